@@ -1722,14 +1722,30 @@ static f32 dts = 72.f;
 			}
 			ImGui::EndDock();
 	 	}; 
+
+		static bool mShowGPUMemory = false;
+		auto gpuMemoryMenu = [&]()
+		{
+        	ImGui::MenuItem("GPU Memory##options", NULL, &mShowGPUMemory);
+		};
+	 	auto showGPUMemoryWindow = [&]()
+	 	{
+			if (ImGui::BeginDock("GPU Memory##options", &mShowGPUMemory))
+			{
+				EngineSubsystem( GraphicsSubsystem )->ShowGPUMemoryWindow( );
+			}
+			ImGui::EndDock();
+	 	}; 
  
 		guiContext->RegisterMenuOption("View", "Styles##Options", stylesMenuOption);
 		guiContext->RegisterMenuOption("View", "Graphics Settings##options", graphicsOptionsMenu);
+		guiContext->RegisterMenuOption("View", "GPU Memory##options", gpuMemoryMenu);
 		//guiContext->RegisterMenuOption( "View", "Application Properties##Options", [ & ] () { 
 		//	ImGui::MenuItem( "Application Properties##options", NULL, &mApplicationPropertiesEnabled ); 
 		//});
 		guiContext->RegisterWindow("Styles", showStylesWindowFunc); 
 		guiContext->RegisterWindow( "Graphics Settings", showGfxOptionsMenu );
+		guiContext->RegisterWindow( "GPU Memory", showGPUMemoryWindow );
 		//guiContext->RegisterWindow( "Application Properties", appPropView );
 
 		guiContext->RegisterWindow( "Cameras", [ & ] ( )
@@ -6,12 +6,14 @@
 #define ENJON_IMPORT_OPTIONS_H
 
 #include "Base/Object.h"
+#include "Serialize/ByteBuffer.h"
 #include "System/Types.h"
 #include "Defines.h"
 
 namespace Enjon
 {
 	class AssetLoader;
+	class AssetManager;
 
 	struct AssetStringInformation
 	{ 
@@ -26,6 +28,7 @@ namespace Enjon
 	class ImportOptions : public Object
 	{
 		friend AssetLoader;
+		friend AssetManager;
 
 		ENJON_CLASS_BODY( ImportOptions )
 
@@ -62,6 +65,22 @@ namespace Enjon
 				// Nothing by default
 			}
 
+			/*
+			* @brief Writes settings that affect the imported asset. Stored with the asset so a changed source can be reimported the same way.
+			*/
+			virtual void SerializeSettings( ByteBuffer* buffer ) const
+			{
+				// Nothing by default
+			}
+
+			/*
+			* @brief Reads settings written by SerializeSettings
+			*/
+			virtual void DeserializeSettings( ByteBuffer* buffer )
+			{
+				// Nothing by default
+			}
+
 		protected:
 
 			/*
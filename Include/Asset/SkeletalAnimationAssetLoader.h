@@ -19,6 +19,7 @@ struct aiScene;
 namespace Enjon
 {
 	class Skeleton;
+	class MeshImportOptions;
 
 	ENJON_CLASS( )
 	class SkeletalAnimationAssetLoader : public AssetLoader
@@ -37,6 +38,16 @@ namespace Enjon
 			*/
 			virtual String GetAssetFileExtension( ) const override;
 
+			/**
+			* @brief Builds animation of scene bound to options' skeleton. Only reads scene, so this can run on a worker thread.
+			*/
+			SkeletalAnimation* ConstructAnimation( const aiScene* scene, const MeshImportOptions* options );
+
+			/**
+			* @brief Registers an animation built from an import
+			*/
+			Asset* AddImported( SkeletalAnimation* animation, const ImportOptions* options );
+
 		protected:
 
 			/**
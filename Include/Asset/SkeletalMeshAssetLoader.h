@@ -19,6 +19,7 @@ struct aiScene;
 namespace Enjon
 {
 	class SkeletalMesh;
+	class MeshImportOptions;
 
 	ENJON_CLASS( )
 	class SkeletalMeshAssetLoader : public AssetLoader
@@ -37,6 +38,17 @@ namespace Enjon
 			*/
 			virtual String GetAssetFileExtension( ) const override;
 
+			/**
+			* @brief Builds skeletal mesh bound to options' skeleton from all meshes in scene. Vertex data is not uploaded,
+			*			so this can run on a worker thread.
+			*/
+			SkeletalMesh* ConstructSkeletalMesh( const aiScene* scene, const MeshImportOptions* options );
+
+			/**
+			* @brief Uploads and registers a skeletal mesh built from an import
+			*/
+			Asset* AddImported( SkeletalMesh* mesh, const ImportOptions* options );
+
 		protected:
 
 			/**
@@ -44,6 +44,11 @@ namespace Enjon
 			*/
 			virtual Result DeserializeData( ByteBuffer* buffer ) override; 
 
+			/**
+			* @brief Appends assets referenced by entities in the archetype's hierarchy
+			*/
+			virtual Result CollectDependencies( Vector< AssetDependency >* out ) const override;
+
 			/**
 			* @brief
 			*/
@@ -257,6 +257,11 @@ namespace Enjon
 			*/
 			virtual Result DeserializeData( ByteBuffer* buffer ) override; 
 
+			/**
+			* @brief
+			*/
+			virtual Result CloneData( const Object* source ) override;
+
 			/**
 			* @brief
 			*/
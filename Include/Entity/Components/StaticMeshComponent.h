@@ -142,6 +142,11 @@ namespace Enjon
 			*/
 			virtual Result DeserializeData( ByteBuffer* buffer ) override; 
 
+			/*
+			* @brief Shares mesh and materials of source renderable
+			*/
+			virtual Result CloneData( const Object* source ) override;
+
 		protected: 
 
 		private: 
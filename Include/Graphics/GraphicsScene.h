@@ -6,6 +6,8 @@
 #include "System/Types.h"
 #include "Graphics/Color.h"
 #include "Graphics/Camera.h"
+#include "Graphics/Frustum.h"
+#include "Graphics/AABBTree.h"
 #include "Base/Object.h"
 
 #include <set>
@@ -21,13 +23,6 @@ namespace Enjon
 	class SpotLight;
 	class QuadBatch;
 
-	enum class RenderableSortType
-	{
-		MATERIAL,
-		DEPTH,
-		NONE
-	};
-
 	struct AmbientSettings
 	{
 		AmbientSettings()
@@ -47,6 +42,34 @@ namespace Enjon
 
 	using RenderableID = u32;
 
+	// Renderables and lights culled per job
+	#define ENJON_CULLING_CHUNK_SIZE			256
+
+	// Skinned meshes are bounded by their bind pose, so are grown to cover how far animation moves them from it
+	#define ENJON_CULLING_SKINNED_BOUNDS_SCALE	1.5f
+
+	// Contribution below which spot lights with falloff no longer light anything
+	#define ENJON_CULLING_LIGHT_THRESHOLD		( 1.0f / 256.0f )
+
+	// Largest extent given bounds in spatial index, standing in for unbounded renderables and lights that never fall off
+	#define ENJON_CULLING_MAX_EXTENT			100000.0f
+
+	// Distance bounds in spatial index are fattened by, so small movements don't restructure it
+	#define ENJON_SPATIAL_INDEX_MARGIN			0.1f
+
+	/*
+	* @brief Renderables and lights of a scene a camera sees, in the same order as the scene's lists
+	*/
+	struct GraphicsSceneVisibility
+	{
+		Vector< StaticMeshRenderable* > mStaticMeshRenderables;
+		Vector< SkeletalMeshRenderable* > mSkeletalMeshRenderables;
+		Vector< Renderable* > mCustomRenderables;
+		Vector< PointLight* > mPointLights;
+		Vector< SpotLight* > mSpotLights;
+		u32 mTestedCount = 0;				// Bounds tested individually after spatial index query
+	};
+
 	ENJON_CLASS( )
 	class GraphicsScene : public Enjon::Object
 	{
@@ -172,7 +195,7 @@ namespace Enjon
 			/*
 			* @brief
 			*/
-			const Vector<StaticMeshRenderable*>& GetNonDepthTestedStaticMeshRenderables();
+			const Vector<StaticMeshRenderable*>& GetNonDepthTestedStaticMeshRenderables( ) const;
 
 			/*
 			* @brief
@@ -219,24 +242,70 @@ namespace Enjon
 				return mCameras;
 			}
 
+			/*
+			* @brief Fills visible with renderables whose world bounds and lights whose influence intersect camera's frustum.
+			*			Spatial index finds those wholly inside frustum and those straddling it, which are then tested
+			*			four at a time with SIMD, in chunks across the job system. Renderables are in no particular order.
+			*/
+			void Cull( const Camera* camera, GraphicsSceneVisibility* visible );
+
+			/*
+			* @brief Flags renderable's bounds to be refit in spatial index before next query. Called as its transform or
+			*			mesh change.
+			*/
+			void UpdateBounds( Renderable* renderable );
+
+			/*
+			* @brief Flags light's influence to be refit in spatial index before next query
+			*/
+			void UpdateBounds( PointLight* light );
+
+			/*
+			* @brief Flags light's influence to be refit in spatial index before next query
+			*/
+			void UpdateBounds( SpotLight* light );
+
+			/*
+			* @brief Renderables whose bounds overlap box min to max
+			*/
+			void QueryRenderables( const Vec3& min, const Vec3& max, Vector< Renderable* >* results );
+
+			/*
+			* @brief Renderables whose bounds overlap sphere
+			*/
+			void QueryRenderables( const Vec3& center, f32 radius, Vector< Renderable* >* results );
+
+			/*
+			* @brief Lights whose influence reaches sphere
+			*/
+			void QueryLights( const Vec3& center, f32 radius, Vector< PointLight* >* pointLights, Vector< SpotLight* >* spotLights );
+
+			/*
+			* @brief Renderables whose bounds ray hits within maxDistance, nearest first
+			*/
+			void Raycast( const Ray& ray, Vector< Renderable* >* results, f32 maxDistance = 100000.0f );
+
 		private: 
 
 			/*
 			* @brief
 			*/
-			void SortStaticMeshRenderables( RenderableSortType type = RenderableSortType::MATERIAL );
-
-		private:
+			void AddRenderableProxy( Renderable* renderable, u32 type );
 
 			/*
 			* @brief
 			*/
-			static bool CompareMaterial(Renderable* a, Renderable* b);
+			void AddLightProxy( const void* light, u32 type );
 
 			/*
 			* @brief
 			*/
-			static bool CompareDepth(Renderable* a, Renderable* b);
+			void RemoveProxy( const void* object, AABBTree* tree, HashMap< const void*, s32 >* proxies, HashSet< s32 >* dirty );
+
+			/*
+			* @brief Refits proxies of everything whose bounds changed since last query
+			*/
+			void UpdateSpatialIndex( );
 
 		private:
 
@@ -263,6 +332,19 @@ namespace Enjon
 			HashSet<SpotLight*> mSpotLights; 
 			AmbientSettings mAmbientSettings; 
 
+			// Spatial indices of renderables and lights, with proxy of each in them and those needing refit
+			AABBTree mRenderableTree = AABBTree( ENJON_SPATIAL_INDEX_MARGIN );
+			AABBTree mLightTree = AABBTree( ENJON_SPATIAL_INDEX_MARGIN );
+			HashMap< const void*, s32 > mRenderableProxies;
+			HashMap< const void*, s32 > mLightProxies;
+			HashSet< s32 > mDirtyRenderableProxies;
+			HashSet< s32 > mDirtyLightProxies;
+
+			// Scratch for culling, kept to avoid allocating each view
+			CullingBounds mCullingBounds;
+			Vector< u8 > mCullingResults;
+			Vector< s32 > mCullingCandidates;
+
 			// Not sure that I like this "solution"
 			Camera* mActiveCamera = nullptr;
 			Camera mDefaultCamera;
@@ -13,6 +13,9 @@
 #include "Entity/EntityManager.h"
 #include "Base/SubsystemContext.h"
 #include "Graphics/GBuffer.h"
+#include "Graphics/TextureStreamer.h"
+#include "Graphics/RenderQueue.h"
+#include "Graphics/GLRenderCommandExecutor.h"
 #include "Subsystem.h" 
 
 namespace Enjon 
@@ -87,6 +90,16 @@ namespace Enjon
 
 			b32 GetEnableRenderWorld() const; 
 
+			/**
+			* @brief Renderables and lights that survived culling against active camera this frame
+			*/
+			const GraphicsSceneVisibility& GetVisibility( ) const;
+
+			/**
+			* @brief Sorted draws of visible renderables this frame
+			*/
+			const RenderQueue& GetRenderQueue( ) const;
+
 		public:
 			b32 mWriteUIIntoFrameBuffer = false;
 
@@ -96,6 +109,8 @@ namespace Enjon
 			FrameBuffer* mObjectIDBuffer = nullptr;
 			Mat4x4 mPreviousViewProjectionMatrix = Mat4x4::Identity( );
 			Vector< RenderPass* > mCustomPasses;
+			GraphicsSceneVisibility mVisibility;
+			RenderQueue mRenderQueue;
 			b32 mRenderWorld = true;
 	};
 
@@ -205,6 +220,11 @@ namespace Enjon
 			*@brief
 			*/
 			const Camera* GetGraphicsSceneCamera( );
+
+			/**
+			*@brief Streams mips of cooked textures by how they're drawn
+			*/
+			TextureStreamer* GetTextureStreamer( );
 			
 			/**
 			*@brief
@@ -231,6 +251,11 @@ namespace Enjon
 			*/
 			void ShowGraphicsWindow();
 
+			/**
+			*@brief Totals of GPU memory by type and pool, with the largest owners and allocations
+			*/
+			void ShowGPUMemoryWindow( );
+
 			/**
 			*@brief
 			*/
@@ -316,6 +341,22 @@ namespace Enjon
 			*/
 			void RegisterCVars();
 
+			/**
+			*@brief
+			*/
+			void CullPass( GraphicsSubsystemContext* ctx );
+
+			/**
+			*@brief Fills context's render queue with a draw for each submesh of visible renderables, and sorts it
+			*/
+			void BuildRenderQueue( GraphicsSubsystemContext* ctx );
+
+			/**
+			*@brief Records gbuffer draws of context's render queue into command buffers, in chunks recorded in parallel.
+			*			Returns number of buffers recorded, to be executed in order.
+			*/
+			u32 RecordGBufferCommands( GraphicsSubsystemContext* ctx, f32 worldTime );
+
 			/**
 			*@brief
 			*/
@@ -430,6 +471,9 @@ namespace Enjon
 
 			// Graphics scene
 			GraphicsScene 		mGraphicsScene;
+			TextureStreamer		mTextureStreamer;
+			Vector< RenderCommandBuffer > mCommandBuffers;
+			GLRenderCommandExecutor mCommandExecutor;
 			Window* 			mWindow = nullptr;
 			Window 				mWindowOther;
 			Window*				mCurrentWindow = nullptr;
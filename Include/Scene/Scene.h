@@ -30,6 +30,11 @@ namespace Enjon
 			*/
 			virtual Result DeserializeData( ByteBuffer* archiver ) override;
 
+			/*
+			* @brief Appends assets referenced by all root level entities in the scene and their hierarchies
+			*/
+			virtual Result CollectDependencies( Vector< AssetDependency >* out ) const override;
+
 		protected:
 
 		private:
@@ -6,13 +6,30 @@
 #define ENJON_ASSET_ARCHIVER_H 
 
 #include "Base/Object.h" 
+#include "Asset/Asset.h"
 #include "Serialize/ByteBuffer.h"
 #include "Serialize/ObjectArchiver.h"
 
+// Version 1 adds source info after loader name
+#define ENJON_ASSET_HEADER_VERSION		1
+
 namespace Enjon
 {
 	class Asset; 
 
+	/*
+	* @brief Header written at the start of every cached asset file
+	*/
+	struct AssetHeader
+	{
+		const MetaClass* mClass		= nullptr;
+		u32 mVersion				= 0;
+		UUID mUUID;
+		String mName;
+		String mLoaderName;
+		AssetSourceInfo mSourceInfo;
+	};
+
 	class AssetArchiver : public ObjectArchiver
 	{
 		public: 
@@ -47,8 +64,35 @@ namespace Enjon
 			*/
 			static void Deserialize( ByteBuffer* buffer, Asset* asset );
 
+			/*
+			* @brief Constructs and deserializes asset from buffer holding the full contents of an asset file
+			*/
+			static Asset* DeserializeAsset( ByteBuffer* buffer );
+
+			/*
+			* @brief Reads asset data from buffer into an already constructed asset. Does not call DeserializeLateInit or
+			*			set the asset's name, uuid or loader, so it can be run on a worker thread while the asset is streaming.
+			*/
+			static Result DeserializeAssetData( ByteBuffer* buffer, Asset* asset );
+
+			/*
+			* @brief Reads asset header from buffer, leaving read position at start of asset data
+			*/
+			static void ReadHeader( ByteBuffer* buffer, AssetHeader* header );
+
+			/*
+			* @brief Writes serialized asset to file at filePath as a block compressed file
+			*/
+			Result WriteToCompressedFile( const String& filePath );
+
 		protected:
 
+			/*
+			* @brief Reads asset written as text into asset, constructing it if null, and applies its header the same way as binary
+			*			assets. Returns null on failure, having freed asset only if it was constructed here.
+			*/
+			static Asset* DeserializeText( const ByteBuffer* buffer, Asset* asset );
+
 		private: 
 	};
 
@@ -22,6 +22,11 @@ namespace Enjon
 			* @brief
 			*/
 			static void Deserialize( const Object* object, ByteBuffer* buffer );
+
+			/**
+			* @brief Reads value of property already resolved from its header, which buffer must be positioned after
+			*/
+			static void DeserializeValue( const Object* object, const MetaProperty* property, ByteBuffer* buffer );
 	};
 
 }
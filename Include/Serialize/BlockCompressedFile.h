@@ -0,0 +1,157 @@
+// @file BlockCompressedFile.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_BLOCK_COMPRESSED_FILE_H
+#define ENJON_BLOCK_COMPRESSED_FILE_H
+
+#include "Serialize/ByteBuffer.h"
+
+// 'ENCB'
+#define ENJON_BLOCK_COMPRESSED_FILE_MAGIC		0x42434E45
+#define ENJON_BLOCK_COMPRESSED_FILE_VERSION		1
+#define ENJON_BLOCK_COMPRESSED_DEFAULT_BLOCK_SIZE	( 64 * 1024 )
+
+namespace Enjon
+{
+	/*
+	* @brief File container that splits its contents into fixed size, independently compressed blocks.
+	*			Layout is a header, a table of block offsets / sizes, then block data. Any byte range can be read
+	*			by decompressing only the blocks it covers, and whole files decompress their blocks in parallel.
+	*			Blocks that do not compress are stored raw.
+	*/
+	class BlockCompressedFile
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			BlockCompressedFile( ) = default;
+
+			/*
+			* @brief
+			*/
+			~BlockCompressedFile( ) = default;
+
+			/*
+			* @brief Compresses size bytes of data into a block compressed file at filePath
+			*/
+			static Result Write( const u8* data, u32 size, const String& filePath, u32 blockSize = ENJON_BLOCK_COMPRESSED_DEFAULT_BLOCK_SIZE );
+
+			/*
+			* @brief Returns whether file at filePath is a block compressed file
+			*/
+			static bool IsCompressedFile( const String& filePath );
+
+			/*
+			* @brief Reads entire contents of file at filePath into buffer, decompressing if needed. Plain files are read as is.
+			*/
+			static Result ReadFile( const String& filePath, ByteBuffer* buffer );
+
+			/*
+			* @brief Returns whether size bytes at data start with a block compressed file header
+			*/
+			static bool IsCompressedMemory( const u8* data, usize size );
+
+			/*
+			* @brief Reads entire contents of file held in size bytes of memory into buffer, decompressing if needed
+			*/
+			static Result ReadMemory( const u8* data, usize size, ByteBuffer* buffer );
+
+			/*
+			* @brief Reads size bytes starting at uncompressed offset of file at filePath into out, decompressing only blocks
+			*			covering them. Plain files are read as is.
+			*/
+			static Result ReadFileRange( const String& filePath, u32 offset, u32 size, u8* out );
+
+			/*
+			* @brief Reads size bytes starting at uncompressed offset of file held in fileSize bytes of memory into out
+			*/
+			static Result ReadMemoryRange( const u8* data, usize fileSize, u32 offset, u32 size, u8* out );
+
+			/*
+			* @brief Reads header and block table of file at filePath. Block data is left on disk until requested.
+			*/
+			Result Open( const String& filePath );
+
+			/*
+			* @brief Reads header and block table of a file held in memory, which must outlive this object. Blocks are
+			*			decompressed straight from it.
+			*/
+			Result OpenMemory( const u8* data, usize size );
+
+			/*
+			* @brief
+			*/
+			bool IsOpen( ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetUncompressedSize( ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetBlockCount( ) const;
+
+			/*
+			* @brief Decompresses size bytes starting at uncompressed offset into out. Only blocks overlapping the range are read.
+			*/
+			Result ReadRange( u32 offset, u32 size, u8* out ) const;
+
+			/*
+			* @brief Decompresses entire file into out, which must hold GetUncompressedSize() bytes. Blocks are decompressed on worker threads.
+			*/
+			Result ReadAll( u8* out ) const;
+
+		protected:
+
+			/*
+			* @brief Validates fixed size header and reads sizes from it. Fills blockCount with size of block table that follows.
+			*/
+			bool ReadHeader( const u8* header, u32* blockCount );
+
+			/*
+			* @brief Reads block table following header
+			*/
+			bool ReadBlockTable( const u8* table, u32 blockCount );
+
+			/*
+			* @brief Points data at compressed data for blocks [first, last]. Files on disk are read into storage with
+			*			a single read, files in memory are used in place.
+			*/
+			Result ReadBlockData( u32 first, u32 last, Vector< u8 >* storage, const u8** data ) const;
+
+			/*
+			* @brief Decompresses block at index from compressed data starting at src into out
+			*/
+			bool DecompressBlock( u32 index, const u8* src, u8* out ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetBlockUncompressedSize( u32 index ) const;
+
+		protected:
+
+			struct BlockEntry
+			{
+				u32 mOffset;
+				u32 mCompressedSize;
+				bool mIsRaw;
+			};
+
+			String mFilePath;
+			u32 mUncompressedSize	= 0;
+			u32 mBlockSize			= 0;
+			u32 mDataOffset			= 0;
+			Vector< BlockEntry > mBlocks;
+			const u8* mMemory		= nullptr;
+			usize mMemorySize		= 0;
+			bool mIsOpen			= false;
+	};
+}
+
+#endif
@@ -10,9 +10,16 @@
 #include "Serialize/UUID.h"
 #include "Serialize/ByteBuffer.h"
 #include "Base/Object.h"
+#include "Asset/Asset.h"
+
+// 'ENMI'
+#define ENJON_CACHE_MANIFEST_INDEX_MAGIC		0x494D4E45
+#define ENJON_CACHE_MANIFEST_INDEX_VERSION		2
 
 namespace Enjon
 { 
+	class PakFile;
+
 	enum class AssetLocationType
 	{
 		EngineAsset,
@@ -27,6 +34,9 @@ namespace Enjon
 		AssetLocationType mAssetLocationType	= AssetLocationType::ApplicationAsset;
 		const MetaClass* mAssetLoaderClass		= nullptr;
 		const MetaClass* mAssetClass			= nullptr;
+		u64 mFileSize							= 0;
+		s64 mFileWriteTime						= 0;
+		AssetSourceInfo mSourceInfo;
 	};
 
 	class CacheRegistryManifest
@@ -61,19 +71,40 @@ namespace Enjon
 			*/
 			Result AddRecord( const CacheManifestRecord& record );
 
+			/*
+			* @brief Replaces existing record with same UUID, refreshing stats of its file after it has been rewritten
+			*/
+			Result UpdateRecord( const CacheManifestRecord& record );
+
+			/*
+			* @brief Writes index out to manifest path if any record has changed since it was last read or written
+			*/
+			Result Flush( );
+
 		private:
 
 			/*
-			* @brief
+			* @brief Writes all records, sorted by UUID bytes, along with the size and write time of their files
 			*/
 			Result WriteOutManifest( const String& manifestPath );
 
 			/*
-			* @brief
+			* @brief Loads the index, then walks the assets directory checking each file's size and write time against it.
+			*			Only files that are new or have changed since the index was written have their headers parsed.
 			* @note Will be read in ONLY by calling Initialize() first, since the manifest path must be given
 			*/
 			Result ReadInManifest( ); 
 
+			/*
+			* @brief Adds a record for every entry of archive mounted by asset manager. Nothing on disk is walked or stat'd.
+			*/
+			Result ReadInPak( const PakFile* pak );
+
+			/*
+			* @brief Reads records from index at manifest path into indexed, keyed by asset file path
+			*/
+			Result ReadInIndex( HashMap< String, CacheManifestRecord >* indexed );
+
 			/*
 			* @brief
 			*/
@@ -83,6 +114,7 @@ namespace Enjon
 			String mManifestPath; 
 			HashMap< String, CacheManifestRecord > mManifestRecords;
 			const AssetManager* mAssetManager = nullptr;
+			bool mIsDirty = false;
 	};
 }
 
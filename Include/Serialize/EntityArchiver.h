@@ -9,12 +9,88 @@
 #include "Serialize/ByteBuffer.h"
 #include "Serialize/ObjectArchiver.h"
 #include "Entity/EntityManager.h"
+#include "Asset/AssetDependencies.h"
 
 namespace Enjon
 {
 	class Entity; 
 	class World;
 
+	/*
+	* @brief How entity hierarchies are written out. OverridesOnly writes archetype instances as their prototype
+	*			UUID plus the properties that differ from that prototype; all other entities are written in full.
+	*/
+	enum class EntitySerializeMode
+	{
+		Full,
+		OverridesOnly
+	};
+
+	/*
+	* @brief Leading tag written for every entity record
+	*/
+	enum class EntityRecordType : u32
+	{
+		Null		= 0,
+		Full		= 1,
+		Overrides	= 2
+	};
+
+	/*
+	* @brief Property decoded from a default serialized property block. Its value is left in the source buffer and referenced by offset.
+	*/
+	struct StagedProperty
+	{
+		const MetaProperty* mProperty = nullptr;
+		u32 mDataOffset = 0;
+	};
+
+	/*
+	* @brief Component record decoded from an entity record. Default serialized data is decoded into properties; custom
+	*			serialized data can only be read by the component itself, so is left in the source buffer and referenced by offset.
+	*/
+	struct StagedComponent
+	{
+		const MetaClass* mClass = nullptr;
+		bool mIsDefaultData = false;
+		Vector< StagedProperty > mProperties;
+		u32 mDataOffset = 0;
+		u32 mDataSize = 0;
+	};
+
+	/*
+	* @brief Entity record decoded from a buffer without touching any engine state, so it can be built off the main thread.
+	*/
+	struct StagedEntity
+	{
+		EntityRecordType mRecordType = EntityRecordType::Null;
+		UUID mUUID;
+		String mName;
+		Transform mLocalTransform;
+		UUID mArchetype;
+		UUID mPrototype;
+		Vector< UUID > mInstancedEntities;
+		Vector< StagedComponent > mComponents;
+		Vector< StagedEntity > mChildren;
+		Vector< StagedProperty > mProperties;
+
+		// Prototype components and children removed from an instance, for overrides records
+		Vector< const MetaClass* > mRemovedComponents;
+		Vector< UUID > mRemovedChildren;
+
+		// Assets referenced by staged properties of this entity and its components
+		Vector< AssetDependency > mAssets;
+	};
+
+	/*
+	* @brief Entities allocated in one batch for committing staged records, handed out in turn as full records are committed
+	*/
+	struct StagedAllocation
+	{
+		Vector< EntityHandle > mEntities;
+		u32 mNext = 0;
+	};
+
 	class EntityArchiver : public ObjectArchiver
 	{
 		public: 
@@ -49,7 +125,7 @@ namespace Enjon
 			/*
 			* @brief Static method which serializes entity data using an existing ByteBuffer
 			*/
-			static Result Serialize( const EntityHandle& entity, ByteBuffer* buffer );
+			static Result Serialize( const EntityHandle& entity, ByteBuffer* buffer, EntitySerializeMode mode = EntitySerializeMode::Full );
 
 			/*
 			* @brief Static method which deserializes entity data using an existing ByteBuffer
@@ -61,6 +137,45 @@ namespace Enjon
 			*/
 			static EntityHandle Deserialize( ByteBuffer* buffer, World* world, bool isInstanced = false );
 
+			/*
+			* @brief Decodes a single entity record into staged, resolving its properties and gathering the assets they reference. Only reads
+			*			from buffer, so is safe to call from worker threads on separate buffers.
+			*/
+			static void Stage( ByteBuffer* buffer, StagedEntity* staged );
+
+			/*
+			* @brief Gathers all archetypes referenced by staged hierarchy into out
+			*/
+			static void GetStagedArchetypes( const StagedEntity& staged, HashSet< String >& out );
+
+			/*
+			* @brief Gathers all assets referenced by staged properties of hierarchy into out
+			*/
+			static void GetStagedAssets( const StagedEntity& staged, Vector< AssetDependency >& out );
+
+			/*
+			* @brief Allocates entities for every full record of staged hierarchies in one batch and reserves storage for their
+			*			components, so committing them doesn't allocate one at a time. Main thread only.
+			*/
+			static void AllocateStaged( const Vector< StagedEntity >& staged, World* world, StagedAllocation* allocation );
+
+			/*
+			* @brief Destroys entities of allocation that no committed record used, such as those under dropped records
+			*/
+			static void ReleaseStaged( StagedAllocation* allocation );
+
+			/*
+			* @brief Constructs entity from staged record. Buffer must be the one staged was decoded from. Takes entities from
+			*			allocation if given, otherwise allocates them as needed. Main thread only.
+			*/
+			static EntityHandle CommitStaged( const StagedEntity& staged, ByteBuffer* buffer, World* world, StagedAllocation* allocation = nullptr );
+
+			/*
+			* @brief Copies entity hierarchy into world directly, without round tripping through a byte buffer. Clones keep the UUIDs of their source.
+			*			Instanced clones skip resolving overrides against their prototype, as caller will assign them a new one.
+			*/
+			static EntityHandle Clone( const EntityHandle& source, World* world, bool isInstanced = false );
+
 		protected:
 
 			/*
@@ -68,6 +183,36 @@ namespace Enjon
 			*/
 			static EntityHandle DeserializeInternal( const EntityHandle& entiy, ByteBuffer* buffer, World* world, bool isInstanced = false );
 
+			/*
+			* @brief Returns whether or not entity can be written as an overrides-only record ( must be an instance of an archetype prototype )
+			*/
+			static bool CanSerializeOverrides( const EntityHandle& entity );
+
+			/*
+			* @brief Writes entity as its prototype UUID plus all properties that differ from the prototype
+			*/
+			static Result SerializeOverrides( const EntityHandle& entity, ByteBuffer* buffer );
+
+			/*
+			* @brief Writes all serializable properties of object that differ from source. Format matches SerializeObjectDataDefault. Returns number of properties written.
+			*/
+			static u32 SerializePropertyOverrides( const Object* object, const Object* source, ByteBuffer* buffer );
+
+			/*
+			* @brief Reads an overrides-only record ( tag already consumed ) by instancing its prototype and applying the recorded overrides
+			*/
+			static EntityHandle DeserializeOverrides( ByteBuffer* buffer, World* world );
+
+			/*
+			* @brief Applies the body of an overrides-only record to an entity already instanced from the record's prototype
+			*/
+			static void ApplyOverrides( Entity* ent, ByteBuffer* buffer, World* world );
+
+			/*
+			* @brief Applies a staged overrides record to an entity already instanced from the record's prototype
+			*/
+			static void CommitStagedOverrides( Entity* ent, const StagedEntity& staged, ByteBuffer* buffer, World* world, StagedAllocation* allocation );
+
 		private: 
 	};
 
@@ -0,0 +1,122 @@
+// @file JSONArchiver.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_JSON_ARCHIVER_H
+#define ENJON_JSON_ARCHIVER_H
+
+#include "Base/Object.h"
+#include "Entity/EntityManager.h"
+
+namespace Enjon
+{
+	class World;
+	class Asset;
+	class ByteBuffer;
+	class JSONWriter;
+	struct AssetHeader;
+	class JSONReadHandler;
+
+	/*
+	* @brief Streams objects and entity hierarchies to and from text using the same reflection data as ObjectArchiver.
+	*			Properties are written as objects are walked and applied as they are parsed, so no document is ever held in memory.
+	*			Objects that handle their own serialization are embedded as base64 encoded binary.
+	*/
+	class JSONArchiver
+	{
+		friend JSONReadHandler;
+
+		public:
+
+			/*
+			* @brief
+			*/
+			JSONArchiver( ) = default;
+
+			/*
+			* @brief
+			*/
+			~JSONArchiver( ) = default;
+
+			/*
+			* @brief Writes object to file at filePath
+			*/
+			static Result Serialize( const Object* object, const String& filePath );
+
+			/*
+			* @brief Constructs and returns object read from file at filePath. Returns nullptr on failure.
+			*/
+			static Object* Deserialize( const String& filePath );
+
+			/*
+			* @brief Reads file at filePath into an existing object
+			*/
+			static Result Deserialize( const String& filePath, Object* object );
+
+			/*
+			* @brief Writes all given entity hierarchies to file at filePath
+			*/
+			static Result SerializeEntities( const Vector< EntityHandle >& entities, const String& filePath );
+
+			/*
+			* @brief Reads all entity hierarchies from file at filePath into world. Root level entities are appended to out if given.
+			*/
+			static Result DeserializeEntities( const String& filePath, World* world, Vector< EntityHandle >* out = nullptr );
+
+			/*
+			* @brief Writes asset to file at filePath as text, with the same header fields as a binary asset file. Scenes are written as
+			*			the entities they hold. Returns incomplete without writing anything for assets that handle their own serialization.
+			*/
+			static Result SerializeAsset( const Asset* asset, const String& filePath );
+
+			/*
+			* @brief Reads asset written as text from buffer into asset, constructing it if null. Fills out header, but neither applies
+			*			it to the asset nor calls DeserializeLateInit, so callers can treat text and binary assets the same way.
+			*/
+			static Result DeserializeAsset( const ByteBuffer* buffer, Asset** asset, AssetHeader* header );
+
+			/*
+			* @brief Reads header of asset written as text. Parsing stops at asset data, so data only needs to hold a prefix of the file.
+			*/
+			static Result ReadAssetHeader( const u8* data, usize size, AssetHeader* header );
+
+			/*
+			* @brief Returns whether data holds an asset written as text rather than binary
+			*/
+			static bool IsAssetText( const u8* data, usize size );
+
+		protected:
+
+			/*
+			* @brief
+			*/
+			static void WriteObject( const Object* object, JSONWriter* writer );
+
+			/*
+			* @brief
+			*/
+			static void WriteProperties( const Object* object, const MetaClass* cls, JSONWriter* writer );
+
+			/*
+			* @brief
+			*/
+			static void WriteProperty( const Object* object, const MetaProperty* prop, JSONWriter* writer );
+
+			/*
+			* @brief
+			*/
+			static void WriteEntity( const EntityHandle& entity, JSONWriter* writer );
+
+			/*
+			* @brief Applies a single named entity field ( UUID, Name, Archetype or Prototype ) read from text
+			*/
+			static void ApplyEntityField( const EntityHandle& entity, const String& field, const String& value );
+
+			/*
+			* @brief Resolves archetype and prototype overrides once an entity has been fully read
+			*/
+			static void FinalizeEntity( const EntityHandle& entity );
+	};
+}
+
+#endif
@@ -0,0 +1,38 @@
+// @file LZCompression.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_LZ_COMPRESSION_H
+#define ENJON_LZ_COMPRESSION_H
+
+#include "System/Types.h"
+#include "Defines.h"
+
+namespace Enjon
+{
+	/*
+	* @brief Fast byte oriented LZ77 codec using the LZ4 block layout ( token, literals, 16 bit offset, match length ).
+	*			Favors decompression speed over ratio. Stateless, so safe to use from any thread.
+	*/
+	class LZCompression
+	{
+		public:
+
+			/*
+			* @brief Returns worst case size of compressing srcSize bytes
+			*/
+			static u32 GetMaxCompressedSize( u32 srcSize );
+
+			/*
+			* @brief Compresses src into dst. Returns compressed size, or 0 if dst is too small.
+			*/
+			static u32 Compress( const u8* src, u32 srcSize, u8* dst, u32 dstCapacity );
+
+			/*
+			* @brief Decompresses src into dst, which must be exactly dstSize bytes once decompressed. Returns false on malformed input.
+			*/
+			static bool Decompress( const u8* src, u32 srcSize, u8* dst, u32 dstSize );
+	};
+}
+
+#endif
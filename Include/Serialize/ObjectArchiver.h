@@ -135,6 +135,17 @@ namespace Enjon
 			*/
 			static Result RevertProperty( Object* object, MetaProperty* prop );
 
+			/*
+			* @brief Copies source into dest, which must be of the same class, by walking its properties directly instead of 
+			*			round tripping through a byte buffer. Objects and arrays / maps of objects are deep copied, asset handles are shared.
+			*/
+			static Result Clone( const Object* source, Object* dest );
+
+			/*
+			* @brief Constructs a new object of source's class and clones source into it. Returns nullptr on failure.
+			*/
+			static Object* Clone( const Object* source );
+
 			// NOTE( John ): NOT RECOMMENDED TO CALL ANY OF THE BELOW FUNCTIONS WITHOUT FULLY UNDERSTANDING WHAT THEY'RE DOING FIRST. 
 			//				PREFERRED TO USE THE ABOVE FUNCTIONS FOR ANY SERIALIZATION MECHANISMS INSTEAD.
 			
@@ -173,6 +184,16 @@ namespace Enjon
 			*/ 
 			static Result ClearAllPropertyOverridesDefault( Object* obj );
 
+			/*
+			*@brief Clones all serializable properties of source into dest
+			*/ 
+			static Result CloneObjectDataDefault( const Object* source, Object* dest, const MetaClass* cls );
+
+			/*
+			*@brief
+			*/ 
+			static Result CloneProperty( const Object* source, Object* dest, const MetaProperty* prop );
+
 		protected:
 			ByteBuffer mBuffer;
 	};
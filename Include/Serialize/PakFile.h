@@ -0,0 +1,110 @@
+// @file PakFile.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_PAK_FILE_H
+#define ENJON_PAK_FILE_H
+
+#include "Serialize/ByteBuffer.h"
+#include "Serialize/UUID.h"
+
+// 'EPAK'
+#define ENJON_PAK_FILE_MAGIC				0x4B415045
+#define ENJON_PAK_FILE_VERSION				1
+#define ENJON_PAK_DEFAULT_ALIGNMENT			4096
+
+namespace Enjon
+{
+	struct PakEntry
+	{
+		String mUUID				= "";			// Key table of contents is sorted by
+		String mFilePath			= "";			// Relative to root directory pak was built from
+		String mAssetName			= "";
+		String mLoaderClassName		= "";
+		String mAssetClassName		= "";
+		u64 mOffset					= 0;
+		u64 mSize					= 0;
+	};
+
+	/*
+	* @brief Archive of cached asset files for shipping builds. Layout is a header, each file's bytes as is ( plain or
+	*			block compressed ) starting on an aligned offset, then a table of contents sorted by UUID. Mounting
+	*			maps the whole archive into memory once, so loads are lookups and copies instead of file opens.
+	*			Reads of a mounted archive are thread safe.
+	*/
+	class PakFile
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			PakFile( ) = default;
+
+			/*
+			* @brief Unmaps archive if mounted
+			*/
+			~PakFile( );
+
+			/*
+			* @brief Writes archive to pakPath containing each entry's file, found at its path relative to rootDirectory.
+			*			Offsets and sizes of entries are filled in by the build. Entries whose file can't be read are skipped.
+			*/
+			static Result Build( const String& pakPath, const String& rootDirectory, const Vector< PakEntry >& entries, u32 alignment = ENJON_PAK_DEFAULT_ALIGNMENT );
+
+			/*
+			* @brief Maps archive at pakPath into memory and reads its table of contents. Unmounts any previous archive.
+			*/
+			Result Mount( const String& pakPath );
+
+			/*
+			* @brief
+			*/
+			void Unmount( );
+
+			/*
+			* @brief
+			*/
+			bool IsMounted( ) const;
+
+			/*
+			* @brief
+			*/
+			const String& GetFilePath( ) const;
+
+			/*
+			* @brief Entries of table of contents, sorted by UUID
+			*/
+			const Vector< PakEntry >& GetEntries( ) const;
+
+			/*
+			* @brief Binary searches table of contents. Returns null if uuid isn't in archive.
+			*/
+			const PakEntry* Find( const UUID& uuid ) const;
+
+			/*
+			* @brief Reads contents of entry's file into buffer, decompressing it if it was cached block compressed
+			*/
+			Result Read( const PakEntry* entry, ByteBuffer* buffer ) const;
+
+			/*
+			* @brief Reads size bytes starting at offset into contents of entry's file, as Read would have produced them, into out
+			*/
+			Result ReadRange( const PakEntry* entry, u32 offset, u32 size, u8* out ) const;
+
+		protected:
+
+			/*
+			* @brief Validates header and parses table of contents of mapped archive
+			*/
+			Result ReadTableOfContents( );
+
+		protected:
+			String mFilePath;
+			Vector< PakEntry > mEntries;
+			const u8* mData			= nullptr;
+			usize mSize				= 0;
+	};
+}
+
+#endif
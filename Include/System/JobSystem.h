@@ -0,0 +1,126 @@
+// @file JobSystem.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_JOB_SYSTEM_H
+#define ENJON_JOB_SYSTEM_H
+
+#include "Subsystem.h"
+#include "System/Types.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <deque>
+
+namespace Enjon
+{
+	using Job = std::function< void( ) >;
+
+	/*
+	* @brief Tracks number of outstanding jobs submitted under it. Must outlive all jobs submitted with it.
+	*/
+	class JobGroup
+	{
+		friend class JobSystem;
+
+		public:
+
+			/*
+			* @brief
+			*/
+			JobGroup( ) = default;
+
+			/*
+			* @brief
+			*/
+			~JobGroup( ) = default;
+
+			/*
+			* @brief Returns whether or not all jobs submitted with this group have finished
+			*/
+			bool IsComplete( ) const;
+
+		private:
+			std::atomic< u32 > mPending{ 0 };
+	};
+
+	ENJON_CLASS( )
+	class JobSystem : public Subsystem
+	{
+		ENJON_CLASS_BODY( JobSystem )
+
+		public:
+
+			/**
+			*@brief
+			*/
+			virtual Result Initialize() override;
+
+			/**
+			*@brief
+			*/
+			virtual void Update( const f32 dT ) override;
+
+			/**
+			*@brief
+			*/
+			virtual Enjon::Result Shutdown() override;
+
+			/**
+			*@brief Queues job to be run on a worker thread. If group is given, it will be tracked by that group.
+			*/
+			void Submit( const Job& job, JobGroup* group = nullptr );
+
+			/**
+			*@brief Blocks until all jobs in group have finished. Calling thread will run queued jobs while it waits.
+			*/
+			void Wait( JobGroup* group );
+
+			/**
+			*@brief Runs func( i ) for i in [0, count) across all workers and calling thread. Returns when all iterations have finished.
+			*/
+			void ParallelFor( u32 count, const std::function< void( u32 ) >& func, u32 batchSize = 1 );
+
+			/**
+			*@brief Runs ParallelFor on engine's job system, or every iteration on calling thread when used outside of a running
+			*			engine ( tools, shutdown ) or for a single iteration
+			*/
+			static void ParallelForOrSerial( u32 count, const std::function< void( u32 ) >& func, u32 batchSize = 1 );
+
+			/**
+			*@brief Returns number of worker threads ( not including calling thread )
+			*/
+			u32 GetWorkerCount( ) const;
+
+		protected:
+
+			/**
+			*@brief
+			*/
+			void WorkerLoop( );
+
+			/**
+			*@brief Pops and runs a single job if one is queued. Returns whether or not a job was run.
+			*/
+			bool RunPendingJob( );
+
+		private:
+
+			struct QueuedJob
+			{
+				Job mJob;
+				JobGroup* mGroup = nullptr;
+			};
+
+			Vector< std::thread > mWorkers;
+			std::deque< QueuedJob > mQueue;
+			std::mutex mQueueLock;
+			std::condition_variable mQueueSignal;
+			bool mShuttingDown = false;
+	};
+}
+
+#endif
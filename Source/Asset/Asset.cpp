@@ -13,6 +13,10 @@ namespace Enjon
 { 
 	//================================================================================================================
 
+	std::atomic< u32 > Asset::sResidencyFrame{ 0 };
+
+	//================================================================================================================
+
 	template <typename T>
 	const AssetLoader* AssetHandle<T>::GetLoader( ) const
 	{
@@ -28,6 +32,24 @@ namespace Enjon
 
 	//================================================================================================================
 
+	const Asset* Asset::GetResidentAsset( ) const
+	{
+		if ( mStreamingPlaceholder )
+		{
+			return mStreamingPlaceholder;
+		}
+
+		// Nothing can stand in for an asset still loading without a placeholder
+		if ( mRecordInfo && mRecordInfo->GetAssetLoadStatus( ) == AssetLoadStatus::Loading )
+		{
+			return nullptr;
+		}
+
+		return this;
+	}
+
+	//================================================================================================================
+
 	Result Asset::Save( ) const
 	{
 		return Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->SaveAsset( this );
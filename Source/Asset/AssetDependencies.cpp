@@ -0,0 +1,303 @@
+// @file AssetDependencies.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Asset/AssetDependencies.h"
+#include "Asset/AssetManager.h"
+#include "Entity/EntityManager.h"
+#include "Base/Object.h"
+#include "SubsystemCatalog.h"
+#include "Engine.h"
+
+#include "fs/filesystem.hpp"
+
+#include <fstream>
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL void AddDependency( const Asset* asset, Vector< AssetDependency >* out )
+	{
+		// Default assets are always resident, so never need to be loaded
+		if ( !asset || asset->IsDefault( ) )
+		{
+			return;
+		}
+
+		AssetDependency dep;
+		dep.mAssetUUID = asset->GetUUID( );
+		dep.mAssetClass = asset->Class( );
+		out->push_back( dep );
+	}
+
+	//=================================================================
+
+	INTERNAL s64 GetFileWriteTime( const String& filePath )
+	{
+		std::error_code ec;
+		return ( s64 )ghc::filesystem::last_write_time( filePath, ec ).time_since_epoch( ).count( );
+	}
+
+	//=================================================================
+
+	Result AssetDependencies::Collect( const Asset* asset, Vector< AssetDependency >* out )
+	{
+		if ( !asset || !out )
+		{
+			return Result::FAILURE;
+		}
+
+		// Assets still streaming would be walked through their placeholders
+		AssetManager* am = EngineSubsystem( AssetManager );
+		if ( am )
+		{
+			am->FlushStreaming( );
+		}
+
+		std::unordered_set< String > visited;
+		visited.insert( asset->GetUUID( ).ToString( ) );
+		CollectRecursive( asset, &visited, out );
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	void AssetDependencies::CollectRecursive( const Asset* asset, std::unordered_set< String >* visited, Vector< AssetDependency >* out )
+	{
+		// Assets that know their own references report them, everything else is found through reflection
+		Vector< AssetDependency > direct;
+		if ( asset->CollectDependencies( &direct ) == Result::INCOMPLETE )
+		{
+			CollectFromObject( asset, &direct );
+		}
+
+		AssetManager* am = EngineSubsystem( AssetManager );
+		for ( auto& dep : direct )
+		{
+			if ( !visited->insert( dep.mAssetUUID.ToString( ) ).second )
+			{
+				continue;
+			}
+
+			// Dependencies of a dependency have to be in the list before it
+			const Asset* child = am ? am->GetAsset( dep.mAssetClass, dep.mAssetUUID ) : nullptr;
+			if ( child && !child->IsDefault( ) )
+			{
+				CollectRecursive( child, visited, out );
+			}
+
+			out->push_back( dep );
+		}
+	}
+
+	//=================================================================
+
+	void AssetDependencies::CollectFromObject( const Object* object, Vector< AssetDependency >* out )
+	{
+		if ( !object )
+		{
+			return;
+		}
+
+		const MetaClass* cls = object->Class( );
+		for ( usize i = 0; i < cls->GetPropertyCount( ); ++i )
+		{
+			const MetaProperty* prop = cls->GetProperty( i );
+			if ( !prop || prop->HasFlags( MetaPropertyFlags::NonSerializeable ) )
+			{
+				continue;
+			}
+
+			CollectFromProperty( object, prop, out );
+		}
+	}
+
+	//=================================================================
+
+	void AssetDependencies::CollectFromProperty( const Object* object, const MetaProperty* prop, Vector< AssetDependency >* out )
+	{
+		const MetaClass* cls = object->Class( );
+		switch ( prop->GetType( ) )
+		{
+			default: break;
+
+			case MetaPropertyType::AssetHandle:
+			{
+				AssetHandle< Asset > val;
+				cls->GetValue( object, prop, &val );
+				AddDependency( val.Get( ), out );
+			} break;
+
+			case MetaPropertyType::Object:
+			{
+				if ( prop->GetTraits( ).IsPointer( ) )
+				{
+					CollectFromObject( prop->Cast< MetaPropertyPointerBase >( )->GetValueAsObject( object ), out );
+				}
+				else
+				{
+					CollectFromObject( cls->GetValueAs< Object >( object, prop ), out );
+				}
+			} break;
+
+			case MetaPropertyType::Array:
+			{
+				const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+				switch ( base->GetArrayType( ) )
+				{
+					default: break;
+
+					case MetaPropertyType::AssetHandle:
+					{
+						const MetaPropertyArray< AssetHandle< Asset > >* arrProp = base->Cast< MetaPropertyArray< AssetHandle< Asset > > >( );
+						for ( usize j = 0; j < arrProp->GetSize( object ); ++j )
+						{
+							AddDependency( arrProp->GetValueAs( object, j ).Get( ), out );
+						}
+					} break;
+
+					case MetaPropertyType::Object:
+					{
+						const MetaPropertyArray< Object* >* arrProp = base->Cast< MetaPropertyArray< Object* > >( );
+						if ( arrProp )
+						{
+							for ( usize j = 0; j < arrProp->GetSize( object ); ++j )
+							{
+								CollectFromObject( arrProp->GetValueAs( object, j ), out );
+							}
+						}
+					} break;
+				}
+			} break;
+
+			case MetaPropertyType::HashMap:
+			{
+				// Only maps holding objects can reach other assets
+				const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
+				if ( base->GetValueType( ) != MetaPropertyType::Object )
+				{
+					break;
+				}
+
+				switch ( base->GetKeyType( ) )
+				{
+					default: break;
+
+					case MetaPropertyType::String:
+					{
+						const MetaPropertyHashMap< String, Object* >* mapProp = base->Cast< MetaPropertyHashMap< String, Object* > >( );
+						for ( auto iter = mapProp->Begin( object ); iter != mapProp->End( object ); ++iter )
+						{
+							CollectFromObject( iter->second, out );
+						}
+					} break;
+
+					case MetaPropertyType::Enum:
+					{
+						const MetaPropertyHashMap< s32, Object* >* mapProp = base->Cast< MetaPropertyHashMap< s32, Object* > >( );
+						for ( auto iter = mapProp->Begin( object ); iter != mapProp->End( object ); ++iter )
+						{
+							CollectFromObject( iter->second, out );
+						}
+					} break;
+				}
+			} break;
+		}
+	}
+
+	//=================================================================
+
+	void AssetDependencies::CollectFromEntity( Entity* entity, Vector< AssetDependency >* out )
+	{
+		if ( !entity )
+		{
+			return;
+		}
+
+		// Archetype instances need their archetype loaded before they can be built
+		if ( entity->GetArchetype( ) )
+		{
+			AddDependency( entity->GetArchetype( ).Get( ), out );
+		}
+
+		for ( auto& c : entity->GetComponents( ) )
+		{
+			CollectFromObject( c, out );
+		}
+
+		for ( auto& child : entity->GetChildren( ) )
+		{
+			CollectFromEntity( child.Get( ), out );
+		}
+	}
+
+	//=================================================================
+
+	String AssetDependencies::GetFilePath( const String& assetFilePath )
+	{
+		return assetFilePath + ENJON_ASSET_DEPENDENCIES_FILE_EXTENSION;
+	}
+
+	//=================================================================
+
+	Result AssetDependencies::WriteToFile( const String& assetFilePath, const Vector< AssetDependency >& dependencies )
+	{
+		std::ofstream file( GetFilePath( assetFilePath ), std::ios::out | std::ios::trunc );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		// Stamped with asset file's write time so a list left behind by an older save is ignored
+		file << ENJON_ASSET_DEPENDENCIES_FILE_VERSION << " " << GetFileWriteTime( assetFilePath ) << " " << dependencies.size( ) << "\n";
+		for ( auto& dep : dependencies )
+		{
+			file << dep.mAssetUUID.ToString( ) << " " << dep.mAssetClass->GetName( ) << "\n";
+		}
+
+		return file.good( ) ? Result::SUCCESS : Result::FAILURE;
+	}
+
+	//=================================================================
+
+	Result AssetDependencies::ReadFromFile( const String& assetFilePath, Vector< AssetDependency >* out )
+	{
+		std::ifstream file( GetFilePath( assetFilePath ) );
+		if ( !file || !out )
+		{
+			return Result::FAILURE;
+		}
+
+		u32 version = 0;
+		s64 writeTime = 0;
+		usize count = 0;
+		file >> version >> writeTime >> count;
+		if ( !file || version != ENJON_ASSET_DEPENDENCIES_FILE_VERSION || writeTime != GetFileWriteTime( assetFilePath ) )
+		{
+			return Result::FAILURE;
+		}
+
+		for ( usize i = 0; i < count; ++i )
+		{
+			String uuid, className;
+			if ( !( file >> uuid >> className ) )
+			{
+				return Result::FAILURE;
+			}
+
+			// Classes that no longer exist are skipped, the asset will resolve them as usual when it loads
+			AssetDependency dep;
+			dep.mAssetUUID = UUID( uuid );
+			dep.mAssetClass = Object::GetClass( className );
+			if ( dep.mAssetClass )
+			{
+				out->push_back( dep );
+			}
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+}
@@ -0,0 +1,242 @@
+// @file AssetDirectoryWatcher.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Asset/AssetDirectoryWatcher.h"
+#include "System/Config.h"
+
+#include "fs/filesystem.hpp"
+
+#ifdef ENJON_SYSTEM_LINUX
+	#include <sys/inotify.h>
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL String NormalizeWatchPath( const String& path )
+	{
+		std::error_code ec;
+		ghc::filesystem::path p = ghc::filesystem::absolute( path, ec );
+		return ( ec ? ghc::filesystem::path( path ) : p ).lexically_normal( ).generic_string( );
+	}
+
+	//=================================================================
+
+	AssetDirectoryWatcher::~AssetDirectoryWatcher( )
+	{
+		Shutdown( );
+	}
+
+	//=================================================================
+
+	Result AssetDirectoryWatcher::Initialize( const String& directory, const Vector< String >& excludedDirectories )
+	{
+		Shutdown( );
+
+#ifdef ENJON_SYSTEM_LINUX
+		if ( !ghc::filesystem::is_directory( directory ) )
+		{
+			return Result::FAILURE;
+		}
+
+		mHandle = inotify_init1( IN_NONBLOCK | IN_CLOEXEC );
+		if ( mHandle < 0 )
+		{
+			mHandle = -1;
+			return Result::FAILURE;
+		}
+
+		for ( auto& d : excludedDirectories )
+		{
+			// Trailing slash so a directory only excludes its own contents, not siblings sharing its name as a prefix
+			mExcludedDirectories.push_back( NormalizeWatchPath( d ) + "/" );
+		}
+
+		WatchRecursive( NormalizeWatchPath( directory ) );
+
+		return Result::SUCCESS;
+#else
+		return Result::FAILURE;
+#endif
+	}
+
+	//=================================================================
+
+	void AssetDirectoryWatcher::Shutdown( )
+	{
+#ifdef ENJON_SYSTEM_LINUX
+		if ( mHandle >= 0 )
+		{
+			// Closing the instance removes all of its watches
+			close( mHandle );
+		}
+#endif
+
+		mHandle = -1;
+		mDirectoriesByWatch.clear( );
+		mExcludedDirectories.clear( );
+		mPendingChanges.clear( );
+	}
+
+	//=================================================================
+
+	bool AssetDirectoryWatcher::IsWatching( ) const
+	{
+		return ( mHandle >= 0 );
+	}
+
+	//=================================================================
+
+	void AssetDirectoryWatcher::SetSettleTime( u32 milliseconds )
+	{
+		mSettleTimeMS = milliseconds;
+	}
+
+	//=================================================================
+
+	bool AssetDirectoryWatcher::IsExcluded( const String& path ) const
+	{
+		String dir = path + "/";
+		for ( auto& e : mExcludedDirectories )
+		{
+			if ( dir.compare( 0, e.size( ), e ) == 0 )
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	//=================================================================
+
+	void AssetDirectoryWatcher::WatchRecursive( const String& directory )
+	{
+#ifdef ENJON_SYSTEM_LINUX
+		if ( IsExcluded( directory ) )
+		{
+			return;
+		}
+
+		// Saves are caught by close after write, and by rename for editors that write to a temporary file first
+		s32 wd = inotify_add_watch( mHandle, directory.c_str( ), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE_SELF );
+		if ( wd < 0 )
+		{
+			return;
+		}
+		mDirectoriesByWatch[ wd ] = directory;
+
+		std::error_code ec;
+		for ( auto& p : ghc::filesystem::directory_iterator( directory, ec ) )
+		{
+			if ( p.is_directory( ec ) )
+			{
+				WatchRecursive( p.path( ).generic_string( ) );
+			}
+		}
+#endif
+	}
+
+	//=================================================================
+
+	void AssetDirectoryWatcher::ReadEvents( )
+	{
+#ifdef ENJON_SYSTEM_LINUX
+		alignas( struct inotify_event ) char events[ 4096 ];
+		auto now = std::chrono::steady_clock::now( );
+
+		while ( true )
+		{
+			ssize_t length = read( mHandle, events, sizeof( events ) );
+			if ( length <= 0 )
+			{
+				// EAGAIN once the queue is drained
+				break;
+			}
+
+			for ( char* ptr = events; ptr < events + length; )
+			{
+				const struct inotify_event* ev = ( const struct inotify_event* )ptr;
+				ptr += sizeof( struct inotify_event ) + ev->len;
+
+				auto query = mDirectoriesByWatch.find( ev->wd );
+				if ( query == mDirectoriesByWatch.end( ) )
+				{
+					continue;
+				}
+
+				if ( ev->mask & ( IN_DELETE_SELF | IN_IGNORED ) )
+				{
+					mDirectoriesByWatch.erase( query );
+					continue;
+				}
+
+				if ( !ev->len )
+				{
+					continue;
+				}
+
+				String path = query->second + "/" + ev->name;
+
+				// New directories need watches of their own. Files already inside them were never seen, so count as changed.
+				if ( ev->mask & IN_ISDIR )
+				{
+					if ( ev->mask & ( IN_CREATE | IN_MOVED_TO ) )
+					{
+						WatchRecursive( path );
+
+						std::error_code ec;
+						for ( auto& p : ghc::filesystem::recursive_directory_iterator( path, ec ) )
+						{
+							if ( p.is_regular_file( ec ) && !IsExcluded( p.path( ).parent_path( ).generic_string( ) ) )
+							{
+								mPendingChanges[ p.path( ).generic_string( ) ] = now;
+							}
+						}
+					}
+					continue;
+				}
+
+				// Creation alone is followed by a close after write once the file has contents
+				if ( ev->mask & ( IN_CLOSE_WRITE | IN_MOVED_TO ) )
+				{
+					mPendingChanges[ path ] = now;
+				}
+			}
+		}
+#endif
+	}
+
+	//=================================================================
+
+	void AssetDirectoryWatcher::Poll( Vector< String >* changed )
+	{
+		if ( !IsWatching( ) )
+		{
+			return;
+		}
+
+		ReadEvents( );
+
+		// Report files that have stopped changing, coalescing bursts of saves into one change
+		auto now = std::chrono::steady_clock::now( );
+		auto settle = std::chrono::milliseconds( mSettleTimeMS );
+		for ( auto iter = mPendingChanges.begin( ); iter != mPendingChanges.end( ); )
+		{
+			if ( now - iter->second >= settle )
+			{
+				changed->push_back( iter->first );
+				iter = mPendingChanges.erase( iter );
+			}
+			else
+			{
+				++iter;
+			}
+		}
+	}
+
+	//=================================================================
+}
@@ -5,6 +5,7 @@
 #include "Utils/FileUtils.h"
 #include "Serialize/ObjectArchiver.h"
 #include "Serialize/AssetArchiver.h"
+#include "Serialize/BlockCompressedFile.h"
 #include "Asset/AssetManager.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
@@ -52,6 +53,12 @@ namespace Enjon
 
 	void AssetRecordInfo::UnloadAsset( )
 	{
+		// Can't release asset while a worker is still decoding into it
+		if ( mAssetLoadStatus == AssetLoadStatus::Loading )
+		{
+			EngineSubsystem( AssetManager )->FlushStreaming( );
+		}
+
 		// Delete the asset if not null
 		if ( mAsset )
 		{
@@ -70,17 +77,28 @@ namespace Enjon
 
 	void AssetRecordInfo::ReloadAsset( )
 	{
+		// Let any in flight decode finish before deserializing over it
+		if ( mAssetLoadStatus == AssetLoadStatus::Loading )
+		{
+			EngineSubsystem( AssetManager )->FlushStreaming( );
+		}
+
+		// Failed to stream in, so try again into the asset handles already hold
+		if ( mAssetLoadStatus == AssetLoadStatus::Failed )
+		{
+			EngineSubsystem( AssetManager )->LoadStreamedAssetImmediate( this );
+			return;
+		}
+
 		// Do not want to unload asset, since other assethandle references will be lost
 		if ( mAsset )
 		{
 			// Archiver to use to load asset from disk
 			AssetArchiver archiver;
 
+			// Cached file may be plain or block compressed
 			ByteBuffer buffer;
-			buffer.ReadFromFile( mAssetFilePath );
-
-			// Error checking...
-			if ( buffer.GetStatus( ) == BufferStatus::Invalid )
+			if ( EngineSubsystem( AssetManager )->ReadAssetFile( this, &buffer ) != Result::SUCCESS )
 			{
 				return;
 			}
@@ -106,6 +124,13 @@ namespace Enjon
 
 	//=================================================================
 
+	const AssetSourceInfo& AssetRecordInfo::GetSourceInfo( ) const
+	{
+		return mSourceInfo;
+	}
+
+	//=================================================================
+
 	String AssetRecordInfo::GetAssetName( ) const
 	{
 		return mAssetName;
@@ -203,26 +228,7 @@ namespace Enjon
 			// If unloaded, load asset from disk
 			if ( info->GetAssetLoadStatus( ) == AssetLoadStatus::Unloaded )
 			{
-				// Archiver to use to load asset from disk
-				AssetArchiver archiver;
-
-				// Set the asset
-				info->mAsset = const_cast<Asset*>( archiver.Deserialize( info->mAssetFilePath )->Cast< Asset >( ) );
-
-				// Set loader of asset
-				info->mAsset->mLoader = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetLoaderByAssetClass( info->mAsset->Class( ) );
-
-				// Set to loaded
-				info->mAssetLoadStatus = AssetLoadStatus::Loaded;
-
-				// Set record info of asset
-				info->mAsset->mRecordInfo = info;
-
-				// Set asset file path
-				info->mAsset->mFilePath = info->mAssetFilePath;
-
-				// Set asset class
-				info->mAssetClass = info->mAsset->Class( );
+				LoadRecordAsset( info );
 			}
 
 			// Set default asset if not valid asset
@@ -251,29 +257,7 @@ namespace Enjon
 			// If unloaded, load asset from disk
 			if ( info->GetAssetLoadStatus( ) == AssetLoadStatus::Unloaded )
 			{
-				// Archiver to use to load asset from disk
-				AssetArchiver archiver;
-
-				// Set the asset
-				info->mAsset = const_cast<Asset*>( archiver.Deserialize( info->mAssetFilePath )->Cast< Asset >( ) );
-
-				// Set loader of asset
-				info->mAsset->mLoader = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetLoaderByAssetClass( info->mAsset->Class( ) );
-
-				// Set to loaded
-				info->mAssetLoadStatus = AssetLoadStatus::Loaded;
-
-				// Set up asset info
-				info->mAsset->mName = info->mAssetName;
-
-				// Set record info for asset
-				info->mAsset->mRecordInfo = info;
-
-				// Set asset file path
-				info->mAsset->mFilePath = info->mAssetFilePath;
-
-				// Set asset class
-				info->mAssetClass = info->mAsset->Class( );
+				LoadRecordAsset( info );
 			}
 
 			// Return asset from info record
@@ -290,6 +274,54 @@ namespace Enjon
 
 	//=================================================================
 
+	void AssetLoader::LoadRecordAsset( AssetRecordInfo* info, ByteBuffer* fileContents )
+	{
+		AssetManager* am = EngineSubsystem( AssetManager );
+
+		// Decode off the main thread if possible, otherwise fall through to loading immediately
+		if ( !fileContents && SupportsStreaming( ) && am->StreamAsset( info, this ) == Result::SUCCESS )
+		{
+			return;
+		}
+
+		// Read file in unless contents already have been, from mounted archive if it holds asset
+		ByteBuffer buffer;
+		if ( !fileContents && am->ReadAssetFile( info, &buffer ) == Result::SUCCESS )
+		{
+			fileContents = &buffer;
+		}
+
+		// Set the asset
+		Asset* asset = fileContents ? AssetArchiver::DeserializeAsset( fileContents ) : nullptr;
+		info->mAsset = asset ? const_cast< Asset* >( asset->Cast< Asset >( ) ) : nullptr;
+
+		// Set to loaded
+		info->mAssetLoadStatus = AssetLoadStatus::Loaded;
+
+		// Couldn't load from disk, so default asset will be used
+		if ( !info->mAsset )
+		{
+			return;
+		}
+
+		// Set loader of asset
+		info->mAsset->mLoader = am->GetLoaderByAssetClass( info->mAsset->Class( ) );
+
+		// Set up asset info
+		info->mAsset->mName = info->mAssetName;
+
+		// Set record info for asset
+		info->mAsset->mRecordInfo = info;
+
+		// Set asset file path
+		info->mAsset->mFilePath = info->mAssetFilePath;
+
+		// Set asset class
+		info->mAssetClass = info->mAsset->Class( );
+	}
+
+	//=================================================================
+
 	bool AssetLoader::FindRecordInfoByName( const String& name, AssetRecordInfo* info )
 	{
 		String qualifiedName = Utils::ToLower( name );
@@ -322,6 +354,13 @@ namespace Enjon
 
 	//=================================================================
 
+	Asset* AssetLoader::ImportResourceData( const String& filePath, const ImportOptions* options )
+	{
+		return nullptr;
+	}
+
+	//=================================================================
+
 	Asset* AssetLoader::DirectImport( const ImportOptions* options )
 	{
 		return nullptr;
@@ -404,6 +443,7 @@ namespace Enjon
 		info.mAssetLoaderClass = record.mAssetLoaderClass;
 		info.mAsset = nullptr;
 		info.mAssetClass = record.mAssetClass;
+		info.mSourceInfo = record.mSourceInfo;
 
 		// Add to assets
 		if ( !Exists( record.mAssetUUID ) )
@@ -18,12 +18,20 @@
 #include "Utils/FileUtils.h"
 #include "Serialize/ObjectArchiver.h"
 #include "Serialize/AssetArchiver.h"
+#include "Serialize/JSONArchiver.h"
+#include "Serialize/BlockCompressedFile.h"
 #include "Utils/FileUtils.h"
+#include "Utils/Hash.h"
 #include "Engine.h"
 #include "SubsystemCatalog.h"
 
 #include "fs/filesystem.hpp"
 
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <unordered_set>
+
 namespace FS = ghc::filesystem; 
 
 namespace Enjon
@@ -93,6 +101,14 @@ namespace Enjon
 	// Base initialization method called from engine
 	Result AssetManager::Initialize( )
 	{
+		// Shipping builds read records and files from a single mapped archive instead of the cache directory
+		String pakPath = mAssetsDirectoryPath + "/" + ENJON_ASSET_PAK_FILE_NAME;
+		mPak.Unmount( );
+		if ( FS::exists( pakPath ) )
+		{
+			mPak.Mount( pakPath );
+		}
+
 		// Initialize the manifest and read in records
 		mCacheManifest.Initialize( mAssetsDirectoryPath + "/Intermediate/CacheManifest.bin", this );
 
@@ -100,6 +116,15 @@ namespace Enjon
 		// NOTE(): I hate this, by the way...
 		mAssetLocationType = AssetLocationType::ApplicationAsset;
 
+		// Watch sources for changes, ignoring the files written by caching assets
+		if ( mHotReloadEnabled )
+		{
+			mSourceWatcher.Initialize( mAssetsDirectoryPath, { mCachedDirectoryPath, mAssetsDirectoryPath + "/Intermediate/" } );
+		}
+		else
+		{
+			mSourceWatcher.Shutdown( );
+		}
 
 		return Result::SUCCESS;
 	}
@@ -108,6 +133,9 @@ namespace Enjon
 
 	void AssetManager::Reinitialize( const String& assetsPath )
 	{
+		// Streaming assets reference records about to be cleared
+		FlushStreaming( );
+
 		// Clear records for loaders
 		for ( auto& l : mLoadersByAssetId )
 		{
@@ -132,13 +160,29 @@ namespace Enjon
 
 	void AssetManager::Update( const f32 dT )
 	{
-		// In here could check for file updates on hot loaded resources 
+		// Finish any assets that have streamed in, within this frame's upload budget
+		ProcessStreamedAssets( false );
+
+		// Periodically account for loaded assets and evict unreferenced ones if over budget
+		u32 frame = Asset::sResidencyFrame.fetch_add( 1, std::memory_order_relaxed ) + 1;
+		if ( mResidencyUpdateInterval && ( frame % mResidencyUpdateInterval ) == 0 )
+		{
+			UpdateResidency( );
+		}
+
+		// Reimport sources that have been saved since last frame
+		ProcessSourceChanges( );
 	}
 
 	//============================================================================================ 
 
 	Result AssetManager::Shutdown( )
 	{
+		// Workers can't be left decoding into assets about to be deleted
+		FlushStreaming( );
+
+		mSourceWatcher.Shutdown( );
+
 		// Delete all asset loaders
 		for ( auto& l : mLoadersByAssetId )
 		{
@@ -149,9 +193,12 @@ namespace Enjon
 		mLoadersByAssetId.clear( );
 		mLoadersByMetaClass.clear( );
 
-		// Reset cache registry manifest
+		// Write out any records added this session, then reset cache registry manifest
+		mCacheManifest.Flush( );
 		mCacheManifest.Reset( );
 
+		mPak.Unmount( );
+
 		return Result::SUCCESS;
 	}
 
@@ -186,6 +233,528 @@ namespace Enjon
 
 	//============================================================================================ 
 
+	Result AssetManager::BuildPak( const String& pakPath ) const
+	{
+		// Paths are stored relative to assets directory, so archive can be mounted from wherever project ends up
+		String rootDirectory = mAssetsDirectoryPath + "/";
+
+		Vector< PakEntry > entries;
+		entries.reserve( mCacheManifest.mManifestRecords.size( ) );
+		for ( auto& r : mCacheManifest.mManifestRecords )
+		{
+			const CacheManifestRecord& record = r.second;
+			if ( record.mAssetFilePath.compare( 0, mAssetsDirectoryPath.size( ), mAssetsDirectoryPath ) != 0 )
+			{
+				continue;
+			}
+
+			PakEntry entry;
+			entry.mUUID = record.mAssetUUID.ToString( );
+			entry.mFilePath = record.mAssetFilePath.substr( mAssetsDirectoryPath.size( ) );
+			entry.mFilePath.erase( 0, entry.mFilePath.find_first_not_of( '/' ) );
+			entry.mAssetName = record.mAssetName;
+			entry.mLoaderClassName = record.mAssetLoaderClass ? record.mAssetLoaderClass->GetName( ) : "";
+			entry.mAssetClassName = record.mAssetClass ? record.mAssetClass->GetName( ) : "";
+			entries.push_back( entry );
+		}
+
+		return PakFile::Build( pakPath, rootDirectory, entries );
+	}
+
+	//============================================================================================ 
+
+	const PakFile* AssetManager::GetMountedPak( ) const
+	{
+		return mPak.IsMounted( ) ? &mPak : nullptr;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::ReadAssetFile( const AssetRecordInfo* info, ByteBuffer* buffer ) const
+	{
+		if ( !info )
+		{
+			return Result::FAILURE;
+		}
+
+		const PakEntry* entry = mPak.IsMounted( ) ? mPak.Find( info->mAssetUUID ) : nullptr;
+		if ( entry )
+		{
+			return mPak.Read( entry, buffer );
+		}
+
+		return BlockCompressedFile::ReadFile( info->mAssetFilePath, buffer );
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::ReadAssetFileRange( const AssetRecordInfo* info, u32 offset, u32 size, u8* out ) const
+	{
+		if ( !info )
+		{
+			return Result::FAILURE;
+		}
+
+		const PakEntry* entry = mPak.IsMounted( ) ? mPak.Find( info->mAssetUUID ) : nullptr;
+		if ( entry )
+		{
+			return mPak.ReadRange( entry, offset, size, out );
+		}
+
+		return BlockCompressedFile::ReadFileRange( info->mAssetFilePath, offset, size, out );
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::SetCompressCachedAssets( bool enabled )
+	{
+		mCompressCachedAssets = enabled;
+	}
+
+	//============================================================================================ 
+
+	bool AssetManager::GetCompressCachedAssets( ) const
+	{
+		return mCompressCachedAssets;
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::SetAssetFileFormat( AssetFileFormat format )
+	{
+		mAssetFileFormat = format;
+	}
+
+	//============================================================================================ 
+
+	AssetFileFormat AssetManager::GetAssetFileFormat( ) const
+	{
+		return mAssetFileFormat;
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::SetStreamingEnabled( bool enabled )
+	{
+		mStreamingEnabled = enabled;
+	}
+
+	//============================================================================================ 
+
+	bool AssetManager::GetStreamingEnabled( ) const
+	{
+		return mStreamingEnabled;
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::SetStreamingUploadBudget( f32 milliseconds, usize bytes )
+	{
+		mStreamingUploadBudgetMS = milliseconds;
+		mStreamingUploadBudgetBytes = bytes;
+	}
+
+	//============================================================================================ 
+
+	u32 AssetManager::GetStreamingAssetCount( ) const
+	{
+		return mStreamingAssetCount;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::StreamAsset( AssetRecordInfo* info, AssetLoader* loader )
+	{
+		if ( !mStreamingEnabled || !info || !loader || !info->mAssetClass )
+		{
+			return Result::FAILURE;
+		}
+
+		JobSystem* jobs = EngineSubsystem( JobSystem );
+		if ( !jobs || !jobs->GetWorkerCount( ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Need something to stand in for the asset until it's finished
+		const Asset* placeholder = loader->GetDefaultAsset( );
+		if ( !placeholder )
+		{
+			return Result::FAILURE;
+		}
+
+		// Asset is constructed up front so handles can hold on to it while it streams in
+		Asset* asset = ( Asset* )info->mAssetClass->Construct( );
+		if ( !asset )
+		{
+			return Result::FAILURE;
+		}
+
+		// Everything handles might read is set here on the main thread. Workers only touch the asset's own data.
+		asset->mLoader = loader;
+		asset->mName = info->mAssetName;
+		asset->mUUID = info->mAssetUUID;
+		asset->mFilePath = info->mAssetFilePath;
+		asset->mRecordInfo = info;
+		asset->mStreamingPlaceholder = placeholder;
+
+		info->mAsset = asset;
+		info->mAssetLoadStatus = AssetLoadStatus::Loading;
+		mStreamingAssetCount++;
+
+		jobs->Submit( [ this, info, asset ] ( )
+		{
+			StreamedAsset streamed;
+			streamed.mRecord = info;
+			streamed.mAsset = asset;
+
+			// File I/O, decompression and decode all happen here
+			ByteBuffer buffer;
+			if ( ReadAssetFile( info, &buffer ) == Result::SUCCESS )
+			{
+				streamed.mByteSize = buffer.GetSize( );
+				streamed.mResult = AssetArchiver::DeserializeAssetData( &buffer, asset );
+			}
+
+			std::lock_guard< std::mutex > lock( mStreamedAssetsLock );
+			mDecodedAssets.push_back( streamed );
+		}, &mStreamingJobs );
+
+		return Result::SUCCESS;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::LoadStreamedAssetImmediate( AssetRecordInfo* info )
+	{
+		Asset* asset = info ? info->mAsset : nullptr;
+		if ( !asset || !asset->mStreamingPlaceholder )
+		{
+			return Result::FAILURE;
+		}
+
+		ByteBuffer buffer;
+		if ( ReadAssetFile( info, &buffer ) != Result::SUCCESS || AssetArchiver::DeserializeAssetData( &buffer, asset ) != Result::SUCCESS )
+		{
+			// Placeholder is left in place so handles continue to resolve to the default asset
+			info->mAssetLoadStatus = AssetLoadStatus::Failed;
+			return Result::FAILURE;
+		}
+
+		info->mAssetLoadStatus = AssetLoadStatus::Loaded;
+		asset->DeserializeLateInit( );
+		asset->mStreamingPlaceholder = nullptr;
+		info->mAssetClass = asset->Class( );
+
+		return Result::SUCCESS;
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::ProcessStreamedAssets( bool ignoreBudget )
+	{
+		// Grab everything workers have finished decoding since last time
+		{
+			std::lock_guard< std::mutex > lock( mStreamedAssetsLock );
+			mPendingUploads.insert( mPendingUploads.end( ), mDecodedAssets.begin( ), mDecodedAssets.end( ) );
+			mDecodedAssets.clear( );
+		}
+
+		auto start = std::chrono::high_resolution_clock::now( );
+		usize bytesUploaded = 0;
+		usize processed = 0;
+
+		for ( ; processed < mPendingUploads.size( ); ++processed )
+		{
+			// Stop once over budget, but always make progress
+			if ( !ignoreBudget && processed )
+			{
+				f32 elapsedMS = std::chrono::duration< f32, std::milli >( std::chrono::high_resolution_clock::now( ) - start ).count( );
+				if ( elapsedMS >= mStreamingUploadBudgetMS || bytesUploaded >= mStreamingUploadBudgetBytes )
+				{
+					break;
+				}
+			}
+
+			StreamedAsset& streamed = mPendingUploads[ processed ];
+			AssetRecordInfo* info = streamed.mRecord;
+
+			if ( streamed.mResult == Result::SUCCESS )
+			{
+				// Marked loaded before placeholder is cleared, so handles never see an asset loading without one
+				info->mAssetLoadStatus = AssetLoadStatus::Loaded;
+
+				// GPU uploads happen in late init, which has to be on the main thread
+				streamed.mAsset->DeserializeLateInit( );
+				streamed.mAsset->mStreamingPlaceholder = nullptr;
+				info->mAssetClass = streamed.mAsset->Class( );
+			}
+			else
+			{
+				// Fall back to loading it here, which marks record failed if that doesn't work either
+				LoadStreamedAssetImmediate( info );
+			}
+
+			bytesUploaded += streamed.mByteSize;
+			mStreamingAssetCount--;
+		}
+
+		mPendingUploads.erase( mPendingUploads.begin( ), mPendingUploads.begin( ) + processed );
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::SetResidencyBudget( usize bytes )
+	{
+		mResidencyBudgetBytes = bytes;
+	}
+
+	//============================================================================================ 
+
+	usize AssetManager::GetResidencyBudget( ) const
+	{
+		return mResidencyBudgetBytes;
+	}
+
+	//============================================================================================ 
+
+	usize AssetManager::GetResidentMemoryUsage( const MetaClass* assetCls ) const
+	{
+		auto query = mResidentMemoryByClass.find( assetCls );
+		return query != mResidentMemoryByClass.end( ) ? query->second : 0;
+	}
+
+	//============================================================================================ 
+
+	usize AssetManager::GetResidentMemoryUsage( ) const
+	{
+		return mResidentMemoryTotal;
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::UpdateResidency( )
+	{
+		mResidentMemoryByClass.clear( );
+		mResidentMemoryTotal = 0;
+
+		// Account for all loaded assets, collecting ones nothing holds a handle to
+		Vector< AssetRecordInfo* > candidates;
+		for ( auto& l : mLoadersByAssetId )
+		{
+			AssetLoader* loader = l.second;
+			bool canEvict = loader->SupportsEviction( );
+
+			for ( auto& r : loader->mAssetsByUUID )
+			{
+				AssetRecordInfo* info = &r.second;
+
+				// Records that failed to load point at the loader's default asset, which is never released
+				if ( info->mAssetLoadStatus != AssetLoadStatus::Loaded || !info->mAsset || info->mAsset->IsDefault( ) )
+				{
+					continue;
+				}
+
+				usize bytes = info->mAsset->GetResidentMemoryUsage( );
+				mResidentMemoryByClass[ info->mAsset->Class( ) ] += bytes;
+				mResidentMemoryTotal += bytes;
+
+				if ( canEvict && bytes && !info->mAsset->GetHandleReferenceCount( ) )
+				{
+					candidates.push_back( info );
+				}
+			}
+		}
+
+		if ( !mResidencyBudgetBytes || mResidentMemoryTotal <= mResidencyBudgetBytes )
+		{
+			return;
+		}
+
+		// Evict least recently released first until back under budget
+		std::sort( candidates.begin( ), candidates.end( ), [ ] ( const AssetRecordInfo* a, const AssetRecordInfo* b )
+		{
+			return a->mAsset->GetLastReleasedFrame( ) < b->mAsset->GetLastReleasedFrame( );
+		} );
+
+		for ( AssetRecordInfo* info : candidates )
+		{
+			if ( mResidentMemoryTotal <= mResidencyBudgetBytes )
+			{
+				break;
+			}
+
+			usize bytes = info->mAsset->GetResidentMemoryUsage( );
+			mResidentMemoryByClass[ info->mAsset->Class( ) ] -= bytes;
+			mResidentMemoryTotal -= bytes;
+
+			// Record stays registered, so asset is loaded back in from disk on next access
+			info->UnloadAsset( );
+		}
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::FlushStreaming( )
+	{
+		if ( !mStreamingAssetCount )
+		{
+			return;
+		}
+
+		JobSystem* jobs = EngineSubsystem( JobSystem );
+		if ( jobs )
+		{
+			jobs->Wait( &mStreamingJobs );
+		}
+
+		ProcessStreamedAssets( true );
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::PrefetchAssets( const Vector< AssetDependency >& dependencies )
+	{
+		// Start streaming whatever can be, and gather the rest to load here
+		Vector< std::pair< AssetLoader*, AssetRecordInfo* > > immediate;
+		for ( auto& dep : dependencies )
+		{
+			if ( !dep.mAssetClass || !Exists( dep.mAssetClass->GetTypeId( ) ) )
+			{
+				continue;
+			}
+
+			AssetLoader* loader = mLoadersByAssetId[ dep.mAssetClass->GetTypeId( ) ];
+			auto query = loader->mAssetsByUUID.find( dep.mAssetUUID.ToString( ) );
+			if ( query == loader->mAssetsByUUID.end( ) || query->second.mAssetLoadStatus != AssetLoadStatus::Unloaded )
+			{
+				continue;
+			}
+
+			AssetRecordInfo* info = &query->second;
+			if ( loader->SupportsStreaming( ) && StreamAsset( info, loader ) == Result::SUCCESS )
+			{
+				continue;
+			}
+
+			immediate.push_back( std::make_pair( loader, info ) );
+		}
+
+		// Read and decompress files for everything else in parallel
+		Vector< std::unique_ptr< ByteBuffer > > contents( immediate.size( ) );
+		auto readFile = [ & ] ( u32 i )
+		{
+			contents[ i ].reset( new ByteBuffer( ) );
+			if ( ReadAssetFile( immediate[ i ].second, contents[ i ].get( ) ) != Result::SUCCESS )
+			{
+				contents[ i ].reset( );
+			}
+		};
+
+		JobSystem* jobs = EngineSubsystem( JobSystem );
+		if ( jobs )
+		{
+			jobs->ParallelFor( ( u32 )immediate.size( ), readFile );
+		}
+		else
+		{
+			for ( u32 i = 0; i < ( u32 )immediate.size( ); ++i )
+			{
+				readFile( i );
+			}
+		}
+
+		// Deserialize in list order so handles to earlier dependencies resolve to assets that are already loaded
+		for ( usize i = 0; i < immediate.size( ); ++i )
+		{
+			AssetRecordInfo* info = immediate[ i ].second;
+
+			// May have been pulled in already by an asset deserialized before it
+			if ( info->mAssetLoadStatus != AssetLoadStatus::Unloaded )
+			{
+				continue;
+			}
+
+			immediate[ i ].first->LoadRecordAsset( info, contents[ i ].get( ) );
+			if ( !info->mAsset )
+			{
+				info->mAsset = immediate[ i ].first->GetDefaultAsset( );
+			}
+		}
+
+		// Everything has to be resident before caller starts using it
+		FlushStreaming( );
+
+		return Result::SUCCESS;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::PrefetchDependencies( const MetaClass* cls, const UUID& id )
+	{
+		if ( !cls || !Exists( cls->GetTypeId( ) ) )
+		{
+			return Result::FAILURE;
+		}
+
+		AssetLoader* loader = mLoadersByAssetId[ cls->GetTypeId( ) ];
+		auto query = loader->mAssetsByUUID.find( id.ToString( ) );
+		return query != loader->mAssetsByUUID.end( ) ? PrefetchRecordDependencies( &query->second ) : Result::FAILURE;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::PrefetchDependencies( const MetaClass* cls, const String& name )
+	{
+		if ( !cls || !Exists( cls->GetTypeId( ) ) )
+		{
+			return Result::FAILURE;
+		}
+
+		AssetLoader* loader = mLoadersByAssetId[ cls->GetTypeId( ) ];
+		auto query = loader->mAssetsByName.find( Utils::ToLower( name ) );
+		return query != loader->mAssetsByName.end( ) ? PrefetchRecordDependencies( query->second ) : Result::FAILURE;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::PrefetchRecordDependencies( const AssetRecordInfo* info )
+	{
+		// Nothing to gain once asset itself is loaded, its dependencies already were
+		if ( !info || info->mAssetLoadStatus != AssetLoadStatus::Unloaded )
+		{
+			return Result::FAILURE;
+		}
+
+		Vector< AssetDependency > dependencies;
+		if ( AssetDependencies::ReadFromFile( info->mAssetFilePath, &dependencies ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		return PrefetchAssets( dependencies );
+	}
+
+	//============================================================================================ 
+
+	void AssetManager::CacheAssetDependencies( const Asset* asset, const String& filePath ) const
+	{
+		// Only assets that report their own references ( scenes, archetypes ) have lists worth caching
+		Vector< AssetDependency > direct;
+		if ( asset->CollectDependencies( &direct ) == Result::INCOMPLETE )
+		{
+			return;
+		}
+
+		Vector< AssetDependency > dependencies;
+		if ( AssetDependencies::Collect( asset, &dependencies ) == Result::SUCCESS )
+		{
+			AssetDependencies::WriteToFile( filePath, dependencies );
+		}
+	}
+
+	//============================================================================================ 
+
 	void AssetManager::SetDatabaseName( const String& name )
 	{
 		mName = name;
@@ -344,7 +913,7 @@ namespace Enjon
 		// Grab asset info
 		AssetStringInformation assetInfo = GetAssetQualifiedInformation( options->GetResourceFilePath(), options->GetDestinationAssetDirectory(), loader ); 
 
-		// Make sure it doesn't exist already before trying to load it
+		// Make sure it doesn't exist already before trying to load it. Existing assets are updated with ReimportAsset.
 		if ( loader->Exists( assetInfo.mQualifiedName ) )
 		{
 			return Result::FAILURE;
@@ -356,6 +925,10 @@ namespace Enjon
 			return Result::FAILURE;
 		}
 
+		// Settings have to be captured before importing, since importers may reset their options
+		AssetSourceInfo source;
+		GetSourceInfo( options->GetResourceFilePath( ), options, &source );
+
 		// Load the asset from import options
 		asset = loader->LoadResourceFromImporter( options );
 
@@ -374,6 +947,8 @@ namespace Enjon
 			info.mAssetFilePath = assetInfo.mAssetDestinationPath;							// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
 			info.mAssetDisplayName = assetInfo.mDisplayName;
 			info.mAssetLoadStatus = AssetLoadStatus::Loaded;
+			asset->mSourceInfo = source;
+			info.mSourceInfo = source;
 
 			// Add to loader
 			loader->AddToAssets( info );
@@ -403,46 +978,205 @@ namespace Enjon
 		// If loader not valid, fail
 		if ( !options->GetLoader( ) || !Exists( options->GetLoader()->Class() ) )
 		{
-			return Result::FAILURE;
+			return Result::FAILURE;
+		}
+
+		// Grab loader from options
+		AssetLoader* loader = options->GetLoader( )->ConstCast< AssetLoader >( );
+
+		// Grab asset info
+		AssetStringInformation assetInfo = GetAssetQualifiedInformation( options->GetResourceFilePath(), options->GetDestinationAssetDirectory(), loader ); 
+
+		// Make sure it doesn't exist already before trying to load it
+		if ( loader->Exists( assetInfo.mQualifiedName ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Return failure if path doesn't exist
+		if ( !Utils::FileExists( options->GetResourceFilePath( ) ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Add to loader assets with asset record info
+		AssetRecordInfo info;
+		asset->mName = assetInfo.mQualifiedName;
+		asset->mFilePath = assetInfo.mAssetDestinationPath;				// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
+		asset->mUUID = UUID::GenerateUUID( );
+		asset->mLoader = loader;
+		info.mAsset = asset;
+		info.mAssetName = asset->mName;
+		info.mAssetUUID = asset->mUUID;
+		info.mAssetFilePath = assetInfo.mAssetDestinationPath;							// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
+		info.mAssetDisplayName = assetInfo.mDisplayName;
+		info.mAssetLoadStatus = AssetLoadStatus::Loaded;
+		GetSourceInfo( options->GetResourceFilePath( ), options, &asset->mSourceInfo );
+		info.mSourceInfo = asset->mSourceInfo;
+
+		// Add to loader
+		loader->AddToAssets( info );
+ 
+		// Cache asset afterwards
+		Result res = SerializeAsset( asset, assetInfo.mQualifiedName, options->GetDestinationAssetDirectory( ) );
+
+		return res;
+	}
+
+	//============================================================================================ 
+
+	Result AssetManager::AddToDatabase( const Vector< AssetImportRequest >& requests, Vector< Result >* results )
+	{
+		struct BatchImport
+		{
+			AssetLoader* mLoader				= nullptr;
+			String mResourceFilePath;
+			String mDestinationDirectory;
+			AssetStringInformation mAssetInfo;
+			String mCachedFilePath;
+			UUID mUUID;
+			const MetaClass* mAssetClass		= nullptr;
+			AssetSourceInfo mSourceInfo;
+			bool mIsParallel					= false;
+			Result mResult						= Result::FAILURE;
+		};
+
+		Vector< BatchImport > imports( requests.size( ) );
+		std::unordered_set< String > claimedNames;
+
+		// Everything that reads loader state is resolved up front in request order
+		for ( usize i = 0; i < requests.size( ); ++i )
+		{
+			const AssetImportRequest& request = requests[ i ];
+			BatchImport& import = imports[ i ];
+
+			const AssetLoader* loader = nullptr;
+			if ( request.mOptions )
+			{
+				loader = request.mOptions->GetLoader( );
+				import.mResourceFilePath = request.mOptions->GetResourceFilePath( );
+				import.mDestinationDirectory = request.mOptions->GetDestinationAssetDirectory( );
+			}
+			else
+			{
+				loader = GetLoaderByResourceFilePath( request.mResourceFilePath );
+				import.mResourceFilePath = request.mResourceFilePath;
+				import.mDestinationDirectory = request.mDestinationDirectory;
+			}
+
+			if ( !loader || !Exists( loader->Class( ) ) || !Utils::FileExists( import.mResourceFilePath ) )
+			{
+				continue;
+			}
+
+			import.mAssetInfo = GetAssetQualifiedInformation( import.mResourceFilePath, import.mDestinationDirectory, loader );
+
+			// Skip assets already in the database. Duplicates within the batch go to whichever was requested first.
+			if ( loader->Exists( import.mAssetInfo.mQualifiedName ) || !claimedNames.insert( loader->Class( )->GetName( ) + import.mAssetInfo.mQualifiedName ).second )
+			{
+				continue;
+			}
+
+			import.mLoader = loader->ConstCast< AssetLoader >( );
+			import.mIsParallel = import.mLoader->SupportsParallelImport( request.mOptions );
+			import.mCachedFilePath = Utils::FindReplaceAll( GetCachedAssetFilePath( import.mAssetInfo.mDisplayName, loader, import.mDestinationDirectory ), "\\", "/" );
+			import.mUUID = UUID::GenerateUUID( );
+		}
+
+		Vector< u32 > parallelImports;
+		for ( u32 i = 0; i < ( u32 )imports.size( ); ++i )
+		{
+			if ( imports[ i ].mLoader && imports[ i ].mIsParallel )
+			{
+				parallelImports.push_back( i );
+			}
+		}
+
+		// Import, serialize and write each asset on its own. Jobs only touch their own entry.
+		bool compress = mCompressCachedAssets;
+		auto importJob = [ & ] ( u32 j )
+		{
+			BatchImport& import = imports[ parallelImports[ j ] ];
+			const ImportOptions* options = requests[ parallelImports[ j ] ].mOptions;
+
+			// Settings have to be captured before importing, since importers may reset their options
+			GetSourceInfo( import.mResourceFilePath, options, &import.mSourceInfo );
+
+			Asset* asset = import.mLoader->ImportResourceData( import.mResourceFilePath, options );
+			if ( !asset )
+			{
+				return;
+			}
+
+			asset->mName = import.mAssetInfo.mQualifiedName;
+			asset->mUUID = import.mUUID;
+			asset->mLoader = import.mLoader;
+			asset->mFilePath = import.mCachedFilePath;
+			asset->mSourceInfo = import.mSourceInfo;
+			import.mAssetClass = asset->Class( );
+
+			AssetArchiver archiver;
+			if ( archiver.Serialize( asset ) == Result::SUCCESS )
+			{
+				import.mResult = compress ? archiver.WriteToCompressedFile( import.mCachedFilePath ) : archiver.WriteToFile( import.mCachedFilePath );
+			}
+
+			// Nothing has been uploaded, and the asset is loaded back in from its cached file when first used
+			delete asset;
+		};
+
+		JobSystem* jobs = EngineSubsystem( JobSystem );
+		if ( jobs )
+		{
+			jobs->ParallelFor( ( u32 )parallelImports.size( ), importJob );
+		}
+		else
+		{
+			for ( u32 j = 0; j < ( u32 )parallelImports.size( ); ++j )
+			{
+				importJob( j );
+			}
 		}
 
-		// Grab loader from options
-		AssetLoader* loader = options->GetLoader( )->ConstCast< AssetLoader >( );
+		// Register with loaders and manifest in request order. Imports that had to wait for the main thread happen here.
+		Result res = Result::SUCCESS;
+		for ( usize i = 0; i < imports.size( ); ++i )
+		{
+			BatchImport& import = imports[ i ];
 
-		// Grab asset info
-		AssetStringInformation assetInfo = GetAssetQualifiedInformation( options->GetResourceFilePath(), options->GetDestinationAssetDirectory(), loader ); 
+			if ( import.mLoader && import.mIsParallel && import.mResult == Result::SUCCESS )
+			{
+				CacheManifestRecord record;
+				record.mAssetUUID = import.mUUID;
+				record.mAssetFilePath = import.mCachedFilePath;
+				record.mAssetLoaderClass = import.mLoader->Class( );
+				record.mAssetClass = import.mAssetClass;
+				record.mAssetName = import.mAssetInfo.mQualifiedName;
+				record.mSourceInfo = import.mSourceInfo;
+
+				import.mLoader->AddRecord( record );
+				mCacheManifest.AddRecord( record );
+			}
+			else if ( import.mLoader && !import.mIsParallel )
+			{
+				import.mResult = requests[ i ].mOptions ? AddToDatabase( requests[ i ].mOptions ) : AddToDatabase( import.mResourceFilePath, import.mDestinationDirectory );
+			}
 
-		// Make sure it doesn't exist already before trying to load it
-		if ( loader->Exists( assetInfo.mQualifiedName ) )
-		{
-			return Result::FAILURE;
+			if ( import.mResult != Result::SUCCESS )
+			{
+				res = Result::FAILURE;
+			}
 		}
 
-		// Return failure if path doesn't exist
-		if ( !Utils::FileExists( options->GetResourceFilePath( ) ) )
+		if ( results )
 		{
-			return Result::FAILURE;
+			results->clear( );
+			for ( auto& import : imports )
+			{
+				results->push_back( import.mResult );
+			}
 		}
 
-		// Add to loader assets with asset record info
-		AssetRecordInfo info;
-		asset->mName = assetInfo.mQualifiedName;
-		asset->mFilePath = assetInfo.mAssetDestinationPath;				// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
-		asset->mUUID = UUID::GenerateUUID( );
-		asset->mLoader = loader;
-		info.mAsset = asset;
-		info.mAssetName = asset->mName;
-		info.mAssetUUID = asset->mUUID;
-		info.mAssetFilePath = assetInfo.mAssetDestinationPath;							// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
-		info.mAssetDisplayName = assetInfo.mDisplayName;
-		info.mAssetLoadStatus = AssetLoadStatus::Loaded;
-
-		// Add to loader
-		loader->AddToAssets( info );
- 
-		// Cache asset afterwards
-		Result res = SerializeAsset( asset, assetInfo.mQualifiedName, options->GetDestinationAssetDirectory( ) );
-
 		return res;
 	}
 
@@ -516,6 +1250,8 @@ namespace Enjon
 						info.mAssetFilePath = assetInfo.mAssetDestinationPath;							// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
 						info.mAssetDisplayName = assetInfo.mDisplayName;
 						info.mAssetLoadStatus = AssetLoadStatus::Loaded;
+						GetSourceInfo( resourceFilePath, nullptr, &asset->mSourceInfo );
+						info.mSourceInfo = asset->mSourceInfo;
 
 						// Add to loader
 						query->second->AddToAssets( info );
@@ -620,6 +1356,8 @@ namespace Enjon
 							info.mAssetFilePath = asset->mFilePath;							// THIS IS INCORRECT! NEED TO CHANGE TO BEING THE ACTUAL CACHED ASSET PATH!
 							info.mAssetLoadStatus = AssetLoadStatus::Loaded;
 							info.mAssetDisplayName = asset->mName;
+							GetSourceInfo( asset->mFilePath, nullptr, &asset->mSourceInfo );
+							info.mSourceInfo = asset->mSourceInfo;
 
 							// Add to loader
 							query->second->AddToAssets( info );
@@ -669,6 +1407,8 @@ namespace Enjon
 							info.mAssetFilePath = asset->mFilePath;
 							info.mAssetLoadStatus = AssetLoadStatus::Loaded;
 							info.mAssetDisplayName = asset->mName;
+							GetSourceInfo( asset->mFilePath, nullptr, &asset->mSourceInfo );
+							info.mSourceInfo = asset->mSourceInfo;
 
 							// Add to loader
 							query->second->AddToAssets( info );
@@ -702,33 +1442,38 @@ namespace Enjon
 		// Should the UUID of the asset be written here? Should it be in the ObjectArchiver serialize path?
 		// Should there be a separate archiver that is in charge specifically of assets?  
 
-		Result res = archiver.Serialize( asset ); 
-
-		// Get file extension from loader
-		String fileExtension = asset->mLoader->GetAssetFileExtension( );
-
 		// Write to file using archiver 
-		String assetPath = path;
+		String assetPath = GetCachedAssetFilePath( asset->GetAssetRecordInfo( )->GetAssetDisplayName( ), asset->mLoader, path );
 
-		// If path is empty, then set assetPath to cached directory
-		if ( path.compare( "" ) == 0 )
-		{
-			assetPath = mCachedDirectoryPath + asset->GetAssetRecordInfo()->GetAssetDisplayName() + fileExtension; 
-		}
-		else
+		// Assets that handle their own serialization are left to the binary archiver
+		Result res = ( mAssetFileFormat == AssetFileFormat::Text ) ? JSONArchiver::SerializeAsset( asset, Utils::FindReplaceAll( assetPath, "\\", "/" ) ) : Result::INCOMPLETE;
+
+		if ( res == Result::INCOMPLETE )
 		{
-			assetPath = path + "/" + asset->GetAssetRecordInfo()->GetAssetDisplayName() + fileExtension;
+			res = archiver.Serialize( asset ); 
+
+			// Write the binary to file
+			if ( mCompressCachedAssets )
+			{
+				archiver.WriteToCompressedFile( Utils::FindReplaceAll( assetPath, "\\", "/" ) );
+			}
+			else
+			{
+				archiver.WriteToFile( Utils::FindReplaceAll( assetPath, "\\", "/" ) );
+			}
 		}
 
-		// Write the binary to file
-		archiver.WriteToFile( Utils::FindReplaceAll( assetPath, "\\", "/" ) );
+		// Dependency list is stamped with the file just written, so has to come after it
+		CacheAssetDependencies( asset, Utils::FindReplaceAll( assetPath, "\\", "/" ) );
 
 		// Construct and add record to manifest
 		CacheManifestRecord record;
 		record.mAssetUUID = asset->mUUID;
 		record.mAssetFilePath = assetPath;
 		record.mAssetLoaderClass = asset->mLoader->Class( );
+		record.mAssetClass = asset->Class( );
 		record.mAssetName = asset->mName;
+		record.mSourceInfo = asset->mSourceInfo;
 		mCacheManifest.AddRecord( record ); 
 
 		return res;
@@ -736,6 +1481,337 @@ namespace Enjon
 
 	//======================================================================================================
 
+	String AssetManager::GetCachedAssetFilePath( const String& displayName, const AssetLoader* loader, const String& directory ) const
+	{
+		// Get file extension from loader
+		String fileExtension = loader->GetAssetFileExtension( );
+
+		// If path is empty, then set to cached directory
+		if ( directory.compare( "" ) == 0 )
+		{
+			return mCachedDirectoryPath + displayName + fileExtension; 
+		}
+
+		return directory + "/" + displayName + fileExtension;
+	}
+
+	//======================================================================================================
+
+	INTERNAL String NormalizeSourcePath( const String& path )
+	{
+		std::error_code ec;
+		FS::path p = FS::absolute( Utils::FindReplaceAll( path, "\\", "/" ), ec );
+		String normalized = ( ec ? FS::path( path ) : p ).lexically_normal( ).generic_string( );
+
+		// Directories compare the same with or without a trailing separator
+		if ( normalized.size( ) > 1 && normalized.back( ) == '/' )
+		{
+			normalized.pop_back( );
+		}
+
+		return normalized;
+	}
+
+	//======================================================================================================
+
+	String AssetManager::GetStoredSourcePath( const String& resourceFilePath ) const
+	{
+		String sourcePath = NormalizeSourcePath( resourceFilePath );
+		FS::path relative = FS::path( sourcePath ).lexically_relative( NormalizeSourcePath( mAssetsDirectoryPath ) );
+
+		// Sources outside of assets directory can't move with the project, so are kept absolute
+		if ( relative.empty( ) || relative.begin( )->string( ) == ".." )
+		{
+			return sourcePath;
+		}
+
+		return relative.generic_string( );
+	}
+
+	//======================================================================================================
+
+	String AssetManager::GetAbsoluteSourcePath( const String& storedPath ) const
+	{
+		if ( storedPath.empty( ) || FS::path( storedPath ).is_absolute( ) )
+		{
+			return storedPath;
+		}
+
+		return NormalizeSourcePath( mAssetsDirectoryPath + "/" + storedPath );
+	}
+
+	//======================================================================================================
+
+	Result AssetManager::GetSourceInfo( const String& resourceFilePath, const ImportOptions* options, AssetSourceInfo* out, const AssetSourceInfo* previous ) const
+	{
+		if ( !out )
+		{
+			return Result::FAILURE;
+		}
+
+		// File is read through its absolute path, but its path is stored relative to assets directory
+		String sourcePath = NormalizeSourcePath( resourceFilePath );
+		out->mSourceFilePath = GetStoredSourcePath( sourcePath );
+
+		std::error_code ec;
+		out->mSourceFileSize = ( u64 )FS::file_size( sourcePath, ec );
+		if ( ec )
+		{
+			return Result::FAILURE;
+		}
+		out->mSourceWriteTime = ( s64 )FS::last_write_time( sourcePath, ec ).time_since_epoch( ).count( );
+
+		// Untouched files keep their hash, anything else has its contents hashed since saving doesn't always change them
+		if ( previous && previous->mSourceHash && 
+			previous->mSourceFilePath == out->mSourceFilePath && 
+			previous->mSourceFileSize == out->mSourceFileSize && 
+			previous->mSourceWriteTime == out->mSourceWriteTime )
+		{
+			out->mSourceHash = previous->mSourceHash;
+		}
+		else if ( !Utils::HashFile( sourcePath, &out->mSourceHash ) )
+		{
+			return Result::FAILURE;
+		}
+
+		out->mImportSettings.clear( );
+		if ( options )
+		{
+			ByteBuffer settings;
+			options->SerializeSettings( &settings );
+			out->mImportSettings.assign( ( const char* )settings.GetData( ), settings.GetSize( ) );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//======================================================================================================
+
+	Result AssetManager::ReimportRecord( AssetLoader* loader, AssetRecordInfo* info, const AssetSourceInfo& source, const ImportOptions* options )
+	{
+		if ( !loader || !info )
+		{
+			return Result::FAILURE;
+		}
+
+		// Name belongs to an asset imported from another file. Records cached before sources were recorded are claimed by whichever source reimports them first.
+		const AssetSourceInfo& previous = info->mSourceInfo;
+		String sourcePath = GetAbsoluteSourcePath( source.mSourceFilePath );
+		if ( !previous.mSourceFilePath.empty( ) && GetAbsoluteSourcePath( previous.mSourceFilePath ) != sourcePath )
+		{
+			return Result::FAILURE;
+		}
+
+		// Nothing to do if neither source contents nor import settings have changed
+		if ( !previous.mSourceFilePath.empty( ) && previous.mSourceHash == source.mSourceHash && previous.mImportSettings == source.mImportSettings )
+		{
+			return Result::SUCCESS;
+		}
+
+		// Importers with side effects ( registering skeletons, animations ) would create duplicates, so those have to be reimported by hand
+		Asset* asset = nullptr;
+		if ( loader->SupportsParallelImport( options ) )
+		{
+			asset = loader->ImportResourceData( sourcePath, options );
+		}
+		else if ( !options )
+		{
+			asset = loader->LoadResourceFromFile( sourcePath );
+		}
+
+		if ( !asset )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( info->mAssetClass && asset->Class( ) != info->mAssetClass )
+		{
+			delete asset;
+			return Result::FAILURE;
+		}
+
+		// Written over the existing cached file, so references by UUID stay valid
+		asset->mName = info->mAssetName;
+		asset->mUUID = info->mAssetUUID;
+		asset->mLoader = loader;
+		asset->mFilePath = info->mAssetFilePath;
+		asset->mSourceInfo = source;
+		const MetaClass* assetClass = asset->Class( );
+
+		AssetArchiver archiver;
+		Result res = archiver.Serialize( asset );
+		if ( res == Result::SUCCESS )
+		{
+			res = mCompressCachedAssets ? archiver.WriteToCompressedFile( info->mAssetFilePath ) : archiver.WriteToFile( info->mAssetFilePath );
+		}
+
+		// Loaded asset is reloaded from the new file below, so the imported copy is no longer needed
+		delete asset;
+
+		if ( res != Result::SUCCESS )
+		{
+			return res;
+		}
+
+		info->mSourceInfo = source;
+
+		CacheManifestRecord record;
+		record.mAssetUUID = info->mAssetUUID;
+		record.mAssetFilePath = info->mAssetFilePath;
+		record.mAssetName = info->mAssetName;
+		record.mAssetLocationType = info->mAssetLocationType;
+		record.mAssetLoaderClass = loader->Class( );
+		record.mAssetClass = assetClass;
+		record.mSourceInfo = source;
+		mCacheManifest.UpdateRecord( record );
+
+		// Deserialized in place so existing handles see the new data
+		if ( info->mAsset )
+		{
+			info->ReloadAsset( );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//======================================================================================================
+
+	Result AssetManager::ReimportAsset( const ImportOptions* options )
+	{
+		// If loader not valid, fail
+		if ( !options || !options->GetLoader( ) || !Exists( options->GetLoader( )->Class( ) ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Grab loader from options
+		AssetLoader* loader = options->GetLoader( )->ConstCast< AssetLoader >( );
+
+		// Asset has to have been imported already
+		AssetStringInformation assetInfo = GetAssetQualifiedInformation( options->GetResourceFilePath( ), options->GetDestinationAssetDirectory( ), loader ); 
+		auto query = loader->mAssetsByName.find( assetInfo.mQualifiedName );
+		if ( query == loader->mAssetsByName.end( ) )
+		{
+			return Result::FAILURE;
+		}
+
+		AssetSourceInfo source;
+		if ( GetSourceInfo( options->GetResourceFilePath( ), options, &source, &query->second->mSourceInfo ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		return ReimportRecord( loader, query->second, source, options );
+	}
+
+	//======================================================================================================
+
+	Result AssetManager::ReimportAsset( const String& resourceFilePath )
+	{
+		String sourcePath = NormalizeSourcePath( resourceFilePath );
+
+		// Several assets can come from one source ( meshes and their skeletons )
+		Vector< std::pair< AssetLoader*, AssetRecordInfo* > > records;
+		for ( auto& l : mLoadersByAssetId )
+		{
+			for ( auto& r : l.second->mAssetsByUUID )
+			{
+				if ( GetAbsoluteSourcePath( r.second.mSourceInfo.mSourceFilePath ) == sourcePath )
+				{
+					records.push_back( std::make_pair( l.second, &r.second ) );
+				}
+			}
+		}
+
+		if ( records.empty( ) )
+		{
+			return Result::FAILURE;
+		}
+
+		Result res = Result::SUCCESS;
+		for ( auto& r : records )
+		{
+			AssetLoader* loader = r.first;
+			AssetRecordInfo* info = r.second;
+
+			// Reimport with the settings asset was imported with, applied to loader's options for the duration
+			ImportOptions* options = nullptr;
+			ByteBuffer savedSettings;
+			String savedPath;
+			if ( !info->mSourceInfo.mImportSettings.empty( ) )
+			{
+				options = loader->GetImportOptions( ) ? loader->GetImportOptions( )->ConstCast< ImportOptions >( ) : nullptr;
+				if ( !options )
+				{
+					res = Result::FAILURE;
+					continue;
+				}
+
+				options->SerializeSettings( &savedSettings );
+				savedPath = options->mResourceFilePath;
+
+				ByteBuffer settings;
+				settings.WriteBytes( ( const u8* )info->mSourceInfo.mImportSettings.data( ), ( u32 )info->mSourceInfo.mImportSettings.size( ) );
+				options->DeserializeSettings( &settings );
+				options->mResourceFilePath = sourcePath;
+			}
+
+			AssetSourceInfo source;
+			Result reimported = GetSourceInfo( sourcePath, options, &source, &info->mSourceInfo );
+			if ( reimported == Result::SUCCESS )
+			{
+				reimported = ReimportRecord( loader, info, source, options );
+			}
+
+			if ( options )
+			{
+				options->DeserializeSettings( &savedSettings );
+				options->mResourceFilePath = savedPath;
+			}
+
+			if ( reimported != Result::SUCCESS )
+			{
+				res = Result::FAILURE;
+			}
+		}
+
+		return res;
+	}
+
+	//======================================================================================================
+
+	void AssetManager::ProcessSourceChanges( )
+	{
+		Vector< String > changed;
+		mSourceWatcher.Poll( &changed );
+
+		// Cached asset files written into the assets directory aren't sources of anything
+		std::sort( changed.begin( ), changed.end( ) );
+		for ( auto& path : changed )
+		{
+			if ( GetLoaderByResourceFilePath( path ) )
+			{
+				ReimportAsset( path );
+			}
+		}
+	}
+
+	//======================================================================================================
+
+	void AssetManager::SetHotReloadEnabled( bool enabled )
+	{
+		mHotReloadEnabled = enabled;
+	}
+
+	//======================================================================================================
+
+	bool AssetManager::GetHotReloadEnabled( ) const
+	{
+		return mHotReloadEnabled;
+	}
+
+	//======================================================================================================
+
 	Result AssetManager::SaveAsset( const Asset* asset ) const
 	{
 		// Can only save asset if it's valid and NOT a default engine asset
@@ -744,9 +1820,34 @@ namespace Enjon
 			const AssetRecordInfo* info = asset->GetAssetRecordInfo( );
 			if ( info )
 			{
-				AssetArchiver archiver;
-				Result res = archiver.Serialize( asset );
-				archiver.WriteToFile( info->GetAssetFilePath( ) );
+				// Assets that handle their own serialization are left to the binary archiver
+				Result res = ( mAssetFileFormat == AssetFileFormat::Text ) ? JSONArchiver::SerializeAsset( asset, info->GetAssetFilePath( ) ) : Result::INCOMPLETE;
+				if ( res == Result::INCOMPLETE )
+				{
+					AssetArchiver archiver;
+					res = archiver.Serialize( asset );
+
+					// Partial data would overwrite a good cached file
+					if ( res != Result::SUCCESS )
+					{
+						return res;
+					}
+
+					if ( mCompressCachedAssets )
+					{
+						archiver.WriteToCompressedFile( info->GetAssetFilePath( ) );
+					}
+					else
+					{
+						archiver.WriteToFile( info->GetAssetFilePath( ) );
+					}
+				}
+				else if ( res != Result::SUCCESS )
+				{
+					return res;
+				}
+
+				CacheAssetDependencies( asset, info->GetAssetFilePath( ) );
 
 				return Result::SUCCESS;
 			}
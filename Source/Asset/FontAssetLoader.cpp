@@ -3,6 +3,8 @@
 
 #include "Asset/FontAssetLoader.h" 
 
+#include <fstream>
+
 namespace Enjon
 { 
 	//======================================================================
@@ -14,6 +16,7 @@ namespace Enjon
 
 		// Load font
 		UIFont* font = new UIFont( filePath ); 
+		font->BuildSDFAtlas( );
 
 		// Set default
 		mDefaultAsset = font;
@@ -26,6 +29,9 @@ namespace Enjon
 		// Create new font
 		UIFont* font = new UIFont( filePath ); 
 
+		// Cook distance field atlas once, so it's cached along with font
+		font->BuildSDFAtlas( );
+
 		// Return font
 		return font;
 	} 
@@ -38,4 +44,42 @@ namespace Enjon
 	}
 
 	//=====================================================================================================
+
+	bool FontAssetLoader::SupportsParallelImport( const ImportOptions* options ) const
+	{
+		return true;
+	}
+
+	//=====================================================================================================
+
+	Asset* FontAssetLoader::ImportResourceData( const String& filePath, const ImportOptions* options )
+	{
+		// Read file directly rather than through imgui, whose allocator isn't safe to use off the main thread
+		std::ifstream file( filePath, std::ios::in | std::ios::binary | std::ios::ate );
+		if ( !file )
+		{
+			return nullptr;
+		}
+
+		UIFont* font = new UIFont( );
+		font->mFontData.mSize = ( u32 )file.tellg( );
+		font->mFontData.mData = ( u8* )malloc( font->mFontData.mSize );
+
+		file.seekg( 0, std::ios::beg );
+		file.read( ( char* )font->mFontData.mData, font->mFontData.mSize );
+
+		if ( ( u32 )file.gcount( ) != font->mFontData.mSize )
+		{
+			free( font->mFontData.mData );
+			delete font;
+			return nullptr;
+		}
+
+		// Cooked here on worker thread rather than at first use on main thread
+		font->BuildSDFAtlas( );
+
+		return font;
+	}
+
+	//=====================================================================================================
 }
@@ -8,13 +8,24 @@
 #include "Asset/AssetManager.h"
 #include "Graphics/Skeleton.h"
 #include "Graphics/SkeletalAnimation.h"
+#include "Graphics/SkeletalMesh.h"
+#include "Graphics/Material.h"
 #include "ImGui/ImGuiManager.h"
+#include "System/JobSystem.h"
+#include "Utils/FileUtils.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
+#include <assimp/config.h>
+
+#include <cctype>
+
+// Post processing shared by every asset imported from a model file. Vertices are indexed and cache ordered by
+// the mesh optimizer afterwards, so joining and cache locality steps aren't run here.
+#define ENJON_MESH_IMPORT_FLAGS		( aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_LimitBoneWeights | aiProcess_GenUVCoords )
 
 namespace Enjon
 { 
@@ -28,6 +39,35 @@ namespace Enjon
 
 	//==========================================================================================
 
+	void MeshAssetLoader::ExplicitDestructor( )
+	{
+		ReleaseImporter( );
+		AssetLoader::ExplicitDestructor( );
+	}
+
+	//==========================================================================================
+
+	const aiScene* MeshAssetLoader::ReadScene( Assimp::Importer* importer, const String& filePath )
+	{
+		// Skinned vertices hold as many joints as skeletal meshes store
+		importer->SetPropertyInteger( AI_CONFIG_PP_LBW_MAX_WEIGHTS, ENJON_MAX_NUM_JOINTS_PER_VERTEX );
+
+		// NOTE(): Flipping UVs FUCKS IT ALL because I'm already flipping UVs in the shader generation process (shadergraph). Need to fix this.  
+		const aiScene* scene = importer->ReadFile( filePath, ENJON_MESH_IMPORT_FLAGS );
+		return ( scene && scene->mRootNode ) ? scene : nullptr;
+	}
+
+	//==========================================================================================
+
+	void MeshAssetLoader::ReleaseImporter( )
+	{
+		delete mImporter;
+		mImporter = nullptr;
+		mImporterFilePath.clear( );
+	}
+
+	//==========================================================================================
+
 #define CREATE_QUAD_VERTEX( VertexName, X, Y, U, V )\
 	Vert VertexName = { };\
 	VertexName.Position[ 0 ] = X;\
@@ -88,80 +128,10 @@ namespace Enjon
 		WRITE_VERT_DATA( TR, sm->mVertexData )
 		WRITE_VERT_DATA( TL, sm->mVertexData )
 
-		// Create and upload mesh data
-		glGenBuffers( 1, &sm->mVBO );
-		glBindBuffer( GL_ARRAY_BUFFER, sm->mVBO );
-		glBufferData( GL_ARRAY_BUFFER, sm->mVertexData.GetSize( ), sm->mVertexData.GetData( ), GL_STATIC_DRAW );
-		glGenVertexArrays( 1, &sm->mVAO );
-		glBindVertexArray( sm->mVAO );
-
-		// Get vertex data decl from owning mesh
-		const VertexDataDeclaration& vertDecl = mesh->GetVertexDeclaration( );
-
-		// Grab total size in bytes for data declaration
-		usize vertexDeclSize = vertDecl.GetSizeInBytes( );
-
-		// Vertex Attributes
-		for ( u32 i = 0; i < vertDecl.mDecl.size(); ++i )
-		{
-			// Grab attribute
-			VertexAttributeFormat attribute = vertDecl.mDecl.at( i );
-
-			// Enable vertex attribute array
-			glEnableVertexAttribArray( i );
-
-			// Upload attribute
-			switch ( attribute )
-			{
-				case VertexAttributeFormat::Float4:
-				{
-					glVertexAttribPointer( i, 4, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float3:
-				{
-					glVertexAttribPointer( i, 3, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float2:
-				{
-					glVertexAttribPointer( i, 2, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float:
-				{
-					glVertexAttribPointer( i, 1, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt4:
-				{
-					glVertexAttribPointer( i, 4, GL_UNSIGNED_INT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt3:
-				{
-					glVertexAttribPointer( i, 3, GL_UNSIGNED_INT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt2:
-				{
-					glVertexAttribPointer( i, 2, GL_UNSIGNED_INT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt:
-				{
-					glVertexAttribPointer( i, 1, GL_UNSIGNED_INT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-			}
-		} 
-
-		// Unbind VAO
-		glBindVertexArray( 0 );
+		// Cook into shared corners and upload
+		MeshOptimizer::CookSubMesh( sm, mesh->GetVertexDeclaration( ) );
+		sm->UploadVertexData( );
 
-		// Set draw type
-		sm->mDrawType = GL_TRIANGLES;
-		// Set draw count
-		sm->mDrawCount = sm->mVertexData.GetSize( ) / vertDecl.GetSizeInBytes( ); 
 		// Set mesh name
 		mesh->mName = "DefaultMesh"; 
 
@@ -224,15 +194,19 @@ namespace Enjon
 			return nullptr;
 		}
 
-		Assimp::Importer importer;		
-	
-		const aiScene* scene = importer.ReadFile( meshOptions->mResourceFilePath, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_LimitBoneWeights ); 
-		if ( !scene || !scene->mRootNode )
+		// Scene parsed when import began is reused, so file is only read once for every asset made from it
+		Assimp::Importer importer;
+		const aiScene* scene = ( mImporter && mImporterFilePath == meshOptions->mResourceFilePath ) ? mImporter->GetScene( ) : ReadScene( &importer, meshOptions->mResourceFilePath );
+		if ( !scene )
 		{
 			// Error 
+			ReleaseImporter( );
 			return nullptr;
 		} 
 
+		// Every loader below builds from this scene instead of reading file again
+		meshOptions->mScene = scene;
+
 		// Check whether or not the scene has animations
 		bool createAnimation = meshOptions->mCreateAnimations;
 
@@ -242,58 +216,81 @@ namespace Enjon
 		// Detect whether or not scene has any mesh data
 		bool createMesh = meshOptions->mCreateMesh; 
 
-		// Skeleton asset to either create or reference
-		AssetHandle< Skeleton > skeleton;
-
 		// Mesh to return
 		Mesh* mesh = nullptr;
 
 		// Grab asset manager
 		AssetManager* am = EngineSubsystem( AssetManager );
+		SkeletalMeshAssetLoader* smal = am->GetLoader( Object::GetClass< SkeletalMeshAssetLoader >( ) )->ConstCast< SkeletalMeshAssetLoader >( );
+		SkeletalAnimationAssetLoader* saal = am->GetLoader( Object::GetClass< SkeletalAnimationAssetLoader >( ) )->ConstCast< SkeletalAnimationAssetLoader >( );
 
-		if ( createMesh )
-		{
-			// Determine if is skeletal mesh
-			if ( createSkeleton )
-			{ 
-				// Construct skeleton and create it
-				SkeletonAssetLoader* sal = am->GetLoader( Object::GetClass< SkeletonAssetLoader >( ) )->ConstCast< SkeletonAssetLoader >();
-				meshOptions->mSkeletonAsset = sal->DirectImport( meshOptions );
-			}
+		// Skeleton is referenced by skeletal mesh and animations, so is created and registered first
+		if ( createMesh && createSkeleton )
+		{ 
+			SkeletonAssetLoader* sal = am->GetLoader( Object::GetClass< SkeletonAssetLoader >( ) )->ConstCast< SkeletonAssetLoader >();
+			meshOptions->mSkeletonAsset = sal->DirectImport( meshOptions );
+		}
 
-			if ( meshOptions->mSkeletonAsset && createMesh )
-			{
-				SkeletalMeshAssetLoader* smal = am->GetLoader( Object::GetClass< SkeletalMeshAssetLoader >( ) )->ConstCast< SkeletalMeshAssetLoader >( );
-				smal->DirectImport( meshOptions );
-			} 
-			// Otherwise static graphics mesh 
-			else
+		// Remaining assets only read scene, so are built side by side. Uploading and registering happens after, here.
+		bool createSkeletalMesh = createMesh && meshOptions->mSkeletonAsset;
+		bool createStaticMesh = createMesh && !createSkeletalMesh;
+		SkeletalMesh* skeletalMesh = nullptr;
+		SkeletalAnimation* animation = nullptr;
+		JobSystem::ParallelForOrSerial( 3, [ & ] ( u32 i )
+		{
+			switch ( i )
 			{
-				// Construct new static mesh to fill out...
-				mesh = new Mesh( );
-
-				// Construct decl for new mesh
-				VertexDataDeclaration decl;
-				decl.Add( VertexAttributeFormat::Float3 );			// Position
-				decl.Add( VertexAttributeFormat::Float3 );			// Normal
-				decl.Add( VertexAttributeFormat::Float3 );			// Tangent
-				decl.Add( VertexAttributeFormat::Float2 );			// UV
+				case 0: 
+				{
+					if ( createStaticMesh )
+					{
+						mesh = ConstructStaticMesh( scene, meshOptions );
+					}
+				} break;
 
-				// Set vertex decl for mesh
-				mesh->SetVertexDecl( decl );
+				case 1:
+				{
+					if ( createSkeletalMesh )
+					{
+						skeletalMesh = smal->ConstructSkeletalMesh( scene, meshOptions );
+					}
+				} break;
 
-				// Process node of mesh
-				ProcessNode( scene->mRootNode, scene, mesh ); 
+				case 2:
+				{
+					if ( createAnimation )
+					{
+						animation = saal->ConstructAnimation( scene, meshOptions );
+					}
+				} break;
 			}
-		} 
+		} );
+
+		if ( mesh )
+		{
+			mesh->DeserializeLateInit( );
+		}
 
-		// If need to process animation
-		if ( createAnimation )
+		if ( skeletalMesh )
 		{
-			SkeletalAnimationAssetLoader* saal = am->GetLoader( Object::GetClass< SkeletalAnimationAssetLoader >( ) )->ConstCast< SkeletalAnimationAssetLoader >( );
-			saal->DirectImport( options );
+			skeletalMesh->DeserializeLateInit( );
+			smal->AddImported( skeletalMesh, meshOptions );
 		}
 
+		if ( animation )
+		{
+			saal->AddImported( animation, meshOptions );
+		}
+
+		if ( createMesh )
+		{
+			ConstructMaterials( scene, meshOptions );
+		}
+
+		// Scene is no longer needed by anything
+		meshOptions->mScene = nullptr;
+		ReleaseImporter( );
+
 		// Reset mesh options
 		meshOptions->Reset( );
 
@@ -303,17 +300,105 @@ namespace Enjon
 
 	//============================================================================================================
 
+	INTERNAL AssetHandle< Texture > ImportMaterialTexture( const aiMaterial* aimat, aiTextureType type, const MeshImportOptions* options )
+	{
+		// Embedded textures ( "*0" ) aren't files, so are left to be assigned by hand
+		aiString texturePath;
+		if ( aimat->GetTexture( type, 0, &texturePath ) != AI_SUCCESS || texturePath.length == 0 || texturePath.data[ 0 ] == '*' )
+		{
+			return AssetHandle< Texture >( );
+		}
+
+		// Paths are relative to model file
+		ghc::filesystem::path modelDirectory = ghc::filesystem::path( options->GetResourceFilePath( ) ).parent_path( );
+		String filePath = Utils::FindReplaceAll( ( modelDirectory / Utils::FindReplaceAll( texturePath.C_Str( ), "\\", "/" ) ).string( ), "\\", "/" );
+		if ( !Utils::FileExists( filePath ) )
+		{
+			return AssetHandle< Texture >( );
+		}
+
+		// Textures shared between materials or models are only imported once
+		AssetManager* am = EngineSubsystem( AssetManager );
+		const AssetLoader* loader = am->GetLoaderByResourceFilePath( filePath );
+		if ( !loader )
+		{
+			return AssetHandle< Texture >( );
+		}
+
+		String destDir = options->GetDestinationAssetDirectory( );
+		String qualifiedName = AssetManager::GetAssetQualifiedInformation( filePath, destDir, loader ).mQualifiedName;
+		if ( !loader->Exists( qualifiedName ) && am->AddToDatabase( filePath, destDir ) != Result::SUCCESS )
+		{
+			return AssetHandle< Texture >( );
+		}
+
+		return am->GetAsset< Texture >( qualifiedName );
+	}
+
+	//============================================================================================================
+
+	void MeshAssetLoader::ConstructMaterials( const aiScene* scene, const MeshImportOptions* options )
+	{
+		AssetManager* am = EngineSubsystem( AssetManager );
+		String modelName = AssetManager::GetAssetQualifiedInformation( options->GetResourceFilePath( ), options->GetDestinationAssetDirectory( ), this ).mDisplayName;
+
+		// Same graph editor gives textured materials, which is default graph when that isn't in the database
+		AssetHandle< ShaderGraph > graph = am->GetAsset< ShaderGraph >( "shaders.shadergraphs.defaultstaticgeom" );
+
+		for ( u32 i = 0; i < scene->mNumMaterials; ++i )
+		{
+			const aiMaterial* aimat = scene->mMaterials[ i ];
+
+			// Name becomes asset file name, so anything but letters and digits is replaced
+			aiString aiName;
+			String name = ( aimat->Get( AI_MATKEY_NAME, aiName ) == AI_SUCCESS && aiName.length ) ? String( aiName.C_Str( ) ) : "Material" + std::to_string( i );
+			for ( auto& c : name )
+			{
+				c = std::isalnum( ( u8 )c ) ? c : '_';
+			}
+
+			AssetHandle< Material > handle = am->ConstructAsset< Material >( modelName + "_" + name, options->GetDestinationAssetDirectory( ) );
+			Material* material = handle.Get( ) ? handle.Get( )->ConstCast< Material >( ) : nullptr;
+			if ( !material )
+			{
+				continue;
+			}
+
+			material->SetShaderGraph( graph );
+
+			AssetHandle< Texture > albedo = ImportMaterialTexture( aimat, aiTextureType_DIFFUSE, options );
+			if ( albedo.Get( ) )
+			{
+				material->SetUniform( "albedoMap", albedo );
+			}
+
+			// Normal maps of some formats ( obj's bump ) come through as height maps
+			AssetHandle< Texture > normal = ImportMaterialTexture( aimat, aiTextureType_NORMALS, options );
+			if ( !normal.Get( ) )
+			{
+				normal = ImportMaterialTexture( aimat, aiTextureType_HEIGHT, options );
+			}
+			if ( normal.Get( ) )
+			{
+				material->SetUniform( "normalMap", normal );
+			}
+
+			// Material was cached when constructed, before its graph and textures were set
+			am->SaveAsset( material );
+		}
+	}
+
+	//============================================================================================================
+
 	Asset* MeshAssetLoader::LoadResourceFromFile( const String& filePath )
 	{
 		// Construct new mesh from filepath 
 		Assimp::Importer importer;
-
-		// NOTE(): Flipping UVs FUCKS IT ALL because I'm already flipping UVs in the shader generation process (shadergraph). Need to fix this.  
-		const aiScene* scene = importer.ReadFile( filePath, aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace );
-
-		if ( !scene || !scene->mRootNode )
+		const aiScene* scene = ReadScene( &importer, filePath );
+		if ( !scene )
 		{
 			// Error 
+			return nullptr;
 		} 
 
 		// Detect whether or not scene has any mesh data
@@ -322,21 +407,8 @@ namespace Enjon
 		if ( hasMesh )
 		{
 			// Mesh to construct
-			Mesh* mesh = new Mesh( ); 
-			{
-				// Construct decl for new mesh
-				VertexDataDeclaration decl;
-				decl.Add( VertexAttributeFormat::Float3 );			// Position
-				decl.Add( VertexAttributeFormat::Float3 );			// Normal
-				decl.Add( VertexAttributeFormat::Float3 );			// Tangent
-				decl.Add( VertexAttributeFormat::Float2 );			// UV
-
-				// Set vertex decl for mesh
-				mesh->SetVertexDecl( decl );
-
-				// Process node of mesh
-				ProcessNode( scene->mRootNode, scene, mesh ); 
-			} 
+			Mesh* mesh = ConstructStaticMesh( scene, nullptr ); 
+			mesh->DeserializeLateInit( );
 
 			// Return mesh
 			return mesh;
@@ -348,6 +420,38 @@ namespace Enjon
 
 	//===================================================================================================== 
 
+	Mesh* MeshAssetLoader::ConstructStaticMesh( const aiScene* scene, const MeshImportOptions* options )
+	{
+		Mesh* mesh = new Mesh( );
+
+		// Construct decl for new mesh
+		VertexDataDeclaration decl;
+		decl.Add( VertexAttributeFormat::Float3 );			// Position
+		decl.Add( VertexAttributeFormat::Float3 );			// Normal
+		decl.Add( VertexAttributeFormat::Float3 );			// Tangent
+		decl.Add( VertexAttributeFormat::Float2 );			// UV
+
+		// Set vertex decl for mesh
+		mesh->SetVertexDecl( decl );
+
+		// Process node of mesh
+		ProcessNode( scene->mRootNode, scene, mesh ); 
+
+		// Simplify cooked full detail levels before quantizing, so errors are measured against original positions
+		for ( auto& sm : mesh->mSubMeshes )
+		{
+			MeshOptimizer::GenerateLODs( sm, decl, options ? options->mLODCount : ENJON_MESH_DEFAULT_LOD_COUNT, options ? options->mLODReduction : ENJON_MESH_DEFAULT_LOD_REDUCTION );
+		}
+
+		// Compact vertex formats once every submesh is cooked, since they share bounds
+		MeshOptimizer::QuantizeMesh( mesh, options ? options->mVertexErrorBudget : ENJON_MESH_DEFAULT_QUANTIZATION_ERROR );
+		mesh->CalculateBounds( );
+
+		return mesh;
+	}
+
+	//=====================================================================================================
+
 	void MeshAssetLoader::ProcessNode( aiNode* node, const aiScene* scene, Mesh* mesh )
 	{ 
 		// Process all meshes in node
@@ -434,78 +538,8 @@ namespace Enjon
 			}
 		}
 
-		// Create and upload mesh data 
-		glGenBuffers( 1, &sm->mVBO );
-		glBindBuffer( GL_ARRAY_BUFFER, sm->mVBO );
-		glBufferData( GL_ARRAY_BUFFER, sm->mVertexData.GetSize( ), sm->mVertexData.GetData( ), GL_STATIC_DRAW ); 
-		glGenVertexArrays( 1, &sm->mVAO );
-		glBindVertexArray( sm->mVAO );
-
-		// Grab total size in bytes for data declaration
-		usize vertexDeclSize = vertDecl.GetSizeInBytes( );
-
-		// Vertex Attributes
-		for ( u32 i = 0; i < vertDecl.mDecl.size(); ++i )
-		{
-			// Grab attribute
-			VertexAttributeFormat attribute = vertDecl.mDecl.at( i );
-
-			// Enable vertex attribute array
-			glEnableVertexAttribArray( i );
-
-			// Upload attribute
-			switch ( attribute )
-			{
-				case VertexAttributeFormat::Float4:
-				{
-					glVertexAttribPointer( i, 4, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float3:
-				{
-					glVertexAttribPointer( i, 3, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float2:
-				{
-					glVertexAttribPointer( i, 2, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float:
-				{
-					glVertexAttribPointer( i, 1, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt4:
-				{
-					glVertexAttribIPointer( i, 4, GL_UNSIGNED_INT, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt3:
-				{
-					glVertexAttribIPointer( i, 3, GL_UNSIGNED_INT, GL_FALSE, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt2:
-				{
-					glVertexAttribIPointer( i, 2, GL_UNSIGNED_INT, GL_FALSE, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt:
-				{
-					glVertexAttribIPointer( i, 1, GL_UNSIGNED_INT, GL_FALSE, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-			}
-		} 
-
-		// Unbind vertex array
-		glBindVertexArray( 0 );
-
-		// Set draw type
-		sm->mDrawType = GL_TRIANGLES;
-
-		// Set draw count
-		sm->mDrawCount = sm->mVertexData.GetSize( ) / vertDecl.GetSizeInBytes( ); 
+		// Cook triangle soup into indexed, GPU ordered data. GPU upload is left to caller, so this can be run on a worker thread.
+		MeshOptimizer::CookSubMesh( sm, vertDecl );
 	}
 
 	//=====================================================================================================
@@ -516,18 +550,17 @@ namespace Enjon
 		mImportOptions.mResourceFilePath = filePath;
 		mImportOptions.mDestinationAssetDirectory = cacheDirectory; 
 
-		// Construct new mesh from filepath 
-		Assimp::Importer importer;
-
-		// NOTE(): Flipping UVs FUCKS IT ALL because I'm already flipping UVs in the shader generation process (shadergraph). Need to fix this.  
-		const aiScene* scene = importer.ReadFile( filePath, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace );
-
-		//if ( !scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode )
-		if ( !scene || !scene->mRootNode )
+		// Parsed scene is kept for the import itself, so the file is only read once
+		ReleaseImporter( );
+		mImporter = new Assimp::Importer( );
+		const aiScene* scene = ReadScene( mImporter, filePath );
+		if ( !scene )
 		{
 			// Error 
+			ReleaseImporter( );
 			return Result::FAILURE;
 		} 
+		mImporterFilePath = filePath;
 
 		// Check whether or not the scene has animations
 		mImportOptions.mShowAnimationCreateDialogue = scene->HasAnimations( );
@@ -555,6 +588,48 @@ namespace Enjon
 
 	//=====================================================================================================
 
+	f32 MeshImportOptions::GetVertexErrorBudget( ) const
+	{
+		return mVertexErrorBudget;
+	}
+
+	//=====================================================================================================
+
+	void MeshImportOptions::SetVertexErrorBudget( const f32& budget )
+	{
+		mVertexErrorBudget = std::max( budget, 0.0f );
+	}
+
+	//=====================================================================================================
+
+	u32 MeshImportOptions::GetLODCount( ) const
+	{
+		return mLODCount;
+	}
+
+	//=====================================================================================================
+
+	void MeshImportOptions::SetLODCount( const u32& count )
+	{
+		mLODCount = std::max( count, 1u );
+	}
+
+	//=====================================================================================================
+
+	f32 MeshImportOptions::GetLODReduction( ) const
+	{
+		return mLODReduction;
+	}
+
+	//=====================================================================================================
+
+	void MeshImportOptions::SetLODReduction( const f32& reduction )
+	{
+		mLODReduction = std::min( std::max( reduction, 0.05f ), 0.95f );
+	}
+
+	//=====================================================================================================
+
 	void MeshImportOptions::Reset( )
 	{
 		mShowMeshCreateDialogue = false;
@@ -565,6 +640,39 @@ namespace Enjon
 
 	//=====================================================================================================
 
+	void MeshImportOptions::SerializeSettings( ByteBuffer* buffer ) const
+	{
+		buffer->Write< u32 >( mCreateSkeleton );
+		buffer->Write< u32 >( mCreateMesh );
+		buffer->Write< u32 >( mCreateAnimations );
+		buffer->Write< UUID >( mSkeletonAsset.GetUUID( ) );
+		buffer->Write< f32 >( mVertexErrorBudget );
+		buffer->Write< u32 >( mLODCount );
+		buffer->Write< f32 >( mLODReduction );
+	}
+
+	//=====================================================================================================
+
+	void MeshImportOptions::DeserializeSettings( ByteBuffer* buffer )
+	{
+		mCreateSkeleton = buffer->Read< u32 >( );
+		mCreateMesh = buffer->Read< u32 >( );
+		mCreateAnimations = buffer->Read< u32 >( );
+
+		// Skeleton is referenced, not imported, so only needs to be looked up
+		UUID skeletonId = buffer->Read< UUID >( );
+		mSkeletonAsset = skeletonId ? EngineSubsystem( AssetManager )->GetAsset< Skeleton >( skeletonId ) : AssetHandle< Skeleton >( );
+
+		// Settings recorded before quantization have no budget
+		mVertexErrorBudget = ( buffer->GetReadPosition( ) < buffer->GetSize( ) ) ? buffer->Read< f32 >( ) : ENJON_MESH_DEFAULT_QUANTIZATION_ERROR;
+
+		// Or levels of detail
+		mLODCount = ( buffer->GetReadPosition( ) < buffer->GetSize( ) ) ? buffer->Read< u32 >( ) : ENJON_MESH_DEFAULT_LOD_COUNT;
+		mLODReduction = ( buffer->GetReadPosition( ) < buffer->GetSize( ) ) ? buffer->Read< f32 >( ) : ENJON_MESH_DEFAULT_LOD_REDUCTION;
+	}
+
+	//=====================================================================================================
+
 	Result MeshImportOptions::OnEditorUIInternal( )
 	{
 		ImGuiManager* igm = EngineSubsystem( ImGuiManager );
@@ -596,6 +704,19 @@ namespace Enjon
 			mCreateMesh = false;
 		}
 
+		if ( mShowMeshCreateDialogue && mCreateMesh )
+		{
+			ImGui::DragFloat( "Vertex Error Budget", &mVertexErrorBudget, 0.0001f, 0.0f, 1.0f, "%.5f" );
+			mVertexErrorBudget = std::max( mVertexErrorBudget, 0.0f );
+
+			s32 lodCount = ( s32 )mLODCount;
+			ImGui::SliderInt( "LOD Count", &lodCount, 1, 8 );
+			SetLODCount( ( u32 )std::max( lodCount, 1 ) );
+
+			ImGui::SliderFloat( "LOD Reduction", &mLODReduction, 0.05f, 0.95f, "%.2f" );
+			SetLODReduction( mLODReduction );
+		}
+
 		if ( mShowAnimationCreateDialogue )
 		{
 			bool createAnimations = mCreateAnimations;
@@ -644,5 +765,50 @@ namespace Enjon
 	}
 
 	//=====================================================================================================
+
+	bool MeshAssetLoader::SupportsStreaming( ) const
+	{
+		return true;
+	}
+
+	//=====================================================================================================
+
+	bool MeshAssetLoader::SupportsEviction( ) const
+	{
+		return true;
+	}
+
+	//=====================================================================================================
+
+	bool MeshAssetLoader::SupportsParallelImport( const ImportOptions* options ) const
+	{
+		// Creating skeletons and animations registers other assets, so only plain static meshes can be imported off the main thread
+		const MeshImportOptions* meshOptions = options ? options->Cast< MeshImportOptions >( ) : nullptr;
+		if ( !meshOptions )
+		{
+			return !options;
+		}
+
+		return meshOptions->mCreateMesh && !meshOptions->mCreateSkeleton && !meshOptions->mCreateAnimations && !meshOptions->mSkeletonAsset.IsValid( );
+	}
+
+	//=====================================================================================================
+
+	Asset* MeshAssetLoader::ImportResourceData( const String& filePath, const ImportOptions* options )
+	{
+		// Importers are independent, so one per job is safe
+		Assimp::Importer importer;
+		const aiScene* scene = ReadScene( &importer, filePath );
+		if ( !scene || !HasMesh( scene->mRootNode, scene ) )
+		{
+			return nullptr;
+		}
+
+		// Vertex data is uploaded when the mesh is next loaded from its cached file
+		const MeshImportOptions* meshOptions = options ? options->Cast< MeshImportOptions >( ) : nullptr;
+		return ConstructStaticMesh( scene, meshOptions );
+	}
+
+	//=====================================================================================================
 } 
 
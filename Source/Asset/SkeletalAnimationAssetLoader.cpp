@@ -26,8 +26,14 @@ namespace Enjon
 	Asset* SkeletalAnimationAssetLoader::DirectImport( const ImportOptions* options )
 	{
 		// Need to basically act as the asset manager here...
-		SkeletalAnimation* animation = this->LoadResourceFromImporter( options )->ConstCast< SkeletalAnimation >( );
+		Asset* animation = this->LoadResourceFromImporter( options );
+		return animation ? AddImported( animation->ConstCast< SkeletalAnimation >( ), options ) : nullptr;
+	}
+
+	//======================================================================
 
+	Asset* SkeletalAnimationAssetLoader::AddImported( SkeletalAnimation* animation, const ImportOptions* options )
+	{
 		if ( animation )
 		{
 			// Register, cache asset
@@ -50,33 +56,25 @@ namespace Enjon
 			return nullptr;
 		}
 
-		// Construct new mesh from filepath 
+		// Use scene of import in progress, only reading file when imported on its own
 		Assimp::Importer importer;
-
-		//const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath( ), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_LimitBoneWeights );
-		const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath( ), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace ); 
-		//const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath( ), 
-		//										aiProcess_Triangulate | 
-		//										aiProcess_GenSmoothNormals | 
-		//										aiProcess_CalcTangentSpace | 
-		//										aiProcess_OptimizeMeshes | 
-		//										aiProcess_SplitLargeMeshes | 
-		//										aiProcess_JoinIdenticalVertices |
-		//										aiProcess_FindDegenerates | 
-		//										aiProcess_FindInvalidData | 
-		//										aiProcess_ImproveCacheLocality | 
-		//										aiProcess_SortByPType | 
-		//										aiProcess_GenUVCoords
-		//); 
-		if ( !scene ||!scene->mRootNode )
+		const aiScene* scene = meshOptions->mScene ? meshOptions->mScene : MeshAssetLoader::ReadScene( &importer, meshOptions->GetResourceFilePath( ) );
+		if ( !scene || !scene->mRootNode )
 		{
 			// Error 
-			//return nullptr;
+			return nullptr;
 		}
 
+		return ConstructAnimation( scene, meshOptions );
+	}
+
+	//======================================================================
+
+	SkeletalAnimation* SkeletalAnimationAssetLoader::ConstructAnimation( const aiScene* scene, const MeshImportOptions* meshOptions )
+	{
 		// Grab skeleton asset to use for this animation from import options
 		AssetHandle< Skeleton > skeleton = meshOptions->GetSkeleton( );
-		if ( !skeleton )
+		if ( !skeleton || !scene->HasAnimations( ) )
 		{
 			return nullptr;
 		}
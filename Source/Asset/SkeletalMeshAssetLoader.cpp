@@ -5,6 +5,7 @@
 #include "Asset/MeshAssetLoader.h"
 #include "Graphics/SkeletalMesh.h"
 #include "Graphics/Skeleton.h"
+#include "Graphics/MeshOptimizer.h"
 #include "Asset/AssetManager.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
@@ -34,30 +35,38 @@ namespace Enjon
 			return nullptr;
 		}
 
+		// Use scene of import in progress, only reading file when imported on its own
 		Assimp::Importer importer;
-
-		// Read aiscene
-		//const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath(), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_LimitBoneWeights ); 
-		//const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath(), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace ); 
-		const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath( ), 
-												aiProcess_Triangulate | 
-												aiProcess_GenSmoothNormals | 
-												aiProcess_CalcTangentSpace | 
-												aiProcess_OptimizeMeshes | 
-												//aiProcess_SplitLargeMeshes | 
-												aiProcess_JoinIdenticalVertices |
-												//aiProcess_FindDegenerates | 
-												//aiProcess_FindInvalidData | 
-												aiProcess_ImproveCacheLocality | 
-												//aiProcess_SortByPType | 
-												aiProcess_GenUVCoords
-		); 
+		const aiScene* scene = meshOptions->mScene ? meshOptions->mScene : MeshAssetLoader::ReadScene( &importer, meshOptions->GetResourceFilePath( ) );
 		if ( !scene || !scene->mRootNode )
 		{
 			// Error
 			return nullptr;
 		} 
 
+		SkeletalMesh* mesh = ConstructSkeletalMesh( scene, meshOptions );
+		if ( mesh )
+		{
+			mesh->DeserializeLateInit( );
+		}
+
+		// Return mesh
+		return mesh;
+	}
+
+	//========================================================================================
+
+	SkeletalMesh* SkeletalMeshAssetLoader::ConstructSkeletalMesh( const aiScene* scene, const MeshImportOptions* meshOptions )
+	{
+		// Grab skeleton from import options to use for this mesh
+		AssetHandle< Skeleton > skeleton = meshOptions->GetSkeleton(); 
+		
+		// If skeleton not valid, error
+		if ( !skeleton )
+		{
+			return nullptr;
+		} 
+
 		// Construct new mesh to fill out
 		SkeletalMesh* mesh = new SkeletalMesh( ); 
 
@@ -75,17 +84,6 @@ namespace Enjon
 		// Set vertex decl for mesh
 		mesh->SetVertexDecl( decl );
 
-		// Grab skeleton from import options to use for this mesh
-		AssetHandle< Skeleton > skeleton = meshOptions->GetSkeleton(); 
-		
-		// If skeleton not valid, error
-		if ( !skeleton )
-		{
-			delete( mesh );
-			mesh = nullptr;
-			return nullptr;
-		} 
-
 		// Joint data to use for vertices
 		Vector< VertexJointData > vertexJointData;
 
@@ -100,7 +98,17 @@ namespace Enjon
 		// Finish processing the mesh
 		ProcessNodeSkeletal( scene->mRootNode, scene, skeleton, mesh, &vertexJointData );
 
-		// Return mesh
+		// Cook soups into indexed levels of detail only once all are built, since joint data is indexed by soup vertex
+		for ( auto& sm : mesh->mSubMeshes )
+		{
+			MeshOptimizer::CookSubMesh( sm, decl );
+			MeshOptimizer::GenerateLODs( sm, decl, meshOptions->mLODCount, meshOptions->mLODReduction );
+		}
+
+		// Compact vertex formats once all submeshes are built
+		MeshOptimizer::QuantizeMesh( mesh, meshOptions->mVertexErrorBudget );
+		mesh->CalculateBounds( );
+
 		return mesh;
 	}
 
@@ -109,8 +117,14 @@ namespace Enjon
 	Asset* SkeletalMeshAssetLoader::DirectImport( const ImportOptions* options )
 	{
 		// Need to basically act as the asset manager here...
-		SkeletalMesh* mesh = this->LoadResourceFromImporter( options )->ConstCast< SkeletalMesh >( );
+		Asset* mesh = this->LoadResourceFromImporter( options );
+		return mesh ? AddImported( mesh->ConstCast< SkeletalMesh >( ), options ) : nullptr;
+	} 
+
+	//========================================================================================
 
+	Asset* SkeletalMeshAssetLoader::AddImported( SkeletalMesh* mesh, const ImportOptions* options )
+	{
 		if ( mesh )
 		{
 			// Needs to cache the skeletal mesh now 
@@ -124,6 +138,8 @@ namespace Enjon
 		return mesh;
 	} 
 
+	//========================================================================================
+
 	void SkeletalMeshAssetLoader::ProcessNodeSkeletal( aiNode* node, const aiScene* scene, const AssetHandle< Skeleton >& skeleton, SkeletalMesh* mesh, Vector< VertexJointData >* vertexJointData )
 	{
 		// Process all meshes in node
@@ -279,73 +295,6 @@ namespace Enjon
 		// Get decl from mesh
 		const VertexDataDeclaration& vertDecl = mesh->GetVertexDeclaration( ); 
 
-		// Create and upload mesh data 
-		glGenBuffers( 1, &sm->mVBO );
-		glBindBuffer( GL_ARRAY_BUFFER, sm->mVBO );
-		glBufferData( GL_ARRAY_BUFFER, sm->mVertexData.GetSize( ), sm->mVertexData.GetData( ), GL_STATIC_DRAW ); 
-		glGenVertexArrays( 1, &sm->mVAO );
-		glBindVertexArray( sm->mVAO );
-
-		// Grab total size in bytes for data declaration
-		usize vertexDeclSize = vertDecl.GetSizeInBytes( );
-
-		// Vertex Attributes
-		for ( u32 i = 0; i < vertDecl.mDecl.size(); ++i )
-		{
-			// Grab attribute
-			VertexAttributeFormat attribute = vertDecl.mDecl.at( i );
-
-			// Enable vertex attribute array
-			glEnableVertexAttribArray( i );
-
-			// Upload attribute
-			switch ( attribute )
-			{
-				case VertexAttributeFormat::Float4:
-				{
-					glVertexAttribPointer( i, 4, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float3:
-				{
-					glVertexAttribPointer( i, 3, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float2:
-				{
-					glVertexAttribPointer( i, 2, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::Float:
-				{
-					glVertexAttribPointer( i, 1, GL_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt4:
-				{
-					glVertexAttribIPointer( i, 4, GL_UNSIGNED_INT, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt3:
-				{
-					glVertexAttribIPointer( i, 3, GL_UNSIGNED_INT, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt2:
-				{
-					glVertexAttribIPointer( i, 2, GL_UNSIGNED_INT, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-
-				case VertexAttributeFormat::UnsignedInt:
-				{
-					glVertexAttribIPointer( i, 1, GL_UNSIGNED_INT, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset( i )) );
-				} break;
-			}
-		} 
-
-		// Unbind vertex array
-		glBindVertexArray( 0 );
-
 		// Set draw type
 		sm->mDrawType = GL_TRIANGLES;
 
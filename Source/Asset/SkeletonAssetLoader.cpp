@@ -132,24 +132,9 @@ namespace Enjon
 			return nullptr;
 		}
 
-		// Construct new mesh from filepath 
+		// Use scene of import in progress, only reading file when imported on its own
 		Assimp::Importer importer;
-
-		// NOTE(): Flipping UVs FUCKS IT ALL because I'm already flipping UVs in the shader generation process (shadergraph). Need to fix this.  
-		const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath( ), aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_LimitBoneWeights ); 
-		//const aiScene* scene = importer.ReadFile( meshOptions->GetResourceFilePath( ), 
-		//										aiProcess_Triangulate | 
-		//										aiProcess_GenSmoothNormals | 
-		//										aiProcess_CalcTangentSpace | 
-		//										aiProcess_OptimizeMeshes | 
-		//										aiProcess_SplitLargeMeshes | 
-		//										aiProcess_JoinIdenticalVertices |
-		//										aiProcess_FindDegenerates | 
-		//										aiProcess_FindInvalidData | 
-		//										aiProcess_ImproveCacheLocality | 
-		//										aiProcess_SortByPType | 
-		//										aiProcess_GenUVCoords
-		//); 
+		const aiScene* scene = meshOptions->mScene ? meshOptions->mScene : MeshAssetLoader::ReadScene( &importer, meshOptions->GetResourceFilePath( ) );
 		if ( !scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode )
 		{
 			// Error 
@@ -3,6 +3,8 @@
 
 #include "Asset/AssetManager.h"
 #include "Asset/TextureAssetLoader.h" 
+#include "Graphics/TextureCompression.h"
+#include "Graphics/GPUMemoryTracker.h"
 #include "Utils/FileUtils.h"
 #include "Math/Vec3.h"
 #include "Engine.h"
@@ -17,12 +19,65 @@ namespace Enjon
 
 	Asset* TextureAssetLoader::LoadResourceFromFile(const String& filePath )
 	{ 
-		// Load and construct texture from file
-		Enjon::Texture* tex = Texture::Construct( filePath ); 
+		// Cook and upload straight away
+		Enjon::Texture* tex = CookTexture( filePath ); 
+		if ( tex )
+		{
+			tex->UploadMips( );
+		}
 
 		return tex; 
 	} 
 
+	//============================================================================================== 
+
+	INTERNAL TextureCompression GetSupportedCompression( TextureCompression compression )
+	{
+		// Formats the driver can't sample fall back to the nearest one it can, or to uncompressed mips
+		bool s3tc = GLEW_EXT_texture_compression_s3tc;
+		bool bptc = GLEW_ARB_texture_compression_bptc;
+
+		switch ( compression )
+		{
+			case TextureCompression::BC1:
+			case TextureCompression::BC3:	return s3tc ? compression : TextureCompression::None;
+			case TextureCompression::BC6H:	return bptc ? compression : TextureCompression::None;
+			case TextureCompression::BC7:	return bptc ? compression : ( s3tc ? TextureCompression::BC3 : TextureCompression::None );
+			default:						return compression;
+		}
+	}
+
+	//============================================================================================== 
+
+	Texture* TextureAssetLoader::CookTexture( const String& filePath ) const
+	{
+		Texture* tex = Texture::Decode( filePath );
+		if ( !tex )
+		{
+			return nullptr;
+		}
+
+		TextureUsage usage = TextureCompressor::GetUsageFromFilePath( filePath );
+
+		TextureCompression compression = TextureCompression::None;
+		if ( mCompressionEnabled )
+		{
+			if ( tex->mFormat == TextureFormat::HDR )
+			{
+				compression = TextureCompression::BC6H;
+			}
+			else
+			{
+				const u8* pixels = ( const u8* )tex->mSourceData->Cast< u32 >( )->GetData( );
+				compression = TextureCompressor::SelectCompression( usage, pixels, tex->mWidth, tex->mHeight, mHighQualityCompression );
+			}
+		}
+
+		tex->Cook( GetSupportedCompression( compression ), usage );
+
+		return tex;
+	}
+
 	void TextureAssetLoader::RegisterDefaultAsset( )
 	{ 
 		u32 texID;
@@ -81,6 +136,10 @@ namespace Enjon
 		Enjon::Texture* defaultTex = new Enjon::Texture( width, height, texID );
 		defaultTex->mName = "defaultTexture";
 
+		usize bytes = GPUMemoryTracker::GetTextureSize( GL_RGB8, width, height, GPUMemoryTracker::GetFullMipCount( width, height ) );
+		defaultTex->mGPUMemoryBytes = bytes;
+		GPUMemoryTracker::Track( GPUResourceType::Texture, texID, bytes, "Texture Assets", defaultTex->mName );
+
 		// Set default texture
 		mDefaultAsset = defaultTex;
 	} 
@@ -93,4 +152,61 @@ namespace Enjon
 	}
 
 	//===================================================================================
+
+	bool TextureAssetLoader::SupportsStreaming( ) const
+	{
+		return true;
+	}
+
+	//===================================================================================
+
+	bool TextureAssetLoader::SupportsEviction( ) const
+	{
+		return true;
+	}
+
+	//===================================================================================
+
+	bool TextureAssetLoader::SupportsParallelImport( const ImportOptions* options ) const
+	{
+		return true;
+	}
+
+	//===================================================================================
+
+	Asset* TextureAssetLoader::ImportResourceData( const String& filePath, const ImportOptions* options )
+	{
+		// Only cooked, texture is uploaded when it's next loaded from its cached file
+		return CookTexture( filePath );
+	}
+
+	//===================================================================================
+
+	void TextureAssetLoader::SetCompressionEnabled( bool enabled )
+	{
+		mCompressionEnabled = enabled;
+	}
+
+	//===================================================================================
+
+	bool TextureAssetLoader::GetCompressionEnabled( ) const
+	{
+		return mCompressionEnabled;
+	}
+
+	//===================================================================================
+
+	void TextureAssetLoader::SetHighQualityCompression( bool enabled )
+	{
+		mHighQualityCompression = enabled;
+	}
+
+	//===================================================================================
+
+	bool TextureAssetLoader::GetHighQualityCompression( ) const
+	{
+		return mHighQualityCompression;
+	}
+
+	//===================================================================================
 }
@@ -200,6 +200,13 @@ namespace Enjon
 	}
 
 	//====================================================================================== 
+
+	Result Object::CloneData( const Object* source )
+	{
+		return Result::INCOMPLETE;
+	}
+
+	//====================================================================================== 
 } 
 
 
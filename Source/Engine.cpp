@@ -14,6 +14,7 @@
 #include "Graphics/AnimationSubsystem.h"
 #include "Graphics/Window.h"
 #include "Scene/SceneManager.h"
+#include "System/JobSystem.h"
 #include "Utils/Timing.h"
 #include "SubsystemCatalog.h"
 #include "Base/World.h"
@@ -199,6 +200,9 @@ namespace Enjon
 		// Register and bind all application specific meta classes
 		mApp->BindApplicationMetaClasses( ); 
 
+		// Register job system first, since asset and scene loading can schedule work on it
+		mJobSystem			= mSubsystemCatalog->Register< JobSystem >( );
+
 		// Default setting for assets directory
 		mAssetManager		= mSubsystemCatalog->Register< AssetManager >( false );		// Will do manual initialization of asset management system, since it's project dependent 
 		mAssetManager->SetAssetsDirectoryPath( mConfig.GetRoot( ) + "Assets/" );
@@ -334,6 +338,9 @@ namespace Enjon
 			// Update entity manager
 			mEntities->Update( dt ); 
 
+			// Finish streamed assets before they're rendered
+			mAssetManager->Update( dt );
+
 			// Update graphics
 			mGraphics->Update( dt ); 
 
@@ -6,6 +6,7 @@
 #include "Base/World.h"
 #include "Math/Transform.h"
 #include "Asset/ArchetypeAssetLoader.h"
+#include "Asset/AssetDependencies.h"
 #include "SubsystemCatalog.h"
 #include "Serialize/EntityArchiver.h"
 #include "Serialize/ObjectArchiver.h"
@@ -26,6 +27,19 @@ namespace Enjon
 		// Cast to archetype
 		const Archetype* otherArch = other->Cast< Archetype >( ); 
 
+		// Clone other root hierarchy into archetype world with its own uuids
+		if ( otherArch->mRoot )
+		{
+			EntityManager* em = EngineSubsystem( EntityManager );
+			EntityHandle root = EntityArchiver::Clone( otherArch->mRoot, em->GetArchetypeWorld( ) );
+			if ( root )
+			{
+				em->RecurisvelyGenerateNewUUIDs( root );
+				mRoot = root.Get( );
+				RecursivelySetToRoot( mRoot );
+			}
+		}
+
 		return Result::SUCCESS;
 	}
 
@@ -80,10 +94,6 @@ namespace Enjon
 	{ 
 		Entity* ent = dest.Get( );
 
-		// Serialize into buffer
-		ByteBuffer buffer;
-		EntityArchiver::Serialize( dest, &buffer );
-
 		ent->Destroy( ); 
 
 		// Nothing to do
@@ -105,40 +115,52 @@ namespace Enjon
 		}
 	}
 
-	// Terribly named
+	// Entity in an instanced hierarchy and the uuid of the prototype entity it pointed at
 	struct InstanceData
 	{ 
-		ByteBuffer* buffer = nullptr;
-		const World* world = nullptr;
-		UUID mParentUUID;
-		bool mIsArchetypeRoot = false;
+		EntityHandle mEntity;
+		UUID mPrototypeUUID;
 	};
 
+	INTERNAL void CollectInstanceData( const EntityHandle& entity, Vector< InstanceData >* out )
+	{
+		Entity* ent = entity.Get( );
+		if ( !ent )
+		{
+			return;
+		}
+
+		InstanceData data;
+		data.mEntity = entity;
+		data.mPrototypeUUID = ent->HasPrototypeEntity( ) ? ent->GetPrototypeEntity( ).Get( )->GetUUID( ) : UUID::Invalid( );
+		out->push_back( data );
+
+		for ( auto& c : ent->GetChildren( ) )
+		{
+			CollectInstanceData( c, out );
+		}
+	}
+
 	Result Archetype::Reload( )
 	{ 
 		// All entities that need to be pointed back to root entity ( since they're just using handles )
 		EntityManager* em = EngineSubsystem( EntityManager );
 		auto instancedEnts = mRoot->GetInstancedEntities( );
-		EntityHandle rootToDestroy = mRoot; 
-		Vector< InstanceData > mSerializedData;
+		Vector< InstanceData > instanceData;
  
-		// Serialize data into buffers
+		// Instances are kept alive through the reload. Prototypes are rebuilt with the same uuids, so only need to remember which ones to relink to.
 		for ( auto& e : instancedEnts )
 		{
 			if ( e.Get( )->GetState( ) == EntityState::ACTIVE )
 			{
-				InstanceData data;
-				data.buffer = new ByteBuffer( );
-				data.world = e.Get( )->GetWorld( );
-				data.mParentUUID = e.Get( )->HasParent( ) ? e.Get( )->GetParent( ).Get( )->GetUUID( ) : UUID::Invalid( );
-				data.mIsArchetypeRoot = e.Get( )->mIsArchetypeRoot;
-				EntityArchiver::Serialize( e, data.buffer );
-				mSerializedData.push_back( data ); 
+				CollectInstanceData( e, &instanceData );
+			}
+			else
+			{
+				// Destroy entity
+				RecursivelyRemoveFromRoot( e.Get( ) );
+				e.Get( )->Destroy( );
 			}
-
-			// Destroy entity
-			RecursivelyRemoveFromRoot( e.Get( ) );
-			e.Get( )->Destroy( );
 		}
 
 		// Force cleanup
@@ -153,29 +175,36 @@ namespace Enjon
 		// Force add entities
 		em->ForceAddEntities( );
 
-		// Reset previous entities
-		for ( auto& d : mSerializedData )
+		// Relink instances to reloaded prototypes
+		for ( auto& d : instanceData )
 		{
-			EntityHandle handle = EntityArchiver::Deserialize( d.buffer, d.world->ConstCast< World >( ) ); 
-			if ( handle )
+			Entity* ent = d.mEntity.Get( );
+			if ( ent )
 			{
-				// Set archetype root back
-				handle.Get( )->mIsArchetypeRoot = d.mIsArchetypeRoot;
-				Transform local = handle.Get( )->GetLocalTransform( );
-				EntityHandle p = em->GetEntityByUUID( d.mParentUUID );
-				if ( p )
-				{
-					p.Get( )->AddChild( handle );
-					handle.Get( )->SetLocalTransform( local );
-				}
+				ent->SetPrototypeEntity( em->GetEntityByUUID( d.mPrototypeUUID ) );
 			}
+		}
 
-			delete ( d.buffer );
-			d.buffer = nullptr;
-		} 
+		// Merge reloaded prototype data back in. Reverse order so children are resolved before their parents, same as when deserializing.
+		for ( auto iter = instanceData.rbegin( ); iter != instanceData.rend( ); ++iter )
+		{
+			Entity* ent = iter->mEntity.Get( );
+			if ( ent && ent->HasPrototypeEntity( ) )
+			{
+				ObjectArchiver::ClearAllPropertyOverrides( ent );
+				ObjectArchiver::RecordAllPropertyOverrides( ent->GetPrototypeEntity( ).Get( ), ent );
+				ObjectArchiver::MergeObjects( ent->GetPrototypeEntity( ).Get( ), ent, MergeType::AcceptMerge );
+			}
+		}
 
-		mSerializedData.clear( ); 
+		return Result::SUCCESS;
+	}
+
+	//=======================================================================================
 
+	Result Archetype::CollectDependencies( Vector< AssetDependency >* out ) const
+	{
+		AssetDependencies::CollectFromEntity( mRoot, out );
 		return Result::SUCCESS;
 	}
 
@@ -332,6 +332,14 @@ namespace Enjon
 
 	//======================================================================== 
 
+	Result RigidBodyComponent::CloneData( const Object* source )
+	{
+		// Clone mBody
+		return ObjectArchiver::Clone( &source->Cast< RigidBodyComponent >( )->mBody, &mBody );
+	}
+
+	//======================================================================== 
+
 	Result RigidBodyComponent::DeserializeLateInit( )
 	{
 		// Reinitialize rigidbody
@@ -223,6 +223,24 @@ namespace Enjon
 
 	//==================================================================== 
 
+	Result SkeletalMeshComponent::CloneData( const Object* source )
+	{
+		const SkeletalMeshComponent* other = source->Cast< SkeletalMeshComponent >( );
+
+		// Mesh and materials are shared assets, so only need to point at the same ones
+		mRenderable.SetMesh( other->mRenderable.GetMesh( ) );
+
+		u32 i = 0;
+		for ( auto& mat : other->mRenderable.GetMaterials( ) )
+		{
+			mRenderable.SetMaterial( mat, i++ );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//==================================================================== 
+
 	Result SkeletalMeshComponent::OnEditorUI( )
 	{
 		ImGuiManager* igm = EngineSubsystem( ImGuiManager );
@@ -245,6 +245,24 @@ namespace Enjon
 
 	//==================================================================== 
 
+	Result StaticMeshComponent::CloneData( const Object* source )
+	{
+		const StaticMeshComponent* other = source->Cast< StaticMeshComponent >( );
+
+		// Mesh and materials are shared assets, so only need to point at the same ones
+		mRenderable.SetMesh( other->mRenderable.GetMesh( ) );
+
+		u32 i = 0;
+		for ( auto& mat : other->mRenderable.GetMaterials( ) )
+		{
+			mRenderable.SetMaterial( mat, i++ );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//==================================================================== 
+
 	Result StaticMeshComponent::OnEditorUI( )
 	{
 		ImGuiManager* igm = EngineSubsystem( ImGuiManager );
@@ -1019,6 +1019,54 @@ namespace Enjon
 
 	//---------------------------------------------------------------
 
+	void EntityManager::Allocate( u32 count, Vector< EntityHandle >* out, World* world )
+	{
+		if ( !world )
+		{
+			world = Engine::GetInstance( )->GetWorld( );
+		}
+
+		if ( !WorldExists( world ) )
+		{
+			AddWorld( world );
+		}
+
+		out->reserve( out->size( ) + count );
+		mMarkedForAdd.reserve( mMarkedForAdd.size( ) + count );
+		mEntityUUIDMap.reserve( mEntityUUIDMap.size( ) + count );
+
+		// Walk free slots once, starting from next available id and wrapping around
+		u32 id = mNextAvailableID;
+		for ( u32 checked = 0; count && checked < MAX_ENTITIES; ++checked, id = ( id + 1 ) % MAX_ENTITIES )
+		{
+			Entity* entity = &mEntities.at( id );
+			if ( entity->mState != EntityState::INVALID )
+			{
+				continue;
+			}
+
+			entity->mID = id;
+			entity->mState = EntityState::ACTIVE;
+			entity->mUUID = UUID::GenerateUUID( );
+			entity->mWorld = world;
+
+			mMarkedForAdd.push_back( entity );
+			AddToUUIDMap( entity );
+
+			EntityHandle handle;
+			handle.mID = id;
+			out->push_back( handle );
+
+			mNextAvailableID = id;
+			count--;
+		}
+
+		// Make sure there was room for all of them
+		assert( count == 0 );
+	}
+
+	//---------------------------------------------------------------
+
 	void EntityManager::AddToUUIDMap( const EntityHandle& entity )
 	{
 		Entity* ent = entity.Get( );
@@ -1584,6 +1632,27 @@ namespace Enjon
 
 	//========================================================================================================================
 
+	void EntityManager::ReserveComponents( const HashMap< const MetaClass*, u32 >& counts )
+	{
+		u32 total = 0;
+		for ( auto& c : counts )
+		{
+			u32 compIdx = c.first->GetTypeId( );
+			if ( !ComponentBaseExists( compIdx ) )
+			{
+				RegisterComponent( c.first );
+			}
+
+			mComponents[ compIdx ]->Reserve( c.second );
+			total += c.second;
+		}
+
+		mNeedInitializationList.reserve( mNeedInitializationList.size( ) + total );
+		mNeedStartList.reserve( mNeedStartList.size( ) + total );
+	}
+
+	//========================================================================================================================
+
 	Component* EntityManager::AddComponent( const MetaClass* compCls, const Enjon::EntityHandle& handle )
 	{
 		// Get type id from component class
@@ -1770,20 +1839,14 @@ namespace Enjon
 			world = Engine::GetInstance( )->GetWorld( );
 		}
 
-		// Use to serialize entity data for new entity
-		ByteBuffer buffer;
-
 		// Set up the handle using the other
 		if ( entity.Get( ) )
 		{
 			// Get entities
 			Entity* sourceEnt = entity.Get( );
 
-			// Serialize entity into buffer
-			EntityArchiver::Serialize( entity, &buffer );
-
-			// Deserialize into new entity
-			EntityHandle newHandle = EntityArchiver::Deserialize( &buffer, world );
+			// Clone into new entity
+			EntityHandle newHandle = EntityArchiver::Clone( entity, world );
 
 			// Destination entity
 			Entity* destEnt = newHandle.Get( );
@@ -1820,20 +1883,14 @@ namespace Enjon
 			world = Engine::GetInstance( )->GetWorld( );
 		}
 
-		// Use to serialize entity data for new entity
-		ByteBuffer buffer;
-
 		// Set up the handle using the other
 		if ( entity.Get( ) )
 		{
 			// Get entities
 			Entity* sourceEnt = entity.Get( );
 
-			// Serialize entity into buffer
-			EntityArchiver::Serialize( entity, &buffer );
-
-			// Deserialize into new entity
-			EntityHandle newHandle = EntityArchiver::Deserialize( &buffer, world, true );
+			// Clone into new entity
+			EntityHandle newHandle = EntityArchiver::Clone( entity, world, true );
 
 			// Destination entity
 			Entity* destEnt = newHandle.Get( );
@@ -0,0 +1,613 @@
+// @file AABBTree.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/AABBTree.h"
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL Vec3 MinVec3( const Vec3& a, const Vec3& b )
+	{
+		return Vec3( std::min( a.x, b.x ), std::min( a.y, b.y ), std::min( a.z, b.z ) );
+	}
+
+	//=================================================================
+
+	INTERNAL Vec3 MaxVec3( const Vec3& a, const Vec3& b )
+	{
+		return Vec3( std::max( a.x, b.x ), std::max( a.y, b.y ), std::max( a.z, b.z ) );
+	}
+
+	//=================================================================
+
+	INTERNAL f32 SurfaceArea( const Vec3& min, const Vec3& max )
+	{
+		Vec3 d = max - min;
+		return 2.0f * ( d.x * d.y + d.y * d.z + d.z * d.x );
+	}
+
+	//=================================================================
+
+	INTERNAL b32 Contains( const Vec3& outerMin, const Vec3& outerMax, const Vec3& min, const Vec3& max )
+	{
+		return outerMin.x <= min.x && outerMin.y <= min.y && outerMin.z <= min.z &&
+				max.x <= outerMax.x && max.y <= outerMax.y && max.z <= outerMax.z;
+	}
+
+	//=================================================================
+
+	INTERNAL b32 Overlaps( const AABBTreeNode& node, const Vec3& min, const Vec3& max )
+	{
+		return node.mMin.x <= max.x && node.mMin.y <= max.y && node.mMin.z <= max.z &&
+				min.x <= node.mMax.x && min.y <= node.mMax.y && min.z <= node.mMax.z;
+	}
+
+	//=================================================================
+
+	INTERNAL f32 GetAxis( const Vec3& v, u32 axis )
+	{
+		return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+	}
+
+	//=================================================================
+
+	AABBTree::AABBTree( f32 margin )
+		: mMargin( margin )
+	{
+	}
+
+	//=================================================================
+
+	s32 AABBTree::AllocateNode( )
+	{
+		if ( mFreeList == ENJON_AABB_TREE_NULL_NODE )
+		{
+			mNodes.push_back( AABBTreeNode( ) );
+			return ( s32 )mNodes.size( ) - 1;
+		}
+
+		s32 node = mFreeList;
+		mFreeList = mNodes[ node ].mParent;
+		mNodes[ node ] = AABBTreeNode( );
+		return node;
+	}
+
+	//=================================================================
+
+	void AABBTree::FreeNode( s32 node )
+	{
+		mNodes[ node ].mParent = mFreeList;
+		mNodes[ node ].mHeight = -1;
+		mNodes[ node ].mUserData = nullptr;
+		mFreeList = node;
+	}
+
+	//=================================================================
+
+	s32 AABBTree::Insert( const Vec3& min, const Vec3& max, void* userData, u32 userTag )
+	{
+		s32 proxy = AllocateNode( );
+
+		AABBTreeNode& node = mNodes[ proxy ];
+		node.mMin = min - Vec3( mMargin );
+		node.mMax = max + Vec3( mMargin );
+		node.mUserData = userData;
+		node.mUserTag = userTag;
+		node.mHeight = 0;
+
+		InsertLeaf( proxy );
+		mProxyCount++;
+
+		return proxy;
+	}
+
+	//=================================================================
+
+	void AABBTree::Remove( s32 proxy )
+	{
+		assert( mNodes[ proxy ].IsLeaf( ) );
+
+		RemoveLeaf( proxy );
+		FreeNode( proxy );
+		mProxyCount--;
+	}
+
+	//=================================================================
+
+	b32 AABBTree::Move( s32 proxy, const Vec3& min, const Vec3& max )
+	{
+		AABBTreeNode& node = mNodes[ proxy ];
+
+		// Keep fattened bounds while they still hold box and haven't been left far bigger than it
+		Vec3 largeMargin = Vec3( mMargin * 4.0f );
+		if ( Contains( node.mMin, node.mMax, min, max ) && Contains( min - largeMargin, max + largeMargin, node.mMin, node.mMax ) )
+		{
+			return false;
+		}
+
+		RemoveLeaf( proxy );
+
+		mNodes[ proxy ].mMin = min - Vec3( mMargin );
+		mNodes[ proxy ].mMax = max + Vec3( mMargin );
+
+		InsertLeaf( proxy );
+
+		return true;
+	}
+
+	//=================================================================
+
+	void AABBTree::Clear( )
+	{
+		mNodes.clear( );
+		mRoot = ENJON_AABB_TREE_NULL_NODE;
+		mFreeList = ENJON_AABB_TREE_NULL_NODE;
+		mProxyCount = 0;
+	}
+
+	//=================================================================
+
+	void AABBTree::GetBounds( s32 proxy, Vec3* min, Vec3* max ) const
+	{
+		*min = mNodes[ proxy ].mMin;
+		*max = mNodes[ proxy ].mMax;
+	}
+
+	//=================================================================
+
+	s32 AABBTree::GetHeight( ) const
+	{
+		return mRoot == ENJON_AABB_TREE_NULL_NODE ? 0 : mNodes[ mRoot ].mHeight;
+	}
+
+	//=================================================================
+
+	void AABBTree::InsertLeaf( s32 leaf )
+	{
+		if ( mRoot == ENJON_AABB_TREE_NULL_NODE )
+		{
+			mRoot = leaf;
+			mNodes[ leaf ].mParent = ENJON_AABB_TREE_NULL_NODE;
+			return;
+		}
+
+		Vec3 leafMin = mNodes[ leaf ].mMin;
+		Vec3 leafMax = mNodes[ leaf ].mMax;
+
+		// Descend to sibling that grows surface area of tree least
+		s32 index = mRoot;
+		while ( !mNodes[ index ].IsLeaf( ) )
+		{
+			const AABBTreeNode& node = mNodes[ index ];
+
+			f32 area = SurfaceArea( node.mMin, node.mMax );
+			f32 combinedArea = SurfaceArea( MinVec3( node.mMin, leafMin ), MaxVec3( node.mMax, leafMax ) );
+
+			// Cost of pairing leaf with this node, and of pushing it further down, which grows this node regardless
+			f32 cost = 2.0f * combinedArea;
+			f32 inheritanceCost = 2.0f * ( combinedArea - area );
+
+			f32 childCosts[ 2 ];
+			s32 children[ 2 ] = { node.mLeft, node.mRight };
+			for ( u32 i = 0; i < 2; ++i )
+			{
+				const AABBTreeNode& child = mNodes[ children[ i ] ];
+				f32 childArea = SurfaceArea( MinVec3( child.mMin, leafMin ), MaxVec3( child.mMax, leafMax ) );
+				childCosts[ i ] = ( child.IsLeaf( ) ? childArea : childArea - SurfaceArea( child.mMin, child.mMax ) ) + inheritanceCost;
+			}
+
+			if ( cost < childCosts[ 0 ] && cost < childCosts[ 1 ] )
+			{
+				break;
+			}
+
+			index = childCosts[ 0 ] < childCosts[ 1 ] ? children[ 0 ] : children[ 1 ];
+		}
+
+		s32 sibling = index;
+		s32 oldParent = mNodes[ sibling ].mParent;
+		s32 newParent = AllocateNode( );
+
+		mNodes[ newParent ].mParent = oldParent;
+		mNodes[ newParent ].mMin = MinVec3( mNodes[ sibling ].mMin, leafMin );
+		mNodes[ newParent ].mMax = MaxVec3( mNodes[ sibling ].mMax, leafMax );
+		mNodes[ newParent ].mHeight = mNodes[ sibling ].mHeight + 1;
+		mNodes[ newParent ].mLeft = sibling;
+		mNodes[ newParent ].mRight = leaf;
+
+		if ( oldParent != ENJON_AABB_TREE_NULL_NODE )
+		{
+			if ( mNodes[ oldParent ].mLeft == sibling )
+			{
+				mNodes[ oldParent ].mLeft = newParent;
+			}
+			else
+			{
+				mNodes[ oldParent ].mRight = newParent;
+			}
+		}
+		else
+		{
+			mRoot = newParent;
+		}
+
+		mNodes[ sibling ].mParent = newParent;
+		mNodes[ leaf ].mParent = newParent;
+
+		Refit( mNodes[ leaf ].mParent );
+	}
+
+	//=================================================================
+
+	void AABBTree::RemoveLeaf( s32 leaf )
+	{
+		if ( leaf == mRoot )
+		{
+			mRoot = ENJON_AABB_TREE_NULL_NODE;
+			return;
+		}
+
+		s32 parent = mNodes[ leaf ].mParent;
+		s32 grandParent = mNodes[ parent ].mParent;
+		s32 sibling = mNodes[ parent ].mLeft == leaf ? mNodes[ parent ].mRight : mNodes[ parent ].mLeft;
+
+		// Sibling takes parent's place
+		if ( grandParent != ENJON_AABB_TREE_NULL_NODE )
+		{
+			if ( mNodes[ grandParent ].mLeft == parent )
+			{
+				mNodes[ grandParent ].mLeft = sibling;
+			}
+			else
+			{
+				mNodes[ grandParent ].mRight = sibling;
+			}
+
+			mNodes[ sibling ].mParent = grandParent;
+			FreeNode( parent );
+
+			Refit( grandParent );
+		}
+		else
+		{
+			mRoot = sibling;
+			mNodes[ sibling ].mParent = ENJON_AABB_TREE_NULL_NODE;
+			FreeNode( parent );
+		}
+	}
+
+	//=================================================================
+
+	void AABBTree::Refit( s32 node )
+	{
+		while ( node != ENJON_AABB_TREE_NULL_NODE )
+		{
+			node = Balance( node );
+
+			AABBTreeNode& n = mNodes[ node ];
+			const AABBTreeNode& left = mNodes[ n.mLeft ];
+			const AABBTreeNode& right = mNodes[ n.mRight ];
+
+			n.mHeight = 1 + std::max( left.mHeight, right.mHeight );
+			n.mMin = MinVec3( left.mMin, right.mMin );
+			n.mMax = MaxVec3( left.mMax, right.mMax );
+
+			node = n.mParent;
+		}
+	}
+
+	//=================================================================
+
+	s32 AABBTree::Balance( s32 iA )
+	{
+		AABBTreeNode& A = mNodes[ iA ];
+		if ( A.IsLeaf( ) || A.mHeight < 2 )
+		{
+			return iA;
+		}
+
+		s32 iB = A.mLeft;
+		s32 iC = A.mRight;
+		AABBTreeNode& B = mNodes[ iB ];
+		AABBTreeNode& C = mNodes[ iC ];
+
+		s32 balance = C.mHeight - B.mHeight;
+
+		// Rotate C up
+		if ( balance > 1 )
+		{
+			s32 iF = C.mLeft;
+			s32 iG = C.mRight;
+			AABBTreeNode& F = mNodes[ iF ];
+			AABBTreeNode& G = mNodes[ iG ];
+
+			C.mLeft = iA;
+			C.mParent = A.mParent;
+			A.mParent = iC;
+
+			if ( C.mParent != ENJON_AABB_TREE_NULL_NODE )
+			{
+				if ( mNodes[ C.mParent ].mLeft == iA )
+				{
+					mNodes[ C.mParent ].mLeft = iC;
+				}
+				else
+				{
+					mNodes[ C.mParent ].mRight = iC;
+				}
+			}
+			else
+			{
+				mRoot = iC;
+			}
+
+			// Taller of C's children stays under it, shorter moves under A
+			AABBTreeNode& kept = F.mHeight > G.mHeight ? F : G;
+			AABBTreeNode& moved = F.mHeight > G.mHeight ? G : F;
+			s32 iKept = F.mHeight > G.mHeight ? iF : iG;
+			s32 iMoved = F.mHeight > G.mHeight ? iG : iF;
+
+			C.mRight = iKept;
+			A.mRight = iMoved;
+			moved.mParent = iA;
+
+			A.mMin = MinVec3( B.mMin, moved.mMin );
+			A.mMax = MaxVec3( B.mMax, moved.mMax );
+			C.mMin = MinVec3( A.mMin, kept.mMin );
+			C.mMax = MaxVec3( A.mMax, kept.mMax );
+
+			A.mHeight = 1 + std::max( B.mHeight, moved.mHeight );
+			C.mHeight = 1 + std::max( A.mHeight, kept.mHeight );
+
+			return iC;
+		}
+
+		// Rotate B up
+		if ( balance < -1 )
+		{
+			s32 iD = B.mLeft;
+			s32 iE = B.mRight;
+			AABBTreeNode& D = mNodes[ iD ];
+			AABBTreeNode& E = mNodes[ iE ];
+
+			B.mLeft = iA;
+			B.mParent = A.mParent;
+			A.mParent = iB;
+
+			if ( B.mParent != ENJON_AABB_TREE_NULL_NODE )
+			{
+				if ( mNodes[ B.mParent ].mLeft == iA )
+				{
+					mNodes[ B.mParent ].mLeft = iB;
+				}
+				else
+				{
+					mNodes[ B.mParent ].mRight = iB;
+				}
+			}
+			else
+			{
+				mRoot = iB;
+			}
+
+			AABBTreeNode& kept = D.mHeight > E.mHeight ? D : E;
+			AABBTreeNode& moved = D.mHeight > E.mHeight ? E : D;
+			s32 iKept = D.mHeight > E.mHeight ? iD : iE;
+			s32 iMoved = D.mHeight > E.mHeight ? iE : iD;
+
+			B.mRight = iKept;
+			A.mLeft = iMoved;
+			moved.mParent = iA;
+
+			A.mMin = MinVec3( C.mMin, moved.mMin );
+			A.mMax = MaxVec3( C.mMax, moved.mMax );
+			B.mMin = MinVec3( A.mMin, kept.mMin );
+			B.mMax = MaxVec3( A.mMax, kept.mMax );
+
+			A.mHeight = 1 + std::max( C.mHeight, moved.mHeight );
+			B.mHeight = 1 + std::max( A.mHeight, kept.mHeight );
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	//=================================================================
+
+	void AABBTree::QueryAABB( const Vec3& min, const Vec3& max, const std::function< void( s32 ) >& callback ) const
+	{
+		if ( mRoot == ENJON_AABB_TREE_NULL_NODE )
+		{
+			return;
+		}
+
+		Vector< s32 > stack;
+		stack.reserve( 64 );
+		stack.push_back( mRoot );
+
+		while ( !stack.empty( ) )
+		{
+			s32 index = stack.back( );
+			stack.pop_back( );
+
+			const AABBTreeNode& node = mNodes[ index ];
+			if ( !Overlaps( node, min, max ) )
+			{
+				continue;
+			}
+
+			if ( node.IsLeaf( ) )
+			{
+				callback( index );
+			}
+			else
+			{
+				stack.push_back( node.mLeft );
+				stack.push_back( node.mRight );
+			}
+		}
+	}
+
+	//=================================================================
+
+	void AABBTree::QuerySphere( const Vec3& center, f32 radius, const std::function< void( s32 ) >& callback ) const
+	{
+		if ( mRoot == ENJON_AABB_TREE_NULL_NODE )
+		{
+			return;
+		}
+
+		Vector< s32 > stack;
+		stack.reserve( 64 );
+		stack.push_back( mRoot );
+
+		f32 radiusSquared = radius * radius;
+
+		while ( !stack.empty( ) )
+		{
+			s32 index = stack.back( );
+			stack.pop_back( );
+
+			// Distance from center to closest point of box
+			const AABBTreeNode& node = mNodes[ index ];
+			Vec3 closest = MinVec3( MaxVec3( center, node.mMin ), node.mMax );
+			Vec3 d = closest - center;
+			if ( d.x * d.x + d.y * d.y + d.z * d.z > radiusSquared )
+			{
+				continue;
+			}
+
+			if ( node.IsLeaf( ) )
+			{
+				callback( index );
+			}
+			else
+			{
+				stack.push_back( node.mLeft );
+				stack.push_back( node.mRight );
+			}
+		}
+	}
+
+	//=================================================================
+
+	void AABBTree::QueryFrustum( const Frustum& frustum, const std::function< void( s32, b32 ) >& callback ) const
+	{
+		if ( mRoot == ENJON_AABB_TREE_NULL_NODE )
+		{
+			return;
+		}
+
+		// Nodes paired with whether an ancestor was already found wholly inside
+		Vector< std::pair< s32, b32 > > stack;
+		stack.reserve( 64 );
+		stack.push_back( std::make_pair( mRoot, false ) );
+
+		while ( !stack.empty( ) )
+		{
+			s32 index = stack.back( ).first;
+			b32 inside = stack.back( ).second;
+			stack.pop_back( );
+
+			const AABBTreeNode& node = mNodes[ index ];
+
+			if ( !inside )
+			{
+				FrustumContainment containment = frustum.ClassifyAABB( ( node.mMin + node.mMax ) * 0.5f, ( node.mMax - node.mMin ) * 0.5f );
+				if ( containment == FrustumContainment::Outside )
+				{
+					continue;
+				}
+
+				inside = containment == FrustumContainment::Inside;
+			}
+
+			if ( node.IsLeaf( ) )
+			{
+				callback( index, inside );
+			}
+			else
+			{
+				stack.push_back( std::make_pair( node.mLeft, inside ) );
+				stack.push_back( std::make_pair( node.mRight, inside ) );
+			}
+		}
+	}
+
+	//=================================================================
+
+	void AABBTree::RayCast( const Ray& ray, f32 maxDistance, const std::function< void( s32, f32 ) >& callback ) const
+	{
+		if ( mRoot == ENJON_AABB_TREE_NULL_NODE )
+		{
+			return;
+		}
+
+		const Vec3& origin = ray.mPoint;
+		const Vec3& direction = ray.mDirection;
+
+		Vector< s32 > stack;
+		stack.reserve( 64 );
+		stack.push_back( mRoot );
+
+		while ( !stack.empty( ) )
+		{
+			s32 index = stack.back( );
+			stack.pop_back( );
+
+			const AABBTreeNode& node = mNodes[ index ];
+
+			// Slab test, clipping ray against each axis of box in turn
+			f32 tMin = 0.0f;
+			f32 tMax = maxDistance;
+			b32 hit = true;
+			for ( u32 axis = 0; axis < 3 && hit; ++axis )
+			{
+				f32 o = GetAxis( origin, axis );
+				f32 d = GetAxis( direction, axis );
+				f32 lo = GetAxis( node.mMin, axis );
+				f32 hi = GetAxis( node.mMax, axis );
+
+				if ( fabsf( d ) < 1e-8f )
+				{
+					hit = o >= lo && o <= hi;
+					continue;
+				}
+
+				f32 t0 = ( lo - o ) / d;
+				f32 t1 = ( hi - o ) / d;
+				if ( t0 > t1 )
+				{
+					std::swap( t0, t1 );
+				}
+
+				tMin = std::max( tMin, t0 );
+				tMax = std::min( tMax, t1 );
+				hit = tMin <= tMax;
+			}
+
+			if ( !hit )
+			{
+				continue;
+			}
+
+			if ( node.IsLeaf( ) )
+			{
+				callback( index, tMin );
+			}
+			else
+			{
+				stack.push_back( node.mLeft );
+				stack.push_back( node.mRight );
+			}
+		}
+	}
+
+	//=================================================================
+}
@@ -1,5 +1,6 @@
 #include "Math/Maths.h"
 #include "Graphics/Font.h"
+#include "Graphics/GPUMemoryTracker.h"
 #include "System/Types.h"
 #include "Utils/Errors.h" 
 #include "Asset/FontAssetLoader.h"
@@ -13,6 +14,22 @@
 #include <freetype/ftoutln.h>
 #include <freetype/fttrigon.h>
 
+#include <algorithm>
+
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "ImGui/stb_rect_pack.h"
+
+// Distance transform of vendored Include/ImGui/imgui_edtaa3func.h, which is compiled along with ImGui's GL3 binding
+extern "C"
+{
+	void computegradient( double* img, int w, int h, double* gx, double* gy );
+	void edtaa3( double* img, double* gx, double* gy, int w, int h, short* distx, short* disty, double* dist );
+}
+
+// Largest atlas dimension tried before giving up on packing
+#define ENJON_FONT_SDF_MAX_ATLAS_SIZE		4096
+
 
 const Enjon::u32 GLYPH_SIZE = 128;
 
@@ -90,6 +107,9 @@ namespace Enjon
 
 			glGenerateMipmap(GL_TEXTURE_2D);
 
+			u32 glyphWidth = face->glyph->bitmap.width, glyphHeight = face->glyph->bitmap.rows;
+			GPUMemoryTracker::Track( GPUResourceType::Texture, texture, GPUMemoryTracker::GetTextureSize( GL_RED, glyphWidth, glyphHeight, GPUMemoryTracker::GetFullMipCount( glyphWidth, glyphHeight ) ), "Fonts", filePath );
+
 	        // Now store character for later use
 	        Character character = {
 	            texture,
@@ -890,6 +910,36 @@ namespace Enjon
 			buffer->Write< u8 >( b );
 		}
 
+		// Write out cooked distance field atlas
+		if ( HasSDFAtlas( ) )
+		{
+			buffer->Write< u32 >( ENJON_FONT_SDF_MAGIC );
+			buffer->Write< u32 >( mSDFAtlas.mBakeSize );
+			buffer->Write< u32 >( mSDFAtlas.mSpread );
+			buffer->Write< f32 >( mSDFAtlas.mAscent );
+			buffer->Write< f32 >( mSDFAtlas.mDescent );
+			buffer->Write< f32 >( mSDFAtlas.mLineHeight );
+			buffer->Write< u32 >( mSDFAtlas.mWidth );
+			buffer->Write< u32 >( mSDFAtlas.mHeight );
+			buffer->Write< u32 >( mSDFAtlas.mSolidX );
+			buffer->Write< u32 >( mSDFAtlas.mSolidY );
+
+			buffer->Write< u32 >( ( u32 )mSDFAtlas.mGlyphs.size( ) );
+			for ( const FontSDFGlyph& g : mSDFAtlas.mGlyphs )
+			{
+				buffer->Write< u32 >( g.mCodepoint );
+				buffer->Write< u16 >( g.mX );
+				buffer->Write< u16 >( g.mY );
+				buffer->Write< u16 >( g.mWidth );
+				buffer->Write< u16 >( g.mHeight );
+				buffer->Write< f32 >( g.mOffsetX );
+				buffer->Write< f32 >( g.mOffsetY );
+				buffer->Write< f32 >( g.mAdvance );
+			}
+
+			buffer->WriteBytes( mSDFAtlas.mPixels.data( ), ( u32 )mSDFAtlas.mPixels.size( ) );
+		}
+
 		return Result::SUCCESS;
 	}
 
@@ -907,6 +957,41 @@ namespace Enjon
 			mFontData.mData[i] = b;
 		}
 
+		// Fonts cached before atlases were cooked have nothing more, so are cooked now
+		if ( buffer->GetReadPosition( ) >= buffer->GetSize( ) || buffer->Read< u32 >( ) != ENJON_FONT_SDF_MAGIC )
+		{
+			return BuildSDFAtlas( );
+		}
+
+		mSDFAtlas.mBakeSize = buffer->Read< u32 >( );
+		mSDFAtlas.mSpread = buffer->Read< u32 >( );
+		mSDFAtlas.mAscent = buffer->Read< f32 >( );
+		mSDFAtlas.mDescent = buffer->Read< f32 >( );
+		mSDFAtlas.mLineHeight = buffer->Read< f32 >( );
+		mSDFAtlas.mWidth = buffer->Read< u32 >( );
+		mSDFAtlas.mHeight = buffer->Read< u32 >( );
+		mSDFAtlas.mSolidX = buffer->Read< u32 >( );
+		mSDFAtlas.mSolidY = buffer->Read< u32 >( );
+
+		mSDFAtlas.mGlyphs.resize( buffer->Read< u32 >( ) );
+		for ( FontSDFGlyph& g : mSDFAtlas.mGlyphs )
+		{
+			g.mCodepoint = buffer->Read< u32 >( );
+			g.mX = buffer->Read< u16 >( );
+			g.mY = buffer->Read< u16 >( );
+			g.mWidth = buffer->Read< u16 >( );
+			g.mHeight = buffer->Read< u16 >( );
+			g.mOffsetX = buffer->Read< f32 >( );
+			g.mOffsetY = buffer->Read< f32 >( );
+			g.mAdvance = buffer->Read< f32 >( );
+		}
+
+		mSDFAtlas.mPixels.resize( mSDFAtlas.mWidth * mSDFAtlas.mHeight );
+		if ( !buffer->ReadBytes( mSDFAtlas.mPixels.data( ), ( u32 )mSDFAtlas.mPixels.size( ) ) )
+		{
+			return BuildSDFAtlas( );
+		}
+
 		return Result::SUCCESS;
 	}
 
@@ -919,4 +1004,252 @@ namespace Enjon
 
 	//======================================================================================================================== 
 
-}
\ No newline at end of file
+
+	INTERNAL void ComputeSignedDistance( const u8* coverage, u32 width, u32 height, u32 spread, u8* out )
+	{
+		usize count = ( usize )width * height;
+		Vector< f64 > image( count ), gx( count ), gy( count ), outside( count ), inside( count );
+		Vector< s16 > distX( count ), distY( count );
+
+		for ( usize i = 0; i < count; ++i )
+		{
+			image[ i ] = coverage[ i ] / 255.0;
+		}
+
+		// Distance of background to glyph
+		computegradient( image.data( ), width, height, gx.data( ), gy.data( ) );
+		edtaa3( image.data( ), gx.data( ), gy.data( ), width, height, distX.data( ), distY.data( ), outside.data( ) );
+
+		// Distance of glyph to background
+		for ( usize i = 0; i < count; ++i )
+		{
+			image[ i ] = 1.0 - image[ i ];
+		}
+		computegradient( image.data( ), width, height, gx.data( ), gy.data( ) );
+		edtaa3( image.data( ), gx.data( ), gy.data( ), width, height, distX.data( ), distY.data( ), inside.data( ) );
+
+		// Edge maps to 0.5, spread pixels inside to 1 and outside to 0
+		for ( usize i = 0; i < count; ++i )
+		{
+			f64 distance = std::max( outside[ i ], 0.0 ) - std::max( inside[ i ], 0.0 );
+			f64 value = 0.5 - distance / ( 2.0 * spread );
+			out[ i ] = ( u8 )( std::min( std::max( value, 0.0 ), 1.0 ) * 255.0 + 0.5 );
+		}
+	}
+
+	//======================================================================================================================== 
+
+	Result UIFont::BuildSDFAtlas( )
+	{
+		mSDFAtlas = FontSDFAtlas( );
+		if ( !mFontData.mData || !mFontData.mSize )
+		{
+			return Result::FAILURE;
+		}
+
+		// Library per cook, so fonts can be cooked on import worker threads
+		FT_Library ft;
+		if ( FT_Init_FreeType( &ft ) )
+		{
+			return Result::FAILURE;
+		}
+
+		FT_Face face;
+		if ( FT_New_Memory_Face( ft, mFontData.mData, ( FT_Long )mFontData.mSize, 0, &face ) )
+		{
+			FT_Done_FreeType( ft );
+			return Result::FAILURE;
+		}
+
+		const u32 spread = ENJON_FONT_SDF_SPREAD;
+		FT_Set_Pixel_Sizes( face, 0, ENJON_FONT_SDF_BAKE_SIZE );
+
+		mSDFAtlas.mBakeSize = ENJON_FONT_SDF_BAKE_SIZE;
+		mSDFAtlas.mSpread = spread;
+		mSDFAtlas.mAscent = face->size->metrics.ascender / 64.0f;
+		mSDFAtlas.mDescent = face->size->metrics.descender / 64.0f;
+		mSDFAtlas.mLineHeight = face->size->metrics.height / 64.0f;
+
+		// Rasterize each glyph once, padded by spread, and transform it into a distance field
+		Vector< Vector< u8 > > fields;
+		for ( u32 c = ENJON_FONT_SDF_FIRST_CODEPOINT; c <= ENJON_FONT_SDF_LAST_CODEPOINT; ++c )
+		{
+			if ( FT_Load_Char( face, c, FT_LOAD_RENDER | FT_LOAD_NO_HINTING ) )
+			{
+				continue;
+			}
+
+			FT_GlyphSlot slot = face->glyph;
+			const FT_Bitmap& bmp = slot->bitmap;
+
+			FontSDFGlyph glyph;
+			glyph.mCodepoint = c;
+			glyph.mAdvance = slot->advance.x / 64.0f;
+
+			Vector< u8 > field;
+			if ( bmp.width && bmp.rows )
+			{
+				u32 width = bmp.width + 2 * spread;
+				u32 height = bmp.rows + 2 * spread;
+
+				Vector< u8 > coverage( width * height, 0 );
+				for ( u32 row = 0; row < bmp.rows; ++row )
+				{
+					memcpy( &coverage[ ( row + spread ) * width + spread ], bmp.buffer + row * bmp.pitch, bmp.width );
+				}
+
+				field.resize( width * height );
+				ComputeSignedDistance( coverage.data( ), width, height, spread, field.data( ) );
+
+				glyph.mWidth = ( u16 )width;
+				glyph.mHeight = ( u16 )height;
+				glyph.mOffsetX = ( f32 )slot->bitmap_left - ( f32 )spread;
+				glyph.mOffsetY = -( f32 )slot->bitmap_top - ( f32 )spread;
+			}
+
+			mSDFAtlas.mGlyphs.push_back( glyph );
+			fields.push_back( std::move( field ) );
+		}
+
+		FT_Done_Face( face );
+		FT_Done_FreeType( ft );
+
+		// Pack glyphs with a texel of gutter between them, plus a small solid block
+		u32 glyphCount = ( u32 )mSDFAtlas.mGlyphs.size( );
+		Vector< stbrp_rect > rects;
+		for ( u32 i = 0; i < glyphCount; ++i )
+		{
+			if ( mSDFAtlas.mGlyphs[ i ].mWidth )
+			{
+				stbrp_rect r = { };
+				r.id = ( s32 )i;
+				r.w = mSDFAtlas.mGlyphs[ i ].mWidth + 1;
+				r.h = mSDFAtlas.mGlyphs[ i ].mHeight + 1;
+				rects.push_back( r );
+			}
+		}
+		stbrp_rect solid = { };
+		solid.id = ( s32 )glyphCount;
+		solid.w = 4;
+		solid.h = 4;
+		rects.push_back( solid );
+
+		// Smallest power of two square everything fits in
+		u32 size = 64;
+		for ( ; size <= ENJON_FONT_SDF_MAX_ATLAS_SIZE; size *= 2 )
+		{
+			stbrp_context context;
+			Vector< stbrp_node > nodes( size );
+			stbrp_init_target( &context, ( s32 )size, ( s32 )size, nodes.data( ), ( s32 )size );
+			stbrp_pack_rects( &context, rects.data( ), ( s32 )rects.size( ) );
+
+			bool packed = true;
+			for ( const stbrp_rect& r : rects )
+			{
+				packed &= ( r.was_packed != 0 );
+			}
+
+			if ( packed )
+			{
+				break;
+			}
+		}
+
+		if ( size > ENJON_FONT_SDF_MAX_ATLAS_SIZE )
+		{
+			mSDFAtlas = FontSDFAtlas( );
+			return Result::FAILURE;
+		}
+
+		// Copy fields into place
+		mSDFAtlas.mWidth = size;
+		mSDFAtlas.mHeight = size;
+		mSDFAtlas.mPixels.assign( size * size, 0 );
+		for ( const stbrp_rect& r : rects )
+		{
+			if ( r.id == ( s32 )glyphCount )
+			{
+				for ( u32 y = 0; y < 3; ++y )
+				{
+					memset( &mSDFAtlas.mPixels[ ( r.y + y ) * size + r.x ], 255, 3 );
+				}
+				mSDFAtlas.mSolidX = r.x + 1;
+				mSDFAtlas.mSolidY = r.y + 1;
+				continue;
+			}
+
+			FontSDFGlyph& glyph = mSDFAtlas.mGlyphs[ r.id ];
+			const Vector< u8 >& field = fields[ r.id ];
+			glyph.mX = ( u16 )r.x;
+			glyph.mY = ( u16 )r.y;
+			for ( u32 row = 0; row < glyph.mHeight; ++row )
+			{
+				memcpy( &mSDFAtlas.mPixels[ ( r.y + row ) * size + r.x ], &field[ row * glyph.mWidth ], glyph.mWidth );
+			}
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//======================================================================================================================== 
+
+	bool UIFont::HasSDFAtlas( ) const
+	{
+		return !mSDFAtlas.mPixels.empty( );
+	}
+
+	//======================================================================================================================== 
+
+	const FontSDFAtlas& UIFont::GetSDFAtlas( ) const
+	{
+		return mSDFAtlas;
+	}
+
+	//======================================================================================================================== 
+
+	const FontSDFGlyph* UIFont::GetSDFGlyph( const u32& codepoint ) const
+	{
+		auto query = std::lower_bound( mSDFAtlas.mGlyphs.begin( ), mSDFAtlas.mGlyphs.end( ), codepoint, [ ] ( const FontSDFGlyph& g, u32 c )
+		{
+			return g.mCodepoint < c;
+		} );
+
+		return ( query != mSDFAtlas.mGlyphs.end( ) && query->mCodepoint == codepoint ) ? &( *query ) : nullptr;
+	}
+
+	//======================================================================================================================== 
+
+	u32 UIFont::GetSDFTextureID( ) const
+	{
+		if ( mSDFTextureID || !HasSDFAtlas( ) )
+		{
+			return mSDFTextureID;
+		}
+
+		UIFont* font = const_cast< UIFont* >( this );
+
+		// Single channel, rows aren't 4 byte aligned
+		GLint lastAlignment;
+		glGetIntegerv( GL_UNPACK_ALIGNMENT, &lastAlignment );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+		glGenTextures( 1, &font->mSDFTextureID );
+		glBindTexture( GL_TEXTURE_2D, mSDFTextureID );
+		glTexImage2D( GL_TEXTURE_2D, 0, GL_R8, mSDFAtlas.mWidth, mSDFAtlas.mHeight, 0, GL_RED, GL_UNSIGNED_BYTE, mSDFAtlas.mPixels.data( ) );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+		glGenerateMipmap( GL_TEXTURE_2D );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, lastAlignment );
+
+		usize bytes = GPUMemoryTracker::GetTextureSize( GL_R8, mSDFAtlas.mWidth, mSDFAtlas.mHeight, GPUMemoryTracker::GetFullMipCount( mSDFAtlas.mWidth, mSDFAtlas.mHeight ) );
+		GPUMemoryTracker::Track( GPUResourceType::Texture, mSDFTextureID, bytes, "Fonts", GetName( ) );
+
+		return mSDFTextureID;
+	}
+
+	//======================================================================================================================== 
+}
@@ -2,7 +2,9 @@
 // File: FrameBuffer.cpp
 
 #include "Graphics/FrameBuffer.h"
+#include "Graphics/GPUMemoryTracker.h"
 #include "Utils/Errors.h"
+#include "Utils/FileUtils.h"
 #include <stdio.h>
 
 namespace Enjon 
@@ -41,6 +43,9 @@ namespace Enjon
 	    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mTexture, 0);
 		glGenerateMipmap(GL_TEXTURE_2D);
 
+		String owner = Utils::format( "%ux%u", mWidth, mHeight );
+		GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mTexture, GPUMemoryTracker::GetTextureSize( GL_RGBA16F, mWidth, mHeight, GPUMemoryTracker::GetFullMipCount( mWidth, mHeight ) ), "FrameBuffer", owner );
+
 		glGenTextures(1, &mDepthBuffer);
 	    glBindTexture(GL_TEXTURE_2D, mDepthBuffer);
 	    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, mWidth, mHeight, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
@@ -52,6 +57,7 @@ namespace Enjon
 	   	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
 
 	    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mDepthBuffer, 0);
+		GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mDepthBuffer, GPUMemoryTracker::GetImageSize( GL_DEPTH_COMPONENT, mWidth, mHeight ), "FrameBuffer", owner );
 	    glDrawBuffer(GL_NONE);
 	    glReadBuffer(GL_NONE);
 	 
@@ -69,10 +75,13 @@ namespace Enjon
 
 	void FrameBuffer::ExplicitDestructor( )
 	{
+		GPUMemoryTracker::Release( GPUResourceType::RenderTarget, mTexture );
+		GPUMemoryTracker::Release( GPUResourceType::RenderTarget, mDepthBuffer );
+
 		glDeleteTextures(1, &mTexture);
 		glDeleteFramebuffers(1, &mFrameBufferID);
 		glDeleteRenderbuffers(1, &mTargetID);
-		glDeleteRenderbuffers(1, &mDepthBuffer);
+		glDeleteTextures(1, &mDepthBuffer);
 	}
 
 	void FrameBuffer::Bind(BindType type, bool clear)
@@ -0,0 +1,238 @@
+// @file Frustum.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/Frustum.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+#if defined( __SSE__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 1 )
+	#define ENJON_FRUSTUM_SSE 1
+	#include <xmmintrin.h>
+#endif
+
+namespace Enjon
+{
+	//=================================================================
+
+	void CullingBounds::Resize( u32 count )
+	{
+		u32 padded = ( count + 3 ) & ~3u;
+		mCenterX.resize( padded );
+		mCenterY.resize( padded );
+		mCenterZ.resize( padded );
+		mExtentX.resize( padded );
+		mExtentY.resize( padded );
+		mExtentZ.resize( padded );
+		mCount = count;
+	}
+
+	//=================================================================
+
+	void CullingBounds::SetAABB( u32 index, const Vec3& center, const Vec3& extents )
+	{
+		mCenterX[ index ] = center.x;
+		mCenterY[ index ] = center.y;
+		mCenterZ[ index ] = center.z;
+		mExtentX[ index ] = extents.x;
+		mExtentY[ index ] = extents.y;
+		mExtentZ[ index ] = extents.z;
+	}
+
+	//=================================================================
+
+	void CullingBounds::SetSphere( u32 index, const Vec3& center, f32 radius )
+	{
+		SetAABB( index, center, Vec3( radius ) );
+	}
+
+	//=================================================================
+
+	void CullingBounds::SetInfinite( u32 index )
+	{
+		SetAABB( index, Vec3( 0.0f ), Vec3( FLT_MAX ) );
+	}
+
+	//=================================================================
+
+	Frustum Frustum::FromViewProjection( const Mat4x4& viewProjection )
+	{
+		// Rows of matrix, which is stored by column
+		Vec4 rows[ 4 ];
+		for ( u32 i = 0; i < 4; ++i )
+		{
+			rows[ i ] = Vec4( viewProjection.elements[ i ], viewProjection.elements[ 4 + i ], viewProjection.elements[ 8 + i ], viewProjection.elements[ 12 + i ] );
+		}
+
+		Frustum frustum;
+		frustum.mPlanes[ 0 ] = rows[ 3 ] + rows[ 0 ];		// Left
+		frustum.mPlanes[ 1 ] = rows[ 3 ] - rows[ 0 ];		// Right
+		frustum.mPlanes[ 2 ] = rows[ 3 ] + rows[ 1 ];		// Bottom
+		frustum.mPlanes[ 3 ] = rows[ 3 ] - rows[ 1 ];		// Top
+		frustum.mPlanes[ 4 ] = rows[ 3 ] + rows[ 2 ];		// Near
+		frustum.mPlanes[ 5 ] = rows[ 3 ] - rows[ 2 ];		// Far
+
+		for ( auto& p : frustum.mPlanes )
+		{
+			f32 length = sqrtf( p.x * p.x + p.y * p.y + p.z * p.z );
+			if ( length > 0.0f )
+			{
+				p = p / length;
+			}
+		}
+
+		return frustum;
+	}
+
+	//=================================================================
+
+	void Frustum::TransformAABB( const Mat4x4& model, const Vec3& min, const Vec3& max, Vec3* center, Vec3* extents )
+	{
+		Vec3 localCenter = ( min + max ) * 0.5f;
+		Vec3 localExtents = ( max - min ) * 0.5f;
+
+		// Extents of transformed box are extents projected onto each world axis through absolute rotation and scale
+		*center = ( model * Vec4( localCenter, 1.0f ) ).XYZ( );
+		*extents = Vec3(
+			fabsf( model.columns[ 0 ].x ) * localExtents.x + fabsf( model.columns[ 1 ].x ) * localExtents.y + fabsf( model.columns[ 2 ].x ) * localExtents.z,
+			fabsf( model.columns[ 0 ].y ) * localExtents.x + fabsf( model.columns[ 1 ].y ) * localExtents.y + fabsf( model.columns[ 2 ].y ) * localExtents.z,
+			fabsf( model.columns[ 0 ].z ) * localExtents.x + fabsf( model.columns[ 1 ].z ) * localExtents.y + fabsf( model.columns[ 2 ].z ) * localExtents.z
+		);
+	}
+
+	//=================================================================
+
+	bool Frustum::IntersectsAABB( const Vec3& center, const Vec3& extents ) const
+	{
+		for ( const Vec4& p : mPlanes )
+		{
+			f32 distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+			f32 radius = fabsf( p.x ) * extents.x + fabsf( p.y ) * extents.y + fabsf( p.z ) * extents.z;
+			if ( distance + radius < 0.0f )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//=================================================================
+
+	bool Frustum::IntersectsSphere( const Vec3& center, f32 radius ) const
+	{
+		for ( const Vec4& p : mPlanes )
+		{
+			if ( p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//=================================================================
+
+	FrustumContainment Frustum::ClassifyAABB( const Vec3& center, const Vec3& extents ) const
+	{
+		FrustumContainment result = FrustumContainment::Inside;
+		for ( const Vec4& p : mPlanes )
+		{
+			f32 distance = p.x * center.x + p.y * center.y + p.z * center.z + p.w;
+			f32 radius = fabsf( p.x ) * extents.x + fabsf( p.y ) * extents.y + fabsf( p.z ) * extents.z;
+			if ( distance + radius < 0.0f )
+			{
+				return FrustumContainment::Outside;
+			}
+
+			if ( distance - radius < 0.0f )
+			{
+				result = FrustumContainment::Intersecting;
+			}
+		}
+
+		return result;
+	}
+
+	//=================================================================
+
+	void Frustum::CullAABBs( const CullingBounds& bounds, u32 first, u32 count, u8* visible ) const
+	{
+		u32 end = std::min( first + count, bounds.GetCount( ) );
+		u32 i = first;
+
+#ifdef ENJON_FRUSTUM_SSE
+		const __m128 zero = _mm_setzero_ps( );
+		for ( ; i < end; i += 4 )
+		{
+			__m128 cx = _mm_loadu_ps( &bounds.mCenterX[ i ] );
+			__m128 cy = _mm_loadu_ps( &bounds.mCenterY[ i ] );
+			__m128 cz = _mm_loadu_ps( &bounds.mCenterZ[ i ] );
+			__m128 ex = _mm_loadu_ps( &bounds.mExtentX[ i ] );
+			__m128 ey = _mm_loadu_ps( &bounds.mExtentY[ i ] );
+			__m128 ez = _mm_loadu_ps( &bounds.mExtentZ[ i ] );
+
+			// Box is outside once its center is further behind any plane than its extents reach
+			__m128 inside = _mm_cmpeq_ps( zero, zero );
+			for ( const Vec4& p : mPlanes )
+			{
+				__m128 distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, _mm_set1_ps( p.x ) ), _mm_mul_ps( cy, _mm_set1_ps( p.y ) ) ), _mm_add_ps( _mm_mul_ps( cz, _mm_set1_ps( p.z ) ), _mm_set1_ps( p.w ) ) );
+				__m128 radius = _mm_add_ps( _mm_add_ps( _mm_mul_ps( ex, _mm_set1_ps( fabsf( p.x ) ) ), _mm_mul_ps( ey, _mm_set1_ps( fabsf( p.y ) ) ) ), _mm_mul_ps( ez, _mm_set1_ps( fabsf( p.z ) ) ) );
+				inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( distance, radius ), zero ) );
+			}
+
+			s32 mask = _mm_movemask_ps( inside );
+			for ( u32 j = 0; j < 4 && i + j < end; ++j )
+			{
+				visible[ i + j ] = ( mask >> j ) & 1;
+			}
+		}
+#endif
+
+		for ( ; i < end; ++i )
+		{
+			visible[ i ] = IntersectsAABB( Vec3( bounds.mCenterX[ i ], bounds.mCenterY[ i ], bounds.mCenterZ[ i ] ), Vec3( bounds.mExtentX[ i ], bounds.mExtentY[ i ], bounds.mExtentZ[ i ] ) );
+		}
+	}
+
+	//=================================================================
+
+	void Frustum::CullSpheres( const CullingBounds& bounds, u32 first, u32 count, u8* visible ) const
+	{
+		u32 end = std::min( first + count, bounds.GetCount( ) );
+		u32 i = first;
+
+#ifdef ENJON_FRUSTUM_SSE
+		const __m128 zero = _mm_setzero_ps( );
+		for ( ; i < end; i += 4 )
+		{
+			__m128 cx = _mm_loadu_ps( &bounds.mCenterX[ i ] );
+			__m128 cy = _mm_loadu_ps( &bounds.mCenterY[ i ] );
+			__m128 cz = _mm_loadu_ps( &bounds.mCenterZ[ i ] );
+			__m128 r = _mm_loadu_ps( &bounds.mExtentX[ i ] );
+
+			__m128 inside = _mm_cmpeq_ps( zero, zero );
+			for ( const Vec4& p : mPlanes )
+			{
+				__m128 distance = _mm_add_ps( _mm_add_ps( _mm_mul_ps( cx, _mm_set1_ps( p.x ) ), _mm_mul_ps( cy, _mm_set1_ps( p.y ) ) ), _mm_add_ps( _mm_mul_ps( cz, _mm_set1_ps( p.z ) ), _mm_set1_ps( p.w ) ) );
+				inside = _mm_and_ps( inside, _mm_cmpge_ps( _mm_add_ps( distance, r ), zero ) );
+			}
+
+			s32 mask = _mm_movemask_ps( inside );
+			for ( u32 j = 0; j < 4 && i + j < end; ++j )
+			{
+				visible[ i + j ] = ( mask >> j ) & 1;
+			}
+		}
+#endif
+
+		for ( ; i < end; ++i )
+		{
+			visible[ i ] = IntersectsSphere( Vec3( bounds.mCenterX[ i ], bounds.mCenterY[ i ], bounds.mCenterZ[ i ] ), bounds.mExtentX[ i ] );
+		}
+	}
+
+	//=================================================================
+}
@@ -1,4 +1,5 @@
 #include "Graphics/FullScreenQuad.h"
+#include "Graphics/GPUMemoryTracker.h"
 
 namespace Enjon { 
 
@@ -17,6 +18,7 @@ namespace Enjon {
 		glBindVertexArray( mVAO );
 		glBindBuffer( GL_ARRAY_BUFFER, mVBO );
 		glBufferData( GL_ARRAY_BUFFER, sizeof( quadVertices ), &quadVertices, GL_STATIC_DRAW );
+		GPUMemoryTracker::Track( GPUResourceType::Buffer, mVBO, sizeof( quadVertices ), "FullScreenQuad" );
 
 		// Positions
 		glEnableVertexAttribArray( 0 );
@@ -33,6 +35,9 @@ namespace Enjon {
 	FullScreenQuad::~FullScreenQuad()
 	{
 		// Clean up mVAO
+		GPUMemoryTracker::Release( GPUResourceType::Buffer, mVBO );
+		glDeleteBuffers( 1, &mVBO );
+		glDeleteVertexArrays( 1, &mVAO );
 	}
 
 	void FullScreenQuad::Bind()
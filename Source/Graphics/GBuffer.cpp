@@ -1,4 +1,5 @@
 #include "Graphics/GBuffer.h"
+#include "Graphics/GPUMemoryTracker.h"
 #include "Utils/Errors.h"
 #include "Defines.h"
 #include <stdio.h>
@@ -25,6 +26,8 @@ namespace Enjon {
 		glGenerateMipmap( GL_TEXTURE_2D );\
 		\
 		glBindTexture( GL_TEXTURE_2D, 0 );\
+		\
+		GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mTextures[ index ], GPUMemoryTracker::GetTextureSize( InternalFormat, mWidth, mHeight, GPUMemoryTracker::GetFullMipCount( mWidth, mHeight ) ), "GBuffer", #GBufferAttachment );\
 	}
 
 	GBuffer::GBuffer(u32 width, u32 height)
@@ -60,6 +63,7 @@ namespace Enjon {
 		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
 		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
 		glFramebufferTexture2D( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, mDepthTexture, 0 ); 
+		GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mDepthTexture, GPUMemoryTracker::GetImageSize( GL_DEPTH_COMPONENT24, mWidth, mHeight ), "GBuffer", "GBufferTextureType::DEPTH" );
 
 		glBindTexture( GL_TEXTURE_2D, 0 );
 		
@@ -78,10 +82,14 @@ namespace Enjon {
 	{
 		for (u32 i = 0; i < (u32)GBufferTextureType::GBUFFER_TEXTURE_COUNT; ++i)
 		{
+			GPUMemoryTracker::Release( GPUResourceType::RenderTarget, mTextures[i] );
 			glDeleteTextures(1, &mTextures[i]);
 			glDeleteRenderbuffers(1, &mTargetIDs[i]);
 		}
 
+		GPUMemoryTracker::Release( GPUResourceType::RenderTarget, mDepthTexture );
+		glDeleteTextures( 1, &mDepthTexture );
+
 		// Clean up buffers
 		glDeleteFramebuffers(1, &mFrameBufferID);
 		glDeleteRenderbuffers(1, &mDepthBuffer);
@@ -0,0 +1,120 @@
+// @file GLRenderCommandExecutor.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/GLRenderCommandExecutor.h"
+#include "Graphics/Shader.h"
+#include "Graphics/Material.h"
+#include "Graphics/Mesh.h"
+
+#include <assert.h>
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL const char* GetUniformName( RenderUniform uniform )
+	{
+		switch ( uniform )
+		{
+			case RenderUniform::ViewProjection:			return "uViewProjection";
+			case RenderUniform::PreviousViewProjection:	return "uPreviousViewProjection";
+			case RenderUniform::ViewPosition:			return "uViewPositionWorldSpace";
+			case RenderUniform::WorldTime:				return "uWorldTime";
+			case RenderUniform::Model:					return "uModel";
+			case RenderUniform::PreviousModel:			return "uPreviousModel";
+			case RenderUniform::ObjectID:				return "uObjectID";
+			case RenderUniform::JointTransforms:		return "uJointTransforms";
+			default: assert( false ); return "";
+		}
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::Invalidate( )
+	{
+		mShader = nullptr;
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::BindProgram( const Shader* shader )
+	{
+		// Consecutive buffers recorded in chunks each begin by binding their program
+		if ( mShader == shader )
+		{
+			return;
+		}
+
+		mShader = const_cast< Shader* >( shader );
+		mShader->Use( );
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::BindMaterial( const Material* material )
+	{
+		assert( mShader != nullptr );
+		material->Bind( mShader );
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::SetUniform( RenderUniform uniform, f32 value )
+	{
+		mShader->SetUniform( GetUniformName( uniform ), value );
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::SetUniform( RenderUniform uniform, const Vec3& value )
+	{
+		mShader->SetUniform( GetUniformName( uniform ), value );
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::SetUniform( RenderUniform uniform, const Vec4& value )
+	{
+		mShader->SetUniform( GetUniformName( uniform ), value );
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count )
+	{
+		const char* name = GetUniformName( uniform );
+
+		// Arrays are set element by element through their first element's location
+		if ( uniform == RenderUniform::JointTransforms )
+		{
+			for ( u32 i = 0; i < count; ++i )
+			{
+				mShader->SetUniformArrayElement( name, i, values[ i ] );
+			}
+		}
+		else
+		{
+			mShader->SetUniform( name, values[ 0 ] );
+		}
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::BindMesh( const Mesh* mesh )
+	{
+		mesh->Bind( mShader );
+	}
+
+	//=================================================================
+
+	void GLRenderCommandExecutor::DrawSubMesh( const SubMesh* subMesh, u32 lod )
+	{
+		subMesh->Bind( );
+		{
+			subMesh->Submit( lod );
+		}
+		subMesh->Unbind( );
+	}
+
+	//=================================================================
+}
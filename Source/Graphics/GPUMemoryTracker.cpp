@@ -0,0 +1,285 @@
+// @file GPUMemoryTracker.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/GPUMemoryTracker.h"
+
+#include <GLEW/glew.h>
+
+#include <algorithm>
+#include <mutex>
+
+namespace Enjon
+{
+	INTERNAL std::mutex sGPUMemoryLock;
+	INTERNAL HashMap< u64, GPUAllocation > sGPUAllocations;
+	INTERNAL usize sGPUTypeBytes[ ( u32 )GPUResourceType::Count ] = { };
+	INTERNAL usize sGPUTotalBytes = 0;
+	INTERNAL usize sGPUPeakBytes = 0;
+
+	//=================================================================
+
+	INTERNAL u64 GetAllocationKey( GPUResourceType type, u32 handle )
+	{
+		// Render targets are textures, so are named from the same pool as them
+		u64 names = type == GPUResourceType::Buffer ? 1 : 0;
+		return ( names << 32 ) | handle;
+	}
+
+	//=================================================================
+
+	INTERNAL void RemoveAllocation( const GPUAllocation& allocation )
+	{
+		sGPUTypeBytes[ ( u32 )allocation.mType ] -= allocation.mBytes;
+		sGPUTotalBytes -= allocation.mBytes;
+	}
+
+	//=================================================================
+
+	void GPUMemoryTracker::Track( GPUResourceType type, u32 handle, usize bytes, const String& pool, const String& owner )
+	{
+		if ( !handle || type == GPUResourceType::Count )
+		{
+			return;
+		}
+
+		std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+
+		GPUAllocation& allocation = sGPUAllocations[ GetAllocationKey( type, handle ) ];
+		RemoveAllocation( allocation );
+
+		allocation.mType = type;
+		allocation.mHandle = handle;
+		allocation.mBytes = bytes;
+		allocation.mPool = pool;
+		allocation.mOwner = owner;
+
+		sGPUTypeBytes[ ( u32 )type ] += bytes;
+		sGPUTotalBytes += bytes;
+		sGPUPeakBytes = std::max( sGPUPeakBytes, sGPUTotalBytes );
+	}
+
+	//=================================================================
+
+	void GPUMemoryTracker::Release( GPUResourceType type, u32 handle )
+	{
+		std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+
+		auto query = sGPUAllocations.find( GetAllocationKey( type, handle ) );
+		if ( query != sGPUAllocations.end( ) )
+		{
+			RemoveAllocation( query->second );
+			sGPUAllocations.erase( query );
+		}
+	}
+
+	//=================================================================
+
+	usize GPUMemoryTracker::GetTotalBytes( )
+	{
+		std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+		return sGPUTotalBytes;
+	}
+
+	//=================================================================
+
+	usize GPUMemoryTracker::GetPeakBytes( )
+	{
+		std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+		return sGPUPeakBytes;
+	}
+
+	//=================================================================
+
+	usize GPUMemoryTracker::GetBytes( GPUResourceType type )
+	{
+		if ( type == GPUResourceType::Count )
+		{
+			return GetTotalBytes( );
+		}
+
+		std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+		return sGPUTypeBytes[ ( u32 )type ];
+	}
+
+	//=================================================================
+
+	u32 GPUMemoryTracker::GetAllocationCount( )
+	{
+		std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+		return ( u32 )sGPUAllocations.size( );
+	}
+
+	//=================================================================
+
+	INTERNAL void SortTotals( Vector< GPUMemoryTotal >* totals, const HashMap< String, GPUMemoryTotal >& grouped )
+	{
+		totals->clear( );
+		totals->reserve( grouped.size( ) );
+		for ( auto& g : grouped )
+		{
+			totals->push_back( g.second );
+		}
+
+		std::sort( totals->begin( ), totals->end( ), [ ] ( const GPUMemoryTotal& a, const GPUMemoryTotal& b )
+		{
+			return a.mBytes > b.mBytes;
+		} );
+	}
+
+	//=================================================================
+
+	void GPUMemoryTracker::GetPoolTotals( Vector< GPUMemoryTotal >* totals )
+	{
+		HashMap< String, GPUMemoryTotal > pools;
+		{
+			std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+			for ( auto& a : sGPUAllocations )
+			{
+				GPUMemoryTotal& total = pools[ a.second.mPool ];
+				total.mName = a.second.mPool;
+				total.mBytes += a.second.mBytes;
+				total.mCount++;
+			}
+		}
+
+		SortTotals( totals, pools );
+	}
+
+	//=================================================================
+
+	void GPUMemoryTracker::GetLargestOwners( u32 count, Vector< GPUMemoryTotal >* totals )
+	{
+		HashMap< String, GPUMemoryTotal > owners;
+		{
+			std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+			for ( auto& a : sGPUAllocations )
+			{
+				// Owners are only unique within their pool
+				String name = a.second.mOwner.empty( ) ? a.second.mPool : a.second.mPool + ": " + a.second.mOwner;
+				GPUMemoryTotal& total = owners[ name ];
+				total.mName = name;
+				total.mBytes += a.second.mBytes;
+				total.mCount++;
+			}
+		}
+
+		SortTotals( totals, owners );
+		if ( totals->size( ) > count )
+		{
+			totals->resize( count );
+		}
+	}
+
+	//=================================================================
+
+	void GPUMemoryTracker::GetLargestAllocations( GPUResourceType type, u32 count, Vector< GPUAllocation >* allocations )
+	{
+		allocations->clear( );
+		{
+			std::lock_guard< std::mutex > lock( sGPUMemoryLock );
+			for ( auto& a : sGPUAllocations )
+			{
+				if ( type == GPUResourceType::Count || a.second.mType == type )
+				{
+					allocations->push_back( a.second );
+				}
+			}
+		}
+
+		auto comparator = [ ] ( const GPUAllocation& a, const GPUAllocation& b )
+		{
+			return a.mBytes > b.mBytes;
+		};
+
+		if ( allocations->size( ) > count )
+		{
+			std::partial_sort( allocations->begin( ), allocations->begin( ) + count, allocations->end( ), comparator );
+			allocations->resize( count );
+		}
+		else
+		{
+			std::sort( allocations->begin( ), allocations->end( ), comparator );
+		}
+	}
+
+	//=================================================================
+
+	usize GPUMemoryTracker::GetImageSize( u32 internalFormat, u32 width, u32 height )
+	{
+		usize blocks = ( usize )( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 );
+		usize pixels = ( usize )width * height;
+
+		switch ( internalFormat )
+		{
+			// 4x4 blocks
+			case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+			case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+			case GL_COMPRESSED_RED_RGTC1:			return blocks * 8;
+			case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			case GL_COMPRESSED_RG_RGTC2:
+			case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT:
+			case GL_COMPRESSED_RGBA_BPTC_UNORM:		return blocks * 16;
+
+			case GL_RED:
+			case GL_R8:								return pixels;
+			case GL_RG:
+			case GL_RG8:
+			case GL_R16F:							return pixels * 2;
+			case GL_RG16F:
+			case GL_R32F:
+			case GL_DEPTH_COMPONENT:
+			case GL_DEPTH_COMPONENT24:
+			case GL_DEPTH_COMPONENT32F:
+			case GL_DEPTH24_STENCIL8:
+			case GL_RGBA:
+			case GL_RGBA8:
+			case GL_RGB:
+			case GL_RGB8:							return pixels * 4;		// Three component 8 bit formats are padded by drivers
+			case GL_RG32F:
+			case GL_RGB16F:
+			case GL_RGBA16F:						return pixels * 8;		// As are half float ones
+			case GL_RGB32F:							return pixels * 12;
+			case GL_RGBA32F:						return pixels * 16;
+			default:								return pixels * 4;
+		}
+	}
+
+	//=================================================================
+
+	usize GPUMemoryTracker::GetTextureSize( u32 internalFormat, u32 width, u32 height, u32 levels, u32 faces )
+	{
+		usize bytes = 0;
+		for ( u32 level = 0; level < levels; ++level )
+		{
+			bytes += GetImageSize( internalFormat, std::max( width >> level, 1u ), std::max( height >> level, 1u ) );
+		}
+		return bytes * faces;
+	}
+
+	//=================================================================
+
+	u32 GPUMemoryTracker::GetFullMipCount( u32 width, u32 height )
+	{
+		u32 levels = 1;
+		for ( u32 size = std::max( width, height ); size > 1; size >>= 1 )
+		{
+			++levels;
+		}
+		return levels;
+	}
+
+	//=================================================================
+
+	const char* GPUMemoryTracker::ToString( GPUResourceType type )
+	{
+		switch ( type )
+		{
+			case GPUResourceType::Texture:		return "Textures";
+			case GPUResourceType::RenderTarget:	return "Render Targets";
+			case GPUResourceType::Buffer:		return "Buffers";
+			default:							return "All";
+		}
+	}
+
+	//=================================================================
+}
@@ -8,14 +8,29 @@
 #include "Graphics/Camera.h"
 #include "Graphics/StaticMeshRenderable.h"
 #include "Graphics/SkeletalMeshRenderable.h"
+#include "Graphics/Mesh.h"
 #include "Graphics/GraphicsSubsystem.h" 
+#include "System/JobSystem.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
 
 #include <algorithm>
+#include <functional>
+#include <float.h>
+#include <math.h>
 
 namespace Enjon 
 { 
+	// Kinds of objects proxies in spatial indices are for
+	enum class SpatialProxyType : u32
+	{
+		StaticMesh,
+		SkeletalMesh,
+		Custom,
+		Point,
+		Spot
+	};
+
 	//=========================================================================================
 
 	void GraphicsScene::ExplicitDestructor()
@@ -62,29 +77,13 @@ namespace Enjon
 		mDirectionalLights.clear();
 		mPointLights.clear();
 		mSpotLights.clear(); 
-	}
-
-	//====================================================================================================
-
-	void GraphicsScene::SortStaticMeshRenderables( RenderableSortType type )
-	{
-		switch( type )
-		{
-			case RenderableSortType::MATERIAL:
-			{
-				std::stable_sort(mSortedStaticMeshRenderables.begin(), mSortedStaticMeshRenderables.end(), CompareMaterial);
-			} 
-			break;
-
-			case RenderableSortType::DEPTH:
-			{
-				std::stable_sort(mSortedStaticMeshRenderables.begin(), mSortedStaticMeshRenderables.end(), CompareDepth);
-			}
-			break;
 
-			default:
-			case RenderableSortType::NONE: break;
-		} 
+		mRenderableTree.Clear( );
+		mLightTree.Clear( );
+		mRenderableProxies.clear( );
+		mLightProxies.clear( );
+		mDirtyRenderableProxies.clear( );
+		mDirtyLightProxies.clear( );
 	}
 
 	//====================================================================================================
@@ -115,11 +114,8 @@ namespace Enjon
 
 	//====================================================================================================
 
-	const Vector<StaticMeshRenderable*>& GraphicsScene::GetNonDepthTestedStaticMeshRenderables( )
+	const Vector<StaticMeshRenderable*>& GraphicsScene::GetNonDepthTestedStaticMeshRenderables( ) const
 	{
-		// Sort by depth to camera
-		std::stable_sort( mNonDepthTestedStaticMeshRenderables.begin( ), mNonDepthTestedStaticMeshRenderables.end( ), CompareDepth );
-
 		return mNonDepthTestedStaticMeshRenderables;
 	} 
 
@@ -149,6 +145,7 @@ namespace Enjon
 
 			// Add to sorted renderables
 			mSortedSkeletalMeshRenderables.push_back( renderable );
+			AddRenderableProxy( renderable, ( u32 )SpatialProxyType::SkeletalMesh );
 
 			// Sort renderables
 			//SortRenderables( );
@@ -167,6 +164,7 @@ namespace Enjon
 
 			// Remove renderable from sorted list
 			mSortedSkeletalMeshRenderables.erase( std::remove( mSortedSkeletalMeshRenderables.begin( ), mSortedSkeletalMeshRenderables.end( ), renderable ), mSortedSkeletalMeshRenderables.end( ) );
+			RemoveProxy( renderable, &mRenderableTree, &mRenderableProxies, &mDirtyRenderableProxies );
 
 			// Sort renderables
 			//SortRenderables( );
@@ -185,6 +183,7 @@ namespace Enjon
 
 			// Add to sorted renderables
 			mSortedStaticMeshRenderables.push_back( renderable );
+			AddRenderableProxy( renderable, ( u32 )SpatialProxyType::StaticMesh );
 
 			// Sort renderables
 			//SortRenderables( );
@@ -203,6 +202,7 @@ namespace Enjon
 
 			// Remove renderable from sorted list
 			mSortedStaticMeshRenderables.erase( std::remove( mSortedStaticMeshRenderables.begin( ), mSortedStaticMeshRenderables.end( ), renderable ), mSortedStaticMeshRenderables.end( ) );
+			RemoveProxy( renderable, &mRenderableTree, &mRenderableProxies, &mDirtyRenderableProxies );
 
 			// Sort renderables
 			//SortRenderables( );
@@ -233,6 +233,7 @@ namespace Enjon
 
 			// Add to sorted renderables
 			mSortedCustomRenderables.push_back( renderable );
+			AddRenderableProxy( renderable, ( u32 )SpatialProxyType::Custom );
 
 			// Sort renderables
 			//SortRenderables( );
@@ -251,6 +252,7 @@ namespace Enjon
 		
 		// Remove renderable from sorted list
 		mSortedCustomRenderables.erase( std::remove( mSortedCustomRenderables.begin( ), mSortedCustomRenderables.end( ), renderable ), mSortedCustomRenderables.end( ) );
+		RemoveProxy( renderable, &mRenderableTree, &mRenderableProxies, &mDirtyRenderableProxies );
 		
 		// Sort renderables
 		//SortRenderables( );
@@ -321,6 +323,7 @@ namespace Enjon
 		{
 			mPointLights.insert(light);
 			light->SetGraphicsScene(this);
+			AddLightProxy( light, ( u32 )SpatialProxyType::Point );
 		}
 	}
 
@@ -333,6 +336,7 @@ namespace Enjon
 		{
 			mPointLights.erase(light);
 			light->SetGraphicsScene(nullptr);
+			RemoveProxy( light, &mLightTree, &mLightProxies, &mDirtyLightProxies );
 		}
 	}
 
@@ -345,6 +349,7 @@ namespace Enjon
 		{
 			mSpotLights.insert(light);
 			light->SetGraphicsScene(this);
+			AddLightProxy( light, ( u32 )SpatialProxyType::Spot );
 		}
 	}
 
@@ -357,6 +362,7 @@ namespace Enjon
 		{
 			mSpotLights.erase(light);
 			light->SetGraphicsScene(nullptr);
+			RemoveProxy( light, &mLightTree, &mLightProxies, &mDirtyLightProxies );
 		}
 	} 
 
@@ -407,45 +413,401 @@ namespace Enjon
 
 	//==================================================================================================
 
-	bool GraphicsScene::CompareDepth(Renderable* a, Renderable* b)
+	INTERNAL u32 GetCullingChunkCount( u32 count )
+	{
+		return ( count + ENJON_CULLING_CHUNK_SIZE - 1 ) / ENJON_CULLING_CHUNK_SIZE;
+	}
+
+	//==================================================================================================
+
+	INTERNAL void GetRenderableBounds( const Renderable* renderable, u32 type, Vec3* min, Vec3* max )
+	{
+		const Mesh* mesh = renderable->GetMesh( );
+		Vec3 meshMin = mesh ? mesh->GetBoundsMin( ) : Vec3( 0.0f );
+		Vec3 meshMax = mesh ? mesh->GetBoundsMax( ) : Vec3( 0.0f );
+
+		// Meshes without any bounds computed are never culled
+		if ( meshMin == meshMax )
+		{
+			*min = Vec3( -ENJON_CULLING_MAX_EXTENT );
+			*max = Vec3( ENJON_CULLING_MAX_EXTENT );
+			return;
+		}
+
+		// Skinned meshes are bounded by their bind pose, grown to cover animation
+		f32 scale = type == ( u32 )SpatialProxyType::SkeletalMesh ? ENJON_CULLING_SKINNED_BOUNDS_SCALE : 1.0f;
+
+		Vec3 center, extents;
+		// Model matrix is only cached as renderables are bound for drawing, so is built from their current transform
+		Frustum::TransformAABB( renderable->GetTransform( ).ToMat4x4( ), meshMin, meshMax, &center, &extents );
+		*min = center - extents * scale;
+		*max = center + extents * scale;
+	}
+
+	//==================================================================================================
+
+	INTERNAL f32 GetSpotLightRange( SpotLight* light )
+	{
+		// Solve for distance at which falloff takes brightest channel of light below threshold
+		ColorRGBA32 color = light->GetColor( );
+		f32 brightness = light->GetIntensity( ) * std::max( color.r, std::max( color.g, color.b ) );
+		Vec3 falloff = light->GetParams( ).mFalloff;
+
+		f32 a = falloff.z;
+		f32 b = falloff.y;
+		f32 c = falloff.x - brightness / ENJON_CULLING_LIGHT_THRESHOLD;
+
+		if ( c >= 0.0f )
+		{
+			return 0.0f;
+		}
+
+		if ( a > 0.0f )
+		{
+			return std::min( ( -b + sqrtf( b * b - 4.0f * a * c ) ) / ( 2.0f * a ), ENJON_CULLING_MAX_EXTENT );
+		}
+
+		if ( b > 0.0f )
+		{
+			return std::min( -c / b, ENJON_CULLING_MAX_EXTENT );
+		}
+
+		// Light never falls off
+		return ENJON_CULLING_MAX_EXTENT;
+	}
+
+	//==================================================================================================
+
+	INTERNAL void GetLightSphere( void* light, u32 type, Vec3* center, f32* radius )
+	{
+		if ( type == ( u32 )SpatialProxyType::Point )
+		{
+			PointLight* pointLight = static_cast< PointLight* >( light );
+			*center = pointLight->GetPosition( );
+			*radius = std::min( pointLight->GetRadius( ), ENJON_CULLING_MAX_EXTENT );
+		}
+		else
+		{
+			SpotLight* spotLight = static_cast< SpotLight* >( light );
+			*center = spotLight->GetPosition( );
+			*radius = GetSpotLightRange( spotLight );
+		}
+	}
+
+	//==================================================================================================
+
+	INTERNAL void AddVisibleRenderable( GraphicsSceneVisibility* visible, void* userData, u32 type )
+	{
+		// Proxies hold renderables as their base
+		Renderable* renderable = static_cast< Renderable* >( userData );
+		switch ( ( SpatialProxyType )type )
+		{
+			case SpatialProxyType::StaticMesh:		visible->mStaticMeshRenderables.push_back( static_cast< StaticMeshRenderable* >( renderable ) ); break;
+			case SpatialProxyType::SkeletalMesh:	visible->mSkeletalMeshRenderables.push_back( static_cast< SkeletalMeshRenderable* >( renderable ) ); break;
+			default:								visible->mCustomRenderables.push_back( renderable ); break;
+		}
+	}
+
+	//==================================================================================================
+
+	INTERNAL void AddVisibleLight( GraphicsSceneVisibility* visible, void* light, u32 type )
+	{
+		if ( type == ( u32 )SpatialProxyType::Point )
+		{
+			visible->mPointLights.push_back( static_cast< PointLight* >( light ) );
+		}
+		else
+		{
+			visible->mSpotLights.push_back( static_cast< SpotLight* >( light ) );
+		}
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::AddRenderableProxy( Renderable* renderable, u32 type )
 	{
-		// Get camera position
-		GraphicsSubsystem* gfx = EngineSubsystem( GraphicsSubsystem );
-		v3 camPos = gfx->GetGraphicsSceneCamera()->GetPosition();
+		Vec3 min, max;
+		GetRenderableBounds( renderable, type, &min, &max );
+		mRenderableProxies[ renderable ] = mRenderableTree.Insert( min, max, renderable, type );
+	}
+
+	//==================================================================================================
 
-		// Get a pos
-		v3 aPos = a->GetPosition();
-		// Get b pos
-		v3 bPos = b->GetPosition();
+	void GraphicsScene::AddLightProxy( const void* light, u32 type )
+	{
+		Vec3 center;
+		f32 radius;
+		GetLightSphere( const_cast< void* >( light ), type, &center, &radius );
+		mLightProxies[ light ] = mLightTree.Insert( center - Vec3( radius ), center + Vec3( radius ), const_cast< void* >( light ), type );
+	}
 
-		f32 aDist = (camPos - aPos).Length();
-		f32 bDist = (camPos - bPos).Length();
+	//==================================================================================================
 
-		return aDist < bDist;
+	void GraphicsScene::RemoveProxy( const void* object, AABBTree* tree, HashMap< const void*, s32 >* proxies, HashSet< s32 >* dirty )
+	{
+		auto query = proxies->find( object );
+		if ( query != proxies->end( ) )
+		{
+			dirty->erase( query->second );
+			tree->Remove( query->second );
+			proxies->erase( query );
+		}
 	}
 
 	//==================================================================================================
 
-	// TODO(): Come up with better way to compare materials
-	bool GraphicsScene::CompareMaterial(Renderable* a, Renderable* b)
+	void GraphicsScene::UpdateBounds( Renderable* renderable )
 	{
-		// Need a good metric for comparing materials by shader program ids...
-		if ( a && b )
+		auto query = mRenderableProxies.find( renderable );
+		if ( query != mRenderableProxies.end( ) )
 		{
-			u32 pA = a->GetMaterial( 0 )->GetShaderGraph( )->GetShader( Enjon::ShaderPassType::Deferred_StaticGeom )->GetProgramID( );
-			u32 pB = a->GetMaterial( 0 )->GetShaderGraph( )->GetShader( Enjon::ShaderPassType::Deferred_StaticGeom )->GetProgramID( );
-			return pA > pB;
+			mDirtyRenderableProxies.insert( query->second );
 		}
+	}
+
+	//==================================================================================================
 
-		return false;
+	void GraphicsScene::UpdateBounds( PointLight* light )
+	{
+		auto query = mLightProxies.find( light );
+		if ( query != mLightProxies.end( ) )
+		{
+			mDirtyLightProxies.insert( query->second );
+		}
+	}
 
-		// TODO(): Set this up to where materials have a unique id and sort by that
-		//AssetHandle<Texture> texA = a->GetMaterial()->GetTexture(TextureSlotType::Albedo);
-		//AssetHandle<Texture> texB = b->GetMaterial()->GetTexture(TextureSlotType::Albedo);
+	//==================================================================================================
 
-		//return texA.Get()->GetTextureId() > texB.Get()->GetTextureId();
+	void GraphicsScene::UpdateBounds( SpotLight* light )
+	{
+		auto query = mLightProxies.find( light );
+		if ( query != mLightProxies.end( ) )
+		{
+			mDirtyLightProxies.insert( query->second );
+		}
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::UpdateSpatialIndex( )
+	{
+		for ( const s32& proxy : mDirtyRenderableProxies )
+		{
+			Vec3 min, max;
+			GetRenderableBounds( static_cast< Renderable* >( mRenderableTree.GetUserData( proxy ) ), mRenderableTree.GetUserTag( proxy ), &min, &max );
+			mRenderableTree.Move( proxy, min, max );
+		}
+
+		for ( const s32& proxy : mDirtyLightProxies )
+		{
+			Vec3 center;
+			f32 radius;
+			GetLightSphere( mLightTree.GetUserData( proxy ), mLightTree.GetUserTag( proxy ), &center, &radius );
+			mLightTree.Move( proxy, center - Vec3( radius ), center + Vec3( radius ) );
+		}
+
+		mDirtyRenderableProxies.clear( );
+		mDirtyLightProxies.clear( );
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::Cull( const Camera* camera, GraphicsSceneVisibility* visible )
+	{
+		visible->mStaticMeshRenderables.clear( );
+		visible->mSkeletalMeshRenderables.clear( );
+		visible->mCustomRenderables.clear( );
+		visible->mPointLights.clear( );
+		visible->mSpotLights.clear( );
+
+		UpdateSpatialIndex( );
+
+		Frustum frustum = Frustum::FromViewProjection( camera->GetViewProjection( ) );
+
+		// Renderables wholly inside frustum are visible, those straddling it are tested again by their exact bounds
+		mCullingCandidates.clear( );
+		mRenderableTree.QueryFrustum( frustum, [ & ] ( s32 proxy, b32 inside )
+		{
+			if ( inside )
+			{
+				AddVisibleRenderable( visible, mRenderableTree.GetUserData( proxy ), mRenderableTree.GetUserTag( proxy ) );
+			}
+			else
+			{
+				mCullingCandidates.push_back( proxy );
+			}
+		} );
+
+		u32 candidateCount = ( u32 )mCullingCandidates.size( );
+		mCullingBounds.Resize( candidateCount );
+		mCullingResults.resize( candidateCount );
+
+		JobSystem::ParallelForOrSerial( GetCullingChunkCount( candidateCount ), [ & ] ( u32 chunk )
+		{
+			u32 first = chunk * ENJON_CULLING_CHUNK_SIZE;
+			u32 end = std::min( first + ENJON_CULLING_CHUNK_SIZE, candidateCount );
+
+			for ( u32 i = first; i < end; ++i )
+			{
+				s32 proxy = mCullingCandidates[ i ];
+				Vec3 min, max;
+				GetRenderableBounds( static_cast< Renderable* >( mRenderableTree.GetUserData( proxy ) ), mRenderableTree.GetUserTag( proxy ), &min, &max );
+				mCullingBounds.SetAABB( i, ( min + max ) * 0.5f, ( max - min ) * 0.5f );
+			}
+
+			frustum.CullAABBs( mCullingBounds, first, end - first, mCullingResults.data( ) );
+		} );
+
+		for ( u32 i = 0; i < candidateCount; ++i )
+		{
+			if ( mCullingResults[ i ] )
+			{
+				s32 proxy = mCullingCandidates[ i ];
+				AddVisibleRenderable( visible, mRenderableTree.GetUserData( proxy ), mRenderableTree.GetUserTag( proxy ) );
+			}
+		}
+
+		// Lights are culled by spheres of their influence in the same way
+		mCullingCandidates.clear( );
+		mLightTree.QueryFrustum( frustum, [ & ] ( s32 proxy, b32 inside )
+		{
+			if ( inside )
+			{
+				AddVisibleLight( visible, mLightTree.GetUserData( proxy ), mLightTree.GetUserTag( proxy ) );
+			}
+			else
+			{
+				mCullingCandidates.push_back( proxy );
+			}
+		} );
+
+		u32 lightCandidateCount = ( u32 )mCullingCandidates.size( );
+		mCullingBounds.Resize( lightCandidateCount );
+		mCullingResults.resize( lightCandidateCount );
+
+		for ( u32 i = 0; i < lightCandidateCount; ++i )
+		{
+			s32 proxy = mCullingCandidates[ i ];
+			Vec3 center;
+			f32 radius;
+			GetLightSphere( mLightTree.GetUserData( proxy ), mLightTree.GetUserTag( proxy ), &center, &radius );
+			mCullingBounds.SetSphere( i, center, radius );
+		}
+
+		frustum.CullSpheres( mCullingBounds, 0, lightCandidateCount, mCullingResults.data( ) );
+
+		for ( u32 i = 0; i < lightCandidateCount; ++i )
+		{
+			if ( mCullingResults[ i ] )
+			{
+				s32 proxy = mCullingCandidates[ i ];
+				AddVisibleLight( visible, mLightTree.GetUserData( proxy ), mLightTree.GetUserTag( proxy ) );
+			}
+		}
+
+		visible->mTestedCount = candidateCount + lightCandidateCount;
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::QueryRenderables( const Vec3& min, const Vec3& max, Vector< Renderable* >* results )
+	{
+		UpdateSpatialIndex( );
+
+		results->clear( );
+		mRenderableTree.QueryAABB( min, max, [ & ] ( s32 proxy )
+		{
+			Renderable* renderable = static_cast< Renderable* >( mRenderableTree.GetUserData( proxy ) );
+
+			Vec3 bMin, bMax;
+			GetRenderableBounds( renderable, mRenderableTree.GetUserTag( proxy ), &bMin, &bMax );
+			if ( bMin.x <= max.x && bMin.y <= max.y && bMin.z <= max.z && min.x <= bMax.x && min.y <= bMax.y && min.z <= bMax.z )
+			{
+				results->push_back( renderable );
+			}
+		} );
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::QueryRenderables( const Vec3& center, f32 radius, Vector< Renderable* >* results )
+	{
+		UpdateSpatialIndex( );
+
+		results->clear( );
+		mRenderableTree.QuerySphere( center, radius, [ & ] ( s32 proxy )
+		{
+			Renderable* renderable = static_cast< Renderable* >( mRenderableTree.GetUserData( proxy ) );
+
+			// Distance from center to closest point of exact bounds
+			Vec3 bMin, bMax;
+			GetRenderableBounds( renderable, mRenderableTree.GetUserTag( proxy ), &bMin, &bMax );
+			Vec3 closest( std::min( std::max( center.x, bMin.x ), bMax.x ), std::min( std::max( center.y, bMin.y ), bMax.y ), std::min( std::max( center.z, bMin.z ), bMax.z ) );
+			Vec3 d = closest - center;
+			if ( d.x * d.x + d.y * d.y + d.z * d.z <= radius * radius )
+			{
+				results->push_back( renderable );
+			}
+		} );
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::QueryLights( const Vec3& center, f32 radius, Vector< PointLight* >* pointLights, Vector< SpotLight* >* spotLights )
+	{
+		UpdateSpatialIndex( );
+
+		pointLights->clear( );
+		spotLights->clear( );
+		mLightTree.QuerySphere( center, radius, [ & ] ( s32 proxy )
+		{
+			void* light = mLightTree.GetUserData( proxy );
+			u32 type = mLightTree.GetUserTag( proxy );
+
+			Vec3 lightCenter;
+			f32 lightRadius;
+			GetLightSphere( light, type, &lightCenter, &lightRadius );
+
+			Vec3 d = lightCenter - center;
+			if ( d.x * d.x + d.y * d.y + d.z * d.z > ( radius + lightRadius ) * ( radius + lightRadius ) )
+			{
+				return;
+			}
+
+			if ( type == ( u32 )SpatialProxyType::Point )
+			{
+				pointLights->push_back( static_cast< PointLight* >( light ) );
+			}
+			else
+			{
+				spotLights->push_back( static_cast< SpotLight* >( light ) );
+			}
+		} );
+	}
+
+	//==================================================================================================
+
+	void GraphicsScene::Raycast( const Ray& ray, Vector< Renderable* >* results, f32 maxDistance )
+	{
+		UpdateSpatialIndex( );
+
+		Vector< std::pair< f32, Renderable* > > hits;
+		mRenderableTree.RayCast( ray, maxDistance, [ & ] ( s32 proxy, f32 distance )
+		{
+			hits.push_back( std::make_pair( distance, static_cast< Renderable* >( mRenderableTree.GetUserData( proxy ) ) ) );
+		} );
+
+		std::sort( hits.begin( ), hits.end( ), [ ] ( const std::pair< f32, Renderable* >& a, const std::pair< f32, Renderable* >& b )
+		{
+			return a.first < b.first;
+		} );
+
+		results->clear( );
+		for ( auto& h : hits )
+		{
+			results->push_back( h.second );
+		}
 	}
 
 	//================================================================================================== 
 }
-
@@ -22,6 +22,7 @@
 #include "CVarsSystem.h"
 #include "ImGui/ImGuiManager.h"
 #include "Graphics/Texture.h"
+#include "Graphics/GPUMemoryTracker.h"
 #include "Graphics/Skeleton.h"
 #include "Graphics/ShaderGraph.h"
 #include "Graphics/SkeletalMesh.h"
@@ -33,6 +34,7 @@
 #include "Graphics/StaticMeshRenderable.h"
 #include "Graphics/SkeletalMeshRenderable.h"
 #include "Base/World.h"
+#include "System/JobSystem.h"
 
 #include <string>
 #include <cassert>
@@ -134,6 +136,20 @@ namespace Enjon
 
 	//======================================================================================================
 
+	const GraphicsSceneVisibility& GraphicsSubsystemContext::GetVisibility( ) const
+	{
+		return mVisibility;
+	}
+
+	//======================================================================================================
+
+	const RenderQueue& GraphicsSubsystemContext::GetRenderQueue( ) const
+	{
+		return mRenderQueue;
+	}
+
+	//======================================================================================================
+
 	void GraphicsSubsystemContext::AddCustomPass( RenderPass* pass )
 	{
 		mCustomPasses.push_back( pass );
@@ -180,6 +196,13 @@ namespace Enjon
 
 	//======================================================================================================
 
+	TextureStreamer* GraphicsSubsystem::GetTextureStreamer( )
+	{
+		return &mTextureStreamer;
+	}
+
+	//======================================================================================================
+
 	Enjon::Result GraphicsSubsystem::Initialize()
 	{ 
 		// Clear previous windows ( if any )
@@ -311,6 +334,9 @@ namespace Enjon
 
 	Enjon::Result GraphicsSubsystem::Shutdown()
 	{ 
+		// Release streamed textures while GL objects are still around
+		mTextureStreamer.Shutdown( );
+
 		// Delete auxillary items
 		delete( mBatch );
 		delete( mFullScreenQuad );
@@ -363,6 +389,16 @@ namespace Enjon
 		//am->AddToDatabase( hdrFilePath ); 
 		Enjon::String qualifiedName = AssetLoader::GetQualifiedName( hdrFilePath ); 
 		Enjon::AssetHandle< Enjon::Texture > hdrEnv = am->GetAsset< Enjon::Texture >( qualifiedName );
+
+		// Lighting precomputed when the environment was cooked. Older caches without it are still convolved here.
+		const ImageBasedLightingMaps* ibl = hdrEnv.Get( ) ? hdrEnv.Get( )->GetImageBasedLighting( ) : nullptr;
+		if ( ibl )
+		{
+			mIrradianceMap = ibl->mIrradianceMap;
+			mPrefilteredMap = ibl->mPrefilteredMap;
+			mBRDFLUT = ibl->mBRDFLUT;
+		}
+		else
 		{ 
 			// Generate cubemap FBO, RBO
 			glGenFramebuffers( 1, &mCaptureFBO );
@@ -420,6 +456,7 @@ namespace Enjon
 
 			glBindTexture( GL_TEXTURE_CUBE_MAP, mEnvCubemapID );
 			glGenerateMipmap( GL_TEXTURE_CUBE_MAP );
+			GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mEnvCubemapID, GPUMemoryTracker::GetTextureSize( GL_RGB16F, envMapSize, envMapSize, GPUMemoryTracker::GetFullMipCount( envMapSize, envMapSize ), 6 ), "Image Based Lighting", "Environment Cubemap" );
 
 			// pbr: create an irradiance cubemap, and re-scale capture FBO to irradiance scale.
 			// --------------------------------------------------------------------------------
@@ -434,6 +471,7 @@ namespace Enjon
 			glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
 			glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 			glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+			GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mIrradianceMap, GPUMemoryTracker::GetTextureSize( GL_RGB16F, 32, 32, 1, 6 ), "Image Based Lighting", "Irradiance Map" );
 
 			glBindFramebuffer( GL_FRAMEBUFFER, mCaptureFBO );
 			glBindRenderbuffer( GL_RENDERBUFFER, mCaptureRBO );
@@ -484,6 +522,7 @@ namespace Enjon
 			glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
 
 			glGenerateMipmap( GL_TEXTURE_CUBE_MAP );
+			GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mPrefilteredMap, GPUMemoryTracker::GetTextureSize( GL_RGB16F, textureSize, textureSize, GPUMemoryTracker::GetFullMipCount( textureSize, textureSize ), 6 ), "Image Based Lighting", "Prefiltered Map" );
 
 			// -----------------------------------------------------------------------------
 			GLSLProgram* prefilterShader = ShaderManager::Get( "PrefilterConvolution" );
@@ -532,6 +571,7 @@ namespace Enjon
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+			GPUMemoryTracker::Track( GPUResourceType::RenderTarget, mBRDFLUT, GPUMemoryTracker::GetImageSize( GL_RGBA32F, 512, 512 ), "Image Based Lighting", "BRDF LUT" );
 
 			// then re-configure capture framebuffer object and render screen-space quad with BRDF shader.
 			glBindFramebuffer( GL_FRAMEBUFFER, mCaptureFBO );
@@ -698,6 +738,10 @@ namespace Enjon
 				// This needs to be much more flexible than it currently is...
 				if ( gfxCtx->GetEnableRenderWorld() )
 				{
+					// Culling pass
+					CullPass( gfxCtx );
+					// Queue visible draws
+					BuildRenderQueue( gfxCtx );
 					// Gbuffer pass
 					GBufferPass( gfxCtx );
 					// SSAO pass
@@ -748,6 +792,9 @@ namespace Enjon
 		// TODO(): This will be handled elsewhere
 		mCurrentWindow = mWindow;
 		mCurrentWindow->MakeCurrent( ); 
+
+		// Every view has made its mip requests for this frame
+		mTextureStreamer.Update( );
 	}
 
 	//======================================================================================================
@@ -884,6 +931,212 @@ namespace Enjon
 
 	//======================================================================================================
 	
+	void GraphicsSubsystem::CullPass( GraphicsSubsystemContext* ctx )
+	{
+		GraphicsScene* scene = ctx->GetGraphicsScene( );
+		Camera* camera = scene->GetActiveCamera( );
+		scene->Cull( camera, &ctx->mVisibility );
+	}
+
+	//======================================================================================================
+
+	void GraphicsSubsystem::BuildRenderQueue( GraphicsSubsystemContext* ctx )
+	{
+		GraphicsScene* scene = ctx->GetGraphicsScene( );
+		Camera* camera = scene->GetActiveCamera( );
+		const GraphicsSceneVisibility& visibility = ctx->GetVisibility( );
+		RenderQueue* queue = &ctx->mRenderQueue;
+
+		queue->Clear( );
+
+		Vec3 cameraPosition = camera->GetPosition( );
+		f32 farPlane = camera->GetFar( );
+		f32 screenHeight = ( f32 )mGbuffer->GetResolution( ).y;
+
+		auto queueRenderable = [ & ] ( Renderable* renderable, RenderQueuePass pass, ShaderPassType shaderPass, b32 selectLOD )
+		{
+			// Model matrix and level of detail are fixed for the frame before any of renderable's draws
+			renderable->Bind( );
+			if ( selectLOD )
+			{
+				renderable->SelectLOD( camera, screenHeight );
+			}
+
+			const Mesh* mesh = renderable->GetMesh( );
+			f32 depth = ( renderable->GetPosition( ) - cameraPosition ).Length( ) / farPlane;
+
+			const Vector< SubMesh* >& subMeshes = mesh->GetSubmeshes( );
+			for ( u32 i = 0; i < subMeshes.size( ); ++i )
+			{
+				const Material* material = renderable->GetMaterial( i ).Get( );
+				assert( material != nullptr );
+
+				if ( selectLOD )
+				{
+					mTextureStreamer.RequestMaterial( material, mesh->GetUVDensity( ), renderable->GetPixelsPerUnit( ) );
+				}
+
+				AssetHandle< ShaderGraph > sg = material->GetShaderGraph( );
+				const Shader* shader = sg ? sg->GetShader( shaderPass ) : nullptr;
+				if ( !shader )
+				{
+					continue;
+				}
+
+				RenderQueueItem item;
+				item.mRenderable = renderable;
+				item.mSubMesh = subMeshes.at( i );
+				item.mMaterial = material;
+				item.mShader = shader;
+				item.mSubMeshIndex = i;
+				queue->Push( RenderQueue::MakeKey( pass, shader->GetProgramID( ), material->GetMaterialID( ), item.mSubMesh->GetVAO( ), depth ), item );
+			}
+		};
+
+		for ( auto& renderable : visibility.mStaticMeshRenderables )
+		{
+			queueRenderable( renderable, RenderQueuePass::Opaque, ShaderPassType::Deferred_StaticGeom, true );
+		}
+
+		for ( auto& renderable : visibility.mSkeletalMeshRenderables )
+		{
+			queueRenderable( renderable, RenderQueuePass::OpaqueSkinned, ShaderPassType::Deferred_Skinned_Geom, true );
+		}
+
+		for ( auto& renderable : visibility.mCustomRenderables )
+		{
+			queueRenderable( renderable, RenderQueuePass::Opaque, ShaderPassType::Deferred_StaticGeom, false );
+		}
+
+		// Renderables drawn over everything are drawn whole with their first material, nearest first
+		for ( auto& renderable : scene->GetNonDepthTestedStaticMeshRenderables( ) )
+		{
+			const Material* material = renderable->GetMaterial( 0 ).Get( );
+			assert( material != nullptr );
+
+			AssetHandle< ShaderGraph > sg = material->GetShaderGraph( );
+			if ( !sg )
+			{
+				continue;
+			}
+
+			RenderQueueItem item;
+			item.mRenderable = renderable;
+			item.mMaterial = material;
+			item.mShader = sg->GetShader( ShaderPassType::Deferred_StaticGeom );
+			queue->Push( RenderQueue::MakeDepthKey( RenderQueuePass::Overlay, ( renderable->GetPosition( ) - cameraPosition ).Length( ) / farPlane ), item );
+		}
+
+		queue->Sort( );
+	}
+
+	//======================================================================================================
+
+	u32 GraphicsSubsystem::RecordGBufferCommands( GraphicsSubsystemContext* ctx, f32 worldTime )
+	{
+		const RenderQueue& queue = ctx->GetRenderQueue( );
+		Camera* camera = ctx->GetGraphicsScene( )->GetActiveCamera( );
+
+		Mat4x4 viewProjection = camera->GetViewProjection( );
+		Mat4x4 previousViewProjection = ctx->mPreviousViewProjectionMatrix;
+		Vec3 viewPosition = camera->GetPosition( );
+
+		u32 opaqueBegin, opaqueEnd, skinnedBegin, skinnedEnd;
+		queue.GetPassRange( RenderQueuePass::Opaque, &opaqueBegin, &opaqueEnd );
+		queue.GetPassRange( RenderQueuePass::OpaqueSkinned, &skinnedBegin, &skinnedEnd );
+
+		u32 opaqueChunks = ( opaqueEnd - opaqueBegin + ENJON_RENDER_COMMAND_CHUNK_SIZE - 1 ) / ENJON_RENDER_COMMAND_CHUNK_SIZE;
+		u32 skinnedChunks = ( skinnedEnd - skinnedBegin + ENJON_RENDER_COMMAND_CHUNK_SIZE - 1 ) / ENJON_RENDER_COMMAND_CHUNK_SIZE;
+		u32 chunkCount = opaqueChunks + skinnedChunks;
+
+		if ( mCommandBuffers.size( ) < chunkCount )
+		{
+			mCommandBuffers.resize( chunkCount );
+		}
+
+		// Recording only reads state renderables cached when queued, so chunks can be recorded on any thread
+		JobSystem::ParallelForOrSerial( chunkCount, [ & ] ( u32 chunk )
+		{
+			b32 skinnedPass = chunk >= opaqueChunks;
+			u32 passBegin = skinnedPass ? skinnedBegin : opaqueBegin;
+			u32 passEnd = skinnedPass ? skinnedEnd : opaqueEnd;
+			u32 first = passBegin + ( skinnedPass ? chunk - opaqueChunks : chunk ) * ENJON_RENDER_COMMAND_CHUNK_SIZE;
+			u32 end = std::min( first + ENJON_RENDER_COMMAND_CHUNK_SIZE, passEnd );
+
+			RenderCommandBuffer& buffer = mCommandBuffers[ chunk ];
+			buffer.Clear( );
+
+			// Each chunk binds its own state, since it can't know what chunks before it left bound
+			const Shader* shader = nullptr;
+			const Material* material = nullptr;
+			const Renderable* skinned = nullptr;
+
+			for ( u32 d = first; d < end; ++d )
+			{
+				const RenderQueueItem& item = queue.GetItem( d );
+				const Renderable* renderable = item.mRenderable;
+
+				if ( shader != item.mShader )
+				{
+					shader = item.mShader;
+					material = nullptr;
+					skinned = nullptr;
+
+					buffer.BindProgram( shader );
+					buffer.SetUniform( RenderUniform::ViewProjection, viewProjection );
+					buffer.SetUniform( RenderUniform::WorldTime, worldTime );
+					buffer.SetUniform( RenderUniform::ViewPosition, viewPosition );
+					buffer.SetUniform( RenderUniform::PreviousViewProjection, previousViewProjection );
+				}
+
+				if ( material != item.mMaterial )
+				{
+					material = item.mMaterial;
+					buffer.BindMaterial( material );
+				}
+
+				ColorRGBA32 id = Renderable::IdToColor( renderable->GetRenderableID( ), item.mSubMeshIndex );
+				buffer.SetUniform( RenderUniform::ObjectID, Vec4( id.r, id.g, id.b, id.a ) );
+
+				if ( skinnedPass )
+				{
+					// Joints and transforms only need setting once for consecutive draws of the same renderable
+					if ( skinned != renderable )
+					{
+						skinned = renderable;
+
+						const Vector< Mat4x4 >& transforms = static_cast< const SkeletalMeshRenderable* >( renderable )->GetJointTransforms( );
+						if ( !transforms.empty( ) )
+						{
+							buffer.SetUniform( RenderUniform::JointTransforms, transforms.data( ), ( u32 )transforms.size( ) );
+						}
+
+						buffer.SetUniform( RenderUniform::Model, renderable->GetModelMatrix( ) );
+						buffer.SetUniform( RenderUniform::PreviousModel, renderable->GetPreviousModelMatrix( ) );
+						buffer.BindMesh( renderable->GetMesh( ) );
+					}
+				}
+				else
+				{
+					buffer.SetUniform( RenderUniform::Model, renderable->GetModelMatrix( ) );
+					buffer.SetUniform( RenderUniform::PreviousModel, renderable->GetPreviousModelMatrix( ) );
+
+					// Set vertex decode for owning mesh
+					if ( item.mSubMesh->mMesh )
+					{
+						buffer.BindMesh( item.mSubMesh->mMesh );
+					}
+				}
+
+				buffer.DrawSubMesh( item.mSubMesh, renderable->GetLOD( ) );
+			}
+		} );
+
+		return chunkCount;
+	}
+
+	//======================================================================================================
+
 	void GraphicsSubsystem::GBufferPass( GraphicsSubsystemContext* ctx )
 	{
 		static float wt = 0.0f;
@@ -916,10 +1169,6 @@ namespace Enjon
 		// Grab graphics scene from context
 		GraphicsScene* scene = ctx->GetGraphicsScene( );
 
-		// Get sorted renderables by material
-		const Vector< StaticMeshRenderable* >& sortedStaticMeshRenderables = scene->GetStaticMeshRenderables();
-		const Vector< SkeletalMeshRenderable* >& sortedSkeletalMeshRenderables = scene->GetSkeletalMeshRenderables( );
-		const Vector< Renderable* >& sortedCustomRenderables = scene->GetCustomRenderables();
 		const HashSet< QuadBatch* >& sortedQuadBatches = scene->GetQuadBatches(); 
 
 		Camera* camera = scene->GetActiveCamera( );
@@ -927,157 +1176,29 @@ namespace Enjon
 		Mat4x4 projMtx = camera->GetProjection( );
 		Mat4x4 viewProjMtx = camera->GetViewProjection( );
 
-		if (!sortedStaticMeshRenderables.empty())
-		{ 
-			// Shader graph to be used
-			Enjon::AssetHandle< Enjon::ShaderGraph > sg; 
-			const Material* material = nullptr;
-
-			for (auto& renderable : sortedStaticMeshRenderables)
-			{ 
-				renderable->Bind( );
-				{
-					// For each submesh
-					const Vector< SubMesh* >& subMeshes = renderable->GetMesh( )->GetSubmeshes( );
-					for ( u32 i = 0; i < subMeshes.size(); ++i )
-					{
-						const Material* curMaterial = renderable->GetMaterial( i ).Get( );
-						sg = curMaterial->GetShaderGraph( );
-						assert( curMaterial != nullptr );
-
-						if ( sg )
-						{
-							Enjon::Shader* sgShader = const_cast< Shader * >( sg->GetShader( ShaderPassType::Deferred_StaticGeom ) );
-							if ( material != curMaterial )
-							{
-								// Set material
-								material = curMaterial;
-
-								// Bind uniforms
-								sgShader->Use( );
-								sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
-								sgShader->SetUniform( "uWorldTime", wt );
-								sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
-								sgShader->SetUniform( "uPreviousViewProjection", ctx->mPreviousViewProjectionMatrix );
-								material->Bind( sgShader );
-							}
-
-							//sgShader->SetUniform( "uObjectID", Renderable::IdToColor( renderable->GetRenderableID( ) ) ); 
-							renderable->Submit( sg->GetShader( ShaderPassType::Deferred_StaticGeom ), subMeshes.at( i ), i ); 
-						}
-					} 
-				}
-				renderable->Unbind( );
-			}
+		// Draws are recorded on worker threads, then replayed here in order
+		u32 bufferCount = RecordGBufferCommands( ctx, wt );
+		mCommandExecutor.Invalidate( );
+		for ( u32 i = 0; i < bufferCount; ++i )
+		{
+			mCommandExecutor.Execute( mCommandBuffers[ i ] );
 		}
 
-		// Shader graph to be used
-		if (!sortedSkeletalMeshRenderables.empty())
-		{ 
-			AssetHandle< ShaderGraph > sg;
-			const Material* material = nullptr;
-
-			for (auto& renderable : sortedSkeletalMeshRenderables)
-			{ 
-				renderable->Bind( );
-				{
-					auto transforms = renderable->GetJointTransforms(); 
-
-					// For each submesh
-					const Vector< SubMesh* >& subMeshes = renderable->GetMesh( )->GetSubmeshes( );
-					for ( u32 i = 0; i < subMeshes.size(); ++i )
-					{
-						const Material* curMaterial = renderable->GetMaterial( i ).Get( );
-						sg = curMaterial->GetShaderGraph( );
-						assert( curMaterial != nullptr ); 
-						if ( sg )
-						{
-							Enjon::Shader* sgShader = const_cast< Shader * >( sg->GetShader( ShaderPassType::Deferred_Skinned_Geom ) );
-							if ( material != curMaterial )
-							{
-								// Set material
-								material = curMaterial;
-
-								// Bind uniforms
-								sgShader->Use( );
-								sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
-								sgShader->SetUniform( "uWorldTime", wt );
-								sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
-								sgShader->SetUniform( "uPreviousViewProjection", ctx->mPreviousViewProjectionMatrix );
-								material->Bind( sgShader );
-							}
-
-							sgShader->SetUniform( "uObjectID", Renderable::IdToColor( renderable->GetRenderableID( ), i ) ); 
-
-							// Set transform uniforms in shader
-							for ( u32 i = 0; i < transforms.size(); ++i )
-							{
-								sgShader->SetUniformArrayElement( "uJointTransforms", i, transforms.at( i ) );
-							}
-
-							sgShader->SetUniform( "uModel", renderable->GetModelMatrix( ) );
-							sgShader->SetUniform( "uPreviousModel", renderable->GetPreviousModelMatrix( ) );
-
-							//renderable->Submit( sg->GetShader( ShaderPassType::Deferred_StaticGeom ), subMeshes.at( i ) );
-
-							// Bind submesh
-							subMeshes.at( i )->Bind( );
-							{
-								// Submit for rendering
-								subMeshes.at( i )->Submit( ); 
-							}
-							// Unbind submesh
-							subMeshes.at( i )->Unbind( ); 
-						}
-					} 
-				}
-				renderable->Unbind( );
-			}
+		// Renderables were bound as they were queued, and previous model matrices can now be advanced
+		const GraphicsSceneVisibility& visibility = ctx->GetVisibility( );
+		for ( auto& renderable : visibility.mStaticMeshRenderables )
+		{
+			renderable->Unbind( );
 		}
 
-		// Custom renderables
-		if ( !sortedCustomRenderables.empty() )
-		{ 
-			// Shader graph to be used
-			Enjon::AssetHandle< Enjon::ShaderGraph > sg; 
-			const Material* material = nullptr;
-
-			for (auto& renderable : sortedCustomRenderables)
-			{ 
-				renderable->Bind( );
-				{
-					// For each submesh
-					const Vector< SubMesh* >& subMeshes = renderable->GetMesh( )->GetSubmeshes( );
-					for ( u32 i = 0; i < subMeshes.size(); ++i )
-					{
-						const Material* curMaterial = renderable->GetMaterial( i ).Get( );
-						sg = curMaterial->GetShaderGraph( );
-						assert( curMaterial != nullptr );
+		for ( auto& renderable : visibility.mSkeletalMeshRenderables )
+		{
+			renderable->Unbind( );
+		}
 
-						if ( sg )
-						{
-							Enjon::Shader* sgShader = const_cast< Shader * >( sg->GetShader( ShaderPassType::Deferred_StaticGeom ) );
-							if ( material != curMaterial )
-							{
-								// Set material
-								material = curMaterial;
-
-								// Bind uniforms
-								sgShader->Use( );
-								sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
-								sgShader->SetUniform( "uWorldTime", wt );
-								sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
-								sgShader->SetUniform( "uPreviousViewProjection", ctx->mPreviousViewProjectionMatrix );
-								material->Bind( sgShader );
-							}
-
-							//sgShader->SetUniform( "uObjectID", Renderable::IdToColor( renderable->GetRenderableID( ) ) ); 
-							renderable->Submit( sg->GetShader( ShaderPassType::Deferred_StaticGeom ), subMeshes.at( i ), i ); 
-						}
-					} 
-				}
-				renderable->Unbind( );
-			}
+		for ( auto& renderable : visibility.mCustomRenderables )
+		{
+			renderable->Unbind( );
 		}
 
 		// Quadbatches
@@ -1292,8 +1413,8 @@ namespace Enjon
 		//const HashSet<PointLight*>& pointLights 				= mGraphicsScene.GetPointLights();
 
 		const HashSet<DirectionalLight*>& directionalLights 	= scene->GetDirectionalLights();	
-		const HashSet<SpotLight*>& spotLights 					= scene->GetSpotLights();	
-		const HashSet<PointLight*>& pointLights 				= scene->GetPointLights();
+		const Vector<SpotLight*>& spotLights 					= ctx->GetVisibility( ).mSpotLights;	
+		const Vector<PointLight*>& pointLights 					= ctx->GetVisibility( ).mPointLights;
 
 		AmbientSettings* aS = scene->GetAmbientSettings( );
 		//AmbientSettings* aS = mGraphicsScene.GetAmbientSettings();
@@ -1645,9 +1766,12 @@ namespace Enjon
 	{
 		GraphicsScene* scene = ctx->GetGraphicsScene( );
 		Camera* camera = scene->GetActiveCamera( );
-		Vector<StaticMeshRenderable*> nonDepthTestedRenderables = scene->GetNonDepthTestedStaticMeshRenderables( );
+		const RenderQueue& queue = ctx->GetRenderQueue( );
 		GLSLProgram* motionBlurProgram = ShaderManager::Get( "MotionBlur" ); 
 
+		u32 overlayBegin, overlayEnd;
+		queue.GetPassRange( RenderQueuePass::Overlay, &overlayBegin, &overlayEnd );
+
 		// I don't need all of these frame buffers. I just need rendertargets. I'm wasting A LOT of memory. 
 		// Need to be smarter about this.
 
@@ -1674,38 +1798,30 @@ namespace Enjon
 		glClear( GL_DEPTH_BUFFER_BIT );
 
 		// None depth tested renderables
-		if ( !nonDepthTestedRenderables.empty( ) )
 		{
 			const Material* material = nullptr;
-			for ( auto& renderable : nonDepthTestedRenderables )
+			for ( u32 d = overlayBegin; d < overlayEnd; ++d )
 			{
-				// Check for material switch 
-				const Material* curMaterial = renderable->GetMaterial( 0  ).Get( );
-				AssetHandle< ShaderGraph > sg = curMaterial->GetShaderGraph( );
-				assert( curMaterial != nullptr );
+				const RenderQueueItem& item = queue.GetItem( d );
+				Enjon::Shader* sgShader = const_cast<Enjon::Shader*>( item.mShader );
 
-				// Grab shader from graph
-				if ( sg )
+				// Check for material switch 
+				if ( material != item.mMaterial )
 				{
-					Enjon::Shader* sgShader = const_cast<Enjon::Shader*>( sg->GetShader( ShaderPassType::Deferred_StaticGeom ) );
-
-					if ( material != curMaterial )
-					{
-						// Set material
-						material = curMaterial;
-
-						sgShader->Use( );
-						sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
-						sgShader->SetUniform( "uWorldTime", Engine::GetInstance( )->GetWorldTime( ).mTotalTime );
-						sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
-						sgShader->SetUniform( "uPreviousViewProjection", camera->GetViewProjection( ) );
-						material->Bind( sgShader );
-					}
-
-					// Render object
-					sgShader->SetUniform( "uObjectID", Renderable::IdToColor( renderable->GetRenderableID( ), 0 ) );
-					renderable->Submit( sg->GetShader( ShaderPassType::Deferred_StaticGeom ) );
+					// Set material
+					material = item.mMaterial;
+
+					sgShader->Use( );
+					sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
+					sgShader->SetUniform( "uWorldTime", Engine::GetInstance( )->GetWorldTime( ).mTotalTime );
+					sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
+					sgShader->SetUniform( "uPreviousViewProjection", camera->GetViewProjection( ) );
+					material->Bind( sgShader );
 				}
+
+				// Render object
+				sgShader->SetUniform( "uObjectID", Renderable::IdToColor( item.mRenderable->GetRenderableID( ), 0 ) );
+				item.mRenderable->Submit( item.mShader );
 			}
 		}
 
@@ -1732,39 +1848,29 @@ namespace Enjon
 			glClear( GL_DEPTH_BUFFER_BIT );
 
 			// None depth tested renderables
-			if ( !nonDepthTestedRenderables.empty( ) )
+			const Material* material = nullptr;
+			for ( u32 d = overlayBegin; d < overlayEnd; ++d )
 			{
-				const Material* material = nullptr;
-				for ( auto& renderable : nonDepthTestedRenderables )
-				{
-					// Check for material switch 
-					const Material* curMaterial = renderable->GetMaterial( 0 ).Get( );
-					AssetHandle< ShaderGraph > sg = curMaterial->GetShaderGraph( );
-					assert( curMaterial != nullptr );
+				const RenderQueueItem& item = queue.GetItem( d );
+				Enjon::Shader* sgShader = const_cast<Enjon::Shader*>( item.mShader );
 
-					if ( sg )
-					{
-						// Grab shader from graph
-						Enjon::Shader* sgShader = const_cast<Enjon::Shader*>( sg->GetShader( ShaderPassType::Deferred_StaticGeom ) );
-
-						if ( material != curMaterial )
-						{
-							// Set material
-							material = curMaterial;
-
-							sgShader->Use( );
-							sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
-							sgShader->SetUniform( "uWorldTime", Engine::GetInstance( )->GetWorldTime( ).mTotalTime );
-							sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
-							sgShader->SetUniform( "uPreviousViewProjection", camera->GetViewProjection( ) );
-							material->Bind( sgShader );
-						}
-
-						// Render object
-						sgShader->SetUniform( "uObjectID", Renderable::IdToColor( renderable->GetRenderableID( ), 0 ) );
-						renderable->Submit( sg->GetShader( ShaderPassType::Deferred_StaticGeom ) );
-					}
+				// Check for material switch 
+				if ( material != item.mMaterial )
+				{
+					// Set material
+					material = item.mMaterial;
+
+					sgShader->Use( );
+					sgShader->SetUniform( "uViewProjection", camera->GetViewProjection( ) );
+					sgShader->SetUniform( "uWorldTime", Engine::GetInstance( )->GetWorldTime( ).mTotalTime );
+					sgShader->SetUniform( "uViewPositionWorldSpace", camera->GetPosition( ) );
+					sgShader->SetUniform( "uPreviousViewProjection", camera->GetViewProjection( ) );
+					material->Bind( sgShader );
 				}
+
+				// Render object
+				sgShader->SetUniform( "uObjectID", Renderable::IdToColor( item.mRenderable->GetRenderableID( ), 0 ) );
+				item.mRenderable->Submit( item.mShader );
 			}
 		}
 		mGbuffer->Unbind( );
@@ -1968,6 +2074,7 @@ namespace Enjon
 		glGenTextures( 1, &mSSAONoiseTexture );
 		glBindTexture( GL_TEXTURE_2D, mSSAONoiseTexture );
 		glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB32F, 256, 256, 0, GL_RGB, GL_FLOAT, &ssaoNoise[ 0 ] );
+		GPUMemoryTracker::Track( GPUResourceType::Texture, mSSAONoiseTexture, GPUMemoryTracker::GetImageSize( GL_RGB32F, 256, 256 ), "SSAO", "Noise" );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
 		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
@@ -2401,6 +2508,88 @@ namespace Enjon
 
 	//======================================================================================================= 
 
+	INTERNAL f32 BytesToMB( usize bytes )
+	{
+		return ( f32 )bytes / ( 1024.0f * 1024.0f );
+	}
+
+	//======================================================================================================= 
+
+	void GraphicsSubsystem::ShowGPUMemoryWindow( )
+	{
+		static s32 sTopCount = 20;
+		static s32 sTypeFilter = ( s32 )GPUResourceType::Count;
+
+		ImGui::PushStyleColor( ImGuiCol_Text, ImVec4( 1.0, 0.6f, 0.0f, 1.0f ) );
+		ImGui::Text( "%s", "GPU Memory" );
+		ImGui::PopStyleColor( 1 );
+		ImGui::Separator( );
+
+		ImGui::Text( "Total: %.2f MB ( peak %.2f MB ) in %u allocations", BytesToMB( GPUMemoryTracker::GetTotalBytes( ) ), BytesToMB( GPUMemoryTracker::GetPeakBytes( ) ), GPUMemoryTracker::GetAllocationCount( ) );
+		for ( u32 i = 0; i < ( u32 )GPUResourceType::Count; ++i )
+		{
+			ImGui::BulletText( "%s: %.2f MB", GPUMemoryTracker::ToString( ( GPUResourceType )i ), BytesToMB( GPUMemoryTracker::GetBytes( ( GPUResourceType )i ) ) );
+		}
+
+		// Streamed mips are the part of texture memory that scales with what's on screen
+		usize streamed = mTextureStreamer.GetStreamedMemoryUsage( );
+		usize budget = mTextureStreamer.GetMemoryBudget( );
+		ImGui::Text( "Streamed Mips: %.2f / %.2f MB", BytesToMB( streamed ), BytesToMB( budget ) );
+		ImGui::ProgressBar( budget ? std::min( ( f32 )streamed / ( f32 )budget, 1.0f ) : 0.0f );
+
+		if ( ImGui::CollapsingHeader( "Pools##gpu_memory" ) )
+		{
+			Vector< GPUMemoryTotal > pools;
+			GPUMemoryTracker::GetPoolTotals( &pools );
+
+			ImGui::Columns( 3, "##gpu_memory_pools" );
+			for ( auto& p : pools )
+			{
+				ImGui::Text( "%s", p.mName.c_str( ) );		ImGui::NextColumn( );
+				ImGui::Text( "%.2f MB", BytesToMB( p.mBytes ) );	ImGui::NextColumn( );
+				ImGui::Text( "%u", p.mCount );				ImGui::NextColumn( );
+			}
+			ImGui::Columns( 1 );
+		}
+
+		ImGui::SliderInt( "Count##gpu_memory", &sTopCount, 1, 100 );
+
+		if ( ImGui::CollapsingHeader( "Largest Owners##gpu_memory" ) )
+		{
+			Vector< GPUMemoryTotal > owners;
+			GPUMemoryTracker::GetLargestOwners( ( u32 )sTopCount, &owners );
+
+			ImGui::Columns( 3, "##gpu_memory_owners" );
+			for ( auto& o : owners )
+			{
+				ImGui::Text( "%s", o.mName.c_str( ) );		ImGui::NextColumn( );
+				ImGui::Text( "%.2f MB", BytesToMB( o.mBytes ) );	ImGui::NextColumn( );
+				ImGui::Text( "%u", o.mCount );				ImGui::NextColumn( );
+			}
+			ImGui::Columns( 1 );
+		}
+
+		if ( ImGui::CollapsingHeader( "Largest Allocations##gpu_memory" ) )
+		{
+			ImGui::Combo( "Type##gpu_memory", &sTypeFilter, "Textures\0Render Targets\0Buffers\0All\0\0" );
+
+			Vector< GPUAllocation > allocations;
+			GPUMemoryTracker::GetLargestAllocations( ( GPUResourceType )sTypeFilter, ( u32 )sTopCount, &allocations );
+
+			ImGui::Columns( 4, "##gpu_memory_allocations" );
+			for ( auto& a : allocations )
+			{
+				ImGui::Text( "%s", a.mOwner.empty( ) ? a.mPool.c_str( ) : a.mOwner.c_str( ) );	ImGui::NextColumn( );
+				ImGui::Text( "%s", a.mPool.c_str( ) );											ImGui::NextColumn( );
+				ImGui::Text( "%s", GPUMemoryTracker::ToString( a.mType ) );						ImGui::NextColumn( );
+				ImGui::Text( "%.2f MB", BytesToMB( a.mBytes ) );									ImGui::NextColumn( );
+			}
+			ImGui::Columns( 1 );
+		}
+	}
+
+	//======================================================================================================= 
+
 	unsigned int cubeVAO = 0;
 	unsigned int cubeVBO = 0;
 	void GraphicsSubsystem::RenderCube( )
@@ -2457,6 +2646,7 @@ namespace Enjon
 			// fill buffer
 			glBindBuffer( GL_ARRAY_BUFFER, cubeVBO );
 			glBufferData( GL_ARRAY_BUFFER, sizeof( vertices ), vertices, GL_STATIC_DRAW );
+			GPUMemoryTracker::Track( GPUResourceType::Buffer, cubeVBO, sizeof( vertices ), "Image Based Lighting", "Capture Cube" );
 			// link vertex attributes
 			glBindVertexArray( cubeVAO );
 			glEnableVertexAttribArray( 0 );
@@ -2676,6 +2866,7 @@ namespace Enjon
 
 			// Data size
 			glBufferData( GL_ARRAY_BUFFER, sizeof( DebugLine ) * MAX_DEBUG_LINES, NULL, GL_DYNAMIC_DRAW );
+			GPUMemoryTracker::Track( GPUResourceType::Buffer, mDebugLineVBO, sizeof( DebugLine ) * MAX_DEBUG_LINES, "Debug Lines" );
 
 			// Tell opengl what attribute arrays we need 
 			glEnableVertexAttribArray(0);	// Point
@@ -0,0 +1,631 @@
+// @file ImageBasedLighting.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/ImageBasedLighting.h"
+#include "Graphics/GPUMemoryTracker.h"
+#include "Serialize/ByteBuffer.h"
+#include "System/JobSystem.h"
+
+#include <GLEW/glew.h>
+#include <math.h>
+#include <algorithm>
+
+#define ENJON_IBL_PI					3.14159265358979f
+
+// Largest equirectangular width radiance is projected onto spherical harmonics from, which are too smooth to need more
+#define ENJON_IBL_SH_SOURCE_WIDTH		256
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL inline void NormalizeDirection( f32 d[ 3 ] )
+	{
+		f32 len = sqrtf( d[ 0 ] * d[ 0 ] + d[ 1 ] * d[ 1 ] + d[ 2 ] * d[ 2 ] );
+		f32 inv = len > 0.0f ? 1.0f / len : 0.0f;
+		d[ 0 ] *= inv;
+		d[ 1 ] *= inv;
+		d[ 2 ] *= inv;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Direction through texel of cubemap face, face in GL order and u, v in [-1, 1]
+	*/
+	INTERNAL void CubemapDirection( u32 face, f32 u, f32 v, f32 d[ 3 ] )
+	{
+		switch ( face )
+		{
+			case 0: d[ 0 ] = 1.0f;	d[ 1 ] = -v;	d[ 2 ] = -u;	break;
+			case 1: d[ 0 ] = -1.0f;	d[ 1 ] = -v;	d[ 2 ] = u;		break;
+			case 2: d[ 0 ] = u;		d[ 1 ] = 1.0f;	d[ 2 ] = v;		break;
+			case 3: d[ 0 ] = u;		d[ 1 ] = -1.0f;	d[ 2 ] = -v;	break;
+			case 4: d[ 0 ] = u;		d[ 1 ] = -v;	d[ 2 ] = 1.0f;	break;
+			default: d[ 0 ] = -u;	d[ 1 ] = -v;	d[ 2 ] = -1.0f;	break;
+		}
+		NormalizeDirection( d );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Point i of n in Hammersley set
+	*/
+	INTERNAL inline void Hammersley( u32 i, u32 n, f32* x, f32* y )
+	{
+		u32 bits = i;
+		bits = ( bits << 16u ) | ( bits >> 16u );
+		bits = ( ( bits & 0x55555555u ) << 1u ) | ( ( bits & 0xAAAAAAAAu ) >> 1u );
+		bits = ( ( bits & 0x33333333u ) << 2u ) | ( ( bits & 0xCCCCCCCCu ) >> 2u );
+		bits = ( ( bits & 0x0F0F0F0Fu ) << 4u ) | ( ( bits & 0xF0F0F0F0u ) >> 4u );
+		bits = ( ( bits & 0x00FF00FFu ) << 8u ) | ( ( bits & 0xFF00FF00u ) >> 8u );
+		*x = ( f32 )i / ( f32 )n;
+		*y = ( f32 )bits * 2.3283064365386963e-10f;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief GGX distributed half vector in tangent space ( normal is +z )
+	*/
+	INTERNAL inline void ImportanceSampleGGX( f32 x, f32 y, f32 roughness, f32 h[ 3 ] )
+	{
+		f32 a = roughness * roughness;
+		f32 phi = 2.0f * ENJON_IBL_PI * x;
+		f32 cosTheta = sqrtf( ( 1.0f - y ) / ( 1.0f + ( a * a - 1.0f ) * y ) );
+		f32 sinTheta = sqrtf( std::max( 0.0f, 1.0f - cosTheta * cosTheta ) );
+		h[ 0 ] = cosf( phi ) * sinTheta;
+		h[ 1 ] = sinf( phi ) * sinTheta;
+		h[ 2 ] = cosTheta;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Equirectangular mip chain, sampled the way EquiToCube did on the gpu
+	*/
+	struct EquirectSampler
+	{
+		const Vector< Vector< f32 > >* mMips = nullptr;
+		u32 mComponents = 0;
+		u32 mWidth = 0;
+		u32 mHeight = 0;
+
+		void SampleLevel( u32 level, f32 u, f32 v, f32 out[ 3 ] ) const
+		{
+			u32 w = std::max( mWidth >> level, 1u );
+			u32 h = std::max( mHeight >> level, 1u );
+			const f32* pixels = ( *mMips )[ level ].data( );
+
+			f32 fx = u * ( f32 )w - 0.5f;
+			f32 fy = v * ( f32 )h - 0.5f;
+			s32 x0 = ( s32 )floorf( fx );
+			s32 y0 = ( s32 )floorf( fy );
+			f32 tx = fx - ( f32 )x0;
+			f32 ty = fy - ( f32 )y0;
+
+			// Longitude wraps, latitude clamps at poles
+			u32 xs[ 2 ] = { ( u32 )( ( x0 % ( s32 )w + ( s32 )w ) % ( s32 )w ), ( u32 )( ( ( x0 + 1 ) % ( s32 )w + ( s32 )w ) % ( s32 )w ) };
+			u32 ys[ 2 ] = { ( u32 )std::min( std::max( y0, 0 ), ( s32 )h - 1 ), ( u32 )std::min( std::max( y0 + 1, 0 ), ( s32 )h - 1 ) };
+			f32 wx[ 2 ] = { 1.0f - tx, tx };
+			f32 wy[ 2 ] = { 1.0f - ty, ty };
+
+			out[ 0 ] = out[ 1 ] = out[ 2 ] = 0.0f;
+			for ( u32 j = 0; j < 2; ++j )
+			{
+				for ( u32 i = 0; i < 2; ++i )
+				{
+					const f32* p = pixels + ( ( usize )ys[ j ] * w + xs[ i ] ) * mComponents;
+					f32 weight = wx[ i ] * wy[ j ];
+					for ( u32 c = 0; c < 3; ++c )
+					{
+						out[ c ] += p[ mComponents < 3 ? 0 : c ] * weight;
+					}
+				}
+			}
+		}
+
+		void Sample( const f32 d[ 3 ], f32 lod, f32 out[ 3 ] ) const
+		{
+			f32 u = atan2f( d[ 2 ], d[ 0 ] ) * ( 0.5f / ENJON_IBL_PI ) + 0.5f;
+			f32 v = asinf( std::min( std::max( d[ 1 ], -1.0f ), 1.0f ) ) / ENJON_IBL_PI + 0.5f;
+
+			f32 maxLevel = ( f32 )( mMips->size( ) - 1 );
+			lod = std::min( std::max( lod, 0.0f ), maxLevel );
+			u32 l0 = ( u32 )lod;
+			u32 l1 = std::min( l0 + 1, ( u32 )maxLevel );
+			f32 t = lod - ( f32 )l0;
+
+			SampleLevel( l0, u, v, out );
+			if ( t > 0.0f && l1 != l0 )
+			{
+				f32 next[ 3 ];
+				SampleLevel( l1, u, v, next );
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					out[ c ] += ( next[ c ] - out[ c ] ) * t;
+				}
+			}
+		}
+	};
+
+	//=================================================================
+
+	INTERNAL inline void EvaluateSHBasis( f32 x, f32 y, f32 z, f32 basis[ 9 ] )
+	{
+		basis[ 0 ] = 0.282095f;
+		basis[ 1 ] = 0.488603f * y;
+		basis[ 2 ] = 0.488603f * z;
+		basis[ 3 ] = 0.488603f * x;
+		basis[ 4 ] = 1.092548f * x * y;
+		basis[ 5 ] = 1.092548f * y * z;
+		basis[ 6 ] = 0.315392f * ( 3.0f * z * z - 1.0f );
+		basis[ 7 ] = 1.092548f * x * z;
+		basis[ 8 ] = 0.546274f * ( x * x - y * y );
+	}
+
+	//=================================================================
+
+	void ImageBasedLighting::ProjectSH( const f32* pixels, u32 components, u32 width, u32 height, f32 sh[ 9 ][ 3 ] )
+	{
+		// Rows are summed separately then reduced, keeping the result independent of scheduling
+		Vector< f32 > rows( ( usize )height * 27, 0.0f );
+		JobSystem::ParallelForOrSerial( height, [ & ]( u32 y )
+		{
+			f32* row = rows.data( ) + ( usize )y * 27;
+			f32 lat = ( ( ( f32 )y + 0.5f ) / ( f32 )height - 0.5f ) * ENJON_IBL_PI;
+			f32 solidAngle = cosf( lat ) * ( 2.0f * ENJON_IBL_PI / ( f32 )width ) * ( ENJON_IBL_PI / ( f32 )height );
+			f32 dy = sinf( lat );
+
+			for ( u32 x = 0; x < width; ++x )
+			{
+				f32 lon = ( ( ( f32 )x + 0.5f ) / ( f32 )width - 0.5f ) * 2.0f * ENJON_IBL_PI;
+				f32 dx = cosf( lat ) * cosf( lon );
+				f32 dz = cosf( lat ) * sinf( lon );
+
+				f32 basis[ 9 ];
+				EvaluateSHBasis( dx, dy, dz, basis );
+
+				const f32* p = pixels + ( ( usize )y * width + x ) * components;
+				for ( u32 k = 0; k < 9; ++k )
+				{
+					for ( u32 c = 0; c < 3; ++c )
+					{
+						row[ k * 3 + c ] += p[ components < 3 ? 0 : c ] * basis[ k ] * solidAngle;
+					}
+				}
+			}
+		} );
+
+		for ( u32 k = 0; k < 9; ++k )
+		{
+			for ( u32 c = 0; c < 3; ++c )
+			{
+				f32 sum = 0.0f;
+				for ( u32 y = 0; y < height; ++y )
+				{
+					sum += rows[ ( usize )y * 27 + k * 3 + c ];
+				}
+				sh[ k ][ c ] = sum;
+			}
+		}
+	}
+
+	//=================================================================
+
+	void ImageBasedLighting::EvaluateIrradiance( const f32 sh[ 9 ][ 3 ], f32 x, f32 y, f32 z, f32 out[ 3 ] )
+	{
+		// Cosine lobe convolution per band, divided by pi
+		static const f32 kBandScale[ 9 ] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+
+		f32 basis[ 9 ];
+		EvaluateSHBasis( x, y, z, basis );
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			f32 sum = 0.0f;
+			for ( u32 k = 0; k < 9; ++k )
+			{
+				sum += sh[ k ][ c ] * kBandScale[ k ] * basis[ k ];
+			}
+			out[ c ] = std::max( sum, 0.0f );
+		}
+	}
+
+	//=================================================================
+
+	void ImageBasedLighting::GenerateBRDFLUT( u32 size, Vector< f32 >* lut )
+	{
+		lut->assign( ( usize )size * size * 2, 0.0f );
+		JobSystem::ParallelForOrSerial( size, [ & ]( u32 row )
+		{
+			f32 roughness = ( ( f32 )row + 0.5f ) / ( f32 )size;
+			f32 a = roughness * roughness;
+			f32 k = a / 2.0f;
+
+			for ( u32 col = 0; col < size; ++col )
+			{
+				f32 NdotV = ( ( f32 )col + 0.5f ) / ( f32 )size;
+				f32 v[ 3 ] = { sqrtf( 1.0f - NdotV * NdotV ), 0.0f, NdotV };
+				f32 scale = 0.0f;
+				f32 bias = 0.0f;
+
+				for ( u32 i = 0; i < ENJON_IBL_BRDF_LUT_SAMPLE_COUNT; ++i )
+				{
+					f32 xi0, xi1, h[ 3 ];
+					Hammersley( i, ENJON_IBL_BRDF_LUT_SAMPLE_COUNT, &xi0, &xi1 );
+					ImportanceSampleGGX( xi0, xi1, roughness, h );
+
+					f32 VdotH = v[ 0 ] * h[ 0 ] + v[ 1 ] * h[ 1 ] + v[ 2 ] * h[ 2 ];
+					f32 NdotL = 2.0f * VdotH * h[ 2 ] - v[ 2 ];
+					if ( NdotL <= 0.0f )
+					{
+						continue;
+					}
+
+					f32 NdotH = std::max( h[ 2 ], 0.0f );
+					VdotH = std::max( VdotH, 0.0f );
+					f32 G = ( NdotV / ( NdotV * ( 1.0f - k ) + k ) ) * ( NdotL / ( NdotL * ( 1.0f - k ) + k ) );
+					f32 GVis = ( G * VdotH ) / std::max( NdotH * NdotV, 1e-6f );
+					f32 Fc = powf( 1.0f - VdotH, 5.0f );
+					scale += ( 1.0f - Fc ) * GVis;
+					bias += Fc * GVis;
+				}
+
+				f32* out = lut->data( ) + ( ( usize )row * size + col ) * 2;
+				out[ 0 ] = scale / ( f32 )ENJON_IBL_BRDF_LUT_SAMPLE_COUNT;
+				out[ 1 ] = bias / ( f32 )ENJON_IBL_BRDF_LUT_SAMPLE_COUNT;
+			}
+		} );
+	}
+
+	//=================================================================
+
+	Result ImageBasedLighting::Precompute( const Vector< Vector< f32 > >& mips, u32 components, u32 width, u32 height, ImageBasedLightingData* out )
+	{
+		if ( mips.empty( ) || !components || !width || !height || !out )
+		{
+			return Result::FAILURE;
+		}
+
+		EquirectSampler sampler;
+		sampler.mMips = &mips;
+		sampler.mComponents = components;
+		sampler.mWidth = width;
+		sampler.mHeight = height;
+
+		// Irradiance
+		u32 shLevel = 0;
+		while ( shLevel + 1 < mips.size( ) && ( width >> shLevel ) > ENJON_IBL_SH_SOURCE_WIDTH )
+		{
+			++shLevel;
+		}
+		ProjectSH( mips[ shLevel ].data( ), components, std::max( width >> shLevel, 1u ), std::max( height >> shLevel, 1u ), out->mIrradianceSH );
+
+		// Prefiltered specular, one job per row of every face of every level
+		const u32 size = ENJON_IBL_PREFILTER_SIZE;
+		const f32 texelSolidAngle = 4.0f * ENJON_IBL_PI / ( ( f32 )width * ( f32 )height );
+
+		out->mPrefilterSize = size;
+		out->mPrefilterLevels.resize( ENJON_IBL_PREFILTER_LEVELS );
+
+		// Samples only depend on roughness, so their tangent space directions and source lods are shared by all texels
+		struct PrefilterSample
+		{
+			f32 mH[ 3 ];
+			f32 mNdotL;
+			f32 mLod;
+		};
+		Vector< Vector< PrefilterSample > > samples( ENJON_IBL_PREFILTER_LEVELS );
+
+		u32 rowCount = 0;
+		Vector< u32 > firstRow( ENJON_IBL_PREFILTER_LEVELS );
+		for ( u32 level = 0; level < ENJON_IBL_PREFILTER_LEVELS; ++level )
+		{
+			u32 levelSize = std::max( size >> level, 1u );
+			out->mPrefilterLevels[ level ].assign( ( usize )levelSize * levelSize * 6 * 3, 0.0f );
+			firstRow[ level ] = rowCount;
+			rowCount += levelSize * 6;
+
+			f32 roughness = ( f32 )level / ( f32 )( ENJON_IBL_PREFILTER_LEVELS - 1 );
+			if ( level == 0 )
+			{
+				// Mirror reflection, read at the source lod covering one output texel
+				f32 cubeTexelSolidAngle = 4.0f * ENJON_IBL_PI / ( 6.0f * ( f32 )levelSize * ( f32 )levelSize );
+				samples[ level ].push_back( { { 0.0f, 0.0f, 1.0f }, 1.0f, 0.5f * log2f( std::max( cubeTexelSolidAngle / texelSolidAngle, 1.0f ) ) } );
+				continue;
+			}
+
+			f32 a = roughness * roughness;
+			for ( u32 i = 0; i < ENJON_IBL_PREFILTER_SAMPLE_COUNT; ++i )
+			{
+				PrefilterSample s;
+				f32 xi0, xi1;
+				Hammersley( i, ENJON_IBL_PREFILTER_SAMPLE_COUNT, &xi0, &xi1 );
+				ImportanceSampleGGX( xi0, xi1, roughness, s.mH );
+
+				// View and normal are the reflection vector, so NdotL and pdf follow from NdotH alone
+				f32 NdotH = s.mH[ 2 ];
+				s.mNdotL = 2.0f * NdotH * NdotH - 1.0f;
+				if ( s.mNdotL <= 0.0f )
+				{
+					continue;
+				}
+
+				// Filtered importance sampling, reading from the mip whose texels cover each sample's solid angle
+				f32 denom = NdotH * NdotH * ( a * a - 1.0f ) + 1.0f;
+				f32 D = ( a * a ) / ( ENJON_IBL_PI * denom * denom );
+				f32 pdf = D / 4.0f + 1e-4f;
+				f32 sampleSolidAngle = 1.0f / ( ( f32 )ENJON_IBL_PREFILTER_SAMPLE_COUNT * pdf );
+				s.mLod = 0.5f * log2f( std::max( sampleSolidAngle / texelSolidAngle, 1.0f ) );
+				samples[ level ].push_back( s );
+			}
+		}
+
+		JobSystem::ParallelForOrSerial( rowCount, [ & ]( u32 job )
+		{
+			u32 level = ENJON_IBL_PREFILTER_LEVELS - 1;
+			while ( firstRow[ level ] > job )
+			{
+				--level;
+			}
+
+			u32 levelSize = std::max( size >> level, 1u );
+			u32 face = ( job - firstRow[ level ] ) / levelSize;
+			u32 y = ( job - firstRow[ level ] ) % levelSize;
+			f32* row = out->mPrefilterLevels[ level ].data( ) + ( ( usize )face * levelSize + y ) * levelSize * 3;
+			const Vector< PrefilterSample >& levelSamples = samples[ level ];
+
+			for ( u32 x = 0; x < levelSize; ++x )
+			{
+				f32 n[ 3 ];
+				CubemapDirection( face, 2.0f * ( ( f32 )x + 0.5f ) / ( f32 )levelSize - 1.0f, 2.0f * ( ( f32 )y + 0.5f ) / ( f32 )levelSize - 1.0f, n );
+
+				// Tangent frame around normal
+				f32 up[ 3 ] = { 0.0f, 0.0f, 1.0f };
+				if ( fabsf( n[ 2 ] ) >= 0.999f )
+				{
+					up[ 0 ] = 1.0f;
+					up[ 2 ] = 0.0f;
+				}
+				f32 t[ 3 ] = { up[ 1 ] * n[ 2 ] - up[ 2 ] * n[ 1 ], up[ 2 ] * n[ 0 ] - up[ 0 ] * n[ 2 ], up[ 0 ] * n[ 1 ] - up[ 1 ] * n[ 0 ] };
+				NormalizeDirection( t );
+				f32 b[ 3 ] = { n[ 1 ] * t[ 2 ] - n[ 2 ] * t[ 1 ], n[ 2 ] * t[ 0 ] - n[ 0 ] * t[ 2 ], n[ 0 ] * t[ 1 ] - n[ 1 ] * t[ 0 ] };
+
+				f32 color[ 3 ] = { 0.0f, 0.0f, 0.0f };
+				f32 weight = 0.0f;
+				for ( const PrefilterSample& s : levelSamples )
+				{
+					f32 h[ 3 ];
+					for ( u32 c = 0; c < 3; ++c )
+					{
+						h[ c ] = t[ c ] * s.mH[ 0 ] + b[ c ] * s.mH[ 1 ] + n[ c ] * s.mH[ 2 ];
+					}
+
+					// Reflect normal about half vector
+					f32 l[ 3 ];
+					for ( u32 c = 0; c < 3; ++c )
+					{
+						l[ c ] = 2.0f * s.mH[ 2 ] * h[ c ] - n[ c ];
+					}
+
+					f32 radiance[ 3 ];
+					sampler.Sample( l, s.mLod, radiance );
+					for ( u32 c = 0; c < 3; ++c )
+					{
+						color[ c ] += radiance[ c ] * s.mNdotL;
+					}
+					weight += s.mNdotL;
+				}
+
+				f32 inv = weight > 0.0f ? 1.0f / weight : 0.0f;
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					row[ x * 3 + c ] = color[ c ] * inv;
+				}
+			}
+		} );
+
+		// Split sum lookup
+		out->mBRDFLUTSize = ENJON_IBL_BRDF_LUT_SIZE;
+		GenerateBRDFLUT( out->mBRDFLUTSize, &out->mBRDFLUT );
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	void ImageBasedLighting::Serialize( const ImageBasedLightingData& data, ByteBuffer* buffer )
+	{
+		buffer->Write< u32 >( ENJON_IBL_MAGIC );
+
+		for ( u32 k = 0; k < 9; ++k )
+		{
+			for ( u32 c = 0; c < 3; ++c )
+			{
+				buffer->Write< f32 >( data.mIrradianceSH[ k ][ c ] );
+			}
+		}
+
+		buffer->Write< u32 >( data.mPrefilterSize );
+		buffer->Write< u32 >( ( u32 )data.mPrefilterLevels.size( ) );
+		for ( const Vector< f32 >& level : data.mPrefilterLevels )
+		{
+			buffer->Write< u32 >( ( u32 )level.size( ) );
+			buffer->WriteBytes( ( const u8* )level.data( ), ( u32 )( level.size( ) * sizeof( f32 ) ) );
+		}
+
+		buffer->Write< u32 >( data.mBRDFLUTSize );
+		buffer->Write< u32 >( ( u32 )data.mBRDFLUT.size( ) );
+		buffer->WriteBytes( ( const u8* )data.mBRDFLUT.data( ), ( u32 )( data.mBRDFLUT.size( ) * sizeof( f32 ) ) );
+	}
+
+	//=================================================================
+
+	Result ImageBasedLighting::Deserialize( ByteBuffer* buffer, ImageBasedLightingData* data )
+	{
+		if ( buffer->Read< u32 >( ) != ENJON_IBL_MAGIC )
+		{
+			return Result::FAILURE;
+		}
+
+		for ( u32 k = 0; k < 9; ++k )
+		{
+			for ( u32 c = 0; c < 3; ++c )
+			{
+				data->mIrradianceSH[ k ][ c ] = buffer->Read< f32 >( );
+			}
+		}
+
+		data->mPrefilterSize = buffer->Read< u32 >( );
+		u32 levelCount = buffer->Read< u32 >( );
+		data->mPrefilterLevels.resize( levelCount );
+		for ( u32 level = 0; level < levelCount; ++level )
+		{
+			u32 levelSize = std::max( data->mPrefilterSize >> level, 1u );
+			u32 count = buffer->Read< u32 >( );
+			if ( count != levelSize * levelSize * 6 * 3 )
+			{
+				*data = ImageBasedLightingData( );
+				return Result::FAILURE;
+			}
+
+			data->mPrefilterLevels[ level ].resize( count );
+			if ( !buffer->ReadBytes( ( u8* )data->mPrefilterLevels[ level ].data( ), count * sizeof( f32 ) ) )
+			{
+				*data = ImageBasedLightingData( );
+				return Result::FAILURE;
+			}
+		}
+
+		data->mBRDFLUTSize = buffer->Read< u32 >( );
+		u32 count = buffer->Read< u32 >( );
+		if ( count != data->mBRDFLUTSize * data->mBRDFLUTSize * 2 )
+		{
+			*data = ImageBasedLightingData( );
+			return Result::FAILURE;
+		}
+
+		data->mBRDFLUT.resize( count );
+		if ( !buffer->ReadBytes( ( u8* )data->mBRDFLUT.data( ), count * sizeof( f32 ) ) )
+		{
+			*data = ImageBasedLightingData( );
+			return Result::FAILURE;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	INTERNAL void SetCubemapParameters( bool mipmapped )
+	{
+		glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE );
+		glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR );
+		glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+	}
+
+	//=================================================================
+
+	ImageBasedLightingMaps ImageBasedLighting::Upload( const ImageBasedLightingData& data, const String& owner )
+	{
+		ImageBasedLightingMaps maps;
+		if ( !data.IsValid( ) )
+		{
+			return maps;
+		}
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+		// Irradiance is smooth enough to be expanded from its harmonics here rather than stored
+		{
+			const u32 size = ENJON_IBL_IRRADIANCE_SIZE;
+			Vector< f32 > face( ( usize )size * size * 3 );
+
+			glGenTextures( 1, &maps.mIrradianceMap );
+			glBindTexture( GL_TEXTURE_CUBE_MAP, maps.mIrradianceMap );
+			for ( u32 f = 0; f < 6; ++f )
+			{
+				for ( u32 y = 0; y < size; ++y )
+				{
+					for ( u32 x = 0; x < size; ++x )
+					{
+						f32 d[ 3 ];
+						CubemapDirection( f, 2.0f * ( ( f32 )x + 0.5f ) / ( f32 )size - 1.0f, 2.0f * ( ( f32 )y + 0.5f ) / ( f32 )size - 1.0f, d );
+						EvaluateIrradiance( data.mIrradianceSH, d[ 0 ], d[ 1 ], d[ 2 ], &face[ ( ( usize )y * size + x ) * 3 ] );
+					}
+				}
+				glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, 0, GL_RGB16F, size, size, 0, GL_RGB, GL_FLOAT, face.data( ) );
+			}
+			SetCubemapParameters( false );
+
+			usize bytes = GPUMemoryTracker::GetTextureSize( GL_RGB16F, size, size, 1, 6 );
+			GPUMemoryTracker::Track( GPUResourceType::Texture, maps.mIrradianceMap, bytes, "Image Based Lighting", owner );
+			maps.mGPUMemoryBytes += bytes;
+		}
+
+		// Prefiltered specular
+		{
+			glGenTextures( 1, &maps.mPrefilteredMap );
+			glBindTexture( GL_TEXTURE_CUBE_MAP, maps.mPrefilteredMap );
+			usize bytes = 0;
+			for ( u32 level = 0; level < ( u32 )data.mPrefilterLevels.size( ); ++level )
+			{
+				u32 size = std::max( data.mPrefilterSize >> level, 1u );
+				usize faceCount = ( usize )size * size * 3;
+				for ( u32 f = 0; f < 6; ++f )
+				{
+					glTexImage2D( GL_TEXTURE_CUBE_MAP_POSITIVE_X + f, level, GL_RGB16F, size, size, 0, GL_RGB, GL_FLOAT, data.mPrefilterLevels[ level ].data( ) + faceCount * f );
+				}
+				bytes += GPUMemoryTracker::GetImageSize( GL_RGB16F, size, size ) * 6;
+			}
+			glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BASE_LEVEL, 0 );
+			glTexParameteri( GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, ( s32 )data.mPrefilterLevels.size( ) - 1 );
+			SetCubemapParameters( true );
+
+			GPUMemoryTracker::Track( GPUResourceType::Texture, maps.mPrefilteredMap, bytes, "Image Based Lighting", owner );
+			maps.mGPUMemoryBytes += bytes;
+		}
+		glBindTexture( GL_TEXTURE_CUBE_MAP, 0 );
+
+		// BRDF lookup
+		{
+			glGenTextures( 1, &maps.mBRDFLUT );
+			glBindTexture( GL_TEXTURE_2D, maps.mBRDFLUT );
+			glTexImage2D( GL_TEXTURE_2D, 0, GL_RG16F, data.mBRDFLUTSize, data.mBRDFLUTSize, 0, GL_RG, GL_FLOAT, data.mBRDFLUT.data( ) );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+			glBindTexture( GL_TEXTURE_2D, 0 );
+
+			usize bytes = GPUMemoryTracker::GetImageSize( GL_RG16F, data.mBRDFLUTSize, data.mBRDFLUTSize );
+			GPUMemoryTracker::Track( GPUResourceType::Texture, maps.mBRDFLUT, bytes, "Image Based Lighting", owner );
+			maps.mGPUMemoryBytes += bytes;
+		}
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+		return maps;
+	}
+
+	//=================================================================
+
+	void ImageBasedLighting::Release( ImageBasedLightingMaps* maps )
+	{
+		for ( u32* map : { &maps->mIrradianceMap, &maps->mPrefilteredMap, &maps->mBRDFLUT } )
+		{
+			if ( *map )
+			{
+				GPUMemoryTracker::Release( GPUResourceType::Texture, *map );
+				glDeleteTextures( 1, map );
+			}
+		}
+
+		*maps = ImageBasedLightingMaps( );
+	}
+
+	//=================================================================
+}
@@ -10,6 +10,7 @@
 #include "Engine.h"
 
 #include <assert.h>
+#include <atomic>
 
 namespace Enjon 
 { 
@@ -23,6 +24,14 @@ namespace Enjon
 	
 	//======================================================================== 
 
+	u32 Material::AllocateMaterialID( )
+	{
+		static std::atomic< u32 > sNextMaterialID( 0 );
+		return sNextMaterialID++;
+	}
+
+	//======================================================================== 
+
 	void Material::ExplicitDestructor()
 	{
 		// Free memory
@@ -114,6 +123,30 @@ namespace Enjon
 		} 
 	} 
 
+	//======================================================================== 
+
+	void Material::GetTextures( Vector< const Texture* >* textures ) const
+	{
+		const ShaderGraph* sg = mShaderGraph.Get( );
+		if ( !sg )
+		{
+			return;
+		}
+
+		for ( auto& u : *sg->GetUniforms( ) )
+		{
+			const ShaderUniform* uniform = HasOverride( u.second->GetName( ) ) ? GetOverride( u.second->GetName( ) ) : u.second;
+			if ( uniform && uniform->GetType( ) == UniformType::TextureSampler2D )
+			{
+				const Texture* texture = static_cast< const UniformTexture* >( uniform )->GetTexture( ).Get( );
+				if ( texture )
+				{
+					textures->push_back( texture );
+				}
+			}
+		}
+	}
+
 	//======================================================================== 
 			
 	void Material::SetUniform( const String& name, const AssetHandle< Texture >& value )
@@ -3,6 +3,14 @@
 #include "Asset/MeshAssetLoader.h"
 #include "Serialize/ObjectArchiver.h"
 #include "Asset/SkeletalMeshAssetLoader.h"
+#include "Graphics/Shader.h"
+#include "Graphics/GPUMemoryTracker.h"
+
+// 'EIDX', read where older cached submeshes stored their vertex data size, which can never be this large
+#define ENJON_SUBMESH_INDEXED_MAGIC		0x58444945
+
+// 'ELOD', indexed layout followed by level of detail ranges
+#define ENJON_SUBMESH_LOD_MAGIC			0x444F4C45
 
 namespace Enjon 
 { 
@@ -28,6 +36,11 @@ namespace Enjon
 			case VertexAttributeFormat::UnsignedInt3:	{ byteSize = 4 * 3; } break;
 			case VertexAttributeFormat::UnsignedInt2:	{ byteSize = 4 * 2; } break;
 			case VertexAttributeFormat::UnsignedInt:	{ byteSize = 4 * 1; } break;
+			case VertexAttributeFormat::UNorm16x4:		{ byteSize = 2 * 4; } break;
+			case VertexAttributeFormat::SNorm16x2:		{ byteSize = 2 * 2; } break;
+			case VertexAttributeFormat::UNorm16x2:		{ byteSize = 2 * 2; } break;
+			case VertexAttributeFormat::Half2:			{ byteSize = 2 * 2; } break;
+			case VertexAttributeFormat::UNorm8x4:		{ byteSize = 1 * 4; } break;
 		} 
 
 		return byteSize;
@@ -90,6 +103,11 @@ namespace Enjon
 				case VertexAttributeFormat::UnsignedInt3:	{ sz += 3 * sizeof( u32 ); } break;
 				case VertexAttributeFormat::UnsignedInt2:	{ sz += 2 * sizeof( u32 ); } break;
 				case VertexAttributeFormat::UnsignedInt:	{ sz += 1 * sizeof( u32 ); } break; 
+				case VertexAttributeFormat::UNorm16x4:		{ sz += 4 * sizeof( u16 ); } break;
+				case VertexAttributeFormat::SNorm16x2:		{ sz += 2 * sizeof( s16 ); } break;
+				case VertexAttributeFormat::UNorm16x2:		{ sz += 2 * sizeof( u16 ); } break;
+				case VertexAttributeFormat::Half2:			{ sz += 2 * sizeof( u16 ); } break;
+				case VertexAttributeFormat::UNorm8x4:		{ sz += 4 * sizeof( u8 ); } break;
 			} 
 		}
 
@@ -191,6 +209,21 @@ namespace Enjon
 
 	//=========================================================================
 
+	usize Mesh::GetResidentMemoryUsage( ) const
+	{
+		// Vertex and index data is kept on the CPU after being uploaded, so uploaded submeshes count twice
+		usize bytes = 0;
+		for ( auto& sm : mSubMeshes )
+		{
+			usize size = sm->mVertexData.GetSize( ) + sm->mIndexData.GetSize( );
+			bytes += sm->mVBO ? size * 2 : size;
+		}
+
+		return bytes;
+	}
+
+	//=========================================================================
+
 	const VertexDataDeclaration& Mesh::GetVertexDeclaration( )
 	{
 		return mVertexDecl;
@@ -198,6 +231,227 @@ namespace Enjon
 
 	//=========================================================================
 
+	void Mesh::Bind( const Shader* shader ) const
+	{
+		if ( !shader )
+		{
+			return;
+		}
+
+		// Unquantized meshes set identity decode, since uniforms persist across draws with the same shader
+		Shader* shdr = const_cast< Shader* >( shader );
+		shdr->SetUniform( "uVertexPositionOffset", mPositionOffset );
+		shdr->SetUniform( "uVertexPositionScale", mPositionScale );
+		shdr->SetUniform( "uVertexOctahedralDirections", ( s32 )HasOctahedralDirections( ) );
+	}
+
+	//=========================================================================
+
+	bool Mesh::HasOctahedralDirections( ) const
+	{
+		return ( mVertexDecl.mDecl.size( ) > 1 && mVertexDecl.mDecl[ 1 ] == VertexAttributeFormat::SNorm16x2 );
+	}
+
+	//=========================================================================
+
+	u32 Mesh::GetLODCount( ) const
+	{
+		u32 count = 1;
+		for ( auto& sm : mSubMeshes )
+		{
+			count = std::max( count, sm->GetLODCount( ) );
+		}
+
+		return count;
+	}
+
+	//=========================================================================
+
+	f32 Mesh::GetLODError( const u32& lod ) const
+	{
+		f32 error = 0.0f;
+		for ( auto& sm : mSubMeshes )
+		{
+			error = std::max( error, sm->GetLODError( lod ) );
+		}
+
+		return error;
+	}
+
+	//=========================================================================
+
+	Vec3 Mesh::GetBoundsMin( ) const
+	{
+		return mBoundsMin;
+	}
+
+	//=========================================================================
+
+	Vec3 Mesh::GetBoundsMax( ) const
+	{
+		return mBoundsMax;
+	}
+
+	//=========================================================================
+
+	INTERNAL f32 DecodeHalf( u16 half )
+	{
+		u32 sign = ( u32 )( half & 0x8000 ) << 16;
+		u32 exponent = ( half >> 10 ) & 0x1F;
+		u32 mantissa = half & 0x3FF;
+
+		// Denormals and zero
+		if ( exponent == 0 )
+		{
+			f32 value = ( f32 )mantissa / 16777216.0f;
+			return sign ? -value : value;
+		}
+
+		u32 bits = sign | ( exponent == 0x1F ? 0x7F800000 | ( mantissa << 13 ) : ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 ) );
+		f32 value;
+		memcpy( &value, &bits, sizeof( f32 ) );
+		return value;
+	}
+
+	//=========================================================================
+
+	void Mesh::CalculateBounds( )
+	{
+		mBoundsMin = Vec3( 0.0f );
+		mBoundsMax = Vec3( 0.0f );
+		mUVDensity = 0.0f;
+
+		usize vertexSize = mVertexDecl.GetSizeInBytes( );
+		if ( !vertexSize || mVertexDecl.mDecl.empty( ) )
+		{
+			return;
+		}
+
+		VertexAttributeFormat format = mVertexDecl.mDecl[ 0 ];
+		if ( format != VertexAttributeFormat::UNorm16x4 && format != VertexAttributeFormat::Float3 && format != VertexAttributeFormat::Float4 )
+		{
+			return;
+		}
+
+		// Decode position the same way vertex shaders do
+		auto decodePosition = [ & ] ( const u8* vertex ) -> Vec3
+		{
+			if ( format == VertexAttributeFormat::UNorm16x4 )
+			{
+				const u16* q = ( const u16* )vertex;
+				return mPositionOffset + Vec3( ( f32 )q[ 0 ], ( f32 )q[ 1 ], ( f32 )q[ 2 ] ) / 65535.0f * mPositionScale;
+			}
+
+			const f32* f = ( const f32* )vertex;
+			return Vec3( f[ 0 ], f[ 1 ], f[ 2 ] );
+		};
+
+		bool first = true;
+		for ( auto& sm : mSubMeshes )
+		{
+			u32 vertexCount = sm->mVertexData.GetSize( ) / vertexSize;
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				Vec3 p = decodePosition( sm->mVertexData.GetData( ) + v * vertexSize );
+
+				if ( first )
+				{
+					mBoundsMin = mBoundsMax = p;
+					first = false;
+				}
+				else
+				{
+					mBoundsMin = Vec3( std::min( mBoundsMin.x, p.x ), std::min( mBoundsMin.y, p.y ), std::min( mBoundsMin.z, p.z ) );
+					mBoundsMax = Vec3( std::max( mBoundsMax.x, p.x ), std::max( mBoundsMax.y, p.y ), std::max( mBoundsMax.z, p.z ) );
+				}
+			}
+		}
+
+		// Texture coordinates are the fourth attribute of every layout that has them
+		if ( mVertexDecl.mDecl.size( ) < 4 )
+		{
+			return;
+		}
+
+		VertexAttributeFormat uvFormat = mVertexDecl.mDecl[ 3 ];
+		if ( uvFormat != VertexAttributeFormat::Float2 && uvFormat != VertexAttributeFormat::UNorm16x2 && uvFormat != VertexAttributeFormat::Half2 )
+		{
+			return;
+		}
+
+		s32 uvOffset = mVertexDecl.GetByteOffset( 3 );
+		auto decodeUV = [ & ] ( const u8* vertex ) -> Vec2
+		{
+			const u8* uv = vertex + uvOffset;
+			switch ( uvFormat )
+			{
+				case VertexAttributeFormat::UNorm16x2:	return Vec2( ( f32 )( ( const u16* )uv )[ 0 ], ( f32 )( ( const u16* )uv )[ 1 ] ) / 65535.0f;
+				case VertexAttributeFormat::Half2:		return Vec2( DecodeHalf( ( ( const u16* )uv )[ 0 ] ), DecodeHalf( ( ( const u16* )uv )[ 1 ] ) );
+				default:								return Vec2( ( ( const f32* )uv )[ 0 ], ( ( const f32* )uv )[ 1 ] );
+			}
+		};
+
+		// Ratio of texture coordinate area to surface area over finest level of every submesh
+		f64 uvArea = 0.0;
+		f64 surfaceArea = 0.0;
+		for ( auto& sm : mSubMeshes )
+		{
+			const u8* vertices = sm->mVertexData.GetData( );
+			u32 vertexCount = sm->mVertexData.GetSize( ) / vertexSize;
+			u32 indexStart = sm->mLODs.empty( ) ? 0 : sm->mLODs[ 0 ].mIndexOffset;
+			u32 indexCount = sm->mIndexSize ? ( sm->mLODs.empty( ) ? sm->mIndexData.GetSize( ) / sm->mIndexSize : sm->mLODs[ 0 ].mIndexCount ) : vertexCount;
+
+			for ( u32 t = 0; t + 2 < indexCount; t += 3 )
+			{
+				u32 idx[ 3 ];
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					u32 i = indexStart + t + c;
+					if ( sm->mIndexSize == sizeof( u16 ) )
+					{
+						idx[ c ] = ( ( const u16* )sm->mIndexData.GetData( ) )[ i ];
+					}
+					else if ( sm->mIndexSize )
+					{
+						idx[ c ] = ( ( const u32* )sm->mIndexData.GetData( ) )[ i ];
+					}
+					else
+					{
+						idx[ c ] = i;
+					}
+				}
+
+				if ( idx[ 0 ] >= vertexCount || idx[ 1 ] >= vertexCount || idx[ 2 ] >= vertexCount )
+				{
+					continue;
+				}
+
+				const u8* v0 = vertices + idx[ 0 ] * vertexSize;
+				const u8* v1 = vertices + idx[ 1 ] * vertexSize;
+				const u8* v2 = vertices + idx[ 2 ] * vertexSize;
+
+				Vec3 p0 = decodePosition( v0 );
+				surfaceArea += 0.5 * ( decodePosition( v1 ) - p0 ).Cross( decodePosition( v2 ) - p0 ).Length( );
+
+				Vec2 uv0 = decodeUV( v0 );
+				Vec2 e1 = decodeUV( v1 ) - uv0;
+				Vec2 e2 = decodeUV( v2 ) - uv0;
+				uvArea += 0.5 * std::fabs( e1.x * e2.y - e1.y * e2.x );
+			}
+		}
+
+		mUVDensity = surfaceArea > 0.0 ? ( f32 )std::sqrt( uvArea / surfaceArea ) : 0.0f;
+	}
+
+	//=========================================================================
+
+	f32 Mesh::GetUVDensity( ) const
+	{
+		return mUVDensity;
+	}
+
+	//=========================================================================
+
 	void Mesh::SetVertexDecl( const VertexDataDeclaration& decl )
 	{
 		mVertexDecl = decl;
@@ -212,6 +466,17 @@ namespace Enjon
 		// Write out vertex decl
 		mVertexDecl.SerializeData( buffer );
 
+		// Quantized positions need their bounds to be decoded. Older layouts never have these formats.
+		if ( !mVertexDecl.mDecl.empty( ) && mVertexDecl.mDecl[ 0 ] == VertexAttributeFormat::UNorm16x4 )
+		{
+			buffer->Write< f32 >( mPositionOffset.x );
+			buffer->Write< f32 >( mPositionOffset.y );
+			buffer->Write< f32 >( mPositionOffset.z );
+			buffer->Write< f32 >( mPositionScale.x );
+			buffer->Write< f32 >( mPositionScale.y );
+			buffer->Write< f32 >( mPositionScale.z );
+		}
+
 		// Write out submesh count
 		buffer->Write< u32 >( mSubMeshes.size( ) );
 
@@ -233,6 +498,17 @@ namespace Enjon
 		// Read in vertex decl
 		mVertexDecl.DeserializeData( buffer );
 
+		// Read in quantized position bounds
+		if ( !mVertexDecl.mDecl.empty( ) && mVertexDecl.mDecl[ 0 ] == VertexAttributeFormat::UNorm16x4 )
+		{
+			mPositionOffset.x = buffer->Read< f32 >( );
+			mPositionOffset.y = buffer->Read< f32 >( );
+			mPositionOffset.z = buffer->Read< f32 >( );
+			mPositionScale.x = buffer->Read< f32 >( );
+			mPositionScale.y = buffer->Read< f32 >( );
+			mPositionScale.z = buffer->Read< f32 >( );
+		}
+
 		// Read in number of submeshes
 		u32 numSubMeshes = buffer->Read< u32 >( );
 
@@ -245,11 +521,30 @@ namespace Enjon
 			sm->DeserializeData( buffer );
 		}
 
+		// Bounds aren't cached, since they're cheap to rebuild from vertex data
+		CalculateBounds( );
+
 		return Result::SUCCESS;
 	} 
 
 	//=========================================================================
 
+	Result Mesh::DeserializeLateInit( )
+	{
+		// Upload any submeshes decoded in DeserializeData
+		for ( auto& sm : mSubMeshes )
+		{
+			if ( !sm->mVBO && sm->mVertexData.GetSize( ) )
+			{
+				sm->UploadVertexData( );
+			}
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=========================================================================
+
 	SubMesh* Mesh::ConstructSubmesh( )
 	{
 		SubMesh* sm = new SubMesh( this );
@@ -278,12 +573,22 @@ namespace Enjon
 		if ( mVBO )
 		{
 			// TODO(): Get rid of all exposed OpenGL/ DX API calls
+			GPUMemoryTracker::Release( GPUResourceType::Buffer, mVBO );
 			glDeleteBuffers( 1, &mVBO ); 
+			mVBO = 0;
+		}
+
+		if ( mIBO )
+		{
+			GPUMemoryTracker::Release( GPUResourceType::Buffer, mIBO );
+			glDeleteBuffers( 1, &mIBO );
+			mIBO = 0;
 		}
 
 		if ( mVAO )
 		{
-			glDeleteBuffers( 1, &mVBO ); 
+			glDeleteVertexArrays( 1, &mVAO ); 
+			mVAO = 0;
 		} 
 
 		mVerticies.clear( );
@@ -308,9 +613,21 @@ namespace Enjon
 
 	//=========================================================================
 
-	void SubMesh::Submit() const
+	void SubMesh::Submit( const u32& lod ) const
 	{
-		glDrawArrays(mDrawType, 0, mDrawCount);	
+		if ( mIBO && !mLODs.empty( ) )
+		{
+			const SubMeshLOD& l = mLODs[ std::min( lod, ( u32 )mLODs.size( ) - 1 ) ];
+			glDrawElements( mDrawType, l.mIndexCount, mIndexSize == sizeof( u16 ) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, Int2VoidP( l.mIndexOffset * mIndexSize ) );
+		}
+		else if ( mIBO )
+		{
+			glDrawElements( mDrawType, mDrawCount, mIndexSize == sizeof( u16 ) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, nullptr );
+		}
+		else
+		{
+			glDrawArrays(mDrawType, 0, mDrawCount);	
+		}
 	}
 
 	//=========================================================================
@@ -334,6 +651,32 @@ namespace Enjon
 
 	//=========================================================================
 
+	u32 SubMesh::GetLODCount( ) const
+	{
+		return std::max( ( u32 )mLODs.size( ), ( u32 )1 );
+	}
+
+	//=========================================================================
+
+	f32 SubMesh::GetLODError( const u32& lod ) const
+	{
+		if ( mLODs.empty( ) )
+		{
+			return 0.0f;
+		}
+
+		return mLODs[ std::min( lod, ( u32 )mLODs.size( ) - 1 ) ].mError;
+	}
+
+	//=========================================================================
+
+	bool SubMesh::IsIndexed( ) const
+	{
+		return ( mIndexSize != 0 );
+	}
+
+	//=========================================================================
+
 	u32 SubMesh::GetVAO( ) const
 	{ 
 		return mVAO;
@@ -357,12 +700,29 @@ namespace Enjon
 
 	Result SubMesh::SerializeData( ByteBuffer* buffer ) const
 	{ 
+		// Marks indexed layout with levels of detail
+		buffer->Write< u32 >( ENJON_SUBMESH_LOD_MAGIC );
+
 		// Write out size of data
 		buffer->Write< u32 >( mVertexData.GetSize( ) );
 
 		// Write out vertex data
 		buffer->AppendBuffer( mVertexData );
 
+		// Write out index size and data ( zero size for unindexed submeshes )
+		buffer->Write< u32 >( mIndexSize );
+		buffer->Write< u32 >( mIndexData.GetSize( ) );
+		buffer->AppendBuffer( mIndexData );
+
+		// Write out level of detail ranges into index data
+		buffer->Write< u32 >( mLODs.size( ) );
+		for ( auto& l : mLODs )
+		{
+			buffer->Write< u32 >( l.mIndexOffset );
+			buffer->Write< u32 >( l.mIndexCount );
+			buffer->Write< f32 >( l.mError );
+		}
+
 		return Result::SUCCESS;
 	}
 
@@ -380,14 +740,58 @@ struct struct_name {\
 	{
 		// Release previous data ( if any )
 		Release( );
+		mVertexData.Reset( );
+		mIndexData.Reset( );
 
-		// Need to be able to read back original buffer from the buffer passed in
+		// Submeshes cached before cooking start with their vertex data size and have no indices
 		u32 byteSize = buffer->Read< u32 >( );
+		bool hasLODs = ( byteSize == ENJON_SUBMESH_LOD_MAGIC );
+		bool indexed = ( byteSize == ENJON_SUBMESH_INDEXED_MAGIC || hasLODs );
+		if ( indexed )
+		{
+			byteSize = buffer->Read< u32 >( );
+		}
+
+		Vector< u8 > bytes( byteSize );
+		if ( !buffer->ReadBytes( bytes.data( ), byteSize ) )
+		{
+			return Result::FAILURE;
+		}
+		mVertexData.WriteBytes( bytes.data( ), byteSize );
 
-		// God...this is horrible, but it should work
-		for ( u32 i = 0; i < byteSize; ++i )
+		mIndexSize = 0;
+		if ( indexed )
 		{
-			mVertexData.Write< u8 >( buffer->Read< u8 >( ) );
+			mIndexSize = buffer->Read< u32 >( );
+			u32 indexBytes = buffer->Read< u32 >( );
+
+			bytes.resize( indexBytes );
+			if ( !buffer->ReadBytes( bytes.data( ), indexBytes ) )
+			{
+				return Result::FAILURE;
+			}
+			mIndexData.WriteBytes( bytes.data( ), indexBytes );
+		}
+
+		mLODs.clear( );
+		if ( hasLODs )
+		{
+			u32 lodCount = buffer->Read< u32 >( );
+			for ( u32 i = 0; i < lodCount; ++i )
+			{
+				SubMeshLOD l;
+				l.mIndexOffset = buffer->Read< u32 >( );
+				l.mIndexCount = buffer->Read< u32 >( );
+				l.mError = buffer->Read< f32 >( );
+				mLODs.push_back( l );
+			}
+		}
+		// Indexed submeshes cached before levels of detail have just the one
+		else if ( indexed && mIndexSize )
+		{
+			SubMeshLOD l;
+			l.mIndexCount = mIndexData.GetSize( ) / mIndexSize;
+			mLODs.push_back( l );
 		}
 
 		// If owning mesh doesn't exit, then return failure
@@ -402,12 +806,37 @@ struct struct_name {\
 		// Set draw type
 		mDrawType = GL_TRIANGLES;
 		// Set draw count
-		mDrawCount = mVertexData.GetSize( ) / vertDecl.GetSizeInBytes( );
+		if ( !mLODs.empty( ) )
+		{
+			mDrawCount = mLODs[ 0 ].mIndexCount;
+		}
+		else
+		{
+			mDrawCount = mIndexSize ? mIndexData.GetSize( ) / mIndexSize : mVertexData.GetSize( ) / vertDecl.GetSizeInBytes( );
+		}
+
+		// Vertex data is uploaded by owning mesh's DeserializeLateInit, since this can be run on a worker thread
+		return Result::SUCCESS;
+	}
+
+	//=========================================================================
+
+	Result SubMesh::UploadVertexData( )
+	{
+		// If owning mesh doesn't exit, then return failure
+		if ( !mMesh )
+		{
+			return Result::FAILURE;
+		} 
+
+		// Get vertex data decl from owning mesh
+		const VertexDataDeclaration& vertDecl = mMesh->GetVertexDeclaration( );
 
 		// Create and upload mesh data
 		glGenBuffers( 1, &mVBO );
 		glBindBuffer( GL_ARRAY_BUFFER, mVBO );
 		glBufferData( GL_ARRAY_BUFFER, mVertexData.GetSize( ), mVertexData.GetData( ), GL_STATIC_DRAW );
+		GPUMemoryTracker::Track( GPUResourceType::Buffer, mVBO, mVertexData.GetSize( ), "Meshes", mMesh->GetName( ) );
  
 		glGenVertexArrays( 1, &mVAO );
 		glBindVertexArray( mVAO ); 
@@ -466,9 +895,44 @@ struct struct_name {\
 				{
 					glVertexAttribIPointer( i, 1, GL_UNSIGNED_INT, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset(i)) );
 				} break;
+
+				// Quantized formats are normalized on fetch, decoding past that is done by the shader
+				case VertexAttributeFormat::UNorm16x4:
+				{
+					glVertexAttribPointer( i, 4, GL_UNSIGNED_SHORT, GL_TRUE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset(i)) );
+				} break;
+
+				case VertexAttributeFormat::SNorm16x2:
+				{
+					glVertexAttribPointer( i, 2, GL_SHORT, GL_TRUE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset(i)) );
+				} break;
+
+				case VertexAttributeFormat::UNorm16x2:
+				{
+					glVertexAttribPointer( i, 2, GL_UNSIGNED_SHORT, GL_TRUE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset(i)) );
+				} break;
+
+				case VertexAttributeFormat::Half2:
+				{
+					glVertexAttribPointer( i, 2, GL_HALF_FLOAT, GL_FALSE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset(i)) );
+				} break;
+
+				case VertexAttributeFormat::UNorm8x4:
+				{
+					glVertexAttribPointer( i, 4, GL_UNSIGNED_BYTE, GL_TRUE, vertexDeclSize, Int2VoidP(vertDecl.GetByteOffset(i)) );
+				} break;
 			}
 		} 
 
+		// Element buffer binding is part of the VAO's state, so has to be bound while it is
+		if ( mIndexSize && mIndexData.GetSize( ) )
+		{
+			glGenBuffers( 1, &mIBO );
+			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, mIBO );
+			glBufferData( GL_ELEMENT_ARRAY_BUFFER, mIndexData.GetSize( ), mIndexData.GetData( ), GL_STATIC_DRAW );
+			GPUMemoryTracker::Track( GPUResourceType::Buffer, mIBO, mIndexData.GetSize( ), "Meshes", mMesh->GetName( ) );
+		}
+
 		// Unbind mVAO
 		glBindVertexArray( 0 ); 
 
@@ -0,0 +1,1349 @@
+// @file MeshOptimizer.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/Mesh.h"
+#include "Utils/Hash.h"
+
+#include <math.h>
+#include <float.h>
+#include <string.h>
+#include <algorithm>
+
+// Tuning from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+#define ENJON_MESH_CACHE_DECAY_POWER		1.5f
+#define ENJON_MESH_LAST_TRIANGLE_SCORE		0.75f
+#define ENJON_MESH_VALENCE_BOOST_SCALE		2.0f
+#define ENJON_MESH_VALENCE_BOOST_POWER		0.5f
+
+// FIFO cache size used to find where triangle order starts cold when clustering for overdraw
+#define ENJON_MESH_OVERDRAW_CACHE_SIZE		16
+
+#define ENJON_MESH_INVALID_INDEX			0xFFFFFFFF
+
+// Most joint weights per vertex that can be renormalized together when quantizing
+#define ENJON_MESH_MAX_QUANTIZED_WEIGHTS	16
+
+// Levels of detail aren't made with fewer triangles than this, or if they keep more than this fraction of previous level
+#define ENJON_MESH_LOD_MIN_TRIANGLES		32
+#define ENJON_MESH_LOD_MAX_KEPT				0.9f
+
+// Collapses cheaper than this factor of the cost needed to reach target are done in the same simplification pass
+#define ENJON_MESH_SIMPLIFY_PASS_COST_SCALE	1.5f
+
+// Collapses that turn a triangle further than this ( cosine ) are rejected, which also keeps them from flipping over
+#define ENJON_MESH_SIMPLIFY_MIN_NORMAL_DOT	0.25f
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL f32 VertexScore( s32 cachePosition, u32 remainingValence )
+	{
+		// No triangles left to use it
+		if ( !remainingValence )
+		{
+			return -1.0f;
+		}
+
+		f32 score = 0.0f;
+		if ( cachePosition >= 0 )
+		{
+			// Vertices of the last triangle get a fixed score so the next one doesn't just reuse the same edge
+			if ( cachePosition < 3 )
+			{
+				score = ENJON_MESH_LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				f32 scaler = 1.0f / ( f32 )( ENJON_MESH_VERTEX_CACHE_SIZE - 3 );
+				score = powf( 1.0f - ( f32 )( cachePosition - 3 ) * scaler, ENJON_MESH_CACHE_DECAY_POWER );
+			}
+		}
+
+		// Favour vertices with few triangles left, so lone triangles don't get stranded
+		score += ENJON_MESH_VALENCE_BOOST_SCALE * powf( ( f32 )remainingValence, -ENJON_MESH_VALENCE_BOOST_POWER );
+
+		return score;
+	}
+
+	//=================================================================
+
+	u32 MeshOptimizer::Deduplicate( const u8* soup, u32 vertexCount, u32 vertexSize, Vector< u8 >* vertices, Vector< u32 >* indices )
+	{
+		vertices->clear( );
+		vertices->reserve( ( usize )vertexCount * vertexSize );
+		indices->resize( vertexCount );
+
+		// Open addressing table of unique vertex ids, at most half full
+		u32 tableSize = 1;
+		while ( tableSize < vertexCount * 2 )
+		{
+			tableSize <<= 1;
+		}
+		Vector< u32 > table( tableSize, ENJON_MESH_INVALID_INDEX );
+
+		u32 uniqueCount = 0;
+		for ( u32 i = 0; i < vertexCount; ++i )
+		{
+			const u8* vertex = soup + ( usize )i * vertexSize;
+			u32 slot = ( u32 )Utils::HashBytes( vertex, vertexSize ) & ( tableSize - 1 );
+
+			while ( true )
+			{
+				u32 id = table[ slot ];
+				if ( id == ENJON_MESH_INVALID_INDEX )
+				{
+					table[ slot ] = uniqueCount;
+					vertices->insert( vertices->end( ), vertex, vertex + vertexSize );
+					( *indices )[ i ] = uniqueCount++;
+					break;
+				}
+
+				if ( memcmp( vertices->data( ) + ( usize )id * vertexSize, vertex, vertexSize ) == 0 )
+				{
+					( *indices )[ i ] = id;
+					break;
+				}
+
+				slot = ( slot + 1 ) & ( tableSize - 1 );
+			}
+		}
+
+		return uniqueCount;
+	}
+
+	//=================================================================
+
+	void MeshOptimizer::OptimizeVertexCache( u32* indices, u32 indexCount, u32 vertexCount )
+	{
+		u32 triangleCount = indexCount / 3;
+		if ( triangleCount < 2 )
+		{
+			return;
+		}
+
+		// Triangles using each vertex, packed into one array. Used triangles are swapped to the end of each vertex's range.
+		Vector< u32 > valence( vertexCount, 0 );
+		for ( u32 i = 0; i < triangleCount * 3; ++i )
+		{
+			valence[ indices[ i ] ]++;
+		}
+
+		Vector< u32 > adjacencyOffset( vertexCount + 1, 0 );
+		for ( u32 v = 0; v < vertexCount; ++v )
+		{
+			adjacencyOffset[ v + 1 ] = adjacencyOffset[ v ] + valence[ v ];
+		}
+
+		Vector< u32 > adjacency( triangleCount * 3 );
+		Vector< u32 > fill( adjacencyOffset.begin( ), adjacencyOffset.end( ) - 1 );
+		for ( u32 t = 0; t < triangleCount; ++t )
+		{
+			for ( u32 k = 0; k < 3; ++k )
+			{
+				adjacency[ fill[ indices[ t * 3 + k ] ]++ ] = t;
+			}
+		}
+
+		Vector< s32 > cachePosition( vertexCount, -1 );
+		Vector< f32 > vertexScore( vertexCount );
+		for ( u32 v = 0; v < vertexCount; ++v )
+		{
+			vertexScore[ v ] = VertexScore( -1, valence[ v ] );
+		}
+
+		// Start from the triangle with the most isolated vertices
+		u32 bestTriangle = 0;
+		f32 bestStartScore = -1.0f;
+		for ( u32 t = 0; t < triangleCount; ++t )
+		{
+			f32 score = vertexScore[ indices[ t * 3 ] ] + vertexScore[ indices[ t * 3 + 1 ] ] + vertexScore[ indices[ t * 3 + 2 ] ];
+			if ( score > bestStartScore )
+			{
+				bestStartScore = score;
+				bestTriangle = t;
+			}
+		}
+
+		Vector< u8 > emitted( triangleCount, 0 );
+
+		Vector< u32 > output;
+		output.reserve( triangleCount * 3 );
+
+		// Cache holds the simulated cache plus room for the three vertices pushed past its end
+		u32 cache[ ENJON_MESH_VERTEX_CACHE_SIZE + 3 ];
+		u32 cacheCount = 0;
+
+		u32 cursor = 0;
+
+		for ( u32 emittedCount = 0; emittedCount < triangleCount; ++emittedCount )
+		{
+			// Nothing in the cache scored, so start over from the next unused triangle
+			if ( bestTriangle == ENJON_MESH_INVALID_INDEX )
+			{
+				while ( emitted[ cursor ] )
+				{
+					++cursor;
+				}
+				bestTriangle = cursor;
+			}
+
+			const u32* tri = indices + bestTriangle * 3;
+			output.insert( output.end( ), tri, tri + 3 );
+			emitted[ bestTriangle ] = 1;
+
+			// Remove triangle from its vertices' remaining triangles
+			for ( u32 k = 0; k < 3; ++k )
+			{
+				u32 v = tri[ k ];
+				u32* begin = adjacency.data( ) + adjacencyOffset[ v ];
+				u32* end = begin + valence[ v ];
+				u32* found = std::find( begin, end, bestTriangle );
+				if ( found != end )
+				{
+					std::swap( *found, *( end - 1 ) );
+					valence[ v ]--;
+				}
+			}
+
+			// Triangle's vertices move to the front of the cache
+			u32 newCache[ ENJON_MESH_VERTEX_CACHE_SIZE + 3 ];
+			u32 newCount = 0;
+			for ( u32 k = 0; k < 3; ++k )
+			{
+				newCache[ newCount++ ] = tri[ k ];
+			}
+			for ( u32 c = 0; c < cacheCount; ++c )
+			{
+				u32 v = cache[ c ];
+				if ( v != tri[ 0 ] && v != tri[ 1 ] && v != tri[ 2 ] )
+				{
+					newCache[ newCount++ ] = v;
+				}
+			}
+
+			// Rescore everything in the cache, including vertices that just fell out of it
+			for ( u32 c = 0; c < newCount; ++c )
+			{
+				u32 v = newCache[ c ];
+				cachePosition[ v ] = ( c < ENJON_MESH_VERTEX_CACHE_SIZE ) ? ( s32 )c : -1;
+				vertexScore[ v ] = VertexScore( cachePosition[ v ], valence[ v ] );
+			}
+
+			// Best triangle is picked from those touching the cache
+			bestTriangle = ENJON_MESH_INVALID_INDEX;
+			f32 bestScore = -1.0f;
+			for ( u32 c = 0; c < newCount; ++c )
+			{
+				u32 v = newCache[ c ];
+				const u32* adj = adjacency.data( ) + adjacencyOffset[ v ];
+				for ( u32 a = 0; a < valence[ v ]; ++a )
+				{
+					u32 t = adj[ a ];
+					f32 score = vertexScore[ indices[ t * 3 ] ] + vertexScore[ indices[ t * 3 + 1 ] ] + vertexScore[ indices[ t * 3 + 2 ] ];
+					if ( score > bestScore )
+					{
+						bestScore = score;
+						bestTriangle = t;
+					}
+				}
+			}
+
+			cacheCount = std::min( newCount, ( u32 )ENJON_MESH_VERTEX_CACHE_SIZE );
+			memcpy( cache, newCache, cacheCount * sizeof( u32 ) );
+		}
+
+		memcpy( indices, output.data( ), output.size( ) * sizeof( u32 ) );
+	}
+
+	//=================================================================
+
+	void MeshOptimizer::OptimizeOverdraw( u32* indices, u32 indexCount, const u8* vertices, u32 vertexSize, u32 vertexCount )
+	{
+		u32 triangleCount = indexCount / 3;
+		if ( triangleCount < 2 )
+		{
+			return;
+		}
+
+		auto position = [ & ]( u32 v ) -> const f32*
+		{
+			return ( const f32* )( vertices + ( usize )v * vertexSize );
+		};
+
+		// Split into clusters wherever every vertex of a triangle misses a FIFO cache. Reordering whole clusters
+		// only moves those cold starts around, so doesn't cost any cache efficiency.
+		Vector< u32 > clusterStart;
+		{
+			Vector< u32 > timestamp( vertexCount, 0 );
+			u32 time = ENJON_MESH_OVERDRAW_CACHE_SIZE + 1;
+			for ( u32 t = 0; t < triangleCount; ++t )
+			{
+				u32 misses = 0;
+				for ( u32 k = 0; k < 3; ++k )
+				{
+					u32 v = indices[ t * 3 + k ];
+					if ( time - timestamp[ v ] > ENJON_MESH_OVERDRAW_CACHE_SIZE )
+					{
+						timestamp[ v ] = time++;
+						misses++;
+					}
+				}
+
+				if ( t == 0 || misses == 3 )
+				{
+					clusterStart.push_back( t );
+				}
+			}
+		}
+
+		u32 clusterCount = ( u32 )clusterStart.size( );
+		if ( clusterCount < 2 )
+		{
+			return;
+		}
+		clusterStart.push_back( triangleCount );
+
+		// Area weighted centroid and normal of each cluster, and of the whole mesh
+		Vector< f32 > clusterData( clusterCount * 6, 0.0f );
+		f32 meshCentroid[ 3 ] = { 0.0f, 0.0f, 0.0f };
+		f32 meshArea = 0.0f;
+
+		for ( u32 c = 0; c < clusterCount; ++c )
+		{
+			f32* centroid = &clusterData[ c * 6 ];
+			f32* normal = &clusterData[ c * 6 + 3 ];
+			f32 clusterArea = 0.0f;
+
+			for ( u32 t = clusterStart[ c ]; t < clusterStart[ c + 1 ]; ++t )
+			{
+				const f32* p0 = position( indices[ t * 3 ] );
+				const f32* p1 = position( indices[ t * 3 + 1 ] );
+				const f32* p2 = position( indices[ t * 3 + 2 ] );
+
+				f32 e0[ 3 ] = { p1[ 0 ] - p0[ 0 ], p1[ 1 ] - p0[ 1 ], p1[ 2 ] - p0[ 2 ] };
+				f32 e1[ 3 ] = { p2[ 0 ] - p0[ 0 ], p2[ 1 ] - p0[ 1 ], p2[ 2 ] - p0[ 2 ] };
+				f32 n[ 3 ] = { e0[ 1 ] * e1[ 2 ] - e0[ 2 ] * e1[ 1 ], e0[ 2 ] * e1[ 0 ] - e0[ 0 ] * e1[ 2 ], e0[ 0 ] * e1[ 1 ] - e0[ 1 ] * e1[ 0 ] };
+				f32 area = sqrtf( n[ 0 ] * n[ 0 ] + n[ 1 ] * n[ 1 ] + n[ 2 ] * n[ 2 ] );
+
+				for ( u32 k = 0; k < 3; ++k )
+				{
+					f32 center = ( p0[ k ] + p1[ k ] + p2[ k ] ) / 3.0f;
+					centroid[ k ] += center * area;
+					meshCentroid[ k ] += center * area;
+					normal[ k ] += n[ k ];
+				}
+
+				clusterArea += area;
+			}
+
+			if ( clusterArea > 0.0f )
+			{
+				for ( u32 k = 0; k < 3; ++k )
+				{
+					centroid[ k ] /= clusterArea;
+				}
+			}
+
+			meshArea += clusterArea;
+		}
+
+		if ( meshArea > 0.0f )
+		{
+			for ( u32 k = 0; k < 3; ++k )
+			{
+				meshCentroid[ k ] /= meshArea;
+			}
+		}
+
+		// Clusters facing away from the center of the mesh are likely to be in front of the rest, so draw them first
+		Vector< f32 > sortKey( clusterCount );
+		Vector< u32 > order( clusterCount );
+		for ( u32 c = 0; c < clusterCount; ++c )
+		{
+			const f32* centroid = &clusterData[ c * 6 ];
+			const f32* normal = &clusterData[ c * 6 + 3 ];
+			f32 length = sqrtf( normal[ 0 ] * normal[ 0 ] + normal[ 1 ] * normal[ 1 ] + normal[ 2 ] * normal[ 2 ] );
+
+			f32 key = 0.0f;
+			if ( length > 0.0f )
+			{
+				for ( u32 k = 0; k < 3; ++k )
+				{
+					key += ( centroid[ k ] - meshCentroid[ k ] ) * normal[ k ] / length;
+				}
+			}
+
+			sortKey[ c ] = key;
+			order[ c ] = c;
+		}
+
+		std::stable_sort( order.begin( ), order.end( ), [ & ]( u32 a, u32 b ) { return sortKey[ a ] > sortKey[ b ]; } );
+
+		Vector< u32 > output;
+		output.reserve( triangleCount * 3 );
+		for ( auto& c : order )
+		{
+			output.insert( output.end( ), indices + clusterStart[ c ] * 3, indices + clusterStart[ c + 1 ] * 3 );
+		}
+
+		memcpy( indices, output.data( ), output.size( ) * sizeof( u32 ) );
+	}
+
+	//=================================================================
+
+	u32 MeshOptimizer::OptimizeVertexFetch( u8* vertices, u32 vertexCount, u32 vertexSize, u32* indices, u32 indexCount )
+	{
+		Vector< u32 > remap( vertexCount, ENJON_MESH_INVALID_INDEX );
+		Vector< u8 > reordered;
+		reordered.reserve( ( usize )vertexCount * vertexSize );
+
+		u32 nextVertex = 0;
+		for ( u32 i = 0; i < indexCount; ++i )
+		{
+			u32 v = indices[ i ];
+			if ( remap[ v ] == ENJON_MESH_INVALID_INDEX )
+			{
+				const u8* vertex = vertices + ( usize )v * vertexSize;
+				reordered.insert( reordered.end( ), vertex, vertex + vertexSize );
+				remap[ v ] = nextVertex++;
+			}
+			indices[ i ] = remap[ v ];
+		}
+
+		memcpy( vertices, reordered.data( ), reordered.size( ) );
+
+		return nextVertex;
+	}
+
+	//=================================================================
+
+	Result MeshOptimizer::CookSubMesh( SubMesh* subMesh, const VertexDataDeclaration& decl )
+	{
+		u32 vertexSize = ( u32 )decl.GetSizeInBytes( );
+		if ( !subMesh || !vertexSize )
+		{
+			return Result::FAILURE;
+		}
+
+		// Any trailing partial triangle can't be drawn anyway
+		u32 soupCount = subMesh->mVertexData.GetSize( ) / vertexSize;
+		u32 indexCount = soupCount - soupCount % 3;
+		if ( !indexCount )
+		{
+			return Result::SUCCESS;
+		}
+
+		Vector< u8 > vertices;
+		Vector< u32 > indices;
+		u32 vertexCount = Deduplicate( subMesh->mVertexData.GetData( ), indexCount, vertexSize, &vertices, &indices );
+
+		OptimizeVertexCache( indices.data( ), indexCount, vertexCount );
+
+		if ( !decl.mDecl.empty( ) && ( decl.mDecl[ 0 ] == VertexAttributeFormat::Float3 || decl.mDecl[ 0 ] == VertexAttributeFormat::Float4 ) )
+		{
+			OptimizeOverdraw( indices.data( ), indexCount, vertices.data( ), vertexSize, vertexCount );
+		}
+
+		vertexCount = OptimizeVertexFetch( vertices.data( ), vertexCount, vertexSize, indices.data( ), indexCount );
+
+		subMesh->mVertexData.Reset( );
+		subMesh->mVertexData.WriteBytes( vertices.data( ), vertexCount * vertexSize );
+
+		// Smallest index type that can address every vertex
+		subMesh->mIndexData.Reset( );
+		if ( vertexCount <= 0xFFFF )
+		{
+			Vector< u16 > shortIndices( indices.begin( ), indices.end( ) );
+			subMesh->mIndexSize = sizeof( u16 );
+			subMesh->mIndexData.WriteBytes( ( const u8* )shortIndices.data( ), indexCount * sizeof( u16 ) );
+		}
+		else
+		{
+			subMesh->mIndexSize = sizeof( u32 );
+			subMesh->mIndexData.WriteBytes( ( const u8* )indices.data( ), indexCount * sizeof( u32 ) );
+		}
+
+		subMesh->mDrawType = GL_TRIANGLES;
+		subMesh->mDrawCount = indexCount;
+
+		// Just the full detail level until more are generated
+		subMesh->mLODs.clear( );
+		SubMeshLOD lod;
+		lod.mIndexCount = indexCount;
+		subMesh->mLODs.push_back( lod );
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Sum of squared distances to planes, weighted by area of triangles they came from
+	*/
+	struct Quadric
+	{
+		f64 mA00 = 0.0, mA01 = 0.0, mA02 = 0.0, mA11 = 0.0, mA12 = 0.0, mA22 = 0.0;
+		f64 mB0 = 0.0, mB1 = 0.0, mB2 = 0.0;
+		f64 mC = 0.0;
+		f64 mWeight = 0.0;
+	};
+
+	//=================================================================
+
+	struct EdgeCollapse
+	{
+		u32 mFrom;
+		u32 mTo;
+		f32 mCost;
+	};
+
+	//=================================================================
+
+	INTERNAL void QuadricAdd( Quadric* q, const Quadric& other )
+	{
+		q->mA00 += other.mA00; q->mA01 += other.mA01; q->mA02 += other.mA02;
+		q->mA11 += other.mA11; q->mA12 += other.mA12; q->mA22 += other.mA22;
+		q->mB0 += other.mB0; q->mB1 += other.mB1; q->mB2 += other.mB2;
+		q->mC += other.mC;
+		q->mWeight += other.mWeight;
+	}
+
+	//=================================================================
+
+	INTERNAL Quadric QuadricFromTriangle( const f32* p0, const f32* p1, const f32* p2 )
+	{
+		f64 e0[ 3 ] = { p1[ 0 ] - p0[ 0 ], p1[ 1 ] - p0[ 1 ], p1[ 2 ] - p0[ 2 ] };
+		f64 e1[ 3 ] = { p2[ 0 ] - p0[ 0 ], p2[ 1 ] - p0[ 1 ], p2[ 2 ] - p0[ 2 ] };
+		f64 n[ 3 ] = { e0[ 1 ] * e1[ 2 ] - e0[ 2 ] * e1[ 1 ], e0[ 2 ] * e1[ 0 ] - e0[ 0 ] * e1[ 2 ], e0[ 0 ] * e1[ 1 ] - e0[ 1 ] * e1[ 0 ] };
+
+		Quadric q;
+		f64 length = sqrt( n[ 0 ] * n[ 0 ] + n[ 1 ] * n[ 1 ] + n[ 2 ] * n[ 2 ] );
+		if ( length == 0.0 )
+		{
+			return q;
+		}
+
+		n[ 0 ] /= length;
+		n[ 1 ] /= length;
+		n[ 2 ] /= length;
+		f64 d = -( n[ 0 ] * p0[ 0 ] + n[ 1 ] * p0[ 1 ] + n[ 2 ] * p0[ 2 ] );
+		f64 w = 0.5 * length;
+
+		q.mA00 = w * n[ 0 ] * n[ 0 ]; q.mA01 = w * n[ 0 ] * n[ 1 ]; q.mA02 = w * n[ 0 ] * n[ 2 ];
+		q.mA11 = w * n[ 1 ] * n[ 1 ]; q.mA12 = w * n[ 1 ] * n[ 2 ]; q.mA22 = w * n[ 2 ] * n[ 2 ];
+		q.mB0 = w * n[ 0 ] * d; q.mB1 = w * n[ 1 ] * d; q.mB2 = w * n[ 2 ] * d;
+		q.mC = w * d * d;
+		q.mWeight = w;
+
+		return q;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Area weighted mean squared distance of point to quadric's planes
+	*/
+	INTERNAL f32 QuadricError( const Quadric& a, const Quadric& b, const f32* p )
+	{
+		f64 x = p[ 0 ], y = p[ 1 ], z = p[ 2 ];
+		f64 a00 = a.mA00 + b.mA00, a01 = a.mA01 + b.mA01, a02 = a.mA02 + b.mA02;
+		f64 a11 = a.mA11 + b.mA11, a12 = a.mA12 + b.mA12, a22 = a.mA22 + b.mA22;
+		f64 weight = a.mWeight + b.mWeight;
+
+		f64 e = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * ( a01 * x * y + a02 * x * z + a12 * y * z );
+		e += 2.0 * ( ( a.mB0 + b.mB0 ) * x + ( a.mB1 + b.mB1 ) * y + ( a.mB2 + b.mB2 ) * z );
+		e += a.mC + b.mC;
+
+		return weight > 0.0 ? ( f32 )std::max( e / weight, 0.0 ) : 0.0f;
+	}
+
+	//=================================================================
+
+	INTERNAL void TriangleNormal( const f32* p0, const f32* p1, const f32* p2, f32* n )
+	{
+		f32 e0[ 3 ] = { p1[ 0 ] - p0[ 0 ], p1[ 1 ] - p0[ 1 ], p1[ 2 ] - p0[ 2 ] };
+		f32 e1[ 3 ] = { p2[ 0 ] - p0[ 0 ], p2[ 1 ] - p0[ 1 ], p2[ 2 ] - p0[ 2 ] };
+		n[ 0 ] = e0[ 1 ] * e1[ 2 ] - e0[ 2 ] * e1[ 1 ];
+		n[ 1 ] = e0[ 2 ] * e1[ 0 ] - e0[ 0 ] * e1[ 2 ];
+		n[ 2 ] = e0[ 0 ] * e1[ 1 ] - e0[ 1 ] * e1[ 0 ];
+	}
+
+	//=================================================================
+
+	u32 MeshOptimizer::Simplify( u32* indices, u32 indexCount, const u8* vertices, u32 vertexCount, u32 vertexSize, u32 targetIndexCount, f32* error )
+	{
+		*error = 0.0f;
+
+		auto position = [ & ] ( u32 v ) { return ( const f32* )( vertices + ( usize )v * vertexSize ); };
+
+		// Vertices sharing a position are split along uv or normal seams. They're kept, so seams don't tear.
+		Vector< u32 > canonical( vertexCount );
+		Vector< u8 > locked( vertexCount, 0 );
+		{
+			Vector< u32 > sorted( vertexCount );
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				sorted[ v ] = v;
+			}
+
+			std::sort( sorted.begin( ), sorted.end( ), [ & ] ( u32 a, u32 b )
+			{
+				const f32* pa = position( a );
+				const f32* pb = position( b );
+				return std::lexicographical_compare( pa, pa + 3, pb, pb + 3 );
+			} );
+
+			for ( u32 i = 0; i < vertexCount; )
+			{
+				u32 end = i + 1;
+				while ( end < vertexCount && memcmp( position( sorted[ i ] ), position( sorted[ end ] ), 3 * sizeof( f32 ) ) == 0 )
+				{
+					++end;
+				}
+
+				for ( u32 j = i; j < end; ++j )
+				{
+					canonical[ sorted[ j ] ] = sorted[ i ];
+					locked[ sorted[ j ] ] = ( end - i > 1 );
+				}
+
+				i = end;
+			}
+		}
+
+		// Edges not shared by exactly two triangles are borders or non manifold, and are kept as well
+		{
+			HashMap< u64, u32 > edgeUses;
+			for ( u32 i = 0; i < indexCount; ++i )
+			{
+				u32 a = canonical[ indices[ i ] ];
+				u32 b = canonical[ indices[ i - i % 3 + ( i + 1 ) % 3 ] ];
+				edgeUses[ ( ( u64 )std::min( a, b ) << 32 ) | std::max( a, b ) ]++;
+			}
+
+			for ( u32 i = 0; i < indexCount; ++i )
+			{
+				u32 a = canonical[ indices[ i ] ];
+				u32 b = canonical[ indices[ i - i % 3 + ( i + 1 ) % 3 ] ];
+				if ( edgeUses[ ( ( u64 )std::min( a, b ) << 32 ) | std::max( a, b ) ] != 2 )
+				{
+					locked[ a ] = locked[ b ] = 1;
+				}
+			}
+		}
+
+		// Quadrics are kept per position, so seam vertices see planes from both sides
+		Vector< Quadric > quadrics( vertexCount );
+		for ( u32 i = 0; i < indexCount; i += 3 )
+		{
+			Quadric q = QuadricFromTriangle( position( indices[ i ] ), position( indices[ i + 1 ] ), position( indices[ i + 2 ] ) );
+			for ( u32 k = 0; k < 3; ++k )
+			{
+				QuadricAdd( &quadrics[ canonical[ indices[ i + k ] ] ], q );
+			}
+		}
+
+		Vector< u32 > adjacencyOffsets( vertexCount + 1 );
+		Vector< u32 > adjacency;
+		Vector< f32 > bestCost( vertexCount );
+		Vector< u32 > bestTarget( vertexCount );
+		Vector< EdgeCollapse > candidates;
+		Vector< u32 > collapse( vertexCount );
+		Vector< u8 > touched( vertexCount );
+
+		while ( indexCount > targetIndexCount )
+		{
+			// Triangles around each vertex
+			std::fill( adjacencyOffsets.begin( ), adjacencyOffsets.end( ), 0 );
+			for ( u32 i = 0; i < indexCount; ++i )
+			{
+				adjacencyOffsets[ indices[ i ] + 1 ]++;
+			}
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				adjacencyOffsets[ v + 1 ] += adjacencyOffsets[ v ];
+			}
+
+			adjacency.resize( indexCount );
+			{
+				Vector< u32 > fill( adjacencyOffsets.begin( ), adjacencyOffsets.end( ) - 1 );
+				for ( u32 i = 0; i < indexCount; ++i )
+				{
+					adjacency[ fill[ indices[ i ] ]++ ] = i / 3;
+				}
+			}
+
+			// Cheapest collapse of each unlocked vertex onto one of its neighbours
+			std::fill( bestCost.begin( ), bestCost.end( ), FLT_MAX );
+			std::fill( bestTarget.begin( ), bestTarget.end( ), ENJON_MESH_INVALID_INDEX );
+			for ( u32 i = 0; i < indexCount; ++i )
+			{
+				u32 a = indices[ i ];
+				u32 b = indices[ i - i % 3 + ( i + 1 ) % 3 ];
+
+				for ( u32 k = 0; k < 2; ++k )
+				{
+					u32 from = k ? b : a;
+					u32 to = k ? a : b;
+					if ( locked[ from ] )
+					{
+						continue;
+					}
+
+					f32 cost = QuadricError( quadrics[ canonical[ from ] ], quadrics[ canonical[ to ] ], position( to ) );
+					if ( cost < bestCost[ from ] )
+					{
+						bestCost[ from ] = cost;
+						bestTarget[ from ] = to;
+					}
+				}
+			}
+
+			candidates.clear( );
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				if ( bestTarget[ v ] != ENJON_MESH_INVALID_INDEX )
+				{
+					candidates.push_back( { v, bestTarget[ v ], bestCost[ v ] } );
+				}
+			}
+
+			if ( candidates.empty( ) )
+			{
+				break;
+			}
+
+			std::sort( candidates.begin( ), candidates.end( ), [ ] ( const EdgeCollapse& a, const EdgeCollapse& b ) { return a.mCost < b.mCost; } );
+
+			// Each collapse removes about two triangles. Only ones close in cost to what's needed are done per pass, 
+			// so collapses stay close to globally cheapest first.
+			u32 triangleCount = indexCount / 3;
+			u32 targetTriangleCount = targetIndexCount / 3;
+			u32 goal = std::min( ( triangleCount - targetTriangleCount ) / 2 + 1, ( u32 )candidates.size( ) );
+			f32 costLimit = candidates[ goal - 1 ].mCost * ENJON_MESH_SIMPLIFY_PASS_COST_SCALE;
+
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				collapse[ v ] = v;
+			}
+			std::fill( touched.begin( ), touched.end( ), 0 );
+
+			u32 removed = 0;
+			u32 collapses = 0;
+			for ( auto& c : candidates )
+			{
+				if ( c.mCost > costLimit || triangleCount - removed <= targetTriangleCount )
+				{
+					break;
+				}
+
+				// Triangles around an edge are only changed once per pass, so adjacency stays valid
+				if ( touched[ c.mFrom ] || touched[ c.mTo ] )
+				{
+					continue;
+				}
+
+				// Reject collapses that would turn a triangle too far or flip it over
+				bool flips = false;
+				u32 degenerate = 0;
+				for ( u32 k = adjacencyOffsets[ c.mFrom ]; k < adjacencyOffsets[ c.mFrom + 1 ] && !flips; ++k )
+				{
+					const u32* tri = indices + adjacency[ k ] * 3;
+					if ( tri[ 0 ] == c.mTo || tri[ 1 ] == c.mTo || tri[ 2 ] == c.mTo )
+					{
+						degenerate++;
+						continue;
+					}
+
+					const f32* p[ 3 ];
+					const f32* moved[ 3 ];
+					for ( u32 j = 0; j < 3; ++j )
+					{
+						p[ j ] = position( tri[ j ] );
+						moved[ j ] = tri[ j ] == c.mFrom ? position( c.mTo ) : p[ j ];
+					}
+
+					f32 before[ 3 ], after[ 3 ];
+					TriangleNormal( p[ 0 ], p[ 1 ], p[ 2 ], before );
+					TriangleNormal( moved[ 0 ], moved[ 1 ], moved[ 2 ], after );
+					f32 dot = before[ 0 ] * after[ 0 ] + before[ 1 ] * after[ 1 ] + before[ 2 ] * after[ 2 ];
+					f32 lengths = sqrtf( ( before[ 0 ] * before[ 0 ] + before[ 1 ] * before[ 1 ] + before[ 2 ] * before[ 2 ] ) * ( after[ 0 ] * after[ 0 ] + after[ 1 ] * after[ 1 ] + after[ 2 ] * after[ 2 ] ) );
+					flips = ( dot <= ENJON_MESH_SIMPLIFY_MIN_NORMAL_DOT * lengths );
+				}
+
+				if ( flips )
+				{
+					continue;
+				}
+
+				collapse[ c.mFrom ] = c.mTo;
+				QuadricAdd( &quadrics[ canonical[ c.mTo ] ], quadrics[ canonical[ c.mFrom ] ] );
+				*error = std::max( *error, sqrtf( c.mCost ) );
+				removed += degenerate;
+				collapses++;
+
+				for ( u32 k = adjacencyOffsets[ c.mFrom ]; k < adjacencyOffsets[ c.mFrom + 1 ]; ++k )
+				{
+					const u32* tri = indices + adjacency[ k ] * 3;
+					touched[ tri[ 0 ] ] = touched[ tri[ 1 ] ] = touched[ tri[ 2 ] ] = 1;
+				}
+			}
+
+			if ( !collapses )
+			{
+				break;
+			}
+
+			// Apply collapses, dropping triangles that lost an edge
+			u32 write = 0;
+			for ( u32 i = 0; i < indexCount; i += 3 )
+			{
+				u32 a = collapse[ indices[ i ] ];
+				u32 b = collapse[ indices[ i + 1 ] ];
+				u32 c = collapse[ indices[ i + 2 ] ];
+				if ( a != b && b != c && a != c )
+				{
+					indices[ write++ ] = a;
+					indices[ write++ ] = b;
+					indices[ write++ ] = c;
+				}
+			}
+
+			indexCount = write;
+		}
+
+		return indexCount;
+	}
+
+	//=================================================================
+
+	Result MeshOptimizer::GenerateLODs( SubMesh* subMesh, const VertexDataDeclaration& decl, u32 lodCount, f32 reduction )
+	{
+		u32 vertexSize = ( u32 )decl.GetSizeInBytes( );
+		if ( !subMesh || !vertexSize || !subMesh->IsIndexed( ) || decl.mDecl.empty( ) || 
+			( decl.mDecl[ 0 ] != VertexAttributeFormat::Float3 && decl.mDecl[ 0 ] != VertexAttributeFormat::Float4 ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Every level is simplified from the full detail one, so errors are measured against original surface
+		u32 indexSize = subMesh->mIndexSize;
+		u32 baseCount = subMesh->mLODs.empty( ) ? subMesh->mIndexData.GetSize( ) / indexSize : subMesh->mLODs[ 0 ].mIndexCount;
+		Vector< u32 > base( baseCount );
+		for ( u32 i = 0; i < baseCount; ++i )
+		{
+			const u8* index = subMesh->mIndexData.GetData( ) + ( usize )i * indexSize;
+			base[ i ] = ( indexSize == sizeof( u16 ) ) ? *( const u16* )index : *( const u32* )index;
+		}
+
+		u32 vertexCount = subMesh->mVertexData.GetSize( ) / vertexSize;
+		Vector< Vector< u32 > > levels( 1, base );
+		Vector< f32 > errors( 1, 0.0f );
+		for ( u32 l = 1; l < lodCount; ++l )
+		{
+			u32 previousCount = ( u32 )levels.back( ).size( );
+			u32 targetCount = ( u32 )( ( f32 )( previousCount / 3 ) * reduction ) * 3;
+			if ( targetCount / 3 < ENJON_MESH_LOD_MIN_TRIANGLES )
+			{
+				break;
+			}
+
+			Vector< u32 > lod = base;
+			f32 error = 0.0f;
+			u32 count = Simplify( lod.data( ), baseCount, subMesh->mVertexData.GetData( ), vertexCount, vertexSize, targetCount, &error );
+			if ( ( f32 )count > ( f32 )previousCount * ENJON_MESH_LOD_MAX_KEPT )
+			{
+				break;
+			}
+
+			lod.resize( count );
+			OptimizeVertexCache( lod.data( ), count, vertexCount );
+
+			levels.push_back( lod );
+			errors.push_back( std::max( errors.back( ), error ) );
+		}
+
+		// All levels go back to back in index data
+		subMesh->mIndexData.Reset( );
+		subMesh->mLODs.clear( );
+		u32 offset = 0;
+		for ( u32 l = 0; l < levels.size( ); ++l )
+		{
+			const Vector< u32 >& level = levels[ l ];
+			if ( indexSize == sizeof( u16 ) )
+			{
+				Vector< u16 > shortIndices( level.begin( ), level.end( ) );
+				subMesh->mIndexData.WriteBytes( ( const u8* )shortIndices.data( ), ( u32 )shortIndices.size( ) * sizeof( u16 ) );
+			}
+			else
+			{
+				subMesh->mIndexData.WriteBytes( ( const u8* )level.data( ), ( u32 )level.size( ) * sizeof( u32 ) );
+			}
+
+			SubMeshLOD lod;
+			lod.mIndexOffset = offset;
+			lod.mIndexCount = ( u32 )level.size( );
+			lod.mError = errors[ l ];
+			subMesh->mLODs.push_back( lod );
+
+			offset += ( u32 )level.size( );
+		}
+
+		subMesh->mDrawCount = subMesh->mLODs[ 0 ].mIndexCount;
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	INTERNAL u16 EncodeUNorm16( f32 value )
+	{
+		value = std::min( std::max( value, 0.0f ), 1.0f );
+		return ( u16 )( value * 65535.0f + 0.5f );
+	}
+
+	//=================================================================
+
+	INTERNAL s16 EncodeSNorm16( f32 value )
+	{
+		value = std::min( std::max( value, -1.0f ), 1.0f );
+		return ( s16 )( value * 32767.0f + ( value >= 0.0f ? 0.5f : -0.5f ) );
+	}
+
+	//=================================================================
+
+	INTERNAL f32 DecodeSNorm16( s16 value )
+	{
+		return std::max( ( f32 )value / 32767.0f, -1.0f );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Converts float to half float bits, rounding to nearest and clamping to largest finite half
+	*/
+	INTERNAL u16 FloatToHalf( f32 value )
+	{
+		u32 bits;
+		memcpy( &bits, &value, sizeof( bits ) );
+
+		u32 sign = ( bits >> 16 ) & 0x8000;
+		s32 exponent = ( s32 )( ( bits >> 23 ) & 0xFF ) - 127 + 15;
+		u32 mantissa = bits & 0x7FFFFF;
+
+		if ( exponent >= 31 )
+		{
+			return ( u16 )( sign | 0x7BFF );
+		}
+
+		// Denormal half, or too small for one
+		if ( exponent <= 0 )
+		{
+			if ( exponent < -10 )
+			{
+				return ( u16 )sign;
+			}
+
+			mantissa |= 0x800000;
+			u32 shift = ( u32 )( 14 - exponent );
+			u32 half = ( mantissa >> shift ) + ( ( mantissa >> ( shift - 1 ) ) & 1 );
+			return ( u16 )( sign | half );
+		}
+
+		u32 half = ( ( u32 )exponent << 10 ) | ( mantissa >> 13 );
+		half += ( mantissa >> 12 ) & 1;
+		return ( u16 )( sign | std::min( half, ( u32 )0x7BFF ) );
+	}
+
+	//=================================================================
+
+	INTERNAL f32 HalfToFloat( u16 half )
+	{
+		f32 sign = ( half & 0x8000 ) ? -1.0f : 1.0f;
+		s32 exponent = ( half >> 10 ) & 0x1F;
+		u32 mantissa = half & 0x3FF;
+
+		if ( !exponent )
+		{
+			return sign * ldexpf( ( f32 )mantissa, -24 );
+		}
+
+		return sign * ldexpf( ( f32 )( mantissa | 0x400 ), exponent - 25 );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Projects direction onto octahedron and folds lower half over upper one. Mirrored by DecodeOctahedral
+	*			in generated vertex shaders.
+	*/
+	INTERNAL void EncodeOctahedral( const f32* v, s16* out )
+	{
+		f32 l1 = fabsf( v[ 0 ] ) + fabsf( v[ 1 ] ) + fabsf( v[ 2 ] );
+		if ( l1 == 0.0f )
+		{
+			out[ 0 ] = out[ 1 ] = 0;
+			return;
+		}
+
+		f32 x = v[ 0 ] / l1;
+		f32 y = v[ 1 ] / l1;
+		if ( v[ 2 ] < 0.0f )
+		{
+			f32 fx = ( 1.0f - fabsf( y ) ) * ( x >= 0.0f ? 1.0f : -1.0f );
+			f32 fy = ( 1.0f - fabsf( x ) ) * ( y >= 0.0f ? 1.0f : -1.0f );
+			x = fx;
+			y = fy;
+		}
+
+		out[ 0 ] = EncodeSNorm16( x );
+		out[ 1 ] = EncodeSNorm16( y );
+	}
+
+	//=================================================================
+
+	INTERNAL void DecodeOctahedral( const s16* encoded, f32* out )
+	{
+		f32 x = DecodeSNorm16( encoded[ 0 ] );
+		f32 y = DecodeSNorm16( encoded[ 1 ] );
+		f32 z = 1.0f - fabsf( x ) - fabsf( y );
+		if ( z < 0.0f )
+		{
+			f32 fx = ( 1.0f - fabsf( y ) ) * ( x >= 0.0f ? 1.0f : -1.0f );
+			f32 fy = ( 1.0f - fabsf( x ) ) * ( y >= 0.0f ? 1.0f : -1.0f );
+			x = fx;
+			y = fy;
+		}
+
+		f32 length = sqrtf( x * x + y * y + z * z );
+		out[ 0 ] = x / length;
+		out[ 1 ] = y / length;
+		out[ 2 ] = z / length;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Distance between unit direction and its octahedral round trip. Zero length vectors don't count.
+	*/
+	INTERNAL f32 OctahedralError( const f32* v )
+	{
+		f32 length = sqrtf( v[ 0 ] * v[ 0 ] + v[ 1 ] * v[ 1 ] + v[ 2 ] * v[ 2 ] );
+		if ( length == 0.0f )
+		{
+			return 0.0f;
+		}
+
+		s16 encoded[ 2 ];
+		f32 decoded[ 3 ];
+		EncodeOctahedral( v, encoded );
+		DecodeOctahedral( encoded, decoded );
+
+		f32 error = 0.0f;
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			f32 d = decoded[ c ] - v[ c ] / length;
+			error += d * d;
+		}
+
+		return sqrtf( error );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Rounds weights to unorm8 so they still sum to exactly 255, handing leftover units to the largest remainders
+	*/
+	INTERNAL void EncodeWeights( const f32* weights, u32 count, u8* out )
+	{
+		f32 sum = 0.0f;
+		for ( u32 i = 0; i < count; ++i )
+		{
+			sum += std::max( weights[ i ], 0.0f );
+		}
+
+		if ( sum <= 0.0f )
+		{
+			memset( out, 0, count );
+			return;
+		}
+
+		f32 remainders[ ENJON_MESH_MAX_QUANTIZED_WEIGHTS ];
+		u32 total = 0;
+		for ( u32 i = 0; i < count; ++i )
+		{
+			f32 scaled = std::max( weights[ i ], 0.0f ) / sum * 255.0f;
+			u32 q = std::min( ( u32 )scaled, ( u32 )255 );
+			out[ i ] = ( u8 )q;
+			remainders[ i ] = scaled - ( f32 )q;
+			total += q;
+		}
+
+		for ( ; total < 255; ++total )
+		{
+			u32 best = 0;
+			for ( u32 i = 1; i < count; ++i )
+			{
+				if ( remainders[ i ] > remainders[ best ] )
+				{
+					best = i;
+				}
+			}
+
+			out[ best ]++;
+			remainders[ best ] -= 1.0f;
+		}
+	}
+
+	//=================================================================
+
+	Result MeshOptimizer::QuantizeMesh( Mesh* mesh, f32 errorBudget )
+	{
+		if ( !mesh )
+		{
+			return Result::FAILURE;
+		}
+
+		// Only float layouts that start with position, normal, tangent and uv are understood
+		const VertexDataDeclaration& decl = mesh->mVertexDecl;
+		const Vector< VertexAttributeFormat >& formats = decl.mDecl;
+		if ( formats.size( ) < 4 || 
+			formats[ 0 ] != VertexAttributeFormat::Float3 || 
+			formats[ 1 ] != VertexAttributeFormat::Float3 || 
+			formats[ 2 ] != VertexAttributeFormat::Float3 || 
+			formats[ 3 ] != VertexAttributeFormat::Float2 )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( errorBudget <= 0.0f )
+		{
+			return Result::SUCCESS;
+		}
+
+		u32 vertexSize = ( u32 )decl.GetSizeInBytes( );
+		u32 attributeCount = ( u32 )formats.size( );
+		u32 uvOffset = ( u32 )decl.GetByteOffset( 3 );
+
+		// Trailing Float4 attributes are joint weights
+		u32 weightCount = 0;
+		for ( u32 a = 4; a < attributeCount; ++a )
+		{
+			weightCount += ( formats[ a ] == VertexAttributeFormat::Float4 ) ? 4 : 0;
+		}
+		bool quantizeWeights = ( weightCount && weightCount <= ENJON_MESH_MAX_QUANTIZED_WEIGHTS );
+
+		// Bounds cover every submesh, since they all share decl and decode uniforms
+		f32 minPosition[ 3 ] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		f32 maxPosition[ 3 ] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		f32 minUV = FLT_MAX;
+		f32 maxUV = -FLT_MAX;
+		u32 totalVertexCount = 0;
+		for ( auto& sm : mesh->mSubMeshes )
+		{
+			u32 vertexCount = sm->mVertexData.GetSize( ) / vertexSize;
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				const u8* vertex = sm->mVertexData.GetData( ) + ( usize )v * vertexSize;
+				const f32* position = ( const f32* )vertex;
+				const f32* uv = ( const f32* )( vertex + uvOffset );
+
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					minPosition[ c ] = std::min( minPosition[ c ], position[ c ] );
+					maxPosition[ c ] = std::max( maxPosition[ c ], position[ c ] );
+				}
+
+				for ( u32 c = 0; c < 2; ++c )
+				{
+					minUV = std::min( minUV, uv[ c ] );
+					maxUV = std::max( maxUV, uv[ c ] );
+				}
+			}
+
+			totalVertexCount += vertexCount;
+		}
+
+		if ( !totalVertexCount )
+		{
+			return Result::SUCCESS;
+		}
+
+		f32 positionScale[ 3 ];
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			positionScale[ c ] = maxPosition[ c ] - minPosition[ c ];
+		}
+
+		// Measure largest error of each attribute after a round trip through its compact format
+		bool uvInUnitRange = ( minUV >= 0.0f && maxUV <= 1.0f );
+		f32 positionError = 0.0f;
+		f32 directionError = 0.0f;
+		f32 uvError = 0.0f;
+		for ( auto& sm : mesh->mSubMeshes )
+		{
+			u32 vertexCount = sm->mVertexData.GetSize( ) / vertexSize;
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				const u8* vertex = sm->mVertexData.GetData( ) + ( usize )v * vertexSize;
+				const f32* position = ( const f32* )vertex;
+				const f32* uv = ( const f32* )( vertex + uvOffset );
+
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					u16 q = EncodeUNorm16( positionScale[ c ] > 0.0f ? ( position[ c ] - minPosition[ c ] ) / positionScale[ c ] : 0.0f );
+					f32 decoded = minPosition[ c ] + ( f32 )q / 65535.0f * positionScale[ c ];
+					positionError = std::max( positionError, fabsf( decoded - position[ c ] ) );
+				}
+
+				for ( u32 a = 1; a < 3; ++a )
+				{
+					directionError = std::max( directionError, OctahedralError( ( const f32* )( vertex + decl.GetByteOffset( a ) ) ) );
+				}
+
+				for ( u32 c = 0; c < 2; ++c )
+				{
+					f32 decoded = uvInUnitRange ? ( f32 )EncodeUNorm16( uv[ c ] ) / 65535.0f : HalfToFloat( FloatToHalf( uv[ c ] ) );
+					uvError = std::max( uvError, fabsf( decoded - uv[ c ] ) );
+				}
+			}
+		}
+
+		bool quantizePositions = ( positionError <= errorBudget );
+		bool quantizeDirections = ( directionError <= errorBudget );
+		bool quantizeUVs = ( uvError <= errorBudget );
+		if ( !quantizePositions && !quantizeDirections && !quantizeUVs && !quantizeWeights )
+		{
+			return Result::SUCCESS;
+		}
+
+		VertexDataDeclaration quantized;
+		quantized.Add( quantizePositions ? VertexAttributeFormat::UNorm16x4 : VertexAttributeFormat::Float3 );
+		quantized.Add( quantizeDirections ? VertexAttributeFormat::SNorm16x2 : VertexAttributeFormat::Float3 );
+		quantized.Add( quantizeDirections ? VertexAttributeFormat::SNorm16x2 : VertexAttributeFormat::Float3 );
+		quantized.Add( quantizeUVs ? ( uvInUnitRange ? VertexAttributeFormat::UNorm16x2 : VertexAttributeFormat::Half2 ) : VertexAttributeFormat::Float2 );
+		for ( u32 a = 4; a < attributeCount; ++a )
+		{
+			quantized.Add( ( quantizeWeights && formats[ a ] == VertexAttributeFormat::Float4 ) ? VertexAttributeFormat::UNorm8x4 : formats[ a ] );
+		}
+
+		Vector< u32 > srcOffsets( attributeCount );
+		Vector< u32 > dstOffsets( attributeCount );
+		for ( u32 a = 0; a < attributeCount; ++a )
+		{
+			srcOffsets[ a ] = ( u32 )decl.GetByteOffset( a );
+			dstOffsets[ a ] = ( u32 )quantized.GetByteOffset( a );
+		}
+
+		u32 quantizedSize = ( u32 )quantized.GetSizeInBytes( );
+		Vector< u8 > vertices;
+		for ( auto& sm : mesh->mSubMeshes )
+		{
+			u32 vertexCount = sm->mVertexData.GetSize( ) / vertexSize;
+			vertices.assign( ( usize )vertexCount * quantizedSize, 0 );
+
+			for ( u32 v = 0; v < vertexCount; ++v )
+			{
+				const u8* src = sm->mVertexData.GetData( ) + ( usize )v * vertexSize;
+				u8* dst = vertices.data( ) + ( usize )v * quantizedSize;
+
+				// Position
+				if ( quantizePositions )
+				{
+					const f32* position = ( const f32* )src;
+					u16 q[ 4 ] = { 0, 0, 0, 0 };
+					for ( u32 c = 0; c < 3; ++c )
+					{
+						q[ c ] = EncodeUNorm16( positionScale[ c ] > 0.0f ? ( position[ c ] - minPosition[ c ] ) / positionScale[ c ] : 0.0f );
+					}
+					memcpy( dst, q, sizeof( q ) );
+				}
+				else
+				{
+					memcpy( dst, src, 3 * sizeof( f32 ) );
+				}
+
+				// Normal and tangent
+				for ( u32 a = 1; a < 3; ++a )
+				{
+					if ( quantizeDirections )
+					{
+						s16 encoded[ 2 ];
+						EncodeOctahedral( ( const f32* )( src + srcOffsets[ a ] ), encoded );
+						memcpy( dst + dstOffsets[ a ], encoded, sizeof( encoded ) );
+					}
+					else
+					{
+						memcpy( dst + dstOffsets[ a ], src + srcOffsets[ a ], 3 * sizeof( f32 ) );
+					}
+				}
+
+				// UV
+				const f32* uv = ( const f32* )( src + srcOffsets[ 3 ] );
+				if ( quantizeUVs )
+				{
+					u16 q[ 2 ];
+					for ( u32 c = 0; c < 2; ++c )
+					{
+						q[ c ] = uvInUnitRange ? EncodeUNorm16( uv[ c ] ) : FloatToHalf( uv[ c ] );
+					}
+					memcpy( dst + dstOffsets[ 3 ], q, sizeof( q ) );
+				}
+				else
+				{
+					memcpy( dst + dstOffsets[ 3 ], uv, 2 * sizeof( f32 ) );
+				}
+
+				// Everything else is copied, apart from weights which are renormalized together
+				f32 weights[ ENJON_MESH_MAX_QUANTIZED_WEIGHTS ];
+				u32 w = 0;
+				for ( u32 a = 4; a < attributeCount; ++a )
+				{
+					if ( quantized.mDecl[ a ] == VertexAttributeFormat::UNorm8x4 )
+					{
+						memcpy( weights + w, src + srcOffsets[ a ], 4 * sizeof( f32 ) );
+						w += 4;
+					}
+					else
+					{
+						u32 end = ( a + 1 < attributeCount ) ? srcOffsets[ a + 1 ] : vertexSize;
+						memcpy( dst + dstOffsets[ a ], src + srcOffsets[ a ], end - srcOffsets[ a ] );
+					}
+				}
+
+				if ( w )
+				{
+					u8 encoded[ ENJON_MESH_MAX_QUANTIZED_WEIGHTS ];
+					EncodeWeights( weights, w, encoded );
+
+					w = 0;
+					for ( u32 a = 4; a < attributeCount; ++a )
+					{
+						if ( quantized.mDecl[ a ] == VertexAttributeFormat::UNorm8x4 )
+						{
+							memcpy( dst + dstOffsets[ a ], encoded + w, 4 );
+							w += 4;
+						}
+					}
+				}
+			}
+
+			sm->mVertexData.Reset( );
+			sm->mVertexData.WriteBytes( vertices.data( ), ( u32 )vertices.size( ) );
+		}
+
+		if ( quantizePositions )
+		{
+			mesh->mPositionOffset = Vec3( minPosition[ 0 ], minPosition[ 1 ], minPosition[ 2 ] );
+			mesh->mPositionScale = Vec3( positionScale[ 0 ], positionScale[ 1 ], positionScale[ 2 ] );
+		}
+
+		mesh->SetVertexDecl( quantized );
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+}
@@ -61,6 +61,11 @@ namespace Enjon
 	void PointLight::SetPosition( const Vec3& position )
 	{
 		mPosition = position;
+
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//============================================================================================================================
@@ -75,6 +80,11 @@ namespace Enjon
 	void PointLight::SetRadius( const f32& radius )
 	{
 		mRadius = radius;
+
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//==============================================================================================
@@ -1,6 +1,7 @@
 #include "Graphics/QuadBatch.h"
 #include "Graphics/GraphicsScene.h"
 #include "Graphics/Material.h"
+#include "Graphics/GPUMemoryTracker.h"
 #include <stdio.h>
 
 #include <algorithm>
@@ -509,6 +510,7 @@ namespace Enjon
 		glBindBuffer(GL_ARRAY_BUFFER, VBO);
 		// Orphan data
 		glBufferData(GL_ARRAY_BUFFER, Verticies.size() * sizeof(QuadVert), nullptr, GL_DYNAMIC_DRAW);
+		GPUMemoryTracker::Track( GPUResourceType::Buffer, VBO, Verticies.size() * sizeof(QuadVert), "QuadBatch" );
 		// Upload data
 		glBufferSubData(GL_ARRAY_BUFFER, 0, Verticies.size() * sizeof(QuadVert), Verticies.data());
 		// Unbind vbo
@@ -0,0 +1,260 @@
+// @file RenderCommandBuffer.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/RenderCommandBuffer.h"
+
+#include <assert.h>
+#include <string.h>
+
+namespace Enjon
+{
+	//=================================================================
+
+	void RenderCommandBuffer::Clear( )
+	{
+		mData.clear( );
+		mCommandCount = 0;
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::Write( RenderCommandType type, RenderUniform uniform, u16 count, const void* payload, u32 size )
+	{
+		RenderCommandHeader header;
+		header.mType = type;
+		header.mUniform = uniform;
+		header.mCount = count;
+		header.mSize = size;
+
+		usize offset = mData.size( );
+		mData.resize( offset + sizeof( RenderCommandHeader ) + size );
+		memcpy( &mData[ offset ], &header, sizeof( RenderCommandHeader ) );
+		if ( size )
+		{
+			memcpy( &mData[ offset + sizeof( RenderCommandHeader ) ], payload, size );
+		}
+
+		mCommandCount++;
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::BindProgram( const Shader* shader )
+	{
+		Write( RenderCommandType::BindProgram, RenderUniform::Count, 1, &shader, sizeof( shader ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::BindMaterial( const Material* material )
+	{
+		Write( RenderCommandType::BindMaterial, RenderUniform::Count, 1, &material, sizeof( material ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::SetUniform( RenderUniform uniform, f32 value )
+	{
+		Write( RenderCommandType::SetFloat, uniform, 1, &value, sizeof( value ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::SetUniform( RenderUniform uniform, const Vec3& value )
+	{
+		f32 data[ 3 ] = { value.x, value.y, value.z };
+		Write( RenderCommandType::SetVec3, uniform, 1, data, sizeof( data ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::SetUniform( RenderUniform uniform, const Vec4& value )
+	{
+		f32 data[ 4 ] = { value.x, value.y, value.z, value.w };
+		Write( RenderCommandType::SetVec4, uniform, 1, data, sizeof( data ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::SetUniform( RenderUniform uniform, const Mat4x4& value )
+	{
+		SetUniform( uniform, &value, 1 );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count )
+	{
+		assert( count <= 0xFFFF );
+		Write( RenderCommandType::SetMat4, uniform, ( u16 )count, values ? values->elements : nullptr, count * sizeof( f32 ) * 16 );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::BindMesh( const Mesh* mesh )
+	{
+		Write( RenderCommandType::BindMesh, RenderUniform::Count, 1, &mesh, sizeof( mesh ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::DrawSubMesh( const SubMesh* subMesh, u32 lod )
+	{
+		u8 payload[ sizeof( subMesh ) + sizeof( lod ) ];
+		memcpy( payload, &subMesh, sizeof( subMesh ) );
+		memcpy( payload + sizeof( subMesh ), &lod, sizeof( lod ) );
+		Write( RenderCommandType::DrawSubMesh, RenderUniform::Count, 1, payload, sizeof( payload ) );
+	}
+
+	//=================================================================
+
+	void RenderCommandBuffer::Append( const RenderCommandBuffer& other )
+	{
+		mData.insert( mData.end( ), other.mData.begin( ), other.mData.end( ) );
+		mCommandCount += other.mCommandCount;
+	}
+
+	//=================================================================
+
+	template < typename T >
+	INTERNAL T ReadPayload( const u8* payload, usize offset = 0 )
+	{
+		T value;
+		memcpy( &value, payload + offset, sizeof( T ) );
+		return value;
+	}
+
+	//=================================================================
+
+	void RenderCommandExecutor::Execute( const RenderCommandBuffer& buffer )
+	{
+		// Matrices are copied out of buffer since its payloads aren't aligned
+		Vector< Mat4x4 > matrices;
+
+		const u8* data = buffer.GetData( );
+		const u8* end = data + buffer.GetSize( );
+		while ( data < end )
+		{
+			RenderCommandHeader header;
+			memcpy( &header, data, sizeof( RenderCommandHeader ) );
+			const u8* payload = data + sizeof( RenderCommandHeader );
+
+			switch ( header.mType )
+			{
+				case RenderCommandType::BindProgram:	BindProgram( ReadPayload< const Shader* >( payload ) ); break;
+				case RenderCommandType::BindMaterial:	BindMaterial( ReadPayload< const Material* >( payload ) ); break;
+				case RenderCommandType::SetFloat:		SetUniform( header.mUniform, ReadPayload< f32 >( payload ) ); break;
+				case RenderCommandType::BindMesh:		BindMesh( ReadPayload< const Mesh* >( payload ) ); break;
+
+				case RenderCommandType::SetVec3:
+				{
+					SetUniform( header.mUniform, Vec3( ReadPayload< f32 >( payload, 0 ), ReadPayload< f32 >( payload, 4 ), ReadPayload< f32 >( payload, 8 ) ) );
+				} break;
+
+				case RenderCommandType::SetVec4:
+				{
+					SetUniform( header.mUniform, Vec4( ReadPayload< f32 >( payload, 0 ), ReadPayload< f32 >( payload, 4 ), ReadPayload< f32 >( payload, 8 ), ReadPayload< f32 >( payload, 12 ) ) );
+				} break;
+
+				case RenderCommandType::SetMat4:
+				{
+					matrices.resize( header.mCount );
+					for ( u32 i = 0; i < header.mCount; ++i )
+					{
+						memcpy( matrices[ i ].elements, payload + i * sizeof( f32 ) * 16, sizeof( f32 ) * 16 );
+					}
+					SetUniform( header.mUniform, matrices.data( ), header.mCount );
+				} break;
+
+				case RenderCommandType::DrawSubMesh:
+				{
+					DrawSubMesh( ReadPayload< const SubMesh* >( payload ), ReadPayload< u32 >( payload, sizeof( const SubMesh* ) ) );
+				} break;
+
+				default: assert( false ); break;
+			}
+
+			data = payload + header.mSize;
+		}
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::Reset( )
+	{
+		for ( u32& c : mCounts )
+		{
+			c = 0;
+		}
+	}
+
+	//=================================================================
+
+	u32 NullRenderCommandExecutor::GetTotalCount( ) const
+	{
+		u32 total = 0;
+		for ( const u32& c : mCounts )
+		{
+			total += c;
+		}
+		return total;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::BindProgram( const Shader* shader )
+	{
+		mCounts[ ( u32 )RenderCommandType::BindProgram ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::BindMaterial( const Material* material )
+	{
+		mCounts[ ( u32 )RenderCommandType::BindMaterial ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::SetUniform( RenderUniform uniform, f32 value )
+	{
+		mCounts[ ( u32 )RenderCommandType::SetFloat ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::SetUniform( RenderUniform uniform, const Vec3& value )
+	{
+		mCounts[ ( u32 )RenderCommandType::SetVec3 ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::SetUniform( RenderUniform uniform, const Vec4& value )
+	{
+		mCounts[ ( u32 )RenderCommandType::SetVec4 ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count )
+	{
+		mCounts[ ( u32 )RenderCommandType::SetMat4 ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::BindMesh( const Mesh* mesh )
+	{
+		mCounts[ ( u32 )RenderCommandType::BindMesh ]++;
+	}
+
+	//=================================================================
+
+	void NullRenderCommandExecutor::DrawSubMesh( const SubMesh* subMesh, u32 lod )
+	{
+		mCounts[ ( u32 )RenderCommandType::DrawSubMesh ]++;
+	}
+
+	//=================================================================
+}
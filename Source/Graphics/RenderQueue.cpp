@@ -0,0 +1,139 @@
+// @file RenderQueue.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/RenderQueue.h"
+
+#include <algorithm>
+
+// Bit offsets of each field of a key
+#define ENJON_RENDER_KEY_PASS_SHIFT			60
+#define ENJON_RENDER_KEY_PROGRAM_SHIFT		48
+#define ENJON_RENDER_KEY_MATERIAL_SHIFT		32
+#define ENJON_RENDER_KEY_MESH_SHIFT			20
+#define ENJON_RENDER_KEY_DEPTH_BITS			20
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL u64 QuantizeDepth( f32 depth, u32 bits )
+	{
+		u64 max = ( 1ull << bits ) - 1;
+		f32 clamped = std::min( std::max( depth, 0.0f ), 1.0f );
+		return ( u64 )( clamped * ( f32 )max );
+	}
+
+	//=================================================================
+
+	u64 RenderQueue::MakeKey( RenderQueuePass pass, u32 programID, u32 materialID, u32 meshID, f32 depth )
+	{
+		return ( ( u64 )pass << ENJON_RENDER_KEY_PASS_SHIFT ) |
+				( ( u64 )( programID & 0xFFF ) << ENJON_RENDER_KEY_PROGRAM_SHIFT ) |
+				( ( u64 )( materialID & 0xFFFF ) << ENJON_RENDER_KEY_MATERIAL_SHIFT ) |
+				( ( u64 )( meshID & 0xFFF ) << ENJON_RENDER_KEY_MESH_SHIFT ) |
+				QuantizeDepth( depth, ENJON_RENDER_KEY_DEPTH_BITS );
+	}
+
+	//=================================================================
+
+	u64 RenderQueue::MakeDepthKey( RenderQueuePass pass, f32 depth )
+	{
+		return ( ( u64 )pass << ENJON_RENDER_KEY_PASS_SHIFT ) | ( QuantizeDepth( depth, 32 ) << ( ENJON_RENDER_KEY_PASS_SHIFT - 32 ) );
+	}
+
+	//=================================================================
+
+	RenderQueuePass RenderQueue::GetPass( u64 key )
+	{
+		return ( RenderQueuePass )( key >> ENJON_RENDER_KEY_PASS_SHIFT );
+	}
+
+	//=================================================================
+
+	void RenderQueue::Clear( )
+	{
+		mItems.clear( );
+		mEntries.clear( );
+	}
+
+	//=================================================================
+
+	void RenderQueue::Push( u64 key, const RenderQueueItem& item )
+	{
+		mEntries.push_back( { key, ( u32 )mItems.size( ) } );
+		mItems.push_back( item );
+	}
+
+	//=================================================================
+
+	void RenderQueue::Sort( )
+	{
+		usize count = mEntries.size( );
+		if ( count < 2 )
+		{
+			return;
+		}
+
+		// Histograms of every byte of keys, gathered in one pass
+		u32 histograms[ 8 ][ 256 ] = { };
+		for ( const SortEntry& e : mEntries )
+		{
+			for ( u32 b = 0; b < 8; ++b )
+			{
+				histograms[ b ][ ( e.mKey >> ( b * 8 ) ) & 0xFF ]++;
+			}
+		}
+
+		mScratch.resize( count );
+
+		// Least significant byte first, scattering stably between buffers
+		for ( u32 b = 0; b < 8; ++b )
+		{
+			u32* histogram = histograms[ b ];
+
+			// Every key shares this byte, so pass wouldn't move anything
+			if ( histogram[ ( mEntries[ 0 ].mKey >> ( b * 8 ) ) & 0xFF ] == count )
+			{
+				continue;
+			}
+
+			u32 offset = 0;
+			for ( u32 i = 0; i < 256; ++i )
+			{
+				u32 c = histogram[ i ];
+				histogram[ i ] = offset;
+				offset += c;
+			}
+
+			for ( const SortEntry& e : mEntries )
+			{
+				mScratch[ histogram[ ( e.mKey >> ( b * 8 ) ) & 0xFF ]++ ] = e;
+			}
+
+			mEntries.swap( mScratch );
+		}
+	}
+
+	//=================================================================
+
+	void RenderQueue::GetPassRange( RenderQueuePass pass, u32* begin, u32* end ) const
+	{
+		u64 first = ( u64 )pass << ENJON_RENDER_KEY_PASS_SHIFT;
+		u64 last = ( ( u64 )pass + 1 ) << ENJON_RENDER_KEY_PASS_SHIFT;
+
+		auto lower = std::lower_bound( mEntries.begin( ), mEntries.end( ), first, [ ] ( const SortEntry& e, u64 key )
+		{
+			return e.mKey < key;
+		} );
+
+		auto upper = std::lower_bound( lower, mEntries.end( ), last, [ ] ( const SortEntry& e, u64 key )
+		{
+			return e.mKey < key;
+		} );
+
+		*begin = ( u32 )( lower - mEntries.begin( ) );
+		*end = ( u32 )( upper - mEntries.begin( ) );
+	}
+
+	//=================================================================
+}
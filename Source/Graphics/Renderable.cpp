@@ -6,12 +6,14 @@
 #include "Graphics/GLSLProgram.h"
 #include "Graphics/GraphicsSubsystem.h" 
 #include "Graphics/Color.h"
+#include "Graphics/Camera.h"
 #include "ImGui/ImGuiManager.h"
 #include "Asset/AssetManager.h"
 #include "Engine.h"
 #include "SubsystemCatalog.h"
 
 #include <assert.h> 
+#include <float.h>
 
 namespace Enjon  
 { 
@@ -75,6 +77,10 @@ namespace Enjon
 	void Renderable::SetTransform(const Transform& transform) 
 	{ 
 		mTransform = transform; 
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//==============================================================
@@ -82,24 +88,40 @@ namespace Enjon
 	void Renderable::SetPosition(const Vec3& position)
 	{
 		mTransform.SetPosition(position);
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//--------------------------------------------------------------------
 	void Renderable::SetScale(const Vec3& scale)
 	{
 		mTransform.SetScale(scale);
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//--------------------------------------------------------------------
 	void Renderable::SetScale(const f32& scale)
 	{
 		mTransform.SetScale(scale);
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//--------------------------------------------------------------------
 	void Renderable::SetRotation(const Quaternion& rotation)
 	{
 		mTransform.SetRotation(rotation);
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//==============================================================
@@ -110,6 +132,10 @@ namespace Enjon
 		Quaternion Y = Quaternion::AngleAxis(Pitch, mTransform.GetRotation() * Vec3(1, 0, 0));	// Relative Right
 
 		mTransform.SetRotation( X * Y * mTransform.GetRotation( ) );
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 
 	//--------------------------------------------------------------------
@@ -159,6 +185,80 @@ namespace Enjon
 
 	//==============================================================================
 
+	u32 Renderable::GetLOD( ) const
+	{
+		return mLOD;
+	}
+
+	//==============================================================================
+
+	u32 Renderable::SelectLOD( const Camera* camera, const f32& screenHeight )
+	{
+		const Mesh* mesh = GetMesh( );
+		u32 lodCount = mesh ? mesh->GetLODCount( ) : 1;
+		mPixelsPerUnit = 0.0f;
+		if ( !camera || !mesh )
+		{
+			mLOD = 0;
+			return mLOD;
+		}
+
+		// Bounding sphere of mesh in world space
+		Vec3 scale = GetScale( );
+		f32 maxScale = std::max( std::fabs( scale.x ), std::max( std::fabs( scale.y ), std::fabs( scale.z ) ) );
+		Vec3 boundsMin = mesh->GetBoundsMin( );
+		Vec3 boundsMax = mesh->GetBoundsMax( );
+		Vec3 center = ( mCurrentModelMatrix * Vec4( ( boundsMin + boundsMax ) * 0.5f, 1.0f ) ).XYZ( );
+		f32 radius = ( boundsMax - boundsMin ).Length( ) * 0.5f * maxScale;
+
+		// Pixels one object space unit covers at nearest point of bounds. Projection's y scale is 1 / tan( fov / 2 ) or 1 / orthographic scale.
+		f32 pixelsPerUnit = 0.5f * screenHeight * camera->GetProjection( ).elements[ 5 ] * maxScale;
+		if ( camera->GetProjectionType( ) == ProjectionType::Perspective )
+		{
+			f32 distance = ( center - camera->GetPosition( ) ).Length( ) - radius;
+			if ( distance <= 0.0f )
+			{
+				mPixelsPerUnit = FLT_MAX;
+				mLOD = 0;
+				return mLOD;
+			}
+
+			pixelsPerUnit /= distance;
+		}
+
+		mPixelsPerUnit = pixelsPerUnit;
+		if ( lodCount <= 1 )
+		{
+			mLOD = 0;
+			return mLOD;
+		}
+
+		// Errors only grow with level, so stop at first one that's too coarse
+		u32 lod = 0;
+		for ( u32 i = 1; i < lodCount; ++i )
+		{
+			f32 limit = ( i > mLOD ) ? ENJON_LOD_PIXEL_ERROR * ENJON_LOD_HYSTERESIS : ENJON_LOD_PIXEL_ERROR;
+			if ( mesh->GetLODError( i ) * pixelsPerUnit > limit )
+			{
+				break;
+			}
+
+			lod = i;
+		}
+
+		mLOD = lod;
+		return mLOD;
+	}
+
+	//==============================================================================
+
+	f32 Renderable::GetPixelsPerUnit( ) const
+	{
+		return mPixelsPerUnit;
+	}
+
+	//==============================================================================
+
 	void Renderable::Submit( const Enjon::Shader* shader, const SubMesh* subMesh, const u32& subMeshIndex )
 	{
 		if ( shader == nullptr )
@@ -171,11 +271,17 @@ namespace Enjon
 		shdr->SetUniform( "uPreviousModel", mPreviousModelMatrix );
 		shdr->SetUniform( "uObjectID", Renderable::IdToColor( GetRenderableID( ), subMeshIndex ) ); 
 
+		// Set vertex decode for owning mesh
+		if ( subMesh->mMesh )
+		{
+			subMesh->mMesh->Bind( shader );
+		}
+
 		// Bind submesh
 		subMesh->Bind( );
 		{
-			// Submit for rendering
-			subMesh->Submit( ); 
+			// Submit for rendering at selected level of detail
+			subMesh->Submit( mLOD ); 
 		}
 		// Unbind submesh
 		subMesh->Unbind( ); 
@@ -225,6 +331,7 @@ namespace Enjon
 				Model *= Mat4x4::Scale( GetScale( ) );
 				const_cast< Enjon::Shader* > ( shader )->SetUniform( "uModel", Model );
 				const_cast< Enjon::Shader* > ( shader )->SetUniform( "uPreviousModel", mPreviousModelMatrix );
+				mesh->Bind( shader );
 
 				// For each submesh, bind
 				for ( auto& sm : subMeshes )
@@ -1035,18 +1035,18 @@ namespace Enjon
 			case ShaderPassType::Deferred_StaticGeom:
 			{
 				// Vertex Attribute Layouts
-				code += OutputLine( "layout (location = 0) in vec3 aVertexPosition;" );
-				code += OutputLine( "layout (location = 1) in vec3 aVertexNormal;" );
-				code += OutputLine( "layout (location = 2) in vec3 aVertexTangent;" );
+				code += OutputLine( "layout (location = 0) in vec3 aVertexPositionEncoded;" );
+				code += OutputLine( "layout (location = 1) in vec3 aVertexNormalEncoded;" );
+				code += OutputLine( "layout (location = 2) in vec3 aVertexTangentEncoded;" );
 				code += OutputLine( "layout (location = 3) in vec3 aVertexUV;" );
 			} break;
 
 			case ShaderPassType::Deferred_InstancedGeom:
 			{
 				// Vertex Attribute Layouts
-				code += OutputLine( "layout (location = 0) in vec3 aVertexPosition;" );
-				code += OutputLine( "layout (location = 1) in vec3 aVertexNormal;" );
-				code += OutputLine( "layout (location = 2) in vec3 aVertexTangent;" );
+				code += OutputLine( "layout (location = 0) in vec3 aVertexPositionEncoded;" );
+				code += OutputLine( "layout (location = 1) in vec3 aVertexNormalEncoded;" );
+				code += OutputLine( "layout (location = 2) in vec3 aVertexTangentEncoded;" );
 				code += OutputLine( "layout (location = 3) in vec3 aVertexUV;" );
 				code += OutputLine( "layout (location = 4) in mat4 aInstanceMatrix;" );
 			} break; 
@@ -1054,9 +1054,9 @@ namespace Enjon
 			case ShaderPassType::Deferred_Skinned_Geom:
 			{
 				// Vertex Attribute Layouts
-				code += OutputLine( "layout (location = 0) in vec3 aVertexPosition;" );
-				code += OutputLine( "layout (location = 1) in vec3 aVertexNormal;" );
-				code += OutputLine( "layout (location = 2) in vec3 aVertexTangent;" );
+				code += OutputLine( "layout (location = 0) in vec3 aVertexPositionEncoded;" );
+				code += OutputLine( "layout (location = 1) in vec3 aVertexNormalEncoded;" );
+				code += OutputLine( "layout (location = 2) in vec3 aVertexTangentEncoded;" );
 				code += OutputLine( "layout (location = 3) in vec2 aVertexUV;" );
 				code += OutputLine( "layout (location = 4) in ivec4 aJointIndices;" );
 				code += OutputLine( "layout (location = 5) in ivec4 aJointIndices2;" );
@@ -1065,6 +1065,45 @@ namespace Enjon
 			} break;
 		}
 
+		// Quantized vertex data is decoded into the names rest of the shader uses
+		if ( !code.empty( ) )
+		{
+			code += OutputVertexAttributeDecode( );
+		}
+
+		return code;
+	}
+
+	Enjon::String ShaderGraph::OutputVertexAttributeDecode( )
+	{
+		Enjon::String code = "";
+
+		// Identity decode unless set by Mesh::Bind
+		code += OutputLine( "\n// Vertex Attribute Decoding" );
+		code += OutputLine( "uniform vec3 uVertexPositionOffset = vec3( 0.0 );" );
+		code += OutputLine( "uniform vec3 uVertexPositionScale = vec3( 1.0 );" );
+		code += OutputLine( "uniform int uVertexOctahedralDirections = 0;\n" );
+		code += OutputLine( "vec3 aVertexPosition;" );
+		code += OutputLine( "vec3 aVertexNormal;" );
+		code += OutputLine( "vec3 aVertexTangent;\n" );
+
+		code += OutputLine( "vec3 DecodeOctahedral( vec2 e )" );
+		code += OutputLine( "{" );
+		code += OutputTabbedLine( "vec3 v = vec3( e, 1.0 - abs( e.x ) - abs( e.y ) );" );
+		code += OutputTabbedLine( "if ( v.z < 0.0 )" );
+		code += OutputTabbedLine( "{" );
+		code += OutputTabbedLine( "\tv.xy = ( 1.0 - abs( v.yx ) ) * vec2( v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0 );" );
+		code += OutputTabbedLine( "}" );
+		code += OutputTabbedLine( "return normalize( v );" );
+		code += OutputLine( "}\n" );
+
+		code += OutputLine( "void DecodeVertexAttributes( )" );
+		code += OutputLine( "{" );
+		code += OutputTabbedLine( "aVertexPosition = uVertexPositionOffset + aVertexPositionEncoded * uVertexPositionScale;" );
+		code += OutputTabbedLine( "aVertexNormal = uVertexOctahedralDirections != 0 ? DecodeOctahedral( aVertexNormalEncoded.xy ) : aVertexNormalEncoded;" );
+		code += OutputTabbedLine( "aVertexTangent = uVertexOctahedralDirections != 0 ? DecodeOctahedral( aVertexTangentEncoded.xy ) : aVertexTangentEncoded;" );
+		code += OutputLine( "}" );
+
 		return code;
 	}
 
@@ -1341,6 +1380,20 @@ namespace Enjon
 		Enjon::String code = "\n// Vertex Main\n";
 		code += "void main()\n";
 		code += "{\n";
+
+		// Geometry passes decode their vertex attributes before anything reads them
+		switch ( pass )
+		{
+			default: break;
+			case ShaderPassType::Forward_StaticGeom:
+			case ShaderPassType::Deferred_StaticGeom:
+			case ShaderPassType::Deferred_InstancedGeom:
+			case ShaderPassType::Deferred_Skinned_Geom:
+			{
+				code += OutputTabbedLine( "DecodeVertexAttributes( );\n" );
+			} break;
+		}
+
 		return code;
 	}
 
@@ -2,6 +2,7 @@
 // Copyright 2016-2018 John Jackson. All Rights Reserved.
 
 #include "Graphics/SkeletalMeshRenderable.h"
+#include "Graphics/GraphicsScene.h"
 #include "Graphics/AnimationSubsystem.h"
 #include "Entity/Components/SkeletalAnimationComponent.h"
 #include "Asset/AssetManager.h"
@@ -16,6 +17,11 @@ namespace Enjon
 	{
 		mMesh = mesh;
 
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
+
 		// Make sure that material element vector matches amount of submeshes
 		u32 subMeshCount = mMesh->GetSubMeshCount( );
 
@@ -73,6 +79,11 @@ namespace Enjon
 	{
 		mMesh = mesh;
 
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
+
 		// Make sure that material element vector matches amount of submeshes
 		u32 subMeshCount = mMesh->GetSubMeshCount( );
 
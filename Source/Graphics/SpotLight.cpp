@@ -34,6 +34,11 @@ namespace Enjon
 	void SpotLight::SetColor( const ColorRGBA32& color )
 	{
 		mColor = color;
+
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 	
 	//============================================================================================================================
@@ -41,6 +46,11 @@ namespace Enjon
 	void SpotLight::SetIntensity( const f32& intensity )
 	{
 		mIntensity = intensity;
+
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 	
 	//============================================================================================================================
@@ -55,6 +65,11 @@ namespace Enjon
 	void SpotLight::SetPosition( const Vec3& position )
 	{
 		mPosition = position;
+
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 	
 	//============================================================================================================================
@@ -69,6 +84,11 @@ namespace Enjon
 	void SpotLight::SetParams( const SLParams& params )
 	{
 		mParams = params;
+
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
 	}
 	
 	//============================================================================================================================
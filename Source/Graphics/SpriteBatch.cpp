@@ -1,4 +1,5 @@
 #include "Graphics/SpriteBatch.h"
+#include "Graphics/GPUMemoryTracker.h"
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -158,6 +159,7 @@ namespace Enjon {
 			glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 			// Orphan the buffer (for speed) 
 			glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
+			GPUMemoryTracker::Track( GPUResourceType::Buffer, m_vbo, vertices.size() * sizeof(Vertex), "SpriteBatch" );
 			// Upload the data 
 			glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
 
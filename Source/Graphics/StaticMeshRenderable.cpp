@@ -1,4 +1,5 @@
 #include "Graphics/StaticMeshRenderable.h"
+#include "Graphics/GraphicsScene.h"
 #include "Asset/AssetManager.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
@@ -11,6 +12,11 @@ namespace Enjon
 	{
 		mMesh = mesh;
 
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
+
 		// Make sure that material element vector matches amount of submeshes
 		u32 subMeshCount = mMesh->GetSubMeshCount( );
 
@@ -67,6 +73,11 @@ namespace Enjon
 	{
 		mMesh = mesh;
 
+		if ( mGraphicsScene )
+		{
+			mGraphicsScene->UpdateBounds( this );
+		}
+
 		// Make sure that material element vector matches amount of submeshes
 		u32 subMeshCount = mMesh->GetSubMeshCount( );
 
@@ -3,6 +3,11 @@
 // File: Texture.cpp
 
 #include "Graphics/Texture.h"
+#include "Graphics/TextureCompression.h"
+#include "Graphics/ImageBasedLighting.h"
+#include "Graphics/GPUMemoryTracker.h"
+#include "Graphics/TextureStreamer.h"
+#include "Graphics/GraphicsSubsystem.h"
 #include "Asset/TextureAssetLoader.h"
 #include "Asset/AssetManager.h"
 #include "Serialize/ObjectArchiver.h"
@@ -20,6 +25,9 @@
 #include <GLEW/glew.h>
 #include <vector> 
 
+// 'ETXC', read where older cached textures stored their width, which can never be this large
+#define ENJON_TEXTURE_COOKED_MAGIC		0x43585445
+
 namespace Enjon
 {
 	//=================================================
@@ -40,139 +48,392 @@ namespace Enjon
 
 	//=================================================
 
-	Texture* Texture::Construct( const String& filePath )
+	void Texture::ExplicitDestructor( )
+	{
+		// Reads in flight can't be left writing into a deleted texture
+		if ( mIsStreamed )
+		{
+			EngineSubsystem( GraphicsSubsystem )->GetTextureStreamer( )->Unregister( this );
+		}
+
+		ReleaseGPUTexture( );
+	}
+
+	//=================================================
+
+	void Texture::ReleaseGPUTexture( )
+	{
+		if ( mId )
+		{
+			GPUMemoryTracker::Release( GPUResourceType::Texture, mId );
+			glDeleteTextures( 1, &mId );
+			mId = 0;
+		}
+
+		ImageBasedLighting::Release( &mIBLMaps );
+		mGPUMemoryBytes = 0;
+	}
+
+	//=================================================
+
+	Texture* Texture::Decode( const String& filePath )
 	{
 		// Get file extension of file
 		Enjon::String fileExtension = Utils::SplitString( filePath, "." ).back( ); 
 
 		// Fields to load and store
-		s32 width, height, nComps, len; 
-
-		void* textureData = nullptr; 
+		s32 width, height, nComps; 
 
 		// Construct new texture to fill out
 		Texture* tex = new Texture( );
 
-		// Load HDR format
+		// Vertical flip in stb is global state, so flipping is done here to keep decoding safe to run on any thread
 		if ( fileExtension.compare( "hdr" ) == 0 )
 		{
-			stbi_set_flip_vertically_on_load( true );
 			f32* data = stbi_loadf( filePath.c_str( ), &width, &height, &nComps, 0 ); 
+			if ( !data )
+			{
+				delete tex;
+				return nullptr;
+			}
 
-			// Store texture data
-			textureData = (f32*)data;
-
-			s32 MAG_PARAM = GL_LINEAR;
-			s32 MIN_PARAM = GL_LINEAR_MIPMAP_LINEAR;
-			b8 genMips = true;
-
-			// Generate and bind texture for data storage
-			glGenTextures( 1, &tex->mId );
-			glBindTexture( GL_TEXTURE_2D, tex->mId );
-			glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA32F, width, height, 0, GL_RGB, GL_FLOAT, data ); 
-
-			// Anisotropic filtering
-			float aniso = 0.0f;
-			glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, aniso );
-
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MAG_PARAM );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MIN_PARAM );
-
-			if ( genMips )
+			// Flip rows so first row is bottom of image
+			usize rowSize = ( usize )width * ( usize )nComps;
+			Vector< f32 > row( rowSize );
+			for ( s32 y = 0; y < height / 2; ++y )
 			{
-				glGenerateMipmap( GL_TEXTURE_2D );
-			} 
+				f32* top = data + ( usize )y * rowSize;
+				f32* bottom = data + ( usize )( height - 1 - y ) * rowSize;
+				memcpy( row.data( ), top, rowSize * sizeof( f32 ) );
+				memcpy( top, bottom, rowSize * sizeof( f32 ) );
+				memcpy( bottom, row.data( ), rowSize * sizeof( f32 ) );
+			}
 
 			tex->mFormat = TextureFormat::HDR; 
+			tex->mSourceData = new TextureSourceData< f32 >( data, tex ); 
 		}
 
 		// Otherwise load standard format
 		else
 		{
-			// Load texture data
-			stbi_set_flip_vertically_on_load( false );
-
 			// For now, this data will always have 4 components, since STBI_rgb_alpha is being passed in as required components param
 			// Could optimize this later
 			u8* data = stbi_load( filePath.c_str( ), &width, &height, &nComps, STBI_rgb_alpha );
-
-			// Store texture data
-			textureData = (u8*)data;
+			if ( !data )
+			{
+				delete tex;
+				return nullptr;
+			}
 
 			// TODO(): For some reason, required components is not working, so just default to 4 for now
 			nComps = 4;
 
-			// Generate texture
-			glGenTextures( 1, &( tex->mId ) );
+			tex->mFormat = TextureFormat::LDR;
+			tex->mSourceData = new TextureSourceData< u32 >( ( u32* )data, tex ); 
+		} 
+
+		// Set texture attributes
+		tex->mWidth = width;
+		tex->mHeight = height;
+		tex->mNumberOfComponents = nComps; 
+
+		// Store file extension type of texture
+		tex->mFileExtension = Texture::GetFileExtensionType( fileExtension ); 
+
+		return tex; 
+	}
 
-			// Bind and create texture
-			glBindTexture( GL_TEXTURE_2D, tex->mId );
+	//=================================================
 
-			// Generate texture depending on number of components in texture data
-			switch ( nComps )
+	Result Texture::Cook( TextureCompression compression, TextureUsage usage )
+	{
+		if ( !mSourceData )
+		{
+			return Result::FAILURE;
+		}
+
+		mMipData.clear( );
+
+		switch ( mFormat )
+		{
+			case TextureFormat::HDR:
 			{
-				case 3: 
+				const f32* data = mSourceData->Cast< f32 >( )->GetData( );
+
+				// Only block format that can hold HDR data
+				mCompression = ( compression == TextureCompression::None ) ? TextureCompression::None : TextureCompression::BC6H;
+
+				Vector< Vector< f32 > > mips;
+				TextureCompressor::GenerateMips( data, mNumberOfComponents, mWidth, mHeight, &mips );
+
+				// Equirectangular environments get their lighting precomputed once here, filtered from the uncompressed mips
+				mIBLData = ImageBasedLightingData( );
+				if ( mWidth == 2 * mHeight )
 				{
-					glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data ); 
-				} break;
+					ImageBasedLighting::Precompute( mips, mNumberOfComponents, mWidth, mHeight, &mIBLData );
+				}
 
-				default:
-				case 4: 
+				u32 width = mWidth, height = mHeight;
+				for ( auto& level : mips )
 				{
-					glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data ); 
-				} break;
-			}
+					if ( mCompression == TextureCompression::BC6H )
+					{
+						mMipData.emplace_back( );
+						TextureCompressor::CompressHDR( level.data( ), mNumberOfComponents, width, height, &mMipData.back( ) );
+					}
+					else
+					{
+						const u8* bytes = ( const u8* )level.data( );
+						mMipData.emplace_back( bytes, bytes + level.size( ) * sizeof( f32 ) );
+					}
 
-			s32 MAG_PARAM = GL_LINEAR;
-			s32 MIN_PARAM = GL_LINEAR_MIPMAP_LINEAR;
-			b8 genMips = true;
+					width = std::max( width / 2, 1u );
+					height = std::max( height / 2, 1u );
+				}
+			} break;
 
-			// Anisotropic filtering
-			float aniso = 0.0f; 
-			glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, aniso );
+			case TextureFormat::LDR:
+			{
+				const u8* data = ( const u8* )mSourceData->Cast< u32 >( )->GetData( );
 
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MAG_PARAM );
-			glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MIN_PARAM );
+				mCompression = ( compression == TextureCompression::BC6H ) ? TextureCompression::None : compression;
 
+				Vector< Vector< u8 > > mips;
+				TextureCompressor::GenerateMips( data, mWidth, mHeight, usage, &mips );
 
-			if ( genMips )
-			{
-				glGenerateMipmap( GL_TEXTURE_2D );
-			}
+				u32 width = mWidth, height = mHeight;
+				for ( auto& level : mips )
+				{
+					if ( mCompression != TextureCompression::None )
+					{
+						mMipData.emplace_back( );
+						TextureCompressor::Compress( mCompression, level.data( ), width, height, &mMipData.back( ) );
+					}
+					else
+					{
+						mMipData.emplace_back( std::move( level ) );
+					}
 
-			tex->mFormat = TextureFormat::LDR;
+					width = std::max( width / 2, 1u );
+					height = std::max( height / 2, 1u );
+				}
+			} break;
+		}
 
-			glBindTexture( GL_TEXTURE_2D, 0 ); 
-		} 
+		mMipCount = ( u32 )mMipData.size( );
+		mGenerateMipsOnUpload = false;
+		mMipRanges.clear( );
+		mResidentMip = 0;
 
-		// Set texture attributes
-		tex->mWidth = width;
-		tex->mHeight = height;
-		tex->mNumberOfComponents = nComps; 
+		// Source pixels are no longer needed once cooked
+		ReleaseSourceData( );
 
-		// Store file extension type of texture
-		tex->mFileExtension = Texture::GetFileExtensionType( fileExtension ); 
+		return Result::SUCCESS;
+	}
+
+	//=================================================
 
-		// Store texture data
-		switch ( tex->mFormat )
+	void Texture::ReleaseSourceData( )
+	{
+		if ( !mSourceData )
 		{
-			case TextureFormat::HDR:
+			return;
+		}
+
+		// Base has no virtual destructor, so has to be deleted as the type it was created with
+		switch ( mFormat )
+		{
+			case TextureFormat::HDR: delete static_cast< TextureSourceData< f32 >* >( mSourceData ); break;
+			case TextureFormat::LDR: delete static_cast< TextureSourceData< u32 >* >( mSourceData ); break;
+		}
+
+		mSourceData = nullptr;
+	}
+
+	//=================================================
+
+	INTERNAL GLenum GetCompressedInternalFormat( TextureCompression compression )
+	{
+		switch ( compression )
+		{
+			case TextureCompression::BC1:	return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case TextureCompression::BC3:	return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case TextureCompression::BC4:	return GL_COMPRESSED_RED_RGTC1;
+			case TextureCompression::BC5:	return GL_COMPRESSED_RG_RGTC2;
+			case TextureCompression::BC6H:	return GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT;
+			case TextureCompression::BC7:	return GL_COMPRESSED_RGBA_BPTC_UNORM;
+			default:						return 0;
+		}
+	}
+
+	//=================================================
+
+	void Texture::UploadMips( )
+	{
+		if ( mMipData.empty( ) )
+		{
+			return;
+		}
+
+		// Reloaded textures replace what they uploaded before
+		ReleaseGPUTexture( );
+
+		// Generate texture
+		glGenTextures( 1, &mId );
+		// Bind texture to be created
+		glBindTexture( GL_TEXTURE_2D, mId );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+		// Levels finer than resident mip were left in cache to be streamed
+		for ( u32 level = mResidentMip; level < ( u32 )mMipData.size( ); ++level )
+		{
+			UploadMipLevel( level, mMipData[ level ] );
+			mGPUMemoryBytes += mMipData[ level ].size( );
+		}
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+
+		if ( mGenerateMipsOnUpload )
+		{
+			glGenerateMipmap( GL_TEXTURE_2D );
+
+			// Full chain is roughly a third larger than its top level
+			mGPUMemoryBytes += mGPUMemoryBytes / 3;
+		}
+		else
+		{
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, ( s32 )mResidentMip );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, ( s32 )mMipData.size( ) - 1 );
+		}
+
+		// Single channel data is expanded back out to gray
+		if ( mCompression == TextureCompression::BC4 )
+		{
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_G, GL_RED );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_B, GL_RED );
+		}
+
+		// Anisotropic filtering
+		float aniso = 0.0f;
+		glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso );
+		if ( mFormat == TextureFormat::HDR )
+		{
+			aniso = std::min( aniso, 4.0f );
+		}
+		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, aniso );
+
+		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
+		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
+		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+		glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		if ( mIBLData.IsValid( ) && !mIBLMaps.mPrefilteredMap )
+		{
+			mIBLMaps = ImageBasedLighting::Upload( mIBLData, GetName( ) );
+		}
+
+		GPUMemoryTracker::Track( GPUResourceType::Texture, mId, mGPUMemoryBytes, "Texture Assets", GetName( ) );
+
+		// Finer levels come in once something on screen needs them
+		if ( mResidentMip )
+		{
+			EngineSubsystem( GraphicsSubsystem )->GetTextureStreamer( )->Register( this );
+		}
+	}
+
+	//=================================================
+
+	void Texture::UploadMipLevel( u32 level, const Vector< u8 >& data )
+	{
+		u32 width = std::max( mWidth >> level, 1u );
+		u32 height = std::max( mHeight >> level, 1u );
+
+		if ( mCompression != TextureCompression::None )
+		{
+			glCompressedTexImage2D( GL_TEXTURE_2D, level, GetCompressedInternalFormat( mCompression ), width, height, 0, ( GLsizei )data.size( ), data.data( ) );
+		}
+		else if ( mFormat == TextureFormat::HDR )
+		{
+			if ( mNumberOfComponents == 4 )
 			{
-				tex->mSourceData = new TextureSourceData< f32 >( (f32*)textureData, tex ); 
-			} break;
-			case TextureFormat::LDR: 
+				glTexImage2D( GL_TEXTURE_2D, level, GL_RGBA32F, width, height, 0, GL_RGBA, GL_FLOAT, data.data( ) );
+			}
+			else
 			{
-				tex->mSourceData = new TextureSourceData< u32 >( (u32*)textureData, tex ); 
-			} break;
+				glTexImage2D( GL_TEXTURE_2D, level, GL_RGB32F, width, height, 0, GL_RGB, GL_FLOAT, data.data( ) );
+			}
+		}
+		else
+		{
+			if ( mNumberOfComponents == 3 )
+			{
+				glTexImage2D( GL_TEXTURE_2D, level, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data.data( ) );
+			}
+			else
+			{
+				glTexImage2D( GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data( ) );
+			}
 		}
+	}
 
-		return tex; 
+	//=================================================
+
+	void Texture::StreamInMips( u32 first, const Vector< Vector< u8 > >& levels )
+	{
+		if ( !mId || first >= mResidentMip || levels.size( ) != mResidentMip - first )
+		{
+			return;
+		}
+
+		glBindTexture( GL_TEXTURE_2D, mId );
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+
+		for ( u32 level = first; level < mResidentMip; ++level )
+		{
+			const Vector< u8 >& data = levels[ level - first ];
+			UploadMipLevel( level, data );
+			mGPUMemoryBytes += data.size( );
+		}
+
+		// Only switched to once every level below is defined, so texture stays complete
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, ( s32 )first );
+
+		glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		mResidentMip = first;
+		GPUMemoryTracker::Track( GPUResourceType::Texture, mId, mGPUMemoryBytes, "Texture Assets", GetName( ) );
+	}
+
+	//=================================================
+
+	usize Texture::EvictMips( u32 first )
+	{
+		if ( !mId || first <= mResidentMip || first >= mMipCount )
+		{
+			return 0;
+		}
+
+		glBindTexture( GL_TEXTURE_2D, mId );
+		glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, ( s32 )first );
+
+		// Levels below base level don't affect completeness, so respecifying them empty releases their storage
+		usize freed = 0;
+		for ( u32 level = mResidentMip; level < first; ++level )
+		{
+			glTexImage2D( GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr );
+			freed += level < mMipRanges.size( ) ? mMipRanges[ level ].mSize : 0;
+		}
+
+		glBindTexture( GL_TEXTURE_2D, 0 );
+
+		mGPUMemoryBytes -= std::min( freed, mGPUMemoryBytes );
+		mResidentMip = first;
+		GPUMemoryTracker::Track( GPUResourceType::Texture, mId, mGPUMemoryBytes, "Texture Assets", GetName( ) );
+
+		return freed;
 	}
 
 	//=================================================
@@ -214,6 +475,30 @@ namespace Enjon
 
 	//=================================================
 
+	usize Texture::GetResidentMemoryUsage( ) const
+	{
+		if ( !mId )
+		{
+			usize bytes = 0;
+			for ( auto& level : mMipData )
+			{
+				bytes += level.size( );
+			}
+			return bytes;
+		}
+
+		if ( mGPUMemoryBytes )
+		{
+			return mGPUMemoryBytes + mIBLMaps.mGPUMemoryBytes;
+		}
+
+		// Textures created directly from a GL handle, only the top level is known
+		usize bytesPerComponent = ( mFormat == TextureFormat::HDR ) ? sizeof( f32 ) : sizeof( u8 );
+		return ( usize )mWidth * ( usize )mHeight * ( usize )mNumberOfComponents * bytesPerComponent;
+	}
+
+	//=================================================
+
 	u32 Texture::GetWidth() const
 	{
 		return mWidth;
@@ -235,233 +520,171 @@ namespace Enjon
 
 	//================================================= 
 
-	template void Texture::WriteTextureData< f32 >( ByteBuffer* buffer ) const;
-	template void Texture::WriteTextureData< u8 >( ByteBuffer* buffer ) const;
+	const ImageBasedLightingMaps* Texture::GetImageBasedLighting( ) const
+	{
+		return mIBLMaps.mPrefilteredMap ? &mIBLMaps : nullptr;
+	}
+
+	//================================================= 
 
-	template <typename T>
-	void Texture::WriteTextureData( ByteBuffer* buffer ) const
+	u32 Texture::GetMipCount( ) const
 	{
-		// Get raw data from source
-		const T* rawData = mSourceData->Cast< T >( )->GetData( );
+		return mMipCount;
+	}
 
-		// The pixel data consists of *y scanlines of *x pixels,
-		//	with each pixel consisting of N interleaved 8-bit components with no padding in between; the first
-		//	pixel pointed to is top-left-most in the image.  
-		u32 totalWidth = mWidth * mNumberOfComponents;
+	//================================================= 
 
-		for ( u32 h = 0; h < mHeight; ++h )
+	u32 Texture::GetResidentMip( ) const
+	{
+		return mResidentMip;
+	}
+
+	//================================================= 
+
+	u32 Texture::GetStreamingTailMip( ) const
+	{
+		u32 level = 0;
+		while ( level + 1 < mMipCount && std::max( mWidth >> level, mHeight >> level ) > ENJON_TEXTURE_STREAMING_TAIL_SIZE )
 		{
-			for ( u32 w = 0; w < totalWidth; ++w )
-			{
-				// Get index of indvidual interleaved pixel
-				u32 pixelIndex = totalWidth * h + w; 
-				// Raw pixel 
-				T pixel = rawData[ pixelIndex ]; 
-				// Write individual pixel to archive
-				buffer->Write< T >( pixel );
-			}
-		} 
+			++level;
+		}
+		return level;
 	}
 
+	//================================================= 
+
 	Result Texture::SerializeData( ByteBuffer* buffer ) const 
 	{
-		std::cout << "Serializing texture...\n";
-
-		// Keep around texture data resource object for serialization purposes
-		// Will be compiled out with release of application and only defined as being with editor data
+		// Cooked data is released once written, so there's nothing left to save for textures that have already been cached
+		if ( mMipData.empty( ) )
+		{
+			return Result::FAILURE;
+		}
 
 		// Write out basic header info for texture 
-		buffer->Write< u32 >( mWidth );					// Texture width
-		buffer->Write< u32 >( mHeight );				// Texture height
-		buffer->Write< u32 >( mNumberOfComponents );	// Texture components per pixel
-		buffer->Write< u32 >( ( u32 )mFormat );			// Texture format
-		buffer->Write< u32 >( ( u32 )mFileExtension );	// Texture file extension
-
-		switch ( mFormat )
+		buffer->Write< u32 >( ENJON_TEXTURE_COOKED_MAGIC );	// Marks cooked layout
+		buffer->Write< u32 >( mWidth );						// Texture width
+		buffer->Write< u32 >( mHeight );					// Texture height
+		buffer->Write< u32 >( mNumberOfComponents );		// Texture components per pixel
+		buffer->Write< u32 >( ( u32 )mFormat );				// Texture format
+		buffer->Write< u32 >( ( u32 )mFileExtension );		// Texture file extension
+		buffer->Write< u32 >( ( u32 )mCompression );		// Block compression of mips
+		buffer->Write< u32 >( ( u32 )mMipData.size( ) );	// Mip count
+
+		// Mips, largest first
+		for ( auto& level : mMipData )
 		{
-			case TextureFormat::HDR:
-			{
-				// Write texture data
-				WriteTextureData< f32 >( buffer );
+			buffer->Write< u32 >( ( u32 )level.size( ) );
+			buffer->WriteBytes( level.data( ), ( u32 )level.size( ) );
+		}
 
-				// Release source data after serializing
-				const_cast< TextureSourceData< f32 >* >( mSourceData->Cast< f32 >( ) )->ReleaseData( );
-			} break;
+		// Precomputed lighting trails mips, so caches without it still read
+		if ( mIBLData.IsValid( ) )
+		{
+			ImageBasedLighting::Serialize( mIBLData, buffer );
+		}
 
-			case TextureFormat::LDR:
-			{
-				// Write texture data
-				WriteTextureData< u8 >( buffer );
-
-				// Release source data after serializing
-				const_cast< TextureSourceData< u8 >* >( mSourceData->Cast< u8 >( ) )->ReleaseData( ); 
-			} break;
-		} 
+		// Release cooked data after serializing
+		Texture* self = const_cast< Texture* >( this );
+		self->mMipData.clear( );
+		self->mMipData.shrink_to_fit( );
+		self->mIBLData = ImageBasedLightingData( );
 
 		return Result::SUCCESS;
 	} 
 	
 	Result Texture::DeserializeData( ByteBuffer* buffer )
 	{
-		std::cout << "Deserializing texture...\n";
+		u32 magic = buffer->Read< u32 >( );
+
+		// Textures cached before cooking store raw top level pixels, with mips generated on upload
+		if ( magic != ENJON_TEXTURE_COOKED_MAGIC )
+		{
+			mWidth				= magic;											// Texture width
+			mHeight				= buffer->Read< u32 >( );							// Texture height
+			mNumberOfComponents = buffer->Read< u32 >( );							// Texture components per pixel
+			mFormat				= TextureFormat( buffer->Read< u32 >( ) );			// Texture format
+			mFileExtension		= TextureFileExtension( buffer->Read< u32 >( ) );	// Texture file extension
+			mCompression		= TextureCompression::None;
+			mMipCount			= 1;
+			mGenerateMipsOnUpload = true;
+			mMipRanges.clear( );
+			mResidentMip		= 0;
+
+			usize bytesPerComponent = ( mFormat == TextureFormat::HDR ) ? sizeof( f32 ) : sizeof( u8 );
+			mMipData.resize( 1 );
+			mMipData[ 0 ].resize( ( usize )mWidth * mHeight * mNumberOfComponents * bytesPerComponent );
+			return buffer->ReadBytes( mMipData[ 0 ].data( ), ( u32 )mMipData[ 0 ].size( ) ) ? Result::SUCCESS : Result::FAILURE;
+		}
 
-		// Read properties from buffer - THIS SHOULD BE USED WITH A VERSIONING STRUCT!
 		mWidth				= buffer->Read< u32 >( );							// Texture width
 		mHeight				= buffer->Read< u32 >( );							// Texture height
 		mNumberOfComponents = buffer->Read< u32 >( );							// Texture components per pixel
 		mFormat				= TextureFormat( buffer->Read< u32 >( ) );			// Texture format
-		mFileExtension		= TextureFileExtension( buffer->Read< u32 >( ) );	// Texture format
-
-		switch ( mFormat )
+		mFileExtension		= TextureFileExtension( buffer->Read< u32 >( ) );	// Texture file extension
+		mCompression		= TextureCompression( buffer->Read< u32 >( ) );		// Block compression of mips
+		mMipCount			= buffer->Read< u32 >( );							// Mip count
+		mGenerateMipsOnUpload = false;
+
+		// Only the mip tail is kept when streaming. Finer levels are skipped over, remembering where they are to read them later.
+		mResidentMip = TextureStreamer::IsEnabled( ) ? GetStreamingTailMip( ) : 0;
+
+		// Mips are only read here. Upload happens in DeserializeLateInit, since this can be run on a worker thread.
+		mMipData.clear( );
+		mMipData.resize( mMipCount );
+		mMipRanges.resize( mMipCount );
+		for ( u32 level = 0; level < mMipCount; ++level )
 		{
-			case TextureFormat::HDR:
-			{ 
-				// Total width of pixel array
-				u32 totalWidth = mWidth * mNumberOfComponents;
-				// Buffer for pixel data
-				f32* pixelData = new f32[ mHeight * totalWidth]; 
-
-				// Fill out pixel data
-				for ( u32 h = 0; h < mHeight; ++h ) 
-				{
-					for ( u32 w = 0; w < totalWidth; ++w )
-					{
-						// Get index of indvidual interleaved pixel
-						u32 pixelIndex = totalWidth * h + w; 
-						// Read individual pixel from archive
-						pixelData[ pixelIndex ] = buffer->Read< f32 >( );
-					}
-				} 
-
-				// Generate texture
-				glGenTextures( 1, &( mId ) ); 
-				// Bind texture to be created
-				glBindTexture( GL_TEXTURE_2D, mId );
+			TextureMipRange& range = mMipRanges[ level ];
+			range.mSize = buffer->Read< u32 >( );
+			range.mOffset = buffer->GetReadPosition( );
 
-				switch ( mNumberOfComponents )
+			if ( level < mResidentMip )
+			{
+				if ( range.mOffset + range.mSize > buffer->GetSize( ) )
 				{
-					default:
-					case 3: 
-					{
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB32F, mWidth, mHeight, 0, GL_RGB, GL_FLOAT, pixelData );
-					} break;
-
-					case 4: 
-					{
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA32F, mWidth, mHeight, 0, GL_RGB, GL_FLOAT, pixelData );
-					} break;
+					mMipData.clear( );
+					return Result::FAILURE;
 				}
+				buffer->SetReadPosition( range.mOffset + range.mSize );
+				continue;
+			}
 
-				s32 MAG_PARAM = GL_LINEAR;
-				s32 MIN_PARAM = GL_LINEAR_MIPMAP_LINEAR;
-				b8 genMips = true;
-
-				// Anisotropic filtering
-				float aniso = 0.0f;
-				glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso );
-				aniso = std::min( aniso, 4.0f );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, aniso );
-
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MAG_PARAM );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MIN_PARAM );
-
-				if ( genMips )
-				{
-					glGenerateMipmap( GL_TEXTURE_2D );
-				} 
-
-				glBindTexture( GL_TEXTURE_2D, 0 );
-
-				// Clean up pixel data once done
-				delete[] pixelData;
-				pixelData = nullptr;
-			} break;
-
-			case TextureFormat::LDR:
-			{ 
-				// Buffer for pixel data
-				u8* pixelData = new u8[ mHeight * mWidth * mNumberOfComponents ];
-
-				u32 totalWidth = mWidth * mNumberOfComponents;
-
-				for ( u32 h = 0; h < mHeight; ++h ) 
-				{
-					for ( u32 w = 0; w < totalWidth; ++w )
-					{
-						// Get index of indvidual interleaved pixel
-						u32 pixelIndex = totalWidth * h + w; 
-						// Read individual pixel from archive
-						pixelData[ pixelIndex ] = buffer->Read< u8 >( );
-					}
-				} 
-
-				// Generate texture
-				glGenTextures( 1, &( mId ) ); 
-				// Bind texture to be created
-				glBindTexture( GL_TEXTURE_2D, mId );
+			mMipData[ level ].resize( range.mSize );
+			if ( !buffer->ReadBytes( mMipData[ level ].data( ), range.mSize ) )
+			{
+				mMipData.clear( );
+				return Result::FAILURE;
+			}
+		}
 
-				switch ( mNumberOfComponents )
-				{
-					default:
-					case 3: 
-					{
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGB8, mWidth, mHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, pixelData ); 
-					} break;
+		// Optional lighting block. Failing to read it only costs the environment its precomputed lighting.
+		mIBLData = ImageBasedLightingData( );
+		if ( buffer->GetReadPosition( ) < buffer->GetSize( ) )
+		{
+			ImageBasedLighting::Deserialize( buffer, &mIBLData );
+		}
 
-					case 4: 
-					{
-						glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA8, mWidth, mHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixelData ); 
-					} break;
-				}
+		return Result::SUCCESS;
+	}
 
-				//s32 MAG_PARAM = GL_LINEAR;
-				//s32 MIN_PARAM = GL_LINEAR_MIPMAP_LINEAR;
-				//b8 genMips = true;
-				
-				s32 MAG_PARAM = GL_NEAREST;
-				s32 MIN_PARAM = GL_NEAREST;
-				b8 genMips = false;
-
-				// Anisotropic filtering
-				float aniso = 0.0f;
-				glGetFloatv( GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &aniso );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, aniso );
-
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, MAG_PARAM );
-				glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, MIN_PARAM );
-
-				if ( genMips )
-				{
-					glGenerateMipmap( GL_TEXTURE_2D );
-				} 
+	//=================================================
 
-				glBindTexture( GL_TEXTURE_2D, 0 ); 
+	Result Texture::DeserializeLateInit( )
+	{
+		// Nothing read to upload
+		if ( mMipData.empty( ) )
+		{
+			return Result::SUCCESS;
+		}
 
-				// Clean up pixel data once done
-				delete[] pixelData;
-				pixelData = nullptr; 
+		UploadMips( );
 
-			} break;
-		} 
+		// Clean up mips once uploaded
+		mMipData.clear( );
+		mMipData.shrink_to_fit( );
+		mIBLData = ImageBasedLightingData( );
 
 		return Result::SUCCESS;
 	}
 }
-
-
-
-
-
-
-
-
-
-
-
-
-
-
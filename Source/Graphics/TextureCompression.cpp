@@ -0,0 +1,1025 @@
+// @file TextureCompression.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/TextureCompression.h"
+#include "System/JobSystem.h"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <cctype>
+
+// Gamma used to move color data into linear space for filtering
+#define ENJON_TEXTURE_MIP_GAMMA		2.2f
+
+namespace Enjon
+{
+	// Interpolation weights ( out of 64 ) for 4 bit indices, shared by BC6H and BC7
+	INTERNAL const u32 kBC4BitWeights[ 16 ] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	// Weight of first endpoint for each BC1 index in four color mode
+	INTERNAL const f32 kBC1Weights[ 4 ] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	//=================================================================
+
+	/*
+	* @brief Writes fields LSB first into a zeroed 128 bit block, as BC6H and BC7 expect
+	*/
+	struct BlockBitWriter
+	{
+		BlockBitWriter( u8* data )
+			: mData( data )
+		{
+		}
+
+		void Write( u32 value, u32 count )
+		{
+			for ( u32 i = 0; i < count; ++i, ++mBit )
+			{
+				if ( ( value >> i ) & 1 )
+				{
+					mData[ mBit >> 3 ] |= ( u8 )( 1 << ( mBit & 7 ) );
+				}
+			}
+		}
+
+		u8* mData = nullptr;
+		u32 mBit = 0;
+	};
+
+	//=================================================================
+
+	INTERNAL inline f32 ClampFloat( f32 v, f32 lo, f32 hi )
+	{
+		return v < lo ? lo : ( v > hi ? hi : v );
+	}
+
+	//=================================================================
+
+	INTERNAL void FetchBlock( const u8* rgba, u32 width, u32 height, u32 bx, u32 by, f32 block[ 16 ][ 4 ] )
+	{
+		// Edge blocks repeat the last row / column so partial blocks don't pull endpoints towards garbage
+		for ( u32 y = 0; y < 4; ++y )
+		{
+			u32 sy = std::min( by * 4 + y, height - 1 );
+			for ( u32 x = 0; x < 4; ++x )
+			{
+				u32 sx = std::min( bx * 4 + x, width - 1 );
+				const u8* src = rgba + ( ( usize )sy * width + sx ) * 4;
+				for ( u32 c = 0; c < 4; ++c )
+				{
+					block[ y * 4 + x ][ c ] = ( f32 )src[ c ];
+				}
+			}
+		}
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Fits a line through the block along its principal axis and returns the extents of the block along it
+	*/
+	INTERNAL void FitEndpoints( const f32 block[ 16 ][ 4 ], u32 channels, f32 lo[ 4 ], f32 hi[ 4 ] )
+	{
+		f32 mean[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			for ( u32 c = 0; c < channels; ++c )
+			{
+				mean[ c ] += block[ i ][ c ] / 16.0f;
+			}
+		}
+
+		f32 cov[ 4 ][ 4 ] = { };
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			for ( u32 a = 0; a < channels; ++a )
+			{
+				for ( u32 b = 0; b < channels; ++b )
+				{
+					cov[ a ][ b ] += ( block[ i ][ a ] - mean[ a ] ) * ( block[ i ][ b ] - mean[ b ] );
+				}
+			}
+		}
+
+		// Power iteration, starting from the channel with most spread
+		u32 start = 0;
+		for ( u32 c = 1; c < channels; ++c )
+		{
+			if ( cov[ c ][ c ] > cov[ start ][ start ] )
+			{
+				start = c;
+			}
+		}
+
+		f32 axis[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		axis[ start ] = 1.0f;
+		for ( u32 iter = 0; iter < 8; ++iter )
+		{
+			f32 next[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			f32 length = 0.0f;
+			for ( u32 a = 0; a < channels; ++a )
+			{
+				for ( u32 b = 0; b < channels; ++b )
+				{
+					next[ a ] += cov[ a ][ b ] * axis[ b ];
+				}
+				length += next[ a ] * next[ a ];
+			}
+
+			// Flat block, any axis will do
+			if ( length < 1e-12f )
+			{
+				break;
+			}
+
+			length = sqrtf( length );
+			for ( u32 c = 0; c < channels; ++c )
+			{
+				axis[ c ] = next[ c ] / length;
+			}
+		}
+
+		f32 tMin = FLT_MAX;
+		f32 tMax = -FLT_MAX;
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			f32 t = 0.0f;
+			for ( u32 c = 0; c < channels; ++c )
+			{
+				t += ( block[ i ][ c ] - mean[ c ] ) * axis[ c ];
+			}
+			tMin = std::min( tMin, t );
+			tMax = std::max( tMax, t );
+		}
+
+		for ( u32 c = 0; c < channels; ++c )
+		{
+			lo[ c ] = mean[ c ] + axis[ c ] * tMin;
+			hi[ c ] = mean[ c ] + axis[ c ] * tMax;
+		}
+	}
+
+	//=================================================================
+
+	INTERNAL u16 PackRGB565( const f32 color[ 4 ] )
+	{
+		u32 r = ( u32 )ClampFloat( color[ 0 ] * 31.0f / 255.0f + 0.5f, 0.0f, 31.0f );
+		u32 g = ( u32 )ClampFloat( color[ 1 ] * 63.0f / 255.0f + 0.5f, 0.0f, 63.0f );
+		u32 b = ( u32 )ClampFloat( color[ 2 ] * 31.0f / 255.0f + 0.5f, 0.0f, 31.0f );
+		return ( u16 )( ( r << 11 ) | ( g << 5 ) | b );
+	}
+
+	//=================================================================
+
+	INTERNAL void UnpackRGB565( u16 packed, f32 color[ 4 ] )
+	{
+		u32 r = ( packed >> 11 ) & 31;
+		u32 g = ( packed >> 5 ) & 63;
+		u32 b = packed & 31;
+		color[ 0 ] = ( f32 )( ( r << 3 ) | ( r >> 2 ) );
+		color[ 1 ] = ( f32 )( ( g << 2 ) | ( g >> 4 ) );
+		color[ 2 ] = ( f32 )( ( b << 3 ) | ( b >> 2 ) );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Picks nearest of the four palette colors for each pixel. Endpoints must be ordered c0 > c1.
+	*/
+	INTERNAL u32 ComputeColorIndices( const f32 block[ 16 ][ 4 ], u16 c0, u16 c1, u32 indices[ 16 ], f32* error )
+	{
+		f32 palette[ 4 ][ 4 ];
+		UnpackRGB565( c0, palette[ 0 ] );
+		UnpackRGB565( c1, palette[ 1 ] );
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			palette[ 2 ][ c ] = ( 2.0f * palette[ 0 ][ c ] + palette[ 1 ][ c ] ) / 3.0f;
+			palette[ 3 ][ c ] = ( palette[ 0 ][ c ] + 2.0f * palette[ 1 ][ c ] ) / 3.0f;
+		}
+
+		// Identical endpoints would select three color mode in BC1, so only the first entry can be used
+		u32 paletteSize = ( c0 == c1 ) ? 1 : 4;
+
+		u32 packed = 0;
+		*error = 0.0f;
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			f32 best = FLT_MAX;
+			u32 bestIndex = 0;
+			for ( u32 p = 0; p < paletteSize; ++p )
+			{
+				f32 d = 0.0f;
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					f32 diff = block[ i ][ c ] - palette[ p ][ c ];
+					d += diff * diff;
+				}
+				if ( d < best )
+				{
+					best = d;
+					bestIndex = p;
+				}
+			}
+
+			indices[ i ] = bestIndex;
+			packed |= bestIndex << ( 2 * i );
+			*error += best;
+		}
+
+		return packed;
+	}
+
+	//=================================================================
+
+	INTERNAL void OrderColorEndpoints( u16* c0, u16* c1 )
+	{
+		if ( *c0 < *c1 )
+		{
+			std::swap( *c0, *c1 );
+		}
+	}
+
+	//=================================================================
+
+	INTERNAL void WriteColorBlock( u16 c0, u16 c1, u32 indices, u8* out )
+	{
+		memcpy( out, &c0, sizeof( u16 ) );
+		memcpy( out + 2, &c1, sizeof( u16 ) );
+		memcpy( out + 4, &indices, sizeof( u32 ) );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Four color BC1 block. Used on its own for BC1 and as the color half of BC3.
+	*/
+	INTERNAL void EncodeColorBlock( const f32 block[ 16 ][ 4 ], u8* out )
+	{
+		f32 lo[ 4 ], hi[ 4 ];
+		FitEndpoints( block, 3, lo, hi );
+
+		u16 c0 = PackRGB565( hi );
+		u16 c1 = PackRGB565( lo );
+		OrderColorEndpoints( &c0, &c1 );
+
+		u32 indices[ 16 ];
+		f32 error;
+		u32 packed = ComputeColorIndices( block, c0, c1, indices, &error );
+
+		// One least squares pass over the chosen indices to pull endpoints off the block extents
+		if ( c0 != c1 && error > 0.0f )
+		{
+			f32 aa = 0.0f, bb = 0.0f, ab = 0.0f;
+			f32 ax[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			f32 bx[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for ( u32 i = 0; i < 16; ++i )
+			{
+				f32 a = kBC1Weights[ indices[ i ] ];
+				f32 b = 1.0f - a;
+				aa += a * a;
+				bb += b * b;
+				ab += a * b;
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					ax[ c ] += a * block[ i ][ c ];
+					bx[ c ] += b * block[ i ][ c ];
+				}
+			}
+
+			f32 det = aa * bb - ab * ab;
+			if ( fabsf( det ) > 1e-6f )
+			{
+				f32 e0[ 4 ], e1[ 4 ];
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					e0[ c ] = ( ax[ c ] * bb - bx[ c ] * ab ) / det;
+					e1[ c ] = ( bx[ c ] * aa - ax[ c ] * ab ) / det;
+				}
+
+				u16 r0 = PackRGB565( e0 );
+				u16 r1 = PackRGB565( e1 );
+				OrderColorEndpoints( &r0, &r1 );
+
+				u32 refinedIndices[ 16 ];
+				f32 refinedError;
+				u32 refinedPacked = ComputeColorIndices( block, r0, r1, refinedIndices, &refinedError );
+				if ( refinedError < error )
+				{
+					c0 = r0;
+					c1 = r1;
+					packed = refinedPacked;
+				}
+			}
+		}
+
+		WriteColorBlock( c0, c1, packed, out );
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Eight value BC4 block for a single channel. Used for BC4, both halves of BC5 and the alpha half of BC3.
+	*/
+	INTERNAL void EncodeChannelBlock( const f32 block[ 16 ][ 4 ], u32 channel, u8* out )
+	{
+		u32 lo = 255, hi = 0;
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			u32 v = ( u32 )block[ i ][ channel ];
+			lo = std::min( lo, v );
+			hi = std::max( hi, v );
+		}
+
+		out[ 0 ] = ( u8 )hi;
+		out[ 1 ] = ( u8 )lo;
+
+		// Codes 0 and 1 are the endpoints, 2 to 7 step from the first towards the second
+		u32 palette[ 8 ];
+		palette[ 0 ] = hi;
+		palette[ 1 ] = lo;
+		for ( u32 k = 2; k < 8; ++k )
+		{
+			palette[ k ] = ( ( 8 - k ) * hi + ( k - 1 ) * lo ) / 7;
+		}
+
+		u64 bits = 0;
+		if ( hi != lo )
+		{
+			for ( u32 i = 0; i < 16; ++i )
+			{
+				s32 v = ( s32 )block[ i ][ channel ];
+				u32 bestCode = 0;
+				s32 best = 256;
+				for ( u32 k = 0; k < 8; ++k )
+				{
+					s32 d = std::abs( v - ( s32 )palette[ k ] );
+					if ( d < best )
+					{
+						best = d;
+						bestCode = k;
+					}
+				}
+				bits |= ( u64 )bestCode << ( 3 * i );
+			}
+		}
+
+		for ( u32 i = 0; i < 6; ++i )
+		{
+			out[ 2 + i ] = ( u8 )( bits >> ( 8 * i ) );
+		}
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Quantizes an RGBA endpoint to 7 bits per channel plus a shared p bit, picking the p bit with least error
+	*/
+	INTERNAL void QuantizeBC7Endpoint( const f32 endpoint[ 4 ], u32 quantized[ 4 ], u32* pBit )
+	{
+		f32 bestError = FLT_MAX;
+		for ( u32 p = 0; p < 2; ++p )
+		{
+			u32 q[ 4 ];
+			f32 error = 0.0f;
+			for ( u32 c = 0; c < 4; ++c )
+			{
+				q[ c ] = ( u32 )ClampFloat( ( endpoint[ c ] - ( f32 )p ) / 2.0f + 0.5f, 0.0f, 127.0f );
+				f32 diff = ( f32 )( ( q[ c ] << 1 ) | p ) - endpoint[ c ];
+				error += diff * diff;
+			}
+
+			if ( error < bestError )
+			{
+				bestError = error;
+				*pBit = p;
+				memcpy( quantized, q, sizeof( q ) );
+			}
+		}
+	}
+
+	//=================================================================
+
+	/*
+	* @brief BC7 mode 6: a single RGBA line with 7777.1 endpoints and 4 bit indices
+	*/
+	INTERNAL void EncodeBC7Block( const f32 block[ 16 ][ 4 ], u8* out )
+	{
+		f32 lo[ 4 ], hi[ 4 ];
+		FitEndpoints( block, 4, lo, hi );
+
+		u32 q[ 2 ][ 4 ];
+		u32 p[ 2 ];
+		QuantizeBC7Endpoint( lo, q[ 0 ], &p[ 0 ] );
+		QuantizeBC7Endpoint( hi, q[ 1 ], &p[ 1 ] );
+
+		f32 palette[ 16 ][ 4 ];
+		for ( u32 k = 0; k < 16; ++k )
+		{
+			for ( u32 c = 0; c < 4; ++c )
+			{
+				u32 e0 = ( q[ 0 ][ c ] << 1 ) | p[ 0 ];
+				u32 e1 = ( q[ 1 ][ c ] << 1 ) | p[ 1 ];
+				palette[ k ][ c ] = ( f32 )( ( ( 64 - kBC4BitWeights[ k ] ) * e0 + kBC4BitWeights[ k ] * e1 + 32 ) >> 6 );
+			}
+		}
+
+		u32 indices[ 16 ];
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			f32 best = FLT_MAX;
+			for ( u32 k = 0; k < 16; ++k )
+			{
+				f32 d = 0.0f;
+				for ( u32 c = 0; c < 4; ++c )
+				{
+					f32 diff = block[ i ][ c ] - palette[ k ][ c ];
+					d += diff * diff;
+				}
+				if ( d < best )
+				{
+					best = d;
+					indices[ i ] = k;
+				}
+			}
+		}
+
+		// Anchor index is stored without its top bit, so it has to be in the lower half of the range
+		if ( indices[ 0 ] & 8 )
+		{
+			std::swap( q[ 0 ], q[ 1 ] );
+			std::swap( p[ 0 ], p[ 1 ] );
+			for ( u32 i = 0; i < 16; ++i )
+			{
+				indices[ i ] = 15 - indices[ i ];
+			}
+		}
+
+		memset( out, 0, 16 );
+		BlockBitWriter writer( out );
+		writer.Write( 1 << 6, 7 );
+		for ( u32 c = 0; c < 4; ++c )
+		{
+			writer.Write( q[ 0 ][ c ], 7 );
+			writer.Write( q[ 1 ][ c ], 7 );
+		}
+		writer.Write( p[ 0 ], 1 );
+		writer.Write( p[ 1 ], 1 );
+		writer.Write( indices[ 0 ], 3 );
+		for ( u32 i = 1; i < 16; ++i )
+		{
+			writer.Write( indices[ i ], 4 );
+		}
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Converts non negative float to half float bits, clamping to largest finite half
+	*/
+	INTERNAL u32 FloatToHalf( f32 value )
+	{
+		// Also catches NaN
+		if ( !( value > 0.0f ) )
+		{
+			return 0;
+		}
+
+		if ( value >= 65504.0f )
+		{
+			return 0x7BFF;
+		}
+
+		u32 bits;
+		memcpy( &bits, &value, sizeof( u32 ) );
+		s32 exponent = ( s32 )( ( bits >> 23 ) & 0xFF ) - 127 + 15;
+		u32 mantissa = bits & 0x7FFFFF;
+
+		// Denormal half
+		if ( exponent <= 0 )
+		{
+			if ( exponent < -10 )
+			{
+				return 0;
+			}
+			mantissa |= 0x800000;
+			u32 shift = ( u32 )( 14 - exponent );
+			return ( mantissa + ( 1u << ( shift - 1 ) ) ) >> shift;
+		}
+
+		u32 half = ( ( u32 )exponent << 10 ) | ( mantissa >> 13 );
+		half += ( mantissa >> 12 ) & 1;
+		return std::min( half, ( u32 )0x7BFF );
+	}
+
+	//=================================================================
+
+	INTERNAL inline u32 UnquantizeBC6H( u32 value )
+	{
+		if ( value == 0 )
+		{
+			return 0;
+		}
+		if ( value == 1023 )
+		{
+			return 0xFFFF;
+		}
+		return ( ( value << 16 ) + 0x8000 ) >> 10;
+	}
+
+	//=================================================================
+
+	INTERNAL inline u32 FinishUnquantizeBC6H( u32 value )
+	{
+		return ( value * 31 ) >> 6;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Finds 10 bit endpoint value that decodes closest to given half float bits
+	*/
+	INTERNAL u32 QuantizeBC6H( f32 half )
+	{
+		s32 estimate = ( s32 )( ClampFloat( half, 0.0f, ( f32 )0x7BFF ) / 31.0f + 0.5f );
+		u32 bestValue = 0;
+		f32 best = FLT_MAX;
+		for ( s32 v = estimate - 1; v <= estimate + 1; ++v )
+		{
+			if ( v < 0 || v > 1023 )
+			{
+				continue;
+			}
+
+			f32 d = fabsf( ( f32 )FinishUnquantizeBC6H( UnquantizeBC6H( ( u32 )v ) ) - half );
+			if ( d < best )
+			{
+				best = d;
+				bestValue = ( u32 )v;
+			}
+		}
+		return bestValue;
+	}
+
+	//=================================================================
+
+	/*
+	* @brief BC6H mode 11: a single RGB line with 10 bit endpoints and 4 bit indices. Block holds half float bits,
+	*			which are close to logarithmic, so fitting in that space spreads error evenly across exposure.
+	*/
+	INTERNAL void EncodeBC6HBlock( const f32 block[ 16 ][ 4 ], u8* out )
+	{
+		f32 lo[ 4 ], hi[ 4 ];
+		FitEndpoints( block, 3, lo, hi );
+
+		u32 e[ 2 ][ 3 ];
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			e[ 0 ][ c ] = QuantizeBC6H( lo[ c ] );
+			e[ 1 ][ c ] = QuantizeBC6H( hi[ c ] );
+		}
+
+		f32 palette[ 16 ][ 3 ];
+		for ( u32 k = 0; k < 16; ++k )
+		{
+			for ( u32 c = 0; c < 3; ++c )
+			{
+				u32 u0 = UnquantizeBC6H( e[ 0 ][ c ] );
+				u32 u1 = UnquantizeBC6H( e[ 1 ][ c ] );
+				u32 interp = ( ( 64 - kBC4BitWeights[ k ] ) * u0 + kBC4BitWeights[ k ] * u1 + 32 ) >> 6;
+				palette[ k ][ c ] = ( f32 )FinishUnquantizeBC6H( interp );
+			}
+		}
+
+		u32 indices[ 16 ];
+		for ( u32 i = 0; i < 16; ++i )
+		{
+			f32 best = FLT_MAX;
+			for ( u32 k = 0; k < 16; ++k )
+			{
+				f32 d = 0.0f;
+				for ( u32 c = 0; c < 3; ++c )
+				{
+					f32 diff = block[ i ][ c ] - palette[ k ][ c ];
+					d += diff * diff;
+				}
+				if ( d < best )
+				{
+					best = d;
+					indices[ i ] = k;
+				}
+			}
+		}
+
+		// Same anchor rule as BC7
+		if ( indices[ 0 ] & 8 )
+		{
+			std::swap( e[ 0 ], e[ 1 ] );
+			for ( u32 i = 0; i < 16; ++i )
+			{
+				indices[ i ] = 15 - indices[ i ];
+			}
+		}
+
+		memset( out, 0, 16 );
+		BlockBitWriter writer( out );
+		writer.Write( 0x03, 5 );
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			writer.Write( e[ 0 ][ c ], 10 );
+		}
+		for ( u32 c = 0; c < 3; ++c )
+		{
+			writer.Write( e[ 1 ][ c ], 10 );
+		}
+		writer.Write( indices[ 0 ], 3 );
+		for ( u32 i = 1; i < 16; ++i )
+		{
+			writer.Write( indices[ i ], 4 );
+		}
+	}
+
+	//=================================================================
+
+	/*
+	* @brief Gamma to linear lookup for 8 bit color
+	*/
+	struct LinearColorTable
+	{
+		LinearColorTable( )
+		{
+			for ( u32 i = 0; i < 256; ++i )
+			{
+				mValues[ i ] = powf( ( f32 )i / 255.0f, ENJON_TEXTURE_MIP_GAMMA );
+			}
+		}
+
+		f32 mValues[ 256 ];
+	};
+
+	//=================================================================
+
+	u32 TextureCompressor::GetMipCount( u32 width, u32 height )
+	{
+		u32 count = 1;
+		while ( width > 1 || height > 1 )
+		{
+			width = std::max( width / 2, 1u );
+			height = std::max( height / 2, 1u );
+			++count;
+		}
+		return count;
+	}
+
+	//=================================================================
+
+	u32 TextureCompressor::GetBlockSize( TextureCompression compression )
+	{
+		switch ( compression )
+		{
+			case TextureCompression::BC1:
+			case TextureCompression::BC4:
+				return 8;
+
+			case TextureCompression::BC3:
+			case TextureCompression::BC5:
+			case TextureCompression::BC6H:
+			case TextureCompression::BC7:
+				return 16;
+
+			default:
+			case TextureCompression::None:
+				return 0;
+		}
+	}
+
+	//=================================================================
+
+	usize TextureCompressor::GetLevelSize( TextureCompression compression, TextureFormat format, u32 components, u32 width, u32 height )
+	{
+		u32 blockSize = GetBlockSize( compression );
+		if ( blockSize )
+		{
+			return ( usize )( ( width + 3 ) / 4 ) * ( usize )( ( height + 3 ) / 4 ) * blockSize;
+		}
+
+		usize pixelSize = ( format == TextureFormat::HDR ) ? components * sizeof( f32 ) : 4;
+		return ( usize )width * ( usize )height * pixelSize;
+	}
+
+	//=================================================================
+
+	TextureUsage TextureCompressor::GetUsageFromFilePath( const String& filePath )
+	{
+		// File name without directory or extension
+		usize start = filePath.find_last_of( "/\\" );
+		start = ( start == String::npos ) ? 0 : start + 1;
+		usize end = filePath.find_last_of( '.' );
+		end = ( end == String::npos || end < start ) ? filePath.size( ) : end;
+
+		String name = filePath.substr( start, end - start );
+		std::transform( name.begin( ), name.end( ), name.begin( ), []( char c ) { return ( char )std::tolower( ( u8 )c ); } );
+
+		auto endsWith = [ &name ]( const char* suffix )
+		{
+			usize length = strlen( suffix );
+			return name.size( ) >= length && name.compare( name.size( ) - length, length, suffix ) == 0;
+		};
+
+		if ( name.find( "normal" ) != String::npos || endsWith( "_n" ) || endsWith( "_nrm" ) || endsWith( "_nor" ) )
+		{
+			return TextureUsage::Normal;
+		}
+
+		const char* dataNames[ ] = { "rough", "metal", "occlusion", "gloss", "specular", "height", "displace", "mask" };
+		for ( auto& n : dataNames )
+		{
+			if ( name.find( n ) != String::npos )
+			{
+				return TextureUsage::Data;
+			}
+		}
+
+		if ( endsWith( "_ao" ) || endsWith( "_orm" ) || endsWith( "_mra" ) )
+		{
+			return TextureUsage::Data;
+		}
+
+		return TextureUsage::Color;
+	}
+
+	//=================================================================
+
+	TextureCompression TextureCompressor::SelectCompression( TextureUsage usage, const u8* rgba, u32 width, u32 height, bool highQuality )
+	{
+		bool opaque = true;
+		bool grayscale = true;
+		bool noBlue = true;
+
+		usize count = ( usize )width * ( usize )height;
+		for ( usize i = 0; i < count; ++i )
+		{
+			const u8* p = rgba + i * 4;
+			opaque &= ( p[ 3 ] == 255 );
+			grayscale &= ( p[ 0 ] == p[ 1 ] && p[ 1 ] == p[ 2 ] );
+			noBlue &= ( p[ 2 ] == 0 );
+		}
+
+		// Two channel data ( including normal maps with only x and y stored ) gets a block per channel
+		if ( opaque && noBlue )
+		{
+			return TextureCompression::BC5;
+		}
+
+		// Normals need all three channels and are very sensitive to BC1's 565 endpoints
+		if ( usage == TextureUsage::Normal )
+		{
+			return TextureCompression::BC7;
+		}
+
+		// Single channel, expanded back to gray on upload
+		if ( opaque && grayscale )
+		{
+			return TextureCompression::BC4;
+		}
+
+		if ( opaque )
+		{
+			return highQuality ? TextureCompression::BC7 : TextureCompression::BC1;
+		}
+
+		return highQuality ? TextureCompression::BC7 : TextureCompression::BC3;
+	}
+
+	//=================================================================
+
+	void TextureCompressor::GenerateMips( const u8* rgba, u32 width, u32 height, TextureUsage usage, Vector< Vector< u8 > >* mips )
+	{
+		static const LinearColorTable linearTable;
+
+		mips->clear( );
+		mips->emplace_back( rgba, rgba + ( usize )width * ( usize )height * 4 );
+
+		while ( width > 1 || height > 1 )
+		{
+			u32 mipWidth = std::max( width / 2, 1u );
+			u32 mipHeight = std::max( height / 2, 1u );
+
+			// Previous level has to be fetched by index, since growing mips can move it
+			mips->emplace_back( ( usize )mipWidth * ( usize )mipHeight * 4 );
+			const u8* src = ( *mips )[ mips->size( ) - 2 ].data( );
+			u8* dst = mips->back( ).data( );
+
+			for ( u32 y = 0; y < mipHeight; ++y )
+			{
+				for ( u32 x = 0; x < mipWidth; ++x )
+				{
+					// 2x2 box, clamped so single row / column levels don't read past the edge
+					const u8* taps[ 4 ];
+					u32 x0 = std::min( x * 2, width - 1 ), x1 = std::min( x * 2 + 1, width - 1 );
+					u32 y0 = std::min( y * 2, height - 1 ), y1 = std::min( y * 2 + 1, height - 1 );
+					taps[ 0 ] = src + ( ( usize )y0 * width + x0 ) * 4;
+					taps[ 1 ] = src + ( ( usize )y0 * width + x1 ) * 4;
+					taps[ 2 ] = src + ( ( usize )y1 * width + x0 ) * 4;
+					taps[ 3 ] = src + ( ( usize )y1 * width + x1 ) * 4;
+
+					u8* out = dst + ( ( usize )y * mipWidth + x ) * 4;
+
+					f32 sum[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+					switch ( usage )
+					{
+						case TextureUsage::Color:
+						{
+							for ( u32 t = 0; t < 4; ++t )
+							{
+								for ( u32 c = 0; c < 3; ++c )
+								{
+									sum[ c ] += linearTable.mValues[ taps[ t ][ c ] ];
+								}
+								sum[ 3 ] += ( f32 )taps[ t ][ 3 ];
+							}
+							for ( u32 c = 0; c < 3; ++c )
+							{
+								out[ c ] = ( u8 )( powf( sum[ c ] / 4.0f, 1.0f / ENJON_TEXTURE_MIP_GAMMA ) * 255.0f + 0.5f );
+							}
+							out[ 3 ] = ( u8 )( sum[ 3 ] / 4.0f + 0.5f );
+						} break;
+
+						case TextureUsage::Normal:
+						{
+							for ( u32 t = 0; t < 4; ++t )
+							{
+								for ( u32 c = 0; c < 3; ++c )
+								{
+									sum[ c ] += ( f32 )taps[ t ][ c ] / 255.0f * 2.0f - 1.0f;
+								}
+								sum[ 3 ] += ( f32 )taps[ t ][ 3 ];
+							}
+
+							f32 length = sqrtf( sum[ 0 ] * sum[ 0 ] + sum[ 1 ] * sum[ 1 ] + sum[ 2 ] * sum[ 2 ] );
+							for ( u32 c = 0; c < 3; ++c )
+							{
+								f32 n = ( length > 1e-6f ) ? sum[ c ] / length : 0.0f;
+								out[ c ] = ( u8 )ClampFloat( ( n * 0.5f + 0.5f ) * 255.0f + 0.5f, 0.0f, 255.0f );
+							}
+							out[ 3 ] = ( u8 )( sum[ 3 ] / 4.0f + 0.5f );
+						} break;
+
+						default:
+						case TextureUsage::Data:
+						{
+							for ( u32 c = 0; c < 4; ++c )
+							{
+								u32 total = taps[ 0 ][ c ] + taps[ 1 ][ c ] + taps[ 2 ][ c ] + taps[ 3 ][ c ];
+								out[ c ] = ( u8 )( ( total + 2 ) / 4 );
+							}
+						} break;
+					}
+				}
+			}
+
+			width = mipWidth;
+			height = mipHeight;
+		}
+	}
+
+	//=================================================================
+
+	void TextureCompressor::GenerateMips( const f32* pixels, u32 components, u32 width, u32 height, Vector< Vector< f32 > >* mips )
+	{
+		mips->clear( );
+		mips->emplace_back( pixels, pixels + ( usize )width * ( usize )height * components );
+
+		while ( width > 1 || height > 1 )
+		{
+			u32 mipWidth = std::max( width / 2, 1u );
+			u32 mipHeight = std::max( height / 2, 1u );
+
+			mips->emplace_back( ( usize )mipWidth * ( usize )mipHeight * components );
+			const f32* src = ( *mips )[ mips->size( ) - 2 ].data( );
+			f32* dst = mips->back( ).data( );
+
+			for ( u32 y = 0; y < mipHeight; ++y )
+			{
+				for ( u32 x = 0; x < mipWidth; ++x )
+				{
+					u32 x0 = std::min( x * 2, width - 1 ), x1 = std::min( x * 2 + 1, width - 1 );
+					u32 y0 = std::min( y * 2, height - 1 ), y1 = std::min( y * 2 + 1, height - 1 );
+					for ( u32 c = 0; c < components; ++c )
+					{
+						f32 total = src[ ( ( usize )y0 * width + x0 ) * components + c ] + src[ ( ( usize )y0 * width + x1 ) * components + c ] +
+									src[ ( ( usize )y1 * width + x0 ) * components + c ] + src[ ( ( usize )y1 * width + x1 ) * components + c ];
+						dst[ ( ( usize )y * mipWidth + x ) * components + c ] = total * 0.25f;
+					}
+				}
+			}
+
+			width = mipWidth;
+			height = mipHeight;
+		}
+	}
+
+	//=================================================================
+
+	Result TextureCompressor::Compress( TextureCompression compression, const u8* rgba, u32 width, u32 height, Vector< u8 >* out )
+	{
+		u32 blockSize = GetBlockSize( compression );
+		if ( !blockSize || compression == TextureCompression::BC6H || !width || !height )
+		{
+			return Result::FAILURE;
+		}
+
+		u32 blocksX = ( width + 3 ) / 4;
+		u32 blocksY = ( height + 3 ) / 4;
+		out->assign( ( usize )blocksX * blocksY * blockSize, 0 );
+
+		// Each row of blocks is independent
+		JobSystem::ParallelForOrSerial( blocksY, [ & ]( u32 by )
+		{
+			for ( u32 bx = 0; bx < blocksX; ++bx )
+			{
+				f32 block[ 16 ][ 4 ];
+				FetchBlock( rgba, width, height, bx, by, block );
+
+				u8* dst = out->data( ) + ( ( usize )by * blocksX + bx ) * blockSize;
+				switch ( compression )
+				{
+					case TextureCompression::BC1:
+					{
+						EncodeColorBlock( block, dst );
+					} break;
+
+					case TextureCompression::BC3:
+					{
+						EncodeChannelBlock( block, 3, dst );
+						EncodeColorBlock( block, dst + 8 );
+					} break;
+
+					case TextureCompression::BC4:
+					{
+						EncodeChannelBlock( block, 0, dst );
+					} break;
+
+					case TextureCompression::BC5:
+					{
+						EncodeChannelBlock( block, 0, dst );
+						EncodeChannelBlock( block, 1, dst + 8 );
+					} break;
+
+					case TextureCompression::BC7:
+					{
+						EncodeBC7Block( block, dst );
+					} break;
+
+					default: break;
+				}
+			}
+		} );
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	Result TextureCompressor::CompressHDR( const f32* pixels, u32 components, u32 width, u32 height, Vector< u8 >* out )
+	{
+		if ( !components || !width || !height )
+		{
+			return Result::FAILURE;
+		}
+
+		u32 blocksX = ( width + 3 ) / 4;
+		u32 blocksY = ( height + 3 ) / 4;
+		out->assign( ( usize )blocksX * blocksY * 16, 0 );
+
+		JobSystem::ParallelForOrSerial( blocksY, [ & ]( u32 by )
+		{
+			for ( u32 bx = 0; bx < blocksX; ++bx )
+			{
+				f32 block[ 16 ][ 4 ];
+				for ( u32 y = 0; y < 4; ++y )
+				{
+					u32 sy = std::min( by * 4 + y, height - 1 );
+					for ( u32 x = 0; x < 4; ++x )
+					{
+						u32 sx = std::min( bx * 4 + x, width - 1 );
+						const f32* src = pixels + ( ( usize )sy * width + sx ) * components;
+						for ( u32 c = 0; c < 3; ++c )
+						{
+							// Single / dual channel images replicate their first channel
+							block[ y * 4 + x ][ c ] = ( f32 )FloatToHalf( src[ c < components ? c : 0 ] );
+						}
+						block[ y * 4 + x ][ 3 ] = 0.0f;
+					}
+				}
+
+				EncodeBC6HBlock( block, out->data( ) + ( ( usize )by * blocksX + bx ) * 16 );
+			}
+		} );
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+}
@@ -0,0 +1,474 @@
+// @file TextureStreamer.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Graphics/TextureStreamer.h"
+#include "Graphics/Texture.h"
+#include "Graphics/Material.h"
+#include "Asset/AssetManager.h"
+#include "SubsystemCatalog.h"
+#include "Engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+namespace Enjon
+{
+	INTERNAL std::atomic< bool > sTextureStreamingEnabled{ true };
+
+	//=================================================================
+
+	TextureStreamer::~TextureStreamer( )
+	{
+		Shutdown( );
+	}
+
+	//=================================================================
+
+	void TextureStreamer::SetEnabled( bool enabled )
+	{
+		sTextureStreamingEnabled = enabled;
+	}
+
+	//=================================================================
+
+	bool TextureStreamer::IsEnabled( )
+	{
+		return sTextureStreamingEnabled;
+	}
+
+	//=================================================================
+
+	u32 TextureStreamer::ComputeRequiredMip( const Texture* texture, f32 uvDensity, f32 pixelsPerUnit )
+	{
+		u32 tail = texture->GetStreamingTailMip( );
+
+		// Camera inside bounds, so no telling how close surface is
+		if ( pixelsPerUnit == FLT_MAX )
+		{
+			return 0;
+		}
+
+		if ( uvDensity <= 0.0f || pixelsPerUnit <= 0.0f )
+		{
+			return tail;
+		}
+
+		// Texels of top level covering one pixel on screen, each mip halving it
+		f32 texelsPerPixel = ( f32 )std::max( texture->GetWidth( ), texture->GetHeight( ) ) * uvDensity / pixelsPerUnit;
+		if ( texelsPerPixel <= 1.0f )
+		{
+			return 0;
+		}
+
+		return std::min( ( u32 )log2f( texelsPerPixel ), tail );
+	}
+
+	//=================================================================
+
+	void TextureStreamer::Register( Texture* texture )
+	{
+		// Reloaded textures start over, so nothing read for their previous contents may land in them
+		auto query = mTextures.find( texture->mUUID );
+		if ( query != mTextures.end( ) )
+		{
+			Unregister( query->second.mTexture );
+		}
+
+		StreamingTexture& state = mTextures[ texture->mUUID ];
+		state.mTexture = texture;
+		state.mRequestedMip = texture->GetStreamingTailMip( );
+		state.mWantedMip = state.mRequestedMip;
+		state.mLastRequestedFrame = mFrame;
+		texture->mIsStreamed = true;
+
+		mStreamedBytes += GetMipRangeSize( texture, texture->GetResidentMip( ), texture->GetStreamingTailMip( ) );
+	}
+
+	//=================================================================
+
+	void TextureStreamer::Unregister( Texture* texture )
+	{
+		// Entry may belong to a newer texture with the same id that has since replaced this one
+		auto query = mTextures.find( texture->mUUID );
+		if ( query == mTextures.end( ) || query->second.mTexture != texture )
+		{
+			return;
+		}
+
+		if ( query->second.mInFlight )
+		{
+			JobSystem* jobs = EngineSubsystem( JobSystem );
+			if ( jobs )
+			{
+				jobs->Wait( &query->second.mReads );
+			}
+		}
+
+		// Drop anything read for it that hasn't been uploaded
+		{
+			std::lock_guard< std::mutex > lock( mCompletedLock );
+			mPendingUploads.insert( mPendingUploads.end( ), std::make_move_iterator( mCompleted.begin( ) ), std::make_move_iterator( mCompleted.end( ) ) );
+			mCompleted.clear( );
+		}
+
+		const UUID& id = query->first;
+		auto pending = std::remove_if( mPendingUploads.begin( ), mPendingUploads.end( ), [ &id ] ( const StreamedMips& m )
+		{
+			return m.mTextureID == id;
+		} );
+		mReadsInFlight -= ( u32 )std::distance( pending, mPendingUploads.end( ) );
+		mPendingUploads.erase( pending, mPendingUploads.end( ) );
+
+		mStreamedBytes -= std::min( mStreamedBytes, GetMipRangeSize( texture, texture->GetResidentMip( ), texture->GetStreamingTailMip( ) ) );
+		texture->mIsStreamed = false;
+		mTextures.erase( query );
+	}
+
+	//=================================================================
+
+	void TextureStreamer::RequestMip( const Texture* texture, u32 mip )
+	{
+		if ( !texture->mIsStreamed )
+		{
+			return;
+		}
+
+		auto query = mTextures.find( texture->mUUID );
+		if ( query == mTextures.end( ) || query->second.mTexture != texture )
+		{
+			return;
+		}
+
+		StreamingTexture& state = query->second;
+		if ( state.mLastRequestedFrame != mFrame )
+		{
+			state.mRequestedMip = mip;
+			state.mLastRequestedFrame = mFrame;
+		}
+		else
+		{
+			state.mRequestedMip = std::min( state.mRequestedMip, mip );
+		}
+	}
+
+	//=================================================================
+
+	void TextureStreamer::RequestMaterial( const Material* material, f32 uvDensity, f32 pixelsPerUnit )
+	{
+		if ( !material || mTextures.empty( ) )
+		{
+			return;
+		}
+
+		mMaterialTextures.clear( );
+		material->GetTextures( &mMaterialTextures );
+		for ( const Texture* texture : mMaterialTextures )
+		{
+			if ( texture->mIsStreamed )
+			{
+				RequestMip( texture, ComputeRequiredMip( texture, uvDensity, pixelsPerUnit ) );
+			}
+		}
+	}
+
+	//=================================================================
+
+	usize TextureStreamer::GetMipRangeSize( const Texture* texture, u32 first, u32 last )
+	{
+		usize bytes = 0;
+		for ( u32 level = first; level < last && level < ( u32 )texture->mMipRanges.size( ); ++level )
+		{
+			bytes += texture->mMipRanges[ level ].mSize;
+		}
+		return bytes;
+	}
+
+	//=================================================================
+
+	Result TextureStreamer::ReadLevels( const AssetRecordInfo* info, const Vector< TextureMipRange >& ranges, Vector< Vector< u8 > >* levels )
+	{
+		if ( !info || ranges.empty( ) || ranges.front( ).mOffset < sizeof( u32 ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Levels are stored back to back, so one read covers them and their size prefixes
+		u32 start = ranges.front( ).mOffset - sizeof( u32 );
+		u32 end = ranges.back( ).mOffset + ranges.back( ).mSize;
+		Vector< u8 > contents( end - start );
+		if ( EngineSubsystem( AssetManager )->ReadAssetFileRange( info, start, end - start, contents.data( ) ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		// Cache may have been rewritten since texture was loaded, in which case sizes won't line up
+		levels->resize( ranges.size( ) );
+		for ( usize i = 0; i < ranges.size( ); ++i )
+		{
+			const TextureMipRange& range = ranges[ i ];
+			u32 size = 0;
+			memcpy( &size, contents.data( ) + range.mOffset - sizeof( u32 ) - start, sizeof( u32 ) );
+			if ( size != range.mSize )
+			{
+				levels->clear( );
+				return Result::FAILURE;
+			}
+
+			const u8* data = contents.data( ) + range.mOffset - start;
+			( *levels )[ i ].assign( data, data + range.mSize );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	void TextureStreamer::IssueRead( StreamingTexture* state, u32 first )
+	{
+		Texture* texture = state->mTexture;
+		u32 resident = texture->GetResidentMip( );
+
+		// Copied so reads never touch texture itself
+		Vector< TextureMipRange > ranges( texture->mMipRanges.begin( ) + first, texture->mMipRanges.begin( ) + resident );
+		const AssetRecordInfo* info = texture->GetAssetRecordInfo( );
+
+		state->mInFlight = true;
+		mReadsInFlight++;
+
+		auto read = [ this, id = texture->mUUID, first, resident, ranges, info ] ( )
+		{
+			StreamedMips streamed;
+			streamed.mTextureID = id;
+			streamed.mFirstMip = first;
+			streamed.mResidentMip = resident;
+			streamed.mResult = ReadLevels( info, ranges, &streamed.mLevels );
+
+			std::lock_guard< std::mutex > lock( mCompletedLock );
+			mCompleted.push_back( std::move( streamed ) );
+		};
+
+		JobSystem* jobs = EngineSubsystem( JobSystem );
+		if ( jobs && jobs->GetWorkerCount( ) )
+		{
+			jobs->Submit( read, &state->mReads );
+		}
+		else
+		{
+			read( );
+		}
+	}
+
+	//=================================================================
+
+	void TextureStreamer::Update( )
+	{
+		// Upload finished reads within budget, always making progress
+		{
+			std::lock_guard< std::mutex > lock( mCompletedLock );
+			mPendingUploads.insert( mPendingUploads.end( ), std::make_move_iterator( mCompleted.begin( ) ), std::make_move_iterator( mCompleted.end( ) ) );
+			mCompleted.clear( );
+		}
+
+		usize uploaded = 0;
+		usize processed = 0;
+		for ( ; processed < mPendingUploads.size( ); ++processed )
+		{
+			if ( processed && uploaded >= mUploadBudget )
+			{
+				break;
+			}
+
+			StreamedMips& streamed = mPendingUploads[ processed ];
+			mReadsInFlight--;
+
+			auto query = mTextures.find( streamed.mTextureID );
+			if ( query == mTextures.end( ) )
+			{
+				continue;
+			}
+			query->second.mInFlight = false;
+
+			Texture* texture = query->second.mTexture;
+			if ( streamed.mResult != Result::SUCCESS || texture->GetResidentMip( ) != streamed.mResidentMip )
+			{
+				continue;
+			}
+
+			usize bytes = GetMipRangeSize( texture, streamed.mFirstMip, streamed.mResidentMip );
+			texture->StreamInMips( streamed.mFirstMip, streamed.mLevels );
+			mStreamedBytes += bytes;
+			uploaded += bytes;
+		}
+		mPendingUploads.erase( mPendingUploads.begin( ), mPendingUploads.begin( ) + processed );
+
+		// Settle on mip each texture needs. Requests are held for a while so textures briefly out of view keep their levels.
+		Vector< StreamingTexture* > stale;
+		Vector< StreamingTexture* > needed;
+		for ( auto& t : mTextures )
+		{
+			StreamingTexture& state = t.second;
+			u32 tail = state.mTexture->GetStreamingTailMip( );
+
+			if ( state.mLastRequestedFrame == mFrame )
+			{
+				state.mWantedMip = state.mRequestedMip;
+			}
+			else if ( mFrame - state.mLastRequestedFrame > ENJON_TEXTURE_STREAMING_STALE_FRAMES )
+			{
+				state.mWantedMip = tail;
+			}
+
+			if ( state.mInFlight )
+			{
+				continue;
+			}
+
+			u32 resident = state.mTexture->GetResidentMip( );
+			if ( state.mWantedMip > resident )
+			{
+				stale.push_back( &state );
+			}
+			else if ( state.mWantedMip < resident )
+			{
+				needed.push_back( &state );
+			}
+		}
+
+		// Evict levels that are no longer needed, longest unused first, until back under budget
+		usize neededBytes = 0;
+		for ( StreamingTexture* state : needed )
+		{
+			neededBytes += GetMipRangeSize( state->mTexture, state->mWantedMip, state->mTexture->GetResidentMip( ) );
+		}
+
+		if ( mStreamedBytes + neededBytes > mMemoryBudget )
+		{
+			std::sort( stale.begin( ), stale.end( ), [ ] ( const StreamingTexture* a, const StreamingTexture* b )
+			{
+				return a->mLastRequestedFrame < b->mLastRequestedFrame;
+			} );
+
+			for ( StreamingTexture* state : stale )
+			{
+				if ( mStreamedBytes + neededBytes <= mMemoryBudget )
+				{
+					break;
+				}
+
+				mStreamedBytes -= std::min( mStreamedBytes, state->mTexture->EvictMips( state->mWantedMip ) );
+			}
+		}
+
+		// Most recently requested and largest shortfall first
+		std::sort( needed.begin( ), needed.end( ), [ ] ( const StreamingTexture* a, const StreamingTexture* b )
+		{
+			if ( a->mLastRequestedFrame != b->mLastRequestedFrame )
+			{
+				return a->mLastRequestedFrame > b->mLastRequestedFrame;
+			}
+			return ( a->mTexture->GetResidentMip( ) - a->mWantedMip ) > ( b->mTexture->GetResidentMip( ) - b->mWantedMip );
+		} );
+
+		// Read what fits in budget, falling back to fewer levels for textures that don't fit whole
+		usize committed = mStreamedBytes;
+		for ( StreamingTexture* state : needed )
+		{
+			if ( mReadsInFlight >= ENJON_TEXTURE_STREAMING_MAX_IN_FLIGHT )
+			{
+				break;
+			}
+
+			u32 resident = state->mTexture->GetResidentMip( );
+			u32 first = state->mWantedMip;
+			while ( first < resident && committed + GetMipRangeSize( state->mTexture, first, resident ) > mMemoryBudget )
+			{
+				++first;
+			}
+
+			if ( first < resident && state->mTexture->GetAssetRecordInfo( ) )
+			{
+				committed += GetMipRangeSize( state->mTexture, first, resident );
+				IssueRead( state, first );
+			}
+		}
+
+		mFrame++;
+	}
+
+	//=================================================================
+
+	void TextureStreamer::Shutdown( )
+	{
+		JobSystem* jobs = EngineSubsystem( JobSystem );
+		for ( auto& t : mTextures )
+		{
+			if ( jobs && t.second.mInFlight )
+			{
+				jobs->Wait( &t.second.mReads );
+			}
+		}
+
+		{
+			std::lock_guard< std::mutex > lock( mCompletedLock );
+			mCompleted.clear( );
+		}
+		mPendingUploads.clear( );
+
+		// Textures outliving streamer mustn't try to unregister from it
+		for ( auto& t : mTextures )
+		{
+			t.second.mTexture->mIsStreamed = false;
+		}
+
+		mTextures.clear( );
+		mStreamedBytes = 0;
+		mReadsInFlight = 0;
+	}
+
+	//=================================================================
+
+	void TextureStreamer::SetMemoryBudget( usize bytes )
+	{
+		mMemoryBudget = bytes;
+	}
+
+	//=================================================================
+
+	usize TextureStreamer::GetMemoryBudget( ) const
+	{
+		return mMemoryBudget;
+	}
+
+	//=================================================================
+
+	void TextureStreamer::SetUploadBudget( usize bytes )
+	{
+		mUploadBudget = bytes;
+	}
+
+	//=================================================================
+
+	usize TextureStreamer::GetStreamedMemoryUsage( ) const
+	{
+		return mStreamedBytes;
+	}
+
+	//=================================================================
+
+	u32 TextureStreamer::GetTextureCount( ) const
+	{
+		return ( u32 )mTextures.size( );
+	}
+
+	//=================================================================
+
+	u32 TextureStreamer::GetReadsInFlight( ) const
+	{
+		return mReadsInFlight;
+	}
+
+	//=================================================================
+}
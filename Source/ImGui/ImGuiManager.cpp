@@ -18,6 +18,7 @@
 
 #include "Graphics/GraphicsSubsystem.h"
 #include "SubsystemCatalog.h"
+#include "ImGui/imgui_internal.h"
 
 #include <algorithm>
 #include <assert.h>
@@ -411,6 +412,13 @@ namespace Enjon
 		mMainMenuOptions.clear( );
 		mDockingLayouts.clear( ); 
 
+		// Distance field atlases own their fonts
+		for ( auto& atlas : mSDFFontAtlases )
+		{
+			IM_DELETE( atlas.second );
+		}
+		mSDFFontAtlases.clear( );
+
 		// Destroy all contexts ( if existing )
 		//for ( auto& w : mImGuiContextMap )
 		//{ 
@@ -1660,6 +1668,18 @@ namespace Enjon
 			return;
 		}
 
+		// Cooked fonts scale their one atlas to any size, so nothing is rasterized or uploaded here
+		if ( fnt->HasSDFAtlas( ) )
+		{
+			mFonts[ font_name ] = AddSDFFont( fnt, pointSize );
+			if ( mFonts.find( "WeblySleek_16" ) != mFonts.end( ) )
+			{
+				io.FontDefault = mFonts[ "WeblySleek_16" ];
+			}
+			ImGui::SetCurrentContext( prevContext );
+			return;
+		}
+
 		// Set name of font config
 		memcpy( fontCfg.Name, font_name.c_str(), 32 );
 
@@ -1683,6 +1703,69 @@ namespace Enjon
 
 	//============================================================================================ 
 
+	ImFont* ImGuiManager::AddSDFFont( const UIFont* font, const u32& pointSize )
+	{
+		const FontSDFAtlas& sdf = font->GetSDFAtlas( );
+
+		// One atlas per font shared by all its sizes, bound to cooked distance field texture
+		ImFontAtlas* atlas = nullptr;
+		auto query = mSDFFontAtlases.find( font->GetName( ) );
+		if ( query != mSDFFontAtlases.end( ) )
+		{
+			atlas = query->second;
+		}
+		else
+		{
+			atlas = IM_NEW( ImFontAtlas );
+			atlas->TexID = ( ImTextureID )( usize )font->GetSDFTextureID( );
+			atlas->TexWidth = ( s32 )sdf.mWidth;
+			atlas->TexHeight = ( s32 )sdf.mHeight;
+			atlas->TexUvScale = ImVec2( 1.0f / ( f32 )sdf.mWidth, 1.0f / ( f32 )sdf.mHeight );
+			atlas->TexUvWhitePixel = ImVec2( ( ( f32 )sdf.mSolidX + 0.5f ) * atlas->TexUvScale.x, ( ( f32 )sdf.mSolidY + 0.5f ) * atlas->TexUvScale.y );
+
+			// Glyphs read spacing and snapping from config, font data stays with asset
+			ImFontConfig config;
+			config.FontDataOwnedByAtlas = false;
+			config.PixelSnapH = false;
+			memcpy( config.Name, font->GetName( ).c_str( ), std::min< usize >( font->GetName( ).size( ), sizeof( config.Name ) - 1 ) );
+			atlas->ConfigData.push_back( config );
+
+			ImGui_ImplSdlGL3_AddSignedDistanceTexture( atlas->TexID );
+			mSDFFontAtlases[ font->GetName( ) ] = atlas;
+		}
+
+		f32 scale = ( f32 )pointSize / ( f32 )sdf.mBakeSize;
+
+		ImFont* imFont = IM_NEW( ImFont );
+		imFont->FontSize = ( f32 )pointSize;
+		imFont->ContainerAtlas = atlas;
+		imFont->ConfigData = &atlas->ConfigData[ 0 ];
+		imFont->ConfigDataCount = 1;
+		imFont->Ascent = sdf.mAscent * scale;
+		imFont->Descent = sdf.mDescent * scale;
+
+		// Glyph quads are relative to top of line, atlas offsets to baseline
+		for ( const FontSDFGlyph& g : sdf.mGlyphs )
+		{
+			f32 x0 = g.mOffsetX * scale;
+			f32 y0 = ( sdf.mAscent + g.mOffsetY ) * scale;
+			f32 x1 = x0 + g.mWidth * scale;
+			f32 y1 = y0 + g.mHeight * scale;
+			f32 u0 = g.mX * atlas->TexUvScale.x;
+			f32 v0 = g.mY * atlas->TexUvScale.y;
+			f32 u1 = ( g.mX + g.mWidth ) * atlas->TexUvScale.x;
+			f32 v1 = ( g.mY + g.mHeight ) * atlas->TexUvScale.y;
+			imFont->AddGlyph( ( ImWchar )g.mCodepoint, x0, y0, x1, y1, u0, v0, u1, v1, g.mAdvance * scale );
+		}
+
+		imFont->BuildLookupTable( );
+		atlas->Fonts.push_back( imFont );
+
+		return imFont;
+	}
+
+	//============================================================================================ 
+
 	void ImGuiManager::AddFont( const String& filePath, const u32& size, GUIContext* ctx, const char* fontName )
 	{ 
 		// Cache previous context, set context
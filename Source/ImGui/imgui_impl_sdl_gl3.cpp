@@ -48,6 +48,7 @@
 #include <GLEW/glew.h>
 
 #include <unordered_map> 
+#include <unordered_set>
 
 #ifndef IMGUI_DEFINE_MATH_OPERATORS
     #define IMGUI_DEFINE_MATH_OPERATORS
@@ -65,7 +66,7 @@ struct DeviceData
 	GLuint       mFontTexture = 0;
 	//int			 mBufferLocation = 0, mGammaLocation = 0, mUseSDFLocation = 0;
 	int          mShaderHandle = 0, mVertHandle = 0, mFragHandle = 0;
-	int          mAttribLocationTex = 0, mAttribLocationProjMtx = 0;
+	int          mAttribLocationTex = 0, mAttribLocationProjMtx = 0, mAttribLocationSignedDistance = 0;
 	int          mAttribLocationPosition = 0, mAttribLocationUV = 0, mAttribLocationColor = 0;
 	unsigned int mVboHandle = 0, mVaoHandle = 0, mElementsHandle = 0; 
 };
@@ -78,6 +79,9 @@ static int          g_ShaderHandle = 0, g_VertHandle = 0, g_FragHandle = 0;
 static int          g_AttribLocationTex = 0, g_AttribLocationProjMtx = 0;
 static int          g_AttribLocationPosition = 0, g_AttribLocationUV = 0, g_AttribLocationColor = 0;
 static unsigned int g_VboHandle = 0, g_VaoHandle = 0, g_ElementsHandle = 0;
+
+// Textures holding distance fields rather than coverage, shared by all contexts
+static std::unordered_set< GLuint > g_SignedDistanceTextures;
 static SDL_Cursor*  g_SdlCursors[ ImGuiMouseCursor_Count_ ] = { 0 };
 ImGuiContext*		mCtx = nullptr;
 
@@ -249,7 +253,9 @@ void ImGui_ImplSdlGL3_RenderDrawData( ImDrawData* draw_data )
 			}
 			else
 			{
-				glBindTexture( GL_TEXTURE_2D, ( GLuint )( intptr_t )pcmd->TextureId );
+				GLuint texture = ( GLuint )( intptr_t )pcmd->TextureId;
+				glUniform1i( data->mAttribLocationSignedDistance, g_SignedDistanceTextures.find( texture ) != g_SignedDistanceTextures.end( ) ? 1 : 0 );
+				glBindTexture( GL_TEXTURE_2D, texture );
 				glScissor( ( int )pcmd->ClipRect.x, ( int )( fb_height - pcmd->ClipRect.w ), ( int )( pcmd->ClipRect.z - pcmd->ClipRect.x ), ( int )( pcmd->ClipRect.w - pcmd->ClipRect.y ) );
 				glDrawElements( GL_TRIANGLES, ( GLsizei )pcmd->ElemCount, sizeof( ImDrawIdx ) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, idx_buffer_offset );
 			}
@@ -450,6 +456,7 @@ bool ImGui_ImplSdlGL3_CreateDeviceObjects( ImGuiContext* ctx )
 	const GLchar* fragment_shader =
 		"#version 150\n"
 		"uniform sampler2D Texture;\n"
+		"uniform int SignedDistance;\n"
 		//"uniform float u_gamma;\n"
 		//"uniform float u_buffer;\n"
 		//"uniform float u_sdf;\n"
@@ -463,6 +470,15 @@ bool ImGui_ImplSdlGL3_CreateDeviceObjects( ImGuiContext* ctx )
 		//"	float alpha = 1.0 - smoothstep(u_buffer, u_buffer + u_gamma, distance);\n"
 		//"	Out_Color = vec4(Frag_Color.rgb, Frag_Color.a * alpha);\n"
 		//"	Out_Color = mix( Frag_Color * texture( Texture, Frag_UV.st), Out_Color, u_sdf );\n"
+		"	if ( SignedDistance != 0 )\n"
+		"	{\n"
+		"		// Edge is at 0.5, smoothed over a screen pixel whatever size glyph is drawn at\n"
+		"		float d = texture( Texture, Frag_UV.st ).r;\n"
+		"		float w = fwidth( d );\n"
+		"		float alpha = smoothstep( 0.5 - w, 0.5 + w, d );\n"
+		"		Out_Color = vec4( Frag_Color.rgb, Frag_Color.a * alpha );\n"
+		"		return;\n"
+		"	}\n"
 		"	Out_Color = Frag_Color * texture( Texture, Frag_UV.st);\n"
 		"}\n";
 
@@ -494,6 +510,7 @@ bool ImGui_ImplSdlGL3_CreateDeviceObjects( ImGuiContext* ctx )
 	//data->mUseSDFLocation = glGetUniformLocation( data->mShaderHandle, "u_sdf" );
 	data->mAttribLocationTex = glGetUniformLocation( data->mShaderHandle, "Texture" ); 
 	data->mAttribLocationProjMtx = glGetUniformLocation( data->mShaderHandle, "ProjMtx" );
+	data->mAttribLocationSignedDistance = glGetUniformLocation( data->mShaderHandle, "SignedDistance" );
 	data->mAttribLocationPosition = glGetAttribLocation( data->mShaderHandle, "Position" );
 	data->mAttribLocationUV = glGetAttribLocation( data->mShaderHandle, "UV" );
 	data->mAttribLocationColor = glGetAttribLocation( data->mShaderHandle, "Color" );
@@ -772,4 +789,11 @@ void ImGui_ImplSdlGL3_NewFrame( SDL_Window* window, ImGuiContext* ctx )
 
 	// Start the frame. This call will update the io.WantCaptureMouse, io.WantCaptureKeyboard flag that you can use to dispatch inputs (or not) to your application.
 	ImGui::NewFrame( );
-}
\ No newline at end of file
+}
+
+//==================================================================================
+
+void ImGui_ImplSdlGL3_AddSignedDistanceTexture( ImTextureID texture )
+{
+	g_SignedDistanceTextures.insert( ( GLuint )( intptr_t )texture );
+}
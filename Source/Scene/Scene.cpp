@@ -5,9 +5,16 @@
 #include "SubsystemCatalog.h"
 #include "Entity/EntityManager.h"
 #include "Asset/SceneAssetLoader.h"
+#include "Asset/AssetManager.h"
+#include "Asset/AssetDependencies.h"
+#include "Entity/Archetype.h"
 #include "Serialize/EntityArchiver.h"
+#include "System/JobSystem.h"
 #include "Engine.h"
 
+// Leads scene data that has a size written before each root entity record. Older scenes begin directly with the root entity count.
+#define ENJON_SCENE_STAGED_DATA_TAG 0xE75CE001
+
 namespace Enjon
 { 
 	//====================================================================
@@ -23,13 +30,34 @@ namespace Enjon
 			// Get all root level entities in default world
 			Vector<EntityHandle> rootEntities = em->GetRootLevelEntities( );
 
-			// Write out count of vector
+			// Write out tag and count of vector
+			archiver->Write<u32>( ENJON_SCENE_STAGED_DATA_TAG );
 			archiver->Write<u32>( rootEntities.size( ) );
 
-			// Serialize all root level entities into archive
+			// Serialize all root level entities into archive, each prefixed with its size so they can be decoded independently
 			for ( auto& e : rootEntities )
 			{
-				EntityArchiver::Serialize( e, archiver );
+				ByteBuffer record;
+				EntityArchiver::Serialize( e, &record, EntitySerializeMode::OverridesOnly );
+				archiver->Write<u32>( record.GetSize( ) );
+				archiver->AppendBuffer( record );
+			}
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//====================================================================
+	
+	Result Scene::CollectDependencies( Vector< AssetDependency >* out ) const
+	{
+		// Same set of entities that SerializeData writes out
+		EntityManager* em = EngineSubsystem( EntityManager );
+		if ( em )
+		{
+			for ( auto& e : em->GetRootLevelEntities( ) )
+			{
+				AssetDependencies::CollectFromEntity( e.Get( ), out );
 			}
 		}
 
@@ -46,12 +74,82 @@ namespace Enjon
 			// Read size from buffer
 			u32 rootSize = archiver->Read< u32 >( );
 
-			// Deserilaize all root level entities from buffer
+			// Older scenes have to be deserialized sequentially
+			if ( rootSize != ENJON_SCENE_STAGED_DATA_TAG )
+			{
+				// Deserilaize all root level entities from buffer
+				for ( u32 i = 0; i < rootSize; ++i )
+				{
+					// Deserialize all entities in buffer
+					EntityArchiver::Deserialize( archiver ); 
+				}
+
+				return Result::SUCCESS;
+			}
+
+			rootSize = archiver->Read< u32 >( );
+
+			// Find each root record in the scene data. Records are staged and committed through views over it, so nothing is copied.
+			Vector< u32 > recordOffsets( rootSize );
+			Vector< u32 > recordSizes( rootSize );
+			Vector< StagedEntity > staged( rootSize );
+			for ( u32 i = 0; i < rootSize; ++i )
+			{
+				recordSizes[ i ] = archiver->Read< u32 >( );
+				recordOffsets[ i ] = archiver->GetReadPosition( );
+				archiver->AdvanceReadPosition( recordSizes[ i ] );
+			}
+
+			// Decode all records, their properties and the assets they reference on workers. Touches no engine state.
+			const u8* data = archiver->GetData( );
+			EngineSubsystem( JobSystem )->ParallelFor( rootSize, [ & ] ( u32 i )
+			{
+				ByteBuffer record( data + recordOffsets[ i ], recordSizes[ i ] );
+				EntityArchiver::Stage( &record, &staged[ i ] );
+			}, 64 );
+
+			// Load all referenced archetypes up front so their prototypes exist before any instances are committed
+			HashSet< String > archetypes;
+			for ( auto& s : staged )
+			{
+				EntityArchiver::GetStagedArchetypes( s, archetypes );
+			}
+
+			AssetManager* am = EngineSubsystem( AssetManager );
+			for ( auto& a : archetypes )
+			{
+				am->GetAsset< Archetype >( UUID( a ) );
+			}
+
+			// Load all assets referenced by staged properties in one batch, so committing only has to link entities to them
+			Vector< AssetDependency > assets;
+			for ( auto& s : staged )
+			{
+				EntityArchiver::GetStagedAssets( s, assets );
+			}
+
+			HashSet< String > assetIDs;
+			Vector< AssetDependency > uniqueAssets;
+			for ( auto& a : assets )
+			{
+				if ( assetIDs.insert( a.mAssetUUID.ToString( ) ).second )
+				{
+					uniqueAssets.push_back( a );
+				}
+			}
+
+			am->PrefetchAssets( uniqueAssets );
+
+			// Allocate every entity and reserve for every component up front, then commit all entities in order on main thread
+			World* world = Engine::GetInstance( )->GetWorld( );
+			StagedAllocation allocation;
+			EntityArchiver::AllocateStaged( staged, world, &allocation );
 			for ( u32 i = 0; i < rootSize; ++i )
 			{
-				// Deserialize all entities in buffer
-				EntityArchiver::Deserialize( archiver ); 
+				ByteBuffer record( data + recordOffsets[ i ], recordSizes[ i ] );
+				EntityArchiver::CommitStaged( staged[ i ], &record, world, &allocation );
 			}
+			EntityArchiver::ReleaseStaged( &allocation );
 		}
 
 		return Result::SUCCESS; 
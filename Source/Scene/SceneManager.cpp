@@ -50,8 +50,12 @@ namespace Enjon
 		// Unload the previous scene
 		UnloadScene( );
 
+		// Load everything the scene references in parallel before any of its entities are built
+		AssetManager* am = EngineSubsystem( AssetManager );
+		am->PrefetchDependencies( Object::GetClass< Scene >( ), sceneName );
+
 		// Get scene from asset manager
-		AssetHandle< Scene > scene = EngineSubsystem( AssetManager )->GetAsset< Scene >( sceneName ); 
+		AssetHandle< Scene > scene = am->GetAsset< Scene >( sceneName ); 
 
 		// Set current scene
 		mCurrentScene = scene;
@@ -64,8 +68,12 @@ namespace Enjon
 		// Unload the previous scene
 		UnloadScene( );
 
+		// Load everything the scene references in parallel before any of its entities are built
+		AssetManager* am = EngineSubsystem( AssetManager );
+		am->PrefetchDependencies( Object::GetClass< Scene >( ), uuid );
+
 		// Get scene from asset manager
-		AssetHandle< Scene > scene = EngineSubsystem( AssetManager )->GetAsset< Scene >( uuid ); 
+		AssetHandle< Scene > scene = am->GetAsset< Scene >( uuid ); 
 
 		// Set current scene
 		mCurrentScene = scene;
@@ -4,6 +4,8 @@
 #include "Asset/Asset.h"
 #include "Asset/AssetLoader.h"
 #include "Serialize/AssetArchiver.h"
+#include "Serialize/BlockCompressedFile.h"
+#include "Serialize/JSONArchiver.h"
 #include "Asset/AssetManager.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
@@ -32,14 +34,24 @@ namespace Enjon
 			// Object Header 
 			//==================================================
 			mBuffer.Write< String >( cls->GetName( ) );				// Class name
-			mBuffer.Write( 0 );										// Version number
+			mBuffer.Write< u32 >( ENJON_ASSET_HEADER_VERSION );		// Version number
 
 			//==================================================
 			// Asset Header 
 			//==================================================
 			mBuffer.Write< UUID >( asset->GetUUID( ) );										// UUID of asset
 			mBuffer.Write< String >( asset->GetName( ) );									// Asset name
-			mBuffer.Write< String >( asset->GetLoader( )->Class( )->GetName( ) );			// Asset name
+			mBuffer.Write< String >( asset->GetLoader( )->Class( )->GetName( ) );			// Loader class name
+
+			//==================================================
+			// Source Info 
+			//==================================================
+			const AssetSourceInfo& source = asset->GetSourceInfo( );
+			mBuffer.Write< String >( source.mSourceFilePath );								// Source file asset was imported from
+			mBuffer.Write< u64 >( source.mSourceFileSize );									// Source file size
+			mBuffer.Write< s64 >( source.mSourceWriteTime );								// Source file write time
+			mBuffer.Write< u64 >( source.mSourceHash );										// Hash of source contents
+			mBuffer.Write< String >( source.mImportSettings );								// Serialized import options
 
 			// Serialize all object specific data ( classes can override at this point how they want to serialize data )
 			Result res = asset->SerializeData( &mBuffer );
@@ -69,18 +81,16 @@ namespace Enjon
 
 	void AssetArchiver::Deserialize( ByteBuffer* buffer, Asset* asset )
 	{
-		//==================================================
-		// Object Header 
-		//==================================================
-		const MetaClass* cls = Object::GetClass( buffer->Read< String >( ) );	// Read class type
-		u32 versionNumber = buffer->Read< u32 >( );								// Read version number id 
+		// Assets saved as text are whole json documents rather than a binary header followed by data
+		if ( JSONArchiver::IsAssetText( buffer->GetData( ), buffer->GetSize( ) ) )
+		{
+			DeserializeText( buffer, asset );
+			return;
+		}
 
-		//==================================================
-		// Asset Header 
-		//==================================================
-		UUID uuid = buffer->Read< UUID >( );										// UUID of asset
-		String assetName = buffer->Read< String >( );								// Asset name
-		String loaderName = buffer->Read< String >( );								// Loader class name
+		AssetHeader header;
+		ReadHeader( buffer, &header );
+		const MetaClass* cls = header.mClass;
 
 
 		if ( cls )
@@ -105,8 +115,9 @@ namespace Enjon
 
 				// Set asset properties
 				asset->mLoader = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetLoaderByAssetClass( asset->Class( ) );
-				asset->mName = assetName;
-				asset->mUUID = uuid;
+				asset->mName = header.mName;
+				asset->mUUID = header.mUUID;
+				asset->mSourceInfo = header.mSourceInfo;
 
 				// Default deserialization method if not asset does not handle its own deserialization
 				if ( res == Result::INCOMPLETE )
@@ -131,26 +142,77 @@ namespace Enjon
 
 	//====================================================================================
 
+	Result AssetArchiver::DeserializeAssetData( ByteBuffer* buffer, Asset* asset )
+	{
+		if ( !buffer || !asset )
+		{
+			return Result::FAILURE;
+		}
+
+		AssetHeader header;
+
+		// Text is read straight into asset, which is rejected if it is of a different type than the file holds
+		if ( JSONArchiver::IsAssetText( buffer->GetData( ), buffer->GetSize( ) ) )
+		{
+			Result res = JSONArchiver::DeserializeAsset( buffer, &asset, &header );
+			if ( res == Result::SUCCESS )
+			{
+				asset->mSourceInfo = header.mSourceInfo;
+			}
+			return res;
+		}
+
+		ReadHeader( buffer, &header );
+		const MetaClass* cls = header.mClass;
+
+		// File must hold the same type of asset that was constructed for it
+		if ( !cls || cls != asset->Class( ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Only this asset's own header, so safe to set while streaming
+		asset->mSourceInfo = header.mSourceInfo;
+
+		Result res = asset->DeserializeData( buffer ); 
+
+		// Default deserialization method if not asset does not handle its own deserialization
+		if ( res == Result::INCOMPLETE )
+		{
+			res = DeserializeObjectDataDefault( asset, cls, buffer );
+		} 
+
+		return res;
+	}
+
+	//====================================================================================
+
 	Asset* AssetArchiver::Deserialize( const String& filePath )
 	{ 
 		// Reset the buffer
 		Reset( );
 
-		// Read contents into buffer
-		mBuffer.ReadFromFile( filePath );
+		// Read contents into buffer, decompressing if file was written compressed
+		if ( BlockCompressedFile::ReadFile( filePath, &mBuffer ) != Result::SUCCESS )
+		{
+			return nullptr;
+		}
 
-		//==================================================
-		// Object Header 
-		//==================================================
-		const MetaClass* cls = Object::GetClass( mBuffer.Read< String >( ) );	// Read class type
-		u32 versionNumber = mBuffer.Read< u32 >( );								// Read version number id
+		return DeserializeAsset( &mBuffer );
+	}
 
-		//==================================================
-		// Asset Header 
-		//==================================================
-		UUID uuid = mBuffer.Read< UUID >( );										// UUID of asset
-		String assetName = mBuffer.Read< String >( );								// Asset name
-		String loaderName = mBuffer.Read< String >( );								// Loader class name
+	//====================================================================================
+
+	Asset* AssetArchiver::DeserializeAsset( ByteBuffer* buffer )
+	{
+		if ( JSONArchiver::IsAssetText( buffer->GetData( ), buffer->GetSize( ) ) )
+		{
+			return DeserializeText( buffer, nullptr );
+		}
+
+		AssetHeader header;
+		ReadHeader( buffer, &header );
+		const MetaClass* cls = header.mClass;
 
 		// Object to construct and fill out
 		Asset* asset = nullptr; 
@@ -172,17 +234,18 @@ namespace Enjon
 			else
 			{
 				std::cout << "Deserializing asset...\n";
-				Result res = asset->DeserializeData( &mBuffer ); 
+				Result res = asset->DeserializeData( buffer ); 
 
 				// Set asset properties
 				asset->mLoader = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetLoaderByAssetClass( asset->Class( ) );
-				asset->mName = assetName;
-				asset->mUUID = uuid;
+				asset->mName = header.mName;
+				asset->mUUID = header.mUUID;
+				asset->mSourceInfo = header.mSourceInfo;
 
 				// Default deserialization method if not asset does not handle its own deserialization
 				if ( res == Result::INCOMPLETE )
 				{
-					res = DeserializeObjectDataDefault( asset, cls );
+					res = DeserializeObjectDataDefault( asset, cls, buffer );
 				}
 
 				// Delete object if not deserialized correctly
@@ -202,5 +265,72 @@ namespace Enjon
 		// Return asset, either null or filled out
 		return asset; 
 	}
-}
 
+	//====================================================================================
+
+	Asset* AssetArchiver::DeserializeText( const ByteBuffer* buffer, Asset* asset )
+	{
+		Asset* constructed = asset;
+		AssetHeader header;
+
+		if ( JSONArchiver::DeserializeAsset( buffer, &constructed, &header ) != Result::SUCCESS )
+		{
+			// Only free asset if it was constructed while reading
+			if ( constructed != asset )
+			{
+				delete constructed;
+			}
+			return nullptr;
+		}
+
+		// Set asset properties
+		constructed->mLoader = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetLoaderByAssetClass( constructed->Class( ) );
+		constructed->mName = header.mName;
+		constructed->mUUID = header.mUUID;
+		constructed->mSourceInfo = header.mSourceInfo;
+
+		constructed->DeserializeLateInit( );
+
+		return constructed;
+	}
+
+	//====================================================================================
+
+	void AssetArchiver::ReadHeader( ByteBuffer* buffer, AssetHeader* header )
+	{
+		//==================================================
+		// Object Header 
+		//==================================================
+		header->mClass = Object::GetClass( buffer->Read< String >( ) );		// Read class type
+		header->mVersion = buffer->Read< u32 >( );								// Read version number id
+
+		//==================================================
+		// Asset Header 
+		//==================================================
+		header->mUUID = buffer->Read< UUID >( );								// UUID of asset
+		header->mName = buffer->Read< String >( );								// Asset name
+		header->mLoaderName = buffer->Read< String >( );						// Loader class name
+
+		//==================================================
+		// Source Info 
+		//==================================================
+		// Files cached before source info was recorded have none, and will be reimported if their source is imported again
+		if ( header->mVersion >= 1 )
+		{
+			header->mSourceInfo.mSourceFilePath = buffer->Read< String >( );
+			header->mSourceInfo.mSourceFileSize = buffer->Read< u64 >( );
+			header->mSourceInfo.mSourceWriteTime = buffer->Read< s64 >( );
+			header->mSourceInfo.mSourceHash = buffer->Read< u64 >( );
+			header->mSourceInfo.mImportSettings = buffer->Read< String >( );
+		}
+	}
+
+	//====================================================================================
+
+	Result AssetArchiver::WriteToCompressedFile( const String& filePath )
+	{
+		return BlockCompressedFile::Write( mBuffer.GetData( ), mBuffer.GetSize( ), filePath );
+	}
+
+	//====================================================================================
+}
@@ -464,389 +464,398 @@ namespace Enjon
 
 			if ( prop && propType == prop->GetType( ) )
 			{
-				switch ( prop->GetType( ) )
-				{
-					default: break;
+				DeserializeValue( object, prop, buffer );
+			}
+			// Otherwise skip the property in the buffer
+			else
+			{
+				buffer->AdvanceReadPosition( propSize );
+			} 
+	}
 
-					case MetaPropertyType::U8:
-					{
-						READ_PROP( buffer, cls, object, prop, u8 )
-					} break;
+	//==================================================================================================================
 
-					case MetaPropertyType::U16:
-					{
-						READ_PROP( buffer, cls, object, prop, u16 )
-					} break;
+	void PropertyArchiver::DeserializeValue( const Object* object, const MetaProperty* prop, ByteBuffer* buffer )
+	{
+			const MetaClass* cls = object->Class( );
 
-					case MetaPropertyType::U32:
-					{
-						// Set value of object from read buffer
-						READ_PROP( buffer, cls, object, prop, u32 )
-					} break;
+			switch ( prop->GetType( ) )
+			{
+				default: break;
 
-					case MetaPropertyType::U64:
-					{
-						// Set value of object from read buffer
-						READ_PROP( buffer, cls, object, prop, u64 )
-					} break;
+				case MetaPropertyType::U8:
+				{
+					READ_PROP( buffer, cls, object, prop, u8 )
+				} break;
 
-					case MetaPropertyType::F32:
-					{
-						// Set value of object from read buffer
-						READ_PROP( buffer, cls, object, prop, f32 )
-					} break;
+				case MetaPropertyType::U16:
+				{
+					READ_PROP( buffer, cls, object, prop, u16 )
+				} break;
 
-					case MetaPropertyType::String:
-					{
-						READ_PROP( buffer, cls, object, prop, String )
-					} break;
+				case MetaPropertyType::U32:
+				{
+					// Set value of object from read buffer
+					READ_PROP( buffer, cls, object, prop, u32 )
+				} break;
 
-					case MetaPropertyType::S8:
-					{
-						READ_PROP( buffer, cls, object, prop, s8 )
-					} break;
+				case MetaPropertyType::U64:
+				{
+					// Set value of object from read buffer
+					READ_PROP( buffer, cls, object, prop, u64 )
+				} break;
 
-					case MetaPropertyType::S16:
-					{
-						READ_PROP( buffer, cls, object, prop, s16 )
-					} break;
+				case MetaPropertyType::F32:
+				{
+					// Set value of object from read buffer
+					READ_PROP( buffer, cls, object, prop, f32 )
+				} break;
 
-					case MetaPropertyType::S32:
-					{
-						READ_PROP( buffer, cls, object, prop, s32 )
-					} break;
+				case MetaPropertyType::String:
+				{
+					READ_PROP( buffer, cls, object, prop, String )
+				} break;
 
-					case MetaPropertyType::S64:
-					{
-						READ_PROP( buffer, cls, object, prop, s64 )
-					} break;
+				case MetaPropertyType::S8:
+				{
+					READ_PROP( buffer, cls, object, prop, s8 )
+				} break;
 
-					case MetaPropertyType::UUID:
-					{
-						READ_PROP( buffer, cls, object, prop, UUID )
-					} break;
+				case MetaPropertyType::S16:
+				{
+					READ_PROP( buffer, cls, object, prop, s16 )
+				} break;
 
-					case MetaPropertyType::Bool:
-					{
-						READ_PROP( buffer, cls, object, prop, bool )
-					} break;
+				case MetaPropertyType::S32:
+				{
+					READ_PROP( buffer, cls, object, prop, s32 )
+				} break;
 
-					case MetaPropertyType::AssetHandle:
-					{
-						// Grab asset manager
-						const MetaPropertyTemplateBase* base = prop->Cast< MetaPropertyTemplateBase >( );
-						const AssetManager* am = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( );
-						AssetHandle<Asset> val;
+				case MetaPropertyType::S64:
+				{
+					READ_PROP( buffer, cls, object, prop, s64 )
+				} break;
 
-						// Get meta class of the asset
-						const MetaClass* assetCls = base->GetClassOfTemplatedArgument( );
+				case MetaPropertyType::UUID:
+				{
+					READ_PROP( buffer, cls, object, prop, UUID )
+				} break;
 
-						// Get uuid from read buffer
-						UUID id = buffer->Read< UUID >( );
+				case MetaPropertyType::Bool:
+				{
+					READ_PROP( buffer, cls, object, prop, bool )
+				} break;
 
-						// Get asset
-						const Asset* asset = am->GetAsset( assetCls, id );
+				case MetaPropertyType::AssetHandle:
+				{
+					// Grab asset manager
+					const MetaPropertyTemplateBase* base = prop->Cast< MetaPropertyTemplateBase >( );
+					const AssetManager* am = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( );
+					AssetHandle<Asset> val;
 
-						// If valid asset
-						if ( asset )
-						{
-							// Set asset handle to default asset
-							val.Set( asset );
+					// Get meta class of the asset
+					const MetaClass* assetCls = base->GetClassOfTemplatedArgument( );
 
-						}
-						// Otherwise get default asset for this class type
-						else
-						{
-							val.Set( am->GetDefaultAsset( assetCls ) );
-						}
+					// Get uuid from read buffer
+					UUID id = buffer->Read< UUID >( );
 
-						// Set value of object
-						cls->SetValue( object, prop, val );
+					// Get asset
+					const Asset* asset = am->GetAsset( assetCls, id );
 
-					} break;
+					// If valid asset
+					if ( asset )
+					{
+						// Set asset handle to default asset
+						val.Set( asset );
 
-					case MetaPropertyType::iVec3:
+					}
+					// Otherwise get default asset for this class type
+					else
 					{
-						// Read individual elements of Vec2
-						s32 x = buffer->Read< s32 >( );
-						s32 y = buffer->Read< s32 >( );
-						s32 z = buffer->Read< s32 >( );
+						val.Set( am->GetDefaultAsset( assetCls ) );
+					}
 
-						// Set iVec3 property
-						cls->SetValue( object, prop, iVec3( x, y, z ) );
+					// Set value of object
+					cls->SetValue( object, prop, val );
 
-					} break;
+				} break;
 
-					case MetaPropertyType::Vec2:
-					{
-						// Read individual elements of Vec2
-						f32 x = buffer->Read< f32 >( );
-						f32 y = buffer->Read< f32 >( );
+				case MetaPropertyType::iVec3:
+				{
+					// Read individual elements of Vec2
+					s32 x = buffer->Read< s32 >( );
+					s32 y = buffer->Read< s32 >( );
+					s32 z = buffer->Read< s32 >( );
 
-						// Set Vec2 property
-						cls->SetValue( object, prop, Vec2( x, y ) );
-					} break;
+					// Set iVec3 property
+					cls->SetValue( object, prop, iVec3( x, y, z ) );
 
-					case MetaPropertyType::Vec3:
-					{
-						// Read individual elements of Vec3
-						f32 x = buffer->Read< f32 >( );
-						f32 y = buffer->Read< f32 >( );
-						f32 z = buffer->Read< f32 >( );
+				} break;
 
-						// Set Vec3 property
-						cls->SetValue( object, prop, Vec3( x, y, z ) );
-					} break;
+				case MetaPropertyType::Vec2:
+				{
+					// Read individual elements of Vec2
+					f32 x = buffer->Read< f32 >( );
+					f32 y = buffer->Read< f32 >( );
 
-					case MetaPropertyType::Vec4:
-					{
-						// Read individual elements of Vec4
-						f32 x = buffer->Read< f32 >( );
-						f32 y = buffer->Read< f32 >( );
-						f32 z = buffer->Read< f32 >( );
-						f32 w = buffer->Read< f32 >( );
-
-						// Set Vec4 property
-						cls->SetValue( object, prop, Vec4( x, y, z, w ) );
-					} break;
+					// Set Vec2 property
+					cls->SetValue( object, prop, Vec2( x, y ) );
+				} break;
+
+				case MetaPropertyType::Vec3:
+				{
+					// Read individual elements of Vec3
+					f32 x = buffer->Read< f32 >( );
+					f32 y = buffer->Read< f32 >( );
+					f32 z = buffer->Read< f32 >( );
+
+					// Set Vec3 property
+					cls->SetValue( object, prop, Vec3( x, y, z ) );
+				} break;
 
-					case MetaPropertyType::Transform:
-					{ 
-						Transform val;
+				case MetaPropertyType::Vec4:
+				{
+					// Read individual elements of Vec4
+					f32 x = buffer->Read< f32 >( );
+					f32 y = buffer->Read< f32 >( );
+					f32 z = buffer->Read< f32 >( );
+					f32 w = buffer->Read< f32 >( );
+
+					// Set Vec4 property
+					cls->SetValue( object, prop, Vec4( x, y, z, w ) );
+				} break;
+
+				case MetaPropertyType::Transform:
+				{ 
+					Transform val;
 		 
-						// Read in position
-						Vec3 position;
-						position.x = buffer->Read< f32 >( );
-						position.y = buffer->Read< f32 >( );
-						position.z = buffer->Read< f32 >( );
-						val.SetPosition( position );
-
-						// Read in rotation
-						Quaternion rotation;
-						rotation.x = buffer->Read< f32 >( );
-						rotation.y = buffer->Read< f32 >( );
-						rotation.z = buffer->Read< f32 >( );
-						rotation.w = buffer->Read< f32 >( );
-						val.SetRotation( rotation );
-
-						// Read in scale
-						Vec3 scale;
-						scale.x = buffer->Read< f32 >( );
-						scale.y = buffer->Read< f32 >( );
-						scale.z = buffer->Read< f32 >( );
-
-						// Set transform property
-						cls->SetValue( object, prop, val ); 
-					} break;
+					// Read in position
+					Vec3 position;
+					position.x = buffer->Read< f32 >( );
+					position.y = buffer->Read< f32 >( );
+					position.z = buffer->Read< f32 >( );
+					val.SetPosition( position );
+
+					// Read in rotation
+					Quaternion rotation;
+					rotation.x = buffer->Read< f32 >( );
+					rotation.y = buffer->Read< f32 >( );
+					rotation.z = buffer->Read< f32 >( );
+					rotation.w = buffer->Read< f32 >( );
+					val.SetRotation( rotation );
+
+					// Read in scale
+					Vec3 scale;
+					scale.x = buffer->Read< f32 >( );
+					scale.y = buffer->Read< f32 >( );
+					scale.z = buffer->Read< f32 >( );
+
+					// Set transform property
+					cls->SetValue( object, prop, val ); 
+				} break;
 
-					case MetaPropertyType::ColorRGBA32:
-					{
-						// Read all individual color channels
-						f32 r = buffer->Read< f32 >( );
-						f32 g = buffer->Read< f32 >( );
-						f32 b = buffer->Read< f32 >( );
-						f32 a = buffer->Read< f32 >( );
-
-						// Set ColorRGBA32 property
-						cls->SetValue( object, prop, ColorRGBA32( r, g, b, a ) );
-					} break;
+				case MetaPropertyType::ColorRGBA32:
+				{
+					// Read all individual color channels
+					f32 r = buffer->Read< f32 >( );
+					f32 g = buffer->Read< f32 >( );
+					f32 b = buffer->Read< f32 >( );
+					f32 a = buffer->Read< f32 >( );
+
+					// Set ColorRGBA32 property
+					cls->SetValue( object, prop, ColorRGBA32( r, g, b, a ) );
+				} break;
 
-					case MetaPropertyType::Object:
+				case MetaPropertyType::Object:
+				{
+					// If is pointer
+					if ( prop->GetTraits( ).IsPointer( ) )
 					{
-						// If is pointer
-						if ( prop->GetTraits( ).IsPointer( ) )
-						{
-							const MetaPropertyPointerBase* base = prop->Cast< MetaPropertyPointerBase >( );
-							Object* actualObj = base->GetValueAsObject( object )->ConstCast<Object>( );
+						const MetaPropertyPointerBase* base = prop->Cast< MetaPropertyPointerBase >( );
+						Object* actualObj = base->GetValueAsObject( object )->ConstCast<Object>( );
  
-							// Destroy the object for now and recreate it
-							if ( actualObj )
-							{
-								delete actualObj;
-								actualObj = nullptr;
-							}
-
-							// Grab object from deserializer
-							Object* obj = ObjectArchiver::Deserialize( buffer );
-
-							// Set value
-							cls->SetValue( object, prop, obj ); 
-						}
-						else
+						// Destroy the object for now and recreate it
+						if ( actualObj )
 						{
-							// Grab the object pointer
-							Object* obj = cls->GetValueAs< Object >( object, prop )->ConstCast< Object >( );
-							// Deserialize data
-							ObjectArchiver::Deserialize( buffer, obj );
+							delete actualObj;
+							actualObj = nullptr;
 						}
-					} break;
 
-					case MetaPropertyType::Enum:
+						// Grab object from deserializer
+						Object* obj = ObjectArchiver::Deserialize( buffer );
+
+						// Set value
+						cls->SetValue( object, prop, obj ); 
+					}
+					else
 					{
-						// Read value from buffer
-						s32 val = buffer->Read< s32 >( );
+						// Grab the object pointer
+						Object* obj = cls->GetValueAs< Object >( object, prop )->ConstCast< Object >( );
+						// Deserialize data
+						ObjectArchiver::Deserialize( buffer, obj );
+					}
+				} break;
 
-						// Set property on object
-						cls->SetValue( object, prop, val );
+				case MetaPropertyType::Enum:
+				{
+					// Read value from buffer
+					s32 val = buffer->Read< s32 >( );
 
-					} break;
+					// Set property on object
+					cls->SetValue( object, prop, val );
 
-					case MetaPropertyType::EntityHandle:
-					{
-						// Get the entity handle
-						EntityHandle handle = EntityArchiver::Deserialize( buffer );
+				} break;
 
-						// Set value on object
-						cls->SetValue( object, prop, handle );
-					} break;
+				case MetaPropertyType::EntityHandle:
+				{
+					// Get the entity handle
+					EntityHandle handle = EntityArchiver::Deserialize( buffer );
+
+					// Set value on object
+					cls->SetValue( object, prop, handle );
+				} break;
 
 	# define READ_ARRAY_PROP_PRIM( object, prop, valType, arraySize, buffer )\
 		{\
 			const MetaPropertyArray< valType >* arrayProp = prop->Cast< MetaPropertyArray< valType > >();\
 			for ( usize j = 0; j < arraySize; ++j )\
 			{\
-				/*Grab value from buffer and set at index in array*/\
-				arrayProp->SetValueAt( object, j, buffer->Read< valType >( ) );\
+			/*Grab value from buffer and set at index in array*/\
+			arrayProp->SetValueAt( object, j, buffer->Read< valType >( ) );\
 			}\
 		} 
-				case MetaPropertyType::Array:
-				{
-					// Get base
-					const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+			case MetaPropertyType::Array:
+			{
+				// Get base
+				const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+
+				// Read size of array from buffer
+				u32 arraySize = buffer->Read< u32 >( );
 
-					// Read size of array from buffer
-					u32 arraySize = buffer->Read< u32 >( );
+				// If a dynamic vector then need to resize vector to allow for placement
+				switch ( base->GetArraySizeType( ) )
+				{
+					default: break;
+					case ArraySizeType::Dynamic:
+					{
+						base->Resize( object, arraySize );
+					} break;
+					}
 
-					// If a dynamic vector then need to resize vector to allow for placement
-					switch ( base->GetArraySizeType( ) )
+					// Read out array elements
+					switch ( base->GetArrayType( ) )
 					{
 						default: break;
-						case ArraySizeType::Dynamic:
+						case MetaPropertyType::Bool:	READ_ARRAY_PROP_PRIM( object, base, bool, arraySize, buffer )	break;
+						case MetaPropertyType::U8:		READ_ARRAY_PROP_PRIM( object, base, u8, arraySize, buffer )		break;
+						case MetaPropertyType::U32:		READ_ARRAY_PROP_PRIM( object, base, u32, arraySize, buffer )	break;
+						case MetaPropertyType::S32:		READ_ARRAY_PROP_PRIM( object, base, s32, arraySize, buffer )	break;
+						case MetaPropertyType::F32:		READ_ARRAY_PROP_PRIM( object, base, f32, arraySize, buffer )	break;
+						case MetaPropertyType::F64:		READ_ARRAY_PROP_PRIM( object, base, f64, arraySize, buffer )	break;
+						case MetaPropertyType::String:	READ_ARRAY_PROP_PRIM( object, base, String, arraySize, buffer )	break;
+						case MetaPropertyType::UUID:	READ_ARRAY_PROP_PRIM( object, base, UUID, arraySize, buffer )	break;
+						case MetaPropertyType::AssetHandle:
 						{
-							base->Resize( object, arraySize );
-						} break;
-						}
+							MetaArrayPropertyProxy proxy = base->GetProxy( );
+							const MetaPropertyTemplateBase* arrBase = static_cast< const MetaPropertyTemplateBase* > ( proxy.mArrayPropertyTypeBase );
+							const MetaClass* assetCls = const_cast< Enjon::MetaClass* >( arrBase->GetClassOfTemplatedArgument( ) );
 
-						// Read out array elements
-						switch ( base->GetArrayType( ) )
+							// Write out asset uuids in array
+							const MetaPropertyArray< AssetHandle< Asset > >* arrProp = base->Cast< MetaPropertyArray< AssetHandle< Asset > > >( );
+							for ( usize j = 0; j < arraySize; ++j )
+							{
+								AssetHandle<Asset> newAsset = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetAsset( assetCls, buffer->Read< UUID >( ) );
+								arrProp->SetValueAt( object, j, newAsset );
+							}
+						} break;
+						
+						case MetaPropertyType::Object:
 						{
-							default: break;
-							case MetaPropertyType::Bool:	READ_ARRAY_PROP_PRIM( object, base, bool, arraySize, buffer )	break;
-							case MetaPropertyType::U8:		READ_ARRAY_PROP_PRIM( object, base, u8, arraySize, buffer )		break;
-							case MetaPropertyType::U32:		READ_ARRAY_PROP_PRIM( object, base, u32, arraySize, buffer )	break;
-							case MetaPropertyType::S32:		READ_ARRAY_PROP_PRIM( object, base, s32, arraySize, buffer )	break;
-							case MetaPropertyType::F32:		READ_ARRAY_PROP_PRIM( object, base, f32, arraySize, buffer )	break;
-							case MetaPropertyType::F64:		READ_ARRAY_PROP_PRIM( object, base, f64, arraySize, buffer )	break;
-							case MetaPropertyType::String:	READ_ARRAY_PROP_PRIM( object, base, String, arraySize, buffer )	break;
-							case MetaPropertyType::UUID:	READ_ARRAY_PROP_PRIM( object, base, UUID, arraySize, buffer )	break;
-							case MetaPropertyType::AssetHandle:
+							const MetaPropertyArray< Object* >* arrProp = prop->Cast< MetaPropertyArray< Object* > >( );
+							if ( arrProp )
 							{
-								MetaArrayPropertyProxy proxy = base->GetProxy( );
-								const MetaPropertyTemplateBase* arrBase = static_cast< const MetaPropertyTemplateBase* > ( proxy.mArrayPropertyTypeBase );
-								const MetaClass* assetCls = const_cast< Enjon::MetaClass* >( arrBase->GetClassOfTemplatedArgument( ) );
-
-								// Write out asset uuids in array
-								const MetaPropertyArray< AssetHandle< Asset > >* arrProp = base->Cast< MetaPropertyArray< AssetHandle< Asset > > >( );
 								for ( usize j = 0; j < arraySize; ++j )
 								{
-									AssetHandle<Asset> newAsset = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< AssetManager >( )->GetAsset( assetCls, buffer->Read< UUID >( ) );
-									arrProp->SetValueAt( object, j, newAsset );
-								}
-							} break;
-							
-							case MetaPropertyType::Object:
-							{
-								const MetaPropertyArray< Object* >* arrProp = prop->Cast< MetaPropertyArray< Object* > >( );
-								if ( arrProp )
-								{
-									for ( usize j = 0; j < arraySize; ++j )
-									{
-										arrProp->SetValueAt( object, j, ObjectArchiver::Deserialize( buffer ) );
-									}
+									arrProp->SetValueAt( object, j, ObjectArchiver::Deserialize( buffer ) );
 								}
-							} break;
-						} 
-					} break;
+							}
+						} break;
+					} 
+				} break;
 
 
 		#define READ_MAP_KEY_PRIM_VAL_PRIM( object, prop, keyType, valType, mapSize, buffer )\
 			{\
-				const MetaPropertyHashMap< keyType, valType >* mapProp = prop->Cast< MetaPropertyHashMap< keyType, valType > >();\
-				for ( usize j = 0; j < mapSize; ++j )\
-				{\
-					/*Read Key*/\
-					keyType key = buffer->Read< keyType >( );\
-					/*Read Value*/\
-					valType val = buffer->Read< valType >( );\
-					/*Set Value at key*/\
-					mapProp->SetValueAt( object, key, val );\
-				}\
+			const MetaPropertyHashMap< keyType, valType >* mapProp = prop->Cast< MetaPropertyHashMap< keyType, valType > >();\
+			for ( usize j = 0; j < mapSize; ++j )\
+			{\
+				/*Read Key*/\
+				keyType key = buffer->Read< keyType >( );\
+				/*Read Value*/\
+				valType val = buffer->Read< valType >( );\
+				/*Set Value at key*/\
+				mapProp->SetValueAt( object, key, val );\
+			}\
 			} 
 
 		#define READ_MAP_KEY_PRIM_VAL_OBJ( object, prop, keyType, mapSize, buffer )\
 			{\
-				const MetaPropertyHashMap< keyType, Object* >* mapProp = prop->Cast< MetaPropertyHashMap< keyType, Object* > >();\
-				for ( usize j = 0; j < mapSize; ++j )\
-				{\
-					/* Read Key */\
-					keyType key = buffer->Read< keyType >();\
-					/* Read Value */\
-					Object* val = ObjectArchiver::Deserialize( buffer );\
-					/* Set Value */\
-					mapProp->SetValueAt( object, key, val );\
-				}\
+			const MetaPropertyHashMap< keyType, Object* >* mapProp = prop->Cast< MetaPropertyHashMap< keyType, Object* > >();\
+			for ( usize j = 0; j < mapSize; ++j )\
+			{\
+				/* Read Key */\
+				keyType key = buffer->Read< keyType >();\
+				/* Read Value */\
+				Object* val = ObjectArchiver::Deserialize( buffer );\
+				/* Set Value */\
+				mapProp->SetValueAt( object, key, val );\
+			}\
 			}
-					case MetaPropertyType::HashMap:
-					{
-						// Get base
-						const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
+				case MetaPropertyType::HashMap:
+				{
+					// Get base
+					const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
 
-						// Read size of map to buffer
-						u32 mapSize = buffer->Read< u32 >( );
+					// Read size of map to buffer
+					u32 mapSize = buffer->Read< u32 >( );
 
-						switch ( base->GetKeyType( ) )
-						{
-							default: break;
+					switch ( base->GetKeyType( ) )
+					{
+						default: break;
 
-							case MetaPropertyType::U32:
+						case MetaPropertyType::U32:
+						{
+							switch ( base->GetValueType( ) )
 							{
-								switch ( base->GetValueType( ) )
-								{
-									default: break;
-									case MetaPropertyType::U32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, u32, u32, mapSize, buffer )	break;
-									case MetaPropertyType::S32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, s32, u32, mapSize, buffer )	break;
-									case MetaPropertyType::F32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, f32, u32, mapSize, buffer )	break;
-								}
-							} break;
+								default: break;
+								case MetaPropertyType::U32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, u32, u32, mapSize, buffer )	break;
+								case MetaPropertyType::S32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, s32, u32, mapSize, buffer )	break;
+								case MetaPropertyType::F32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, f32, u32, mapSize, buffer )	break;
+							}
+						} break;
 
-							case MetaPropertyType::String:
+						case MetaPropertyType::String:
+						{
+							switch ( base->GetValueType( ) )
 							{
-								switch ( base->GetValueType( ) )
-								{
-									default: break;
-									case MetaPropertyType::U32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, String, u32, mapSize, buffer )	break;
-									case MetaPropertyType::Object:	READ_MAP_KEY_PRIM_VAL_OBJ( object, base, String, mapSize, buffer )			break;
-								}
+								default: break;
+								case MetaPropertyType::U32:		READ_MAP_KEY_PRIM_VAL_PRIM( object, base, String, u32, mapSize, buffer )	break;
+								case MetaPropertyType::Object:	READ_MAP_KEY_PRIM_VAL_OBJ( object, base, String, mapSize, buffer )			break;
+							}
 
-							} break;
+						} break;
 
-							case MetaPropertyType::Enum:
+						case MetaPropertyType::Enum:
+						{
+							switch ( base->GetValueType( ) )
 							{
-								switch ( base->GetValueType( ) )
-								{
-									default: break;
-									case MetaPropertyType::String:	READ_MAP_KEY_PRIM_VAL_PRIM( object, base, s32, String, mapSize, buffer )	break;
-									case MetaPropertyType::Object:	READ_MAP_KEY_PRIM_VAL_OBJ( object, base, s32, mapSize, buffer )			break;
-								}
-							} break;
-						}
-					} break;
-				}
+								default: break;
+								case MetaPropertyType::String:	READ_MAP_KEY_PRIM_VAL_PRIM( object, base, s32, String, mapSize, buffer )	break;
+								case MetaPropertyType::Object:	READ_MAP_KEY_PRIM_VAL_OBJ( object, base, s32, mapSize, buffer )			break;
+							}
+						} break;
+					}
+				} break;
 			}
-			// Otherwise skip the property in the buffer
-			else
-			{
-				buffer->AdvanceReadPosition( propSize );
-			} 
 	}
 }
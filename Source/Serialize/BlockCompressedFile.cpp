@@ -0,0 +1,532 @@
+// @file BlockCompressedFile.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Serialize/BlockCompressedFile.h"
+#include "Serialize/LZCompression.h"
+#include "System/JobSystem.h"
+
+#include <fstream>
+#include <atomic>
+#include <string.h>
+
+// High bit of a block's compressed size marks it as stored uncompressed
+#define ENJON_BLOCK_RAW_FLAG		0x80000000
+#define ENJON_BLOCK_HEADER_SIZE		( 5 * sizeof( u32 ) )
+#define ENJON_BLOCK_ENTRY_SIZE		( 2 * sizeof( u32 ) )
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL inline void WriteU32( std::ofstream& file, u32 val )
+	{
+		file.write( ( const char* )&val, sizeof( u32 ) );
+	}
+
+	//=================================================================
+
+	INTERNAL inline u32 ReadU32( const u8* data )
+	{
+		u32 val;
+		memcpy( &val, data, sizeof( u32 ) );
+		return val;
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::Write( const u8* data, u32 size, const String& filePath, u32 blockSize )
+	{
+		blockSize = blockSize ? blockSize : ENJON_BLOCK_COMPRESSED_DEFAULT_BLOCK_SIZE;
+		u32 blockCount = ( size + blockSize - 1 ) / blockSize;
+
+		// Compress each block independently
+		Vector< Vector< u8 > > compressed( blockCount );
+		Vector< u32 > compressedSizes( blockCount, 0 );
+		JobSystem::ParallelForOrSerial( blockCount, [ & ] ( u32 i )
+		{
+			u32 start = i * blockSize;
+			u32 rawSize = std::min( blockSize, size - start );
+
+			compressed[ i ].resize( LZCompression::GetMaxCompressedSize( rawSize ) );
+			u32 csize = LZCompression::Compress( data + start, rawSize, compressed[ i ].data( ), ( u32 )compressed[ i ].size( ) );
+
+			// Store raw if compression did not help
+			if ( !csize || csize >= rawSize )
+			{
+				compressed[ i ].assign( data + start, data + start + rawSize );
+				compressedSizes[ i ] = rawSize | ENJON_BLOCK_RAW_FLAG;
+			}
+			else
+			{
+				compressed[ i ].resize( csize );
+				compressedSizes[ i ] = csize;
+			}
+		} );
+
+		std::ofstream file( filePath, std::ios::out | std::ios::binary );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		// Header
+		WriteU32( file, ENJON_BLOCK_COMPRESSED_FILE_MAGIC );
+		WriteU32( file, ENJON_BLOCK_COMPRESSED_FILE_VERSION );
+		WriteU32( file, size );
+		WriteU32( file, blockSize );
+		WriteU32( file, blockCount );
+
+		// Block table, offsets relative to start of block data
+		u32 offset = 0;
+		for ( u32 i = 0; i < blockCount; ++i )
+		{
+			WriteU32( file, offset );
+			WriteU32( file, compressedSizes[ i ] );
+			offset += ( u32 )compressed[ i ].size( );
+		}
+
+		// Block data
+		for ( auto& block : compressed )
+		{
+			file.write( ( const char* )block.data( ), block.size( ) );
+		}
+
+		return file.good( ) ? Result::SUCCESS : Result::FAILURE;
+	}
+
+	//=================================================================
+
+	bool BlockCompressedFile::IsCompressedFile( const String& filePath )
+	{
+		std::ifstream file( filePath, std::ios::in | std::ios::binary );
+		if ( !file )
+		{
+			return false;
+		}
+
+		u32 magic = 0;
+		file.read( ( char* )&magic, sizeof( u32 ) );
+		return ( file.gcount( ) == sizeof( u32 ) && magic == ENJON_BLOCK_COMPRESSED_FILE_MAGIC );
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadFile( const String& filePath, ByteBuffer* buffer )
+	{
+		if ( !buffer )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( !IsCompressedFile( filePath ) )
+		{
+			buffer->ReadFromFile( filePath );
+			return ( buffer->GetStatus( ) == BufferStatus::Invalid ) ? Result::FAILURE : Result::SUCCESS;
+		}
+
+		BlockCompressedFile file;
+		if ( file.Open( filePath ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		// Decompress straight into buffer storage
+		u8* out = buffer->PrepareForRead( file.GetUncompressedSize( ) );
+		if ( !out || file.ReadAll( out ) != Result::SUCCESS )
+		{
+			buffer->Reset( );
+			return Result::FAILURE;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadFileRange( const String& filePath, u32 offset, u32 size, u8* out )
+	{
+		if ( !out && size )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( !IsCompressedFile( filePath ) )
+		{
+			std::ifstream file( filePath, std::ios::in | std::ios::binary );
+			if ( !file )
+			{
+				return Result::FAILURE;
+			}
+
+			file.seekg( offset, std::ios::beg );
+			file.read( ( char* )out, size );
+			return ( ( u32 )file.gcount( ) == size ) ? Result::SUCCESS : Result::FAILURE;
+		}
+
+		BlockCompressedFile file;
+		if ( file.Open( filePath ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		return file.ReadRange( offset, size, out );
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadMemoryRange( const u8* data, usize fileSize, u32 offset, u32 size, u8* out )
+	{
+		if ( !data || ( !out && size ) )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( !IsCompressedMemory( data, fileSize ) )
+		{
+			if ( ( usize )offset + size > fileSize )
+			{
+				return Result::FAILURE;
+			}
+			memcpy( out, data + offset, size );
+			return Result::SUCCESS;
+		}
+
+		BlockCompressedFile file;
+		if ( file.OpenMemory( data, fileSize ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		return file.ReadRange( offset, size, out );
+	}
+
+	//=================================================================
+
+	bool BlockCompressedFile::ReadHeader( const u8* header, u32* blockCount )
+	{
+		u32 magic = ReadU32( header );
+		u32 version = ReadU32( header + 4 );
+		if ( magic != ENJON_BLOCK_COMPRESSED_FILE_MAGIC || version != ENJON_BLOCK_COMPRESSED_FILE_VERSION )
+		{
+			return false;
+		}
+
+		mUncompressedSize = ReadU32( header + 8 );
+		mBlockSize = ReadU32( header + 12 );
+		*blockCount = ReadU32( header + 16 );
+
+		// Sanity check header against itself before trusting block table
+		return ( mBlockSize && *blockCount == ( mUncompressedSize + mBlockSize - 1 ) / mBlockSize );
+	}
+
+	//=================================================================
+
+	bool BlockCompressedFile::ReadBlockTable( const u8* table, u32 blockCount )
+	{
+		// Blocks are written back to back, so anything else means a corrupt table
+		u32 expectedOffset = 0;
+		mBlocks.resize( blockCount );
+		for ( u32 i = 0; i < blockCount; ++i )
+		{
+			u32 csize = ReadU32( table + i * ENJON_BLOCK_ENTRY_SIZE + 4 );
+			mBlocks[ i ].mOffset = ReadU32( table + i * ENJON_BLOCK_ENTRY_SIZE );
+			mBlocks[ i ].mCompressedSize = csize & ~ENJON_BLOCK_RAW_FLAG;
+			mBlocks[ i ].mIsRaw = ( csize & ENJON_BLOCK_RAW_FLAG ) != 0;
+
+			if ( mBlocks[ i ].mOffset != expectedOffset )
+			{
+				mBlocks.clear( );
+				return false;
+			}
+			expectedOffset += mBlocks[ i ].mCompressedSize;
+		}
+
+		mDataOffset = ENJON_BLOCK_HEADER_SIZE + blockCount * ENJON_BLOCK_ENTRY_SIZE;
+		return true;
+	}
+
+	//=================================================================
+
+	bool BlockCompressedFile::IsCompressedMemory( const u8* data, usize size )
+	{
+		return ( data && size >= sizeof( u32 ) && ReadU32( data ) == ENJON_BLOCK_COMPRESSED_FILE_MAGIC );
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadMemory( const u8* data, usize size, ByteBuffer* buffer )
+	{
+		if ( !buffer || !data )
+		{
+			return Result::FAILURE;
+		}
+
+		// Plain files are copied as is
+		if ( !IsCompressedMemory( data, size ) )
+		{
+			u8* out = buffer->PrepareForRead( ( u32 )size );
+			if ( !out )
+			{
+				return Result::FAILURE;
+			}
+			memcpy( out, data, size );
+			return Result::SUCCESS;
+		}
+
+		BlockCompressedFile file;
+		if ( file.OpenMemory( data, size ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		u8* out = buffer->PrepareForRead( file.GetUncompressedSize( ) );
+		if ( !out || file.ReadAll( out ) != Result::SUCCESS )
+		{
+			buffer->Reset( );
+			return Result::FAILURE;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::Open( const String& filePath )
+	{
+		mIsOpen = false;
+		mBlocks.clear( );
+		mMemory = nullptr;
+		mMemorySize = 0;
+
+		std::ifstream file( filePath, std::ios::in | std::ios::binary );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		u8 header[ ENJON_BLOCK_HEADER_SIZE ];
+		file.read( ( char* )header, ENJON_BLOCK_HEADER_SIZE );
+		u32 blockCount = 0;
+		if ( file.gcount( ) != ENJON_BLOCK_HEADER_SIZE || !ReadHeader( header, &blockCount ) )
+		{
+			return Result::FAILURE;
+		}
+
+		Vector< u8 > table( blockCount * ENJON_BLOCK_ENTRY_SIZE );
+		file.read( ( char* )table.data( ), table.size( ) );
+		if ( ( size_t )file.gcount( ) != table.size( ) || !ReadBlockTable( table.data( ), blockCount ) )
+		{
+			return Result::FAILURE;
+		}
+
+		mFilePath = filePath;
+		mIsOpen = true;
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::OpenMemory( const u8* data, usize size )
+	{
+		mIsOpen = false;
+		mBlocks.clear( );
+
+		u32 blockCount = 0;
+		if ( !data || size < ENJON_BLOCK_HEADER_SIZE || !ReadHeader( data, &blockCount ) )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( ( usize )blockCount * ENJON_BLOCK_ENTRY_SIZE > size - ENJON_BLOCK_HEADER_SIZE || !ReadBlockTable( data + ENJON_BLOCK_HEADER_SIZE, blockCount ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// All block data has to be present, since it is never read from anywhere else
+		if ( !mBlocks.empty( ) && mDataOffset + ( usize )mBlocks.back( ).mOffset + mBlocks.back( ).mCompressedSize > size )
+		{
+			mBlocks.clear( );
+			return Result::FAILURE;
+		}
+
+		mFilePath = "";
+		mMemory = data;
+		mMemorySize = size;
+		mIsOpen = true;
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	bool BlockCompressedFile::IsOpen( ) const
+	{
+		return mIsOpen;
+	}
+
+	//=================================================================
+
+	u32 BlockCompressedFile::GetUncompressedSize( ) const
+	{
+		return mUncompressedSize;
+	}
+
+	//=================================================================
+
+	u32 BlockCompressedFile::GetBlockCount( ) const
+	{
+		return ( u32 )mBlocks.size( );
+	}
+
+	//=================================================================
+
+	u32 BlockCompressedFile::GetBlockUncompressedSize( u32 index ) const
+	{
+		return std::min( mBlockSize, mUncompressedSize - index * mBlockSize );
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadBlockData( u32 first, u32 last, Vector< u8 >* storage, const u8** data ) const
+	{
+		const BlockEntry& begin = mBlocks.at( first );
+		const BlockEntry& end = mBlocks.at( last );
+		u32 size = ( end.mOffset + end.mCompressedSize ) - begin.mOffset;
+
+		// Already resident, bounds were checked when opened
+		if ( mMemory )
+		{
+			*data = mMemory + mDataOffset + begin.mOffset;
+			return Result::SUCCESS;
+		}
+
+		std::ifstream file( mFilePath, std::ios::in | std::ios::binary );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		storage->resize( size );
+		file.seekg( mDataOffset + begin.mOffset, std::ios::beg );
+		file.read( ( char* )storage->data( ), size );
+		*data = storage->data( );
+
+		return ( ( u32 )file.gcount( ) == size ) ? Result::SUCCESS : Result::FAILURE;
+	}
+
+	//=================================================================
+
+	bool BlockCompressedFile::DecompressBlock( u32 index, const u8* src, u8* out ) const
+	{
+		const BlockEntry& block = mBlocks.at( index );
+		u32 rawSize = GetBlockUncompressedSize( index );
+
+		if ( block.mIsRaw )
+		{
+			if ( block.mCompressedSize != rawSize )
+			{
+				return false;
+			}
+
+			memcpy( out, src, rawSize );
+			return true;
+		}
+
+		return LZCompression::Decompress( src, block.mCompressedSize, out, rawSize );
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadRange( u32 offset, u32 size, u8* out ) const
+	{
+		if ( !mIsOpen || offset + size > mUncompressedSize || offset + size < offset )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( !size )
+		{
+			return Result::SUCCESS;
+		}
+
+		u32 first = offset / mBlockSize;
+		u32 last = ( offset + size - 1 ) / mBlockSize;
+
+		Vector< u8 > storage;
+		const u8* data = nullptr;
+		if ( ReadBlockData( first, last, &storage, &data ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+
+		Vector< u8 > scratch( mBlockSize );
+		u32 written = 0;
+		for ( u32 i = first; i <= last; ++i )
+		{
+			const u8* src = data + ( mBlocks[ i ].mOffset - mBlocks[ first ].mOffset );
+			u32 blockStart = i * mBlockSize;
+			u32 copyStart = std::max( offset, blockStart ) - blockStart;
+			u32 copySize = std::min( offset + size, blockStart + GetBlockUncompressedSize( i ) ) - blockStart - copyStart;
+
+			// Whole blocks can be decompressed directly into output
+			if ( copyStart == 0 && copySize == GetBlockUncompressedSize( i ) )
+			{
+				if ( !DecompressBlock( i, src, out + written ) )
+				{
+					return Result::FAILURE;
+				}
+			}
+			else
+			{
+				if ( !DecompressBlock( i, src, scratch.data( ) ) )
+				{
+					return Result::FAILURE;
+				}
+				memcpy( out + written, scratch.data( ) + copyStart, copySize );
+			}
+
+			written += copySize;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	Result BlockCompressedFile::ReadAll( u8* out ) const
+	{
+		if ( !mIsOpen )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( mBlocks.empty( ) )
+		{
+			return Result::SUCCESS;
+		}
+
+		// One sequential read for all block data, then decompress blocks independently
+		Vector< u8 > storage;
+		const u8* data = nullptr;
+		if ( ReadBlockData( 0, ( u32 )mBlocks.size( ) - 1, &storage, &data ) != Result::SUCCESS )
+		{
+			return Result::FAILURE;
+		}
+		u32 dataSize = ( mBlocks.back( ).mOffset + mBlocks.back( ).mCompressedSize );
+
+		std::atomic< bool > failed( false );
+		JobSystem::ParallelForOrSerial( ( u32 )mBlocks.size( ), [ & ] ( u32 i )
+		{
+			const BlockEntry& block = mBlocks[ i ];
+			if ( block.mOffset + block.mCompressedSize > dataSize || !DecompressBlock( i, data + block.mOffset, out + i * mBlockSize ) )
+			{
+				failed = true;
+			}
+		} );
+
+		return failed ? Result::FAILURE : Result::SUCCESS;
+	}
+
+	//=================================================================
+}
@@ -56,6 +56,18 @@ namespace Enjon
 
 	//========================================================================
 
+	ByteBuffer::ByteBuffer( const u8* data, const u32& size )
+	{
+		mBuffer = const_cast< u8* >( data );
+		mSize = size;
+		mCapacity = size ? size : 1;		// Writes grow capacity by doubling it
+		mWritePosition = size;
+		mOwnsData = false;
+		mStatus = BufferStatus::ReadyToRead;
+	}
+
+	//========================================================================
+
 	ByteBuffer::~ByteBuffer( )
 	{
 		ReleaseData( );
@@ -65,12 +77,13 @@ namespace Enjon
 
 	void ByteBuffer::ReleaseData( )
 	{
-		if ( mBuffer )
+		if ( mBuffer && mOwnsData )
 		{
 			// Delete all of its data
 			free( mBuffer ); 
 		}
 		mBuffer = nullptr;
+		mOwnsData = true;
 	}
 
 	//========================================================================
@@ -95,6 +108,18 @@ namespace Enjon
 
 	void ByteBuffer::Resize( u32 size )
 	{
+		// Views don't own their data, so take a copy of it before growing
+		if ( !mOwnsData )
+		{
+			u8* data = (u8*)malloc( sizeof( u8 ) * (u32)size );
+			assert( data != nullptr );
+			memcpy( data, mBuffer, mSize );
+			mBuffer = data;
+			mOwnsData = true;
+			mReadPosition = 0;
+			return;
+		}
+
 		mBuffer = (u8*)realloc( mBuffer, sizeof( u8 ) * (u32)size );
 		mReadPosition = 0;
 		assert( mBuffer != nullptr );
@@ -297,10 +322,7 @@ namespace Enjon
 			oData[size] = '\0';
 
 			// Delete previous buffer that was allocated
-			if ( mBuffer )
-			{
-				free( mBuffer );
-			}
+			ReleaseData( );
 
 			// Set buffer to oData and reset fields
 			mBuffer = oData;
@@ -366,6 +388,77 @@ namespace Enjon
 
 	//========================================================================
 
+	u32 ByteBuffer::GetReadPosition( ) const
+	{
+		return mReadPosition;
+	}
+
+	//========================================================================
+
+	void ByteBuffer::WriteBytes( const u8* data, const u32& size )
+	{
+		// Total amount of capacity needed to write this chunk of data
+		u32 totalWriteSize = mWritePosition + size;
+
+		// Make sure that enough bytes are present in buffer
+		if ( totalWriteSize >= mCapacity )
+		{
+			while ( mCapacity < totalWriteSize )
+			{
+				mCapacity *= 2; 
+			}
+			Resize( mCapacity );
+		}
+
+		memcpy( mBuffer + mWritePosition, data, size );
+
+		mWritePosition += size;
+		mSize += size;
+	}
+
+	//========================================================================
+
+	bool ByteBuffer::ReadBytes( u8* data, const u32& size )
+	{
+		if ( mReadPosition + size > mSize )
+		{
+			return false;
+		}
+
+		memcpy( data, mBuffer + mReadPosition, size );
+
+		mReadPosition += size;
+
+		return true;
+	}
+
+	//========================================================================
+
+	u8* ByteBuffer::PrepareForRead( const u32& size )
+	{
+		ReleaseData( );
+
+		mBuffer = (u8*)malloc( size + 1 );
+		if ( !mBuffer )
+		{
+			mSize = 0;
+			mCapacity = 0;
+			mStatus = BufferStatus::Invalid;
+			return nullptr;
+		}
+
+		mBuffer[ size ] = '\0';
+		mSize = size;
+		mCapacity = size + 1;
+		mReadPosition = 0;
+		mWritePosition = 0;
+		mStatus = BufferStatus::ReadyToRead;
+
+		return mBuffer;
+	}
+
+	//========================================================================
+
 	void ByteBuffer::CopyFromOther( const ByteBuffer& other ) 
 	{ 
 		// Release previous data
@@ -397,12 +490,7 @@ namespace Enjon
 
 	void ByteBuffer::AppendBuffer( const ByteBuffer& other )
 	{
-		// Brute force loop for now...
-		for ( u32 i = 0; i < other.GetSize( ); ++i ) 
-		{
-			// Write to buffer
-			Write< u8 >( other.mBuffer[i] );
-		} 
+		WriteBytes( other.mBuffer, other.GetSize( ) );
 	}
 
 	//========================================================================
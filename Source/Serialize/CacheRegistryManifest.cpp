@@ -3,12 +3,19 @@
 
 #include "Serialize/CacheRegistryManifest.h"
 #include "Serialize/AssetArchiver.h"
+#include "Serialize/BlockCompressedFile.h"
+#include "Serialize/JSONArchiver.h"
+#include "Serialize/PakFile.h"
 #include "Asset/AssetManager.h"
 #include "SubsystemCatalog.h"
 #include "Engine.h"
 
 #include "fs/filesystem.hpp"
 
+#include <fstream>
+#include <algorithm>
+#include <string.h>
+
 namespace Enjon
 { 
 	//=========================================================================================
@@ -19,6 +26,7 @@ namespace Enjon
 		mManifestPath = "";
 		// Clear records
 		mManifestRecords.clear();
+		mIsDirty = false;
 	}
 
 	//=========================================================================================
@@ -38,6 +46,9 @@ namespace Enjon
 			ghc::filesystem::create_directory( manager->GetCachedAssetsDirectoryPath( ) );
 		}
 
+		// Write out any pending changes to previous index before resetting
+		Flush( );
+
 		// Reset manifest records
 		Reset();
 
@@ -56,28 +67,328 @@ namespace Enjon
 
 	Result CacheRegistryManifest::WriteOutManifest( const String& manifestPath  )
 	{
+		// Sort records by UUID bytes so the index is the same between writes of the same records
+		Vector< const CacheManifestRecord* > records;
+		records.reserve( mManifestRecords.size( ) );
+		for ( auto iter = mManifestRecords.begin( ); iter != mManifestRecords.end( ); ++iter )
+		{
+			records.push_back( &iter->second );
+		}
+		std::sort( records.begin( ), records.end( ), [ ] ( const CacheManifestRecord* a, const CacheManifestRecord* b )
+		{
+			return a->mAssetUUID < b->mAssetUUID;
+		} );
+
 		// Create write buffer
 		ByteBuffer buffer;
 
+		// Index header
+		buffer.Write< u32 >( ENJON_CACHE_MANIFEST_INDEX_MAGIC );
+		buffer.Write< u32 >( ENJON_CACHE_MANIFEST_INDEX_VERSION );
+
 		// Amount of records to store
-		buffer.Write< u32 >( mManifestRecords.size( ) );
+		buffer.Write< u32 >( ( u32 )records.size( ) );
 
 		// For each record, write out information into buffer
-		for ( auto iter = mManifestRecords.begin( ); iter != mManifestRecords.end( ); ++iter )
+		for ( const CacheManifestRecord* record : records )
 		{
 			// Write out UUID of record
-			buffer.Write< UUID >( iter->second.mAssetUUID );
+			buffer.Write< UUID >( record->mAssetUUID );
 			// Write out file path of record
-			buffer.Write< String >( iter->second.mAssetFilePath );
+			buffer.Write< String >( record->mAssetFilePath );
 			// Write out name of asset
-			buffer.Write< String >( iter->second.mAssetName );
+			buffer.Write< String >( record->mAssetName );
 			// Write out MetaClass name of loader
-			buffer.Write< String >( iter->second.mAssetLoaderClass != nullptr ? iter->second.mAssetLoaderClass->GetName() : "" );
+			buffer.Write< String >( record->mAssetLoaderClass != nullptr ? record->mAssetLoaderClass->GetName() : "" );
+			// Write out MetaClass name of asset
+			buffer.Write< String >( record->mAssetClass != nullptr ? record->mAssetClass->GetName() : "" );
+			// Write out file stats used to validate record on next read
+			buffer.Write< u64 >( record->mFileSize );
+			buffer.Write< s64 >( record->mFileWriteTime );
+			// Write out source asset was imported from, so reimports can be skipped without opening the asset file
+			buffer.Write< String >( record->mSourceInfo.mSourceFilePath );
+			buffer.Write< u64 >( record->mSourceInfo.mSourceFileSize );
+			buffer.Write< s64 >( record->mSourceInfo.mSourceWriteTime );
+			buffer.Write< u64 >( record->mSourceInfo.mSourceHash );
+			buffer.Write< String >( record->mSourceInfo.mImportSettings );
 		}
 
+		// Make sure intermediate directory exists
+		std::error_code ec;
+		ghc::filesystem::create_directories( ghc::filesystem::path( manifestPath ).parent_path( ), ec );
+
 		// Write to file using manifest path
 		buffer.WriteToFile( manifestPath );
 
+		mIsDirty = false;
+
+		return Result::SUCCESS;
+	}
+
+	//=========================================================================================
+
+	Result CacheRegistryManifest::Flush( )
+	{
+		if ( !mIsDirty || mManifestPath.empty( ) )
+		{
+			return Result::SUCCESS;
+		}
+
+		return WriteOutManifest( mManifestPath );
+	}
+
+	//=========================================================================================
+
+	// Bounds checked reads over raw bytes. Manifest and asset headers can be truncated or stale, so nothing is trusted.
+	struct ManifestReader
+	{
+		const u8* mData;
+		usize mSize;
+		usize mPosition;
+
+		template < typename T >
+		bool Read( T* val )
+		{
+			if ( mPosition + sizeof( T ) > mSize )
+			{
+				return false;
+			}
+			memcpy( val, mData + mPosition, sizeof( T ) );
+			mPosition += sizeof( T );
+			return true;
+		}
+
+		bool ReadString( String* val )
+		{
+			u32 size = 0;
+			if ( !Read< u32 >( &size ) || mPosition + size > mSize )
+			{
+				return false;
+			}
+			val->assign( ( const char* )( mData + mPosition ), size );
+			mPosition += size;
+			return true;
+		}
+	};
+
+	//=========================================================================================
+
+	// Asset header is small, so only its prefix is read for new or changed files
+	#define ENJON_ASSET_HEADER_PREFIX_SIZE	1024
+
+	//=========================================================================================
+
+	INTERNAL bool ParseAssetHeader( const u8* data, usize size, CacheManifestRecord* record )
+	{
+		// Assets saved as text carry the same header fields as json values
+		if ( JSONArchiver::IsAssetText( data, size ) )
+		{
+			AssetHeader header;
+			if ( JSONArchiver::ReadAssetHeader( data, size, &header ) != Result::SUCCESS )
+			{
+				return false;
+			}
+
+			record->mAssetClass = header.mClass;
+			record->mAssetUUID = header.mUUID;
+			record->mAssetName = header.mName;
+			record->mAssetLoaderClass = Object::GetClass( header.mLoaderName );
+			record->mSourceInfo = header.mSourceInfo;
+
+			return true;
+		}
+
+		ManifestReader reader = { data, size, 0 };
+		String className, uuid, name, loaderName;
+		u32 versionNumber = 0;
+
+		//==================================================
+		// Object Header 
+		//==================================================
+		if ( !reader.ReadString( &className ) || !reader.Read< u32 >( &versionNumber ) )
+		{
+			return false;
+		}
+
+		//==================================================
+		// Asset Header 
+		//================================================== 
+		if ( !reader.ReadString( &uuid ) || !reader.ReadString( &name ) || !reader.ReadString( &loaderName ) )
+		{
+			return false;
+		}
+
+		record->mAssetClass = Object::GetClass( className );
+		record->mAssetUUID = UUID( uuid );
+		record->mAssetName = name;
+		record->mAssetLoaderClass = Object::GetClass( loaderName );
+
+		//==================================================
+		// Source Info 
+		//==================================================
+		if ( versionNumber >= 1 )
+		{
+			AssetSourceInfo& source = record->mSourceInfo;
+			if ( !reader.ReadString( &source.mSourceFilePath ) || 
+				!reader.Read< u64 >( &source.mSourceFileSize ) || 
+				!reader.Read< s64 >( &source.mSourceWriteTime ) || 
+				!reader.Read< u64 >( &source.mSourceHash ) || 
+				!reader.ReadString( &source.mImportSettings ) )
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//=========================================================================================
+
+	INTERNAL bool ReadAssetHeader( const String& filePath, CacheManifestRecord* record )
+	{
+		Vector< u8 > prefix;
+
+		if ( BlockCompressedFile::IsCompressedFile( filePath ) )
+		{
+			BlockCompressedFile file;
+			if ( file.Open( filePath ) != Result::SUCCESS )
+			{
+				return false;
+			}
+
+			prefix.resize( std::min< u32 >( ENJON_ASSET_HEADER_PREFIX_SIZE, file.GetUncompressedSize( ) ) );
+			if ( file.ReadRange( 0, ( u32 )prefix.size( ), prefix.data( ) ) != Result::SUCCESS )
+			{
+				return false;
+			}
+		}
+		else
+		{
+			std::ifstream file( filePath, std::ios::in | std::ios::binary );
+			if ( !file )
+			{
+				return false;
+			}
+
+			prefix.resize( ENJON_ASSET_HEADER_PREFIX_SIZE );
+			file.read( ( char* )prefix.data( ), prefix.size( ) );
+			prefix.resize( ( usize )file.gcount( ) );
+		}
+
+		if ( ParseAssetHeader( prefix.data( ), prefix.size( ), record ) )
+		{
+			return true;
+		}
+
+		// Header did not fit in prefix ( very long names ), so fall back to reading the whole file
+		ByteBuffer buffer;
+		if ( BlockCompressedFile::ReadFile( filePath, &buffer ) != Result::SUCCESS )
+		{
+			return false;
+		}
+
+		return ParseAssetHeader( buffer.GetData( ), buffer.GetSize( ), record );
+	}
+
+	//=========================================================================================
+
+	INTERNAL void GetFileStats( const ghc::filesystem::path& path, u64* size, s64* writeTime )
+	{
+		std::error_code ec;
+		*size = ( u64 )ghc::filesystem::file_size( path, ec );
+		*writeTime = ( s64 )ghc::filesystem::last_write_time( path, ec ).time_since_epoch( ).count( );
+	}
+
+	//=========================================================================================
+
+	Result CacheRegistryManifest::ReadInIndex( HashMap< String, CacheManifestRecord >* indexed )
+	{
+		std::ifstream file( mManifestPath, std::ios::in | std::ios::binary | std::ios::ate );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		Vector< u8 > data( ( usize )file.tellg( ) );
+		file.seekg( 0, std::ios::beg );
+		file.read( ( char* )data.data( ), data.size( ) );
+
+		ManifestReader reader = { data.data( ), ( usize )file.gcount( ), 0 };
+		u32 magic = 0, version = 0, recordCount = 0;
+		if ( !reader.Read< u32 >( &magic ) || !reader.Read< u32 >( &version ) || !reader.Read< u32 >( &recordCount ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Anything written by an older version is simply rebuilt
+		if ( magic != ENJON_CACHE_MANIFEST_INDEX_MAGIC || version != ENJON_CACHE_MANIFEST_INDEX_VERSION )
+		{
+			return Result::FAILURE;
+		}
+
+		for ( u32 i = 0; i < recordCount; ++i )
+		{
+			CacheManifestRecord record;
+			String uuid, loaderName, className;
+			if ( !reader.ReadString( &uuid ) || 
+				!reader.ReadString( &record.mAssetFilePath ) || 
+				!reader.ReadString( &record.mAssetName ) || 
+				!reader.ReadString( &loaderName ) || 
+				!reader.ReadString( &className ) || 
+				!reader.Read< u64 >( &record.mFileSize ) || 
+				!reader.Read< s64 >( &record.mFileWriteTime ) || 
+				!reader.ReadString( &record.mSourceInfo.mSourceFilePath ) || 
+				!reader.Read< u64 >( &record.mSourceInfo.mSourceFileSize ) || 
+				!reader.Read< s64 >( &record.mSourceInfo.mSourceWriteTime ) || 
+				!reader.Read< u64 >( &record.mSourceInfo.mSourceHash ) || 
+				!reader.ReadString( &record.mSourceInfo.mImportSettings ) )
+			{
+				// Keep whatever was read before truncation, rest will be reparsed
+				break;
+			}
+
+			record.mAssetUUID = UUID( uuid );
+			record.mAssetLoaderClass = Object::GetClass( loaderName );
+			record.mAssetClass = Object::GetClass( className );
+
+			( *indexed )[ record.mAssetFilePath ] = record;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=========================================================================================
+
+	Result CacheRegistryManifest::ReadInPak( const PakFile* pak )
+	{
+		for ( const PakEntry& entry : pak->GetEntries( ) )
+		{
+			CacheManifestRecord record;
+			record.mAssetUUID = UUID( entry.mUUID );
+			record.mAssetFilePath = mAssetManager->GetAssetsDirectoryPath( ) + "/" + entry.mFilePath;
+			record.mAssetName = entry.mAssetName;
+			record.mAssetLoaderClass = Object::GetClass( entry.mLoaderClassName );
+			record.mAssetClass = Object::GetClass( entry.mAssetClassName );
+			record.mAssetLocationType = mAssetManager->GetAssetLocationType( );
+
+			if ( !record.mAssetLoaderClass || !record.mAssetClass )
+			{
+				continue;
+			}
+
+			// Added directly, since there are no files on disk for records to be validated against
+			mManifestRecords[ entry.mUUID ] = record;
+
+			const AssetLoader* loader = mAssetManager->GetLoader( record.mAssetLoaderClass );
+			if ( loader )
+			{
+				const_cast< AssetLoader* >( loader )->AddRecord( record );
+			}
+		}
+
+		// Archive is its own index
+		mIsDirty = false;
+
 		return Result::SUCCESS;
 	}
 
@@ -85,30 +396,53 @@ namespace Enjon
 
 	Result CacheRegistryManifest::ReadInManifest( )
 	{
+		// Mounted archive replaces cache directory entirely
+		if ( mAssetManager && mAssetManager->GetMountedPak( ) )
+		{
+			return ReadInPak( mAssetManager->GetMountedPak( ) );
+		}
+
+		// Records from last run, keyed by file path
+		HashMap< String, CacheManifestRecord > indexed;
+		bool isDirty = ( ReadInIndex( &indexed ) != Result::SUCCESS );
+
+		usize reusedCount = 0;
+
 		for ( auto& p : ghc::filesystem::recursive_directory_iterator( mAssetManager->GetAssetsDirectoryPath( ) + "/" ) )
 		{
-			if ( Enjon::AssetManager::HasAnyAssetFileExtension( p.path().string() ) )
+			String filePath = p.path( ).string( );
+			if ( Enjon::AssetManager::HasAnyAssetFileExtension( filePath ) )
 			{
 				// Asset record to fill out
 				CacheManifestRecord record; 
 
-				// Buffer to read from
-				ByteBuffer buffer( p.path( ).string( ) ); 
-
-				//==================================================
-				// Object Header 
-				//==================================================
-				const MetaClass* cls = Object::GetClass( buffer.Read< String >( ) );	// Read class type
-				u32 versionNumber = buffer.Read< u32 >( );								// Read version number id 
+				// Stat only, file contents are not touched unless the index is out of date
+				u64 fileSize = 0;
+				s64 fileWriteTime = 0;
+				GetFileStats( p.path( ), &fileSize, &fileWriteTime );
+
+				auto query = indexed.find( filePath );
+				if ( query != indexed.end( ) && 
+					query->second.mFileSize == fileSize && 
+					query->second.mFileWriteTime == fileWriteTime && 
+					query->second.mAssetClass && 
+					query->second.mAssetLoaderClass )
+				{
+					record = query->second;
+					reusedCount++;
+				}
+				else
+				{
+					if ( !ReadAssetHeader( filePath, &record ) )
+					{
+						continue;
+					}
 
-				//==================================================
-				// Asset Header 
-				//================================================== 
-				record.mAssetUUID = buffer.Read< UUID >();									// UUID of asset
-				record.mAssetName = buffer.Read< String >();								// Asset name
-				record.mAssetLoaderClass = Object::GetClass( buffer.Read< String >( ) );	// Loader class
-				record.mAssetFilePath = p.path( ).string( );								// Asset file path 
-				record.mAssetClass = cls;													// Assset class
+					record.mAssetFilePath = filePath;				// Asset file path 
+					record.mFileSize = fileSize;
+					record.mFileWriteTime = fileWriteTime;
+					isDirty = true;
+				}
 
 				// Set location type of record
 				record.mAssetLocationType = mAssetManager->GetAssetLocationType( );
@@ -130,52 +464,16 @@ namespace Enjon
 			} 
 		}
 
-		return Result::SUCCESS;
+		// Files removed since index was written drop out of it
+		if ( reusedCount != indexed.size( ) )
+		{
+			isDirty = true;
+		}
+
+		// Only rewrite index if something actually changed on disk
+		mIsDirty = isDirty;
 
-		//// Create read buffer from manifest path
-		//ByteBuffer buffer( mManifestPath );
-
-		//// If the buffer was created successfully, then parse
-		//if ( buffer.GetStatus( ) == BufferStatus::ReadyToRead )
-		//{
-		//	// Grab record count
-		//	u32 recordCount = buffer.Read< u32 >();
-
-		//	// For each record, store into manifest 
-		//	for ( u32 i = 0; i < recordCount; ++i )
-		//	{
-		//		// Asset record to fill out
-		//		CacheManifestRecord record; 
-		//		
-		//		// Load into record
-		//		record.mAssetUUID = buffer.Read< UUID >();
-		//		record.mAssetFilePath = buffer.Read< String >();
-		//		record.mAssetName = buffer.Read< String >( );
-
-		//		// Get MetaClass for loader
-		//		const MetaClass* cls = Object::GetClass( buffer.Read< String >() );
-		//		record.mAssetLoaderClass = cls;
-
-		//		// Add record
-		//		AddRecord( record );
-
-		//		if ( mAssetManager )
-		//		{
-		//			// At this point, should I pass on the record to the loader class? 
-		//			const AssetLoader* loader = mAssetManager->GetLoader( cls );
-
-		//			if ( loader )
-		//			{
-		//				// Add record to loader
-		//				const_cast< AssetLoader* >( loader )->AddRecord( record ); 
-		//			} 
-		//		}
-		//	} 
-
-		//	return Result::SUCCESS;
-		//} 
-
-		//return Result::FAILURE; 
+		return Flush( );
 	}
 
 	//=========================================================================================
@@ -192,11 +490,40 @@ namespace Enjon
 		if ( !HasRecord( record.mAssetUUID ) )
 		{
 			mManifestRecords[record.mAssetUUID.ToString()] = record;
+			mIsDirty = true;
+
+			// Records added for newly written assets need file stats to be validated on next read
+			CacheManifestRecord& added = mManifestRecords[record.mAssetUUID.ToString()];
+			if ( !added.mFileWriteTime && ghc::filesystem::exists( added.mAssetFilePath ) )
+			{
+				GetFileStats( added.mAssetFilePath, &added.mFileSize, &added.mFileWriteTime );
+			}
 
 			return Result::SUCCESS;
 		}
 
 		return Result::FAILURE;
 	}
-}
 
+	//=========================================================================================
+
+	Result CacheRegistryManifest::UpdateRecord( const CacheManifestRecord& record )
+	{
+		auto query = mManifestRecords.find( record.mAssetUUID.ToString( ) );
+		if ( query == mManifestRecords.end( ) )
+		{
+			return AddRecord( record );
+		}
+
+		// Keep location of existing record, only its contents have changed
+		AssetLocationType locationType = query->second.mAssetLocationType;
+		query->second = record;
+		query->second.mAssetLocationType = locationType;
+		GetFileStats( query->second.mAssetFilePath, &query->second.mFileSize, &query->second.mFileWriteTime );
+		mIsDirty = true;
+
+		return Result::SUCCESS;
+	}
+
+	//=========================================================================================
+}
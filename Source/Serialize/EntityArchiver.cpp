@@ -3,11 +3,15 @@
 
 #include "Asset/AssetManager.h"
 #include "Serialize/EntityArchiver.h"
+#include "Serialize/BaseTypeSerializeMethods.h"
 #include "SubsystemCatalog.h"
 #include "Base/World.h" 
 #include "Engine.h"
 #include "SubsystemCatalog.h"
 
+// Set in the size written ahead of component data when it's in the default property layout, so it can be decoded without the component
+#define ENJON_COMPONENT_DEFAULT_DATA_FLAG	0x80000000
+
 namespace Enjon
 {
 	//=========================================================================================
@@ -20,7 +24,7 @@ namespace Enjon
 
 	//==========================================================================
 
-	Result EntityArchiver::Serialize( const EntityHandle& entity, ByteBuffer* buffer )
+	Result EntityArchiver::Serialize( const EntityHandle& entity, ByteBuffer* buffer, EntitySerializeMode mode )
 	{ 
 		if ( !buffer )
 		{
@@ -30,12 +34,18 @@ namespace Enjon
 		// Write that entity was null for deserializing later on
 		if ( !entity.Get( ) )
 		{
-			buffer->Write< u32 >( 0 );
+			buffer->Write< u32 >( (u32)EntityRecordType::Null );
 			return Result::FAILURE;
 		}
 
+		// Archetype instances only need to write what differs from their prototype
+		if ( mode == EntitySerializeMode::OverridesOnly && CanSerializeOverrides( entity ) )
+		{
+			return SerializeOverrides( entity, buffer );
+		}
+
 		// Write that entity was alive and serialized
-		buffer->Write< u32 >( 1 );
+		buffer->Write< u32 >( (u32)EntityRecordType::Full );
 
 		//==========================================================================
 		// Local Transform
@@ -101,11 +111,13 @@ namespace Enjon
 			// Need to write out specific data regarding the component, namely how much size there is so that I can 
 			// skip the data in the buffer
 			ByteBuffer temp; 
+			u32 defaultDataFlag = 0;
 			if ( c->SerializeData( &temp ) == Result::INCOMPLETE )
 			{
 				SerializeObjectDataDefault( c, compCls, &temp );
+				defaultDataFlag = ENJON_COMPONENT_DEFAULT_DATA_FLAG;
 			}
-			buffer->Write< u32 >( temp.GetSize( ) );
+			buffer->Write< u32 >( temp.GetSize( ) | defaultDataFlag );
 
 			// Serialize component data
 			Result res = c->SerializeData( buffer );
@@ -127,7 +139,7 @@ namespace Enjon
 		// Serialize all children into buffer
 		for ( auto& c : children )
 		{
-			Serialize( c, buffer );
+			Serialize( c, buffer, mode );
 		}
 
 		// Serialize entity default ( remaining unserialized properties )
@@ -165,15 +177,21 @@ namespace Enjon
 	EntityHandle EntityArchiver::Deserialize( ByteBuffer* buffer )
 	{
 		// Read status of entity from buffer
-		u32 entityStatus = buffer->Read< u32 >( );
+		EntityRecordType entityStatus = ( EntityRecordType )buffer->Read< u32 >( );
 
 		// If entity wasn't alive, then it wasn't serialized
-		if ( !entityStatus )
+		if ( entityStatus == EntityRecordType::Null )
 		{
 			// Return empty entity handle
 			return EntityHandle();
 		}
 
+		// Instanced from prototype with only overrides recorded
+		if ( entityStatus == EntityRecordType::Overrides )
+		{
+			return DeserializeOverrides( buffer, Engine::GetInstance( )->GetWorld( ) );
+		}
+
 		// Get entity manager from engine
 		EntityManager* entities = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< EntityManager >( )->ConstCast< EntityManager >( );
 
@@ -190,15 +208,21 @@ namespace Enjon
 	EntityHandle EntityArchiver::Deserialize( ByteBuffer* buffer, World* world, bool isInstanced )
 	{
 		// Read status of entity from buffer
-		u32 entityStatus = buffer->Read< u32 >( );
+		EntityRecordType entityStatus = ( EntityRecordType )buffer->Read< u32 >( );
 
 		// If entity wasn't alive, then it wasn't serialized
-		if ( !entityStatus )
+		if ( entityStatus == EntityRecordType::Null )
 		{
 			// Return empty entity handle
 			return EntityHandle();
 		}
 
+		// Instanced from prototype with only overrides recorded
+		if ( entityStatus == EntityRecordType::Overrides )
+		{
+			return DeserializeOverrides( buffer, world );
+		}
+
 		// Get entity manager from engine
 		EntityManager* entities = Engine::GetInstance( )->GetSubsystemCatalog( )->Get< EntityManager >( )->ConstCast< EntityManager >( );
 
@@ -304,7 +328,7 @@ namespace Enjon
 			// Get component's meta class
 			const MetaClass* cmpCls = Object::GetClass( buffer->Read< String >( ) );
 
-			u32 compWriteSize = buffer->Read< u32 >( );
+			u32 compWriteSize = buffer->Read< u32 >( ) & ~ENJON_COMPONENT_DEFAULT_DATA_FLAG;
 
 			if ( cmpCls )
 			{
@@ -372,6 +396,1074 @@ namespace Enjon
 	}
 
 	//========================================================================================= 
+
+	bool EntityArchiver::CanSerializeOverrides( const EntityHandle& entity )
+	{
+		Entity* ent = entity.Get( );
+		if ( !ent || !ent->HasPrototypeEntity( ) || !ent->GetArchetype( ) )
+		{
+			return false;
+		}
+
+		// Prototype has to live in the archetype world, otherwise it might not exist yet when this record is read back in
+		return ( ent->GetPrototypeEntity( ).Get( )->GetWorld( ) == EngineSubsystem( EntityManager )->GetArchetypeWorld( ) );
+	}
+
+	//========================================================================================= 
+
+	Result EntityArchiver::SerializeOverrides( const EntityHandle& entity, ByteBuffer* buffer )
+	{
+		Entity* ent = entity.Get( );
+		Entity* proto = ent->GetPrototypeEntity( ).Get( );
+
+		// Record is written to a temp buffer first so its size can lead it. Allows skipping the record if prototype can't be resolved.
+		ByteBuffer record;
+
+		// Write out prototype and archetype uuids
+		record.Write< UUID >( proto->GetUUID( ) );
+		record.Write< UUID >( ent->GetArchetype( ).GetUUID( ) );
+
+		// Write out entity UUID and name
+		record.Write< UUID >( ent->GetUUID( ) );
+		record.Write< String >( ent->GetName( ) );
+
+		//==========================================================================
+		// Local Transform
+		//========================================================================== 
+
+		Transform local = ent->GetLocalTransform( );
+
+		// Write out position
+		record.Write< f32 >( local.GetPosition().x );
+		record.Write< f32 >( local.GetPosition().y );
+		record.Write< f32 >( local.GetPosition().z );
+
+		// Write out rotation
+		record.Write< f32 >( local.GetRotation().x );
+		record.Write< f32 >( local.GetRotation().y );
+		record.Write< f32 >( local.GetRotation().z );
+		record.Write< f32 >( local.GetRotation().w );
+
+		// Write out scale
+		record.Write< f32 >( local.GetScale().x );
+		record.Write< f32 >( local.GetScale().y );
+		record.Write< f32 >( local.GetScale().z );
+
+		//==========================================================================
+		// Components
+		//========================================================================== 
+
+		ByteBuffer compRecords;
+		u32 compRecordCount = 0;
+
+		for ( auto& c : ent->GetComponents( ) )
+		{
+			const MetaClass* compCls = c->Class( );
+			Component* protoComp = proto->GetComponent( compCls );
+
+			ByteBuffer data;
+			EntityRecordType recordType = EntityRecordType::Full;
+			u32 defaultDataFlag = 0;
+
+			// Component was added to this instance, so write it in full
+			if ( !protoComp )
+			{
+				if ( c->SerializeData( &data ) == Result::INCOMPLETE )
+				{
+					SerializeObjectDataDefault( c, compCls, &data );
+					defaultDataFlag = ENJON_COMPONENT_DEFAULT_DATA_FLAG;
+				}
+			}
+			// Default serialized components only write overridden properties
+			else if ( c->SerializeData( &data ) == Result::INCOMPLETE )
+			{
+				if ( SerializePropertyOverrides( c, protoComp, &data ) == 0 )
+				{
+					continue;
+				}
+
+				recordType = EntityRecordType::Overrides;
+			}
+			// Custom serialized components can't be diffed per property, so only write if their data differs from the prototype
+			else
+			{
+				ByteBuffer protoData;
+				protoComp->SerializeData( &protoData );
+				if ( ByteBuffer::ContentsEqual( data, protoData ) )
+				{
+					continue;
+				}
+			}
+
+			compRecords.Write< String >( compCls->GetName( ) );
+			compRecords.Write< u32 >( (u32)recordType );
+			compRecords.Write< u32 >( data.GetSize( ) | defaultDataFlag );
+			compRecords.AppendBuffer( data );
+			compRecordCount++;
+		}
+
+		// Write out component records
+		record.Write< u32 >( compRecordCount );
+		record.AppendBuffer( compRecords );
+
+		// Write out prototype components removed from this instance, otherwise instancing would bring them back
+		Vector< String > removedComps;
+		for ( auto& c : proto->GetComponents( ) )
+		{
+			if ( !ent->HasComponent( c->Class( ) ) )
+			{
+				removedComps.push_back( c->Class( )->GetName( ) );
+			}
+		}
+
+		record.Write< u32 >( ( u32 )removedComps.size( ) );
+		for ( auto& name : removedComps )
+		{
+			record.Write< String >( name );
+		}
+
+		//================================================================================
+		// Entity Children
+		//================================================================================
+
+		const Vector< EntityHandle >& children = ent->GetChildren( );
+
+		// Write out number of children 
+		record.Write< u32 >( ( u32 )children.size( ) );
+
+		// Children instanced from the prototype's children will write overrides as well
+		for ( auto& c : children )
+		{
+			Serialize( c, &record, EntitySerializeMode::OverridesOnly );
+		}
+
+		// Write out prototype's children removed from this instance
+		Vector< UUID > removedChildren;
+		for ( auto& pc : proto->GetChildren( ) )
+		{
+			bool found = false;
+			for ( auto& c : children )
+			{
+				if ( c.Get( )->HasPrototypeEntity( ) && c.Get( )->GetPrototypeEntity( ).Get( ) == pc.Get( ) )
+				{
+					found = true;
+					break;
+				}
+			}
+
+			if ( !found )
+			{
+				removedChildren.push_back( pc.Get( )->GetUUID( ) );
+			}
+		}
+
+		record.Write< u32 >( ( u32 )removedChildren.size( ) );
+		for ( auto& id : removedChildren )
+		{
+			record.Write< UUID >( id );
+		}
+
+		// Serialize entity overrides ( remaining unserialized properties )
+		SerializePropertyOverrides( ent, proto, &record );
+
+		// Write out tag, size and then the record
+		buffer->Write< u32 >( (u32)EntityRecordType::Overrides );
+		buffer->Write< u32 >( record.GetSize( ) );
+		buffer->AppendBuffer( record );
+
+		return Result::SUCCESS;
+	}
+
+	//========================================================================================= 
+
+	u32 EntityArchiver::SerializePropertyOverrides( const Object* object, const Object* source, ByteBuffer* buffer )
+	{
+		const MetaClass* cls = object->Class( );
+
+		ByteBuffer props;
+		u32 count = 0;
+
+		for ( u32 i = 0; i < cls->GetPropertyCount( ); ++i )
+		{
+			const MetaProperty* prop = cls->GetProperty( i );
+
+			// Do not serialize if property is null or non-serializable
+			if ( !prop || prop->HasFlags( MetaPropertyFlags::NonSerializeable ) )
+			{
+				continue;
+			}
+
+			// Recorded overrides are always written. Otherwise compare serialized values, since not all property types have overrides recorded.
+			if ( !prop->HasOverride( object ) )
+			{
+				ByteBuffer objectVal, sourceVal;
+				PropertyArchiver::Serialize( object, prop, &objectVal );
+				PropertyArchiver::Serialize( source, prop, &sourceVal );
+				if ( ByteBuffer::ContentsEqual( objectVal, sourceVal ) )
+				{
+					continue;
+				}
+			}
+
+			PropertyArchiver::Serialize( object, prop, &props );
+			count++;
+		}
+
+		// Same layout as SerializeObjectDataDefault, so DeserializeObjectDataDefault can read it back
+		buffer->Write< u32 >( count );
+		buffer->AppendBuffer( props );
+
+		return count;
+	}
+
+	//========================================================================================= 
+
+	EntityHandle EntityArchiver::DeserializeOverrides( ByteBuffer* buffer, World* world )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+		AssetManager* am = EngineSubsystem( AssetManager );
+
+		// Read size of record and prototype information
+		u32 recordSize = buffer->Read< u32 >( );
+		u32 recordStart = buffer->GetReadPosition( );
+		UUID prototypeID = buffer->Read< UUID >( );
+		UUID archetypeID = buffer->Read< UUID >( );
+
+		// Loading the archetype brings its prototype entities into the archetype world
+		AssetHandle< Archetype > archetype = am->GetAsset< Archetype >( archetypeID );
+		EntityHandle proto = em->GetEntityByUUID( prototypeID );
+
+		// Can't resolve prototype, so skip the remainder of the record
+		if ( !proto )
+		{
+			buffer->AdvanceReadPosition( recordSize - ( buffer->GetReadPosition( ) - recordStart ) );
+			return EntityHandle( );
+		}
+
+		// Clone prototype and apply recorded overrides on top of it
+		EntityHandle handle = em->InstanceEntity( proto, world );
+		Entity* ent = handle.Get( );
+		ent->SetArchetype( archetype );
+		ApplyOverrides( ent, buffer, world );
+
+		// Record overrides against prototype so they're tracked the same as a fully deserialized instance
+		ObjectArchiver::ClearAllPropertyOverrides( ent );
+		ObjectArchiver::RecordAllPropertyOverrides( proto.Get( ), ent );
+
+		return handle;
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::ApplyOverrides( Entity* ent, ByteBuffer* buffer, World* world )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+
+		// Replace instanced UUID with the one recorded
+		em->RemoveFromUUIDMap( ent );
+		ent->SetUUID( buffer->Read< UUID >( ) );
+
+		// Read in name
+		ent->SetName( buffer->Read< String >( ) );
+
+		//==========================================================================
+		// Local Transform
+		//========================================================================== 
+
+		Transform local;
+
+		// Read in position
+		Vec3 position; 
+		position.x = buffer->Read< f32 >( );
+		position.y = buffer->Read< f32 >( );
+		position.z = buffer->Read< f32 >( ); 
+		local.SetPosition( position );
+
+		// Read in rotation
+		Quaternion rotation;
+		rotation.x = buffer->Read< f32 >( );
+		rotation.y = buffer->Read< f32 >( );
+		rotation.z = buffer->Read< f32 >( );
+		rotation.w = buffer->Read< f32 >( );
+		local.SetRotation( rotation );
+
+		// Read in scale
+		Vec3 scale;
+		scale.x = buffer->Read< f32 >( );
+		scale.y = buffer->Read< f32 >( );
+		scale.z = buffer->Read< f32 >( );
+		local.SetScale( scale );
+
+		ent->SetLocalTransform( local );
+
+		//=================================================================
+		// Components
+		//=================================================================
+
+		u32 numComps = buffer->Read< u32 >( );
+
+		for ( u32 i = 0; i < numComps; ++i )
+		{
+			const MetaClass* cmpCls = Object::GetClass( buffer->Read< String >( ) );
+			EntityRecordType recordType = ( EntityRecordType )buffer->Read< u32 >( );
+			u32 compWriteSize = buffer->Read< u32 >( ) & ~ENJON_COMPONENT_DEFAULT_DATA_FLAG;
+
+			// Instanced components already hold prototype values, so only add if missing
+			Component* cmp = cmpCls ? ( ent->HasComponent( cmpCls ) ? ent->GetComponent( cmpCls ) : ent->AddComponent( cmpCls ) ) : nullptr;
+			if ( !cmp )
+			{
+				buffer->AdvanceReadPosition( compWriteSize );
+				continue;
+			}
+
+			if ( recordType == EntityRecordType::Overrides )
+			{
+				DeserializeObjectDataDefault( cmp, cmpCls, buffer );
+			}
+			else if ( cmp->DeserializeData( buffer ) == Result::INCOMPLETE )
+			{
+				DeserializeObjectDataDefault( cmp, cmpCls, buffer );
+			}
+
+			// Deserialize late init 
+			cmp->DeserializeLateInit( );
+		}
+
+		// Remove prototype components that were removed from the instance
+		u32 numRemovedComps = buffer->Read< u32 >( );
+		for ( u32 i = 0; i < numRemovedComps; ++i )
+		{
+			const MetaClass* cmpCls = Object::GetClass( buffer->Read< String >( ) );
+			if ( cmpCls && ent->HasComponent( cmpCls ) )
+			{
+				ent->RemoveComponent( cmpCls );
+			}
+		}
+
+		//=================================================================
+		// Entity Children
+		//=================================================================
+
+		u32 numChildren = buffer->Read< u32 >( );
+
+		for ( u32 i = 0; i < numChildren; ++i )
+		{
+			EntityRecordType childType = ( EntityRecordType )buffer->Read< u32 >( );
+
+			switch ( childType )
+			{
+				default:
+				case EntityRecordType::Null: break;
+
+				// Child not from the prototype, so allocate and deserialize as usual
+				case EntityRecordType::Full:
+				{
+					EntityHandle child = em->Allocate( world );
+					DeserializeInternal( child, buffer, world );
+					if ( child.Get( ) )
+					{
+						Transform localTrans = child.Get( )->GetLocalTransform( );
+						ent->AddChild( child );
+						child.Get( )->SetLocalTransform( localTrans );
+					}
+				} break;
+
+				// Child instanced from one of the prototype's children
+				case EntityRecordType::Overrides:
+				{
+					u32 recordSize = buffer->Read< u32 >( );
+					u32 recordStart = buffer->GetReadPosition( );
+					UUID prototypeID = buffer->Read< UUID >( );
+					AssetHandle< Archetype > archetype = EngineSubsystem( AssetManager )->GetAsset< Archetype >( buffer->Read< UUID >( ) );
+
+					// Find the child that was already instanced alongside this entity
+					Entity* target = nullptr;
+					for ( auto& c : ent->GetChildren( ) )
+					{
+						if ( c.Get( )->HasPrototypeEntity( ) && c.Get( )->GetPrototypeEntity( ).Get( )->GetUUID( ) == prototypeID )
+						{
+							target = c.Get( );
+							break;
+						}
+					}
+
+					// Not found in the instanced hierarchy, so instance prototype directly if it still exists
+					if ( !target )
+					{
+						EntityHandle proto = em->GetEntityByUUID( prototypeID );
+						if ( !proto )
+						{
+							buffer->AdvanceReadPosition( recordSize - ( buffer->GetReadPosition( ) - recordStart ) );
+							break;
+						}
+
+						EntityHandle child = em->InstanceEntity( proto, world );
+						ent->AddChild( child );
+						target = child.Get( );
+					}
+
+					target->SetArchetype( archetype );
+					ApplyOverrides( target, buffer, world );
+				} break;
+			}
+		}
+
+		// Destroy children instanced from prototype children that were removed from the instance
+		u32 numRemovedChildren = buffer->Read< u32 >( );
+		for ( u32 i = 0; i < numRemovedChildren; ++i )
+		{
+			UUID prototypeID = buffer->Read< UUID >( );
+			for ( auto& c : ent->GetChildren( ) )
+			{
+				if ( c.Get( )->HasPrototypeEntity( ) && c.Get( )->GetPrototypeEntity( ).Get( )->GetUUID( ) == prototypeID )
+				{
+					ent->DetachChild( c );
+					c.Get( )->Destroy( );
+					break;
+				}
+			}
+		}
+
+		// Deserialize entity overrides
+		DeserializeObjectDataDefault( ent, ent->Class( ), buffer );
+	}
+
+	//========================================================================================= 
+
+	INTERNAL void GatherAssetReferences( const MetaProperty* prop, ByteBuffer* buffer, Vector< AssetDependency >* out )
+	{
+		switch ( prop->GetType( ) )
+		{
+			default: break;
+
+			case MetaPropertyType::AssetHandle:
+			{
+				AssetDependency dep;
+				dep.mAssetClass = prop->Cast< MetaPropertyTemplateBase >( )->GetClassOfTemplatedArgument( );
+				dep.mAssetUUID = buffer->Read< UUID >( );
+				out->push_back( dep );
+			} break;
+
+			case MetaPropertyType::Array:
+			{
+				const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+				if ( base->GetArrayType( ) != MetaPropertyType::AssetHandle )
+				{
+					break;
+				}
+
+				MetaArrayPropertyProxy proxy = base->GetProxy( );
+				const MetaClass* assetCls = static_cast< const MetaPropertyTemplateBase* >( proxy.mArrayPropertyTypeBase )->GetClassOfTemplatedArgument( );
+
+				u32 arraySize = buffer->Read< u32 >( );
+				for ( u32 i = 0; i < arraySize; ++i )
+				{
+					AssetDependency dep;
+					dep.mAssetClass = assetCls;
+					dep.mAssetUUID = buffer->Read< UUID >( );
+					out->push_back( dep );
+				}
+			} break;
+		}
+	}
+
+	//========================================================================================= 
+
+	INTERNAL void StageProperties( const MetaClass* cls, ByteBuffer* buffer, Vector< StagedProperty >* out, Vector< AssetDependency >* assets )
+	{
+		// Same layout as SerializeObjectDataDefault
+		u32 propCount = buffer->Read< u32 >( );
+		out->reserve( out->size( ) + propCount );
+
+		for ( u32 i = 0; i < propCount; ++i )
+		{
+			String name = buffer->Read< String >( );
+			MetaPropertyType propType = ( MetaPropertyType )buffer->Read< s32 >( );
+			u32 propSize = buffer->Read< u32 >( );
+			u32 dataOffset = buffer->GetReadPosition( );
+
+			// Properties no longer on the class, or whose type changed, are dropped here rather than at commit
+			const MetaProperty* prop = cls ? cls->GetPropertyByName( name ) : nullptr;
+			if ( prop && prop->GetType( ) == propType )
+			{
+				StagedProperty staged;
+				staged.mProperty = prop;
+				staged.mDataOffset = dataOffset;
+				out->push_back( staged );
+
+				GatherAssetReferences( prop, buffer, assets );
+			}
+
+			buffer->SetReadPosition( dataOffset + propSize );
+		}
+	}
+
+	//========================================================================================= 
+
+	INTERNAL void StageComponent( StagedComponent* staged, const MetaClass* cls, u32 dataSize, bool isDefaultData, ByteBuffer* buffer, Vector< AssetDependency >* assets )
+	{
+		staged->mClass = cls;
+		staged->mIsDefaultData = isDefaultData;
+		staged->mDataSize = dataSize;
+		staged->mDataOffset = buffer->GetReadPosition( );
+
+		if ( cls && isDefaultData )
+		{
+			StageProperties( cls, buffer, &staged->mProperties, assets );
+		}
+
+		buffer->SetReadPosition( staged->mDataOffset + dataSize );
+	}
+
+	//========================================================================================= 
+
+	INTERNAL Transform ReadLocalTransform( ByteBuffer* buffer )
+	{
+		Vec3 position, scale;
+		Quaternion rotation;
+		position.x = buffer->Read< f32 >( );
+		position.y = buffer->Read< f32 >( );
+		position.z = buffer->Read< f32 >( ); 
+		rotation.x = buffer->Read< f32 >( );
+		rotation.y = buffer->Read< f32 >( );
+		rotation.z = buffer->Read< f32 >( );
+		rotation.w = buffer->Read< f32 >( );
+		scale.x = buffer->Read< f32 >( );
+		scale.y = buffer->Read< f32 >( );
+		scale.z = buffer->Read< f32 >( );
+
+		Transform local;
+		local.SetPosition( position );
+		local.SetRotation( rotation );
+		local.SetScale( scale );
+		return local;
+	}
+
+	//========================================================================================= 
+
+	INTERNAL void CommitStagedProperties( const Object* object, const Vector< StagedProperty >& properties, ByteBuffer* buffer )
+	{
+		for ( auto& p : properties )
+		{
+			buffer->SetReadPosition( p.mDataOffset );
+			PropertyArchiver::DeserializeValue( object, p.mProperty, buffer );
+		}
+	}
+
+	//========================================================================================= 
+
+	INTERNAL void CommitStagedComponent( Component* cmp, const StagedComponent& staged, ByteBuffer* buffer )
+	{
+		if ( staged.mIsDefaultData )
+		{
+			CommitStagedProperties( cmp, staged.mProperties, buffer );
+		}
+		else
+		{
+			buffer->SetReadPosition( staged.mDataOffset );
+			if ( cmp->DeserializeData( buffer ) == Result::INCOMPLETE )
+			{
+				ObjectArchiver::DeserializeObjectDataDefault( cmp, staged.mClass, buffer );
+			}
+		}
+
+		cmp->DeserializeLateInit( );
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::Stage( ByteBuffer* buffer, StagedEntity* staged )
+	{
+		// Read status of entity from buffer
+		staged->mRecordType = ( EntityRecordType )buffer->Read< u32 >( );
+
+		switch ( staged->mRecordType )
+		{
+			default:
+			case EntityRecordType::Null: 
+			{
+				staged->mRecordType = EntityRecordType::Null;
+			} break;
+
+			case EntityRecordType::Overrides:
+			{
+				u32 recordSize = buffer->Read< u32 >( );
+				u32 recordStart = buffer->GetReadPosition( );
+
+				// Read in prototype, archetype, uuid, name and local transform
+				staged->mPrototype = buffer->Read< UUID >( );
+				staged->mArchetype = buffer->Read< UUID >( );
+				staged->mUUID = buffer->Read< UUID >( );
+				staged->mName = buffer->Read< String >( );
+				staged->mLocalTransform = ReadLocalTransform( buffer );
+
+				// Components changed or added on this instance
+				u32 numComps = buffer->Read< u32 >( );
+				staged->mComponents.resize( numComps );
+				for ( auto& c : staged->mComponents )
+				{
+					const MetaClass* cls = Object::GetClass( buffer->Read< String >( ) );
+					EntityRecordType recordType = ( EntityRecordType )buffer->Read< u32 >( );
+					u32 dataSize = buffer->Read< u32 >( );
+					bool isDefaultData = recordType == EntityRecordType::Overrides || ( dataSize & ENJON_COMPONENT_DEFAULT_DATA_FLAG );
+					StageComponent( &c, cls, dataSize & ~ENJON_COMPONENT_DEFAULT_DATA_FLAG, isDefaultData, buffer, &staged->mAssets );
+				}
+
+				// Prototype components removed from this instance
+				u32 numRemovedComps = buffer->Read< u32 >( );
+				for ( u32 i = 0; i < numRemovedComps; ++i )
+				{
+					const MetaClass* cls = Object::GetClass( buffer->Read< String >( ) );
+					if ( cls )
+					{
+						staged->mRemovedComponents.push_back( cls );
+					}
+				}
+
+				// Stage all children
+				u32 numChildren = buffer->Read< u32 >( );
+				staged->mChildren.resize( numChildren );
+				for ( auto& c : staged->mChildren )
+				{
+					Stage( buffer, &c );
+				}
+
+				// Prototype children removed from this instance
+				u32 numRemovedChildren = buffer->Read< u32 >( );
+				staged->mRemovedChildren.reserve( numRemovedChildren );
+				for ( u32 i = 0; i < numRemovedChildren; ++i )
+				{
+					staged->mRemovedChildren.push_back( buffer->Read< UUID >( ) );
+				}
+
+				// Entity property overrides
+				StageProperties( Object::GetClass< Entity >( ), buffer, &staged->mProperties, &staged->mAssets );
+
+				buffer->SetReadPosition( recordStart + recordSize );
+			} break;
+
+			case EntityRecordType::Full:
+			{
+				staged->mLocalTransform = ReadLocalTransform( buffer );
+
+				// Read in uuid, name, archetype and prototype
+				staged->mUUID = buffer->Read< UUID >( );
+				staged->mName = buffer->Read< String >( );
+				staged->mArchetype = buffer->Read< UUID >( );
+				staged->mPrototype = buffer->Read< UUID >( );
+
+				// Read in instanced entities
+				u32 entityInstanceSize = buffer->Read< u32 >( );
+				staged->mInstancedEntities.reserve( entityInstanceSize );
+				for ( u32 i = 0; i < entityInstanceSize; ++i )
+				{
+					staged->mInstancedEntities.push_back( buffer->Read< UUID >( ) );
+				}
+
+				// Components
+				u32 numComps = buffer->Read< u32 >( );
+				staged->mComponents.resize( numComps );
+				for ( auto& c : staged->mComponents )
+				{
+					const MetaClass* cls = Object::GetClass( buffer->Read< String >( ) );
+					u32 dataSize = buffer->Read< u32 >( );
+					StageComponent( &c, cls, dataSize & ~ENJON_COMPONENT_DEFAULT_DATA_FLAG, ( dataSize & ENJON_COMPONENT_DEFAULT_DATA_FLAG ) != 0, buffer, &staged->mAssets );
+				}
+
+				// Stage all children
+				u32 numChildren = buffer->Read< u32 >( );
+				staged->mChildren.resize( numChildren );
+				for ( auto& c : staged->mChildren )
+				{
+					Stage( buffer, &c );
+				}
+
+				// Default object data
+				StageProperties( Object::GetClass< Entity >( ), buffer, &staged->mProperties, &staged->mAssets );
+			} break;
+		}
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::GetStagedArchetypes( const StagedEntity& staged, HashSet< String >& out )
+	{
+		if ( staged.mRecordType == EntityRecordType::Null )
+		{
+			return;
+		}
+
+		if ( staged.mArchetype )
+		{
+			out.insert( staged.mArchetype.ToString( ) );
+		}
+
+		for ( auto& c : staged.mChildren )
+		{
+			GetStagedArchetypes( c, out );
+		}
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::GetStagedAssets( const StagedEntity& staged, Vector< AssetDependency >& out )
+	{
+		out.insert( out.end( ), staged.mAssets.begin( ), staged.mAssets.end( ) );
+
+		for ( auto& c : staged.mChildren )
+		{
+			GetStagedAssets( c, out );
+		}
+	}
+
+	//========================================================================================= 
+
+	INTERNAL void CountStaged( const StagedEntity& staged, u32* entityCount, HashMap< const MetaClass*, u32 >* componentCounts )
+	{
+		if ( staged.mRecordType == EntityRecordType::Null )
+		{
+			return;
+		}
+
+		// Overrides records are instanced from their prototype, so only their components can be reserved for
+		if ( staged.mRecordType == EntityRecordType::Full )
+		{
+			( *entityCount )++;
+		}
+
+		for ( auto& c : staged.mComponents )
+		{
+			if ( c.mClass )
+			{
+				( *componentCounts )[ c.mClass ]++;
+			}
+		}
+
+		for ( auto& c : staged.mChildren )
+		{
+			CountStaged( c, entityCount, componentCounts );
+		}
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::AllocateStaged( const Vector< StagedEntity >& staged, World* world, StagedAllocation* allocation )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+
+		u32 entityCount = 0;
+		HashMap< const MetaClass*, u32 > componentCounts;
+		for ( auto& s : staged )
+		{
+			CountStaged( s, &entityCount, &componentCounts );
+		}
+
+		em->Allocate( entityCount, &allocation->mEntities, world );
+		em->ReserveComponents( componentCounts );
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::ReleaseStaged( StagedAllocation* allocation )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+		for ( u32 i = allocation->mNext; i < ( u32 )allocation->mEntities.size( ); ++i )
+		{
+			em->Destroy( allocation->mEntities[ i ] );
+		}
+
+		allocation->mEntities.clear( );
+		allocation->mNext = 0;
+	}
+
+	//========================================================================================= 
+
+	EntityHandle EntityArchiver::CommitStaged( const StagedEntity& staged, ByteBuffer* buffer, World* world, StagedAllocation* allocation )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+		AssetManager* am = EngineSubsystem( AssetManager );
+
+		switch ( staged.mRecordType )
+		{
+			default:
+			case EntityRecordType::Null: return EntityHandle( );
+
+			case EntityRecordType::Overrides:
+			{
+				// Prototype can't be resolved, so record is dropped
+				EntityHandle proto = em->GetEntityByUUID( staged.mPrototype );
+				if ( !proto )
+				{
+					return EntityHandle( );
+				}
+
+				// Clone prototype and apply staged overrides on top of it
+				EntityHandle handle = em->InstanceEntity( proto, world );
+				Entity* ent = handle.Get( );
+				ent->SetArchetype( am->GetAsset< Archetype >( staged.mArchetype ) );
+				CommitStagedOverrides( ent, staged, buffer, world, allocation );
+
+				// Record overrides against prototype so they're tracked the same as a fully deserialized instance
+				ObjectArchiver::ClearAllPropertyOverrides( ent );
+				ObjectArchiver::RecordAllPropertyOverrides( proto.Get( ), ent );
+
+				return handle;
+			} 
+
+			case EntityRecordType::Full: break;
+		}
+
+		bool allocated = allocation && allocation->mNext < ( u32 )allocation->mEntities.size( );
+		EntityHandle handle = allocated ? allocation->mEntities[ allocation->mNext++ ] : em->Allocate( world );
+		Entity* ent = handle.Get( );
+
+		// Set the transform of the entity
+		ent->SetLocalTransform( staged.mLocalTransform );
+
+		// Remove from uuid map before setting uuid
+		em->RemoveFromUUIDMap( ent );
+		ent->SetUUID( staged.mUUID );
+		ent->SetName( staged.mName );
+
+		// Set archetype and prototype
+		ent->SetArchetype( am->GetAsset< Archetype >( staged.mArchetype ) );
+		ent->SetPrototypeEntity( em->GetEntityByUUID( staged.mPrototype ) );
+
+		// If archetype is default, remove the archetype and then set the id to invalid
+		if ( ent->GetArchetype( ) == am->GetDefaultAsset< Archetype >( ) || !ent->GetArchetype( ) )
+		{
+			ent->SetArchetype( nullptr );
+			ent->SetPrototypeEntity( EntityHandle::Invalid( ) );
+		}
+
+		// Set prototype for any instances that already exist
+		for ( auto& id : staged.mInstancedEntities )
+		{
+			EntityHandle h = em->GetEntityByUUID( id );
+			if ( h )
+			{
+				h.Get( )->SetPrototypeEntity( ent );
+			}
+		}
+
+		// Components
+		for ( auto& c : staged.mComponents )
+		{
+			if ( !c.mClass )
+			{
+				continue;
+			}
+
+			Component* cmp = ent->AddComponent( c.mClass );
+			if ( cmp )
+			{
+				CommitStagedComponent( cmp, c, buffer );
+			}
+		}
+
+		// Children
+		for ( auto& c : staged.mChildren )
+		{
+			EntityHandle child = CommitStaged( c, buffer, world, allocation );
+			Entity* childEnt = child.Get( );
+			if ( childEnt )
+			{
+				// Restore local transform after parenting
+				Transform localTrans = childEnt->GetLocalTransform( );
+				ent->AddChild( child );
+				childEnt->SetLocalTransform( localTrans );
+			}
+		}
+
+		// Default object data
+		CommitStagedProperties( ent, staged.mProperties, buffer );
+
+		// If prototype entity, then record all property overrides and then attempt merge
+		if ( ent->HasPrototypeEntity( ) )
+		{
+			ObjectArchiver::ClearAllPropertyOverrides( ent );
+			ObjectArchiver::RecordAllPropertyOverrides( ent->mPrototypeEntity.Get( ), ent );
+			ObjectArchiver::MergeObjects( ent->mPrototypeEntity.Get( ), ent, MergeType::AcceptMerge );
+		}
+
+		return handle;
+	}
+
+	//========================================================================================= 
+
+	void EntityArchiver::CommitStagedOverrides( Entity* ent, const StagedEntity& staged, ByteBuffer* buffer, World* world, StagedAllocation* allocation )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+		AssetManager* am = EngineSubsystem( AssetManager );
+
+		// Replace instanced UUID with the one recorded
+		em->RemoveFromUUIDMap( ent );
+		ent->SetUUID( staged.mUUID );
+		ent->SetName( staged.mName );
+		ent->SetLocalTransform( staged.mLocalTransform );
+
+		// Instanced components already hold prototype values, so only add if missing
+		for ( auto& c : staged.mComponents )
+		{
+			Component* cmp = c.mClass ? ( ent->HasComponent( c.mClass ) ? ent->GetComponent( c.mClass ) : ent->AddComponent( c.mClass ) ) : nullptr;
+			if ( cmp )
+			{
+				CommitStagedComponent( cmp, c, buffer );
+			}
+		}
+
+		for ( auto& cls : staged.mRemovedComponents )
+		{
+			if ( ent->HasComponent( cls ) )
+			{
+				ent->RemoveComponent( cls );
+			}
+		}
+
+		for ( auto& c : staged.mChildren )
+		{
+			switch ( c.mRecordType )
+			{
+				default:
+				case EntityRecordType::Null: break;
+
+				// Child not from the prototype
+				case EntityRecordType::Full:
+				{
+					EntityHandle child = CommitStaged( c, buffer, world, allocation );
+					if ( child.Get( ) )
+					{
+						Transform localTrans = child.Get( )->GetLocalTransform( );
+						ent->AddChild( child );
+						child.Get( )->SetLocalTransform( localTrans );
+					}
+				} break;
+
+				// Child instanced from one of the prototype's children
+				case EntityRecordType::Overrides:
+				{
+					// Find the child that was already instanced alongside this entity
+					Entity* target = nullptr;
+					for ( auto& ec : ent->GetChildren( ) )
+					{
+						if ( ec.Get( )->HasPrototypeEntity( ) && ec.Get( )->GetPrototypeEntity( ).Get( )->GetUUID( ) == c.mPrototype )
+						{
+							target = ec.Get( );
+							break;
+						}
+					}
+
+					// Not found in the instanced hierarchy, so instance prototype directly if it still exists
+					if ( !target )
+					{
+						EntityHandle proto = em->GetEntityByUUID( c.mPrototype );
+						if ( !proto )
+						{
+							break;
+						}
+
+						EntityHandle child = em->InstanceEntity( proto, world );
+						ent->AddChild( child );
+						target = child.Get( );
+					}
+
+					target->SetArchetype( am->GetAsset< Archetype >( c.mArchetype ) );
+					CommitStagedOverrides( target, c, buffer, world, allocation );
+				} break;
+			}
+		}
+
+		// Destroy children instanced from prototype children that were removed from the instance
+		for ( auto& id : staged.mRemovedChildren )
+		{
+			for ( auto& c : ent->GetChildren( ) )
+			{
+				if ( c.Get( )->HasPrototypeEntity( ) && c.Get( )->GetPrototypeEntity( ).Get( )->GetUUID( ) == id )
+				{
+					ent->DetachChild( c );
+					c.Get( )->Destroy( );
+					break;
+				}
+			}
+		}
+
+		CommitStagedProperties( ent, staged.mProperties, buffer );
+	}
+
+	//=========================================================================================
+
+	EntityHandle EntityArchiver::Clone( const EntityHandle& source, World* world, bool isInstanced )
+	{
+		Entity* src = source.Get( );
+		if ( !src )
+		{
+			return EntityHandle( );
+		}
+
+		EntityManager* em = EngineSubsystem( EntityManager );
+		AssetManager* am = EngineSubsystem( AssetManager );
+
+		EntityHandle handle = em->Allocate( world );
+		Entity* ent = handle.Get( );
+		if ( !ent )
+		{
+			return EntityHandle( );
+		}
+
+		ent->SetLocalTransform( src->GetLocalTransform( ) );
+
+		// Remove from uuid map before setting uuid
+		em->RemoveFromUUIDMap( ent );
+		ent->SetUUID( src->GetUUID( ) );
+		ent->SetName( src->GetName( ) );
+
+		// Archetype and prototype are shared with source
+		if ( src->GetArchetype( ) && src->GetArchetype( ) != am->GetDefaultAsset< Archetype >( ) )
+		{
+			ent->SetArchetype( src->GetArchetype( ) );
+			ent->SetPrototypeEntity( src->GetPrototypeEntity( ) );
+		}
+
+		// Components
+		for ( auto& c : src->GetComponents( ) )
+		{
+			Component* cmp = ent->AddComponent( c->Class( ) );
+			if ( cmp )
+			{
+				ObjectArchiver::Clone( c, cmp );
+				cmp->DeserializeLateInit( );
+			}
+		}
+
+		// Children
+		for ( auto& c : src->GetChildren( ) )
+		{
+			EntityHandle child = Clone( c, world );
+			Entity* childEnt = child.Get( );
+			if ( childEnt )
+			{
+				// After adding child, local transform will be incorrect
+				Transform localTrans = childEnt->GetLocalTransform( );
+				ent->AddChild( child );
+				childEnt->SetLocalTransform( localTrans );
+			}
+		}
+
+		// Remaining default data
+		CloneObjectDataDefault( src, ent, ent->Class( ) );
+
+		// Same override resolution as deserializing a full record
+		if ( ent->HasPrototypeEntity( ) && !isInstanced )
+		{
+			ObjectArchiver::ClearAllPropertyOverrides( ent );
+			ObjectArchiver::RecordAllPropertyOverrides( ent->mPrototypeEntity.Get( ), ent );
+			ObjectArchiver::MergeObjects( ent->mPrototypeEntity.Get( ), ent, MergeType::AcceptMerge );
+		}
+
+		return handle;
+	}
+
+	//========================================================================================= 
 }
 
 
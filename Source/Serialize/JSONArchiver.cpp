@@ -0,0 +1,1652 @@
+// @file JSONArchiver.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Serialize/JSONArchiver.h"
+#include "Serialize/ObjectArchiver.h"
+#include "Serialize/ByteBuffer.h"
+#include "Serialize/UUID.h"
+#include "Serialize/AssetArchiver.h"
+#include "Asset/AssetManager.h"
+#include "Entity/Archetype.h"
+#include "Scene/Scene.h"
+#include "Graphics/Color.h"
+#include "Math/Transform.h"
+#include "SubsystemCatalog.h"
+#include "Engine.h"
+
+#include "rapidjson/rapidjson.h"
+#include "rapidjson/reader.h"
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/filereadstream.h"
+#include "rapidjson/filewritestream.h"
+#include "rapidjson/memorystream.h"
+
+#include <stdio.h>
+#include <functional>
+
+#define STRSIZE( string ) static_cast< rapidjson::SizeType >( string.length( ) )
+
+// Size of intermediate buffers used for streaming to and from files
+#define JSON_STREAM_BUFFER_SIZE		65536
+
+namespace Enjon
+{
+	//============================================================================================
+
+	class JSONWriter
+	{
+		public:
+			JSONWriter( FILE* file )
+				: mStream( file, mStreamBuffer, sizeof( mStreamBuffer ) ), mWriter( mStream )
+			{
+			}
+
+			~JSONWriter( )
+			{
+				mStream.Flush( );
+			}
+
+			void Key( const char* key )
+			{
+				mWriter.Key( key );
+			}
+
+			void Str( const String& str )
+			{
+				mWriter.String( str.c_str( ), STRSIZE( str ) );
+			}
+
+			// Writes shortest representation that reads back to the same f32, which keeps text diffs stable
+			void Float( f32 val )
+			{
+				// NaN and infinities are written as NaN, Infinity and -Infinity, which reader is set up to accept
+				if ( val != val || val - val != 0.0f )
+				{
+					mWriter.Double( ( f64 )val );
+					return;
+				}
+
+				char buf[ 32 ];
+				s32 len = 0;
+				for ( s32 precision = 6; precision <= 9; ++precision )
+				{
+					len = snprintf( buf, sizeof( buf ), "%.*g", precision, val );
+					if ( strtof( buf, nullptr ) == val )
+					{
+						break;
+					}
+				}
+
+				mWriter.RawValue( buf, ( size_t )len, rapidjson::kNumberType );
+			}
+
+			char mStreamBuffer[ JSON_STREAM_BUFFER_SIZE ];
+			rapidjson::FileWriteStream mStream;
+			rapidjson::PrettyWriter< rapidjson::FileWriteStream, rapidjson::UTF8<>, rapidjson::UTF8<>, rapidjson::CrtAllocator, rapidjson::kWriteNanAndInfFlag > mWriter;
+	};
+
+	//============================================================================================
+
+	static const char* gBase64Chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	INTERNAL String Base64Encode( const u8* data, u32 size )
+	{
+		String out;
+		out.reserve( ( ( size + 2 ) / 3 ) * 4 );
+
+		for ( u32 i = 0; i < size; i += 3 )
+		{
+			u32 n = ( u32 )data[ i ] << 16;
+			if ( i + 1 < size ) n |= ( u32 )data[ i + 1 ] << 8;
+			if ( i + 2 < size ) n |= ( u32 )data[ i + 2 ];
+
+			out.push_back( gBase64Chars[ ( n >> 18 ) & 63 ] );
+			out.push_back( gBase64Chars[ ( n >> 12 ) & 63 ] );
+			out.push_back( i + 1 < size ? gBase64Chars[ ( n >> 6 ) & 63 ] : '=' );
+			out.push_back( i + 2 < size ? gBase64Chars[ n & 63 ] : '=' );
+		}
+
+		return out;
+	}
+
+	//============================================================================================
+
+	INTERNAL void Base64Decode( const String& str, ByteBuffer* out )
+	{
+		u32 n = 0;
+		s32 bits = -8;
+		for ( auto& c : str )
+		{
+			s32 v = -1;
+			if ( c >= 'A' && c <= 'Z' ) v = c - 'A';
+			else if ( c >= 'a' && c <= 'z' ) v = c - 'a' + 26;
+			else if ( c >= '0' && c <= '9' ) v = c - '0' + 52;
+			else if ( c == '+' ) v = 62;
+			else if ( c == '/' ) v = 63;
+			else break;
+
+			n = ( n << 6 ) | ( u32 )v;
+			bits += 6;
+			if ( bits >= 0 )
+			{
+				out->Write< u8 >( ( u8 )( ( n >> bits ) & 0xFF ) );
+				bits -= 8;
+			}
+		}
+	}
+
+	//============================================================================================
+	// Writing
+	//============================================================================================
+
+	Result JSONArchiver::Serialize( const Object* object, const String& filePath )
+	{
+		if ( !object )
+		{
+			return Result::FAILURE;
+		}
+
+		FILE* file = fopen( filePath.c_str( ), "wb" );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		{
+			JSONWriter writer( file );
+			WriteObject( object, &writer );
+		}
+
+		fclose( file );
+
+		return Result::SUCCESS;
+	}
+
+	//============================================================================================
+
+	Result JSONArchiver::SerializeEntities( const Vector< EntityHandle >& entities, const String& filePath )
+	{
+		FILE* file = fopen( filePath.c_str( ), "wb" );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		{
+			JSONWriter writer( file );
+			writer.mWriter.StartObject( );
+			writer.Key( "Entities" );
+			writer.mWriter.StartArray( );
+			for ( auto& e : entities )
+			{
+				WriteEntity( e, &writer );
+			}
+			writer.mWriter.EndArray( );
+			writer.mWriter.EndObject( );
+		}
+
+		fclose( file );
+
+		return Result::SUCCESS;
+	}
+
+	//============================================================================================
+
+	Result JSONArchiver::SerializeAsset( const Asset* asset, const String& filePath )
+	{
+		if ( !asset || !asset->GetLoader( ) )
+		{
+			return Result::FAILURE;
+		}
+
+		const MetaClass* cls = asset->Class( );
+
+		// Scenes are written as the entities they hold, so levels can be diffed and merged as text
+		bool isScene = ( cls == Object::GetClass< Scene >( ) );
+
+		// Binary data is no easier to diff once embedded in text, so those assets are left to the binary archiver
+		ByteBuffer data;
+		if ( !isScene && asset->SerializeData( &data ) != Result::INCOMPLETE )
+		{
+			return Result::INCOMPLETE;
+		}
+
+		FILE* file = fopen( filePath.c_str( ), "wb" );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		{
+			JSONWriter writer( file );
+			auto& w = writer.mWriter;
+
+			w.StartObject( );
+
+			//==================================================
+			// Asset Header 
+			//==================================================
+			writer.Key( "Class" );
+			writer.Str( cls->GetName( ) );
+			writer.Key( "Version" );
+			w.Uint( ENJON_ASSET_HEADER_VERSION );
+			writer.Key( "UUID" );
+			writer.Str( asset->GetUUID( ).ToString( ) );
+			writer.Key( "Name" );
+			writer.Str( asset->GetName( ) );
+			writer.Key( "Loader" );
+			writer.Str( asset->GetLoader( )->Class( )->GetName( ) );
+
+			//==================================================
+			// Source Info 
+			//==================================================
+			const AssetSourceInfo& source = asset->GetSourceInfo( );
+			writer.Key( "SourceFilePath" );
+			writer.Str( source.mSourceFilePath );
+			writer.Key( "SourceFileSize" );
+			w.Uint64( source.mSourceFileSize );
+			writer.Key( "SourceWriteTime" );
+			w.Int64( source.mSourceWriteTime );
+			writer.Key( "SourceHash" );
+			w.Uint64( source.mSourceHash );
+			writer.Key( "ImportSettings" );
+			writer.Str( source.mImportSettings );
+
+			if ( isScene )
+			{
+				// Same set of entities that Scene::SerializeData writes out
+				writer.Key( "Entities" );
+				w.StartArray( );
+				for ( auto& e : EngineSubsystem( EntityManager )->GetRootLevelEntities( ) )
+				{
+					WriteEntity( e, &writer );
+				}
+				w.EndArray( );
+			}
+			else
+			{
+				writer.Key( "Properties" );
+				WriteProperties( asset, cls, &writer );
+			}
+
+			w.EndObject( );
+		}
+
+		fclose( file );
+
+		return Result::SUCCESS;
+	}
+
+	//============================================================================================
+
+	void JSONArchiver::WriteObject( const Object* object, JSONWriter* writer )
+	{
+		if ( !object )
+		{
+			writer->mWriter.Null( );
+			return;
+		}
+
+		const MetaClass* cls = object->Class( );
+
+		writer->mWriter.StartObject( );
+		writer->Key( "Class" );
+		writer->Str( cls->GetName( ) );
+
+		// Objects that handle their own serialization can only be embedded as binary
+		ByteBuffer data;
+		if ( object->SerializeData( &data ) == Result::INCOMPLETE )
+		{
+			writer->Key( "Properties" );
+			WriteProperties( object, cls, writer );
+		}
+		else
+		{
+			writer->Key( "Data" );
+			writer->Str( Base64Encode( data.GetData( ), data.GetSize( ) ) );
+		}
+
+		writer->mWriter.EndObject( );
+	}
+
+	//============================================================================================
+
+	void JSONArchiver::WriteProperties( const Object* object, const MetaClass* cls, JSONWriter* writer )
+	{
+		writer->mWriter.StartObject( );
+
+		for ( u32 i = 0; i < cls->GetPropertyCount( ); ++i )
+		{
+			const MetaProperty* prop = cls->GetProperty( i );
+
+			// Do not serialize if property is null or non-serializable
+			if ( !prop || prop->HasFlags( MetaPropertyFlags::NonSerializeable ) )
+			{
+				continue;
+			}
+
+			writer->Key( prop->GetName( ).c_str( ) );
+			WriteProperty( object, prop, writer );
+		}
+
+		writer->mWriter.EndObject( );
+	}
+
+	//============================================================================================
+
+#define WRITE_JSON_ARRAY_PRIM( object, prop, valType, writeFunc )\
+	{\
+		const MetaPropertyArray< valType >* arrayProp = prop->Cast< MetaPropertyArray< valType > >( );\
+		for ( usize j = 0; j < arrayProp->GetSize( object ); ++j )\
+		{\
+			writeFunc( arrayProp->GetValueAs( object, j ) );\
+		}\
+	}
+
+#define WRITE_JSON_MAP_PRIM( object, prop, keyType, valType, keyFunc, valFunc )\
+	{\
+		const MetaPropertyHashMap< keyType, valType >* mapProp = prop->Cast< MetaPropertyHashMap< keyType, valType > >( );\
+		for ( auto iter = mapProp->Begin( object ); iter != mapProp->End( object ); ++iter )\
+		{\
+			w.StartArray( );\
+			keyFunc( iter->first );\
+			valFunc( iter->second );\
+			w.EndArray( );\
+		}\
+	}
+
+	void JSONArchiver::WriteProperty( const Object* object, const MetaProperty* prop, JSONWriter* writer )
+	{
+		const MetaClass* cls = object->Class( );
+		auto& w = writer->mWriter;
+
+		auto writeBool = [ & ] ( bool v ) { w.Bool( v ); };
+		auto writeUint = [ & ] ( u32 v ) { w.Uint( v ); };
+		auto writeInt = [ & ] ( s32 v ) { w.Int( v ); };
+		auto writeFloat = [ & ] ( f32 v ) { writer->Float( v ); };
+		auto writeDouble = [ & ] ( f64 v ) { w.Double( v ); };
+		auto writeString = [ & ] ( const String& v ) { writer->Str( v ); };
+		auto writeUUID = [ & ] ( const UUID& v ) { writer->Str( v.ToString( ) ); };
+		auto writeObject = [ & ] ( const Object* v ) { WriteObject( v, writer ); };
+
+		switch ( prop->GetType( ) )
+		{
+			default:
+			{
+				w.Null( );
+			} break;
+
+			case MetaPropertyType::Bool:	w.Bool( *cls->GetValueAs< bool >( object, prop ) );		break;
+			case MetaPropertyType::U8:		w.Uint( *cls->GetValueAs< u8 >( object, prop ) );		break;
+			case MetaPropertyType::U16:		w.Uint( *cls->GetValueAs< u16 >( object, prop ) );		break;
+			case MetaPropertyType::U32:		w.Uint( *cls->GetValueAs< u32 >( object, prop ) );		break;
+			case MetaPropertyType::U64:		w.Uint64( *cls->GetValueAs< u64 >( object, prop ) );	break;
+			case MetaPropertyType::S8:		w.Int( *cls->GetValueAs< s8 >( object, prop ) );		break;
+			case MetaPropertyType::S16:		w.Int( *cls->GetValueAs< s16 >( object, prop ) );		break;
+			case MetaPropertyType::S32:		w.Int( *cls->GetValueAs< s32 >( object, prop ) );		break;
+			case MetaPropertyType::S64:		w.Int64( *cls->GetValueAs< s64 >( object, prop ) );		break;
+			case MetaPropertyType::F32:		writer->Float( *cls->GetValueAs< f32 >( object, prop ) );	break;
+			case MetaPropertyType::F64:		w.Double( *cls->GetValueAs< f64 >( object, prop ) );	break;
+			case MetaPropertyType::Enum:	w.Int( *cls->GetValueAs< s32 >( object, prop ) );		break;
+			case MetaPropertyType::String:	writer->Str( *cls->GetValueAs< String >( object, prop ) );				break;
+			case MetaPropertyType::UUID:	writer->Str( cls->GetValueAs< UUID >( object, prop )->ToString( ) );	break;
+
+			case MetaPropertyType::AssetHandle:
+			{
+				AssetHandle< Asset > val;
+				cls->GetValue( object, prop, &val );
+				writer->Str( val ? val.GetUUID( ).ToString( ) : UUID::Invalid( ).ToString( ) );
+			} break;
+
+			case MetaPropertyType::Vec2:
+			{
+				const Vec2* v = cls->GetValueAs< Vec2 >( object, prop );
+				w.StartArray( ); writer->Float( v->x ); writer->Float( v->y ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::Vec3:
+			{
+				const Vec3* v = cls->GetValueAs< Vec3 >( object, prop );
+				w.StartArray( ); writer->Float( v->x ); writer->Float( v->y ); writer->Float( v->z ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::Vec4:
+			{
+				const Vec4* v = cls->GetValueAs< Vec4 >( object, prop );
+				w.StartArray( ); writer->Float( v->x ); writer->Float( v->y ); writer->Float( v->z ); writer->Float( v->w ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::iVec2:
+			{
+				const iVec2* v = cls->GetValueAs< iVec2 >( object, prop );
+				w.StartArray( ); w.Int( v->x ); w.Int( v->y ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::iVec3:
+			{
+				const iVec3* v = cls->GetValueAs< iVec3 >( object, prop );
+				w.StartArray( ); w.Int( v->x ); w.Int( v->y ); w.Int( v->z ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::iVec4:
+			{
+				const iVec4* v = cls->GetValueAs< iVec4 >( object, prop );
+				w.StartArray( ); w.Int( v->x ); w.Int( v->y ); w.Int( v->z ); w.Int( v->w ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::Quat:
+			{
+				const Quaternion* v = cls->GetValueAs< Quaternion >( object, prop );
+				w.StartArray( ); writer->Float( v->x ); writer->Float( v->y ); writer->Float( v->z ); writer->Float( v->w ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::ColorRGBA32:
+			{
+				const ColorRGBA32* v = cls->GetValueAs< ColorRGBA32 >( object, prop );
+				w.StartArray( ); writer->Float( v->r ); writer->Float( v->g ); writer->Float( v->b ); writer->Float( v->a ); w.EndArray( );
+			} break;
+
+			case MetaPropertyType::Mat4x4:
+			{
+				const Mat4x4* v = cls->GetValueAs< Mat4x4 >( object, prop );
+				w.StartArray( );
+				for ( auto& e : v->elements )
+				{
+					writer->Float( e );
+				}
+				w.EndArray( );
+			} break;
+
+			case MetaPropertyType::Transform:
+			{
+				const Transform* v = cls->GetValueAs< Transform >( object, prop );
+				Vec3 p = v->GetPosition( ), s = v->GetScale( );
+				Quaternion r = v->GetRotation( );
+				w.StartArray( );
+				writer->Float( p.x ); writer->Float( p.y ); writer->Float( p.z );
+				writer->Float( r.x ); writer->Float( r.y ); writer->Float( r.z ); writer->Float( r.w );
+				writer->Float( s.x ); writer->Float( s.y ); writer->Float( s.z );
+				w.EndArray( );
+			} break;
+
+			case MetaPropertyType::Object:
+			{
+				if ( prop->GetTraits( ).IsPointer( ) )
+				{
+					WriteObject( prop->Cast< MetaPropertyPointerBase >( )->GetValueAsObject( object ), writer );
+				}
+				else
+				{
+					WriteObject( cls->GetValueAs< Object >( object, prop ), writer );
+				}
+			} break;
+
+			case MetaPropertyType::EntityHandle:
+			{
+				EntityHandle handle = *cls->GetValueAs< EntityHandle >( object, prop );
+				if ( handle.Get( ) )
+				{
+					WriteEntity( handle, writer );
+				}
+				else
+				{
+					w.Null( );
+				}
+			} break;
+
+			case MetaPropertyType::Array:
+			{
+				const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+
+				w.StartArray( );
+				switch ( base->GetArrayType( ) )
+				{
+					default: break;
+					case MetaPropertyType::Bool:	WRITE_JSON_ARRAY_PRIM( object, base, bool, writeBool )			break;
+					case MetaPropertyType::U8:		WRITE_JSON_ARRAY_PRIM( object, base, u8, writeUint )			break;
+					case MetaPropertyType::U32:		WRITE_JSON_ARRAY_PRIM( object, base, u32, writeUint )			break;
+					case MetaPropertyType::S32:		WRITE_JSON_ARRAY_PRIM( object, base, s32, writeInt )			break;
+					case MetaPropertyType::F32:		WRITE_JSON_ARRAY_PRIM( object, base, f32, writeFloat )			break;
+					case MetaPropertyType::F64:		WRITE_JSON_ARRAY_PRIM( object, base, f64, writeDouble )			break;
+					case MetaPropertyType::String:	WRITE_JSON_ARRAY_PRIM( object, base, String, writeString )		break;
+					case MetaPropertyType::UUID:	WRITE_JSON_ARRAY_PRIM( object, base, UUID, writeUUID )			break;
+					case MetaPropertyType::Object:	WRITE_JSON_ARRAY_PRIM( object, base, Object*, writeObject )		break;
+
+					case MetaPropertyType::AssetHandle:
+					{
+						const MetaPropertyArray< AssetHandle< Asset > >* arrProp = base->Cast< MetaPropertyArray< AssetHandle< Asset > > >( );
+						for ( usize j = 0; j < arrProp->GetSize( object ); ++j )
+						{
+							AssetHandle< Asset > asset;
+							arrProp->GetValueAt( object, j, &asset );
+							writer->Str( asset ? asset->GetUUID( ).ToString( ) : UUID::Invalid( ).ToString( ) );
+						}
+					} break;
+				}
+				w.EndArray( );
+			} break;
+
+			// Maps are written as an array of [ key, value ] pairs
+			case MetaPropertyType::HashMap:
+			{
+				const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
+
+				w.StartArray( );
+				switch ( base->GetKeyType( ) )
+				{
+					default: break;
+
+					case MetaPropertyType::U32:
+					{
+						switch ( base->GetValueType( ) )
+						{
+							default: break;
+							case MetaPropertyType::U32:		WRITE_JSON_MAP_PRIM( object, base, u32, u32, writeUint, writeUint )		break;
+							case MetaPropertyType::S32:		WRITE_JSON_MAP_PRIM( object, base, u32, s32, writeUint, writeInt )			break;
+							case MetaPropertyType::F32:		WRITE_JSON_MAP_PRIM( object, base, u32, f32, writeUint, writeFloat )		break;
+						}
+					} break;
+
+					case MetaPropertyType::String:
+					{
+						switch ( base->GetValueType( ) )
+						{
+							default: break;
+							case MetaPropertyType::U32:		WRITE_JSON_MAP_PRIM( object, base, String, u32, writeString, writeUint )		break;
+							case MetaPropertyType::Object:	WRITE_JSON_MAP_PRIM( object, base, String, Object*, writeString, writeObject )	break;
+						}
+					} break;
+
+					case MetaPropertyType::Enum:
+					{
+						switch ( base->GetValueType( ) )
+						{
+							default: break;
+							case MetaPropertyType::String:	WRITE_JSON_MAP_PRIM( object, base, s32, String, writeInt, writeString )		break;
+							case MetaPropertyType::Object:	WRITE_JSON_MAP_PRIM( object, base, s32, Object*, writeInt, writeObject )	break;
+						}
+					} break;
+				}
+				w.EndArray( );
+			} break;
+		}
+	}
+
+	//============================================================================================
+
+	void JSONArchiver::WriteEntity( const EntityHandle& entity, JSONWriter* writer )
+	{
+		Entity* ent = entity.Get( );
+		if ( !ent )
+		{
+			writer->mWriter.Null( );
+			return;
+		}
+
+		auto& w = writer->mWriter;
+
+		w.StartObject( );
+
+		writer->Key( "UUID" );
+		writer->Str( ent->GetUUID( ).ToString( ) );
+
+		writer->Key( "Name" );
+		writer->Str( ent->GetName( ) );
+
+		// Local transform is written as position, rotation, scale
+		Transform local = ent->GetLocalTransform( );
+		Vec3 p = local.GetPosition( ), s = local.GetScale( );
+		Quaternion r = local.GetRotation( );
+		writer->Key( "Transform" );
+		w.StartArray( );
+		writer->Float( p.x ); writer->Float( p.y ); writer->Float( p.z );
+		writer->Float( r.x ); writer->Float( r.y ); writer->Float( r.z ); writer->Float( r.w );
+		writer->Float( s.x ); writer->Float( s.y ); writer->Float( s.z );
+		w.EndArray( );
+
+		writer->Key( "Archetype" );
+		writer->Str( ent->GetArchetype( ) ? ent->GetArchetype( ).GetUUID( ).ToString( ) : UUID::Invalid( ).ToString( ) );
+
+		writer->Key( "Prototype" );
+		writer->Str( ent->HasPrototypeEntity( ) ? ent->GetPrototypeEntity( ).Get( )->GetUUID( ).ToString( ) : UUID::Invalid( ).ToString( ) );
+
+		writer->Key( "Components" );
+		w.StartArray( );
+		for ( auto& c : ent->GetComponents( ) )
+		{
+			WriteObject( c, writer );
+		}
+		w.EndArray( );
+
+		writer->Key( "Children" );
+		w.StartArray( );
+		for ( auto& c : ent->GetChildren( ) )
+		{
+			WriteEntity( c, writer );
+		}
+		w.EndArray( );
+
+		writer->Key( "Properties" );
+		WriteProperties( ent, ent->Class( ), writer );
+
+		w.EndObject( );
+	}
+
+	//============================================================================================
+	// Reading
+	//============================================================================================
+
+	struct JSONScalar
+	{
+		bool mIsNull = false;
+		s64 mInt = 0;
+		u64 mUint = 0;
+		f64 mNumber = 0.0;
+		String mString;
+	};
+
+	enum class JSONFrameType
+	{
+		Root,
+		Object,
+		Properties,
+		Values,
+		Array,
+		MapList,
+		MapPair,
+		Entity,
+		EntityList,
+		ComponentList,
+		Skip
+	};
+
+	struct JSONReadFrame
+	{
+		JSONFrameType mType = JSONFrameType::Skip;
+		Object* mObject = nullptr;
+		const MetaProperty* mProperty = nullptr;
+		EntityHandle mEntity;
+		String mKey;
+		u32 mIndex = 0;
+		bool mHasPairKey = false;
+		JSONScalar mPairKey;
+		Vector< f64 > mValues;
+		std::function< Object*( const MetaClass* ) > mConstruct;
+		std::function< void( const Vector< f64 >& ) > mOnValues;
+		std::function< void( const EntityHandle& ) > mOnEntity;
+	};
+
+	//============================================================================================
+
+	INTERNAL const MetaClass* GetAssetClass( const MetaProperty* prop )
+	{
+		const MetaPropertyTemplateBase* base = prop->Cast< MetaPropertyTemplateBase >( );
+		return base ? base->GetClassOfTemplatedArgument( ) : nullptr;
+	}
+
+	INTERNAL AssetHandle< Asset > GetAssetFromString( const MetaClass* assetCls, const String& id )
+	{
+		AssetManager* am = EngineSubsystem( AssetManager );
+		AssetHandle< Asset > handle;
+		const Asset* asset = am->GetAsset( assetCls, UUID( id ) );
+		handle.Set( asset ? asset : am->GetDefaultAsset( assetCls ) );
+		return handle;
+	}
+
+	//============================================================================================
+
+	INTERNAL void ApplyScalar( Object* object, const MetaProperty* prop, const JSONScalar& v )
+	{
+		if ( !object || !prop || v.mIsNull )
+		{
+			return;
+		}
+
+		const MetaClass* cls = object->Class( );
+
+		switch ( prop->GetType( ) )
+		{
+			default: break;
+			case MetaPropertyType::Bool:	cls->SetValue( object, prop, v.mInt != 0 );				break;
+			case MetaPropertyType::U8:		cls->SetValue( object, prop, ( u8 )v.mUint );			break;
+			case MetaPropertyType::U16:		cls->SetValue( object, prop, ( u16 )v.mUint );			break;
+			case MetaPropertyType::U32:		cls->SetValue( object, prop, ( u32 )v.mUint );			break;
+			case MetaPropertyType::U64:		cls->SetValue( object, prop, ( u64 )v.mUint );			break;
+			case MetaPropertyType::S8:		cls->SetValue( object, prop, ( s8 )v.mInt );			break;
+			case MetaPropertyType::S16:		cls->SetValue( object, prop, ( s16 )v.mInt );			break;
+			case MetaPropertyType::S32:		cls->SetValue( object, prop, ( s32 )v.mInt );			break;
+			case MetaPropertyType::S64:		cls->SetValue( object, prop, ( s64 )v.mInt );			break;
+			case MetaPropertyType::F32:		cls->SetValue( object, prop, ( f32 )v.mNumber );		break;
+			case MetaPropertyType::F64:		cls->SetValue( object, prop, ( f64 )v.mNumber );		break;
+			case MetaPropertyType::Enum:	cls->SetValue( object, prop, ( s32 )v.mInt );			break;
+			case MetaPropertyType::String:	cls->SetValue( object, prop, v.mString );				break;
+			case MetaPropertyType::UUID:	cls->SetValue( object, prop, UUID( v.mString ) );		break;
+			case MetaPropertyType::AssetHandle: cls->SetValue( object, prop, GetAssetFromString( GetAssetClass( prop ), v.mString ) ); break;
+		}
+	}
+
+	//============================================================================================
+
+	INTERNAL void ApplyValues( Object* object, const MetaProperty* prop, const Vector< f64 >& v )
+	{
+		const MetaClass* cls = object->Class( );
+		usize n = v.size( );
+
+		switch ( prop->GetType( ) )
+		{
+			default: break;
+			case MetaPropertyType::Vec2:		if ( n >= 2 ) cls->SetValue( object, prop, Vec2( ( f32 )v[0], ( f32 )v[1] ) );											break;
+			case MetaPropertyType::Vec3:		if ( n >= 3 ) cls->SetValue( object, prop, Vec3( ( f32 )v[0], ( f32 )v[1], ( f32 )v[2] ) );								break;
+			case MetaPropertyType::Vec4:		if ( n >= 4 ) cls->SetValue( object, prop, Vec4( ( f32 )v[0], ( f32 )v[1], ( f32 )v[2], ( f32 )v[3] ) );				break;
+			case MetaPropertyType::iVec2:		if ( n >= 2 ) cls->SetValue( object, prop, iVec2( ( s32 )v[0], ( s32 )v[1] ) );										break;
+			case MetaPropertyType::iVec3:		if ( n >= 3 ) cls->SetValue( object, prop, iVec3( ( s32 )v[0], ( s32 )v[1], ( s32 )v[2] ) );							break;
+			case MetaPropertyType::iVec4:		if ( n >= 4 ) cls->SetValue( object, prop, iVec4( ( s32 )v[0], ( s32 )v[1], ( s32 )v[2], ( s32 )v[3] ) );				break;
+			case MetaPropertyType::Quat:		if ( n >= 4 ) cls->SetValue( object, prop, Quaternion( ( f32 )v[0], ( f32 )v[1], ( f32 )v[2], ( f32 )v[3] ) );			break;
+			case MetaPropertyType::ColorRGBA32:	if ( n >= 4 ) cls->SetValue( object, prop, ColorRGBA32( ( f32 )v[0], ( f32 )v[1], ( f32 )v[2], ( f32 )v[3] ) );			break;
+
+			case MetaPropertyType::Mat4x4:
+			{
+				if ( n >= 16 )
+				{
+					Mat4x4 mat;
+					for ( u32 i = 0; i < 16; ++i )
+					{
+						mat.elements[ i ] = ( f32 )v[ i ];
+					}
+					cls->SetValue( object, prop, mat );
+				}
+			} break;
+
+			case MetaPropertyType::Transform:
+			{
+				if ( n >= 10 )
+				{
+					Transform t;
+					t.SetPosition( Vec3( ( f32 )v[0], ( f32 )v[1], ( f32 )v[2] ) );
+					t.SetRotation( Quaternion( ( f32 )v[3], ( f32 )v[4], ( f32 )v[5], ( f32 )v[6] ) );
+					t.SetScale( Vec3( ( f32 )v[7], ( f32 )v[8], ( f32 )v[9] ) );
+					cls->SetValue( object, prop, t );
+				}
+			} break;
+		}
+	}
+
+	//============================================================================================
+
+	// Makes sure index is addressable in array, growing dynamic arrays as elements stream in
+	INTERNAL bool PrepareArrayIndex( const Object* object, const MetaPropertyArrayBase* base, u32 index )
+	{
+		if ( index < base->GetSize( object ) )
+		{
+			return true;
+		}
+
+		if ( base->GetArraySizeType( ) == ArraySizeType::Dynamic )
+		{
+			base->Resize( object, index + 1 );
+			return true;
+		}
+
+		return false;
+	}
+
+	//============================================================================================
+
+	INTERNAL void ApplyArrayElement( Object* object, const MetaProperty* prop, u32 index, const JSONScalar& v )
+	{
+		const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+		if ( !PrepareArrayIndex( object, base, index ) )
+		{
+			return;
+		}
+
+		switch ( base->GetArrayType( ) )
+		{
+			default: break;
+			case MetaPropertyType::Bool:	base->Cast< MetaPropertyArray< bool > >( )->SetValueAt( object, index, v.mInt != 0 );			break;
+			case MetaPropertyType::U8:		base->Cast< MetaPropertyArray< u8 > >( )->SetValueAt( object, index, ( u8 )v.mUint );			break;
+			case MetaPropertyType::U32:		base->Cast< MetaPropertyArray< u32 > >( )->SetValueAt( object, index, ( u32 )v.mUint );			break;
+			case MetaPropertyType::S32:		base->Cast< MetaPropertyArray< s32 > >( )->SetValueAt( object, index, ( s32 )v.mInt );			break;
+			case MetaPropertyType::F32:		base->Cast< MetaPropertyArray< f32 > >( )->SetValueAt( object, index, ( f32 )v.mNumber );		break;
+			case MetaPropertyType::F64:		base->Cast< MetaPropertyArray< f64 > >( )->SetValueAt( object, index, ( f64 )v.mNumber );		break;
+			case MetaPropertyType::String:	base->Cast< MetaPropertyArray< String > >( )->SetValueAt( object, index, v.mString );			break;
+			case MetaPropertyType::UUID:	base->Cast< MetaPropertyArray< UUID > >( )->SetValueAt( object, index, UUID( v.mString ) );		break;
+
+			case MetaPropertyType::AssetHandle:
+			{
+				MetaArrayPropertyProxy proxy = base->GetProxy( );
+				const MetaPropertyTemplateBase* arrBase = static_cast< const MetaPropertyTemplateBase* >( proxy.mArrayPropertyTypeBase );
+				const MetaPropertyArray< AssetHandle< Asset > >* arrProp = base->Cast< MetaPropertyArray< AssetHandle< Asset > > >( );
+				arrProp->SetValueAt( object, index, GetAssetFromString( arrBase->GetClassOfTemplatedArgument( ), v.mString ) );
+			} break;
+		}
+	}
+
+	//============================================================================================
+
+	INTERNAL void ApplyMapValue( Object* object, const MetaProperty* prop, const JSONScalar& k, const JSONScalar& v )
+	{
+		const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
+
+		switch ( base->GetKeyType( ) )
+		{
+			default: break;
+
+			case MetaPropertyType::U32:
+			{
+				switch ( base->GetValueType( ) )
+				{
+					default: break;
+					case MetaPropertyType::U32:	base->Cast< MetaPropertyHashMap< u32, u32 > >( )->SetValueAt( object, ( u32 )k.mUint, ( u32 )v.mUint );		break;
+					case MetaPropertyType::S32:	base->Cast< MetaPropertyHashMap< u32, s32 > >( )->SetValueAt( object, ( u32 )k.mUint, ( s32 )v.mInt );		break;
+					case MetaPropertyType::F32:	base->Cast< MetaPropertyHashMap< u32, f32 > >( )->SetValueAt( object, ( u32 )k.mUint, ( f32 )v.mNumber );	break;
+				}
+			} break;
+
+			case MetaPropertyType::String:
+			{
+				if ( base->GetValueType( ) == MetaPropertyType::U32 )
+				{
+					base->Cast< MetaPropertyHashMap< String, u32 > >( )->SetValueAt( object, k.mString, ( u32 )v.mUint );
+				}
+			} break;
+
+			case MetaPropertyType::Enum:
+			{
+				if ( base->GetValueType( ) == MetaPropertyType::String )
+				{
+					base->Cast< MetaPropertyHashMap< s32, String > >( )->SetValueAt( object, ( s32 )k.mInt, v.mString );
+				}
+			} break;
+		}
+	}
+
+	//============================================================================================
+
+	INTERNAL void ApplyMapObject( Object* object, const MetaProperty* prop, const JSONScalar& k, Object* v )
+	{
+		const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
+		if ( base->GetValueType( ) != MetaPropertyType::Object )
+		{
+			return;
+		}
+
+		switch ( base->GetKeyType( ) )
+		{
+			default: break;
+			case MetaPropertyType::String:	base->Cast< MetaPropertyHashMap< String, Object* > >( )->SetValueAt( object, k.mString, v );	break;
+			case MetaPropertyType::Enum:	base->Cast< MetaPropertyHashMap< s32, Object* > >( )->SetValueAt( object, ( s32 )k.mInt, v );	break;
+		}
+	}
+
+	//============================================================================================
+
+	INTERNAL bool IsValuesType( MetaPropertyType type )
+	{
+		switch ( type )
+		{
+			case MetaPropertyType::Vec2:
+			case MetaPropertyType::Vec3:
+			case MetaPropertyType::Vec4:
+			case MetaPropertyType::iVec2:
+			case MetaPropertyType::iVec3:
+			case MetaPropertyType::iVec4:
+			case MetaPropertyType::Quat:
+			case MetaPropertyType::ColorRGBA32:
+			case MetaPropertyType::Mat4x4:
+			case MetaPropertyType::Transform: return true;
+			default: return false;
+		}
+	}
+
+	//============================================================================================
+
+	// Returns whether key names a field of an asset header, applying value to header if so
+	INTERNAL bool ApplyAssetHeaderField( AssetHeader* header, const String& key, const JSONScalar& v )
+	{
+		if ( key.compare( "Class" ) == 0 )						header->mClass = Object::GetClass( v.mString );
+		else if ( key.compare( "Version" ) == 0 )				header->mVersion = ( u32 )v.mUint;
+		else if ( key.compare( "UUID" ) == 0 )					header->mUUID = UUID( v.mString );
+		else if ( key.compare( "Name" ) == 0 )					header->mName = v.mString;
+		else if ( key.compare( "Loader" ) == 0 )				header->mLoaderName = v.mString;
+		else if ( key.compare( "SourceFilePath" ) == 0 )		header->mSourceInfo.mSourceFilePath = v.mString;
+		else if ( key.compare( "SourceFileSize" ) == 0 )		header->mSourceInfo.mSourceFileSize = v.mUint;
+		else if ( key.compare( "SourceWriteTime" ) == 0 )		header->mSourceInfo.mSourceWriteTime = v.mInt;
+		else if ( key.compare( "SourceHash" ) == 0 )			header->mSourceInfo.mSourceHash = v.mUint;
+		else if ( key.compare( "ImportSettings" ) == 0 )		header->mSourceInfo.mImportSettings = v.mString;
+		else return false;
+
+		return true;
+	}
+
+	//============================================================================================
+
+	/*
+	* @brief SAX handler that applies values to objects and entities as they are parsed. Keeps a stack of frames, one per open json object or array.
+	*/
+	class JSONReadHandler : public rapidjson::BaseReaderHandler< rapidjson::UTF8<>, JSONReadHandler >
+	{
+		public:
+
+			JSONReadHandler( World* world )
+				: mWorld( world )
+			{
+				JSONReadFrame root;
+				root.mType = JSONFrameType::Root;
+				mFrames.push_back( root );
+			}
+
+			// Root json object will be read into object ( or constructed if null )
+			void ReadObject( Object* object )
+			{
+				mRootObject = object;
+				mReadRootObject = true;
+				mReadEntities = false;
+			}
+
+			// Root json object is a list of entities
+			void ReadEntities( Vector< EntityHandle >* out )
+			{
+				mEntitiesOut = out;
+				mReadRootObject = false;
+				mReadEntities = true;
+			}
+
+			// Root json object is an asset ( constructed if null ), with its header fields alongside its class and a list of entities if it is a scene
+			void ReadAsset( Object* asset, AssetHeader* header )
+			{
+				mRootObject = asset;
+				mHeader = header;
+				mReadRootObject = true;
+				mReadEntities = true;
+			}
+
+			// Only header fields of root asset are read, stopping as soon as its data is reached
+			void ReadAssetHeader( AssetHeader* header )
+			{
+				mHeader = header;
+				mReadHeaderOnly = true;
+			}
+
+			bool HasReadHeader( ) const
+			{
+				return mHasReadHeader;
+			}
+
+			Object* GetRootObject( ) const
+			{
+				return mRootObject;
+			}
+
+			//========================================================================
+
+			bool Null( )
+			{
+				JSONScalar v;
+				v.mIsNull = true;
+				return Scalar( v );
+			}
+
+			bool Bool( bool b )
+			{
+				JSONScalar v;
+				v.mInt = b ? 1 : 0; v.mUint = v.mInt; v.mNumber = ( f64 )v.mInt;
+				return Scalar( v );
+			}
+
+			bool Int( int i ) { return Int64( i ); }
+			bool Uint( unsigned u ) { return Uint64( u ); }
+
+			bool Int64( int64_t i )
+			{
+				JSONScalar v;
+				v.mInt = i; v.mUint = ( u64 )i; v.mNumber = ( f64 )i;
+				return Scalar( v );
+			}
+
+			bool Uint64( uint64_t u )
+			{
+				JSONScalar v;
+				v.mInt = ( s64 )u; v.mUint = u; v.mNumber = ( f64 )u;
+				return Scalar( v );
+			}
+
+			bool Double( double d )
+			{
+				// Non-finite values only make sense as floating point
+				JSONScalar v;
+				v.mInt = ( d == d && d - d == 0.0 ) ? ( s64 )d : 0; v.mUint = ( u64 )v.mInt; v.mNumber = d;
+				return Scalar( v );
+			}
+
+			bool String( const char* str, rapidjson::SizeType length, bool copy )
+			{
+				JSONScalar v;
+				v.mString = Enjon::String( str, length );
+				return Scalar( v );
+			}
+
+			bool Key( const char* str, rapidjson::SizeType length, bool copy )
+			{
+				JSONReadFrame& f = mFrames.back( );
+				f.mKey = Enjon::String( str, length );
+
+				// Anything that is not a header field is asset data
+				if ( mReadHeaderOnly && mFrames.size( ) == 2 && ( f.mKey.compare( "Properties" ) == 0 || f.mKey.compare( "Data" ) == 0 || f.mKey.compare( "Entities" ) == 0 ) )
+				{
+					mHasReadHeader = true;
+					return false;
+				}
+
+
+				if ( f.mType == JSONFrameType::Properties && f.mObject )
+				{
+					f.mProperty = f.mObject->Class( )->GetPropertyByName( f.mKey );
+				}
+
+				return true;
+			}
+
+			//========================================================================
+
+			bool Scalar( const JSONScalar& v )
+			{
+				JSONReadFrame& f = mFrames.back( );
+
+				switch ( f.mType )
+				{
+					default: break;
+
+					case JSONFrameType::Object:
+					{
+						// Header fields of assets sit alongside their class. A file holding a different class than the asset being read into is rejected.
+						if ( mHeader && mFrames.size( ) == 2 && ApplyAssetHeaderField( mHeader, f.mKey, v ) )
+						{
+							if ( f.mKey.compare( "Class" ) == 0 && f.mObject && f.mObject->Class( ) != mHeader->mClass )
+							{
+								return false;
+							}
+						}
+
+						if ( f.mKey.compare( "Class" ) == 0 )
+						{
+							ConstructFrameObject( f, Object::GetClass( v.mString ) );
+						}
+						// Object handles its own serialization, so decode and hand off its binary data
+						else if ( f.mKey.compare( "Data" ) == 0 && f.mObject )
+						{
+							ByteBuffer data;
+							Base64Decode( v.mString, &data );
+							f.mObject->DeserializeData( &data );
+						}
+					} break;
+
+					case JSONFrameType::Properties:
+					{
+						ApplyScalar( f.mObject, f.mProperty, v );
+					} break;
+
+					case JSONFrameType::Values:
+					{
+						f.mValues.push_back( v.mNumber );
+					} break;
+
+					case JSONFrameType::Array:
+					{
+						ApplyArrayElement( f.mObject, f.mProperty, f.mIndex++, v );
+					} break;
+
+					case JSONFrameType::MapPair:
+					{
+						if ( !f.mHasPairKey )
+						{
+							f.mPairKey = v;
+							f.mHasPairKey = true;
+						}
+						else
+						{
+							ApplyMapValue( f.mObject, f.mProperty, f.mPairKey, v );
+						}
+					} break;
+
+					case JSONFrameType::Entity:
+					{
+						if ( !v.mIsNull )
+						{
+							JSONArchiver::ApplyEntityField( f.mEntity, f.mKey, v.mString );
+						}
+					} break;
+				}
+
+				return true;
+			}
+
+			//========================================================================
+
+			bool StartObject( )
+			{
+				JSONReadFrame& f = mFrames.back( );
+				JSONReadFrame next;
+
+				switch ( f.mType )
+				{
+					default: break;
+
+					case JSONFrameType::Root:
+					{
+						// Entity files only hold the entity list
+						next.mType = JSONFrameType::Object;
+						if ( mReadRootObject )
+						{
+							next.mObject = mRootObject;
+							next.mConstruct = [ this ] ( const MetaClass* cls ) { mRootObject = cls->Construct( ); return mRootObject; };
+						}
+					} break;
+
+					case JSONFrameType::Object:
+					{
+						if ( f.mObject && f.mKey.compare( "Properties" ) == 0 )
+						{
+							next.mType = JSONFrameType::Properties;
+							next.mObject = f.mObject;
+						}
+					} break;
+
+					case JSONFrameType::Properties:
+					{
+						if ( f.mObject && f.mProperty )
+						{
+							PushPropertyObject( f, next );
+						}
+					} break;
+
+					case JSONFrameType::Array:
+					{
+						// Arrays of object pointers construct each element from its class
+						const MetaPropertyArrayBase* base = f.mProperty->Cast< MetaPropertyArrayBase >( );
+						if ( base->GetArrayType( ) == MetaPropertyType::Object )
+						{
+							Object* owner = f.mObject;
+							u32 index = f.mIndex++;
+							next.mType = JSONFrameType::Object;
+							next.mConstruct = [ owner, base, index ] ( const MetaClass* cls ) -> Object*
+							{
+								if ( !PrepareArrayIndex( owner, base, index ) )
+								{
+									return nullptr;
+								}
+
+								Object* obj = cls->Construct( );
+								base->Cast< MetaPropertyArray< Object* > >( )->SetValueAt( owner, index, obj );
+								return obj;
+							};
+						}
+					} break;
+
+					case JSONFrameType::MapPair:
+					{
+						if ( f.mHasPairKey )
+						{
+							Object* owner = f.mObject;
+							const MetaProperty* prop = f.mProperty;
+							JSONScalar key = f.mPairKey;
+							next.mType = JSONFrameType::Object;
+							next.mConstruct = [ owner, prop, key ] ( const MetaClass* cls ) -> Object*
+							{
+								Object* obj = cls->Construct( );
+								ApplyMapObject( owner, prop, key, obj );
+								return obj;
+							};
+						}
+					} break;
+
+					case JSONFrameType::Entity:
+					{
+						if ( f.mKey.compare( "Properties" ) == 0 )
+						{
+							next.mType = JSONFrameType::Properties;
+							next.mObject = f.mEntity.Get( );
+						}
+					} break;
+
+					case JSONFrameType::EntityList:
+					{
+						next.mType = JSONFrameType::Entity;
+						next.mEntity = EngineSubsystem( EntityManager )->Allocate( mWorld );
+						next.mOnEntity = f.mOnEntity;
+					} break;
+
+					// Components are added to entity when their class is read
+					case JSONFrameType::ComponentList:
+					{
+						Entity* ent = f.mEntity.Get( );
+						next.mType = JSONFrameType::Object;
+						next.mConstruct = [ ent ] ( const MetaClass* cls ) -> Object*
+						{
+							return ent->HasComponent( cls ) ? ent->GetComponent( cls ) : ent->AddComponent( cls );
+						};
+					} break;
+				}
+
+				mFrames.push_back( next );
+				return true;
+			}
+
+			//========================================================================
+
+			bool EndObject( rapidjson::SizeType memberCount )
+			{
+				JSONReadFrame f = mFrames.back( );
+				mFrames.pop_back( );
+
+				switch ( f.mType )
+				{
+					default: break;
+
+					case JSONFrameType::Object:
+					{
+						// Late init of root asset is left to caller, once its header has been applied
+						if ( f.mObject && !( mHeader && mFrames.size( ) == 1 ) )
+						{
+							f.mObject->DeserializeLateInit( );
+						}
+					} break;
+
+					case JSONFrameType::Entity:
+					{
+						JSONArchiver::FinalizeEntity( f.mEntity );
+						if ( f.mOnEntity )
+						{
+							f.mOnEntity( f.mEntity );
+						}
+					} break;
+				}
+
+				return true;
+			}
+
+			//========================================================================
+
+			bool StartArray( )
+			{
+				JSONReadFrame& f = mFrames.back( );
+				JSONReadFrame next;
+
+				switch ( f.mType )
+				{
+					default: break;
+
+					case JSONFrameType::Object:
+					{
+						// File level entity list
+						if ( mReadEntities && mFrames.size( ) == 2 && f.mKey.compare( "Entities" ) == 0 )
+						{
+							Vector< EntityHandle >* out = mEntitiesOut;
+							next.mType = JSONFrameType::EntityList;
+							next.mOnEntity = [ out ] ( const EntityHandle& e )
+							{
+								if ( out )
+								{
+									out->push_back( e );
+								}
+							};
+						}
+					} break;
+
+					case JSONFrameType::Properties:
+					{
+						if ( !f.mObject || !f.mProperty )
+						{
+							break;
+						}
+
+						MetaPropertyType type = f.mProperty->GetType( );
+						if ( type == MetaPropertyType::Array )
+						{
+							next.mType = JSONFrameType::Array;
+							next.mObject = f.mObject;
+							next.mProperty = f.mProperty;
+
+							// Dynamic arrays are regrown as elements are read
+							const MetaPropertyArrayBase* base = f.mProperty->Cast< MetaPropertyArrayBase >( );
+							if ( base->GetArraySizeType( ) == ArraySizeType::Dynamic )
+							{
+								base->Resize( f.mObject, 0 );
+							}
+						}
+						else if ( type == MetaPropertyType::HashMap )
+						{
+							next.mType = JSONFrameType::MapList;
+							next.mObject = f.mObject;
+							next.mProperty = f.mProperty;
+						}
+						else if ( IsValuesType( type ) )
+						{
+							Object* owner = f.mObject;
+							const MetaProperty* prop = f.mProperty;
+							next.mType = JSONFrameType::Values;
+							next.mOnValues = [ owner, prop ] ( const Vector< f64 >& v ) { ApplyValues( owner, prop, v ); };
+						}
+					} break;
+
+					case JSONFrameType::MapList:
+					{
+						next.mType = JSONFrameType::MapPair;
+						next.mObject = f.mObject;
+						next.mProperty = f.mProperty;
+					} break;
+
+					case JSONFrameType::Entity:
+					{
+						Entity* ent = f.mEntity.Get( );
+
+						if ( f.mKey.compare( "Transform" ) == 0 )
+						{
+							next.mType = JSONFrameType::Values;
+							next.mOnValues = [ ent ] ( const Vector< f64 >& v )
+							{
+								if ( v.size( ) >= 10 )
+								{
+									Transform t;
+									t.SetPosition( Vec3( ( f32 )v[0], ( f32 )v[1], ( f32 )v[2] ) );
+									t.SetRotation( Quaternion( ( f32 )v[3], ( f32 )v[4], ( f32 )v[5], ( f32 )v[6] ) );
+									t.SetScale( Vec3( ( f32 )v[7], ( f32 )v[8], ( f32 )v[9] ) );
+									ent->SetLocalTransform( t );
+								}
+							};
+						}
+						else if ( f.mKey.compare( "Components" ) == 0 )
+						{
+							next.mType = JSONFrameType::ComponentList;
+							next.mEntity = f.mEntity;
+						}
+						else if ( f.mKey.compare( "Children" ) == 0 )
+						{
+							next.mType = JSONFrameType::EntityList;
+							next.mOnEntity = [ ent ] ( const EntityHandle& child )
+							{
+								Entity* childEnt = child.Get( );
+								if ( childEnt )
+								{
+									// After adding child, local transform will be incorrect
+									Transform localTrans = childEnt->GetLocalTransform( );
+									ent->AddChild( child );
+									childEnt->SetLocalTransform( localTrans );
+								}
+							};
+						}
+					} break;
+				}
+
+				mFrames.push_back( next );
+				return true;
+			}
+
+			//========================================================================
+
+			bool EndArray( rapidjson::SizeType elementCount )
+			{
+				JSONReadFrame f = mFrames.back( );
+				mFrames.pop_back( );
+
+				if ( f.mType == JSONFrameType::Values && f.mOnValues )
+				{
+					f.mOnValues( f.mValues );
+				}
+
+				return true;
+			}
+
+		protected:
+
+			//========================================================================
+
+			void ConstructFrameObject( JSONReadFrame& f, const MetaClass* cls )
+			{
+				// Existing objects are filled in place
+				if ( f.mObject || !cls || !f.mConstruct )
+				{
+					return;
+				}
+
+				f.mObject = f.mConstruct( cls );
+			}
+
+			//========================================================================
+
+			void PushPropertyObject( JSONReadFrame& f, JSONReadFrame& next )
+			{
+				Object* owner = f.mObject;
+				const MetaProperty* prop = f.mProperty;
+				const MetaClass* cls = owner->Class( );
+
+				switch ( prop->GetType( ) )
+				{
+					default: break;
+
+					case MetaPropertyType::Object:
+					{
+						next.mType = JSONFrameType::Object;
+
+						// Pointers are destroyed and reconstructed from their serialized class
+						if ( prop->GetTraits( ).IsPointer( ) )
+						{
+							next.mConstruct = [ owner, prop, cls ] ( const MetaClass* objCls ) -> Object*
+							{
+								const MetaPropertyPointerBase* base = prop->Cast< MetaPropertyPointerBase >( );
+								Object* previous = const_cast< Object* >( base->GetValueAsObject( owner ) );
+								if ( previous )
+								{
+									delete previous;
+								}
+
+								Object* obj = objCls->Construct( );
+								cls->SetValue( owner, prop, obj );
+								return obj;
+							};
+						}
+						else
+						{
+							next.mObject = const_cast< Object* >( cls->GetValueAs< Object >( owner, prop ) );
+						}
+					} break;
+
+					case MetaPropertyType::EntityHandle:
+					{
+						next.mType = JSONFrameType::Entity;
+						next.mEntity = EngineSubsystem( EntityManager )->Allocate( mWorld );
+						next.mOnEntity = [ owner, prop, cls ] ( const EntityHandle& e ) { cls->SetValue( owner, prop, e ); };
+					} break;
+				}
+			}
+
+		private:
+			Vector< JSONReadFrame > mFrames;
+			World* mWorld = nullptr;
+			Object* mRootObject = nullptr;
+			Vector< EntityHandle >* mEntitiesOut = nullptr;
+			AssetHeader* mHeader = nullptr;
+			bool mReadRootObject = false;
+			bool mReadEntities = false;
+			bool mReadHeaderOnly = false;
+			bool mHasReadHeader = false;
+	};
+
+	//============================================================================================
+
+	void JSONArchiver::ApplyEntityField( const EntityHandle& entity, const String& field, const String& value )
+	{
+		EntityManager* em = EngineSubsystem( EntityManager );
+		AssetManager* am = EngineSubsystem( AssetManager );
+		Entity* ent = entity.Get( );
+
+		if ( !ent )
+		{
+			return;
+		}
+
+		if ( field.compare( "UUID" ) == 0 )
+		{
+			// Remove from uuid map before setting uuid
+			em->RemoveFromUUIDMap( ent );
+			ent->SetUUID( UUID( value ) );
+		}
+		else if ( field.compare( "Name" ) == 0 )
+		{
+			ent->SetName( value );
+		}
+		else if ( field.compare( "Archetype" ) == 0 )
+		{
+			ent->SetArchetype( am->GetAsset< Archetype >( UUID( value ) ) );
+		}
+		else if ( field.compare( "Prototype" ) == 0 )
+		{
+			ent->SetPrototypeEntity( em->GetEntityByUUID( UUID( value ) ) );
+		}
+	}
+
+	//============================================================================================
+
+	void JSONArchiver::FinalizeEntity( const EntityHandle& entity )
+	{
+		AssetManager* am = EngineSubsystem( AssetManager );
+		Entity* ent = entity.Get( );
+		if ( !ent )
+		{
+			return;
+		}
+
+		// If archetype is default, remove the archetype and then set the id to invalid
+		if ( ent->GetArchetype( ) == am->GetDefaultAsset< Archetype >( ) || !ent->GetArchetype( ) )
+		{
+			ent->SetArchetype( nullptr );
+			ent->SetPrototypeEntity( EntityHandle::Invalid( ) );
+		}
+
+		// If prototype entity, then record all property overrides and then attempt merge
+		if ( ent->HasPrototypeEntity( ) )
+		{
+			Entity* proto = ent->GetPrototypeEntity( ).Get( );
+			ObjectArchiver::ClearAllPropertyOverrides( ent );
+			ObjectArchiver::RecordAllPropertyOverrides( proto, ent );
+			ObjectArchiver::MergeObjects( proto, ent, MergeType::AcceptMerge );
+		}
+	}
+
+	//============================================================================================
+
+	INTERNAL Result ParseFile( const String& filePath, JSONReadHandler* handler )
+	{
+		FILE* file = fopen( filePath.c_str( ), "rb" );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		char streamBuffer[ JSON_STREAM_BUFFER_SIZE ];
+		rapidjson::FileReadStream stream( file, streamBuffer, sizeof( streamBuffer ) );
+		rapidjson::Reader reader;
+		rapidjson::ParseResult res = reader.Parse< rapidjson::kParseNanAndInfFlag >( stream, *handler );
+
+		fclose( file );
+
+		return res.IsError( ) ? Result::FAILURE : Result::SUCCESS;
+	}
+
+	//============================================================================================
+
+	INTERNAL rapidjson::ParseResult ParseMemory( const u8* data, usize size, JSONReadHandler* handler )
+	{
+		rapidjson::MemoryStream stream( ( const char* )data, size );
+		rapidjson::Reader reader;
+		return reader.Parse< rapidjson::kParseNanAndInfFlag >( stream, *handler );
+	}
+
+	//============================================================================================
+
+	Object* JSONArchiver::Deserialize( const String& filePath )
+	{
+		JSONReadHandler handler( Engine::GetInstance( )->GetWorld( ) );
+		handler.ReadObject( nullptr );
+
+		if ( ParseFile( filePath, &handler ) != Result::SUCCESS )
+		{
+			return nullptr;
+		}
+
+		return handler.GetRootObject( );
+	}
+
+	//============================================================================================
+
+	Result JSONArchiver::Deserialize( const String& filePath, Object* object )
+	{
+		if ( !object )
+		{
+			return Result::FAILURE;
+		}
+
+		JSONReadHandler handler( Engine::GetInstance( )->GetWorld( ) );
+		handler.ReadObject( object );
+
+		return ParseFile( filePath, &handler );
+	}
+
+	//============================================================================================
+
+	Result JSONArchiver::DeserializeEntities( const String& filePath, World* world, Vector< EntityHandle >* out )
+	{
+		JSONReadHandler handler( world ? world : Engine::GetInstance( )->GetWorld( ) );
+		handler.ReadEntities( out );
+
+		return ParseFile( filePath, &handler );
+	}
+
+	//============================================================================================
+
+	Result JSONArchiver::DeserializeAsset( const ByteBuffer* buffer, Asset** asset, AssetHeader* header )
+	{
+		if ( !buffer || !asset || !header )
+		{
+			return Result::FAILURE;
+		}
+
+		JSONReadHandler handler( Engine::GetInstance( )->GetWorld( ) );
+		handler.ReadAsset( *asset, header );
+
+		rapidjson::ParseResult res = ParseMemory( buffer->GetData( ), buffer->GetSize( ), &handler );
+
+		// Set even on failure, so caller can free an asset that was constructed
+		*asset = ( Asset* )handler.GetRootObject( );
+
+		return ( res.IsError( ) || !*asset ) ? Result::FAILURE : Result::SUCCESS;
+	}
+
+	//============================================================================================
+
+	Result JSONArchiver::ReadAssetHeader( const u8* data, usize size, AssetHeader* header )
+	{
+		if ( !data || !header )
+		{
+			return Result::FAILURE;
+		}
+
+		JSONReadHandler handler( nullptr );
+		handler.ReadAssetHeader( header );
+
+		// Parsing is cut short by handler once data is reached, so only an incomplete header is an error
+		ParseMemory( data, size, &handler );
+
+		return ( handler.HasReadHeader( ) && header->mClass ) ? Result::SUCCESS : Result::FAILURE;
+	}
+
+	//============================================================================================
+
+	bool JSONArchiver::IsAssetText( const u8* data, usize size )
+	{
+		// Binary asset files begin with the length of their class name, which would have to be 123 characters to look like this
+		return ( data && size && data[ 0 ] == '{' );
+	}
+
+	//============================================================================================
+}
@@ -0,0 +1,213 @@
+// @file LZCompression.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Serialize/LZCompression.h"
+
+#include <string.h>
+
+// Minimum match length encodable by a sequence
+#define LZ_MIN_MATCH			4
+// Last match must start at least this many bytes before end of input
+#define LZ_MATCH_LIMIT			12
+// Last bytes of input are always written as literals
+#define LZ_LAST_LITERALS		5
+#define LZ_MAX_OFFSET			65535
+#define LZ_HASH_BITS			14
+
+namespace Enjon
+{
+	//=================================================================
+
+	INTERNAL inline u32 LZRead32( const u8* p )
+	{
+		u32 v;
+		memcpy( &v, p, sizeof( u32 ) );
+		return v;
+	}
+
+	//=================================================================
+
+	INTERNAL inline u32 LZHash( u32 seq )
+	{
+		return ( seq * 2654435761u ) >> ( 32 - LZ_HASH_BITS );
+	}
+
+	//=================================================================
+
+	// Writes 255 continuation bytes for lengths that overflow a token nibble. Returns false if out of space.
+	INTERNAL inline bool LZWriteLength( u32 len, u8* dst, u32& op, u32 dstCapacity )
+	{
+		while ( len >= 255 )
+		{
+			if ( op >= dstCapacity ) return false;
+			dst[ op++ ] = 255;
+			len -= 255;
+		}
+
+		if ( op >= dstCapacity ) return false;
+		dst[ op++ ] = ( u8 )len;
+		return true;
+	}
+
+	//=================================================================
+
+	u32 LZCompression::GetMaxCompressedSize( u32 srcSize )
+	{
+		return srcSize + ( srcSize / 255 ) + 16;
+	}
+
+	//=================================================================
+
+	u32 LZCompression::Compress( const u8* src, u32 srcSize, u8* dst, u32 dstCapacity )
+	{
+		// Table holds position + 1 of last occurrence of each hashed sequence, 0 when empty
+		u32 table[ 1 << LZ_HASH_BITS ];
+		memset( table, 0, sizeof( table ) );
+
+		u32 ip = 0;
+		u32 anchor = 0;
+		u32 op = 0;
+		u32 misses = 0;
+
+		while ( srcSize >= LZ_MATCH_LIMIT && ip <= srcSize - LZ_MATCH_LIMIT )
+		{
+			u32 seq = LZRead32( src + ip );
+			u32 h = LZHash( seq );
+			u32 ref = table[ h ];
+			table[ h ] = ip + 1;
+
+			// No usable match, so step forward. Step grows the longer we go without a match to move through incompressible data quickly.
+			if ( !ref || ip - ( ref - 1 ) > LZ_MAX_OFFSET || LZRead32( src + ref - 1 ) != seq )
+			{
+				ip += 1 + ( misses++ >> 6 );
+				continue;
+			}
+
+			ref -= 1;
+			misses = 0;
+
+			// Extend match forward
+			u32 matchLen = LZ_MIN_MATCH;
+			u32 matchEnd = srcSize - LZ_LAST_LITERALS;
+			while ( ip + matchLen < matchEnd && src[ ip + matchLen ] == src[ ref + matchLen ] )
+			{
+				matchLen++;
+			}
+
+			// Write token
+			u32 litLen = ip - anchor;
+			u32 mlCode = matchLen - LZ_MIN_MATCH;
+			if ( op >= dstCapacity ) return 0;
+			u8* token = dst + op++;
+			*token = ( u8 )( ( ( litLen >= 15 ? 15 : litLen ) << 4 ) | ( mlCode >= 15 ? 15 : mlCode ) );
+
+			// Write literals
+			if ( litLen >= 15 && !LZWriteLength( litLen - 15, dst, op, dstCapacity ) ) return 0;
+			if ( op + litLen + 2 > dstCapacity ) return 0;
+			memcpy( dst + op, src + anchor, litLen );
+			op += litLen;
+
+			// Write offset
+			u32 offset = ip - ref;
+			dst[ op++ ] = ( u8 )( offset & 0xFF );
+			dst[ op++ ] = ( u8 )( offset >> 8 );
+
+			// Write remaining match length
+			if ( mlCode >= 15 && !LZWriteLength( mlCode - 15, dst, op, dstCapacity ) ) return 0;
+
+			ip += matchLen;
+			anchor = ip;
+		}
+
+		// Write last literals
+		u32 litLen = srcSize - anchor;
+		if ( op >= dstCapacity ) return 0;
+		dst[ op++ ] = ( u8 )( ( litLen >= 15 ? 15 : litLen ) << 4 );
+		if ( litLen >= 15 && !LZWriteLength( litLen - 15, dst, op, dstCapacity ) ) return 0;
+		if ( op + litLen > dstCapacity ) return 0;
+		memcpy( dst + op, src + anchor, litLen );
+		op += litLen;
+
+		return op;
+	}
+
+	//=================================================================
+
+	bool LZCompression::Decompress( const u8* src, u32 srcSize, u8* dst, u32 dstSize )
+	{
+		u32 ip = 0;
+		u32 op = 0;
+
+		while ( ip < srcSize )
+		{
+			u8 token = src[ ip++ ];
+
+			// Literal length
+			u32 litLen = token >> 4;
+			if ( litLen == 15 )
+			{
+				u8 b;
+				do
+				{
+					if ( ip >= srcSize ) return false;
+					b = src[ ip++ ];
+					litLen += b;
+				} while ( b == 255 );
+			}
+
+			// Copy literals
+			if ( ip + litLen > srcSize || op + litLen > dstSize ) return false;
+			memcpy( dst + op, src + ip, litLen );
+			ip += litLen;
+			op += litLen;
+
+			// Last sequence only holds literals
+			if ( ip >= srcSize )
+			{
+				break;
+			}
+
+			// Match offset
+			if ( ip + 2 > srcSize ) return false;
+			u32 offset = ( u32 )src[ ip ] | ( ( u32 )src[ ip + 1 ] << 8 );
+			ip += 2;
+			if ( offset == 0 || offset > op ) return false;
+
+			// Match length
+			u32 matchLen = token & 15;
+			if ( matchLen == 15 )
+			{
+				u8 b;
+				do
+				{
+					if ( ip >= srcSize ) return false;
+					b = src[ ip++ ];
+					matchLen += b;
+				} while ( b == 255 );
+			}
+			matchLen += LZ_MIN_MATCH;
+
+			if ( op + matchLen > dstSize ) return false;
+
+			// Copy match. Overlapping matches have to be copied forward byte by byte.
+			u8* out = dst + op;
+			const u8* match = out - offset;
+			if ( offset >= matchLen )
+			{
+				memcpy( out, match, matchLen );
+			}
+			else
+			{
+				for ( u32 i = 0; i < matchLen; ++i )
+				{
+					out[ i ] = match[ i ];
+				}
+			}
+			op += matchLen;
+		}
+
+		return ( op == dstSize );
+	}
+
+	//=================================================================
+}
@@ -536,6 +536,300 @@ namespace Enjon
 
 	//===================================================================== 
 
+	Result ObjectArchiver::Clone( const Object* source, Object* dest )
+	{
+		if ( !source || !dest )
+		{
+			return Result::FAILURE;
+		}
+
+		const MetaClass* cls = source->Class( );
+
+		// Can't clone between separate types
+		if ( !cls || cls != dest->Class( ) )
+		{
+			return Result::FAILURE;
+		}
+
+		// Attempt object specific cloning first
+		Result res = dest->CloneData( source );
+
+		// Default cloning if object doesn't handle its own
+		if ( res == Result::INCOMPLETE )
+		{
+			res = CloneObjectDataDefault( source, dest, cls );
+		}
+
+		return res;
+	}
+
+	//===================================================================== 
+
+	Object* ObjectArchiver::Clone( const Object* source )
+	{
+		if ( !source || !source->Class( ) )
+		{
+			return nullptr;
+		}
+
+		// Construct new object based on class
+		Object* object = source->Class( )->Construct( );
+		if ( !object )
+		{
+			return nullptr;
+		}
+
+		// Delete object if not cloned correctly
+		if ( Clone( source, object ) != Result::SUCCESS )
+		{
+			delete object;
+			return nullptr;
+		}
+
+		// Same as after deserializing
+		object->DeserializeLateInit( );
+
+		return object;
+	}
+
+	//===================================================================== 
+
+	Result ObjectArchiver::CloneObjectDataDefault( const Object* source, Object* dest, const MetaClass* cls )
+	{
+		for ( u32 i = 0; i < cls->GetPropertyCount( ); ++i )
+		{
+			const MetaProperty* prop = cls->GetProperty( i );
+
+			// Only clone what would have been serialized
+			if ( !prop || prop->HasFlags( MetaPropertyFlags::NonSerializeable ) )
+			{
+				continue;
+			}
+
+			CloneProperty( source, dest, prop );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//===================================================================== 
+
+#define ENJON_CLONE_PROP_POD( cls, source, dest, prop, podType )\
+{\
+	cls->SetValue( dest, prop, *cls->GetValueAs< podType >( source, prop ) );\
+}
+
+#define ENJON_CLONE_ARRAY_PROP_POD( source, dest, prop, podType )\
+{\
+	const MetaPropertyArray< podType >* arrProp = prop->Cast< MetaPropertyArray< podType > >( );\
+	for ( usize j = 0; j < arrProp->GetSize( source ); ++j )\
+	{\
+		arrProp->SetValueAt( dest, j, arrProp->GetValueAs( source, j ) );\
+	}\
+}
+
+#define ENJON_CLONE_MAP_PROP_POD( cls, source, dest, prop, keyType, valType )\
+{\
+	cls->SetValue( dest, prop, *cls->GetValueAs< HashMap< keyType, valType > >( source, prop ) );\
+}
+
+#define ENJON_CLONE_MAP_PROP_OBJECT( cls, source, dest, prop, keyType )\
+{\
+	const MetaPropertyHashMap< keyType, Object* >* mapProp = prop->Cast< MetaPropertyHashMap< keyType, Object* > >( );\
+	HashMap< keyType, Object* > cloned;\
+	for ( auto iter = mapProp->Begin( source ); iter != mapProp->End( source ); ++iter )\
+	{\
+		cloned[ iter->first ] = ObjectArchiver::Clone( iter->second );\
+	}\
+	/*Destination owns the objects it held, which are replaced*/\
+	for ( auto iter = mapProp->Begin( dest ); iter != mapProp->End( dest ); ++iter )\
+	{\
+		delete iter->second;\
+	}\
+	cls->SetValue( dest, prop, cloned );\
+}
+
+	Result ObjectArchiver::CloneProperty( const Object* source, Object* dest, const MetaProperty* prop )
+	{
+		const MetaClass* cls = source->Class( );
+
+		switch ( prop->GetType( ) )
+		{
+			default: break;
+			case MetaPropertyType::Bool:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, bool ); break;
+			case MetaPropertyType::U8:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, u8 ); break;
+			case MetaPropertyType::U16:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, u16 ); break;
+			case MetaPropertyType::U32:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, u32 ); break;
+			case MetaPropertyType::U64:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, u64 ); break;
+			case MetaPropertyType::S8:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, s8 ); break;
+			case MetaPropertyType::S16:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, s16 ); break;
+			case MetaPropertyType::S32:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, s32 ); break;
+			case MetaPropertyType::S64:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, s64 ); break;
+			case MetaPropertyType::F32:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, f32 ); break;
+			case MetaPropertyType::F64:			ENJON_CLONE_PROP_POD( cls, source, dest, prop, f64 ); break;
+			case MetaPropertyType::Enum:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, s32 ); break;
+			case MetaPropertyType::String:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, String ); break;
+			case MetaPropertyType::UUID:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, UUID ); break;
+			case MetaPropertyType::iVec3:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, iVec3 ); break;
+			case MetaPropertyType::Vec2:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, Vec2 ); break;
+			case MetaPropertyType::Vec3:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, Vec3 ); break;
+			case MetaPropertyType::Vec4:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, Vec4 ); break;
+			case MetaPropertyType::Quat:		ENJON_CLONE_PROP_POD( cls, source, dest, prop, Quaternion ); break;
+			case MetaPropertyType::Transform:	ENJON_CLONE_PROP_POD( cls, source, dest, prop, Transform ); break;
+			case MetaPropertyType::ColorRGBA32:	ENJON_CLONE_PROP_POD( cls, source, dest, prop, ColorRGBA32 ); break;
+
+			// Assets are shared, so only the handle is copied
+			case MetaPropertyType::AssetHandle:
+			{
+				AssetHandle< Asset > val;
+				cls->GetValue( source, prop, &val );
+				cls->SetValue( dest, prop, val );
+			} break;
+
+			// Serialized entity handles are written out as whole entities, so clone the entity as well
+			case MetaPropertyType::EntityHandle:
+			{
+				EntityHandle handle = *cls->GetValueAs< EntityHandle >( source, prop );
+				cls->SetValue( dest, prop, EntityArchiver::Clone( handle, Engine::GetInstance( )->GetWorld( ) ) );
+			} break;
+
+			case MetaPropertyType::Object:
+			{
+				if ( prop->GetTraits( ).IsPointer( ) )
+				{
+					const MetaPropertyPointerBase* base = prop->Cast< MetaPropertyPointerBase >( );
+					const Object* sourceObj = base->GetValueAsObject( source );
+					Object* destObj = const_cast< Object* >( base->GetValueAsObject( dest ) );
+
+					// Reuse destination object if it's the same type, otherwise replace it
+					if ( sourceObj && destObj && sourceObj->Class( ) == destObj->Class( ) )
+					{
+						Clone( sourceObj, destObj );
+					}
+					else
+					{
+						if ( destObj )
+						{
+							delete destObj;
+						}
+
+						cls->SetValue( dest, prop, Clone( sourceObj ) );
+					}
+				}
+				else
+				{
+					const Object* sourceObj = cls->GetValueAs< Object >( source, prop );
+					Object* destObj = cls->GetValueAs< Object >( dest, prop )->ConstCast< Object >( );
+					Clone( sourceObj, destObj );
+				}
+			} break;
+
+			case MetaPropertyType::Array:
+			{
+				const MetaPropertyArrayBase* base = prop->Cast< MetaPropertyArrayBase >( );
+				const MetaPropertyArray< Object* >* objArrProp = base->GetArrayType( ) == MetaPropertyType::Object ? base->Cast< MetaPropertyArray< Object* > >( ) : nullptr;
+
+				// Dynamic arrays need to match source size before elements can be set
+				if ( base->GetArraySizeType( ) == ArraySizeType::Dynamic )
+				{
+					// Objects held past the end of the source would be dropped by resizing, so free them first
+					if ( objArrProp )
+					{
+						for ( usize j = base->GetSize( source ); j < base->GetSize( dest ); ++j )
+						{
+							delete objArrProp->GetValueAs( dest, j );
+							objArrProp->SetValueAt( dest, j, nullptr );
+						}
+					}
+
+					base->Resize( dest, base->GetSize( source ) );
+				}
+
+				switch ( base->GetArrayType( ) )
+				{
+					default: break;
+					case MetaPropertyType::Bool:		ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, bool ) break;
+					case MetaPropertyType::U8:			ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, u8 ) break;
+					case MetaPropertyType::U32:			ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, u32 ) break;
+					case MetaPropertyType::S32:			ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, s32 ) break;
+					case MetaPropertyType::F32:			ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, f32 ) break;
+					case MetaPropertyType::F64:			ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, f64 ) break;
+					case MetaPropertyType::String:		ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, String ) break;
+					case MetaPropertyType::UUID:		ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, UUID ) break;
+					case MetaPropertyType::AssetHandle:	ENJON_CLONE_ARRAY_PROP_POD( source, dest, base, AssetHandle< Asset > ) break;
+
+					case MetaPropertyType::Object:
+					{
+						if ( objArrProp )
+						{
+							for ( usize j = 0; j < objArrProp->GetSize( source ); ++j )
+							{
+								const Object* sourceObj = objArrProp->GetValueAs( source, j );
+								Object* destObj = objArrProp->GetValueAs( dest, j );
+
+								// Reuse destination object if it's the same type, otherwise replace it
+								if ( sourceObj && destObj && sourceObj->Class( ) == destObj->Class( ) )
+								{
+									Clone( sourceObj, destObj );
+								}
+								else
+								{
+									delete destObj;
+									objArrProp->SetValueAt( dest, j, Clone( sourceObj ) );
+								}
+							}
+						}
+					} break;
+				}
+			} break;
+
+			case MetaPropertyType::HashMap:
+			{
+				const MetaPropertyHashMapBase* base = prop->Cast< MetaPropertyHashMapBase >( );
+
+				switch ( base->GetKeyType( ) )
+				{
+					default: break;
+
+					case MetaPropertyType::U32:
+					{
+						switch ( base->GetValueType( ) )
+						{
+							default: break;
+							case MetaPropertyType::U32:		ENJON_CLONE_MAP_PROP_POD( cls, source, dest, prop, u32, u32 ) break;
+							case MetaPropertyType::S32:		ENJON_CLONE_MAP_PROP_POD( cls, source, dest, prop, u32, s32 ) break;
+							case MetaPropertyType::F32:		ENJON_CLONE_MAP_PROP_POD( cls, source, dest, prop, u32, f32 ) break;
+						}
+					} break;
+
+					case MetaPropertyType::String:
+					{
+						switch ( base->GetValueType( ) )
+						{
+							default: break;
+							case MetaPropertyType::U32:		ENJON_CLONE_MAP_PROP_POD( cls, source, dest, prop, String, u32 ) break;
+							case MetaPropertyType::Object:	ENJON_CLONE_MAP_PROP_OBJECT( cls, source, dest, base, String ) break;
+						}
+					} break;
+
+					case MetaPropertyType::Enum:
+					{
+						switch ( base->GetValueType( ) )
+						{
+							default: break;
+							case MetaPropertyType::String:	ENJON_CLONE_MAP_PROP_POD( cls, source, dest, prop, s32, String ) break;
+							case MetaPropertyType::Object:	ENJON_CLONE_MAP_PROP_OBJECT( cls, source, dest, base, s32 ) break;
+						}
+					} break;
+				}
+			} break;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//===================================================================== 
+
 	bool ObjectArchiver::HasPropertyOverrides( const Object* obj )
 	{
 		bool hasOverrides = false;
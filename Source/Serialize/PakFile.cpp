@@ -0,0 +1,363 @@
+// @file PakFile.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "Serialize/PakFile.h"
+#include "Serialize/BlockCompressedFile.h"
+
+#include <fstream>
+#include <algorithm>
+#include <string.h>
+
+#ifdef ENJON_SYSTEM_WINDOWS
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+// Magic, version, alignment, entry count, then 64 bit offset and size of table of contents
+#define ENJON_PAK_HEADER_SIZE		( 4 * sizeof( u32 ) + 2 * sizeof( u64 ) )
+
+namespace Enjon
+{
+	//=================================================================
+
+	// Bounds checked reads over mapped bytes, since archive may be truncated or stale
+	struct PakReader
+	{
+		const u8* mData;
+		usize mSize;
+		usize mPosition;
+
+		template < typename T >
+		bool Read( T* val )
+		{
+			if ( mPosition + sizeof( T ) > mSize )
+			{
+				return false;
+			}
+			memcpy( val, mData + mPosition, sizeof( T ) );
+			mPosition += sizeof( T );
+			return true;
+		}
+
+		bool ReadString( String* val )
+		{
+			u32 size = 0;
+			if ( !Read< u32 >( &size ) || mPosition + size > mSize )
+			{
+				return false;
+			}
+			val->assign( ( const char* )( mData + mPosition ), size );
+			mPosition += size;
+			return true;
+		}
+	};
+
+	//=================================================================
+
+	INTERNAL inline u64 AlignOffset( u64 offset, u32 alignment )
+	{
+		return ( offset + alignment - 1 ) / alignment * alignment;
+	}
+
+	//=================================================================
+
+	INTERNAL void WritePadding( std::ofstream& file, u64 from, u64 to )
+	{
+		static const char zeros[ 256 ] = { 0 };
+		while ( from < to )
+		{
+			u64 count = std::min< u64 >( to - from, sizeof( zeros ) );
+			file.write( zeros, ( std::streamsize )count );
+			from += count;
+		}
+	}
+
+	//=================================================================
+
+	PakFile::~PakFile( )
+	{
+		Unmount( );
+	}
+
+	//=================================================================
+
+	Result PakFile::Build( const String& pakPath, const String& rootDirectory, const Vector< PakEntry >& entries, u32 alignment )
+	{
+		alignment = alignment ? alignment : ENJON_PAK_DEFAULT_ALIGNMENT;
+
+		// Sorted once here so mounting can binary search without sorting
+		Vector< PakEntry > sorted = entries;
+		std::sort( sorted.begin( ), sorted.end( ), [ ] ( const PakEntry& a, const PakEntry& b )
+		{
+			return a.mUUID < b.mUUID;
+		} );
+		sorted.erase( std::unique( sorted.begin( ), sorted.end( ), [ ] ( const PakEntry& a, const PakEntry& b )
+		{
+			return a.mUUID == b.mUUID;
+		} ), sorted.end( ) );
+
+		std::ofstream file( pakPath, std::ios::out | std::ios::binary | std::ios::trunc );
+		if ( !file )
+		{
+			return Result::FAILURE;
+		}
+
+		// Header is rewritten once table of contents has been placed
+		u64 position = AlignOffset( ENJON_PAK_HEADER_SIZE, alignment );
+		WritePadding( file, 0, position );
+
+		Vector< PakEntry > written;
+		written.reserve( sorted.size( ) );
+		Vector< char > contents;
+		for ( PakEntry& entry : sorted )
+		{
+			// Files are stored exactly as cached, block compressed ones stay compressed
+			std::ifstream source( rootDirectory + entry.mFilePath, std::ios::in | std::ios::binary | std::ios::ate );
+			if ( !source )
+			{
+				continue;
+			}
+
+			contents.resize( ( usize )source.tellg( ) );
+			source.seekg( 0, std::ios::beg );
+			source.read( contents.data( ), contents.size( ) );
+			if ( ( usize )source.gcount( ) != contents.size( ) )
+			{
+				continue;
+			}
+
+			u64 offset = AlignOffset( position, alignment );
+			WritePadding( file, position, offset );
+			file.write( contents.data( ), contents.size( ) );
+
+			entry.mOffset = offset;
+			entry.mSize = contents.size( );
+			position = offset + entry.mSize;
+			written.push_back( entry );
+		}
+
+		// Table of contents
+		ByteBuffer toc;
+		for ( const PakEntry& entry : written )
+		{
+			toc.Write< String >( entry.mUUID );
+			toc.Write< String >( entry.mFilePath );
+			toc.Write< String >( entry.mAssetName );
+			toc.Write< String >( entry.mLoaderClassName );
+			toc.Write< String >( entry.mAssetClassName );
+			toc.Write< u64 >( entry.mOffset );
+			toc.Write< u64 >( entry.mSize );
+		}
+
+		u64 tocOffset = AlignOffset( position, alignment );
+		WritePadding( file, position, tocOffset );
+		file.write( ( const char* )toc.GetData( ), toc.GetSize( ) );
+
+		// Header
+		u32 header32[ 4 ] = { ENJON_PAK_FILE_MAGIC, ENJON_PAK_FILE_VERSION, alignment, ( u32 )written.size( ) };
+		u64 header64[ 2 ] = { tocOffset, ( u64 )toc.GetSize( ) };
+		file.seekp( 0, std::ios::beg );
+		file.write( ( const char* )header32, sizeof( header32 ) );
+		file.write( ( const char* )header64, sizeof( header64 ) );
+
+		return file.good( ) ? Result::SUCCESS : Result::FAILURE;
+	}
+
+	//=================================================================
+
+	Result PakFile::Mount( const String& pakPath )
+	{
+		Unmount( );
+
+#ifdef ENJON_SYSTEM_WINDOWS
+		HANDLE file = CreateFileA( pakPath.c_str( ), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+		if ( file == INVALID_HANDLE_VALUE )
+		{
+			return Result::FAILURE;
+		}
+
+		LARGE_INTEGER size;
+		HANDLE mapping = GetFileSizeEx( file, &size ) && size.QuadPart ? CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr ) : nullptr;
+		void* view = mapping ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+
+		// View keeps mapping alive on its own
+		if ( mapping )
+		{
+			CloseHandle( mapping );
+		}
+		CloseHandle( file );
+
+		if ( !view )
+		{
+			return Result::FAILURE;
+		}
+
+		mSize = ( usize )size.QuadPart;
+#else
+		s32 file = open( pakPath.c_str( ), O_RDONLY );
+		if ( file < 0 )
+		{
+			return Result::FAILURE;
+		}
+
+		struct stat info;
+		void* view = ( fstat( file, &info ) == 0 && info.st_size ) ? mmap( nullptr, ( usize )info.st_size, PROT_READ, MAP_PRIVATE, file, 0 ) : MAP_FAILED;
+
+		// Mapping stays valid after descriptor is closed
+		close( file );
+
+		if ( view == MAP_FAILED )
+		{
+			return Result::FAILURE;
+		}
+
+		mSize = ( usize )info.st_size;
+#endif
+
+		mData = ( const u8* )view;
+		mFilePath = pakPath;
+
+		if ( ReadTableOfContents( ) != Result::SUCCESS )
+		{
+			Unmount( );
+			return Result::FAILURE;
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	void PakFile::Unmount( )
+	{
+		if ( mData )
+		{
+#ifdef ENJON_SYSTEM_WINDOWS
+			UnmapViewOfFile( mData );
+#else
+			munmap( ( void* )mData, mSize );
+#endif
+		}
+
+		mData = nullptr;
+		mSize = 0;
+		mFilePath = "";
+		mEntries.clear( );
+	}
+
+	//=================================================================
+
+	bool PakFile::IsMounted( ) const
+	{
+		return ( mData != nullptr );
+	}
+
+	//=================================================================
+
+	const String& PakFile::GetFilePath( ) const
+	{
+		return mFilePath;
+	}
+
+	//=================================================================
+
+	const Vector< PakEntry >& PakFile::GetEntries( ) const
+	{
+		return mEntries;
+	}
+
+	//=================================================================
+
+	Result PakFile::ReadTableOfContents( )
+	{
+		PakReader header = { mData, mSize, 0 };
+		u32 magic = 0, version = 0, alignment = 0, entryCount = 0;
+		u64 tocOffset = 0, tocSize = 0;
+		if ( !header.Read< u32 >( &magic ) || !header.Read< u32 >( &version ) || !header.Read< u32 >( &alignment ) ||
+			!header.Read< u32 >( &entryCount ) || !header.Read< u64 >( &tocOffset ) || !header.Read< u64 >( &tocSize ) )
+		{
+			return Result::FAILURE;
+		}
+
+		if ( magic != ENJON_PAK_FILE_MAGIC || version != ENJON_PAK_FILE_VERSION || tocOffset > mSize || tocSize > mSize - tocOffset )
+		{
+			return Result::FAILURE;
+		}
+
+		PakReader reader = { mData + tocOffset, ( usize )tocSize, 0 };
+		mEntries.resize( entryCount );
+		for ( PakEntry& entry : mEntries )
+		{
+			if ( !reader.ReadString( &entry.mUUID ) ||
+				!reader.ReadString( &entry.mFilePath ) ||
+				!reader.ReadString( &entry.mAssetName ) ||
+				!reader.ReadString( &entry.mLoaderClassName ) ||
+				!reader.ReadString( &entry.mAssetClassName ) ||
+				!reader.Read< u64 >( &entry.mOffset ) ||
+				!reader.Read< u64 >( &entry.mSize ) )
+			{
+				return Result::FAILURE;
+			}
+
+			// Every entry must lie within data section, so reads never have to check again
+			if ( entry.mOffset > tocOffset || entry.mSize > tocOffset - entry.mOffset )
+			{
+				return Result::FAILURE;
+			}
+		}
+
+		// Lookups rely on order, which only the builder guarantees
+		for ( usize i = 1; i < mEntries.size( ); ++i )
+		{
+			if ( !( mEntries[ i - 1 ].mUUID < mEntries[ i ].mUUID ) )
+			{
+				return Result::FAILURE;
+			}
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//=================================================================
+
+	const PakEntry* PakFile::Find( const UUID& uuid ) const
+	{
+		String key = uuid.ToString( );
+		auto query = std::lower_bound( mEntries.begin( ), mEntries.end( ), key, [ ] ( const PakEntry& entry, const String& k )
+		{
+			return entry.mUUID < k;
+		} );
+
+		return ( query != mEntries.end( ) && query->mUUID == key ) ? &( *query ) : nullptr;
+	}
+
+	//=================================================================
+
+	Result PakFile::Read( const PakEntry* entry, ByteBuffer* buffer ) const
+	{
+		if ( !mData || !entry || !buffer )
+		{
+			return Result::FAILURE;
+		}
+
+		return BlockCompressedFile::ReadMemory( mData + entry->mOffset, ( usize )entry->mSize, buffer );
+	}
+
+	//=================================================================
+
+	Result PakFile::ReadRange( const PakEntry* entry, u32 offset, u32 size, u8* out ) const
+	{
+		if ( !mData || !entry )
+		{
+			return Result::FAILURE;
+		}
+
+		return BlockCompressedFile::ReadMemoryRange( mData + entry->mOffset, ( usize )entry->mSize, offset, size, out );
+	}
+
+	//=================================================================
+}
@@ -203,6 +203,26 @@ namespace Enjon
 
 	//====================================================================
 
+	bool UUID::operator<( const UUID &other ) const
+	{
+		return mBytes < other.mBytes;
+	}
+
+	//====================================================================
+
+	usize UUID::Hash( ) const
+	{
+		// FNV-1a
+		u64 hash = 14695981039346656037ull;
+		for ( u8 b : mBytes )
+		{
+			hash = ( hash ^ b ) * 1099511628211ull;
+		}
+		return ( usize )hash;
+	}
+
+	//====================================================================
+
 #ifdef ENJON_SYSTEM_WINDOWS
 	UUID UUID::NewUUID( )
 	{ 
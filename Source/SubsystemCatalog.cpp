@@ -8,6 +8,7 @@
 #include "Graphics/GraphicsSubsystem.h"
 #include "ImGui/ImGuiManager.h"
 #include "IO/InputManager.h"
+#include "System/JobSystem.h"
 
 #include <assert.h>
 
@@ -38,6 +39,9 @@ namespace Enjon
 
 		EngineSubsystem( ImGuiManager )->Shutdown( );
 
+		// Workers shut down last, since other subsystems may still be waiting on jobs
+		EngineSubsystem( JobSystem )->Shutdown( );
+
 		// Delete all subsystems to clear memory
 		// NOTE(): No subsystem should have an explicit destructor! Not safe to do so, since order or shutdown matters!
 		for ( auto& s : mSubsystems ) 
@@ -0,0 +1,222 @@
+// @file JobSystem.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "System/JobSystem.h"
+#include "SubsystemCatalog.h"
+#include "Engine.h"
+
+#include <algorithm>
+
+namespace Enjon
+{
+	//==================================================================
+
+	bool JobGroup::IsComplete( ) const
+	{
+		return ( mPending.load( ) == 0 );
+	}
+
+	//==================================================================
+
+	Result JobSystem::Initialize( )
+	{
+		// Leave a core for the main thread, which also runs jobs while waiting on them
+		u32 hwThreads = std::thread::hardware_concurrency( );
+		u32 workerCount = hwThreads > 1 ? hwThreads - 1 : 1;
+
+		mShuttingDown = false;
+		for ( u32 i = 0; i < workerCount; ++i )
+		{
+			mWorkers.push_back( std::thread( &JobSystem::WorkerLoop, this ) );
+		}
+
+		return Result::SUCCESS;
+	}
+
+	//==================================================================
+
+	void JobSystem::Update( const f32 dT )
+	{
+		// Do nothing...
+	}
+
+	//==================================================================
+
+	Enjon::Result JobSystem::Shutdown( )
+	{
+		{
+			std::lock_guard< std::mutex > lock( mQueueLock );
+			mShuttingDown = true;
+		}
+		mQueueSignal.notify_all( );
+
+		for ( auto& w : mWorkers )
+		{
+			if ( w.joinable( ) )
+			{
+				w.join( );
+			}
+		}
+
+		mWorkers.clear( );
+		mQueue.clear( );
+
+		return Result::SUCCESS;
+	}
+
+	//==================================================================
+
+	void JobSystem::Submit( const Job& job, JobGroup* group )
+	{
+		if ( group )
+		{
+			group->mPending++;
+		}
+
+		// No workers to run job, so run it immediately
+		if ( mWorkers.empty( ) )
+		{
+			job( );
+			if ( group )
+			{
+				group->mPending--;
+			}
+			return;
+		}
+
+		{
+			std::lock_guard< std::mutex > lock( mQueueLock );
+			mQueue.push_back( QueuedJob{ job, group } );
+		}
+		mQueueSignal.notify_one( );
+	}
+
+	//==================================================================
+
+	void JobSystem::Wait( JobGroup* group )
+	{
+		if ( !group )
+		{
+			return;
+		}
+
+		// Help out with remaining work instead of idling
+		while ( !group->IsComplete( ) )
+		{
+			if ( !RunPendingJob( ) )
+			{
+				std::this_thread::yield( );
+			}
+		}
+	}
+
+	//==================================================================
+
+	void JobSystem::ParallelFor( u32 count, const std::function< void( u32 ) >& func, u32 batchSize )
+	{
+		if ( !count )
+		{
+			return;
+		}
+
+		batchSize = batchSize ? batchSize : 1;
+
+		JobGroup group;
+		for ( u32 start = 0; start < count; start += batchSize )
+		{
+			u32 end = std::min( start + batchSize, count );
+			Submit( [ start, end, &func ] ( )
+			{
+				for ( u32 i = start; i < end; ++i )
+				{
+					func( i );
+				}
+			}, &group );
+		}
+
+		Wait( &group );
+	}
+
+	//==================================================================
+
+	void JobSystem::ParallelForOrSerial( u32 count, const std::function< void( u32 ) >& func, u32 batchSize )
+	{
+		Engine* engine = Engine::GetInstance( );
+		if ( engine && engine->GetSubsystemCatalog( ) && count > 1 )
+		{
+			JobSystem* jobs = EngineSubsystem( JobSystem );
+			if ( jobs )
+			{
+				jobs->ParallelFor( count, func, batchSize );
+				return;
+			}
+		}
+
+		for ( u32 i = 0; i < count; ++i )
+		{
+			func( i );
+		}
+	}
+
+	//==================================================================
+
+	u32 JobSystem::GetWorkerCount( ) const
+	{
+		return ( u32 )mWorkers.size( );
+	}
+
+	//==================================================================
+
+	bool JobSystem::RunPendingJob( )
+	{
+		QueuedJob job;
+		{
+			std::lock_guard< std::mutex > lock( mQueueLock );
+			if ( mQueue.empty( ) )
+			{
+				return false;
+			}
+
+			job = std::move( mQueue.front( ) );
+			mQueue.pop_front( );
+		}
+
+		job.mJob( );
+		if ( job.mGroup )
+		{
+			job.mGroup->mPending--;
+		}
+
+		return true;
+	}
+
+	//==================================================================
+
+	void JobSystem::WorkerLoop( )
+	{
+		while ( true )
+		{
+			QueuedJob job;
+			{
+				std::unique_lock< std::mutex > lock( mQueueLock );
+				mQueueSignal.wait( lock, [ this ] ( ) { return mShuttingDown || !mQueue.empty( ); } );
+
+				if ( mShuttingDown && mQueue.empty( ) )
+				{
+					return;
+				}
+
+				job = std::move( mQueue.front( ) );
+				mQueue.pop_front( );
+			}
+
+			job.mJob( );
+			if ( job.mGroup )
+			{
+				job.mGroup->mPending--;
+			}
+		}
+	}
+
+	//==================================================================
+}
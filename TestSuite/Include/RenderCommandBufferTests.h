@@ -0,0 +1,14 @@
+// @file RenderCommandBufferTests.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_RENDER_COMMAND_BUFFER_TESTS_H
+#define ENJON_RENDER_COMMAND_BUFFER_TESTS_H
+
+/*
+* @brief Records gbuffer draws into chunked command buffers and replays them through a null executor, without a
+*			graphics context. Returns whether all checks passed.
+*/
+bool RunRenderCommandBufferTests( );
+
+#endif
@@ -0,0 +1,211 @@
+// @file RenderCommandBufferTests.cpp
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#include "RenderCommandBufferTests.h"
+
+#include <Graphics/RenderCommandBuffer.h>
+
+#include <algorithm>
+#include <iostream>
+
+using namespace Enjon;
+
+namespace
+{
+	// Recording never dereferences what it binds, so draws only need distinct addresses
+	struct FakeDraw
+	{
+		const Shader* mShader;
+		const Material* mMaterial;
+		const Mesh* mMesh;
+		const SubMesh* mSubMesh;
+	};
+
+	/*
+	* @brief Null executor that also keeps the order commands were replayed in
+	*/
+	class OrderedNullRenderCommandExecutor : public NullRenderCommandExecutor
+	{
+		public:
+			Vector< RenderCommandType > mOrder;
+
+		protected:
+			virtual void BindProgram( const Shader* shader ) override
+			{
+				mOrder.push_back( RenderCommandType::BindProgram );
+				NullRenderCommandExecutor::BindProgram( shader );
+			}
+
+			virtual void BindMaterial( const Material* material ) override
+			{
+				mOrder.push_back( RenderCommandType::BindMaterial );
+				NullRenderCommandExecutor::BindMaterial( material );
+			}
+
+			virtual void SetUniform( RenderUniform uniform, f32 value ) override
+			{
+				mOrder.push_back( RenderCommandType::SetFloat );
+				NullRenderCommandExecutor::SetUniform( uniform, value );
+			}
+
+			virtual void SetUniform( RenderUniform uniform, const Vec3& value ) override
+			{
+				mOrder.push_back( RenderCommandType::SetVec3 );
+				NullRenderCommandExecutor::SetUniform( uniform, value );
+			}
+
+			virtual void SetUniform( RenderUniform uniform, const Vec4& value ) override
+			{
+				mOrder.push_back( RenderCommandType::SetVec4 );
+				NullRenderCommandExecutor::SetUniform( uniform, value );
+			}
+
+			virtual void SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count ) override
+			{
+				mOrder.push_back( RenderCommandType::SetMat4 );
+				NullRenderCommandExecutor::SetUniform( uniform, values, count );
+			}
+
+			virtual void BindMesh( const Mesh* mesh ) override
+			{
+				mOrder.push_back( RenderCommandType::BindMesh );
+				NullRenderCommandExecutor::BindMesh( mesh );
+			}
+
+			virtual void DrawSubMesh( const SubMesh* subMesh, u32 lod ) override
+			{
+				mOrder.push_back( RenderCommandType::DrawSubMesh );
+				NullRenderCommandExecutor::DrawSubMesh( subMesh, lod );
+			}
+	};
+
+	bool Check( bool condition, const char* what )
+	{
+		if ( !condition )
+		{
+			std::cout << "RenderCommandBuffer test failed: " << what << "\n";
+		}
+		return condition;
+	}
+
+	/*
+	* @brief Records draws [first, end) the way the gbuffer pass records an opaque chunk, adding the commands it
+	*			should produce to expected
+	*/
+	void RecordChunk( const Vector< FakeDraw >& draws, u32 first, u32 end, RenderCommandBuffer* buffer, u32* expected )
+	{
+		const Shader* shader = nullptr;
+		const Material* material = nullptr;
+
+		buffer->Clear( );
+		for ( u32 d = first; d < end; ++d )
+		{
+			const FakeDraw& draw = draws[ d ];
+
+			if ( shader != draw.mShader )
+			{
+				shader = draw.mShader;
+				material = nullptr;
+
+				buffer->BindProgram( shader );
+				buffer->SetUniform( RenderUniform::ViewProjection, Mat4x4::Identity( ) );
+				buffer->SetUniform( RenderUniform::WorldTime, 1.0f );
+				buffer->SetUniform( RenderUniform::ViewPosition, Vec3( 0.0f ) );
+				buffer->SetUniform( RenderUniform::PreviousViewProjection, Mat4x4::Identity( ) );
+
+				expected[ ( u32 )RenderCommandType::BindProgram ]++;
+				expected[ ( u32 )RenderCommandType::SetMat4 ] += 2;
+				expected[ ( u32 )RenderCommandType::SetFloat ]++;
+				expected[ ( u32 )RenderCommandType::SetVec3 ]++;
+			}
+
+			if ( material != draw.mMaterial )
+			{
+				material = draw.mMaterial;
+				buffer->BindMaterial( material );
+				expected[ ( u32 )RenderCommandType::BindMaterial ]++;
+			}
+
+			buffer->SetUniform( RenderUniform::ObjectID, Vec4( 1.0f ) );
+			buffer->SetUniform( RenderUniform::Model, Mat4x4::Identity( ) );
+			buffer->SetUniform( RenderUniform::PreviousModel, Mat4x4::Identity( ) );
+			buffer->BindMesh( draw.mMesh );
+			buffer->DrawSubMesh( draw.mSubMesh, 0 );
+
+			expected[ ( u32 )RenderCommandType::SetVec4 ]++;
+			expected[ ( u32 )RenderCommandType::SetMat4 ] += 2;
+			expected[ ( u32 )RenderCommandType::BindMesh ]++;
+			expected[ ( u32 )RenderCommandType::DrawSubMesh ]++;
+		}
+	}
+}
+
+//=================================================================
+
+bool RunRenderCommandBufferTests( )
+{
+	bool passed = true;
+
+	// Queue sorted by shader then material, as the render queue hands the opaque pass over
+	u8 addresses[ 64 ];
+	const u32 drawCount = ENJON_RENDER_COMMAND_CHUNK_SIZE * 3 + 17;
+	Vector< FakeDraw > draws( drawCount );
+	for ( u32 i = 0; i < drawCount; ++i )
+	{
+		draws[ i ].mShader = reinterpret_cast< const Shader* >( &addresses[ i * 2 / drawCount ] );
+		draws[ i ].mMaterial = reinterpret_cast< const Material* >( &addresses[ 2 + i * 8 / drawCount ] );
+		draws[ i ].mMesh = reinterpret_cast< const Mesh* >( &addresses[ 16 + i % 16 ] );
+		draws[ i ].mSubMesh = reinterpret_cast< const SubMesh* >( &addresses[ 32 + i % 32 ] );
+	}
+
+	// Record in chunks, as the gbuffer pass does on workers
+	u32 chunkCount = ( drawCount + ENJON_RENDER_COMMAND_CHUNK_SIZE - 1 ) / ENJON_RENDER_COMMAND_CHUNK_SIZE;
+	Vector< RenderCommandBuffer > chunks( chunkCount );
+	u32 expected[ ( u32 )RenderCommandType::Count ] = { };
+	for ( u32 c = 0; c < chunkCount; ++c )
+	{
+		u32 first = c * ENJON_RENDER_COMMAND_CHUNK_SIZE;
+		RecordChunk( draws, first, std::min( first + ENJON_RENDER_COMMAND_CHUNK_SIZE, drawCount ), &chunks[ c ], expected );
+	}
+
+	// Replay chunks in order and check every command came through once
+	OrderedNullRenderCommandExecutor executor;
+	u32 recorded = 0;
+	for ( auto& chunk : chunks )
+	{
+		executor.Execute( chunk );
+		recorded += chunk.GetCommandCount( );
+	}
+
+	for ( u32 t = 0; t < ( u32 )RenderCommandType::Count; ++t )
+	{
+		passed &= Check( executor.GetCount( ( RenderCommandType )t ) == expected[ t ], "per type count doesn't match recorded commands" );
+	}
+	passed &= Check( executor.GetTotalCount( ) == recorded, "total count doesn't match buffers' command counts" );
+	passed &= Check( executor.GetCount( RenderCommandType::DrawSubMesh ) == drawCount, "not every draw was replayed" );
+
+	// Every chunk rebinds its own program, since it can't rely on state left by the one before
+	passed &= Check( executor.GetCount( RenderCommandType::BindProgram ) >= chunkCount, "chunk replayed without binding a program" );
+	passed &= Check( !executor.mOrder.empty( ) && executor.mOrder.front( ) == RenderCommandType::BindProgram, "first command isn't a program bind" );
+
+	// Appending chunks must replay in exactly the same order as executing them one after another
+	RenderCommandBuffer combined;
+	for ( auto& chunk : chunks )
+	{
+		combined.Append( chunk );
+	}
+
+	OrderedNullRenderCommandExecutor combinedExecutor;
+	combinedExecutor.Execute( combined );
+	passed &= Check( combined.GetCommandCount( ) == recorded, "appended buffer lost commands" );
+	passed &= Check( combinedExecutor.mOrder == executor.mOrder, "appended buffer replayed out of order" );
+
+	// Reset starts counting over
+	executor.Reset( );
+	passed &= Check( executor.GetTotalCount( ) == 0, "reset didn't clear counts" );
+
+	std::cout << "RenderCommandBuffer tests " << ( passed ? "passed" : "failed" ) << "\n";
+	return passed;
+}
+
+//=================================================================
@@ -2,6 +2,7 @@
 // Copyright 2016-2018 John Jackson. All Rights Reserved.
 
 #include <Enjon.h>
+#include "RenderCommandBufferTests.h"
  
 #include <filesystem> 
 #include <iostream> 
@@ -59,6 +60,8 @@ int main(int argc, char** argv)
 
 		std::cout << v1 << ", " << Vec3ToString(v2) << ", Equals: " << Equals( v1, v2 ) << "\n";
 	} 
+
+	bool passed = RunRenderCommandBufferTests( );
 	
-	return 0;
+	return passed ? 0 : 1;
 }
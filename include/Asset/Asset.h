@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <memory>
+#include <atomic>
 
 namespace Enjon
 { 
@@ -21,10 +22,45 @@ namespace Enjon
 	class AssetManager; 
 	class AssetArchiver;
 	class AssetRecordInfo;
+	struct AssetDependency;
 
 	template <typename T>
 	class AssetHandle;
 
+	/*
+	* @brief Counts live handles to an asset. Shared between the asset and its handles, so handles can safely outlive the asset.
+	*			Handles are released from any thread, so both fields are atomic.
+	*/
+	struct AssetReferenceTracker
+	{
+		std::atomic< u32 > mHandleCount{ 0 };
+		std::atomic< u32 > mLastReleasedFrame{ 0 };
+	};
+
+	/*
+	* @brief Owns an asset's reference tracker. Copying an asset gives the copy its own tracker rather than sharing who references the original.
+	*/
+	struct AssetReferences
+	{
+		AssetReferences( ) : mTracker( std::make_shared< AssetReferenceTracker >( ) ) { }
+		AssetReferences( const AssetReferences& other ) : AssetReferences( ) { }
+		AssetReferences& operator=( const AssetReferences& other ) { return *this; }
+
+		std::shared_ptr< AssetReferenceTracker > mTracker;
+	};
+
+	/*
+	* @brief Source file an asset was imported from and the settings it was imported with, used to tell whether it needs reimporting
+	*/
+	struct AssetSourceInfo
+	{
+		String mSourceFilePath		= "";
+		u64 mSourceFileSize			= 0;
+		s64 mSourceWriteTime		= 0;
+		u64 mSourceHash				= 0;
+		String mImportSettings		= "";		// Serialized import options, empty if imported without any
+	};
+
 
 	ENJON_CLASS( Abstract )
 	class Asset : public Enjon::Object
@@ -36,6 +72,9 @@ namespace Enjon
 			friend AssetManager;
 			friend AssetArchiver; 
 
+			template < typename T >
+			friend class AssetHandle;
+
 			/**
 			*@brief
 			*/
@@ -81,6 +120,60 @@ namespace Enjon
 			*/
 			const AssetRecordInfo* GetAssetRecordInfo( ) const; 
 
+			/*
+			* @brief Returns whether asset is still being streamed in on a worker thread
+			*/
+			bool IsStreaming( ) const
+			{
+				return ( mStreamingPlaceholder != nullptr );
+			}
+
+			/*
+			* @brief Returns asset safe to use right now. While streaming in, this is the loader's default asset, or null
+			*			if still loading without one.
+			*/
+			const Asset* GetResidentAsset( ) const;
+
+			/*
+			* @brief Returns source file asset was imported from. Path is empty for assets created in engine.
+			*/
+			const AssetSourceInfo& GetSourceInfo( ) const
+			{
+				return mSourceInfo;
+			}
+
+			/*
+			* @brief Returns number of live handles referencing this asset
+			*/
+			u32 GetHandleReferenceCount( ) const
+			{
+				return mReferences.mTracker->mHandleCount;
+			}
+
+			/*
+			* @brief Returns residency frame at which the last handle to this asset was released
+			*/
+			u32 GetLastReleasedFrame( ) const
+			{
+				return mReferences.mTracker->mLastReleasedFrame.load( std::memory_order_relaxed );
+			}
+
+			/*
+			* @brief Returns approximate bytes of CPU and GPU memory held by this asset while loaded
+			*/
+			virtual usize GetResidentMemoryUsage( ) const
+			{
+				return 0;
+			}
+
+			/*
+			* @brief Returns current residency frame, advanced once per frame by the asset manager
+			*/
+			static u32 GetResidencyFrame( )
+			{
+				return sResidencyFrame.load( std::memory_order_relaxed );
+			}
+
 		public:
 			/*
 			* @brief
@@ -108,6 +201,14 @@ namespace Enjon
 				return Result::INCOMPLETE;
 			} 
 
+			/**
+			*@brief Appends assets this asset directly references. Returns incomplete if references should be found through reflection instead.
+			*/
+			virtual Result CollectDependencies( Vector< AssetDependency >* out ) const
+			{
+				return Result::INCOMPLETE;
+			}
+
 		protected: 
 
 			ENJON_PROPERTY( HideInEditor )
@@ -126,6 +227,17 @@ namespace Enjon
 
 			const AssetRecordInfo* mRecordInfo = nullptr;
 
+			// Written into asset header so changes to the source can be detected
+			AssetSourceInfo mSourceInfo;
+
+			// Stands in for this asset until it has finished streaming in
+			const Asset* mStreamingPlaceholder = nullptr;
+
+			// Tracks handles to this asset for residency management
+			AssetReferences mReferences;
+
+			static std::atomic< u32 > sResidencyFrame;
+
 		private:
 	};
 
@@ -148,14 +260,32 @@ namespace Enjon
 			{
 				static_assert(std::is_base_of<Asset, T>::value, "AssetHandle:: T must inherit from Asset.");	
 
-				mAsset = asset;
+				Set( asset );
 			} 
 
+			/*
+			* @brief Copy Constructor
+			*/
+			AssetHandle( const AssetHandle< T >& other )
+			{
+				Assign( other.mAsset, other.mTracker );
+			}
+
+			/*
+			* @brief Copy assignment
+			*/
+			AssetHandle< T >& operator=( const AssetHandle< T >& other )
+			{
+				Assign( other.mAsset, other.mTracker );
+				return *this;
+			}
+
 			/*
 			* @brief Destructor
 			*/
 			~AssetHandle( )
 			{ 
+				Assign( nullptr, nullptr );
 			}
 			
 			/*
@@ -171,7 +301,7 @@ namespace Enjon
 			*/
 			bool operator==( const AssetHandle< T >& other )
 			{
-				return ( Get( ) == other.Get( ) );
+				return ( mAsset == other.mAsset );
 			}
 
 			/*
@@ -179,7 +309,7 @@ namespace Enjon
 			*/
 			bool operator!=( const AssetHandle< T >& other )
 			{
-				return !( Get( ) == other.Get( ) );
+				return !( mAsset == other.mAsset );
 			}
 
 			/*
@@ -207,13 +337,22 @@ namespace Enjon
 			void Reload( );
 
 			/*
-			* @brief
+			* @brief Returns the loader's default asset while the real one is still streaming in
 			*/
 			const T* Get() const 
 			{ 
-				return mAsset->Cast<T>(); 
+				const Asset* resident = mAsset ? mAsset->GetResidentAsset( ) : nullptr;
+				return resident ? resident->Cast<T>( ) : nullptr; 
 			} 
 
+			/*
+			* @brief Returns whether asset is valid and has finished loading
+			*/
+			bool IsLoaded( ) const
+			{
+				return ( mAsset != nullptr && !mAsset->IsStreaming( ) );
+			}
+
 			/*
 			* @brief
 			*/
@@ -244,7 +383,7 @@ namespace Enjon
 			Result Set( const Asset* asset ) 
 			{
 				// Set to new asset
-				mAsset = asset;
+				Assign( asset, asset ? asset->mReferences.mTracker : nullptr );
 
 				// Return success
 				return Result::SUCCESS;
@@ -255,7 +394,7 @@ namespace Enjon
 			*/
 			Result Save( )
 			{
-				if ( mAsset && !mAsset->IsDefault() )
+				if ( mAsset && !mAsset->IsDefault() && !mAsset->IsStreaming( ) )
 				{
 					return mAsset->Save( );
 				} 
@@ -269,8 +408,36 @@ namespace Enjon
 
 		protected:
 
+		private: 
+
+			/*
+			* @brief Points handle at asset, moving its reference from old tracker to new one. Never dereferences the old asset, which may have been unloaded.
+			*/
+			void Assign( const Asset* asset, const std::shared_ptr< AssetReferenceTracker >& tracker )
+			{
+				if ( asset == mAsset && tracker == mTracker )
+				{
+					return;
+				}
+
+				// Reference new asset before releasing old one
+				if ( tracker )
+				{
+					tracker->mHandleCount++;
+				}
+
+				if ( mTracker && --mTracker->mHandleCount == 0 )
+				{
+					mTracker->mLastReleasedFrame.store( Asset::GetResidencyFrame( ), std::memory_order_relaxed );
+				}
+
+				mAsset = asset;
+				mTracker = tracker;
+			}
+
 		private: 
 			const Asset* mAsset = nullptr;
+			std::shared_ptr< AssetReferenceTracker > mTracker;
 	};
 } 
 
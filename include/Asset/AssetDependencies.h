@@ -0,0 +1,88 @@
+// @file AssetDependencies.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_ASSET_DEPENDENCIES_H
+#define ENJON_ASSET_DEPENDENCIES_H
+
+#include "System/Types.h"
+#include "Serialize/UUID.h"
+#include "Defines.h"
+
+#include <unordered_set>
+
+// Extension of dependency list written next to a cached asset file
+#define ENJON_ASSET_DEPENDENCIES_FILE_EXTENSION		".deps"
+#define ENJON_ASSET_DEPENDENCIES_FILE_VERSION		1
+
+namespace Enjon
+{
+	class Asset;
+	class Entity;
+	class Object;
+	class MetaClass;
+	class MetaProperty;
+
+	/*
+	* @brief Asset referenced by another asset
+	*/
+	struct AssetDependency
+	{
+		UUID mAssetUUID;
+		const MetaClass* mAssetClass = nullptr;
+	};
+
+	/*
+	* @brief Finds the assets an asset references through asset handles, directly or through other assets, so they can
+	*			be loaded ahead of it. Lists are cached next to the asset's file when it is saved.
+	*/
+	class AssetDependencies
+	{
+		public:
+
+			/*
+			* @brief Collects every asset that asset depends on, transitively. Dependencies come before the assets that
+			*			reference them, so loading the list in order never has to wait on an asset further down it.
+			*/
+			static Result Collect( const Asset* asset, Vector< AssetDependency >* out );
+
+			/*
+			* @brief Appends assets directly referenced by object's reflected properties, including nested objects
+			*/
+			static void CollectFromObject( const Object* object, Vector< AssetDependency >* out );
+
+			/*
+			* @brief Appends assets directly referenced by entity, its components and its children
+			*/
+			static void CollectFromEntity( Entity* entity, Vector< AssetDependency >* out );
+
+			/*
+			* @brief Returns path of dependency list cached for asset file at assetFilePath
+			*/
+			static String GetFilePath( const String& assetFilePath );
+
+			/*
+			* @brief Writes dependency list for asset file at assetFilePath
+			*/
+			static Result WriteToFile( const String& assetFilePath, const Vector< AssetDependency >& dependencies );
+
+			/*
+			* @brief Reads dependency list cached for asset file at assetFilePath. Fails if there is none or it is out of date.
+			*/
+			static Result ReadFromFile( const String& assetFilePath, Vector< AssetDependency >* out );
+
+		private:
+
+			/*
+			* @brief
+			*/
+			static void CollectFromProperty( const Object* object, const MetaProperty* prop, Vector< AssetDependency >* out );
+
+			/*
+			* @brief
+			*/
+			static void CollectRecursive( const Asset* asset, std::unordered_set< String >* visited, Vector< AssetDependency >* out );
+	};
+}
+
+#endif
@@ -0,0 +1,88 @@
+// @file AssetDirectoryWatcher.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_ASSET_DIRECTORY_WATCHER_H
+#define ENJON_ASSET_DIRECTORY_WATCHER_H
+
+#include "System/Types.h"
+#include "Defines.h"
+
+#include <chrono>
+
+// How long a file has to go without being written before its change is reported
+#define ENJON_ASSET_WATCHER_DEFAULT_SETTLE_MS		250
+
+namespace Enjon
+{
+	/*
+	* @brief Watches a directory tree for files being written, created or moved into it. Editors tend to save a file
+	*			several times in quick succession, so a change is only reported once the file has gone a settle period
+	*			without further events. Uses inotify on Linux, elsewhere nothing is ever reported.
+	*/
+	class AssetDirectoryWatcher
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			AssetDirectoryWatcher( ) = default;
+
+			/*
+			* @brief
+			*/
+			~AssetDirectoryWatcher( );
+
+			/*
+			* @brief Starts watching directory and all directories below it, other than those under an excluded path
+			*/
+			Result Initialize( const String& directory, const Vector< String >& excludedDirectories );
+
+			/*
+			* @brief Stops watching and drops any changes not yet reported
+			*/
+			void Shutdown( );
+
+			/*
+			* @brief
+			*/
+			bool IsWatching( ) const;
+
+			/*
+			* @brief
+			*/
+			void SetSettleTime( u32 milliseconds );
+
+			/*
+			* @brief Reads pending events without blocking and appends files whose changes have settled to changed
+			*/
+			void Poll( Vector< String >* changed );
+
+		private:
+
+			/*
+			* @brief Adds watch for directory and every directory below it
+			*/
+			void WatchRecursive( const String& directory );
+
+			/*
+			* @brief
+			*/
+			bool IsExcluded( const String& path ) const;
+
+			/*
+			* @brief Reads all queued events, recording time of latest event per file
+			*/
+			void ReadEvents( );
+
+		private:
+			s32 mHandle = -1;
+			HashMap< s32, String > mDirectoriesByWatch;
+			Vector< String > mExcludedDirectories;
+			HashMap< String, std::chrono::steady_clock::time_point > mPendingChanges;
+			u32 mSettleTimeMS = ENJON_ASSET_WATCHER_DEFAULT_SETTLE_MS;
+	};
+}
+
+#endif
@@ -20,7 +20,9 @@ namespace Enjon
 	enum class AssetLoadStatus
 	{
 		Unloaded,				// Not loaded in to memory but record is created
-		Loaded					// Fully loaded into memory and ready to use
+		Loading,				// Being streamed in on a worker thread, default asset is used in its place
+		Loaded,					// Fully loaded into memory and ready to use
+		Failed					// Couldn't be streamed or loaded, default asset is used in its place until reloaded
 	};
 
 	class AssetLoader;
@@ -101,6 +103,11 @@ namespace Enjon
 			*/
 			const MetaClass* GetAssetClass( );
 
+			/**
+			* @brief Returns source file asset was imported from, as recorded when it was last imported
+			*/
+			const AssetSourceInfo& GetSourceInfo( ) const;
+
 
 		private:
 			Asset* mAsset							= nullptr; 
@@ -112,6 +119,7 @@ namespace Enjon
 			AssetLoadStatus mAssetLoadStatus		= AssetLoadStatus::Unloaded;
 			AssetLocationType mAssetLocationType	= AssetLocationType::ApplicationAsset;
 			const MetaClass* mAssetClass			= nullptr;
+			AssetSourceInfo mSourceInfo;
 	}; 
 
 	// Forward declaration
@@ -164,6 +172,33 @@ namespace Enjon
 				return ".easset";
 			}
 
+			/**
+			* @brief Returns whether assets of this type can be decoded on a worker thread. Their DeserializeData must not
+			*			touch graphics state or other assets, leaving GPU uploads to DeserializeLateInit.
+			*/
+			virtual bool SupportsStreaming( ) const
+			{
+				return false;
+			}
+
+			/**
+			* @brief Returns whether unreferenced assets of this type can be unloaded by the asset manager to stay within
+			*			its residency budget. They must be able to be loaded back in from their cached file on next access.
+			*/
+			virtual bool SupportsEviction( ) const
+			{
+				return false;
+			}
+
+			/**
+			* @brief Returns whether resource imported with options ( null for a plain file import ) can be imported on a
+			*			worker thread through ImportResourceData when importing in batches.
+			*/
+			virtual bool SupportsParallelImport( const ImportOptions* options ) const
+			{
+				return false;
+			}
+
 			/**
 			* @brief Returns default asset. Will register if not available yet.
 			*/
@@ -216,6 +251,12 @@ namespace Enjon
 			*/
 			void LoadRecord( AssetRecordInfo* record );
 
+			/**
+			* @brief Loads asset for unloaded record, either immediately or by streaming it in if supported.
+			*			If fileContents is given, asset is deserialized from it immediately instead of being read from disk.
+			*/
+			void LoadRecordAsset( AssetRecordInfo* info, ByteBuffer* fileContents = nullptr );
+
 			/**
 			* @brief
 			*/
@@ -325,6 +366,12 @@ namespace Enjon
 			* @brief 
 			*/
 			virtual Asset* LoadResourceFromImporter( const ImportOptions* options ); 
+
+			/**
+			* @brief Imports resource at filePath without creating GPU resources or touching other assets or loaders, so it
+			*			can be run on a worker thread. Only called if SupportsParallelImport returns true for options.
+			*/
+			virtual Asset* ImportResourceData( const String& filePath, const ImportOptions* options );
 	};
 
 	//====================================================================================
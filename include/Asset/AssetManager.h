@@ -7,18 +7,45 @@
 #include "Subsystem.h"
 #include "System/Types.h"
 #include "Asset/AssetLoader.h"
+#include "Asset/AssetDependencies.h"
+#include "Asset/AssetDirectoryWatcher.h"
 #include "Serialize/CacheRegistryManifest.h"
+#include "Serialize/PakFile.h"
 #include "Asset/ImportOptions.h"
 #include "Defines.h" 
 #include "Engine.h"
+#include "System/JobSystem.h"
 
 #include <array>
+#include <mutex>
+
+// Archive of cached assets mounted from assets directory in place of its loose files, if present
+#define ENJON_ASSET_PAK_FILE_NAME		"Assets.pak"
 
 namespace Enjon
 {
 	class AssetLoader; 
 	class Asset; 
 
+	/*
+	* @brief Format assets are saved in. Either format can always be read.
+	*/
+	enum class AssetFileFormat
+	{
+		Binary,
+		Text			// Json, so scenes and other assets serialized through reflection can be diffed and merged
+	};
+
+	/*
+	* @brief Single source file to import as part of a batch. If options are given, file path, destination and loader are taken from them.
+	*/
+	struct AssetImportRequest
+	{
+		String mResourceFilePath;
+		String mDestinationDirectory;
+		const ImportOptions* mOptions = nullptr;
+	};
+
 	ENJON_CLASS( )
 	class AssetManager : public Subsystem
 	{
@@ -86,6 +113,46 @@ namespace Enjon
 			*/
 			Result AddToDatabase( Asset* asset, const ImportOptions* options );
 
+			/**
+			*@brief Imports all requests, running each import whose loader supports it as an independent job on worker threads.
+			*			Imported assets are written to their cached files and then registered with loaders and the manifest on the
+			*			calling thread in request order, so the result does not depend on job scheduling. Other imports run on the
+			*			calling thread during registration. Requests for assets already imported fail, as with single imports.
+			*			If results is given, it receives the result of each request.
+			*/
+			Result AddToDatabase( const Vector< AssetImportRequest >& requests, Vector< Result >* results = nullptr );
+
+			/**
+			*@brief Reimports every asset imported from source file at resourceFilePath, with the settings it was imported with,
+			*			and reloads those currently loaded in place. Assets whose source contents and import settings are unchanged are skipped.
+			*			Returns failure if nothing was imported from source or any asset couldn't be reimported.
+			*/
+			Result ReimportAsset( const String& resourceFilePath );
+
+			/**
+			*@brief Reimports asset already imported from options' source file with options' settings, into its existing file and UUID,
+			*			and reloads it in place if loaded. Skipped if source contents and import settings are unchanged. Fails if the asset
+			*			was never imported, in which case it has to be added with AddToDatabase.
+			*/
+			Result ReimportAsset( const ImportOptions* options );
+
+			/**
+			*@brief Fills out source info for resource at resourceFilePath imported with options ( null for a plain file import ).
+			*			If previous is given and the file's size and write time match it, its content hash is reused rather than recomputed.
+			*			Sources inside the assets directory have their path stored relative to it.
+			*/
+			Result GetSourceInfo( const String& resourceFilePath, const ImportOptions* options, AssetSourceInfo* out, const AssetSourceInfo* previous = nullptr ) const;
+
+			/**
+			*@brief Sets whether source files under the assets directory are watched and reimported when they change. Takes effect on next initialization.
+			*/
+			void SetHotReloadEnabled( bool enabled );
+
+			/**
+			*@brief
+			*/
+			bool GetHotReloadEnabled( ) const;
+
 			/**
 			*@brief Adds asset to project from given import options
 			*/
@@ -156,6 +223,128 @@ namespace Enjon
 			*@brief
 			*/
 			const Enjon::String& GetCachedAssetsDirectoryPath( ) const;
+
+			/**
+			*@brief Sets whether cached assets are written as block compressed files. Either format can always be read.
+			*/
+			void SetCompressCachedAssets( bool enabled );
+
+			/**
+			*@brief
+			*/
+			bool GetCompressCachedAssets( ) const;
+
+			/**
+			*@brief Sets format assets are written in when saved. Assets that handle their own serialization are always written as binary.
+			*/
+			void SetAssetFileFormat( AssetFileFormat format );
+
+			/**
+			*@brief
+			*/
+			AssetFileFormat GetAssetFileFormat( ) const;
+
+			/**
+			*@brief Packs cached file of every asset record into archive at pakPath, for shipping builds to mount instead of the
+			*			cache directory. Placed in assets directory as ENJON_ASSET_PAK_FILE_NAME, it is mounted on initialization.
+			*/
+			Result BuildPak( const String& pakPath ) const;
+
+			/**
+			*@brief Archive records are served from, if one was mounted on initialization
+			*/
+			const PakFile* GetMountedPak( ) const;
+
+			/**
+			*@brief Reads cached file of record into buffer, from mounted archive if it holds record, otherwise from disk
+			*/
+			Result ReadAssetFile( const AssetRecordInfo* info, ByteBuffer* buffer ) const;
+
+			/**
+			*@brief Reads size bytes starting at offset into contents of record's cached file into out, decompressing only
+			*			what covers them. Thread safe.
+			*/
+			Result ReadAssetFileRange( const AssetRecordInfo* info, u32 offset, u32 size, u8* out ) const;
+
+			/**
+			*@brief Sets whether assets whose loaders support it are decoded on worker threads when first accessed
+			*/
+			void SetStreamingEnabled( bool enabled );
+
+			/**
+			*@brief
+			*/
+			bool GetStreamingEnabled( ) const;
+
+			/**
+			*@brief Sets how much main thread time and data can be spent finishing streamed assets ( GPU uploads ) each frame.
+			*			At least one streamed asset is always finished per frame.
+			*/
+			void SetStreamingUploadBudget( f32 milliseconds, usize bytes );
+
+			/**
+			*@brief Starts streaming in asset for record on a worker thread. Record's asset stands in with loader's default asset until finished.
+			*			Returns failure if asset could not be streamed and must be loaded immediately instead.
+			*/
+			Result StreamAsset( AssetRecordInfo* info, AssetLoader* loader );
+
+			/**
+			*@brief Loads record's streamed asset on calling thread into the asset handles already hold, for assets that failed to
+			*			stream in. Record is marked failed if it still can't be loaded. Main thread only.
+			*/
+			Result LoadStreamedAssetImmediate( AssetRecordInfo* info );
+
+			/**
+			*@brief Blocks until all assets currently streaming have been decoded and finished, ignoring upload budget
+			*/
+			void FlushStreaming( );
+
+			/**
+			*@brief Returns number of assets that have been requested but not yet finished streaming
+			*/
+			u32 GetStreamingAssetCount( ) const;
+
+			/**
+			*@brief Loads all unloaded assets in dependencies before returning. Streamable assets are decoded on worker threads,
+			*			the rest have their files read in parallel and are then deserialized in list order.
+			*/
+			Result PrefetchAssets( const Vector< AssetDependency >& dependencies );
+
+			/**
+			*@brief Loads dependency list cached for asset when it was last saved and prefetches it. Fails if asset has no up to date list.
+			*/
+			Result PrefetchDependencies( const MetaClass* cls, const UUID& id );
+
+			/**
+			*@brief
+			*/
+			Result PrefetchDependencies( const MetaClass* cls, const String& name );
+
+			/**
+			*@brief Sets how many bytes loaded assets may hold before unreferenced ones are evicted, least recently used first.
+			*			Only assets whose loaders support eviction are unloaded. Zero disables eviction.
+			*/
+			void SetResidencyBudget( usize bytes );
+
+			/**
+			*@brief
+			*/
+			usize GetResidencyBudget( ) const;
+
+			/**
+			*@brief Returns memory held by loaded assets of given asset class as of last residency update
+			*/
+			usize GetResidentMemoryUsage( const MetaClass* assetCls ) const;
+
+			/**
+			*@brief Returns memory held by all loaded assets as of last residency update
+			*/
+			usize GetResidentMemoryUsage( ) const;
+
+			/**
+			*@brief Recomputes memory held by loaded assets and evicts unreferenced assets if over budget. Called periodically from Update.
+			*/
+			void UpdateResidency( );
 			
 			/**
 			*@brief
@@ -294,6 +483,57 @@ namespace Enjon
 		private:
 			void RegisterLoaders( );
 
+			/**
+			*@brief Finishes streamed assets whose decode has completed, within the upload budget unless ignoreBudget is set
+			*/
+			void ProcessStreamedAssets( bool ignoreBudget );
+
+			/**
+			*@brief Writes transitive dependency list next to asset's file at filePath, for assets that report their own references
+			*/
+			void CacheAssetDependencies( const Asset* asset, const String& filePath ) const;
+
+			/**
+			*@brief Returns path asset with displayName is cached to in directory, or in cache directory if none given
+			*/
+			String GetCachedAssetFilePath( const String& displayName, const AssetLoader* loader, const String& directory ) const;
+
+			/**
+			*@brief
+			*/
+			Result PrefetchRecordDependencies( const AssetRecordInfo* info );
+
+			/**
+			*@brief Reimports source into record's existing asset file, keeping its UUID, and reloads the asset if loaded.
+			*			Skipped if source contents and import settings match those the record was last imported with.
+			*/
+			Result ReimportRecord( AssetLoader* loader, AssetRecordInfo* info, const AssetSourceInfo& source, const ImportOptions* options );
+
+			/**
+			*@brief Returns path source info stores for resource at resourceFilePath: relative to assets directory if inside it, otherwise absolute
+			*/
+			String GetStoredSourcePath( const String& resourceFilePath ) const;
+
+			/**
+			*@brief Returns absolute path of source from path stored in its source info
+			*/
+			String GetAbsoluteSourcePath( const String& storedPath ) const;
+
+			/**
+			*@brief Reimports sources reported changed by the directory watcher
+			*/
+			void ProcessSourceChanges( );
+
+		private:
+
+			struct StreamedAsset
+			{
+				AssetRecordInfo* mRecord	= nullptr;
+				Asset* mAsset				= nullptr;
+				usize mByteSize				= 0;
+				Result mResult				= Result::FAILURE;
+			};
+
 		private: 
 
 			std::unordered_map< const MetaClass*, AssetLoader* > mLoadersByMetaClass;
@@ -303,7 +543,27 @@ namespace Enjon
 			String mCachedDirectoryPath;
 			String mName; 
 			CacheRegistryManifest mCacheManifest;
+			PakFile mPak;
 			AssetLocationType mAssetLocationType = AssetLocationType::EngineAsset;
+			bool mCompressCachedAssets = false;
+			AssetFileFormat mAssetFileFormat = AssetFileFormat::Binary;
+
+			bool mStreamingEnabled = true;
+			f32 mStreamingUploadBudgetMS = 2.0f;
+			usize mStreamingUploadBudgetBytes = 8 * 1024 * 1024;
+			u32 mStreamingAssetCount = 0;
+			JobGroup mStreamingJobs;
+			std::mutex mStreamedAssetsLock;
+			Vector< StreamedAsset > mDecodedAssets;				// Filled by workers, guarded by lock
+			Vector< StreamedAsset > mPendingUploads;			// Main thread only, waiting on budget
+
+			usize mResidencyBudgetBytes = 0;
+			u32 mResidencyUpdateInterval = 30;
+			usize mResidentMemoryTotal = 0;
+			HashMap< const MetaClass*, usize > mResidentMemoryByClass;
+
+			AssetDirectoryWatcher mSourceWatcher;
+			bool mHotReloadEnabled = true;
 	};
 
 	#include "Asset/AssetManager.inl"
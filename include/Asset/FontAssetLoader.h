@@ -26,8 +26,18 @@ namespace Enjon
 			*/
 			String GetAssetFileExtension( ) const;
 
+			/**
+			* @brief Font import only reads the font file, so can always be done in parallel
+			*/
+			virtual bool SupportsParallelImport( const ImportOptions* options ) const override;
+
 		private:
 			Asset* LoadResourceFromFile( const String& filePath ) override;
+
+			/**
+			* @brief
+			*/
+			virtual Asset* ImportResourceData( const String& filePath, const ImportOptions* options ) override;
 	};
 }
 
@@ -9,12 +9,18 @@
 #include "Asset/AssetLoader.h"
 #include "Graphics/Mesh.h"
 #include "Graphics/Skeleton.h"
+#include "Graphics/MeshOptimizer.h"
 
 // Assimp specifics
 struct aiMesh;
 struct aiNode;
 struct aiScene;
 
+namespace Assimp
+{
+	class Importer;
+}
+
 namespace Enjon
 {
 	// Forward Declarations
@@ -48,11 +54,51 @@ namespace Enjon
 			*/
 			AssetHandle< Skeleton > GetSkeleton( ) const;
 
+			/*
+			* @brief Largest error quantized vertex attributes of imported mesh may have. Zero keeps full floats.
+			*/
+			f32 GetVertexErrorBudget( ) const;
+
+			/*
+			* @brief
+			*/
+			void SetVertexErrorBudget( const f32& budget );
+
+			/*
+			* @brief Number of levels of detail generated for imported mesh, including full detail one. One disables them.
+			*/
+			u32 GetLODCount( ) const;
+
+			/*
+			* @brief
+			*/
+			void SetLODCount( const u32& count );
+
+			/*
+			* @brief Fraction of triangles each generated level of detail keeps of the previous one
+			*/
+			f32 GetLODReduction( ) const;
+
+			/*
+			* @brief
+			*/
+			void SetLODReduction( const f32& reduction );
+
 			/*
 			* @brief
 			*/
 			virtual void Reset( ) override;
 
+			/*
+			* @brief
+			*/
+			virtual void SerializeSettings( ByteBuffer* buffer ) const override;
+
+			/*
+			* @brief
+			*/
+			virtual void DeserializeSettings( ByteBuffer* buffer ) override;
+
 		protected:
 
 			/*
@@ -68,6 +114,12 @@ namespace Enjon
 			u32 mShowAnimationCreateDialogue : 1;
 			u32 mCreateAnimations : 1;
 			AssetHandle< Skeleton > mSkeletonAsset;
+			f32 mVertexErrorBudget = ENJON_MESH_DEFAULT_QUANTIZATION_ERROR;
+			u32 mLODCount = ENJON_MESH_DEFAULT_LOD_COUNT;
+			f32 mLODReduction = ENJON_MESH_DEFAULT_LOD_REDUCTION;
+
+			// Scene of import in progress, shared by every asset built from it. Owned by mesh loader, never serialized.
+			const aiScene* mScene = nullptr;
 	};
 
 	ENJON_CLASS( )
@@ -82,6 +134,11 @@ namespace Enjon
 			*/
 			void virtual ExplicitConstructor() override; 
 
+			/**
+			* @brief Releases scene kept from beginning an import
+			*/
+			virtual void ExplicitDestructor( ) override;
+
 			// NOTE(): Total temporary
 			Vector< Skeleton* > GetSkeletons( )
 			{
@@ -109,6 +166,27 @@ namespace Enjon
 			*/
 			virtual String GetAssetFileExtension( ) const override;
 
+			/**
+			* @brief Decoding is self contained and GPU upload happens in late init, so these can be streamed
+			*/
+			virtual bool SupportsStreaming( ) const override;
+
+			/**
+			* @brief
+			*/
+			virtual bool SupportsEviction( ) const override;
+
+			/**
+			* @brief Static meshes can be imported in parallel. Imports that create skeletons or animations can not.
+			*/
+			virtual bool SupportsParallelImport( const ImportOptions* options ) const override;
+
+			/**
+			* @brief Parses model file with post processing every asset imported from it needs, so it's only read once.
+			*			Scene is owned by importer. Thread safe for separate importers.
+			*/
+			static const aiScene* ReadScene( Assimp::Importer* importer, const String& filePath );
+
 		protected:
 
 			/**
@@ -132,6 +210,23 @@ namespace Enjon
 			*/
 			virtual Asset* LoadResourceFromImporter( const ImportOptions* options ) override;
 
+			/**
+			* @brief
+			*/
+			virtual Asset* ImportResourceData( const String& filePath, const ImportOptions* options ) override;
+
+			/**
+			* @brief Builds static mesh from all meshes in scene with levels of detail and quantized vertex data as set by
+			*			options, or defaults if null. Vertex data is not uploaded.
+			*/
+			Mesh* ConstructStaticMesh( const aiScene* scene, const MeshImportOptions* options );
+
+			/**
+			* @brief Creates a material for each material in scene, with its diffuse and normal textures imported from
+			*			beside the model file. Registers assets, so runs on the calling thread.
+			*/
+			void ConstructMaterials( const aiScene* scene, const MeshImportOptions* options );
+
 			/**
 			* @brief
 			*/
@@ -154,9 +249,18 @@ namespace Enjon
 
 			void BuildBoneHeirarchy( const aiNode* node, const aiNode* parent, Skeleton* skeleton );
 
+			/**
+			* @brief
+			*/
+			void ReleaseImporter( );
+
 			Vector< Skeleton* > mSkeletons;
 			Vector< SkeletalAnimation* > mAnimations;
 			MeshImportOptions mImportOptions;
+
+			// Scene parsed to show import dialogue, reused by import of same file
+			Assimp::Importer* mImporter = nullptr;
+			String mImporterFilePath;
 	}; 
 }
 
@@ -22,6 +22,41 @@ namespace Enjon
 			* @brief
 			*/
 			virtual String GetAssetFileExtension( ) const override;
+
+			/**
+			* @brief Decoding is self contained and GPU upload happens in late init, so these can be streamed
+			*/
+			virtual bool SupportsStreaming( ) const override;
+
+			/**
+			* @brief
+			*/
+			virtual bool SupportsEviction( ) const override;
+
+			/**
+			* @brief Images are decoded without touching graphics state, so can always be imported in parallel
+			*/
+			virtual bool SupportsParallelImport( const ImportOptions* options ) const override;
+
+			/**
+			* @brief Whether imported textures are block compressed. Mips are always cooked.
+			*/
+			void SetCompressionEnabled( bool enabled );
+
+			/**
+			* @brief
+			*/
+			bool GetCompressionEnabled( ) const;
+
+			/**
+			* @brief Whether BC7 is used instead of BC1 / BC3 for color textures. Slower to cook, fewer artifacts.
+			*/
+			void SetHighQualityCompression( bool enabled );
+
+			/**
+			* @brief
+			*/
+			bool GetHighQualityCompression( ) const;
 			
 		protected:
 			/**
@@ -34,11 +69,30 @@ namespace Enjon
 			* @brief
 			*/
 			virtual Asset* LoadResourceFromFile( const String& filePath ) override;
+
+			/**
+			* @brief
+			*/
+			virtual Asset* ImportResourceData( const String& filePath, const ImportOptions* options ) override;
 	
 			/**
 			* @brief
 			*/
 			Texture* LoadTextureFromFile( const Enjon::String& filePath );
+
+			/**
+			* @brief Decodes image at filePath and cooks its mips, picking block format from its usage and contents.
+			*			Nothing is uploaded, so can be run on a worker thread.
+			*/
+			Texture* CookTexture( const String& filePath ) const;
+
+		private:
+
+			ENJON_PROPERTY( )
+			bool mCompressionEnabled = true;
+
+			ENJON_PROPERTY( )
+			bool mHighQualityCompression = false;
 	}; 
 }
 
@@ -1576,6 +1576,12 @@ namespace Enjon
 			*/
 			virtual Result HasPropertyOverrides( bool& result ) const;
 
+			/*
+			* @brief Copies data from source, which is of the same class. Return INCOMPLETE to use default property cloning.
+			*			Classes that handle their own serialization will usually need to handle their own cloning as well.
+			*/
+			virtual Result CloneData( const Object* source );
+
 		private:
 
 			/**
@@ -28,6 +28,7 @@ namespace Enjon
 	class MetaClass;
 	class Subsystem;
 	class WindowSubsystem;
+	class JobSystem;
 	struct WindowParams;
 	
 	class Engine;
@@ -261,6 +262,7 @@ namespace Enjon
 			ImGuiManager*		mImGuiManager		= nullptr;
 			AnimationSubsystem* mAnimationSystem	= nullptr;
 			WindowSubsystem*	mWindowSubsystem	= nullptr;
+			JobSystem*			mJobSystem			= nullptr;
 			World*				mWorld				= nullptr;
 
 			// Engine configuration settings
@@ -46,6 +46,8 @@ namespace Enjon
 
 			virtual Vector<Component*> GetComponents( ) = 0;
 
+			virtual void Reserve( const u32& count ) = 0;
+
 			virtual void Update( ) = 0;
 	};
 
@@ -124,6 +126,15 @@ namespace Enjon
 				return mComponentPtrs;
 			}
 
+			/**
+			* @brief Makes room for count more components without reallocating
+			*/
+			virtual void Reserve( const u32& count ) override
+			{
+				mComponentPtrs.reserve( mComponentPtrs.size( ) + count );
+				mComponentMap.reserve( mComponentMap.size( ) + count );
+			}
+
 		private:
 			ComponentPtrs mComponentPtrs;
 			ComponentMap mComponentMap; 
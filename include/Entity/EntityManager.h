@@ -29,6 +29,7 @@ namespace Enjon
 {
 	class EntityManager;
 	class EntityArchiver;
+	class JSONArchiver;
 	class World;
 
 	enum class EntityState
@@ -126,6 +127,7 @@ namespace Enjon
 		friend EntityHandle;
 		friend EntityManager;
 		friend EntityArchiver;
+		friend JSONArchiver;
 		friend Archetype;
 
 	public:
@@ -604,6 +606,7 @@ namespace Enjon
 		ENJON_CLASS_BODY( EntityManager )
 
 		friend EntityArchiver;
+		friend JSONArchiver;
 		friend Entity;
 		friend Application;
 		friend World;
@@ -616,6 +619,11 @@ namespace Enjon
 		*/
 		Enjon::EntityHandle Allocate( World* world = nullptr );
 
+		/*
+		* @brief Allocates count entities in a single pass over free slots, appending their handles to out
+		*/
+		void Allocate( u32 count, Vector< EntityHandle >* out, World* world = nullptr );
+
 		/**
 		*@brief
 		*/
@@ -673,6 +681,11 @@ namespace Enjon
 		*/
 		Component* AddComponent( const MetaClass* compCls, const Enjon::EntityHandle& handle );
 
+		/**
+		*@brief Makes room for given number of components of each class, so adding them in bulk doesn't reallocate storage
+		*/
+		void ReserveComponents( const HashMap< const MetaClass*, u32 >& counts );
+
 		/**
 		*@brief
 		*/
@@ -0,0 +1,176 @@
+// @file AABBTree.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_AABB_TREE_H
+#define ENJON_AABB_TREE_H
+
+#include "Graphics/Frustum.h"
+#include "Math/Ray.h"
+#include "System/Types.h"
+#include "Defines.h"
+
+#include <functional>
+
+#define ENJON_AABB_TREE_NULL_NODE		-1
+
+namespace Enjon
+{
+	/*
+	* @brief Node of tree. Leaves hold proxies for objects, internal nodes bound their two children.
+	*/
+	struct AABBTreeNode
+	{
+		b32 IsLeaf( ) const
+		{
+			return mLeft == ENJON_AABB_TREE_NULL_NODE;
+		}
+
+		Vec3 mMin;
+		Vec3 mMax;
+		void* mUserData = nullptr;
+		u32 mUserTag = 0;
+		s32 mParent = ENJON_AABB_TREE_NULL_NODE;		// Next free node while in free list
+		s32 mLeft = ENJON_AABB_TREE_NULL_NODE;
+		s32 mRight = ENJON_AABB_TREE_NULL_NODE;
+		s32 mHeight = -1;								// Leaves are 0, free nodes -1
+	};
+
+	/*
+	* @brief Dynamic bounding volume hierarchy. Leaves store boxes fattened by a margin so that objects moving a little
+	*			don't have to be reinserted, and the tree is kept balanced with rotations as leaves are inserted and
+	*			removed, so insert, remove, move and queries are all logarithmic in the number of proxies.
+	*/
+	class AABBTree
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			AABBTree( f32 margin = 0.1f );
+
+			/*
+			* @brief
+			*/
+			~AABBTree( ) = default;
+
+			/*
+			* @brief Inserts box min to max, returning id of proxy for it
+			*/
+			s32 Insert( const Vec3& min, const Vec3& max, void* userData, u32 userTag = 0 );
+
+			/*
+			* @brief
+			*/
+			void Remove( s32 proxy );
+
+			/*
+			* @brief Updates proxy to box min to max. Only reinserts it if box has left its fattened bounds or shrunk well
+			*			inside them, returning whether it did.
+			*/
+			b32 Move( s32 proxy, const Vec3& min, const Vec3& max );
+
+			/*
+			* @brief
+			*/
+			void Clear( );
+
+			/*
+			* @brief
+			*/
+			void* GetUserData( s32 proxy ) const
+			{
+				return mNodes[ proxy ].mUserData;
+			}
+
+			/*
+			* @brief
+			*/
+			u32 GetUserTag( s32 proxy ) const
+			{
+				return mNodes[ proxy ].mUserTag;
+			}
+
+			/*
+			* @brief Fattened bounds of proxy
+			*/
+			void GetBounds( s32 proxy, Vec3* min, Vec3* max ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetProxyCount( ) const
+			{
+				return mProxyCount;
+			}
+
+			/*
+			* @brief Height of root, 0 when empty or with a single proxy
+			*/
+			s32 GetHeight( ) const;
+
+			/*
+			* @brief Calls callback with each proxy whose fattened bounds overlap box min to max
+			*/
+			void QueryAABB( const Vec3& min, const Vec3& max, const std::function< void( s32 ) >& callback ) const;
+
+			/*
+			* @brief Calls callback with each proxy whose fattened bounds overlap sphere
+			*/
+			void QuerySphere( const Vec3& center, f32 radius, const std::function< void( s32 ) >& callback ) const;
+
+			/*
+			* @brief Calls callback with each proxy whose fattened bounds intersect frustum, and whether they're wholly
+			*			inside it. Subtrees wholly inside are reported without testing any further planes.
+			*/
+			void QueryFrustum( const Frustum& frustum, const std::function< void( s32, b32 ) >& callback ) const;
+
+			/*
+			* @brief Calls callback with each proxy whose fattened bounds ray enters within maxDistance, and distance along
+			*			ray, in multiples of its direction, at which it does
+			*/
+			void RayCast( const Ray& ray, f32 maxDistance, const std::function< void( s32, f32 ) >& callback ) const;
+
+		private:
+
+			/*
+			* @brief
+			*/
+			s32 AllocateNode( );
+
+			/*
+			* @brief
+			*/
+			void FreeNode( s32 node );
+
+			/*
+			* @brief
+			*/
+			void InsertLeaf( s32 leaf );
+
+			/*
+			* @brief
+			*/
+			void RemoveLeaf( s32 leaf );
+
+			/*
+			* @brief Rotates node's children if their heights differ by more than one, returning new root of subtree
+			*/
+			s32 Balance( s32 node );
+
+			/*
+			* @brief Walks up from node, refitting bounds and heights and balancing each ancestor
+			*/
+			void Refit( s32 node );
+
+		private:
+			Vector< AABBTreeNode > mNodes;
+			s32 mRoot = ENJON_AABB_TREE_NULL_NODE;
+			s32 mFreeList = ENJON_AABB_TREE_NULL_NODE;
+			u32 mProxyCount = 0;
+			f32 mMargin = 0.1f;
+	};
+}
+
+#endif
@@ -22,6 +22,17 @@
 
 #define MAX_NUMBER_GLYPHS 128 
 
+// 'ESDF'
+#define ENJON_FONT_SDF_MAGIC				0x46445345
+
+// Pixel height glyphs are rasterized at before distance transform, and distance in pixels encoded either side of edges
+#define ENJON_FONT_SDF_BAKE_SIZE			48
+#define ENJON_FONT_SDF_SPREAD				6
+
+// Range of codepoints cooked into atlas
+#define ENJON_FONT_SDF_FIRST_CODEPOINT		32
+#define ENJON_FONT_SDF_LAST_CODEPOINT		126
+
 namespace Enjon 
 { 
 	enum class TextStyle 
@@ -193,6 +204,41 @@ namespace Enjon
 		u8* mData;
 	} FontData;
 
+	/*
+	* @brief Glyph of a signed distance atlas. Rect includes spread on each side. Offset is from pen position on baseline
+	*			to top left of rect, y down. Metrics are in pixels at bake size.
+	*/
+	struct FontSDFGlyph
+	{
+		u32 mCodepoint	= 0;
+		u16 mX			= 0;
+		u16 mY			= 0;
+		u16 mWidth		= 0;
+		u16 mHeight		= 0;
+		f32 mOffsetX	= 0.0f;
+		f32 mOffsetY	= 0.0f;
+		f32 mAdvance	= 0.0f;
+	};
+
+	/*
+	* @brief Single channel atlas of glyph distance fields, cooked once per font. Any size renders from it by scaling
+	*			metrics by size / bake size and thresholding distance at 0.5.
+	*/
+	struct FontSDFAtlas
+	{
+		u32 mBakeSize			= 0;
+		u32 mSpread				= 0;
+		f32 mAscent				= 0.0f;
+		f32 mDescent			= 0.0f;
+		f32 mLineHeight			= 0.0f;
+		u32 mWidth				= 0;
+		u32 mHeight				= 0;
+		u32 mSolidX				= 0;			// Texel fully inside coverage, for drawing solid shapes with atlas bound
+		u32 mSolidY				= 0;
+		Vector< FontSDFGlyph > mGlyphs;			// Sorted by codepoint
+		Vector< u8 > mPixels;
+	};
+
 	ENJON_CLASS( Construct )
 	class UIFont : public Asset 
 	{ 
@@ -212,8 +258,35 @@ namespace Enjon
 
 			const FontData& GetFontData() const;
 
+			/**
+			* @brief Rasterizes glyphs of font data once at bake size and cooks them into a packed distance field atlas
+			*/
+			Result BuildSDFAtlas( );
+
+			/**
+			* @brief
+			*/
+			bool HasSDFAtlas( ) const;
+
+			/**
+			* @brief
+			*/
+			const FontSDFAtlas& GetSDFAtlas( ) const;
+
+			/**
+			* @brief Returns glyph for codepoint, or null if it wasn't cooked
+			*/
+			const FontSDFGlyph* GetSDFGlyph( const u32& codepoint ) const;
+
+			/**
+			* @brief Texture of distance field atlas, uploaded on first use
+			*/
+			u32 GetSDFTextureID( ) const;
+
 		private: 
 			FontData mFontData;
+			FontSDFAtlas mSDFAtlas;
+			u32 mSDFTextureID = 0;
 	};
 }
 
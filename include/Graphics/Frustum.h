@@ -0,0 +1,122 @@
+// @file Frustum.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_FRUSTUM_H
+#define ENJON_FRUSTUM_H
+
+#include "System/Types.h"
+#include "Math/Maths.h"
+#include "Defines.h"
+
+namespace Enjon
+{
+	/*
+	* @brief Bounds to test against frustums, stored as structure of arrays padded to a multiple of four so four can be
+	*			tested with each SIMD instruction. Boxes are given by center and half extents, spheres by center and radius.
+	*/
+	struct CullingBounds
+	{
+		/*
+		* @brief Resizes to count bounds, padding arrays out to a multiple of four
+		*/
+		void Resize( u32 count );
+
+		/*
+		* @brief
+		*/
+		void SetAABB( u32 index, const Vec3& center, const Vec3& extents );
+
+		/*
+		* @brief
+		*/
+		void SetSphere( u32 index, const Vec3& center, f32 radius );
+
+		/*
+		* @brief Marks bounds as unknown, so that they always test visible
+		*/
+		void SetInfinite( u32 index );
+
+		/*
+		* @brief
+		*/
+		u32 GetCount( ) const
+		{
+			return mCount;
+		}
+
+		Vector< f32 > mCenterX;
+		Vector< f32 > mCenterY;
+		Vector< f32 > mCenterZ;
+		Vector< f32 > mExtentX;				// Radius of spheres
+		Vector< f32 > mExtentY;
+		Vector< f32 > mExtentZ;
+		u32 mCount = 0;
+	};
+
+	/*
+	* @brief How much of a bound lies inside a frustum
+	*/
+	enum class FrustumContainment
+	{
+		Outside,
+		Intersecting,
+		Inside
+	};
+
+	/*
+	* @brief Six planes bounding what a camera sees, normals pointing inwards
+	*/
+	class Frustum
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			Frustum( ) = default;
+
+			/*
+			* @brief Extracts planes from view projection matrix, with GL clip space depth of [-w, w]
+			*/
+			static Frustum FromViewProjection( const Mat4x4& viewProjection );
+
+			/*
+			* @brief World space bounds of box given in local space by min and max, transformed by model matrix
+			*/
+			static void TransformAABB( const Mat4x4& model, const Vec3& min, const Vec3& max, Vec3* center, Vec3* extents );
+
+			/*
+			* @brief
+			*/
+			bool IntersectsAABB( const Vec3& center, const Vec3& extents ) const;
+
+			/*
+			* @brief
+			*/
+			bool IntersectsSphere( const Vec3& center, f32 radius ) const;
+
+			/*
+			* @brief Whether box is wholly outside, partly inside or wholly inside
+			*/
+			FrustumContainment ClassifyAABB( const Vec3& center, const Vec3& extents ) const;
+
+			/*
+			* @brief Tests boxes [first, first + count) of bounds, writing whether each intersects to visible at its
+			*			index. First has to be a multiple of four. Thread safe, so disjoint ranges can be tested in parallel.
+			*/
+			void CullAABBs( const CullingBounds& bounds, u32 first, u32 count, u8* visible ) const;
+
+			/*
+			* @brief As CullAABBs, for spheres
+			*/
+			void CullSpheres( const CullingBounds& bounds, u32 first, u32 count, u8* visible ) const;
+
+		public:
+
+			// ( normal, distance ) with dot( normal, p ) + distance >= 0 inside
+			Vec4 mPlanes[ 6 ];
+	};
+}
+
+#endif
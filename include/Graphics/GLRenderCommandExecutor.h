@@ -0,0 +1,40 @@
+// @file GLRenderCommandExecutor.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_GL_RENDER_COMMAND_EXECUTOR_H
+#define ENJON_GL_RENDER_COMMAND_EXECUTOR_H
+
+#include "Graphics/RenderCommandBuffer.h"
+
+namespace Enjon
+{
+	/*
+	* @brief Replays command buffers against OpenGL. Must only be used on thread owning graphics context.
+	*/
+	class GLRenderCommandExecutor : public RenderCommandExecutor
+	{
+		public:
+
+			/*
+			* @brief Forgets program bound, which must be done whenever programs are bound outside of executor
+			*/
+			void Invalidate( );
+
+		protected:
+
+			virtual void BindProgram( const Shader* shader ) override;
+			virtual void BindMaterial( const Material* material ) override;
+			virtual void SetUniform( RenderUniform uniform, f32 value ) override;
+			virtual void SetUniform( RenderUniform uniform, const Vec3& value ) override;
+			virtual void SetUniform( RenderUniform uniform, const Vec4& value ) override;
+			virtual void SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count ) override;
+			virtual void BindMesh( const Mesh* mesh ) override;
+			virtual void DrawSubMesh( const SubMesh* subMesh, u32 lod ) override;
+
+		private:
+			Shader* mShader = nullptr;
+	};
+}
+
+#endif
@@ -0,0 +1,122 @@
+// @file GPUMemoryTracker.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_GPU_MEMORY_TRACKER_H
+#define ENJON_GPU_MEMORY_TRACKER_H
+
+#include "System/Types.h"
+#include "Defines.h"
+
+namespace Enjon
+{
+	/*
+	* @brief Kinds of GL objects tracked. Textures and render targets share GL's texture names.
+	*/
+	enum class GPUResourceType
+	{
+		Texture,
+		RenderTarget,
+		Buffer,
+		Count
+	};
+
+	/*
+	* @brief Bytes allocated for a single GL object
+	*/
+	struct GPUAllocation
+	{
+		GPUResourceType mType = GPUResourceType::Texture;
+		u32 mHandle = 0;
+		usize mBytes = 0;
+		String mPool;			// Subsystem or kind of asset that allocated it
+		String mOwner;			// Asset or object it belongs to
+	};
+
+	/*
+	* @brief Bytes allocated by a pool or owner across all its objects
+	*/
+	struct GPUMemoryTotal
+	{
+		String mName;
+		usize mBytes = 0;
+		u32 mCount = 0;
+	};
+
+	/*
+	* @brief CPU side accounting of GPU memory. Everything creating GL buffers, textures or render targets records their
+	*			size here, computed from dimensions, formats and mips since GL has no portable way to query it, and
+	*			releases it when deleting them. Thread safe.
+	*/
+	class GPUMemoryTracker
+	{
+		public:
+
+			/*
+			* @brief Records bytes allocated for GL object, replacing any previous size recorded for it
+			*/
+			static void Track( GPUResourceType type, u32 handle, usize bytes, const String& pool, const String& owner = "" );
+
+			/*
+			* @brief Forgets GL object. Does nothing for objects that weren't tracked.
+			*/
+			static void Release( GPUResourceType type, u32 handle );
+
+			/*
+			* @brief
+			*/
+			static usize GetTotalBytes( );
+
+			/*
+			* @brief Most bytes tracked at once since startup
+			*/
+			static usize GetPeakBytes( );
+
+			/*
+			* @brief
+			*/
+			static usize GetBytes( GPUResourceType type );
+
+			/*
+			* @brief
+			*/
+			static u32 GetAllocationCount( );
+
+			/*
+			* @brief Totals of every pool, largest first
+			*/
+			static void GetPoolTotals( Vector< GPUMemoryTotal >* totals );
+
+			/*
+			* @brief Totals of count largest owners, largest first
+			*/
+			static void GetLargestOwners( u32 count, Vector< GPUMemoryTotal >* totals );
+
+			/*
+			* @brief Count largest allocations of type, largest first. Type of Count includes every type.
+			*/
+			static void GetLargestAllocations( GPUResourceType type, u32 count, Vector< GPUAllocation >* allocations );
+
+			/*
+			* @brief Bytes of single width x height image of GL internal format, block compressed formats included
+			*/
+			static usize GetImageSize( u32 internalFormat, u32 width, u32 height );
+
+			/*
+			* @brief Bytes of levels mips of texture of GL internal format, for each of faces
+			*/
+			static usize GetTextureSize( u32 internalFormat, u32 width, u32 height, u32 levels = 1, u32 faces = 1 );
+
+			/*
+			* @brief Levels in full mip chain of width x height texture
+			*/
+			static u32 GetFullMipCount( u32 width, u32 height );
+
+			/*
+			* @brief
+			*/
+			static const char* ToString( GPUResourceType type );
+	};
+}
+
+#endif
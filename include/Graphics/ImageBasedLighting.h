@@ -0,0 +1,119 @@
+// @file ImageBasedLighting.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_IMAGE_BASED_LIGHTING_H
+#define ENJON_IMAGE_BASED_LIGHTING_H
+
+#include "System/Types.h"
+#include "Defines.h"
+
+// 'EIBL', follows cooked mips of HDR textures that had lighting precomputed
+#define ENJON_IBL_MAGIC						0x4C424945
+
+// Face size and level count of prefiltered specular cubemap. Level i is filtered for roughness i / ( levels - 1 ).
+#define ENJON_IBL_PREFILTER_SIZE			256
+#define ENJON_IBL_PREFILTER_LEVELS			5
+#define ENJON_IBL_PREFILTER_SAMPLE_COUNT	256
+
+// Face size irradiance cubemap is expanded to from its spherical harmonics
+#define ENJON_IBL_IRRADIANCE_SIZE			32
+
+#define ENJON_IBL_BRDF_LUT_SIZE				128
+#define ENJON_IBL_BRDF_LUT_SAMPLE_COUNT		512
+
+namespace Enjon
+{
+	class ByteBuffer;
+
+	/*
+	* @brief Lighting precomputed from an equirectangular environment
+	*/
+	struct ImageBasedLightingData
+	{
+		// Order 2 spherical harmonics of radiance, RGB per coefficient
+		f32 mIrradianceSH[ 9 ][ 3 ] = { };
+
+		// Prefiltered specular levels, largest first. Each is RGB floats of six faces in GL cubemap order.
+		u32 mPrefilterSize = 0;
+		Vector< Vector< f32 > > mPrefilterLevels;
+
+		// Split sum BRDF scale and bias, RG floats. Columns are NdotV, rows roughness.
+		u32 mBRDFLUTSize = 0;
+		Vector< f32 > mBRDFLUT;
+
+		/*
+		* @brief
+		*/
+		bool IsValid( ) const
+		{
+			return !mPrefilterLevels.empty( ) && !mBRDFLUT.empty( );
+		}
+	};
+
+	/*
+	* @brief GPU textures created from precomputed lighting
+	*/
+	struct ImageBasedLightingMaps
+	{
+		u32 mIrradianceMap = 0;
+		u32 mPrefilteredMap = 0;
+		u32 mBRDFLUT = 0;
+		usize mGPUMemoryBytes = 0;
+	};
+
+	/*
+	* @brief Offline image based lighting. Computes diffuse irradiance as spherical harmonics, specular prefiltered
+	*			with GGX importance sampling and the BRDF lookup table on the cpu, split across the job system, so
+	*			environments are processed once at import instead of with render passes at every startup.
+	*			All functions but Upload are thread safe.
+	*/
+	class ImageBasedLighting
+	{
+		public:
+
+			/*
+			* @brief Precomputes lighting of equirectangular environment, given as its full mip chain of float pixels with
+			*			components channels ( rows bottom first ).
+			*/
+			static Result Precompute( const Vector< Vector< f32 > >& mips, u32 components, u32 width, u32 height, ImageBasedLightingData* out );
+
+			/*
+			* @brief Projects radiance of equirectangular image onto order 2 spherical harmonics
+			*/
+			static void ProjectSH( const f32* pixels, u32 components, u32 width, u32 height, f32 sh[ 9 ][ 3 ] );
+
+			/*
+			* @brief Irradiance divided by pi ( diffuse light of white albedo ) in direction of unit normal
+			*/
+			static void EvaluateIrradiance( const f32 sh[ 9 ][ 3 ], f32 x, f32 y, f32 z, f32 out[ 3 ] );
+
+			/*
+			* @brief Fills lut with size x size split sum BRDF terms. Independent of environment.
+			*/
+			static void GenerateBRDFLUT( u32 size, Vector< f32 >* lut );
+
+			/*
+			* @brief Writes data, prefixed with ENJON_IBL_MAGIC
+			*/
+			static void Serialize( const ImageBasedLightingData& data, ByteBuffer* buffer );
+
+			/*
+			* @brief Reads data written by Serialize, magic included
+			*/
+			static Result Deserialize( ByteBuffer* buffer, ImageBasedLightingData* data );
+
+			/*
+			* @brief Creates irradiance, prefiltered and BRDF lookup textures from data, tracked as belonging to owner. Must be
+			*			called on the main thread.
+			*/
+			static ImageBasedLightingMaps Upload( const ImageBasedLightingData& data, const String& owner = "" );
+
+			/*
+			* @brief Deletes textures created by Upload and resets maps. Must be called on the main thread.
+			*/
+			static void Release( ImageBasedLightingMaps* maps );
+	};
+}
+
+#endif
@@ -77,6 +77,11 @@ namespace Enjon {
 			*/
 			void Bind( const Shader* shader ) const;
 
+			/*
+			* @brief Appends textures material binds to textures, overrides taking precedence over shader graph's uniforms
+			*/
+			void GetTextures( Vector< const Texture* >* textures ) const;
+
 			/*
 			* @brief
 			*/
@@ -117,6 +122,14 @@ namespace Enjon {
 			*/
 			AssetHandle< ShaderGraph > GetShaderGraph( ) const;
 
+			/*
+			* @brief Id unique to material for lifetime of program, given out in order materials are created
+			*/
+			u32 GetMaterialID( ) const
+			{
+				return mMaterialID;
+			}
+
 			/*
 			* @brief
 			*/
@@ -134,6 +147,13 @@ namespace Enjon {
 			*/
 			void ClearAllOverrides( );
 
+		private:
+
+			/*
+			* @brief
+			*/
+			static u32 AllocateMaterialID( );
+
 		protected: 
 			ENJON_PROPERTY( Editable, HideInEditor )
 			AssetHandle< ShaderGraph > mShaderGraph; 
@@ -143,6 +163,8 @@ namespace Enjon {
 
 			ENJON_PROPERTY( Editable ) 
 			bool mTwoSided = false; 
+
+			u32 mMaterialID = AllocateMaterialID( );
 	}; 
 }
 
@@ -15,6 +15,8 @@ namespace Enjon
 	class SubMesh;
 	class Mesh;
 	class MeshAssetLoader; 
+	class MeshOptimizer;
+	class Shader;
 
 	ENJON_ENUM( )
 	enum class VertexAttributeFormat
@@ -26,7 +28,12 @@ namespace Enjon
 		UnsignedInt4,
 		UnsignedInt3,
 		UnsignedInt2,
-		UnsignedInt
+		UnsignedInt,
+		UNorm16x4,			// Positions relative to mesh's quantization bounds, w unused
+		SNorm16x2,			// Octahedral encoded unit vectors
+		UNorm16x2,			// Texture coordinates within [0, 1]
+		Half2,				// Texture coordinates
+		UNorm8x4			// Joint weights
 	};
 
 	ENJON_CLASS( )
@@ -87,6 +94,16 @@ namespace Enjon
 		float UV[2];	
 	}; 
 
+	/*
+	* @brief Range of submesh's index data drawn for one level of detail. All levels share the same vertices.
+	*/
+	struct SubMeshLOD
+	{
+		u32 mIndexOffset = 0;
+		u32 mIndexCount = 0;
+		f32 mError = 0.0f;				// Object space distance simplified surface may be off by
+	};
+
 	ENJON_CLASS( )
 	class SubMesh : public Object
 	{ 
@@ -119,9 +136,19 @@ namespace Enjon
 			void Unbind() const;
 
 			/* 
-			* @brief 
+			* @brief Draws given level of detail, clamped to coarsest one available
+			*/
+			void Submit( const u32& lod = 0 ) const; 
+
+			/*
+			* @brief Number of levels of detail, at least one
+			*/
+			u32 GetLODCount( ) const;
+
+			/*
+			* @brief Simplification error of level of detail, clamped to coarsest one available
 			*/
-			void Submit() const; 
+			f32 GetLODError( const u32& lod ) const;
 
 			/*
 			* @brief
@@ -129,10 +156,15 @@ namespace Enjon
 			u32 GetVertexCount( ) const;
 
 			/*
-			* @brief
+			* @brief Number of indices for indexed submeshes, otherwise number of vertices
 			*/
 			u32 GetDrawCount( ) const; 
 
+			/*
+			* @brief
+			*/
+			bool IsIndexed( ) const;
+
 			/*
 			* @brief
 			*/
@@ -162,10 +194,15 @@ namespace Enjon
 			virtual Result SerializeData( ByteBuffer* buffer ) const override;
 
 			/*
-			* @brief
+			* @brief Reads vertex and index data only. GPU buffers are created by UploadVertexData.
 			*/
 			virtual Result DeserializeData( ByteBuffer* buffer ) override; 
 
+			/*
+			* @brief Creates GPU buffers for vertex and index data. Must be called on the main thread.
+			*/
+			Result UploadVertexData( );
+
 		public:
 			Vector< Vert > mVerticies; 
 			Vector< u32 > mIndicies;	
@@ -174,6 +211,13 @@ namespace Enjon
 			Mesh* mMesh = nullptr; 
 			ByteBuffer mVertexData;
 
+			// Cooked indices, 2 or 4 bytes each. Empty for unindexed triangle lists.
+			ByteBuffer mIndexData;
+			u32 mIndexSize = 0;
+
+			// Index ranges of each level of detail, finest first. Empty for unindexed submeshes.
+			Vector< SubMeshLOD > mLODs;
+
 			GLenum mDrawType;
 			GLint mDrawStart = 0;
 			GLint mDrawCount = 0;
@@ -186,6 +230,7 @@ namespace Enjon
 	class Mesh : public Asset
 	{
 		friend MeshAssetLoader;
+		friend MeshOptimizer;
 
 		ENJON_CLASS_BODY( Mesh )
 
@@ -206,11 +251,56 @@ namespace Enjon
 			*/
 			u32 GetSubMeshCount( ) const;
 
+			/*
+			* @brief
+			*/
+			virtual usize GetResidentMemoryUsage( ) const override;
+
 			/*
 			* @brief
 			*/
 			const VertexDataDeclaration& GetVertexDeclaration( );
 
+			/*
+			* @brief Most levels of detail of any submesh
+			*/
+			u32 GetLODCount( ) const;
+
+			/*
+			* @brief Largest simplification error of any submesh at given level of detail
+			*/
+			f32 GetLODError( const u32& lod ) const;
+
+			/*
+			* @brief Object space bounds of all submeshes
+			*/
+			Vec3 GetBoundsMin( ) const;
+
+			/*
+			* @brief
+			*/
+			Vec3 GetBoundsMax( ) const;
+
+			/*
+			* @brief Recalculates bounds and texture coordinate density from vertex data
+			*/
+			void CalculateBounds( );
+
+			/*
+			* @brief Average texture coordinate units per object space unit over mesh's surface. Zero if it has no texture coordinates.
+			*/
+			f32 GetUVDensity( ) const;
+
+			/*
+			* @brief Sets uniforms shader needs to decode quantized vertex data of this mesh
+			*/
+			void Bind( const Shader* shader ) const;
+
+			/*
+			* @brief Whether normals and tangents are stored octahedral encoded
+			*/
+			bool HasOctahedralDirections( ) const;
+
 		//protected:
 
 			/*
@@ -239,6 +329,11 @@ namespace Enjon
 			*/
 			virtual Result DeserializeData( ByteBuffer* buffer ) override; 
 
+			/*
+			* @brief Uploads submesh vertex data decoded in DeserializeData
+			*/
+			virtual Result DeserializeLateInit( ) override;
+
 		//protected:
 
 			/*
@@ -249,6 +344,14 @@ namespace Enjon
 		protected: 
 			VertexDataDeclaration mVertexDecl;
 			Vector< SubMesh* > mSubMeshes;
+
+			// Maps quantized positions back into object space ( offset + position * scale )
+			Vec3 mPositionOffset = Vec3( 0.0f );
+			Vec3 mPositionScale = Vec3( 1.0f );
+
+			Vec3 mBoundsMin = Vec3( 0.0f );
+			Vec3 mBoundsMax = Vec3( 0.0f );
+			f32 mUVDensity = 0.0f;
 	}; 
 }
 
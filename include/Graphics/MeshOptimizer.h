@@ -0,0 +1,89 @@
+// @file MeshOptimizer.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_MESH_OPTIMIZER_H
+#define ENJON_MESH_OPTIMIZER_H
+
+#include "System/Types.h"
+#include "Defines.h"
+
+// Size of post transform cache that triangle order is optimized for
+#define ENJON_MESH_VERTEX_CACHE_SIZE		32
+
+// Default largest error a quantized vertex attribute may decode with, in the attribute's own units
+#define ENJON_MESH_DEFAULT_QUANTIZATION_ERROR		0.0005f
+
+// Default level of detail chain: levels including full detail one, and fraction of triangles each keeps of previous
+#define ENJON_MESH_DEFAULT_LOD_COUNT				4
+#define ENJON_MESH_DEFAULT_LOD_REDUCTION			0.5f
+
+namespace Enjon
+{
+	class Mesh;
+	class SubMesh;
+	class VertexDataDeclaration;
+
+	/*
+	* @brief Offline mesh cooking. Turns triangle soups into indexed meshes and reorders them for the GPU:
+	*			triangles for post transform cache hits, then clusters of them front to back for less overdraw,
+	*			then vertices in order of first use for fetch locality. All functions are thread safe.
+	*/
+	class MeshOptimizer
+	{
+		public:
+
+			/*
+			* @brief Cooks submesh's triangle soup vertex data into unique vertices and an optimized index buffer.
+			*			Indices are 16 bit when vertex count allows. Position is expected as first attribute of decl.
+			*/
+			static Result CookSubMesh( SubMesh* subMesh, const VertexDataDeclaration& decl );
+
+			/*
+			* @brief Merges bitwise identical vertices of a triangle soup. Fills vertices with unique vertices and
+			*			indices with one index per soup vertex. Returns unique vertex count.
+			*/
+			static u32 Deduplicate( const u8* soup, u32 vertexCount, u32 vertexSize, Vector< u8 >* vertices, Vector< u32 >* indices );
+
+			/*
+			* @brief Reorders triangles in place to maximize post transform cache hits ( Forsyth's linear speed algorithm )
+			*/
+			static void OptimizeVertexCache( u32* indices, u32 indexCount, u32 vertexCount );
+
+			/*
+			* @brief Reorders clusters of triangles, split where the cache order already starts cold, so outward facing
+			*			clusters are drawn first. Keeps cache efficiency of the order it's given.
+			*/
+			static void OptimizeOverdraw( u32* indices, u32 indexCount, const u8* vertices, u32 vertexSize, u32 vertexCount );
+
+			/*
+			* @brief Reorders vertices in order of first use by indices and drops unused ones. Returns new vertex count.
+			*/
+			static u32 OptimizeVertexFetch( u8* vertices, u32 vertexCount, u32 vertexSize, u32* indices, u32 indexCount );
+
+			/*
+			* @brief Collapses edges in order of quadric error ( Garland and Heckbert ) until index count reaches target or
+			*			nothing more can be collapsed. Vertices only collapse onto neighbouring vertices, so results index
+			*			the same vertex data. Vertices on borders and attribute seams are kept. Returns new index count and
+			*			fills error with largest object space distance introduced.
+			*/
+			static u32 Simplify( u32* indices, u32 indexCount, const u8* vertices, u32 vertexCount, u32 vertexSize, u32 targetIndexCount, f32* error );
+
+			/*
+			* @brief Appends simplified levels of detail of cooked submesh's full detail level to its index data, each
+			*			keeping reduction of the previous one's triangles. Stops early once simplification stalls.
+			*/
+			static Result GenerateLODs( SubMesh* subMesh, const VertexDataDeclaration& decl, u32 lodCount, f32 reduction );
+
+			/*
+			* @brief Converts float vertex data of all submeshes into compact formats: positions to 16 bits relative to mesh
+			*			bounds, normals and tangents to octahedral 16 bits, uvs to unorm16 or half floats and joint weights to
+			*			unorm8. Each attribute is only converted if its largest error fits errorBudget ( object space units
+			*			for positions, unit vector and uv units otherwise ). Weights are renormalized and always converted.
+			*			Decl must start with float position, normal, tangent and uv; Float4 attributes after them are weights.
+			*/
+			static Result QuantizeMesh( Mesh* mesh, f32 errorBudget );
+	};
+}
+
+#endif
@@ -0,0 +1,266 @@
+// @file RenderCommandBuffer.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_RENDER_COMMAND_BUFFER_H
+#define ENJON_RENDER_COMMAND_BUFFER_H
+
+#include "Math/Maths.h"
+#include "System/Types.h"
+#include "Defines.h"
+
+// Draws recorded into each command buffer, so chunks of a pass can be recorded in parallel
+#define ENJON_RENDER_COMMAND_CHUNK_SIZE 256
+
+namespace Enjon
+{
+	class Shader;
+	class Material;
+	class Mesh;
+	class SubMesh;
+
+	/*
+	* @brief Commands recorded into command buffers
+	*/
+	enum class RenderCommandType : u8
+	{
+		BindProgram,
+		BindMaterial,
+		SetFloat,
+		SetVec3,
+		SetVec4,
+		SetMat4,				// Array of one or more matrices
+		BindMesh,
+		DrawSubMesh,
+		Count
+	};
+
+	/*
+	* @brief Uniforms commands can set, so commands don't have to carry names
+	*/
+	enum class RenderUniform : u8
+	{
+		ViewProjection,
+		PreviousViewProjection,
+		ViewPosition,
+		WorldTime,
+		Model,
+		PreviousModel,
+		ObjectID,
+		JointTransforms,
+		Count
+	};
+
+	/*
+	* @brief Header preceding each command's payload
+	*/
+	struct RenderCommandHeader
+	{
+		RenderCommandType mType;
+		RenderUniform mUniform;
+		u16 mCount;					// Elements of arrays, otherwise 1
+		u32 mSize;					// Bytes of payload following header
+	};
+
+	/*
+	* @brief Stream of rendering commands, recorded without touching any graphics API so buffers can be filled on any
+	*			thread and replayed later by an executor. Commands are packed back to back as a header followed by their
+	*			payload. Buffers aren't thread safe, so each recording thread needs its own.
+	*/
+	class RenderCommandBuffer
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			void Clear( );
+
+			/*
+			* @brief Binds shader's program, for uniforms and draws following it
+			*/
+			void BindProgram( const Shader* shader );
+
+			/*
+			* @brief Binds material's uniforms and textures to program bound
+			*/
+			void BindMaterial( const Material* material );
+
+			/*
+			* @brief
+			*/
+			void SetUniform( RenderUniform uniform, f32 value );
+
+			/*
+			* @brief
+			*/
+			void SetUniform( RenderUniform uniform, const Vec3& value );
+
+			/*
+			* @brief
+			*/
+			void SetUniform( RenderUniform uniform, const Vec4& value );
+
+			/*
+			* @brief
+			*/
+			void SetUniform( RenderUniform uniform, const Mat4x4& value );
+
+			/*
+			* @brief Sets count elements of matrix array uniform, copying them into buffer
+			*/
+			void SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count );
+
+			/*
+			* @brief Sets vertex decode uniforms of mesh on program bound
+			*/
+			void BindMesh( const Mesh* mesh );
+
+			/*
+			* @brief Draws submesh at level of detail
+			*/
+			void DrawSubMesh( const SubMesh* subMesh, u32 lod );
+
+			/*
+			* @brief Appends commands of other buffer after this one's
+			*/
+			void Append( const RenderCommandBuffer& other );
+
+			/*
+			* @brief
+			*/
+			u32 GetCommandCount( ) const
+			{
+				return mCommandCount;
+			}
+
+			/*
+			* @brief
+			*/
+			usize GetSize( ) const
+			{
+				return mData.size( );
+			}
+
+			/*
+			* @brief
+			*/
+			const u8* GetData( ) const
+			{
+				return mData.data( );
+			}
+
+		private:
+
+			/*
+			* @brief
+			*/
+			void Write( RenderCommandType type, RenderUniform uniform, u16 count, const void* payload, u32 size );
+
+		private:
+			Vector< u8 > mData;
+			u32 mCommandCount = 0;
+	};
+
+	/*
+	* @brief Replays command buffers, decoding each command and handing it to the overload for its type
+	*/
+	class RenderCommandExecutor
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			virtual ~RenderCommandExecutor( ) = default;
+
+			/*
+			* @brief Executes every command of buffer in order
+			*/
+			void Execute( const RenderCommandBuffer& buffer );
+
+		protected:
+
+			/*
+			* @brief
+			*/
+			virtual void BindProgram( const Shader* shader ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void BindMaterial( const Material* material ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void SetUniform( RenderUniform uniform, f32 value ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void SetUniform( RenderUniform uniform, const Vec3& value ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void SetUniform( RenderUniform uniform, const Vec4& value ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void BindMesh( const Mesh* mesh ) = 0;
+
+			/*
+			* @brief
+			*/
+			virtual void DrawSubMesh( const SubMesh* subMesh, u32 lod ) = 0;
+	};
+
+	/*
+	* @brief Executor that only counts commands, for profiling recording or checking it without a graphics context
+	*/
+	class NullRenderCommandExecutor : public RenderCommandExecutor
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			void Reset( );
+
+			/*
+			* @brief Commands of type executed since last reset
+			*/
+			u32 GetCount( RenderCommandType type ) const
+			{
+				return mCounts[ ( u32 )type ];
+			}
+
+			/*
+			* @brief
+			*/
+			u32 GetTotalCount( ) const;
+
+		protected:
+
+			virtual void BindProgram( const Shader* shader ) override;
+			virtual void BindMaterial( const Material* material ) override;
+			virtual void SetUniform( RenderUniform uniform, f32 value ) override;
+			virtual void SetUniform( RenderUniform uniform, const Vec3& value ) override;
+			virtual void SetUniform( RenderUniform uniform, const Vec4& value ) override;
+			virtual void SetUniform( RenderUniform uniform, const Mat4x4* values, u32 count ) override;
+			virtual void BindMesh( const Mesh* mesh ) override;
+			virtual void DrawSubMesh( const SubMesh* subMesh, u32 lod ) override;
+
+		private:
+			u32 mCounts[ ( u32 )RenderCommandType::Count ] = { };
+	};
+}
+
+#endif
@@ -0,0 +1,124 @@
+// @file RenderQueue.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_RENDER_QUEUE_H
+#define ENJON_RENDER_QUEUE_H
+
+#include "System/Types.h"
+#include "Defines.h"
+
+namespace Enjon
+{
+	class Renderable;
+	class SubMesh;
+	class Material;
+	class Shader;
+
+	/*
+	* @brief Passes consuming render queue, in the order their draws sort
+	*/
+	enum class RenderQueuePass : u32
+	{
+		Opaque,					// Static and custom renderables into gbuffer
+		OpaqueSkinned,			// Skeletal renderables into gbuffer
+		Overlay,				// Renderables drawn without depth testing, over everything else
+		Count
+	};
+
+	/*
+	* @brief Single draw of a submesh, or of a whole renderable when submesh is null
+	*/
+	struct RenderQueueItem
+	{
+		Renderable* mRenderable = nullptr;
+		const SubMesh* mSubMesh = nullptr;
+		const Material* mMaterial = nullptr;
+		const Shader* mShader = nullptr;
+		u32 mSubMeshIndex = 0;
+	};
+
+	/*
+	* @brief Draws of a frame keyed by 64 bit integers packing, from most to least significant, pass (4 bits), shader
+	*			program (12 bits), material (16 bits), mesh vertex array (12 bits) and quantized depth (20 bits). Sorting
+	*			keys groups draws so state changes least, and is done with a radix sort, linear in draw count.
+	*/
+	class RenderQueue
+	{
+		public:
+
+			/*
+			* @brief Key grouping draws by state, then front to back. Ids wider than their fields are truncated, which can
+			*			only cost extra state changes. Depth is normalized distance from camera, [0, 1].
+			*/
+			static u64 MakeKey( RenderQueuePass pass, u32 programID, u32 materialID, u32 meshID, f32 depth );
+
+			/*
+			* @brief Key ordering draws only by depth, for passes where draw order matters more than state changes
+			*/
+			static u64 MakeDepthKey( RenderQueuePass pass, f32 depth );
+
+			/*
+			* @brief
+			*/
+			static RenderQueuePass GetPass( u64 key );
+
+			/*
+			* @brief
+			*/
+			void Clear( );
+
+			/*
+			* @brief
+			*/
+			void Push( u64 key, const RenderQueueItem& item );
+
+			/*
+			* @brief Sorts draws by key. Stable, so draws with equal keys stay in order pushed.
+			*/
+			void Sort( );
+
+			/*
+			* @brief
+			*/
+			u32 GetCount( ) const
+			{
+				return ( u32 )mEntries.size( );
+			}
+
+			/*
+			* @brief Draw at index in sorted order
+			*/
+			const RenderQueueItem& GetItem( u32 index ) const
+			{
+				return mItems[ mEntries[ index ].mIndex ];
+			}
+
+			/*
+			* @brief Key at index in sorted order
+			*/
+			u64 GetKey( u32 index ) const
+			{
+				return mEntries[ index ].mKey;
+			}
+
+			/*
+			* @brief Sorted indices [begin, end) of draws of pass
+			*/
+			void GetPassRange( RenderQueuePass pass, u32* begin, u32* end ) const;
+
+		private:
+
+			struct SortEntry
+			{
+				u64 mKey;
+				u32 mIndex;
+			};
+
+			Vector< RenderQueueItem > mItems;
+			Vector< SortEntry > mEntries;
+			Vector< SortEntry > mScratch;
+	};
+}
+
+#endif
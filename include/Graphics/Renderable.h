@@ -14,9 +14,16 @@
 #include "Entity/EntityDefines.h"
 #include "Graphics/Material.h"
 
+// Largest simplification error, in pixels, a level of detail may show on screen
+#define ENJON_LOD_PIXEL_ERROR		1.0f
+
+// Fraction of pixel error coarser levels have to get under before being switched to, so renderables near a threshold don't flicker
+#define ENJON_LOD_HYSTERESIS		0.75f
+
 namespace Enjon 
 { 
 	class SubMesh;
+	class Camera;
 	class Mesh;
 	class GraphicsScene;
 	class GraphicsSubsystem;
@@ -121,6 +128,23 @@ namespace Enjon
 			*/
 			const Mat4x4 GetPreviousModelMatrix( ) const;
 
+			/** 
+			* @brief Level of detail last selected for mesh
+			*/
+			u32 GetLOD( ) const;
+
+			/** 
+			* @brief Selects coarsest level of detail of mesh whose error projects under a pixel at mesh's distance from camera,
+			*			recording the projected scale for GetPixelsPerUnit
+			*/
+			u32 SelectLOD( const Camera* camera, const f32& screenHeight );
+
+			/** 
+			* @brief Pixels one object space unit of mesh covered at nearest point of its bounds when level of detail was last
+			*			selected. FLT_MAX when camera was inside bounds, zero without a camera.
+			*/
+			f32 GetPixelsPerUnit( ) const;
+
 		public:
 
 			/** 
@@ -180,6 +204,8 @@ namespace Enjon
 			GraphicsScene* mGraphicsScene = nullptr;
 			Mat4x4 mPreviousModelMatrix = Mat4x4::Identity( );
 			Mat4x4 mCurrentModelMatrix = Mat4x4::Identity( );
+			u32 mLOD = 0;
+			f32 mPixelsPerUnit = 0.0f;
 	};
 }
 
@@ -312,6 +312,7 @@ namespace Enjon
 			Enjon::String OutputVertexHeaderEndTag( );
 			Enjon::String OutputVertexHeader( const ShaderPassType& pass, s32* status );
 			Enjon::String OutputVertexAttributes( const ShaderPassType& pass, s32* status );
+			Enjon::String OutputVertexAttributeDecode( );
 			Enjon::String BeginVertexMain( const ShaderPassType& pass, s32* status );
 			Enjon::String OutputVertexMain( const ShaderPassType& pass, s32* status );
 			Enjon::String EndVertexMain( const ShaderPassType& pass, s32* status );
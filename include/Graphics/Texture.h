@@ -7,6 +7,7 @@
 
 #include "System/Types.h"
 #include "Asset/Asset.h" 
+#include "Graphics/ImageBasedLighting.h"
 
 namespace Enjon
 {
@@ -15,6 +16,7 @@ namespace Enjon
 	class TextureSourceData;
 	class TextureSourceDataBase;
 	class TextureAssetLoader;
+	class TextureStreamer;
 	class Texture;
 
 	ENJON_ENUM( )
@@ -50,6 +52,37 @@ namespace Enjon
 		ClampToEdge
 	};
 
+	/*
+	* @brief What texture data represents. Decides how mips are filtered and which block format is chosen.
+	*/
+	enum class TextureUsage : u32
+	{
+		Color,			// Gamma encoded color, filtered in linear space
+		Normal,			// Tangent space normals, renormalized after filtering
+		Data			// Linear values ( roughness, metallic, occlusion, masks )
+	};
+
+	ENJON_ENUM( )
+	enum class TextureCompression : u32
+	{
+		None,
+		BC1,			// RGB, 4 bpp
+		BC3,			// RGBA, 8 bpp
+		BC4,			// Single channel, 4 bpp
+		BC5,			// Two channel, 8 bpp
+		BC6H,			// HDR RGB, 8 bpp
+		BC7				// RGBA, 8 bpp, higher quality than BC1 / BC3
+	};
+
+	/*
+	* @brief Where a cooked mip's bytes sit within contents of texture's cached file
+	*/
+	struct TextureMipRange
+	{
+		u32 mOffset = 0;
+		u32 mSize = 0;
+	};
+
 	class TextureSourceDataBase
 	{
 		friend TextureAssetLoader;
@@ -111,18 +144,20 @@ namespace Enjon
 		protected:
 			void ReleaseData( )
 			{
-				delete mData;
+				// Allocated by stb_image
+				free( mData );
 				mData = nullptr;
 			}
 
 		private:
-			T* mData;
+			T* mData = nullptr;
 	}; 
 
 	ENJON_CLASS( )
 	class Texture : public Asset
 	{
 		friend TextureAssetLoader;
+		friend TextureStreamer;
 
 		ENJON_CLASS_BODY( Texture ) 
 
@@ -138,6 +173,11 @@ namespace Enjon
 			*/
 			Texture( u32 width, u32 height, u32 textureID ); 
 
+			/**
+			* @brief Stops streaming texture's mips
+			*/
+			virtual void ExplicitDestructor( ) override;
+
 			/**
 			* @brief 
 			*/
@@ -161,6 +201,31 @@ namespace Enjon
 			ENJON_FUNCTION( )
 			TextureFormat GetFormat( ) const;
 
+			/**
+			* @brief
+			*/
+			virtual usize GetResidentMemoryUsage( ) const override;
+
+			/*
+			* @brief Lighting maps precomputed from this environment when it was cooked. Null if it isn't one or none were uploaded.
+			*/
+			const ImageBasedLightingMaps* GetImageBasedLighting( ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetMipCount( ) const;
+
+			/*
+			* @brief Finest mip uploaded. Non zero while higher mips are left to be streamed in.
+			*/
+			u32 GetResidentMip( ) const;
+
+			/*
+			* @brief Coarsest mip streamed. Mips from here down are always resident.
+			*/
+			u32 GetStreamingTailMip( ) const;
+
 		protected: 
 			/*
 			* @brief
@@ -178,19 +243,54 @@ namespace Enjon
 			*/
 			virtual Result DeserializeData( ByteBuffer* archiver ) override;
 
+			/*
+			* @brief Uploads mips read in DeserializeData. Must be called on the main thread.
+			*/
+			virtual Result DeserializeLateInit( ) override;
+
 		protected: 
 
 			/*
-			* @brief
-			* @note Need to eventually move this into a factory class as a part of the graphics subsystem
+			* @brief Loads and decodes image at filePath without creating any GPU resources, so can be run on a worker thread.
+			*			Returns null if image could not be decoded.
+			*/
+			static Texture* Decode( const String& filePath );
+
+			/*
+			* @brief Builds mip chain from decoded source data and encodes it with compression, then releases source data.
+			*			HDR textures only support BC6H, LDR textures support every other format. Can be run on a worker thread.
+			*/
+			Result Cook( TextureCompression compression, TextureUsage usage );
+
+			/*
+			* @brief Creates GPU texture from cooked mips. Must be called on the main thread.
 			*/
-			static Texture* Construct( const String& filePath );
+			void UploadMips( );
 
 			/*
 			* @brief
 			*/
-			template <typename T>
-			void WriteTextureData( ByteBuffer* archiver ) const;
+			void ReleaseSourceData( );
+
+			/*
+			* @brief Uploads single mip level to bound texture
+			*/
+			void UploadMipLevel( u32 level, const Vector< u8 >& data );
+
+			/*
+			* @brief Uploads levels streamed in, which run from first up to resident mip, and makes first the finest mip sampled
+			*/
+			void StreamInMips( u32 first, const Vector< Vector< u8 > >& levels );
+
+			/*
+			* @brief Frees levels finer than first and makes it the finest mip sampled. Returns bytes freed.
+			*/
+			usize EvictMips( u32 first );
+
+			/*
+			* @brief Deletes GL textures created on upload and stops tracking their memory
+			*/
+			void ReleaseGPUTexture( );
 
 		private:
 			
@@ -212,7 +312,32 @@ namespace Enjon
 			ENJON_PROPERTY( ReadOnly )
 			TextureFormat mFormat;
 
+			ENJON_PROPERTY( ReadOnly )
+			TextureCompression mCompression = TextureCompression::None;
+
+			ENJON_PROPERTY( ReadOnly )
+			u32 mMipCount = 1;
+
 			TextureSourceDataBase* mSourceData = nullptr;
+
+			// Cooked mip chain, largest first, waiting to be serialized or uploaded
+			Vector< Vector< u8 > > mMipData;
+
+			// Set for textures cached before cooking, which only store their top level
+			bool mGenerateMipsOnUpload = false;
+
+			// Size of uploaded mips
+			usize mGPUMemoryBytes = 0;
+
+			// Cached file ranges of cooked mips, so levels left out on load can be streamed in later
+			Vector< TextureMipRange > mMipRanges;
+			u32 mResidentMip = 0;
+			bool mIsStreamed = false;
+
+			// Precomputed lighting of equirectangular HDR environments, waiting to be serialized or uploaded
+			ImageBasedLightingData mIBLData;
+
+			ImageBasedLightingMaps mIBLMaps;
 	}; 
 
 }
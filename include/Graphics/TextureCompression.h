@@ -0,0 +1,69 @@
+// @file TextureCompression.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_TEXTURE_COMPRESSION_H
+#define ENJON_TEXTURE_COMPRESSION_H
+
+#include "Graphics/Texture.h"
+
+namespace Enjon
+{
+	/*
+	* @brief Offline texture cooking. Builds mip chains on the cpu and encodes them into block compressed formats
+	*			( BC1, BC3, BC4, BC5 and BC7 for 8 bit data, BC6H for HDR ) that can be uploaded without any
+	*			further processing. All functions are thread safe.
+	*/
+	class TextureCompressor
+	{
+		public:
+
+			/*
+			* @brief Number of mips in a full chain down to 1x1
+			*/
+			static u32 GetMipCount( u32 width, u32 height );
+
+			/*
+			* @brief Bytes per 4x4 block, or 0 for uncompressed data
+			*/
+			static u32 GetBlockSize( TextureCompression compression );
+
+			/*
+			* @brief Size in bytes of one mip level of given dimensions. Uncompressed data is RGBA8 for LDR and
+			*			components floats per pixel for HDR.
+			*/
+			static usize GetLevelSize( TextureCompression compression, TextureFormat format, u32 components, u32 width, u32 height );
+
+			/*
+			* @brief Guesses usage from naming conventions of a source file ( "_normal", "_n", "roughness" etc. )
+			*/
+			static TextureUsage GetUsageFromFilePath( const String& filePath );
+
+			/*
+			* @brief Picks block format for RGBA8 pixels based on usage and contents. highQuality prefers BC7 over BC1 / BC3.
+			*/
+			static TextureCompression SelectCompression( TextureUsage usage, const u8* rgba, u32 width, u32 height, bool highQuality );
+
+			/*
+			* @brief Fills mips with full mip chain of RGBA8 pixels, starting with a copy of level 0
+			*/
+			static void GenerateMips( const u8* rgba, u32 width, u32 height, TextureUsage usage, Vector< Vector< u8 > >* mips );
+
+			/*
+			* @brief Fills mips with full mip chain of float pixels with components channels, starting with a copy of level 0
+			*/
+			static void GenerateMips( const f32* pixels, u32 components, u32 width, u32 height, Vector< Vector< f32 > >* mips );
+
+			/*
+			* @brief Encodes one level of RGBA8 pixels into out. Compression must be one of the 8 bit block formats.
+			*/
+			static Result Compress( TextureCompression compression, const u8* rgba, u32 width, u32 height, Vector< u8 >* out );
+
+			/*
+			* @brief Encodes one level of float pixels into BC6H ( unsigned ). Negative values are clamped to zero.
+			*/
+			static Result CompressHDR( const f32* pixels, u32 components, u32 width, u32 height, Vector< u8 >* out );
+	};
+}
+
+#endif
@@ -0,0 +1,183 @@
+// @file TextureStreamer.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#pragma once
+#ifndef ENJON_TEXTURE_STREAMER_H
+#define ENJON_TEXTURE_STREAMER_H
+
+#include "System/Types.h"
+#include "System/JobSystem.h"
+#include "Serialize/UUID.h"
+#include "Defines.h"
+
+#include <mutex>
+
+// Mips this size and smaller are read with the texture and stay resident for as long as it's loaded
+#define ENJON_TEXTURE_STREAMING_TAIL_SIZE					64
+
+// Frames a texture can go without being requested before its streamed mips may be evicted
+#define ENJON_TEXTURE_STREAMING_STALE_FRAMES				120
+
+// Reads in flight at once, so a newly visible level doesn't queue every texture in it behind each other
+#define ENJON_TEXTURE_STREAMING_MAX_IN_FLIGHT				8
+
+#define ENJON_TEXTURE_STREAMING_DEFAULT_MEMORY_BUDGET		( 512 * 1024 * 1024 )
+#define ENJON_TEXTURE_STREAMING_DEFAULT_UPLOAD_BUDGET		( 16 * 1024 * 1024 )
+
+namespace Enjon
+{
+	class Texture;
+	class Material;
+	class AssetRecordInfo;
+	struct TextureMipRange;
+
+	/*
+	* @brief Streams cooked mips of textures in and out of GPU memory by on screen usage. Textures loaded from cache only
+	*			upload their mip tail. While drawing, renderables request the finest mip their size on screen and
+	*			texture coordinate density need, then Update reads missing levels from the cached file on worker
+	*			threads, uploads them within a per frame budget and evicts levels no longer needed once over the
+	*			memory budget. Everything but reads runs on the main thread.
+	*/
+	class TextureStreamer
+	{
+		public:
+
+			/*
+			* @brief
+			*/
+			TextureStreamer( ) = default;
+
+			/*
+			* @brief
+			*/
+			~TextureStreamer( );
+
+			/*
+			* @brief Whether textures loaded from now on leave mips above their tail to be streamed. Thread safe.
+			*/
+			static void SetEnabled( bool enabled );
+
+			/*
+			* @brief
+			*/
+			static bool IsEnabled( );
+
+			/*
+			* @brief Finest mip of texture needed where one object space unit covers pixelsPerUnit pixels, for mesh with uvDensity
+			*			texture coordinate units per object space unit
+			*/
+			static u32 ComputeRequiredMip( const Texture* texture, f32 uvDensity, f32 pixelsPerUnit );
+
+			/*
+			* @brief Starts managing texture's mips above its resident one. Called once texture has uploaded its mip tail.
+			*/
+			void Register( Texture* texture );
+
+			/*
+			* @brief Stops managing texture, waiting only on reads still in flight for it
+			*/
+			void Unregister( Texture* texture );
+
+			/*
+			* @brief Records that mip of texture is needed this frame. Ignored for textures that aren't streamed.
+			*/
+			void RequestMip( const Texture* texture, u32 mip );
+
+			/*
+			* @brief Requests mips for every texture material binds, drawn on mesh at given scale
+			*/
+			void RequestMaterial( const Material* material, f32 uvDensity, f32 pixelsPerUnit );
+
+			/*
+			* @brief Uploads finished reads, evicts stale mips over budget and issues reads for needed ones. Call once per frame
+			*			after all requests have been made.
+			*/
+			void Update( );
+
+			/*
+			* @brief Waits on reads in flight and releases all textures
+			*/
+			void Shutdown( );
+
+			/*
+			* @brief Most bytes of streamed mips ( those above mip tails ) to keep resident
+			*/
+			void SetMemoryBudget( usize bytes );
+
+			/*
+			* @brief
+			*/
+			usize GetMemoryBudget( ) const;
+
+			/*
+			* @brief Most bytes of mips uploaded per frame. At least one read is always uploaded.
+			*/
+			void SetUploadBudget( usize bytes );
+
+			/*
+			* @brief Bytes of streamed mips currently resident
+			*/
+			usize GetStreamedMemoryUsage( ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetTextureCount( ) const;
+
+			/*
+			* @brief
+			*/
+			u32 GetReadsInFlight( ) const;
+
+		protected:
+
+			struct StreamingTexture
+			{
+				Texture* mTexture = nullptr;
+				JobGroup mReads;					// Reads in flight for this texture
+				u32 mRequestedMip = 0;				// Finest requested this frame
+				u32 mWantedMip = 0;					// Finest needed recently
+				u32 mLastRequestedFrame = 0;
+				bool mInFlight = false;
+			};
+
+			struct StreamedMips
+			{
+				UUID mTextureID;					// Looked up on upload, since texture may have been unloaded since read was issued
+				u32 mFirstMip = 0;
+				u32 mResidentMip = 0;				// Texture's resident mip when read was issued
+				Vector< Vector< u8 > > mLevels;		// mFirstMip up to mResidentMip
+				Result mResult = Result::FAILURE;
+			};
+
+			/*
+			* @brief Bytes of texture's mips in [first, last)
+			*/
+			static usize GetMipRangeSize( const Texture* texture, u32 first, u32 last );
+
+			/*
+			* @brief Reads mips of texture from first up to its resident one, on a worker thread if any
+			*/
+			void IssueRead( StreamingTexture* state, u32 first );
+
+			/*
+			* @brief Reads consecutive cooked levels at ranges from record's cached file with a single read. Each level is
+			*			preceded by its size, which has to match its range.
+			*/
+			static Result ReadLevels( const AssetRecordInfo* info, const Vector< TextureMipRange >& ranges, Vector< Vector< u8 > >* levels );
+
+		protected:
+			HashMap< UUID, StreamingTexture > mTextures;		// Keyed by texture's asset id
+			std::mutex mCompletedLock;
+			Vector< StreamedMips > mCompleted;				// Filled by workers, guarded by lock
+			Vector< StreamedMips > mPendingUploads;			// Main thread only, waiting on upload budget
+			Vector< const Texture* > mMaterialTextures;		// Scratch for material requests
+			usize mMemoryBudget = ENJON_TEXTURE_STREAMING_DEFAULT_MEMORY_BUDGET;
+			usize mUploadBudget = ENJON_TEXTURE_STREAMING_DEFAULT_UPLOAD_BUDGET;
+			usize mStreamedBytes = 0;
+			u32 mReadsInFlight = 0;
+			u32 mFrame = 1;
+	};
+}
+
+#endif
@@ -517,6 +517,11 @@ namespace Enjon
 
 			void AddFont( const AssetHandle< UIFont >& ui, const u32& pointSize, GUIContext* ctx = nullptr );
 
+			/**
+			* @brief Creates font of given size from font's cooked distance field atlas, without baking a new texture
+			*/
+			ImFont* AddSDFFont( const UIFont* font, const u32& pointSize );
+
 			ImGuiContext* GetContextByWindow( Window* window );
 
 		public:
@@ -595,6 +600,7 @@ namespace Enjon
 			HashMap<String, HashMap<String, std::function<void()>>> mMainMenuOptions;
 			Vector<GUIDockingLayout> mDockingLayouts; 
 			HashMap< Enjon::String, ImFont* > mFonts;
+			HashMap< Enjon::String, ImFontAtlas* > mSDFFontAtlases;
 			ImGuiContext* mContext = nullptr;
 			HashMap< SDL_Window*, ImGuiContext* > mImGuiContextMap;
  
@@ -28,3 +28,6 @@ ImGuiContext*			ImGui_ImplSdlGL3_GetContext( );
 ImGuiContext*			ImGui_ImplSdlGL3_CreateContext( );
 IMGUI_API void 			ImGui_ImplSdlGL3_UpdateViewports( ImGuiContext* ctx );
 void					ImGui_ImplSdlGL3_CreateFontsTexture( ImGuiContext* ctx );
+
+// Draws commands using texture as a single channel distance field, edge at 0.5, instead of as coverage
+IMGUI_API void			ImGui_ImplSdlGL3_AddSignedDistanceTexture( ImTextureID texture );
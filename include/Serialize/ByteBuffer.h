@@ -32,6 +32,12 @@ namespace Enjon
 			*/
 			ByteBuffer( const String& filePath );
 
+			/*
+			* @brief Read only view over size bytes of data owned elsewhere, which must outlive the buffer. Data is only copied
+			*			if the buffer is written to.
+			*/
+			ByteBuffer( const u8* data, const u32& size );
+
 			/*
 			* @brief
 			*/
@@ -114,6 +120,26 @@ namespace Enjon
 			*/
 			void SetReadPosition( const u32& position );
 
+			/*
+			* @brief
+			*/
+			u32 GetReadPosition( ) const;
+
+			/*
+			* @brief Writes size raw bytes from data into buffer
+			*/
+			void WriteBytes( const u8* data, const u32& size );
+
+			/*
+			* @brief Reads size raw bytes from buffer into data. Returns false, reading nothing, if fewer than size bytes remain.
+			*/
+			bool ReadBytes( u8* data, const u32& size );
+
+			/*
+			* @brief Reallocates buffer to exactly size bytes and marks it ready to read. Returns storage for caller to fill in directly.
+			*/
+			u8* PrepareForRead( const u32& size );
+
 			/*
 			* @brief
 			*/
@@ -132,6 +158,7 @@ namespace Enjon
 			u32 mCapacity			= ENJON_BYTE_BUFFER_DEFAULT_CAPACITY;
 			u8* mBuffer				= nullptr;
 			BufferStatus mStatus	= BufferStatus::Invalid;
+			bool mOwnsData			= true;
 	};
 }
 
@@ -69,6 +69,16 @@ namespace Enjon
 			*/
 			bool operator!=( const UUID &other ) const;
 
+			/*
+			* @brief Orders ids by their bytes
+			*/
+			bool operator<( const UUID &other ) const;
+
+			/*
+			* @brief Hash of id's bytes, so ids can key hash maps without being converted to strings
+			*/
+			usize Hash( ) const;
+
 		private:
 
 			/*
@@ -86,4 +96,16 @@ namespace Enjon
 	}; 
 }
 
+namespace std
+{
+	template <>
+	struct hash< Enjon::UUID >
+	{
+		size_t operator()( const Enjon::UUID& uuid ) const
+		{
+			return uuid.Hash( );
+		}
+	};
+}
+
 #endif
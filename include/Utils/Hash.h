@@ -0,0 +1,64 @@
+// @file Hash.h
+// Copyright 2016-2018 John Jackson. All Rights Reserved.
+
+#ifndef ENJON_HASH_H
+#define ENJON_HASH_H
+
+#include <fstream>
+
+#include "Defines.h"
+#include "System/Types.h"
+
+#define ENJON_FNV1A_64_OFFSET_BASIS		0xcbf29ce484222325ull
+#define ENJON_FNV1A_64_PRIME			0x100000001b3ull
+
+namespace Enjon { namespace Utils
+{
+	/*
+	* @brief 64 bit FNV-1a hash of size bytes of data. Pass a previous result as seed to hash data in pieces.
+	*/
+	static inline u64 HashBytes( const void* data, usize size, u64 seed = ENJON_FNV1A_64_OFFSET_BASIS )
+	{
+		const u8* bytes = ( const u8* )data;
+		u64 hash = seed;
+		for ( usize i = 0; i < size; ++i )
+		{
+			hash ^= ( u64 )bytes[ i ];
+			hash *= ENJON_FNV1A_64_PRIME;
+		}
+		return hash;
+	}
+
+	/*
+	* @brief
+	*/
+	static inline u64 HashString( const String& str, u64 seed = ENJON_FNV1A_64_OFFSET_BASIS )
+	{
+		return HashBytes( str.data( ), str.size( ), seed );
+	}
+
+	/*
+	* @brief Hashes contents of file at filePath. Returns false if file could not be read.
+	*/
+	static inline bool HashFile( const String& filePath, u64* hash )
+	{
+		std::ifstream file( filePath, std::ios::in | std::ios::binary );
+		if ( !file )
+		{
+			return false;
+		}
+
+		char chunk[ 64 * 1024 ];
+		u64 result = ENJON_FNV1A_64_OFFSET_BASIS;
+		while ( file )
+		{
+			file.read( chunk, sizeof( chunk ) );
+			result = HashBytes( chunk, ( usize )file.gcount( ), result );
+		}
+
+		*hash = result;
+		return file.eof( );
+	}
+}}
+
+#endif